@@ -0,0 +1,11 @@
+
+
+#ifndef TMV_BINARY_H
+#define TMV_BINARY_H
+
+#include "TMV.h"
+#include "TMV_Band.h"
+
+#include "tmv/TMV_BinaryIO.h"
+
+#endif
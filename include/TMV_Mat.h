@@ -5,6 +5,7 @@
 
 #include "tmv/TMV_Matrix.h"
 #include "tmv/TMV_SmallMatrix.h"
+#include "tmv/TMV_SmallMatrixBatch.h"
 
 #include "tmv/TMV_MatrixIO.h"
 #include "tmv/TMV_CopyM.h"
@@ -22,6 +23,7 @@
 #include "tmv/TMV_MultMM_Block.h"
 #include "tmv/TMV_MultMM_OpenMP.h"
 #include "tmv/TMV_MultMM_Winograd.h"
+#include "tmv/TMV_MultMM_Packed.h"
 
 #include "tmv/TMV_Det.h"
 #include "tmv/TMV_InvertM.h"
@@ -56,6 +58,18 @@
 #include "tmv/TMV_SVDiv.h"
 #include "tmv/TMV_SVInverse.h"
 
+#include "tmv/TMV_CHD.h"
+#include "tmv/TMV_CHDecompose.h"
+#include "tmv/TMV_CHDiv.h"
+
+#include "tmv/TMV_LDLD.h"
+#include "tmv/TMV_LDLDecompose.h"
+#include "tmv/TMV_LDLDiv.h"
+
+#include "tmv/TMV_EigenDecompose.h"
+#include "tmv/TMV_EigenDecompose_Tridiag.h"
+#include "tmv/TMV_EigenDecompose_DC.h"
+
 #ifndef TMV_H
 #include "tmv/TMV_ProdXM.h"
 #include "tmv/TMV_SumMM.h"
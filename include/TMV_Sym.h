@@ -5,10 +5,12 @@
 
 #include "TMV.h"
 
+#include "tmv/TMV_BaseMatrix_Sym.h"
 #include "tmv/TMV_SymMatrix.h"
-#include "tmv/TMV_SymLDLD.h"
-#include "tmv/TMV_SymSVD.h"
-#include "tmv/TMV_SymCHD.h"
-#include "tmv/TMV_SymMatrixArith.h"
+#include "tmv/TMV_SymMatrixIO.h"
+#include "tmv/TMV_MultXS.h"
+#include "tmv/TMV_MultSV.h"
+#include "tmv/TMV_MultSM.h"
+#include "tmv/TMV_RankKMMS.h"
 
 #endif
@@ -0,0 +1,526 @@
+
+
+// This file defines the run time tracing of the algorithm selection.
+//
+// Most of the operations in TMV are done by a Helper structure that
+// picks one of several algorithms according to the storage, the sizes,
+// and what is known at compile time.  The PRINTALGO_* macros in each
+// header write out these choices, but they have to be turned on when
+// compiling, and they write a line for every call.  To find out which
+// calls in a real program end up in a slow path (e.g. the MultMM
+// algorithm that doesn't allocate memory, or a copy to colmajor storage),
+// the choices at the main decision points are also recorded at run time
+// when tracing is enabled:
+//
+// EnableAlgoTrace()
+// DisableAlgoTrace()
+// IsAlgoTraceEnabled()
+//     Turn the tracing on or off.  It is off by default, in which case
+//     each trace point only costs a check of this flag.
+// ResetAlgoTrace()
+//     Clear the statistics collected so far.
+// WriteAlgoTraceJSON(os)
+// WriteAlgoTraceCSV(os)
+//     Write the statistics to os.  There is one record for each
+//     operation and algorithm with the number of calls, the total wall
+//     time, the estimated number of flops and bytes moved, and the min,
+//     mean and max of the sizes M, N, K along with a histogram of each
+//     in powers of 2.
+// GetAlgoTrace(records)
+//     Fill a std::vector<AlgoTraceRecord> with the same statistics,
+//     sorted by operation and algorithm.  Returns the number of calls
+//     that were dropped because a thread's buffer was full.
+// LogAlgoTraceTo(os)
+//     Also write a line to *os for each traced call, like the PRINTALGO
+//     output.  LogAlgoTraceTo(0) turns this off.  Returns the previous
+//     stream.
+//
+// Each thread collects its statistics in its own buffer, so the trace
+// points don't need any locking.  The buffers are merged when they are
+// written out.  Like SetScratchSize, these functions should not be
+// called while other threads are using TMV.
+//
+// The times are inclusive.  e.g. The time for MultMM algo 81 (copy m1
+// to colmajor storage) includes the time for the product that it calls,
+// which is recorded again under the algorithm that does it.  The flops
+// and bytes are the nominal counts for the operation, not what the
+// particular algorithm actually does.
+//
+// A trace point is added to an algorithm with:
+//
+//     AlgoTrace trace("MultMM",67,M,N,K,flops,bytes);
+//
+// which records the call when trace goes out of scope.  If the op
+// argument is 0, nothing is recorded, which lets the small fixed-size
+// algorithms skip the trace at compile time.
+//
+// If TMV_NO_ALGO_TRACE is defined, the trace points don't do anything.
+// This is also the case if we don't know how to make thread local
+// variables with this compiler.  (TMV_NO_ALGO_TRACE needs to be the
+// same for the library and the code that uses it.)
+
+#ifndef TMV_AlgoTrace_H
+#define TMV_AlgoTrace_H
+
+#include "TMV_Base.h"
+#include "TMV_Array.h"
+#include <vector>
+#include <cstring>
+#include <ostream>
+
+#if __cplusplus >= 201103L
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#else
+#include <sys/time.h>
+#endif
+
+// The number of different (op,algo) records each thread can hold.
+#ifndef TMV_ALGO_TRACE_SIZE
+#define TMV_ALGO_TRACE_SIZE 128
+#endif
+
+// The number of bins in the size histograms.
+// Bin b counts the sizes n with 2^(b-1) <= n < 2^b.  Bin 0 is n = 0,
+// and the last bin also has everything larger.
+#define TMV_ALGO_TRACE_NBINS 24
+
+#if !defined(TMV_THREAD_LOCAL) && !defined(TMV_NO_ALGO_TRACE)
+#define TMV_NO_ALGO_TRACE
+#endif
+
+// Registering a thread's buffer also needs an atomic compare and swap.
+#if __cplusplus < 201103L && !defined(__GNUC__) && !defined(TMV_NO_ALGO_TRACE)
+#define TMV_NO_ALGO_TRACE
+#endif
+
+namespace tmv {
+
+    // The statistics for one operation and algorithm.
+    // This needs to be a POD type, since it is in the thread local buffer.
+    struct AlgoTraceRecord
+    {
+        const char* op;
+        int algo;
+        long ncalls;
+        double seconds;
+        double flops;
+        double bytes;
+        ptrdiff_t min[3]; // For M, N, K respectively
+        ptrdiff_t max[3];
+        double sum[3];
+        long hist[3][TMV_ALGO_TRACE_NBINS];
+
+        void clear(const char* _op, int _algo)
+        {
+            op = _op;
+            algo = _algo;
+            ncalls = 0;
+            seconds = flops = bytes = 0.;
+            for(int k=0;k<3;++k) {
+                min[k] = max[k] = 0;
+                sum[k] = 0.;
+                for(int b=0;b<TMV_ALGO_TRACE_NBINS;++b) hist[k][b] = 0;
+            }
+        }
+
+        static int bin(ptrdiff_t n)
+        {
+            int b = 0;
+            while (n > 0 && b < TMV_ALGO_TRACE_NBINS-1) { ++b; n >>= 1; }
+            return b;
+        }
+
+        void add(const ptrdiff_t* mnk, double f, double nb, double t)
+        {
+            for(int k=0;k<3;++k) {
+                if (ncalls == 0 || mnk[k] < min[k]) min[k] = mnk[k];
+                if (ncalls == 0 || mnk[k] > max[k]) max[k] = mnk[k];
+                sum[k] += double(mnk[k]);
+                ++hist[k][bin(mnk[k])];
+            }
+            ++ncalls;
+            flops += f;
+            bytes += nb;
+            seconds += t;
+        }
+
+        void merge(const AlgoTraceRecord& rhs)
+        {
+            for(int k=0;k<3;++k) {
+                if (ncalls == 0 || rhs.min[k] < min[k]) min[k] = rhs.min[k];
+                if (ncalls == 0 || rhs.max[k] > max[k]) max[k] = rhs.max[k];
+                sum[k] += rhs.sum[k];
+                for(int b=0;b<TMV_ALGO_TRACE_NBINS;++b)
+                    hist[k][b] += rhs.hist[k][b];
+            }
+            ncalls += rhs.ncalls;
+            flops += rhs.flops;
+            bytes += rhs.bytes;
+            seconds += rhs.seconds;
+        }
+
+        double mean(int k) const
+        { return ncalls > 0 ? sum[k] / ncalls : 0.; }
+    };
+
+    inline bool operator<(const AlgoTraceRecord& a, const AlgoTraceRecord& b)
+    {
+        const int c = std::strcmp(a.op,b.op);
+        return c < 0 || (c == 0 && a.algo < b.algo);
+    }
+
+    // The records for one thread.  The records are found by a hash of
+    // the op pointer and the algo number.  The op strings are literals,
+    // so the pointer is the same for every call from the same place,
+    // and GetAlgoTrace combines records with the same name from
+    // different places.
+    struct AlgoTraceBuffer
+    {
+        AlgoTraceRecord rec[TMV_ALGO_TRACE_SIZE];
+        long ndropped;
+        AlgoTraceBuffer* next;
+#if __cplusplus >= 201103L
+        std::atomic<bool> inuse; // Whether a running thread owns it
+#endif
+
+        void clear()
+        {
+            for(int i=0;i<TMV_ALGO_TRACE_SIZE;++i) rec[i].clear(0,0);
+            ndropped = 0;
+        }
+
+        AlgoTraceRecord* find(const char* op, int algo)
+        {
+            size_t h = (size_t(op) >> 3) * 31 + size_t(algo) * 131;
+            for(int n=0;n<TMV_ALGO_TRACE_SIZE;++n) {
+                AlgoTraceRecord& r = rec[(h+n) % TMV_ALGO_TRACE_SIZE];
+                if (r.op == op && r.algo == algo) return &r;
+                if (r.op == 0) { r.clear(op,algo); return &r; }
+            }
+            return 0;
+        }
+    };
+
+    struct AlgoTraceState
+    {
+        static bool& enabled()
+        {
+            static bool on = false;
+            return on;
+        }
+
+        static std::ostream*& log()
+        {
+            static std::ostream* os = 0;
+            return os;
+        }
+
+        // The buffers for all threads that have recorded anything.
+        // When a thread ends, its buffer is kept, so its calls still
+        // show up in the output, but it is marked as free, and the next
+        // new thread takes it over and adds its own calls to it.  So the
+        // number of buffers is the largest number of threads that were
+        // tracing at the same time, not the total number of threads.
+        // (Without C++11, there is no way to know when a thread ends,
+        // so each new thread gets a new buffer.)
+        // The list is only ever pushed onto, which is done with an
+        // atomic compare and swap.  (An omp critical section doesn't
+        // protect against threads that aren't OpenMP threads.)
+#if __cplusplus >= 201103L
+        static std::atomic<AlgoTraceBuffer*>& head()
+        {
+            static std::atomic<AlgoTraceBuffer*> buf(0);
+            return buf;
+        }
+
+        static AlgoTraceBuffer* first()
+        { return head().load(); }
+
+        static void push(AlgoTraceBuffer* buf)
+        {
+            AlgoTraceBuffer* h = head().load();
+            do { buf->next = h; } 
+            while (!head().compare_exchange_weak(h,buf));
+        }
+
+        // Take over a free buffer, or make a new one if there aren't any.
+        static AlgoTraceBuffer* claim()
+        {
+            for(AlgoTraceBuffer* b=first(); b; b=b->next) {
+                bool inuse = false;
+                if (b->inuse.compare_exchange_strong(inuse,true)) return b;
+            }
+            AlgoTraceBuffer* buf = new AlgoTraceBuffer;
+            buf->clear();
+            buf->inuse = true;
+            push(buf);
+            return buf;
+        }
+
+        // The log is written with a mutex for the same reason.
+        static std::mutex& logMutex()
+        {
+            static std::mutex m;
+            return m;
+        }
+
+        static void lockLog() { logMutex().lock(); }
+        static void unlockLog() { logMutex().unlock(); }
+#else
+        static AlgoTraceBuffer*& head()
+        {
+            static AlgoTraceBuffer* buf = 0;
+            return buf;
+        }
+
+        static AlgoTraceBuffer* first()
+        { __sync_synchronize(); return head(); }
+
+#ifdef __GNUC__
+        static void push(AlgoTraceBuffer* buf)
+        {
+            AlgoTraceBuffer* h;
+            do { h = head(); buf->next = h; } 
+            while (!__sync_bool_compare_and_swap(&head(),h,buf));
+        }
+
+        // The log is written with a spin lock, using the same atomic
+        // builtins.
+        static volatile int& logLock()
+        {
+            static volatile int lock = 0;
+            return lock;
+        }
+
+        static void lockLog()
+        { while (__sync_lock_test_and_set(&logLock(),1)) {} }
+        static void unlockLog() 
+        { __sync_lock_release(&logLock()); }
+#endif
+#endif
+
+#ifndef TMV_NO_ALGO_TRACE
+        // Holds the log lock while it is in scope.
+        struct LogLock
+        {
+            LogLock() { lockLog(); }
+            ~LogLock() { unlockLog(); }
+        };
+
+#if __cplusplus >= 201103L
+        // Frees up the thread's buffer when the thread ends.
+        struct Owner
+        {
+            AlgoTraceBuffer* buf;
+            Owner() : buf(claim()) {}
+            ~Owner() { buf->inuse = false; }
+        private:
+            Owner(const Owner&);
+            Owner& operator=(const Owner&);
+        };
+
+        static AlgoTraceBuffer& get()
+        {
+            static thread_local Owner owner;
+            return *owner.buf;
+        }
+#else
+        static AlgoTraceBuffer& get()
+        {
+            static TMV_THREAD_LOCAL AlgoTraceBuffer* buf = 0;
+            if (!buf) {
+                buf = new AlgoTraceBuffer;
+                buf->clear();
+                push(buf);
+            }
+            return *buf;
+        }
+#endif
+#endif
+
+        static double now()
+        {
+#if __cplusplus >= 201103L
+            return std::chrono::duration<double>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+            timeval tp;
+            gettimeofday(&tp,0);
+            return tp.tv_sec + tp.tv_usec/1.e6;
+#endif
+        }
+    };
+
+    class AlgoTrace
+    {
+    public:
+#ifndef TMV_NO_ALGO_TRACE
+        AlgoTrace(
+            const char* op, int algo, ptrdiff_t M, ptrdiff_t N, ptrdiff_t K,
+            double flops, double bytes) :
+            _op(op && AlgoTraceState::enabled() ? op : 0), _algo(algo),
+            _flops(flops), _bytes(bytes), _t0(0.)
+        {
+            if (_op) {
+                _mnk[0] = M; _mnk[1] = N; _mnk[2] = K;
+                _t0 = AlgoTraceState::now();
+            }
+        }
+
+        ~AlgoTrace()
+        { if (_op) record(); }
+
+    private:
+
+        void record()
+        {
+            const double t = AlgoTraceState::now() - _t0;
+            AlgoTraceBuffer& buf = AlgoTraceState::get();
+            AlgoTraceRecord* r = buf.find(_op,_algo);
+            if (r) r->add(_mnk,_flops,_bytes,t);
+            else ++buf.ndropped;
+            if (AlgoTraceState::log()) {
+                AlgoTraceState::LogLock lock;
+                *AlgoTraceState::log() << _op << " algo " << _algo <<
+                    ": M,N,K = " << _mnk[0] << ',' << _mnk[1] << ',' <<
+                    _mnk[2] << "  time = " << t << std::endl;
+            }
+        }
+
+        const char* _op;
+        int _algo;
+        ptrdiff_t _mnk[3];
+        double _flops;
+        double _bytes;
+        double _t0;
+#else
+        TMV_INLINE AlgoTrace(
+            const char* , int , ptrdiff_t , ptrdiff_t , ptrdiff_t ,
+            double , double ) {}
+    private:
+#endif
+
+        AlgoTrace(const AlgoTrace&);
+        AlgoTrace& operator=(const AlgoTrace&);
+    };
+
+    inline void EnableAlgoTrace()
+    { AlgoTraceState::enabled() = true; }
+
+    inline void DisableAlgoTrace()
+    { AlgoTraceState::enabled() = false; }
+
+    inline bool IsAlgoTraceEnabled()
+    { return AlgoTraceState::enabled(); }
+
+    inline std::ostream* LogAlgoTraceTo(std::ostream* os)
+    {
+        std::ostream* temp = AlgoTraceState::log();
+        AlgoTraceState::log() = os;
+        return temp;
+    }
+
+    inline void ResetAlgoTrace()
+    {
+        for(AlgoTraceBuffer* b=AlgoTraceState::first(); b; b=b->next)
+            b->clear();
+    }
+
+    inline long GetAlgoTrace(std::vector<AlgoTraceRecord>& recs)
+    {
+        recs.clear();
+        long ndropped = 0;
+        for(AlgoTraceBuffer* b=AlgoTraceState::first(); b; b=b->next) {
+            ndropped += b->ndropped;
+            for(int i=0;i<TMV_ALGO_TRACE_SIZE;++i) {
+                const AlgoTraceRecord& r = b->rec[i];
+                if (r.op == 0 || r.ncalls == 0) continue;
+                size_t j=0;
+                for(;j<recs.size();++j) {
+                    if (recs[j].algo == r.algo &&
+                        std::strcmp(recs[j].op,r.op) == 0) break;
+                }
+                if (j == recs.size()) recs.push_back(r);
+                else recs[j].merge(r);
+            }
+        }
+        std::sort(recs.begin(),recs.end());
+        return ndropped;
+    }
+
+    // The ops are all identifiers, so they don't need any escaping for
+    // either format.
+    inline void WriteAlgoTraceJSON(std::ostream& os)
+    {
+        std::vector<AlgoTraceRecord> recs;
+        const long ndropped = GetAlgoTrace(recs);
+        const char* dim[3] = { "M", "N", "K" };
+        os << "{\n  \"dropped\": " << ndropped << ",\n  \"records\": [";
+        for(size_t i=0;i<recs.size();++i) {
+            const AlgoTraceRecord& r = recs[i];
+            os << (i == 0 ? "\n" : ",\n");
+            os << "    { \"op\": \"" << r.op << "\", \"algo\": " << r.algo;
+            os << ", \"calls\": " << r.ncalls;
+            os << ", \"seconds\": " << r.seconds;
+            os << ", \"flops\": " << r.flops;
+            os << ", \"bytes\": " << r.bytes;
+            os << ", \"gflops\": " <<
+                (r.seconds > 0. ? r.flops / r.seconds * 1.e-9 : 0.);
+            os << ", \"gbytes_per_sec\": " <<
+                (r.seconds > 0. ? r.bytes / r.seconds * 1.e-9 : 0.);
+            for(int k=0;k<3;++k) {
+                os << ",\n      \"" << dim[k] << "\": { \"min\": " << r.min[k];
+                os << ", \"mean\": " << r.mean(k);
+                os << ", \"max\": " << r.max[k] << ", \"hist\": {";
+                bool first = true;
+                for(int b=0;b<TMV_ALGO_TRACE_NBINS;++b) {
+                    if (r.hist[k][b] == 0) continue;
+                    os << (first ? " \"" : ", \"") <<
+                        (b == 0 ? 0 : ptrdiff_t(1) << (b-1)) << "\": " <<
+                        r.hist[k][b];
+                    first = false;
+                }
+                os << " } }";
+            }
+            os << " }";
+        }
+        os << "\n  ]\n}\n";
+    }
+
+    // The histograms are written as lo:count pairs separated by ';',
+    // where lo is the lower edge of the bin.
+    inline void WriteAlgoTraceCSV(std::ostream& os)
+    {
+        std::vector<AlgoTraceRecord> recs;
+        GetAlgoTrace(recs);
+        const char* dim[3] = { "M", "N", "K" };
+        os << "op,algo,calls,seconds,flops,bytes";
+        for(int k=0;k<3;++k)
+            os << ',' << dim[k] << "_min," << dim[k] << "_mean," <<
+                dim[k] << "_max," << dim[k] << "_hist";
+        os << '\n';
+        for(size_t i=0;i<recs.size();++i) {
+            const AlgoTraceRecord& r = recs[i];
+            os << r.op << ',' << r.algo << ',' << r.ncalls << ',' <<
+                r.seconds << ',' << r.flops << ',' << r.bytes;
+            for(int k=0;k<3;++k) {
+                os << ',' << r.min[k] << ',' << r.mean(k) << ',' <<
+                    r.max[k] << ',';
+                bool first = true;
+                for(int b=0;b<TMV_ALGO_TRACE_NBINS;++b) {
+                    if (r.hist[k][b] == 0) continue;
+                    if (!first) os << ';';
+                    os << (b == 0 ? 0 : ptrdiff_t(1) << (b-1)) << ':' <<
+                        r.hist[k][b];
+                    first = false;
+                }
+            }
+            os << '\n';
+        }
+    }
+
+} // namespace tmv
+
+#endif
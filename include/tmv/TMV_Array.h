@@ -1,15 +1,20 @@
 
 
-// This file defines two classes that are used by TMV for allocating
+// This file defines the classes that are used by TMV for allocating
 // memory.
 //
 // First, AlignedArray works basically like a regular new v[]
-// allocation, except that if we are doing SSE or SSE2, then we enforce
-// that the allocation is aligned on a 128 byte boundary.
+// allocation, except that float and double (and complex) allocations 
+// are aligned on (at least) a 16 byte boundary, and they are made with 
+// an allocation policy that you can replace with your own functions.
 //
 // Second, StackArray is used for small arrays and emulates a normal C array
 // on the stack: T v[N].  However, when N is large, it uses the 
 // heap instead to avoid stack overflows.
+//
+// Third, ScratchScope lets an algorithm take the memory for its
+// temporaries from a per-thread scratch arena rather than the heap.
+// See the description below.
 
 #ifndef Array_H
 #define Array_H
@@ -17,6 +22,7 @@
 const ptrdiff_t TMV_MaxStack = 1024; // bytes
 
 #include <complex>
+#include <new>
 
 namespace tmv
 {
@@ -24,18 +30,324 @@ namespace tmv
     TMV_INLINE bool TMV_Aligned(const T* p)
     { return (reinterpret_cast<size_t>(p) & 0xf) == 0; }
 
+    // The allocation policy
+    //
     // There doesn't seem to be any portable C++ function that guarantees
     // that the memory allocated will be aligned as necessary for 
     // SSE functions.
     // Sometimes posix_memalign or memalign does this job.
     // But it doesn't seem to be standard, since some systems don't have it.
     // Other systems have _mm_malloc (ICPC) or _aligned_malloc (WIN).
-    // So probably I should have ifdefs that check to see if one of these
-    // is available and use that instead.
     //
-    // But for now we have this simple class that simply loads a bit more 
-    // memory than necessary and then finds the starting point that is 
-    // 16 byte aligned.
+    // So the default allocator simply loads a bit more memory than 
+    // necessary with new and then finds the starting point that has the 
+    // right alignment.  The original pointer is stored just before the 
+    // aligned memory, so we can delete it later.
+    //
+    // However, you may want to get the memory some other way.  e.g. to put
+    // large matrices in huge pages, in NUMA-local memory, or in a 
+    // memory pool.  So you can replace the allocator with your own
+    // functions:
+    //
+    // SetAllocator(alloc, dealloc)
+    //     alloc has the signature void* alloc(size_t nbytes, size_t align)
+    //     and should return memory for nbytes bytes aligned on an align
+    //     byte boundary, or 0 if it fails (in which case we throw
+    //     std::bad_alloc).  dealloc has the signature 
+    //     void dealloc(void* p, size_t nbytes), and is called with the
+    //     pointer and size from alloc.  Calling SetAllocator(0,0) restores 
+    //     the default allocator.
+    // SetAlignment(align)
+    //     Set the alignment of new allocations.  This must be a power
+    //     of 2 that is at least 16.  The default is TMV_ALIGNMENT, which
+    //     is 16 unless you define it otherwise.  64 is useful for AVX-512,
+    //     and to start every allocation on a new cache line.
+    // GetAlignment()
+    //     Return the current alignment.
+    //
+    // These apply to every float and double allocation through 
+    // AlignedArray, which includes the storage of Matrix, Vector, 
+    // BandMatrix, TriMatrix, DiagMatrix, etc. and their complex versions.
+    // Other value types just use new T[].
+    // Each allocation remembers the dealloc function that goes with it,
+    // so memory allocated before a change of allocator is still freed
+    // correctly.  However, these settings are not thread safe, so they 
+    // should not be changed while other threads are using TMV.
+    
+#ifndef TMV_ALIGNMENT
+#define TMV_ALIGNMENT 16
+#endif
+
+    typedef void* (*AllocateFunction)(size_t nbytes, size_t align);
+    typedef void (*DeallocateFunction)(void* p, size_t nbytes);
+
+    struct AllocationPolicy
+    {
+        static void* defaultAllocate(size_t nbytes, size_t align)
+        {
+            char* p0 = new char[nbytes + align + sizeof(char*)];
+            char* p = p0 + sizeof(char*);
+            p += (align - ((size_t)(p) & (align-1))) & (align-1);
+            reinterpret_cast<char**>(p)[-1] = p0;
+            return p;
+        }
+        static void defaultDeallocate(void* p, size_t )
+        { delete [] reinterpret_cast<char**>(p)[-1]; }
+
+        static AllocateFunction& allocateFunction()
+        {
+            static AllocateFunction f = &defaultAllocate;
+            return f;
+        }
+        static DeallocateFunction& deallocateFunction()
+        {
+            static DeallocateFunction f = &defaultDeallocate;
+            return f;
+        }
+        static size_t& alignment()
+        {
+            static size_t align = TMV_ALIGNMENT;
+            return align;
+        }
+
+        // Allocate nbytes with the current policy.  
+        // fr is set to the function that frees it.
+        static char* allocate(size_t nbytes, DeallocateFunction& fr)
+        {
+            void* p = allocateFunction()(nbytes,alignment());
+            if (!p) throw std::bad_alloc();
+            TMVAssert(((size_t)(p) & (alignment()-1)) == 0);
+            fr = deallocateFunction();
+            return reinterpret_cast<char*>(p);
+        }
+    };
+
+    inline void SetAllocator(AllocateFunction alloc, DeallocateFunction dealloc)
+    {
+        TMVAssert((alloc == 0) == (dealloc == 0));
+        if (alloc && dealloc) {
+            AllocationPolicy::allocateFunction() = alloc;
+            AllocationPolicy::deallocateFunction() = dealloc;
+        } else {
+            AllocationPolicy::allocateFunction() = 
+                &AllocationPolicy::defaultAllocate;
+            AllocationPolicy::deallocateFunction() = 
+                &AllocationPolicy::defaultDeallocate;
+        }
+    }
+
+    inline void SetAlignment(size_t align)
+    {
+        TMVAssert(align >= 16 && (align & (align-1)) == 0);
+        if (align < 16) align = 16;
+        AllocationPolicy::alignment() = align;
+    }
+
+    inline size_t GetAlignment()
+    { return AllocationPolicy::alignment(); }
+
+    // The scratch arena
+    //
+    // Many algorithms make temporary copies of their arguments on every
+    // call: e.g. the copies to colmajor storage (algo 81) in MultMM and
+    // the decompositions, the block storage in MultMM_Block, the
+    // workspace vectors in the divide and conquer SVD.  For medium sized
+    // matrices in a tight loop, the new/delete for these can be a
+    // noticeable fraction of the time, and with several threads they
+    // also contend for the allocator's lock.
+    //
+    // So each thread has a scratch arena, which is a single block of
+    // memory that is used as a stack.  When an algorithm creates a
+    // ScratchScope object, any float or double (and hence complex)
+    // allocations made by that thread through AlignedMemory (which
+    // includes the storage for Matrix, Vector, etc.) are taken from the
+    // top of the arena until the scope ends, at which point they are all
+    // released at once.  Allocations that don't fit in the arena use the
+    // allocation policy as usual.  The arena itself is also allocated 
+    // with the allocation policy.
+    //
+    // Since the memory is released when the scope ends, a ScratchScope may
+    // only be used where everything allocated inside it is destroyed
+    // before the scope ends, which is the case for the internal
+    // temporaries listed above.  Do not swap the storage of such a
+    // temporary with an object that outlives the scope.
+    //
+    // The arena for each thread is allocated the first time that thread
+    // enters a ScratchScope.  With C++11, it is freed when the thread
+    // exits.  With older compilers, the arena is a POD __thread variable,
+    // which can't have a destructor, so a thread that exits without 
+    // calling ResetScratch() leaks its arena.
+    // The following functions let you control it:
+    //
+    // SetScratchSize(nbytes)
+    //     Set the size of the arena.  The default is TMV_SCRATCH_SIZE
+    //     (4 MB).  Each thread picks up the new size the next time its
+    //     arena is empty.  This should not be called while other threads 
+    //     are using TMV.
+    // GetScratchSize()
+    //     Return the current setting of the arena size.
+    // ResetScratch()
+    //     Free the calling thread's arena.  It will be allocated again 
+    //     the next time it is needed.
+    // GetScratchPeak()
+    //     Return the largest amount of memory (in bytes) that the
+    //     calling thread has requested from its arena since the last
+    //     ResetScratchPeak().  This includes requests that didn't fit
+    //     and went to the heap instead, so it is the arena size that
+    //     would have been needed to do everything in the arena.
+    // ResetScratchPeak()
+    //     Reset the peak to the current usage.
+    //
+    // If TMV_NO_SCRATCH is defined, ScratchScope doesn't do anything,
+    // and all allocations use the heap.  This is also the case if we
+    // don't know how to make thread local variables with this compiler.
+    // (TMV_NO_SCRATCH needs to be the same for the library and the code
+    // that uses it.)
+
+#ifndef TMV_SCRATCH_SIZE
+#define TMV_SCRATCH_SIZE (1<<22)
+#endif
+
+#ifndef TMV_THREAD_LOCAL
+#if __cplusplus >= 201103L
+#define TMV_THREAD_LOCAL thread_local
+#elif defined(__GNUC__)
+#define TMV_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define TMV_THREAD_LOCAL __declspec(thread)
+#endif
+#endif
+
+#if !defined(TMV_THREAD_LOCAL) && !defined(TMV_NO_SCRATCH)
+#define TMV_NO_SCRATCH
+#endif
+
+#if __cplusplus >= 201103L && !defined(TMV_NO_SCRATCH)
+#define TMV_SCRATCH_DTOR
+#endif
+
+    // Without C++11, this needs to be a POD type for __thread to work.
+    struct ScratchArena
+    {
+        char* mem;     // The arena memory (0 until it is first needed)
+        DeallocateFunction fr; // The function to free mem
+        size_t cap;    // The size of mem
+        size_t top;    // The number of bytes currently in use
+        size_t peak;   // The largest value of top requested
+        int depth;     // The number of open ScratchScopes
+
+#ifdef TMV_SCRATCH_DTOR
+        ScratchArena() : mem(0), fr(0), cap(0), top(0), peak(0), depth(0) {}
+        ~ScratchArena() { if (mem) fr(mem,cap); }
+    private:
+        ScratchArena(const ScratchArena&);
+        ScratchArena& operator=(const ScratchArena&);
+    public:
+#endif
+
+        static size_t& defaultSize()
+        {
+            static size_t nbytes = TMV_SCRATCH_SIZE;
+            return nbytes;
+        }
+
+#ifndef TMV_NO_SCRATCH
+        static ScratchArena& get()
+        {
+#ifdef TMV_SCRATCH_DTOR
+            static thread_local ScratchArena arena;
+#else
+            static TMV_THREAD_LOCAL ScratchArena arena = { 0, 0, 0, 0, 0, 0 };
+#endif
+            return arena;
+        }
+
+        void release()
+        {
+            TMVAssert(top == 0);
+            if (mem) fr(mem,cap);
+            mem = 0;
+            cap = 0;
+        }
+
+        char* allocate(size_t nbytes)
+        {
+            // Keep everything on 64 byte boundaries (or the alignment if
+            // that is larger), so each allocation starts on a new cache line.
+            size_t align = AllocationPolicy::alignment();
+            if (align < 64) align = 64;
+            nbytes = (nbytes + align-1) & ~(align-1);
+            const size_t start = 
+                top + ((align - ((size_t)(mem+top) & (align-1))) & (align-1));
+            if (start + nbytes > peak) peak = start + nbytes;
+            if (top == 0 && cap != defaultSize()) {
+                release();
+                if (defaultSize() > 0) {
+                    mem = AllocationPolicy::allocate(defaultSize(),fr);
+                    cap = defaultSize();
+                }
+                return allocate(nbytes);
+            }
+            if (start + nbytes > cap) return 0;
+            top = start + nbytes;
+            return mem + start;
+        }
+
+        // Return memory for nbytes from the calling thread's arena if
+        // there is an open ScratchScope and enough room, else 0.
+        static char* alloc(size_t nbytes)
+        {
+            ScratchArena& arena = get();
+            return arena.depth > 0 ? arena.allocate(nbytes) : 0;
+        }
+#else
+        static char* alloc(size_t ) { return 0; }
+#endif
+    };
+
+    class ScratchScope
+    {
+    public:
+#ifndef TMV_NO_SCRATCH
+        ScratchScope() : arena(ScratchArena::get()), mark(arena.top)
+        { ++arena.depth; }
+        ~ScratchScope()
+        { arena.top = mark; --arena.depth; }
+    private:
+        ScratchArena& arena;
+        size_t mark;
+#else
+        ScratchScope() {}
+    private:
+#endif
+        ScratchScope(const ScratchScope&);
+        ScratchScope& operator=(const ScratchScope&);
+    };
+
+    inline void SetScratchSize(size_t nbytes)
+    { ScratchArena::defaultSize() = nbytes; }
+
+    inline size_t GetScratchSize()
+    { return ScratchArena::defaultSize(); }
+
+#ifndef TMV_NO_SCRATCH
+    inline void ResetScratch()
+    {
+        ScratchArena& arena = ScratchArena::get();
+        TMVAssert(arena.depth == 0);
+        if (arena.depth == 0) arena.release();
+    }
+
+    inline size_t GetScratchPeak()
+    { return ScratchArena::get().peak; }
+
+    inline void ResetScratchPeak()
+    { ScratchArena& arena = ScratchArena::get(); arena.peak = arena.top; }
+#else
+    inline void ResetScratch() {}
+    inline size_t GetScratchPeak() { return 0; }
+    inline void ResetScratchPeak() {}
+#endif
 
     // Also, the TMV_END_PADDING option is implemented here.  If it is 
     // defined, then we write 0's to the end of the full 16 byte word.
@@ -46,7 +358,8 @@ namespace tmv
     // to finish the block of 16 bytes.  And we write 0's to the values
     // that aren't part of the requested memory.
     
-    // First the regular non-SSE version, where we don't need aligment.
+    // First the regular version for other types, where we don't need 
+    // aligment.
     template <class T>
     class AlignedMemory
     {
@@ -73,91 +386,79 @@ namespace tmv
         T* p;
     };
 
-    // Now specialize float and double
+    // The float and double versions use the allocation policy and
+    // the scratch arena.
     // We do this regardless of whether __SSE__ or __SSE2__ is defined,
     // since these might be allocated in a unit that doesn't defined them
     // and then have get() called in a unit that does.  This leads to problems!
     // So we always make the float and double allocations aligned at
-    // 16 byte boundaries.
-    template <>
-    class AlignedMemory<float>
+    // (at least) 16 byte boundaries.
+    //
+    // AlignedBytes does the work for both of them.
+    class AlignedBytes
     {
     public:
-        TMV_INLINE AlignedMemory() : p(0) {}
-        TMV_INLINE void allocate(const ptrdiff_t n) 
+        TMV_INLINE AlignedBytes() : p(0), fr(0), nb(0) {}
+        TMV_INLINE void allocate(const size_t nbytes) 
         {
-            //std::cout<<"AlignedMemory float allocate "<<n<<std::endl;
 #ifdef TMV_END_PADDING
-            const ptrdiff_t nn = (n<<2)+15 + 16;
-            p = new char[nn];
-            float* pf = get();
-            for(ptrdiff_t i=n;i<(nn>>2);++i) pf[i] = 0.F;
+            nb = nbytes + 16;
 #else
-            p = new char[(n<<2)+15];
+            nb = nbytes;
+#endif
+            p = ScratchArena::alloc(nb);
+            if (p) fr = 0; // Released by the ScratchScope.
+            else p = AllocationPolicy::allocate(nb,fr);
+#ifdef TMV_END_PADDING
+            for(size_t i=nbytes;i<nb;++i) p[i] = 0;
 #endif
-            TMVAssert((void*)(p+(n<<2)+15) >= (void*)(get()+n));
+            TMVAssert(TMV_Aligned(p));
         }
         TMV_INLINE void deallocate()
-        { if (p) delete [] p; p=0; }
-        void swapWith(AlignedMemory<float>& rhs)
-        { char* temp = p; p = rhs.p; rhs.p = temp; }
-        TMV_INLINE float* get() 
-        {
-            float* pf = reinterpret_cast<float*>(
-                p + ((0x10-((size_t)(p) & 0xf)) & ~0x10));
-            TMVAssert( TMV_Aligned(pf) );
-            return pf;
-        }
-        TMV_INLINE const float* get() const 
-        {
-            const float* pf = reinterpret_cast<const float*>(
-                p + ((0x10-((size_t)(p) & 0xf)) & ~0x10));
-            TMVAssert( TMV_Aligned(pf) );
-            return pf;
+        { if (p && fr) fr(p,nb); p=0; fr=0; nb=0; }
+        void swapWith(AlignedBytes& rhs)
+        { 
+            TMV_SWAP(p,rhs.p);
+            TMV_SWAP(fr,rhs.fr);
+            TMV_SWAP(nb,rhs.nb);
         }
+        TMV_INLINE char* get() const { return p; }
     private:
         char* p;
+        DeallocateFunction fr;
+        size_t nb;
+    };
+
+    template <>
+    class AlignedMemory<float>
+    {
+    public:
+        TMV_INLINE void allocate(const ptrdiff_t n) 
+        { p.allocate(n*sizeof(float)); }
+        TMV_INLINE void deallocate() { p.deallocate(); }
+        void swapWith(AlignedMemory<float>& rhs) { p.swapWith(rhs.p); }
+        TMV_INLINE float* get() 
+        { return reinterpret_cast<float*>(p.get()); }
+        TMV_INLINE const float* get() const 
+        { return reinterpret_cast<const float*>(p.get()); }
+    private:
+        AlignedBytes p;
     };
+
     template <>
     class AlignedMemory<double>
     {
     public:
-        TMV_INLINE AlignedMemory() : p(0) {}
         TMV_INLINE void allocate(const ptrdiff_t n) 
-        {
-            //std::cout<<"AlignedMemory double allocate "<<n<<std::endl;
-#ifdef TMV_END_PADDING
-            const ptrdiff_t nn = (n<<3)+15 + 16;
-            p = new char[nn];
-            double* pd = get();
-            for(ptrdiff_t i=n;i<(nn>>3);++i) pd[i] = 0.;
-#else
-            p = new char[(n<<3)+15];
-#endif
-            TMVAssert((void*)(p+(n<<3)+15) >= (void*)(get()+n));
-        }
-        TMV_INLINE void deallocate()
-        { if (p) delete [] p; p=0; }
-        void swapWith(AlignedMemory<double>& rhs)
-        { char* temp = p; p = rhs.p; rhs.p = temp; }
+        { p.allocate(n*sizeof(double)); }
+        TMV_INLINE void deallocate() { p.deallocate(); }
+        void swapWith(AlignedMemory<double>& rhs) { p.swapWith(rhs.p); }
         TMV_INLINE double* get() 
-        {
-            double* pd = reinterpret_cast<double*>(
-                p + ((0x10-((size_t)(p) & 0xf)) & ~0x10));
-            TMVAssert( TMV_Aligned(pd) );
-            return pd;
-        }
+        { return reinterpret_cast<double*>(p.get()); }
         TMV_INLINE const double* get() const 
-        {
-            const double* pd = reinterpret_cast<const double*>(
-                p + ((0x10-((size_t)(p) & 0xf)) & ~0x10));
-            TMVAssert( TMV_Aligned(pd) );
-            return pd;
-        }
-
-    private :
-        char* p;
-
+        { return reinterpret_cast<const double*>(p.get()); }
+    private:
+        AlignedBytes p;
     };
 
 #ifdef TMV_INITIALIZE_NAN
@@ -46,7 +46,7 @@ namespace tmv {
     template <class M1, class M2>
     inline void BandLU_SolveInPlace(
         const BaseMatrix_Band<M1>& m1, const Permutation& P,
-        BaseMatrix_Band_Mutable<M2>& m2);
+        BaseMatrix_Rec_Mutable<M2>& m2);
     template <class M1, class V2>
     inline void BandLU_SolveInPlace(
         const BaseMatrix_Band<M1>& m1, const Permutation& P,
@@ -54,7 +54,7 @@ namespace tmv {
     template <class M1, class M2>
     inline void BandLU_SolveTransposeInPlace(
         const BaseMatrix_Band<M1>& m1, const Permutation& P,
-        BaseMatrix_Band_Mutable<M2>& m2);
+        BaseMatrix_Rec_Mutable<M2>& m2);
     template <class M1, class V2>
     inline void BandLU_SolveTransposeInPlace(
         const BaseMatrix_Band<M1>& m1, const Permutation& P,
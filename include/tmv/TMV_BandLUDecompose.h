@@ -10,6 +10,7 @@
 #include "TMV_DivVU.h"
 #include "TMV_DivMU.h"
 #include "TMV_Permutation.h"
+#include "TMV_LUDecompose.h"
 
 #ifdef PRINTALGO_BandLU
 #include <iostream>
@@ -26,6 +27,15 @@
 #define TMV_BandLU_INLINE_VVM
 #endif
 
+// BLOCKSIZE is the number of columns in each panel of algo 21.
+#define TMV_BANDLU_BLOCKSIZE 32
+
+// BLOCK_MINLO is the minimum nlo for which algo 21 is used.
+// It needs nlo >= BLOCKSIZE to have full size blocks, but the extra 
+// copying makes it slower than algo 11 until nlo is about twice that.
+// (cf. speed/TMV_Speed_BandLU.cpp)
+#define TMV_BANDLU_BLOCK_MINLO 64
+
 namespace tmv {
 
     // Defined in TMV_BandLUDecompose.cpp
@@ -135,10 +145,11 @@ namespace tmv {
                 RT piv = Ajb.maxAbsElement(&ip);
 
                 // Check for underflow:
+                // (Don't skip the rest of the step, since endcol and
+                // endrow still need to be incremented.)
                 if (TMV_Underflow(piv)) {
-                    P[j] = j;
+                    ip = 0;
                     Ajb.setZero();
-                    continue;
                 }
 
                 // Swap the pivot row with j if necessary
@@ -223,26 +234,168 @@ namespace tmv {
                 if (pivot && j+2<N) *(Uj1+1) -= *Lj * (*Uj2); // (if !pivot, *Uj2 == 0)
             }
             // j == N-1
-            P[j] = N-1;
+            P[N-1] = N-1;
         }
     };
 
-    // algo 71: Check whether m is tri-diagonal or not
+    // algo 21: Blocked algorithm for wide bands
+    template <ptrdiff_t cs, ptrdiff_t rs, class M1>
+    struct BandLUDecompose_Helper<21,cs,rs,M1>
+    {
+        static void call(M1& A, ptrdiff_t* P)
+        {
+            // This is a blocked version of algo 11, similar to LAPACK's 
+            // gbtrf, which lets most of the work be done by MultMM.
+            //
+            // With kl = nlo and kv = nhi (= the original nlo+nhi), we
+            // decompose a panel of Nx <= kl columns at a time:
+            //
+            // ( A00 A01 )   ( L00  0 ) ( U00 U01 )
+            // ( A10 A11 ) = ( L10  1 ) (  0  A~  )
+            //
+            // A00 is Nx x Nx.  A10 has the (at most) kl rows below it 
+            // that have nonzero elements in these columns, and A01 has 
+            // the (at most) kv columns to the right of it that have 
+            // nonzero elements in these rows (including fill from the 
+            // pivoting).  A11 is then entirely inside the band.
+            //
+            // The problem is that [A00 A10] and [A00 A01] are not, since
+            // the bottom left corner of A10 and the top right corner of
+            // A01 are outside the band.  So we copy them into dense
+            // work matrices, where the corners are just 0.
+            //
+            // 1) Decompose [A00 A10] = [L00 L10] U00 with the regular
+            //    dense LU algorithm.
+            // 2) Apply the row swaps to [A01 A11].
+            // 3) U01 = L00^-1 A01
+            // 4) A11 -= L10 U01
+            // 5) Copy U01 back into the band.
+            // 6) Undo the row swaps within the panel's L columns,
+            //    since the band storage (and the division routines) 
+            //    expect L not to be permuted by later swaps the way it is 
+            //    for the dense LU.  Then copy the panel back into the band.
+            //
+            typedef typename M1::value_type T;
+            typedef typename M1::real_type RT;
+
+            const ptrdiff_t N = rs==Unknown ? A.rowsize() : rs;
+            const ptrdiff_t kl = A.nlo();
+            const ptrdiff_t kv = A.nhi();
+            const ptrdiff_t Nx = TMV_MIN(ptrdiff_t(TMV_BANDLU_BLOCKSIZE),kl);
+            const ptrdiff_t xx = Unknown;
+#ifdef PRINTALGO_LU
+            std::cout<<"BandLUDecompose algo 21: M,N,cs,rs = "<<A.colsize()<<
+                ','<<N<<','<<cs<<','<<rs<<std::endl;
+#endif
+
+            typedef typename M1::submatrix_type M1s;
+            typedef typename MCopyHelper<T,Rec,xx,xx,ColMajor>::type Mw;
+            typedef typename Mw::submatrix_type Mws;
+            typedef typename Mw::const_submatrix_type Mwsc;
+            typedef typename Mws::const_unit_lowertri_type Mwl;
+            const Scaling<-1,RT> mone;
+
+            ScratchScope scope;
+            Mw Wp(Nx+kl,Nx);   // [A00 A10]
+            Mw Wu(Nx,kv);      // [A00 A01]
+            ptrdiff_t Pp[TMV_BANDLU_BLOCKSIZE];
+
+            for (ptrdiff_t j=0; j<N; j+=Nx) {
+                const ptrdiff_t nb = TMV_MIN(Nx,N-j);
+                const ptrdiff_t m = TMV_MIN(nb+kl,N-j);
+                const ptrdiff_t n = TMV_MIN(kv,N-j-nb);
+                const ptrdiff_t j2 = j+nb;
+
+                // Copy the panel into Wp.
+                Mws W0 = Wp.cSubMatrix(0,m,0,nb);
+                W0.setZero();
+                for (ptrdiff_t jj=0; jj<nb; ++jj) {
+                    const ptrdiff_t i1 = TMV_MAX(j,j+jj-kv);
+                    const ptrdiff_t i2 = TMV_MIN(N,j+jj+kl+1);
+                    W0.col(jj,i1-j,i2-j).noAlias() = A.col(j+jj,i1,i2);
+                }
+
+                // 1) Decompose the panel.
+                LUDecompose_Helper<-2,xx,xx,Mws>::call(W0,Pp);
+
+                // 2) Apply the swaps to the columns to the right.
+                for (ptrdiff_t jj=0; jj<nb; ++jj) {
+                    if (Pp[jj] != jj) {
+                        const ptrdiff_t endrow = TMV_MIN(N,j+jj+kv+1);
+                        if (j2 < endrow)
+                            Swap(A.row(j+Pp[jj],j2,endrow),
+                                 A.row(j+jj,j2,endrow));
+                    }
+                    P[j+jj] = j + Pp[jj];
+                }
+
+                if (n > 0) {
+                    // Copy A01 into Wu.
+                    Mws W1 = Wu.cSubMatrix(0,nb,0,n);
+                    W1.setZero();
+                    for (ptrdiff_t jj=0; jj<n; ++jj) {
+                        const ptrdiff_t i1 = TMV_MAX(j,j2+jj-kv);
+                        if (i1 < j2)
+                            W1.col(jj,i1-j,nb).noAlias() = A.col(j2+jj,i1,j2);
+                    }
+
+                    // 3) U01 = L00^-1 A01
+                    Mwl L00 = W0.cSubMatrix(0,nb,0,nb).unitLowerTri();
+                    LDivEqMU_Helper<-2,xx,xx,Mws,Mwl>::call(W1,L00);
+
+                    // 4) A11 -= L10 U01
+                    if (m > nb) {
+                        Mwsc L10 = W0.cSubMatrix(nb,m,0,nb);
+                        M1s A11 = A.cSubMatrix(j2,j+m,j2,j2+n);
+                        MultMM_Helper<-2,xx,xx,xx,true,-1,RT,Mwsc,Mws,M1s>::
+                            call(mone,L10,W1,A11);
+                    }
+
+                    // 5) Copy U01 back.
+                    for (ptrdiff_t jj=0; jj<n; ++jj) {
+                        const ptrdiff_t i1 = TMV_MAX(j,j2+jj-kv);
+                        if (i1 < j2)
+                            A.col(j2+jj,i1,j2).noAlias() = W1.col(jj,i1-j,nb);
+                    }
+                }
+
+                // 6) Undo the swaps in the L part and copy the panel back.
+                for (ptrdiff_t jj=nb-1; jj>0; --jj) {
+                    if (Pp[jj] != jj) 
+                        Swap(W0.row(jj,0,jj),W0.row(Pp[jj],0,jj));
+                }
+                for (ptrdiff_t jj=0; jj<nb; ++jj) {
+                    const ptrdiff_t i1 = TMV_MAX(j,j+jj-kv);
+                    const ptrdiff_t i2 = TMV_MIN(N,j+jj+kl+1);
+                    A.col(j+jj,i1,i2).noAlias() = W0.col(jj,i1-j,i2-j);
+                }
+            }
+        }
+    };
+
+    // algo 71: Check the band widths at run time
     template <ptrdiff_t cs, ptrdiff_t rs, class M>
-    struct BandLUDecompose_Helper<81,cs,rs,M>
+    struct BandLUDecompose_Helper<71,cs,rs,M>
     {
         static void call(M& m, ptrdiff_t* P)
         {
 #ifdef PRINTALGO_BandLU
             std::cout<<"BandLUDecompose algo 71: cs,rs = "<<cs<<','<<rs<<std::endl;
 #endif
-            const ptrdiff_t lo = m._nlo==Unknown ? m.nlo() : m._nlo;
-            const ptrdiff_t hi = m._nhi==Unknown ? m.nhi() : m._nhi;
+            const ptrdiff_t lo = M::_nlo==Unknown ? m.nlo() : ptrdiff_t(M::_nlo);
+            const ptrdiff_t hi = M::_nhi==Unknown ? m.nhi() : ptrdiff_t(M::_nhi);
             // Note: hi is the original lo+hi, so if the original was tridiagonal, then hi==2.
+            // Algos 11 and 21 need colmajor storage, so a DiagMajor band
+            // (which algo -3 sends here when the band widths aren't known)
+            // is copied to colmajor unless it turns out to be tridiagonal.
+            const int algo11 = M::_colmajor ? 11 : 81;
+            const int algo21 = M::_colmajor ? 21 : 81;
             if (lo == 1 && hi == 2) 
-                BandLUDecompose_Helper<11,cs,rs,Mcm>::call(m,P);
+                BandLUDecompose_Helper<31,cs,rs,M>::call(m,P);
+            else if (lo >= TMV_BANDLU_BLOCK_MINLO)
+                BandLUDecompose_Helper<algo21,cs,rs,M>::call(m,P);
             else
-                BandLUDecompose_Helper<21,cs,rs,Mcm>::call(m,P);
+                BandLUDecompose_Helper<algo11,cs,rs,M>::call(m,P);
         }
     };
 
@@ -257,8 +410,11 @@ namespace tmv {
 #endif
             typedef typename M::value_type T;
             typedef typename MCopyHelper<T,Band,cs,rs,ColMajor>::type Mcm;
+            ScratchScope scope;
             Mcm mcm = m;
-            BandLUDecompose_Helper<-2,cs,rs,Mcm>::call(mcm,P);
+            // The copy is already in the storage the inline algorithms
+            // want, so don't go back through -2.
+            BandLUDecompose_Helper<-4,cs,rs,Mcm>::call(mcm,P);
             m.noAlias() = mcm;
         }
     };
@@ -274,8 +430,11 @@ namespace tmv {
 #endif
             typedef typename M::value_type T;
             typedef typename MCopyHelper<T,Band,cs,rs,DiagMajor>::type Mdm;
+            ScratchScope scope;
             Mdm mdm = m;
-            BandLUDecompose_Helper<-2,cs,rs,Mdm>::call(mdm,P);
+            // The copy is already in the storage the inline algorithms
+            // want, so don't go back through -2.
+            BandLUDecompose_Helper<-4,cs,rs,Mdm>::call(mdm,P);
             m.noAlias() = mdm;
         }
     };
@@ -310,8 +469,10 @@ namespace tmv {
             const int algo = 
                 cs == 0 || rs == 0 || cs == 1 ? 0 :
                 TMV_OPT == 0 ? 11 :
-                (M::_nlo == 1 && M::_nhi == 2) ? 21 :
-                11;
+                (M1::_nlo == 1 && M1::_nhi == 2) ? 31 :
+                (M1::_nlo != Unknown && M1::_nlo < TMV_BANDLU_BLOCK_MINLO) ? 11 :
+                (cs != Unknown && cs <= TMV_BANDLU_BLOCK_MINLO) ? 11 :
+                71;
 #ifdef PRINTALGO_BandLU
             std::cout<<"Inline BandLUDecompose: \n";
             std::cout<<"m = "<<TMV_Text(m)<<std::endl;
@@ -367,10 +528,10 @@ namespace tmv {
             const int algo = 
                 cs == 0 || rs == 0 || cs == 1 ? 0 :
                 TMV_OPT == 0 ? 11 :
-                (M::_nlo == 1 && M::_nhi == 2) ? dmalgo :
-                (N::_nlo != 1 && M::_nlo != Unknown) ? cmalgo :
-                (N::_nhi != 2 && M::_nhi != Unknown) ? cmalgo :
-                (M::_nlo == Unknown || M::_nhi == Unknown) ? 71 :
+                (M1::_nlo == 1 && M1::_nhi == 2) ? dmalgo :
+                (M1::_nlo != 1 && M1::_nlo != Unknown) ? cmalgo :
+                (M1::_nhi != 2 && M1::_nhi != Unknown) ? cmalgo :
+                (M1::_colmajor || M1::_diagmajor) ? -4 :
                 cmalgo;
 #ifdef PRINTALGO_BandLU
             const ptrdiff_t M = cs==Unknown ? m.colsize() : cs;
@@ -445,13 +606,13 @@ namespace tmv {
     template <class T, int A>
     TMV_INLINE void BandLU_Decompose(BandMatrixView<T,A> m, Permutation& P)
     {
-        typedef MatrixView<T,A> M;
+        typedef BandMatrixView<T,A> M;
         BandLU_Decompose(static_cast<BaseMatrix_Band_Mutable<M>&>(m),P); 
     }
     template <class T, ptrdiff_t M, ptrdiff_t N, ptrdiff_t lo, ptrdiff_t hi, ptrdiff_t Si, ptrdiff_t Sj, int A>
     TMV_INLINE void BandLU_Decompose(SmallBandMatrixView<T,M,N,lo,hi,Si,Sj,A> m, Permutation& P)
     {
-        typedef SmallMatrixView<T,M,N,lo,hi,Si,Sj,A> MM;
+        typedef SmallBandMatrixView<T,M,N,lo,hi,Si,Sj,A> MM;
         BandLU_Decompose(static_cast<BaseMatrix_Band_Mutable<MM>&>(m),P); 
     }
 
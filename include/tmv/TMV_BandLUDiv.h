@@ -1,41 +1,67 @@
-
-
 #ifndef TMV_BandLUDiv_H
 #define TMV_BandLUDiv_H
 
 #include "TMV_BaseMatrix_Rec.h"
-#include "TMV_BaseMatrix_Tri.h"
+#include "TMV_BaseMatrix_Band.h"
 #include "TMV_Permutation.h"
-#include "TMV_DivVM_Funcs.h"
-#include "TMV_DivMM_Funcs.h"
-#include "TMV_MultMM_Funcs.h"
+#include "TMV_MultXV.h"
+#include "TMV_MultVV.h"
+#include "TMV_ScaleV.h"
+#include "TMV_MultMV.h"
+#include "TMV_Rank1VVM.h"
+
+#ifdef _OPENMP
+#include "omp.h"
+#endif
 
 #ifdef PRINTALGO_BandLU
 #include <iostream>
-#include "TMV_ProdMV.h"
-#include "TMV_ProdMM.h"
 #endif
 
+// BLOCKSIZE is the number of columns of the right hand side that are
+// done together by algo 22.  The factors are read once for each block,
+// and the rows of the block that are being updated, (at most nlo+nhi+1
+// of them) should stay in the L2 cache.
+#define TMV_BANDLU_SOLVE_BLOCKSIZE 64
+
+// OPENMP_THRESH is the minimum N * ncols * (nlo+nhi+1) for which the
+// blocks of the right hand side are split up among the threads.
+#define TMV_BANDLU_SOLVE_OPENMP_THRESH 1048576
+
 namespace tmv {
 
     // Defined in TMV_BandLUDiv.cpp
     template <class T1, int C1, class T2>
     void InstBandLU_SolveInPlace(
-        const ConstMatrixView<T1,C1>& m1, const Permutation& P,
+        const ConstBandMatrixView<T1,C1>& m1, const Permutation& P,
         MatrixView<T2> m2);
     template <class T1, int C1, class T2>
     void InstBandLU_SolveTransposeInPlace(
-        const ConstMatrixView<T1,C1>& m1, const Permutation& P,
+        const ConstBandMatrixView<T1,C1>& m1, const Permutation& P,
         MatrixView<T2> m2);
     template <class T1, int C1, class T2>
     void InstBandLU_SolveInPlace(
-        const ConstMatrixView<T1,C1>& m1, const Permutation& P,
+        const ConstBandMatrixView<T1,C1>& m1, const Permutation& P,
         VectorView<T2> v2);
     template <class T1, int C1, class T2>
     void InstBandLU_SolveTransposeInPlace(
-        const ConstMatrixView<T1,C1>& m1, const Permutation& P,
+        const ConstBandMatrixView<T1,C1>& m1, const Permutation& P,
         VectorView<T2> v2);
 
+    // m1 holds the LU decomposition from BandLU_Decompose, so m1.nhi()
+    // is the nlo+nhi of the original matrix.  L is stored in the lower
+    // band, but it is not permuted by the later row swaps, so
+    // A = P0 L0 P1 L1 ... U, where Pj swaps rows j and P[j], and Lj is
+    // the unit lower triangle matrix with m1.col(j,j+1,j+nlo+1) below the
+    // diagonal in column j.  (This is the same convention as LAPACK's
+    // gbtrf.)  So the solution is:
+    //
+    // x = U^-1 ... L1^-1 P1 L0^-1 P0 b
+    //
+    // and for the transpose:
+    //
+    // x = P0 L0^-T P1 L1^-T ... U^-T b
+
     template <int algo, bool trans, ptrdiff_t cs, ptrdiff_t rs, class M1, class M2>
     struct BandLU_Solve_Helper;
 
@@ -45,68 +71,303 @@ namespace tmv {
     struct BandLU_Solve_Helper<0,trans,cs,rs,M1,M2>
     { static TMV_INLINE void call(const M1& , const Permutation& , M2& ) {} };
 
-    // algo 11: Normal case
-    template <ptrdiff_t cs, ptrdiff_t rs, class M1, class M2>
-    struct BandLU_Solve_Helper<11,false,cs,rs,M1,M2>
+    // algo 11: Single vector
+    template <ptrdiff_t cs, ptrdiff_t rs, class M1, class V2>
+    struct BandLU_Solve_Helper<11,false,cs,rs,M1,V2>
     {
-        static void call(const M1& m1, const Permutation& P, M2& m2)
+        static void call(const M1& m1, const Permutation& P, V2& v2)
         {
+            typedef typename M1::value_type T1;
+            typedef typename V2::value_type T2;
+            typedef typename M1::const_col_sub_type M1c;
+            typedef typename V2::subvector_type V2s;
+            const ptrdiff_t N = cs==Unknown ? v2.size() : cs;
+            const ptrdiff_t nlo = m1.nlo();
+            const ptrdiff_t nhi = m1.nhi();
+            const ptrdiff_t xx = Unknown;
 #ifdef PRINTALGO_BandLU
-            std::cout<<"BandLUSolve algo 11: trans,cs,rs = "<<
-                false<<','<<cs<<','<<rs<<std::endl;
-            //std::cout<<"m1 = "<<m1<<std::endl;
-            //std::cout<<"m2 = "<<m2<<std::endl;
-#endif
-            // m2 = (PLU)^-1 m2
-            //    = U^-1 L^-1 Pt m2
-            P.inverse().applyOnLeft(m2);
-#ifdef PRINTALGO_BandLU
-            //std::cout<<"after permute m2 => "<<m2<<std::endl;
+            std::cout<<"BandLUSolve algo 11: trans,N,nlo,nhi = "<<
+                false<<','<<N<<','<<nlo<<','<<nhi<<std::endl;
 #endif
-            typename M2::noalias_type m2na = m2.noAlias();
-            TriLDivEq(m2na,m1.unitLowerTri());
+            TMVAssert(!P.isInverse());
+            const ptrdiff_t* p = P.getValues();
+
+            // v2 = (L0^-1 P0 ... ) v2
+            if (nlo > 0) {
+                for(ptrdiff_t j=0; j<N-1; ++j) {
+                    if (p[j] != j) {
+                        const T2 temp = v2.cref(j);
+                        v2.ref(j) = v2.cref(p[j]);
+                        v2.ref(p[j]) = temp;
+                    }
+                    const T2 vj = v2.cref(j);
+                    if (vj != T2(0)) {
+                        const ptrdiff_t end = TMV_MIN(N,j+nlo+1);
+                        M1c m1c = m1.get_col(j,j+1,end);
+                        V2s v2s = v2.cSubVector(j+1,end);
+                        MultXV_Helper<-2,xx,true,0,T2,M1c,V2s>::call(
+                            Scaling<0,T2>(-vj),m1c,v2s);
+                    }
+                }
+            }
+
+            // v2 = U^-1 v2
+            for(ptrdiff_t j=N-1; j>=0; --j) {
+                const T1 Ujj = m1.cref(j,j);
+                const T2 vj = v2.cref(j) / Ujj;
+                v2.ref(j) = vj;
+                if (j > 0 && vj != T2(0)) {
+                    const ptrdiff_t start = TMV_MAX(ptrdiff_t(0),j-nhi);
+                    M1c m1c = m1.get_col(j,start,j);
+                    V2s v2s = v2.cSubVector(start,j);
+                    MultXV_Helper<-2,xx,true,0,T2,M1c,V2s>::call(
+                        Scaling<0,T2>(-vj),m1c,v2s);
+                }
+            }
+        }
+    };
+    template <ptrdiff_t cs, ptrdiff_t rs, class M1, class V2>
+    struct BandLU_Solve_Helper<11,true,cs,rs,M1,V2>
+    {
+        static void call(const M1& m1, const Permutation& P, V2& v2)
+        {
+            typedef typename M1::value_type T1;
+            typedef typename V2::value_type T2;
+            typedef typename M1::const_col_sub_type M1c;
+            typedef typename V2::const_subvector_type V2s;
+            const ptrdiff_t N = cs==Unknown ? v2.size() : cs;
+            const ptrdiff_t nlo = m1.nlo();
+            const ptrdiff_t nhi = m1.nhi();
+            const ptrdiff_t xx = Unknown;
 #ifdef PRINTALGO_BandLU
-            //std::cout<<"after L^-1 m2 => "<<m2<<std::endl;
-            //std::cout<<"L*m2 = "<<m1.unitLowerTri()*m2<<std::endl;
+            std::cout<<"BandLUSolve algo 11: trans,N,nlo,nhi = "<<
+                true<<','<<N<<','<<nlo<<','<<nhi<<std::endl;
 #endif
-            TriLDivEq(m2na,m1.upperTri());
+            TMVAssert(!P.isInverse());
+            const ptrdiff_t* p = P.getValues();
+
+            // v2 = U^-T v2
+            for(ptrdiff_t j=0; j<N; ++j) {
+                const ptrdiff_t start = TMV_MAX(ptrdiff_t(0),j-nhi);
+                const T1 Ujj = m1.cref(j,j);
+                if (start < j) {
+                    M1c m1c = m1.get_col(j,start,j);
+                    V2s v2s = v2.cSubVector(start,j);
+                    v2.ref(j) -= MultVV_Helper<-2,xx,M1c,V2s>::call(m1c,v2s);
+                }
+                v2.ref(j) /= Ujj;
+            }
+
+            // v2 = ( ... P1 L1^-T P0 L0^-T) v2
+            if (nlo > 0) {
+                for(ptrdiff_t j=N-2; j>=0; --j) {
+                    const ptrdiff_t end = TMV_MIN(N,j+nlo+1);
+                    M1c m1c = m1.get_col(j,j+1,end);
+                    V2s v2s = v2.cSubVector(j+1,end);
+                    v2.ref(j) -= MultVV_Helper<-2,xx,M1c,V2s>::call(m1c,v2s);
+                    if (p[j] != j) {
+                        const T2 temp = v2.cref(j);
+                        v2.ref(j) = v2.cref(p[j]);
+                        v2.ref(p[j]) = temp;
+                    }
+                }
+            }
+        }
+    };
+
+    // algo 12: Loop over the columns of m2, using algo 11 for each.
+    template <bool trans, ptrdiff_t cs, ptrdiff_t rs, class M1, class M2>
+    struct BandLU_Solve_Helper<12,trans,cs,rs,M1,M2>
+    {
+        static void call(const M1& m1, const Permutation& P, M2& m2)
+        {
+            const ptrdiff_t K = rs==Unknown ? m2.rowsize() : rs;
 #ifdef PRINTALGO_BandLU
-            //std::cout<<"after U^-1 m2 => "<<m2<<std::endl;
-            //std::cout<<"U*m2 = "<<m1.upperTri()*m2<<std::endl;
+            std::cout<<"BandLUSolve algo 12: trans,N,K = "<<
+                trans<<','<<m2.colsize()<<','<<K<<std::endl;
 #endif
+            typedef typename M2::col_type M2c;
+            for(ptrdiff_t j=0; j<K; ++j) {
+                M2c m2c = m2.get_col(j);
+                BandLU_Solve_Helper<11,trans,cs,1,M1,M2c>::call(m1,P,m2c);
+            }
         }
     };
+
+    // algo 21: Do all the columns of m2 in one sweep through the factors.
+    // Each column of L and U is applied to all of m2 with a rank-1
+    // update (or a MultMV for the transpose) of the rows of m2 that
+    // are in the band.  So the factors are only read once.
     template <ptrdiff_t cs, ptrdiff_t rs, class M1, class M2>
-    struct BandLU_Solve_Helper<11,true,cs,rs,M1,M2>
+    struct BandLU_Solve_Helper<21,false,cs,rs,M1,M2>
     {
         static void call(const M1& m1, const Permutation& P, M2& m2)
         {
+            typedef typename M1::value_type T1;
+            typedef typename M2::real_type RT;
+            typedef typename M1::const_col_sub_type M1c;
+            typedef typename M2::row_type M2r;
+            typedef typename M2::rowrange_type M2rr;
+            const ptrdiff_t N = cs==Unknown ? m2.colsize() : cs;
+            const ptrdiff_t nlo = m1.nlo();
+            const ptrdiff_t nhi = m1.nhi();
+            const ptrdiff_t xx = Unknown;
 #ifdef PRINTALGO_BandLU
-            std::cout<<"BandLUSolve algo 11: trans,cs,rs = "<<
-                true<<','<<cs<<','<<rs<<std::endl;
-            //std::cout<<"m1 = "<<m1<<std::endl;
-            //std::cout<<"m2 = "<<m2<<std::endl;
+            std::cout<<"BandLUSolve algo 21: trans,N,K,nlo,nhi = "<<
+                false<<','<<N<<','<<m2.rowsize()<<','<<nlo<<','<<nhi<<
+                std::endl;
 #endif
-            // m2 = (PLU)^-1t m2
-            //    = (U^-1 L^-1 Pt)t m2
-            //    = P L^-1t U^-1t m2
-            typename M2::noalias_type m2na = m2.noAlias();
-            TriLDivEq(m2na,m1.upperTri().transpose());
+            TMVAssert(!P.isInverse());
+            const ptrdiff_t* p = P.getValues();
+            const Scaling<-1,RT> mone;
+
+            // m2 = (L0^-1 P0 ... ) m2
+            if (nlo > 0) {
+                for(ptrdiff_t j=0; j<N-1; ++j) {
+                    m2.cSwapRows(j,p[j]);
+                    const ptrdiff_t end = TMV_MIN(N,j+nlo+1);
+                    M1c m1c = m1.get_col(j,j+1,end);
+                    M2r m2r = m2.get_row(j);
+                    M2rr m2rr = m2.cRowRange(j+1,end);
+                    Rank1VVM_Helper<-2,xx,rs,true,-1,RT,M1c,M2r,M2rr>::call(
+                        mone,m1c,m2r,m2rr);
+                }
+            }
+
+            // m2 = U^-1 m2
+            for(ptrdiff_t j=N-1; j>=0; --j) {
+                M2r m2r = m2.get_row(j);
+                const Scaling<0,T1> invUjj(T1(1)/m1.cref(j,j));
+                ScaleV_Helper<-2,rs,0,T1,M2r>::call(invUjj,m2r);
+                if (j > 0) {
+                    const ptrdiff_t start = TMV_MAX(ptrdiff_t(0),j-nhi);
+                    M1c m1c = m1.get_col(j,start,j);
+                    M2rr m2rr = m2.cRowRange(start,j);
+                    Rank1VVM_Helper<-2,xx,rs,true,-1,RT,M1c,M2r,M2rr>::call(
+                        mone,m1c,m2r,m2rr);
+                }
+            }
+        }
+    };
+    template <ptrdiff_t cs, ptrdiff_t rs, class M1, class M2>
+    struct BandLU_Solve_Helper<21,true,cs,rs,M1,M2>
+    {
+        static void call(const M1& m1, const Permutation& P, M2& m2)
+        {
+            typedef typename M1::value_type T1;
+            typedef typename M2::real_type RT;
+            typedef typename M1::const_col_sub_type M1c;
+            typedef typename M2::row_type M2r;
+            typedef typename M2::const_rowrange_type::const_transpose_type M2rt;
+            const ptrdiff_t N = cs==Unknown ? m2.colsize() : cs;
+            const ptrdiff_t nlo = m1.nlo();
+            const ptrdiff_t nhi = m1.nhi();
+            const ptrdiff_t xx = Unknown;
 #ifdef PRINTALGO_BandLU
-            //std::cout<<"after UT^-1 m2 => "<<m2<<std::endl;
-            //std::cout<<"Ut*m2 = "<<m1.upperTri().transpose()*m2<<std::endl;
+            std::cout<<"BandLUSolve algo 21: trans,N,K,nlo,nhi = "<<
+                true<<','<<N<<','<<m2.rowsize()<<','<<nlo<<','<<nhi<<
+                std::endl;
 #endif
-            TriLDivEq(m2na,m1.unitLowerTri().transpose());
+            TMVAssert(!P.isInverse());
+            const ptrdiff_t* p = P.getValues();
+            const Scaling<-1,RT> mone;
+
+            // m2 = U^-T m2
+            for(ptrdiff_t j=0; j<N; ++j) {
+                M2r m2r = m2.get_row(j);
+                const ptrdiff_t start = TMV_MAX(ptrdiff_t(0),j-nhi);
+                if (start < j) {
+                    M1c m1c = m1.get_col(j,start,j);
+                    M2rt m2rt = m2.cRowRange(start,j).transpose();
+                    MultMV_Helper<-2,rs,xx,true,-1,RT,M2rt,M1c,M2r>::call(
+                        mone,m2rt,m1c,m2r);
+                }
+                const Scaling<0,T1> invUjj(T1(1)/m1.cref(j,j));
+                ScaleV_Helper<-2,rs,0,T1,M2r>::call(invUjj,m2r);
+            }
+
+            // m2 = ( ... P1 L1^-T P0 L0^-T) m2
+            if (nlo > 0) {
+                for(ptrdiff_t j=N-2; j>=0; --j) {
+                    const ptrdiff_t end = TMV_MIN(N,j+nlo+1);
+                    M1c m1c = m1.get_col(j,j+1,end);
+                    M2r m2r = m2.get_row(j);
+                    M2rt m2rt = m2.cRowRange(j+1,end).transpose();
+                    MultMV_Helper<-2,rs,xx,true,-1,RT,M2rt,M1c,M2r>::call(
+                        mone,m2rt,m1c,m2r);
+                    m2.cSwapRows(j,p[j]);
+                }
+            }
+        }
+    };
+
+    // algo 22: Split m2 into blocks of TMV_BANDLU_SOLVE_BLOCKSIZE columns
+    // and do each block with algo 21.  This keeps the active rows of
+    // each block in cache while reading the factors once per block,
+    // rather than once per column as in algo 12.
+    template <bool trans, ptrdiff_t cs, ptrdiff_t rs, class M1, class M2>
+    struct BandLU_Solve_Helper<22,trans,cs,rs,M1,M2>
+    {
+        static void call(const M1& m1, const Permutation& P, M2& m2)
+        {
+            const ptrdiff_t K = rs==Unknown ? m2.rowsize() : rs;
 #ifdef PRINTALGO_BandLU
-            //std::cout<<"after LT^-1 m2 => "<<m2<<std::endl;
-            //std::cout<<"LT*m2 = "<<m1.unitLowerTri().transpose()*m2<<std::endl;
+            std::cout<<"BandLUSolve algo 22: trans,N,K = "<<
+                trans<<','<<m2.colsize()<<','<<K<<std::endl;
 #endif
-            P.applyOnLeft(m2);
+            typedef typename M2::colrange_type M2c;
+            const ptrdiff_t xx = Unknown;
+            const ptrdiff_t Kb = TMV_BANDLU_SOLVE_BLOCKSIZE;
+            for(ptrdiff_t j1=0; j1<K; j1+=Kb) {
+                const ptrdiff_t j2 = TMV_MIN(K,j1+Kb);
+                M2c m2c = m2.cColRange(j1,j2);
+                BandLU_Solve_Helper<21,trans,cs,xx,M1,M2c>::call(m1,P,m2c);
+            }
+        }
+    };
+
+#ifdef _OPENMP
+    // algo 32: Split the column blocks of m2 among the threads.
+    // Each thread gets a multiple of TMV_BANDLU_SOLVE_BLOCKSIZE columns
+    // (except the last), and does them with algo 22.
+    template <bool trans, ptrdiff_t cs, ptrdiff_t rs, class M1, class M2>
+    struct BandLU_Solve_Helper<32,trans,cs,rs,M1,M2>
+    {
+        static void call(const M1& m1, const Permutation& P, M2& m2)
+        {
+            const ptrdiff_t N = cs==Unknown ? m2.colsize() : cs;
+            const ptrdiff_t K = rs==Unknown ? m2.rowsize() : rs;
+            const ptrdiff_t Kb = TMV_BANDLU_SOLVE_BLOCKSIZE;
+            const double work =
+                double(N) * double(K) * double(m1.nlo()+m1.nhi()+1);
+            if (K > Kb && work >= TMV_BANDLU_SOLVE_OPENMP_THRESH &&
+                omp_get_level() == 0 && omp_get_max_threads() > 1) {
 #ifdef PRINTALGO_BandLU
-            //std::cout<<"after reverse permute m2 => "<<m2<<std::endl;
+                std::cout<<"BandLUSolve algo 32: trans,N,K = "<<
+                    trans<<','<<N<<','<<K<<std::endl;
 #endif
+                typedef typename M2::colrange_type M2c;
+                const ptrdiff_t xx = Unknown;
+#pragma omp parallel
+                {
+                    const int num_threads = omp_get_num_threads();
+                    const int mythread = omp_get_thread_num();
+                    ptrdiff_t nblocks = (K-1)/Kb + 1;
+                    ptrdiff_t Kx = ((nblocks-1)/num_threads + 1) * Kb;
+                    ptrdiff_t j1 = mythread * Kx;
+                    ptrdiff_t j2 = TMV_MIN(K,j1+Kx);
+                    if (j1 < K) {
+                        M2c m2c = m2.cColRange(j1,j2);
+                        BandLU_Solve_Helper<22,trans,cs,xx,M1,M2c>::call(
+                            m1,P,m2c);
+                    }
+                }
+            } else {
+                BandLU_Solve_Helper<22,trans,cs,rs,M1,M2>::call(m1,P,m2);
+            }
         }
     };
+#endif
 
     // algo 90: call InstBandLU_Solve
     template <ptrdiff_t cs, ptrdiff_t rs, class M1, class M2>
@@ -122,7 +383,7 @@ namespace tmv {
         { InstBandLU_SolveTransposeInPlace(m1.xView(),P,m2.xView()); }
     };
 
-    // algo 95: Turn m1,m3 into vector
+    // algo 95: Turn m2 into vector
     template <bool trans, ptrdiff_t cs, ptrdiff_t rs, class M1, class M2>
     struct BandLU_Solve_Helper<95,trans,cs,rs,M1,M2>
     {
@@ -157,22 +418,24 @@ namespace tmv {
         {
             const bool invalid =
                 M1::iscomplex && M2::isreal;
-            const int algo = 
-                cs == 0 || rs == 0 || invalid ? 0 : 
-                11;
+            const int algo =
+                cs == 0 || rs == 0 || invalid ? 0 :
+                ShapeTraits<M2::_shape>::vector ? 11 :
+                TMV_OPT == 0 ? 12 :
+                (rs != Unknown && rs <= TMV_BANDLU_SOLVE_BLOCKSIZE) ? 21 :
+#ifdef _OPENMP
+                32;
+#else
+                22;
+#endif
 #ifdef PRINTALGO_BandLU
             std::cout<<"Inline BandLUSolve\n";
             std::cout<<"trans,cs,rs = "<<trans<<','<<cs<<','<<rs<<std::endl;
             std::cout<<"m1 = "<<TMV_Text(m1)<<std::endl;
             std::cout<<"m2 = "<<TMV_Text(m2)<<std::endl;
             std::cout<<"algo = "<<algo<<std::endl;
-            //std::cout<<"m1 = "<<m1<<std::endl;
-            //std::cout<<"m2 = "<<m2<<std::endl;
 #endif
             BandLU_Solve_Helper<algo,trans,cs,rs,M1,M2>::call(m1,P,m2);
-#ifdef PRINTALGO_BandLU
-            //std::cout<<"m2 => "<<m2<<std::endl;
-#endif
         }
     };
 
@@ -184,7 +447,7 @@ namespace tmv {
         {
             typedef typename M1::value_type T1;
             typedef typename M2::value_type T2;
-            const bool inst = 
+            const bool inst =
                 (cs == Unknown || cs > 16) &&
                 (rs == Unknown || rs > 16 || rs == 1) &&
 #ifdef TMV_INST_MIX
@@ -192,14 +455,13 @@ namespace tmv {
 #else
                 Traits2<T1,T2>::sametype &&
 #endif
-                M1::_colmajor && 
                 Traits<T1>::isinst;
             const bool makevector =
                 rs == 1 && !ShapeTraits<M2::_shape>::vector;
             const bool invalid =
                 M1::iscomplex && M2::isreal;
-            const int algo = 
-                cs == 0 || rs == 0 || invalid ? 0 : 
+            const int algo =
+                cs == 0 || rs == 0 || invalid ? 0 :
                 makevector ? 95 :
                 M2::_conj ? 97 :
                 inst ? 90 :
@@ -217,10 +479,12 @@ namespace tmv {
 
     template <class M1, class M2>
     inline void InlineBandLU_SolveInPlace(
-        const BaseMatrix_Rec<M1>& m1, const Permutation& P,
+        const BaseMatrix_Band<M1>& m1, const Permutation& P,
         BaseMatrix_Rec_Mutable<M2>& m2)
     {
-        const ptrdiff_t cs = M2::_colsize;
+        TMVAssert(m1.isSquare());
+        TMVAssert(m1.colsize() == m2.colsize());
+        const ptrdiff_t cs = Sizes<M1::_colsize,M2::_colsize>::size;
         const ptrdiff_t rs = M2::_rowsize;
         typedef typename M1::const_cview_type M1v;
         typedef typename M2::cview_type M2v;
@@ -231,10 +495,12 @@ namespace tmv {
 
     template <class M1, class M2>
     inline void BandLU_SolveInPlace(
-        const BaseMatrix_Rec<M1>& m1, const Permutation& P,
+        const BaseMatrix_Band<M1>& m1, const Permutation& P,
         BaseMatrix_Rec_Mutable<M2>& m2)
     {
-        const ptrdiff_t cs = M2::_colsize;
+        TMVAssert(m1.isSquare());
+        TMVAssert(m1.colsize() == m2.colsize());
+        const ptrdiff_t cs = Sizes<M1::_colsize,M2::_colsize>::size;
         const ptrdiff_t rs = M2::_rowsize;
         typedef typename M1::const_cview_type M1v;
         typedef typename M2::cview_type M2v;
@@ -245,10 +511,12 @@ namespace tmv {
 
     template <class M1, class V2>
     inline void InlineBandLU_SolveInPlace(
-        const BaseMatrix_Rec<M1>& m1, const Permutation& P,
+        const BaseMatrix_Band<M1>& m1, const Permutation& P,
         BaseVector_Mutable<V2>& v2)
     {
-        const ptrdiff_t cs = V2::_size;
+        TMVAssert(m1.isSquare());
+        TMVAssert(m1.colsize() == v2.size());
+        const ptrdiff_t cs = Sizes<M1::_colsize,V2::_size>::size;
         typedef typename M1::const_cview_type M1v;
         typedef typename V2::cview_type V2v;
         TMV_MAYBE_CREF(M1,M1v) m1v = m1.cView();
@@ -258,10 +526,12 @@ namespace tmv {
 
     template <class M1, class V2>
     inline void BandLU_SolveInPlace(
-        const BaseMatrix_Rec<M1>& m1, const Permutation& P,
+        const BaseMatrix_Band<M1>& m1, const Permutation& P,
         BaseVector_Mutable<V2>& v2)
     {
-        const ptrdiff_t cs = V2::_size;
+        TMVAssert(m1.isSquare());
+        TMVAssert(m1.colsize() == v2.size());
+        const ptrdiff_t cs = Sizes<M1::_colsize,V2::_size>::size;
         typedef typename M1::const_cview_type M1v;
         typedef typename V2::cview_type V2v;
         TMV_MAYBE_CREF(M1,M1v) m1v = m1.cView();
@@ -271,10 +541,12 @@ namespace tmv {
 
     template <class M1, class M2>
     inline void InlineBandLU_SolveTransposeInPlace(
-        const BaseMatrix_Rec<M1>& m1, const Permutation& P,
+        const BaseMatrix_Band<M1>& m1, const Permutation& P,
         BaseMatrix_Rec_Mutable<M2>& m2)
     {
-        const ptrdiff_t cs = M2::_colsize;
+        TMVAssert(m1.isSquare());
+        TMVAssert(m1.colsize() == m2.colsize());
+        const ptrdiff_t cs = Sizes<M1::_colsize,M2::_colsize>::size;
         const ptrdiff_t rs = M2::_rowsize;
         typedef typename M1::const_cview_type M1v;
         typedef typename M2::cview_type M2v;
@@ -285,10 +557,12 @@ namespace tmv {
 
     template <class M1, class M2>
     inline void BandLU_SolveTransposeInPlace(
-        const BaseMatrix_Rec<M1>& m1, const Permutation& P,
+        const BaseMatrix_Band<M1>& m1, const Permutation& P,
         BaseMatrix_Rec_Mutable<M2>& m2)
     {
-        const ptrdiff_t cs = M2::_colsize;
+        TMVAssert(m1.isSquare());
+        TMVAssert(m1.colsize() == m2.colsize());
+        const ptrdiff_t cs = Sizes<M1::_colsize,M2::_colsize>::size;
         const ptrdiff_t rs = M2::_rowsize;
         typedef typename M1::const_cview_type M1v;
         typedef typename M2::cview_type M2v;
@@ -299,10 +573,12 @@ namespace tmv {
 
     template <class M1, class V2>
     inline void InlineBandLU_SolveTransposeInPlace(
-        const BaseMatrix_Rec<M1>& m1, const Permutation& P,
+        const BaseMatrix_Band<M1>& m1, const Permutation& P,
         BaseVector_Mutable<V2>& v2)
     {
-        const ptrdiff_t cs = V2::_size;
+        TMVAssert(m1.isSquare());
+        TMVAssert(m1.colsize() == v2.size());
+        const ptrdiff_t cs = Sizes<M1::_colsize,V2::_size>::size;
         typedef typename M1::const_cview_type M1v;
         typedef typename V2::cview_type V2v;
         TMV_MAYBE_CREF(M1,M1v) m1v = m1.cView();
@@ -312,10 +588,12 @@ namespace tmv {
 
     template <class M1, class V2>
     inline void BandLU_SolveTransposeInPlace(
-        const BaseMatrix_Rec<M1>& m1, const Permutation& P,
+        const BaseMatrix_Band<M1>& m1, const Permutation& P,
         BaseVector_Mutable<V2>& v2)
     {
-        const ptrdiff_t cs = V2::_size;
+        TMVAssert(m1.isSquare());
+        TMVAssert(m1.colsize() == v2.size());
+        const ptrdiff_t cs = Sizes<M1::_colsize,V2::_size>::size;
         typedef typename M1::const_cview_type M1v;
         typedef typename V2::cview_type V2v;
         TMV_MAYBE_CREF(M1,M1v) m1v = m1.cView();
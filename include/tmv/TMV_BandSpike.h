@@ -0,0 +1,282 @@
+#ifndef TMV_BandSpike_H
+#define TMV_BandSpike_H
+
+#include "TMV_BaseMatrix_Band.h"
+#include "TMV_BandMatrix.h"
+#include "TMV_Matrix.h"
+#include "TMV_Vector.h"
+#include "TMV_Permutation.h"
+#include "TMV_BandLUDecompose.h"
+#include "TMV_BandLUDiv.h"
+#include "TMV_MultMV.h"
+#include <vector>
+
+#ifdef _OPENMP
+#include "omp.h"
+#endif
+
+#ifdef PRINTALGO_BandLU
+#include <iostream>
+#endif
+
+// MINBLOCK is the minimum size of each partition, in units of
+// nlo+nhi+1.  Each partition needs at least nlo+nhi rows for the
+// reduced system to make sense, and if they are much smaller than this,
+// the reduced system is no longer small compared to the full problem.
+#define TMV_BANDSPIKE_MINBLOCK 8
+
+namespace tmv {
+
+    //
+    // Solve A x = b for a single long vector b with the SPIKE algorithm.
+    //
+    // This is a different way to solve a band system that is meant for
+    // a single right hand side with N >> nlo,nhi, where the usual
+    // LU decomposition and solve are both completely serial.
+    //
+    // The rows of A are split into p partitions, and A is written as
+    // A = D S, where D = diag(A_0, A_1, ... A_p-1) are the diagonal blocks
+    // of A.  Then S is the identity matrix except for the "spikes":
+    //
+    // V_i = A_i^-1 (0 B_i)^T,  W_i = A_i^-1 (C_i 0)^T
+    //
+    // where B_i is the nhi x nhi block of A coupling partition i to the
+    // first nhi columns of partition i+1, and C_i is the nlo x nlo block
+    // coupling it to the last nlo columns of partition i-1.
+    //
+    // Each A_i is LU decomposed, and the spikes and g_i = A_i^-1 b_i are
+    // found, independently (and in parallel with OpenMP).  Then the
+    // bottom nlo and top nhi rows of S x = g involve only the bottom nlo
+    // and top nhi elements of each x_i, so they form a reduced band system
+    // of size (p-1)(nlo+nhi), which is solved with a normal band LU.
+    // Finally, each x_i = g_i - V_i x_i+1(top) - W_i x_i-1(bottom),
+    // again in parallel.
+    //
+    // This takes about 2-3 times as many flops as the regular LU solution,
+    // so it is only faster than BandLU_Decompose + BandLU_SolveInPlace
+    // when there are more than 2 or 3 threads.
+    //
+    // Also, each A_i must be nonsingular, which is not guaranteed for a
+    // general nonsingular A, even with the pivoting within each A_i.
+    // (It is guaranteed for diagonally dominant and positive definite A.)
+    // If some A_i turns out to be singular, we fall back to the
+    // regular LU solution for the whole matrix.  An A_i that is nearly 
+    // singular is just as bad, since the error in the spikes grows with 
+    // the condition of A_i, so we treat a pivot smaller than 
+    // sqrt(eps) max|A_i| as singular too.  This still allows A_i with
+    // a condition up to about 1/sqrt(eps), which can lose up to half of 
+    // the digits in x.  If that matters, use the regular LU solution.
+    //
+    // nparts is the number of partitions to use.  The default (0) uses
+    // one partition for each OpenMP thread.
+    //
+
+    template <class T1, class M1, class V2>
+    void BandSpike_FullSolve(const M1& m1, V2& v2)
+    {
+        const ptrdiff_t N = m1.colsize();
+        const ptrdiff_t lo = m1.nlo();
+        const ptrdiff_t hi = m1.nhi();
+        BandMatrix<T1,ColMajor> LU(N,N,lo,lo+hi,T1(0));
+        LU.cSubBandMatrix(0,N,0,N,lo,hi) = m1;
+        std::vector<ptrdiff_t> P(N);
+        InlineBandLU_Decompose(LU,&P[0]);
+        Permutation PP(N,&P[0]);
+        InlineBandLU_SolveInPlace(LU,PP,v2);
+    }
+
+    template <class M1, class V2>
+    void BandSpike_Solve(const M1& m1, V2& v2, int nparts)
+    {
+        typedef typename M1::value_type T1;
+        typedef typename M1::real_type RT1;
+        typedef typename V2::value_type T2;
+        typedef typename V2::real_type RT;
+        typedef typename BandMatrix<T1,ColMajor>::subbandmatrix_type MLU;
+        typedef typename Matrix<T1,ColMajor>::rowrange_type MVW;
+        typedef typename V2::subvector_type V2s;
+        const ptrdiff_t xx = Unknown;
+
+        const ptrdiff_t N = m1.colsize();
+        const ptrdiff_t lo = m1.nlo();
+        const ptrdiff_t hi = m1.nhi();
+        const ptrdiff_t k = lo + hi;
+
+        ptrdiff_t p = nparts;
+#ifdef _OPENMP
+        if (p <= 0) p = omp_get_max_threads();
+#else
+        if (p <= 0) p = 1;
+#endif
+        const ptrdiff_t maxp = N / (TMV_BANDSPIKE_MINBLOCK * (k+1));
+        if (p > maxp) p = maxp;
+#ifdef PRINTALGO_BandLU
+        std::cout<<"BandSpike_Solve: N,lo,hi = "<<N<<','<<lo<<','<<hi<<
+            "  p = "<<p<<std::endl;
+#endif
+        if (p <= 1 || k == 0) {
+            BandSpike_FullSolve<T1>(m1,v2);
+            return;
+        }
+
+        // The partition i is rows start[i] .. start[i+1].
+        std::vector<ptrdiff_t> start(p+1);
+        for(ptrdiff_t i=0; i<=p; ++i) start[i] = (N/p)*i;
+        start[p] = N;
+
+        // The LU decompositions of the A_i are stored in the same
+        // places as they would be for the full LU decomposition,
+        // and the spikes in VW: V_i in the first hi columns, and W_i
+        // in the last lo columns of rows start[i] .. start[i+1].
+        BandMatrix<T1,ColMajor> LU(N,N,lo,k,T1(0));
+        std::vector<ptrdiff_t> P(N);
+        Matrix<T1,ColMajor> VW(N,k,T1(0));
+        // The g_i go in g rather than v2, so v2 still has b if we need
+        // to fall back to the full solution.
+        Vector<T2> g = v2;
+        const RT1 sqrteps = TMV_SQRT(TMV_Epsilon<RT1>());
+        bool singular = false;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(||:singular)
+#endif
+        for(ptrdiff_t i=0; i<p; ++i) {
+            const ptrdiff_t i1 = start[i];
+            const ptrdiff_t i2 = start[i+1];
+            const ptrdiff_t n = i2-i1;
+            MLU LUi = LU.cSubBandMatrix(i1,i2,i1,i2,lo,k);
+            LUi.cSubBandMatrix(0,n,0,n,lo,hi) =
+                m1.cSubBandMatrix(i1,i2,i1,i2,lo,hi);
+            const RT1 thresh = sqrteps * LUi.maxAbsElement();
+            InlineBandLU_Decompose(LUi,&P[i1]);
+            // The pivots are relative to i1 here.
+            bool sing = false;
+            for(ptrdiff_t j=0; j<n; ++j) 
+                if (!(TMV_ABS(LUi.cref(j,j)) > thresh)) sing = true;
+            if (sing) { singular = true; continue; }
+            Permutation Pi(n,&P[i1]);
+
+            // B_i is upper triangular, and goes in the bottom of V_i.
+            // C_i is lower triangular, and goes in the top of W_i.
+            MVW VWi = VW.cRowRange(i1,i2);
+            if (i < p-1) {
+                for(ptrdiff_t jj=0; jj<hi; ++jj)
+                    for(ptrdiff_t ii=jj; ii<hi; ++ii)
+                        VWi.ref(n-hi+ii,jj) = m1.cref(i2-hi+ii,i2+jj);
+            }
+            if (i > 0) {
+                for(ptrdiff_t jj=0; jj<lo; ++jj)
+                    for(ptrdiff_t ii=0; ii<=jj; ++ii)
+                        VWi.ref(ii,hi+jj) = m1.cref(i1+ii,i1-lo+jj);
+            }
+            InlineBandLU_SolveInPlace(LUi,Pi,VWi);
+            typename Vector<T2>::subvector_type gi = g.cSubVector(i1,i2);
+            InlineBandLU_SolveInPlace(LUi,Pi,gi);
+        }
+        if (singular) {
+#ifdef PRINTALGO_BandLU
+            std::cout<<"Singular partition.  Use full LU."<<std::endl;
+#endif
+            BandSpike_FullSolve<T1>(m1,v2);
+            return;
+        }
+        v2.noAlias() = g;
+
+        // The reduced system for
+        // z = (x_0(bottom), x_1(top), x_1(bottom), ... x_p-1(top))
+        // where (bottom) is the last lo elements and (top) is the first hi.
+        // The equation for x_i(bottom) is
+        // x_i(bottom) + V_i(bottom) x_i+1(top) + W_i(bottom) x_i-1(bottom)
+        //     = g_i(bottom)
+        // and for x_i+1(top) is
+        // x_i+1(top) + V_i+1(top) x_i+2(top) + W_i+1(top) x_i(bottom)
+        //     = g_i+1(top)
+        const ptrdiff_t m = (p-1)*k;
+        const ptrdiff_t rlo = TMV_MIN(m-1,2*lo+hi-1);
+        const ptrdiff_t rhi = TMV_MIN(m-1,lo+2*hi-1);
+        BandMatrix<T1,ColMajor> R(m,m,rlo,TMV_MIN(m-1,rlo+rhi),T1(0));
+        Vector<T2> z(m);
+        for(ptrdiff_t i=0; i<p-1; ++i) {
+            const ptrdiff_t s = i*k;
+            const ptrdiff_t ib = start[i+1]-lo;  // first row of x_i(bottom)
+            const ptrdiff_t it = start[i+1];     // first row of x_i+1(top)
+            for(ptrdiff_t a=0; a<lo; ++a) {
+                R.ref(s+a,s+a) = T1(1);
+                for(ptrdiff_t b=0; b<hi; ++b)
+                    R.ref(s+a,s+lo+b) = VW.cref(ib+a,b);
+                if (i > 0)
+                    for(ptrdiff_t b=0; b<lo; ++b)
+                        R.ref(s+a,s-k+b) = VW.cref(ib+a,hi+b);
+                z.ref(s+a) = v2.cref(ib+a);
+            }
+            for(ptrdiff_t a=0; a<hi; ++a) {
+                R.ref(s+lo+a,s+lo+a) = T1(1);
+                if (i+1 < p-1)
+                    for(ptrdiff_t b=0; b<hi; ++b)
+                        R.ref(s+lo+a,s+k+lo+b) = VW.cref(it+a,b);
+                for(ptrdiff_t b=0; b<lo; ++b)
+                    R.ref(s+lo+a,s+b) = VW.cref(it+a,hi+b);
+                z.ref(s+lo+a) = v2.cref(it+a);
+            }
+        }
+        std::vector<ptrdiff_t> RP(m);
+        InlineBandLU_Decompose(R,&RP[0]);
+        InlineBandLU_SolveInPlace(R,Permutation(m,&RP[0]),z);
+
+        // x_i = g_i - V_i x_i+1(top) - W_i x_i-1(bottom)
+        typedef ConstMatrixView<T1,ColMajor> M1v;
+        typedef ConstVectorView<T2,Unit> Vz;
+        typedef V2s Vx;
+        const Scaling<-1,RT> mone;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for(ptrdiff_t i=0; i<p; ++i) {
+            const ptrdiff_t i1 = start[i];
+            const ptrdiff_t i2 = start[i+1];
+            Vx xi = v2.cSubVector(i1,i2);
+            if (i < p-1) {
+                M1v Vi = VW.cSubMatrix(i1,i2,0,hi);
+                Vz ti = z.cSubVector(i*k+lo,(i+1)*k);
+                MultMV_Helper<-2,xx,xx,true,-1,RT,M1v,Vz,Vx>::call(
+                    mone,Vi,ti,xi);
+            }
+            if (i > 0) {
+                M1v Wi = VW.cSubMatrix(i1,i2,hi,k);
+                Vz bi = z.cSubVector((i-1)*k,(i-1)*k+lo);
+                MultMV_Helper<-2,xx,xx,true,-1,RT,M1v,Vz,Vx>::call(
+                    mone,Wi,bi,xi);
+            }
+        }
+    }
+
+    template <class M1, class V2>
+    inline void BandSpike_SolveInPlace(
+        const BaseMatrix_Band<M1>& m1, BaseVector_Mutable<V2>& v2,
+        int nparts=0)
+    {
+        TMVAssert(m1.isSquare());
+        TMVAssert(m1.colsize() == v2.size());
+        typedef typename M1::value_type T1;
+        typedef typename V2::value_type T2;
+        TMVStaticAssert(!(Traits<T1>::iscomplex && Traits<T2>::isreal));
+        typedef typename V2::cview_type V2v;
+        V2v v2v = v2.cView();
+        if (v2.step() != 1 || V2::_conj) {
+            // The partition solves use VectorView<T2>, so make a copy
+            // if v2 isn't already one.
+            Vector<T2> temp = v2;
+            VectorView<T2> tv = temp.view();
+            BandSpike_Solve(m1.mat(),tv,nparts);
+            v2v = temp;
+        } else {
+            VectorView<T2> vv(v2v.ptr(),v2v.size(),1);
+            BandSpike_Solve(m1.mat(),vv,nparts);
+        }
+    }
+
+} // namespace tmv
+
+#undef TMV_BANDSPIKE_MINBLOCK
+
+#endif
@@ -121,6 +121,33 @@
 #if defined(__SSE2__) || defined(__SSE__)
 #include "xmmintrin.h"
 #endif
+#if defined(__AVX__)
+#include "immintrin.h"
+#endif
+
+// If TMV_CPU_DISPATCH is defined, the MultMM kernels (the block kernels
+// in TMV_MultMM_Kernel_AVX.h and the packed micro-kernels in
+// TMV_MultMM_Packed_Kernel.h) are compiled for several instruction sets,
+// and the best version for the cpu we are actually running on is
+// selected at run time.  This lets a library compiled for a generic x86
+// cpu still use the AVX2 or AVX-512 commands on newer machines for the
+// matrix products, and for the block updates in the LU, QR, etc.
+// decompositions that go through them.
+// Note that the rest of the library (e.g. MultMV, MultVV and the
+// unblocked parts of the decompositions) is only compiled for the
+// instruction set that the compiler targets.  (Putting target_clones
+// on the Inst functions doesn't help, since most of their work is done
+// in template functions that aren't inlined into them, so those would
+// still only have the default versions.)
+// It requires the gcc target attributes, so it is only available for
+// gcc 6 or later on x86 processors.  If the library is compiled for
+// AVX already (e.g. with -mavx2), there is nothing to dispatch.
+#if defined(TMV_CPU_DISPATCH) && !defined(__AVX__) && \
+    defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 6) && \
+    (defined(__x86_64__) || defined(__i386__)) && defined(__ELF__)
+#define TMV_USE_CPU_DISPATCH
+#include "immintrin.h"
+#endif
 
 #ifdef TMV_DEBUG
 #include <sstream>
@@ -183,6 +210,31 @@ namespace tmv {
     ( (major > TMV_MAJOR_VERSION) || \
       (major == TMV_MAJOR_VERSION && minor >= TMV_MINOR_VERSION) )
 
+    // The vector instruction sets for which TMV has specialized kernels.
+    enum CPUArch { CPU_Generic, CPU_AVX2, CPU_AVX512 };
+
+    // Return the best instruction set that the kernels can use.
+    // Normally this is just what the code was compiled for, but with
+    // TMV_CPU_DISPATCH, it is what the running cpu supports.
+    // The cpu is only queried the first time this is called.
+    static inline CPUArch TMV_CPUArch()
+    {
+#ifdef TMV_USE_CPU_DISPATCH
+        static const CPUArch arch =
+            (__builtin_cpu_init(), __builtin_cpu_supports("avx512f")) ?
+            CPU_AVX512 :
+            (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) ?
+            CPU_AVX2 : CPU_Generic;
+        return arch;
+#elif defined(__AVX512F__)
+        return CPU_AVX512;
+#elif defined(__AVX__)
+        return CPU_AVX2;
+#else
+        return CPU_Generic;
+#endif
+    }
+
     // This is based on the BOOST implementation BOOST_STATIC_ASSERT:
     template<bool>
     struct tmv_static_assert;
@@ -288,17 +340,17 @@ namespace tmv {
     };
 
     enum DivType {
-        XX=0, LU=1, CH=2, QR=4, QRP=8, SV=16,
+        XX=0, LU=1, CH=2, QR=4, QRP=8, SV=16, LDL=32,
         // We store the divtype in a binary field integer.
         // In addition to the above, we also use the same object to 
         // store the following other flags related to division.
         // So these values must not clash with the above DivType values.
         // These aren't technically DivType's but since they are 
         // stored together, I think this adds to type-safety.
-        DivInPlaceFlag = 32,
-        SaveDivFlag = 64,
+        DivInPlaceFlag = 64,
+        SaveDivFlag = 128,
         // And finally shorthand for "one of the real DivType's":
-        DivTypeFlags = 31
+        DivTypeFlags = 63
     };
     TMV_INLINE DivType operator|(DivType a, DivType b) 
     { 
@@ -2429,7 +2481,8 @@ namespace tmv {
             d==CH ? "CH" :
             d==QR ? "QR" :
             d==QRP ? "QRP" :
-            d==SV ? "SV" : "XX";
+            d==SV ? "SV" :
+            d==LDL ? "LDL" : "XX";
     }
 
     inline std::string TMV_Text(ConjType c)
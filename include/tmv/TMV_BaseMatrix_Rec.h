@@ -376,6 +376,10 @@ namespace tmv {
     template <class M>
     inline void TransposeSelf(BaseMatrix_Rec_Mutable<M>& m);
 
+    // Defined in TMV_TransposeM.h
+    template <class T>
+    void InPlaceTransposeStorage(T* p, const ptrdiff_t M, const ptrdiff_t N);
+
     // Defined in TMV_Permute.h
     template <class M>
     inline void PermuteRows(
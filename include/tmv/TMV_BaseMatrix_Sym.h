@@ -0,0 +1,1495 @@
+//---------------------------------------------------------------------------
+//
+// This file defines the BaseMatrix_Sym and BaseMatrix_Sym_Mutable classes.
+//
+// These are the base classes for both symmetric and hermitian matrices.
+// The hermitian-ness is a compile-time property of the derived class
+// (see Traits<M>::_herm), so the same code handles both.
+//
+// Only one triangle of the matrix is actually stored, which is given by
+// the Upper or Lower attribute.  The other triangle is obtained from the
+// stored one by transposing (and conjugating for a hermitian matrix).
+//
+// See TMV_SymMatrix.h for the functions that are defined for these objects.
+//
+
+#ifndef TMV_BaseMatrix_Sym_H
+#define TMV_BaseMatrix_Sym_H
+
+#include "TMV_BaseMatrix.h"
+#include "TMV_BaseMatrix_Rec.h"
+#include "TMV_BaseMatrix_Tri.h"
+#include "TMV_BaseMatrix_Diag.h"
+#include "TMV_VIt.h"
+#include "TMV_MIt.h"
+
+namespace tmv {
+
+    template <class M>
+    class BaseMatrix_Sym;
+    template <class M>
+    class BaseMatrix_Sym_Mutable;
+
+    template <class T, int A=0>
+    class SymMatrix;
+    template <class T, int A=0>
+    class ConstSymMatrixView;
+    template <class T, int A=0>
+    class SymMatrixView;
+    template <class T, int A=0>
+    class HermMatrix;
+    template <class T, int A=0>
+    class ConstHermMatrixView;
+    template <class T, int A=0>
+    class HermMatrixView;
+
+    // Defined below:
+    template <class M1, class M2>
+    inline void Copy(
+        const BaseMatrix_Sym<M1>& m1, BaseMatrix_Sym_Mutable<M2>& m2);
+    template <class M1, class M2>
+    inline void Copy(
+        const BaseMatrix_Sym<M1>& m1, BaseMatrix_Rec_Mutable<M2>& m2);
+    template <class M1, class M2>
+    inline void Copy(
+        const BaseMatrix_Diag<M1>& m1, BaseMatrix_Sym_Mutable<M2>& m2);
+
+    // A helper class for returning views without necessarily
+    // making a new object.
+    // Packed storage does not have any views other than the matrix
+    // itself, so the view types are just the matrix type in that case.
+    template <bool ref, class type, class view_type>
+    struct MakeSymView_Helper;
+
+    template <class type, class view_type>
+    struct MakeSymView_Helper<true,type,view_type>
+    {
+        typedef type& ret_type;
+        typedef const type& const_ret_type;
+        static TMV_INLINE ret_type call(type& m) { return m; }
+        static TMV_INLINE const_ret_type call(const type& m) { return m; }
+        static TMV_INLINE ret_type callT(type& m) { return m; }
+        static TMV_INLINE const_ret_type callT(const type& m) { return m; }
+    };
+
+    template <class type, class view_type>
+    struct MakeSymView_Helper<false,type,view_type>
+    {
+        typedef view_type ret_type;
+        typedef view_type const_ret_type;
+        static TMV_INLINE ret_type call(type& m)
+        { return view_type(m.ptr(),m.size(),m.stepi(),m.stepj()); }
+        static TMV_INLINE const_ret_type call(const type& m)
+        { return view_type(m.cptr(),m.size(),m.stepi(),m.stepj()); }
+        static TMV_INLINE ret_type callT(type& m)
+        { return view_type(m.ptr(),m.size(),m.stepj(),m.stepi()); }
+        static TMV_INLINE const_ret_type callT(const type& m)
+        { return view_type(m.cptr(),m.size(),m.stepj(),m.stepi()); }
+    };
+
+    template <class type, class view_type>
+    struct MakeSymView
+    {
+        enum { ref = Traits2<type,view_type>::sametype };
+        typedef MakeSymView_Helper<ref,type,view_type> helper;
+
+        static TMV_INLINE typename helper::ret_type call(type& m)
+        { return helper::call(m); }
+        static TMV_INLINE typename helper::const_ret_type call(const type& m)
+        { return helper::call(m); }
+        static TMV_INLINE typename helper::ret_type callT(type& m)
+        { return helper::callT(m); }
+        static TMV_INLINE typename helper::const_ret_type callT(const type& m)
+        { return helper::callT(m); }
+    };
+
+    // A reference to an element of a hermitian matrix.
+    // Whether the stored value needs to be conjugated depends on which
+    // triangle the element is in, so unlike ConjRef, this is a runtime
+    // property of the reference.
+    template <class T>
+    class HermRef
+    {
+    public:
+
+        TMV_INLINE HermRef(T& r, bool c) : itsref(r), isconj(c) {}
+        TMV_INLINE HermRef(const HermRef<T>& rhs) :
+            itsref(rhs.itsref), isconj(rhs.isconj) {}
+
+        TMV_INLINE operator T() const { return val(); }
+        TMV_INLINE T& getRef() { return itsref; }
+        TMV_INLINE T conj() const { return TMV_CONJ(val()); }
+        TMV_INLINE typename Traits<T>::real_type real() const
+        { return TMV_REAL(itsref); }
+        TMV_INLINE typename Traits<T>::real_type imag() const
+        { return isconj ? -TMV_IMAG(itsref) : TMV_IMAG(itsref); }
+
+        TMV_INLINE HermRef<T>& operator=(const HermRef<T>& x2)
+        { assign(x2.val()); return *this; }
+        template <class T2>
+        TMV_INLINE HermRef<T>& operator=(const T2& x2)
+        { assign(T(x2)); return *this; }
+
+        template <class T2>
+        TMV_INLINE HermRef<T>& operator+=(const T2& x2)
+        { assign(val() + x2); return *this; }
+        template <class T2>
+        TMV_INLINE HermRef<T>& operator-=(const T2& x2)
+        { assign(val() - x2); return *this; }
+        template <class T2>
+        TMV_INLINE HermRef<T>& operator*=(const T2& x2)
+        { assign(val() * x2); return *this; }
+        template <class T2>
+        TMV_INLINE HermRef<T>& operator/=(const T2& x2)
+        { assign(val() / x2); return *this; }
+
+        TMV_INLINE T operator-() const { return -val(); }
+
+        template <class T2>
+        TMV_INLINE bool operator==(const T2& x2) const
+        { return val() == x2; }
+        template <class T2>
+        TMV_INLINE bool operator!=(const T2& x2) const
+        { return val() != x2; }
+
+        friend std::ostream& operator<<(std::ostream& os, const HermRef<T>& x)
+        { os << x.val(); return os; }
+
+    private:
+
+        TMV_INLINE T val() const
+        { return isconj ? TMV_CONJ(itsref) : itsref; }
+        TMV_INLINE void assign(const T& x)
+        { itsref = isconj ? TMV_CONJ(x) : x; }
+
+        T& itsref;
+        const bool isconj;
+    };
+
+    template <class T>
+    TMV_INLINE T TMV_CONJ(const HermRef<T>& x)
+    { return x.conj(); }
+    template <class T>
+    TMV_INLINE typename Traits<T>::real_type TMV_NORM(const HermRef<T>& x)
+    { return TMV_NORM(T(x)); }
+    template <class T>
+    TMV_INLINE typename Traits<T>::real_type TMV_ABS(const HermRef<T>& x)
+    { return TMV_ABS(T(x)); }
+    template <class T>
+    TMV_INLINE typename Traits<T>::real_type TMV_REAL(const HermRef<T>& x)
+    { return x.real(); }
+    template <class T>
+    TMV_INLINE typename Traits<T>::real_type TMV_IMAG(const HermRef<T>& x)
+    { return x.imag(); }
+
+
+    //
+    // The Traits that are common to all the symmetric and hermitian
+    // matrix classes.
+    //
+    // A is the attribute of the class after the defaults have been applied.
+    // herm says whether this is a HermMatrix or a SymMatrix.
+    // M is the class itself.  The view types for packed storage are M.
+    //
+
+    template <class T, int A, bool herm>
+    struct SymViewHelper
+    {
+        typedef ConstSymMatrixView<T,A> ctype;
+        typedef SymMatrixView<T,A> type;
+    };
+    template <class T, int A>
+    struct SymViewHelper<T,A,true>
+    {
+        typedef ConstHermMatrixView<T,A> ctype;
+        typedef HermMatrixView<T,A> type;
+    };
+
+    template <class T, int A, bool herm, class M>
+    struct SymTraits
+    {
+        enum { _attrib = A };
+
+        typedef T value_type;
+        typedef typename Traits<T>::real_type real_type;
+        typedef typename Traits<T>::complex_type complex_type;
+        enum { isreal = Traits<T>::isreal };
+        enum { iscomplex = Traits<T>::iscomplex };
+
+        typedef M type;
+        typedef const type& calc_type;
+        typedef const type& eval_type;
+
+        enum { _colsize = Unknown };
+        enum { _rowsize = Unknown };
+        enum { _size = Unknown };
+        enum { _nlo = Unknown };
+        enum { _nhi = Unknown };
+        enum { _herm = herm && iscomplex };
+        enum { _shape = isreal ? RealSym : herm ? Herm : Sym };
+        enum { _fort = Attrib<A>::fort };
+        enum { _calc = true };
+        enum { _packed = Attrib<A>::packed };
+        enum { _upper = Attrib<A>::upper };
+        enum { _rowmajor = Attrib<A>::rowmajor };
+        enum { _colmajor = Attrib<A>::colmajor };
+        enum { _stepi = (_colmajor && !_packed ? 1 : Unknown) };
+        enum { _stepj = (_rowmajor && !_packed ? 1 : Unknown) };
+        enum { _diagstep = Unknown };
+        enum { _conj = Attrib<A>::conj };
+        enum { _checkalias = !Attrib<A>::noalias };
+        enum { twoSi = isreal ? int(_stepi) : int(IntTraits<_stepi>::twoS) };
+        enum { twoSj = isreal ? int(_stepj) : int(IntTraits<_stepj>::twoS) };
+
+        enum { _hasdivider = false };
+        typedef QuotXM<1,real_type,type> inverse_type;
+
+        enum { copyA = (
+                (_fort ? FortranStyle : CStyle) |
+                (_upper ? Upper : Lower) |
+                (_rowmajor ? RowMajor : ColMajor) ) };
+        typedef typename TypeSelect<herm,
+                HermMatrix<T,copyA>, SymMatrix<T,copyA> >::type copy_type;
+
+        // Attributes for the views.  (These never have Packed.)
+        enum { vA = A & ~Packed };
+        enum { cstyleA = vA & ~FortranStyle };
+        enum { fstyleA = vA | FortranStyle };
+        enum { xA = vA & (Conj | Upper | Lower) };
+        enum { nmA = (vA & ~AllStorageType) };
+        enum { cmA = nmA | ColMajor };
+        enum { rmA = nmA | RowMajor };
+        enum { conjA = iscomplex ? (vA ^ Conj) : int(vA) };
+        enum { trA = (
+                (nmA & ~Upper & ~Lower) |
+                (_upper ? Lower : Upper) |
+                (_colmajor ? RowMajor : _rowmajor ? ColMajor : NonMajor) ) };
+        enum { adjA = iscomplex ? (trA ^ Conj) : int(trA) };
+        enum { nonconjA = vA & ~Conj };
+        enum { twosA = isreal ? int(vA) : (vA & ~Conj & ~AllStorageType) };
+        enum { An = vA & ~NoAlias };
+
+        // The stored triangle and the other one:
+        enum { stA = (vA & ~Upper & ~Lower) | NonUnitDiag };
+        enum { mirA = (
+                ((stA & ~AllStorageType) |
+                 (_colmajor ? RowMajor : _rowmajor ? ColMajor : NonMajor)) ^
+                (_herm ? Conj : 0) ) };
+        enum { loA = _upper ? int(mirA) : int(stA) };
+        enum { upA = _upper ? int(stA) : int(mirA) };
+
+        enum { vecA = (
+                (_fort ? FortranStyle : 0) |
+                (_conj ? Conj : 0) |
+                (_checkalias ? 0 : NoAlias) )};
+
+        typedef SymViewHelper<T,vA,herm> vh;
+        typedef SymViewHelper<T,cstyleA,herm> cvh;
+        typedef SymViewHelper<T,fstyleA,herm> fvh;
+        typedef SymViewHelper<T,xA,herm> xvh;
+        typedef SymViewHelper<T,cmA,herm> cmvh;
+        typedef SymViewHelper<T,rmA,herm> rmvh;
+        typedef SymViewHelper<T,conjA,herm> conjvh;
+        typedef SymViewHelper<T,trA,herm> trvh;
+        typedef SymViewHelper<T,adjA,herm> adjvh;
+        typedef SymViewHelper<T,nonconjA,herm> ncvh;
+        typedef SymViewHelper<real_type,twosA,false> rvh;
+        typedef SymViewHelper<T,An|NoAlias,herm> navh;
+        typedef SymViewHelper<T,An,herm> avh;
+
+        // For packed storage, the only view is the matrix itself,
+        // and since a symmetric matrix is its own transpose,
+        // so is transpose().
+        enum { p = _packed };
+        enum { pt = _packed && !_herm };
+
+        typedef ConstVectorView<T,vecA> const_diag_type;
+        typedef typename vh::ctype const_subsymmatrix_type;
+        typedef ConstMatrixView<T,(stA & ~NonUnitDiag)> const_submatrix_type;
+        typedef ConstUpperTriMatrixView<T,upA> const_uppertri_type;
+        typedef ConstLowerTriMatrixView<T,loA> const_lowertri_type;
+        typedef typename TypeSelect<p,type,typename vh::ctype>::type
+            const_view_type;
+        typedef typename TypeSelect<p,type,typename cvh::ctype>::type
+            const_cview_type;
+        typedef typename TypeSelect<p,type,typename fvh::ctype>::type
+            const_fview_type;
+        typedef typename TypeSelect<p,type,typename xvh::ctype>::type
+            const_xview_type;
+        typedef typename TypeSelect<p,type,typename cmvh::ctype>::type
+            const_cmview_type;
+        typedef typename TypeSelect<p,type,typename rmvh::ctype>::type
+            const_rmview_type;
+        typedef typename TypeSelect<p,InvalidType,typename conjvh::ctype>::type
+            const_conjugate_type;
+        typedef typename TypeSelect<pt,type,
+                typename TypeSelect<p,InvalidType,
+                typename trvh::ctype>::type>::type const_transpose_type;
+        typedef typename TypeSelect<p,InvalidType,typename adjvh::ctype>::type
+            const_adjoint_type;
+        typedef typename rvh::ctype const_realpart_type;
+        typedef typename TypeSelect<herm,InvalidType,
+                const_realpart_type>::type const_imagpart_type;
+        typedef typename TypeSelect<p,type,typename ncvh::ctype>::type
+            const_nonconj_type;
+        typedef typename TypeSelect<p,type,typename vh::type>::type
+            nonconst_type;
+
+        typedef typename TypeSelect<_herm, HermRef<T>,
+                typename AuxRef<T,_conj>::reference>::type reference;
+
+        typedef CRMIt<type> const_rowmajor_iterator;
+        typedef CCMIt<type> const_colmajor_iterator;
+        typedef RMIt<type> rowmajor_iterator;
+        typedef CMIt<type> colmajor_iterator;
+
+        typedef VectorView<T,vecA> diag_type;
+        typedef typename vh::type subsymmatrix_type;
+        typedef MatrixView<T,(stA & ~NonUnitDiag)> submatrix_type;
+        typedef UpperTriMatrixView<T,upA> uppertri_type;
+        typedef LowerTriMatrixView<T,loA> lowertri_type;
+        typedef typename TypeSelect<p,type,typename vh::type>::type view_type;
+        typedef typename TypeSelect<p,type,typename cvh::type>::type
+            cview_type;
+        typedef typename TypeSelect<p,type,typename fvh::type>::type
+            fview_type;
+        typedef typename TypeSelect<p,type,typename xvh::type>::type
+            xview_type;
+        typedef typename TypeSelect<p,type,typename cmvh::type>::type
+            cmview_type;
+        typedef typename TypeSelect<p,type,typename rmvh::type>::type
+            rmview_type;
+        typedef typename TypeSelect<p,InvalidType,typename conjvh::type>::type
+            conjugate_type;
+        typedef typename TypeSelect<pt,type,
+                typename TypeSelect<p,InvalidType,
+                typename trvh::type>::type>::type transpose_type;
+        typedef typename TypeSelect<p,InvalidType,typename adjvh::type>::type
+            adjoint_type;
+        typedef typename rvh::type realpart_type;
+        typedef typename TypeSelect<herm,InvalidType,
+                realpart_type>::type imagpart_type;
+        typedef typename TypeSelect<p,type,typename ncvh::type>::type
+            nonconj_type;
+        typedef typename TypeSelect<p,type,typename navh::type>::type
+            noalias_type;
+        typedef typename TypeSelect<p,type,typename avh::type>::type
+            alias_type;
+    };
+
+
+    //
+    // Loops over the stored triangle for the reductions.
+    // These just use cref, so they work for any storage.
+    //
+
+    template <class M>
+    static typename M::value_type SymSumElements(const M& m)
+    {
+        typedef typename M::value_type T;
+        const ptrdiff_t n = m.size();
+        T sd(0), so(0);
+        for(ptrdiff_t j=0;j<n;++j) {
+            sd += m.cref(j,j);
+            if (m.isupper()) for(ptrdiff_t i=0;i<j;++i) so += m.cref(i,j);
+            else for(ptrdiff_t i=j+1;i<n;++i) so += m.cref(i,j);
+        }
+        if (M::_herm) return sd + T(2*TMV_REAL(so));
+        else return sd + T(2)*so;
+    }
+
+    // f(x) is added once for the diagonal elements and twice for the
+    // off-diagonal elements.  This is correct for any f that satisfies
+    // f(x) = f(conj(x)), which is true for all the ones we need here.
+    template <class RT, class M, class F>
+    static RT SymSumElements(const M& m, const F& f)
+    {
+        const ptrdiff_t n = m.size();
+        RT sd(0), so(0);
+        for(ptrdiff_t j=0;j<n;++j) {
+            sd += f(m.cref(j,j));
+            if (m.isupper()) for(ptrdiff_t i=0;i<j;++i) so += f(m.cref(i,j));
+            else for(ptrdiff_t i=j+1;i<n;++i) so += f(m.cref(i,j));
+        }
+        return sd + RT(2)*so;
+    }
+
+    template <class RT, class M, class F>
+    static RT SymMaxElement(const M& m, const F& f)
+    {
+        const ptrdiff_t n = m.size();
+        RT max(0);
+        for(ptrdiff_t j=0;j<n;++j) {
+            const ptrdiff_t i1 = m.isupper() ? 0 : j;
+            const ptrdiff_t i2 = m.isupper() ? j+1 : n;
+            for(ptrdiff_t i=i1;i<i2;++i) {
+                RT x = f(m.cref(i,j));
+                if (x > max) max = x;
+            }
+        }
+        return max;
+    }
+
+    // Since m is symmetric, norm1 = normInf = the maximum column sum.
+    template <class RT, class M>
+    static RT SymNorm1(const M& m)
+    {
+        const ptrdiff_t n = m.size();
+        if (n == 0) return RT(0);
+        AlignedArray<RT> colsum(n);
+        for(ptrdiff_t j=0;j<n;++j) colsum[j] = RT(0);
+        for(ptrdiff_t j=0;j<n;++j) {
+            colsum[j] += TMV_ABS(m.cref(j,j));
+            const ptrdiff_t i1 = m.isupper() ? 0 : j+1;
+            const ptrdiff_t i2 = m.isupper() ? j : n;
+            for(ptrdiff_t i=i1;i<i2;++i) {
+                RT x = TMV_ABS(m.cref(i,j));
+                colsum[j] += x;
+                colsum[i] += x;
+            }
+        }
+        RT max = colsum[0];
+        for(ptrdiff_t j=1;j<n;++j) if (colsum[j] > max) max = colsum[j];
+        return max;
+    }
+
+    template <class T>
+    struct SymAbsF
+    {
+        typedef typename Traits<typename Traits<T>::real_type>::float_type RT;
+        RT operator()(const T& x) const { return TMV_ABS(x); }
+    };
+    template <class T>
+    struct SymAbs2F
+    {
+        typedef typename Traits<T>::real_type RT;
+        RT operator()(const T& x) const { return TMV_ABS2(x); }
+    };
+    template <class T>
+    struct SymNormF
+    {
+        typedef typename Traits<T>::real_type RT;
+        RT operator()(const T& x) const { return TMV_NORM(x); }
+    };
+    template <class T, class RT>
+    struct SymScaledNormF
+    {
+        SymScaledNormF(RT _s) : s(_s) {}
+        RT operator()(const T& x) const { return TMV_NORM(s*x); }
+        const RT s;
+    };
+
+
+    //
+    // Helpers for the modifying functions, which act on either the
+    // stored triangle (NonPacked) or the whole packed array (Packed).
+    //
+
+    template <bool packed>
+    struct SymElements_Helper // packed = false
+    {
+        template <class M, class T>
+        static void setAllTo(M& m, const T& x)
+        {
+            if (m.isupper()) { typename M::uppertri_type u = m.upperTri(); u.setAllTo(x); }
+            else { typename M::lowertri_type l = m.lowerTri(); l.setAllTo(x); }
+        }
+        template <class M, class T>
+        static void addToAll(M& m, const T& x)
+        {
+            if (m.isupper()) { typename M::uppertri_type u = m.upperTri(); u.addToAll(x); }
+            else { typename M::lowertri_type l = m.lowerTri(); l.addToAll(x); }
+        }
+        template <class M, class RT>
+        static void clip(M& m, const RT& thresh)
+        {
+            if (m.isupper()) { typename M::uppertri_type u = m.upperTri(); u.clip(thresh); }
+            else { typename M::lowertri_type l = m.lowerTri(); l.clip(thresh); }
+        }
+        template <class M, class F>
+        static void applyToAll(M& m, const F& f)
+        {
+            if (m.isupper()) { typename M::uppertri_type u = m.upperTri(); u.applyToAll(f); }
+            else { typename M::lowertri_type l = m.lowerTri(); l.applyToAll(f); }
+        }
+        template <class M>
+        static void conjugateSelf(M& m)
+        {
+            if (m.isupper()) { typename M::uppertri_type u = m.upperTri(); u.conjugateSelf(); }
+            else { typename M::lowertri_type l = m.lowerTri(); l.conjugateSelf(); }
+        }
+        template <int ix, class T, class M>
+        static void scale(const Scaling<ix,T>& x, M& m)
+        {
+            if (m.isupper()) { typename M::uppertri_type u = m.upperTri(); Scale(x,u); }
+            else { typename M::lowertri_type l = m.lowerTri(); Scale(x,l); }
+        }
+    };
+
+    template <>
+    struct SymElements_Helper<true>
+    {
+        template <class M, class T>
+        static void setAllTo(M& m, const T& x)
+        { m.linearView().setAllTo(x); }
+        template <class M, class T>
+        static void addToAll(M& m, const T& x)
+        { m.linearView().addToAll(x); }
+        template <class M, class RT>
+        static void clip(M& m, const RT& thresh)
+        { m.linearView().clip(thresh); }
+        template <class M, class F>
+        static void applyToAll(M& m, const F& f)
+        { m.linearView().applyToAll(f); }
+        template <class M>
+        static void conjugateSelf(M& m)
+        { m.linearView().conjugateSelf(); }
+        template <int ix, class T, class M>
+        static void scale(const Scaling<ix,T>& x, M& m)
+        { typename M::linearview_type v = m.linearView(); Scale(x,v); }
+    };
+
+
+    template <class M>
+    class BaseMatrix_Sym :
+        public BaseMatrix_Calc<M>
+    {
+    public:
+        enum { _colsize = Traits<M>::_size };
+        enum { _rowsize = Traits<M>::_size };
+        enum { _size = Traits<M>::_size };
+        enum { _fort = Traits<M>::_fort };
+        enum { _shape = Traits<M>::_shape };
+        enum { _rowmajor = Traits<M>::_rowmajor };
+        enum { _colmajor = Traits<M>::_colmajor };
+        enum { _calc = Traits<M>::_calc };
+        enum { _conj = Traits<M>::_conj };
+        enum { _herm = Traits<M>::_herm };
+        enum { _packed = Traits<M>::_packed };
+        enum { _upper = Traits<M>::_upper };
+
+        typedef M type;
+        typedef BaseMatrix_Calc<M> base;
+
+        typedef typename base::calc_type calc_type;
+        typedef typename base::eval_type eval_type;
+        typedef typename base::copy_type copy_type;
+        typedef typename base::inverse_type inverse_type;
+        typedef typename base::value_type value_type;
+        typedef typename base::real_type real_type;
+        typedef typename base::complex_type complex_type;
+        typedef typename base::float_type float_type;
+        typedef typename base::zfloat_type zfloat_type;
+
+        typedef typename base::const_view_type const_view_type;
+        typedef typename base::const_cview_type const_cview_type;
+        typedef typename base::const_fview_type const_fview_type;
+        typedef typename base::const_xview_type const_xview_type;
+        typedef typename base::const_transpose_type const_transpose_type;
+        typedef typename base::const_conjugate_type const_conjugate_type;
+        typedef typename base::const_adjoint_type const_adjoint_type;
+        typedef typename base::const_realpart_type const_realpart_type;
+        typedef typename base::const_imagpart_type const_imagpart_type;
+        typedef typename base::const_nonconj_type const_nonconj_type;
+        typedef typename base::nonconst_type nonconst_type;
+        typedef typename base::const_rowmajor_iterator const_rowmajor_iterator;
+        typedef typename base::const_colmajor_iterator const_colmajor_iterator;
+
+        typedef typename Traits<M>::const_diag_type const_diag_type;
+        typedef typename Traits<M>::const_subsymmatrix_type
+            const_subsymmatrix_type;
+        typedef typename Traits<M>::const_submatrix_type const_submatrix_type;
+        typedef typename Traits<M>::const_uppertri_type const_uppertri_type;
+        typedef typename Traits<M>::const_lowertri_type const_lowertri_type;
+        typedef typename Traits<M>::const_cmview_type const_cmview_type;
+        typedef typename Traits<M>::const_rmview_type const_rmview_type;
+
+
+        //
+        // Constructor
+        //
+
+    protected:
+        TMV_INLINE BaseMatrix_Sym() {}
+        TMV_INLINE BaseMatrix_Sym(const BaseMatrix_Sym<M>&) {}
+        TMV_INLINE ~BaseMatrix_Sym() {}
+
+    private:
+        void operator=(const BaseMatrix_Sym<M>&);
+    public:
+
+
+        //
+        // Access
+        //
+
+        TMV_INLINE_ND value_type operator()(ptrdiff_t i, ptrdiff_t j) const
+        {
+            CheckRowIndex<_fort>(i,size());
+            CheckColIndex<_fort>(j,size());
+            return cref(i,j);
+        }
+
+        // Packed storage does not have any of the vector or
+        // triangle views.
+        TMV_INLINE const_diag_type diag() const
+        {
+            TMVStaticAssert(!_packed);
+            return const_diag_type(cptr(),size(),stepi()+stepj());
+        }
+
+
+        //
+        // Functions
+        //
+
+        TMV_INLINE value_type trace() const
+        {
+            value_type sum(0);
+            for(ptrdiff_t i=0;i<size();++i) sum += cref(i,i);
+            return sum;
+        }
+
+        TMV_INLINE value_type sumElements() const
+        { return SymSumElements(mat()); }
+
+        TMV_INLINE float_type sumAbsElements() const
+        { return SymSumElements<float_type>(mat(),SymAbsF<value_type>()); }
+
+        TMV_INLINE real_type sumAbs2Elements() const
+        { return SymSumElements<real_type>(mat(),SymAbs2F<value_type>()); }
+
+        TMV_INLINE float_type maxAbsElement() const
+        { return SymMaxElement<float_type>(mat(),SymAbsF<value_type>()); }
+
+        TMV_INLINE real_type maxAbs2Element() const
+        { return SymMaxElement<real_type>(mat(),SymAbs2F<value_type>()); }
+
+        TMV_INLINE real_type normSq() const
+        { return SymSumElements<real_type>(mat(),SymNormF<value_type>()); }
+
+        TMV_INLINE float_type normSq(const float_type scale) const
+        {
+            return SymSumElements<float_type>(
+                mat(),SymScaledNormF<value_type,float_type>(scale));
+        }
+
+        TMV_INLINE float_type normF() const
+        { return TMV_SQRT(normSq()); }
+
+        TMV_INLINE float_type norm() const
+        { return normF(); }
+
+        TMV_INLINE float_type norm1() const
+        { return SymNorm1<float_type>(mat()); }
+
+        TMV_INLINE float_type normInf() const
+        { return norm1(); }
+
+        // TODO: These should use the eigenvalues rather than the
+        // singular values of the full matrix.
+        float_type norm2() const
+        { return Matrix<value_type>(mat()).norm2(); }
+
+        float_type condition() const
+        { return Matrix<value_type>(mat()).condition(); }
+
+        template <class ret_type, class F>
+        TMV_INLINE ret_type sumElements(const F& f) const
+        { return SymSumElements<ret_type>(mat(),f); }
+
+
+        //
+        // subSymMatrix, upperTri, lowerTri
+        //
+
+        // These versions always uses CStyle
+        TMV_INLINE const_subsymmatrix_type cSubSymMatrix(
+            ptrdiff_t i1, ptrdiff_t i2) const
+        {
+            TMVStaticAssert(!_packed);
+            return const_subsymmatrix_type(
+                cptr()+i1*(stepi()+stepj()), i2-i1, stepi(), stepj());
+        }
+
+        // This is only valid for a submatrix that is completely within
+        // the stored triangle.  Use upperTri() or lowerTri() to
+        // get a submatrix of the other triangle.
+        TMV_INLINE const_submatrix_type cSubMatrix(
+            ptrdiff_t i1, ptrdiff_t i2, ptrdiff_t j1, ptrdiff_t j2) const
+        {
+            TMVStaticAssert(!_packed);
+            return const_submatrix_type(
+                cptr()+i1*stepi()+j1*stepj(), i2-i1, j2-j1, stepi(), stepj());
+        }
+
+        // These check the indices according the the indexing style being
+        // used, and then calls the above CStyle versions.
+        TMV_INLINE_ND const_subsymmatrix_type subSymMatrix(
+            ptrdiff_t i1, ptrdiff_t i2) const
+        {
+            CheckRange<_fort>(i1,i2,size());
+            return cSubSymMatrix(i1,i2);
+        }
+
+        TMV_INLINE_ND const_submatrix_type subMatrix(
+            ptrdiff_t i1, ptrdiff_t i2, ptrdiff_t j1, ptrdiff_t j2) const
+        {
+            CheckRowRange<_fort>(i1,i2,size());
+            CheckColRange<_fort>(j1,j2,size());
+            TMVAssert((i1==i2 || j1==j2 ||
+                       (_upper ? i2-1 <= j1 : j2-1 <= i1)) &&
+                      "subMatrix must be within the stored triangle");
+            return cSubMatrix(i1,i2,j1,j2);
+        }
+
+        TMV_INLINE const_uppertri_type upperTri() const
+        {
+            TMVStaticAssert(!_packed);
+            return const_uppertri_type(
+                cptr(),size(),
+                _upper ? stepi() : stepj(), _upper ? stepj() : stepi());
+        }
+
+        TMV_INLINE const_lowertri_type lowerTri() const
+        {
+            TMVStaticAssert(!_packed);
+            return const_lowertri_type(
+                cptr(),size(),
+                _upper ? stepj() : stepi(), _upper ? stepi() : stepj());
+        }
+
+
+        //
+        // Views
+        //
+
+        TMV_INLINE TMV_MAYBE_CREF(type,const_view_type) view() const
+        { return MakeSymView<type,const_view_type>::call(mat()); }
+
+        TMV_INLINE TMV_MAYBE_CREF(type,const_cview_type) cView() const
+        { return MakeSymView<type,const_cview_type>::call(mat()); }
+
+        TMV_INLINE TMV_MAYBE_CREF(type,const_fview_type) fView() const
+        { return MakeSymView<type,const_fview_type>::call(mat()); }
+
+        TMV_INLINE TMV_MAYBE_CREF(type,const_xview_type) xView() const
+        { return MakeSymView<type,const_xview_type>::call(mat()); }
+
+        TMV_INLINE_ND TMV_MAYBE_CREF(type,const_cmview_type) cmView() const
+        {
+            TMVAssert(this->iscm() && "Called cmView on non-ColMajor matrix");
+            return MakeSymView<type,const_cmview_type>::call(mat());
+        }
+
+        TMV_INLINE_ND TMV_MAYBE_CREF(type,const_rmview_type) rmView() const
+        {
+            TMVAssert(this->isrm() && "Called rmView on non-RowMajor matrix");
+            return MakeSymView<type,const_rmview_type>::call(mat());
+        }
+
+        TMV_INLINE TMV_MAYBE_CREF(type,const_view_type) constView() const
+        { return MakeSymView<type,const_view_type>::call(mat()); }
+
+        TMV_INLINE TMV_MAYBE_CREF(type,const_transpose_type) transpose() const
+        { return MakeSymView<type,const_transpose_type>::callT(mat()); }
+
+        TMV_INLINE TMV_MAYBE_CREF(type,const_conjugate_type) conjugate() const
+        { return MakeSymView<type,const_conjugate_type>::call(mat()); }
+
+        TMV_INLINE TMV_MAYBE_CREF(type,const_adjoint_type) adjoint() const
+        { return MakeSymView<type,const_adjoint_type>::callT(mat()); }
+
+        const_realpart_type realPart() const
+        {
+            TMVStaticAssert(!_packed);
+            const bool isreal = Traits<value_type>::isreal;
+            return const_realpart_type(
+                reinterpret_cast<const real_type*>(cptr()), size(),
+                isreal ? stepi() : 2*stepi(), isreal ? stepj() : 2*stepj());
+        }
+
+        const_imagpart_type imagPart() const
+        {
+            // The imaginary part of a hermitian matrix is anti-symmetric,
+            // so it cannot be viewed as a SymMatrix.
+            TMVStaticAssert(!_herm);
+            TMVStaticAssert(!_packed);
+            TMVStaticAssert(Traits<value_type>::iscomplex);
+            return const_imagpart_type(
+                reinterpret_cast<const real_type*>(cptr())+1, size(),
+                2*stepi(), 2*stepj());
+        }
+
+        TMV_INLINE TMV_MAYBE_CREF(type,const_nonconj_type) nonConj() const
+        { return MakeSymView<type,const_nonconj_type>::call(mat()); }
+
+        TMV_INLINE TMV_MAYBE_REF(type,nonconst_type) nonConst() const
+        {
+            return MakeSymView<type,nonconst_type>::call(
+                const_cast<type&>(mat()));
+        }
+
+
+        //
+        // Auxilliary routines
+        //
+
+        template <class M2>
+        TMV_INLINE void assignTo(BaseMatrix_Mutable<M2>& m2) const
+        {
+            TMVStaticAssert((ShapeTraits2<_shape,M2::_shape>::assignable));
+            tmv::Copy(mat(),m2.mat());
+        }
+
+        TMV_INLINE const type& mat() const
+        { return static_cast<const type&>(*this); }
+
+        TMV_INLINE bool isconj() const { return _conj; }
+        TMV_INLINE bool isherm() const { return _herm; }
+        TMV_INLINE bool issym() const { return !_herm; }
+        TMV_INLINE bool isupper() const { return _upper; }
+        TMV_INLINE bool ispacked() const { return _packed; }
+
+        // Note that these last functions need to be defined in a more derived
+        // class than this, or an infinite loop will result.
+
+        TMV_INLINE ptrdiff_t colsize() const { return mat().size(); }
+        TMV_INLINE ptrdiff_t rowsize() const { return mat().size(); }
+        TMV_INLINE ptrdiff_t size() const { return mat().size(); }
+        TMV_INLINE ptrdiff_t nlo() const { return TMV_MAX(size()-1,ptrdiff_t(0)); }
+        TMV_INLINE ptrdiff_t nhi() const { return TMV_MAX(size()-1,ptrdiff_t(0)); }
+        TMV_INLINE ptrdiff_t nElements() const { return mat().nElements(); }
+        TMV_INLINE ptrdiff_t stepi() const { return mat().stepi(); }
+        TMV_INLINE ptrdiff_t stepj() const { return mat().stepj(); }
+        TMV_INLINE bool isrm() const { return mat().isrm(); }
+        TMV_INLINE bool iscm() const { return mat().iscm(); }
+
+        // The iterators (and so the list initialization) only go over
+        // the stored triangle.
+        TMV_INLINE ptrdiff_t rowstart(ptrdiff_t i) const
+        { return Maybe<_upper>::select(i,0); }
+        TMV_INLINE ptrdiff_t rowend(ptrdiff_t i) const
+        { return Maybe<_upper>::select(size(),i+1); }
+        TMV_INLINE ptrdiff_t colstart(ptrdiff_t j) const
+        { return Maybe<_upper>::select(0,j); }
+        TMV_INLINE ptrdiff_t colend(ptrdiff_t j) const
+        { return Maybe<_upper>::select(j+1,size()); }
+
+        TMV_INLINE const_rowmajor_iterator rowmajor_begin() const
+        { return const_rowmajor_iterator(&mat(),0,0); }
+        TMV_INLINE const_rowmajor_iterator rowmajor_end() const
+        {
+            return const_rowmajor_iterator(
+                &mat(), size(), Maybe<_upper>::select(size(),0));
+        }
+
+        TMV_INLINE const_colmajor_iterator colmajor_begin() const
+        { return const_colmajor_iterator(&mat(),0,0); }
+        TMV_INLINE const_colmajor_iterator colmajor_end() const
+        {
+            return const_colmajor_iterator(
+                &mat(), Maybe<_upper>::select(0,size()), size());
+        }
+
+        TMV_INLINE const value_type* cptr() const { return mat().cptr(); }
+        TMV_INLINE value_type cref(ptrdiff_t i, ptrdiff_t j) const
+        { return mat().cref(i,j); }
+
+    }; // BaseMatrix_Sym
+
+    template <class M>
+    class BaseMatrix_Sym_Mutable :
+        public BaseMatrix_Sym<M>,
+        public BaseMatrix_Mutable<M>
+    {
+    public:
+        enum { _colsize = Traits<M>::_size };
+        enum { _rowsize = Traits<M>::_size };
+        enum { _size = Traits<M>::_size };
+        enum { _fort = Traits<M>::_fort };
+        enum { _shape = Traits<M>::_shape };
+        enum { _rowmajor = Traits<M>::_rowmajor };
+        enum { _colmajor = Traits<M>::_colmajor };
+        enum { _calc = Traits<M>::_calc };
+        enum { _conj = Traits<M>::_conj };
+        enum { _herm = Traits<M>::_herm };
+        enum { _packed = Traits<M>::_packed };
+        enum { _upper = Traits<M>::_upper };
+
+        typedef M type;
+        typedef BaseMatrix_Sym<M> base;
+        typedef BaseMatrix_Mutable<M> base_mut;
+
+        typedef typename base::calc_type calc_type;
+        typedef typename base::eval_type eval_type;
+        typedef typename base::copy_type copy_type;
+        typedef typename base::inverse_type inverse_type;
+        typedef typename base::value_type value_type;
+        typedef typename base::real_type real_type;
+        typedef typename base::complex_type complex_type;
+        typedef typename base::float_type float_type;
+        typedef typename base::zfloat_type zfloat_type;
+
+        typedef typename base::const_view_type const_view_type;
+        typedef typename base::const_cview_type const_cview_type;
+        typedef typename base::const_fview_type const_fview_type;
+        typedef typename base::const_xview_type const_xview_type;
+        typedef typename base::const_transpose_type const_transpose_type;
+        typedef typename base::const_conjugate_type const_conjugate_type;
+        typedef typename base::const_adjoint_type const_adjoint_type;
+        typedef typename base::const_realpart_type const_realpart_type;
+        typedef typename base::const_imagpart_type const_imagpart_type;
+        typedef typename base::const_nonconj_type const_nonconj_type;
+        typedef typename base::nonconst_type nonconst_type;
+        typedef typename base::const_diag_type const_diag_type;
+        typedef typename base::const_subsymmatrix_type
+            const_subsymmatrix_type;
+        typedef typename base::const_submatrix_type const_submatrix_type;
+        typedef typename base::const_uppertri_type const_uppertri_type;
+        typedef typename base::const_lowertri_type const_lowertri_type;
+        typedef typename base::const_cmview_type const_cmview_type;
+        typedef typename base::const_rmview_type const_rmview_type;
+
+        typedef typename base_mut::view_type view_type;
+        typedef typename base_mut::cview_type cview_type;
+        typedef typename base_mut::fview_type fview_type;
+        typedef typename base_mut::xview_type xview_type;
+        typedef typename base_mut::transpose_type transpose_type;
+        typedef typename base_mut::conjugate_type conjugate_type;
+        typedef typename base_mut::adjoint_type adjoint_type;
+        typedef typename base_mut::realpart_type realpart_type;
+        typedef typename base_mut::imagpart_type imagpart_type;
+        typedef typename base_mut::nonconj_type nonconj_type;
+        typedef typename base_mut::noalias_type noalias_type;
+        typedef typename base_mut::alias_type alias_type;
+        typedef typename base_mut::reference reference;
+        typedef typename base::const_rowmajor_iterator const_rowmajor_iterator;
+        typedef typename base::const_colmajor_iterator const_colmajor_iterator;
+        typedef typename base_mut::rowmajor_iterator rowmajor_iterator;
+        typedef typename base_mut::colmajor_iterator colmajor_iterator;
+
+        typedef typename Traits<M>::diag_type diag_type;
+        typedef typename Traits<M>::subsymmatrix_type subsymmatrix_type;
+        typedef typename Traits<M>::submatrix_type submatrix_type;
+        typedef typename Traits<M>::uppertri_type uppertri_type;
+        typedef typename Traits<M>::lowertri_type lowertri_type;
+        typedef typename Traits<M>::cmview_type cmview_type;
+        typedef typename Traits<M>::rmview_type rmview_type;
+
+
+        //
+        //
+        // Constructor
+        //
+
+    protected:
+        TMV_INLINE BaseMatrix_Sym_Mutable() {}
+        TMV_INLINE BaseMatrix_Sym_Mutable(const BaseMatrix_Sym_Mutable<M>&) {}
+        TMV_INLINE ~BaseMatrix_Sym_Mutable() {}
+    public:
+
+
+        //
+        // Access
+        //
+
+        TMV_INLINE_ND reference operator()(ptrdiff_t i, ptrdiff_t j)
+        {
+            CheckRowIndex<_fort>(i,size());
+            CheckColIndex<_fort>(j,size());
+            return ref(i,j);
+        }
+
+        TMV_INLINE diag_type diag()
+        {
+            TMVStaticAssert(!_packed);
+            return diag_type(ptr(),size(),stepi()+stepj());
+        }
+
+        // We need to repeat the const versions so the non-const ones
+        // don't clobber them.
+        TMV_INLINE value_type operator()(ptrdiff_t i, ptrdiff_t j) const
+        { return base::operator()(i,j); }
+        TMV_INLINE const_diag_type diag() const
+        { return base::diag(); }
+
+
+        //
+        // Op =
+        //
+
+        TMV_INLINE_ND type& operator=(const BaseMatrix_Sym_Mutable<M>& m2)
+        {
+            TMVAssert(size() == m2.size());
+            m2.assignTo(mat());
+            return mat();
+        }
+
+        template <class M2>
+        TMV_INLINE_ND type& operator=(const BaseMatrix<M2>& m2)
+        {
+            TMVStaticAssert((Sizes<_colsize,M2::_colsize>::same));
+            TMVStaticAssert((Sizes<_rowsize,M2::_rowsize>::same));
+            TMVAssert(colsize() == m2.colsize());
+            TMVAssert(rowsize() == m2.rowsize());
+            m2.assignTo(mat());
+            return mat();
+        }
+
+        TMV_INLINE type& operator=(const value_type x)
+        { return setToIdentity(x); }
+
+
+        //
+        // Modifying Functions
+        //
+
+        TMV_INLINE type& setZero()
+        { return setAllTo(value_type(0)); }
+
+        TMV_INLINE_ND type& setAllTo(value_type x)
+        {
+            TMVAssert(!_herm || TMV_IMAG(x) == real_type(0));
+            SymElements_Helper<_packed>::setAllTo(mat(),x);
+            return mat();
+        }
+
+        TMV_INLINE_ND type& addToAll(value_type x)
+        {
+            TMVAssert(!_herm || TMV_IMAG(x) == real_type(0));
+            SymElements_Helper<_packed>::addToAll(mat(),x);
+            return mat();
+        }
+
+        TMV_INLINE type& clip(float_type thresh)
+        { SymElements_Helper<_packed>::clip(mat(),thresh); return mat(); }
+
+        // f must satisfy f(conj(x)) = conj(f(x)) for hermitian matrices.
+        template <class F>
+        TMV_INLINE type& applyToAll(const F& f)
+        { SymElements_Helper<_packed>::applyToAll(mat(),f); return mat(); }
+
+        TMV_INLINE type& conjugateSelf()
+        { SymElements_Helper<_packed>::conjugateSelf(mat()); return mat(); }
+
+        // The transpose of a symmetric matrix is the same matrix, and
+        // the transpose of a hermitian matrix is its conjugate.
+        TMV_INLINE type& transposeSelf()
+        { if (_herm) conjugateSelf(); return mat(); }
+
+        TMV_INLINE_ND type& setToIdentity(const value_type x=value_type(1))
+        {
+            TMVAssert(!_herm || TMV_IMAG(x) == real_type(0));
+            setZero();
+            for(ptrdiff_t i=0;i<size();++i) ref(i,i) = x;
+            return mat();
+        }
+
+
+        //
+        // subSymMatrix, upperTri, lowerTri
+        //
+
+        TMV_INLINE subsymmatrix_type cSubSymMatrix(ptrdiff_t i1, ptrdiff_t i2)
+        {
+            TMVStaticAssert(!_packed);
+            return subsymmatrix_type(
+                ptr()+i1*(stepi()+stepj()), i2-i1, stepi(), stepj());
+        }
+
+        TMV_INLINE submatrix_type cSubMatrix(
+            ptrdiff_t i1, ptrdiff_t i2, ptrdiff_t j1, ptrdiff_t j2)
+        {
+            TMVStaticAssert(!_packed);
+            return submatrix_type(
+                ptr()+i1*stepi()+j1*stepj(), i2-i1, j2-j1, stepi(), stepj());
+        }
+
+        TMV_INLINE_ND subsymmatrix_type subSymMatrix(ptrdiff_t i1, ptrdiff_t i2)
+        {
+            CheckRange<_fort>(i1,i2,size());
+            return cSubSymMatrix(i1,i2);
+        }
+
+        TMV_INLINE_ND submatrix_type subMatrix(
+            ptrdiff_t i1, ptrdiff_t i2, ptrdiff_t j1, ptrdiff_t j2)
+        {
+            CheckRowRange<_fort>(i1,i2,size());
+            CheckColRange<_fort>(j1,j2,size());
+            TMVAssert((i1==i2 || j1==j2 ||
+                       (_upper ? i2-1 <= j1 : j2-1 <= i1)) &&
+                      "subMatrix must be within the stored triangle");
+            return cSubMatrix(i1,i2,j1,j2);
+        }
+
+        TMV_INLINE uppertri_type upperTri()
+        {
+            TMVStaticAssert(!_packed);
+            return uppertri_type(
+                ptr(),size(),
+                _upper ? stepi() : stepj(), _upper ? stepj() : stepi());
+        }
+
+        TMV_INLINE lowertri_type lowerTri()
+        {
+            TMVStaticAssert(!_packed);
+            return lowertri_type(
+                ptr(),size(),
+                _upper ? stepj() : stepi(), _upper ? stepi() : stepj());
+        }
+
+        // Repeat the const versions:
+        TMV_INLINE const_subsymmatrix_type cSubSymMatrix(
+            ptrdiff_t i1, ptrdiff_t i2) const
+        { return base::cSubSymMatrix(i1,i2); }
+        TMV_INLINE const_subsymmatrix_type subSymMatrix(
+            ptrdiff_t i1, ptrdiff_t i2) const
+        { return base::subSymMatrix(i1,i2); }
+        TMV_INLINE const_submatrix_type cSubMatrix(
+            ptrdiff_t i1, ptrdiff_t i2, ptrdiff_t j1, ptrdiff_t j2) const
+        { return base::cSubMatrix(i1,i2,j1,j2); }
+        TMV_INLINE const_submatrix_type subMatrix(
+            ptrdiff_t i1, ptrdiff_t i2, ptrdiff_t j1, ptrdiff_t j2) const
+        { return base::subMatrix(i1,i2,j1,j2); }
+        TMV_INLINE const_uppertri_type upperTri() const
+        { return base::upperTri(); }
+        TMV_INLINE const_lowertri_type lowerTri() const
+        { return base::lowerTri(); }
+
+
+        //
+        // Views
+        //
+
+        TMV_INLINE TMV_MAYBE_REF(type,view_type) view()
+        { return MakeSymView<type,view_type>::call(mat()); }
+
+        TMV_INLINE TMV_MAYBE_REF(type,cview_type) cView()
+        { return MakeSymView<type,cview_type>::call(mat()); }
+
+        TMV_INLINE TMV_MAYBE_REF(type,fview_type) fView()
+        { return MakeSymView<type,fview_type>::call(mat()); }
+
+        TMV_INLINE TMV_MAYBE_REF(type,xview_type) xView()
+        { return MakeSymView<type,xview_type>::call(mat()); }
+
+        TMV_INLINE_ND TMV_MAYBE_REF(type,cmview_type) cmView()
+        {
+            TMVAssert(this->iscm() && "Called cmView on non-ColMajor matrix");
+            return MakeSymView<type,cmview_type>::call(mat());
+        }
+
+        TMV_INLINE_ND TMV_MAYBE_REF(type,rmview_type) rmView()
+        {
+            TMVAssert(this->isrm() && "Called rmView on non-RowMajor matrix");
+            return MakeSymView<type,rmview_type>::call(mat());
+        }
+
+        TMV_INLINE TMV_MAYBE_REF(type,transpose_type) transpose()
+        { return MakeSymView<type,transpose_type>::callT(mat()); }
+
+        TMV_INLINE TMV_MAYBE_REF(type,conjugate_type) conjugate()
+        { return MakeSymView<type,conjugate_type>::call(mat()); }
+
+        TMV_INLINE TMV_MAYBE_REF(type,adjoint_type) adjoint()
+        { return MakeSymView<type,adjoint_type>::callT(mat()); }
+
+        realpart_type realPart()
+        {
+            TMVStaticAssert(!_packed);
+            const bool isreal = Traits<value_type>::isreal;
+            return realpart_type(
+                reinterpret_cast<real_type*>(ptr()), size(),
+                isreal ? stepi() : 2*stepi(), isreal ? stepj() : 2*stepj());
+        }
+
+        imagpart_type imagPart()
+        {
+            TMVStaticAssert(!_herm);
+            TMVStaticAssert(!_packed);
+            TMVStaticAssert(Traits<value_type>::iscomplex);
+            return imagpart_type(
+                reinterpret_cast<real_type*>(ptr())+1, size(),
+                2*stepi(), 2*stepj());
+        }
+
+        TMV_INLINE TMV_MAYBE_REF(type,nonconj_type) nonConj()
+        { return MakeSymView<type,nonconj_type>::call(mat()); }
+
+        TMV_INLINE TMV_MAYBE_REF(type,noalias_type) noAlias()
+        { return MakeSymView<type,noalias_type>::call(mat()); }
+
+        TMV_INLINE TMV_MAYBE_REF(type,alias_type) alias()
+        { return MakeSymView<type,alias_type>::call(mat()); }
+
+
+        // Repeat the const versions:
+        TMV_INLINE TMV_MAYBE_CREF(type,const_view_type) view() const
+        { return base::view(); }
+        TMV_INLINE TMV_MAYBE_CREF(type,const_cview_type) cView() const
+        { return base::cView(); }
+        TMV_INLINE TMV_MAYBE_CREF(type,const_fview_type) fView() const
+        { return base::fView(); }
+        TMV_INLINE TMV_MAYBE_CREF(type,const_xview_type) xView() const
+        { return base::xView(); }
+        TMV_INLINE TMV_MAYBE_CREF(type,const_cmview_type) cmView() const
+        { return base::cmView(); }
+        TMV_INLINE TMV_MAYBE_CREF(type,const_rmview_type) rmView() const
+        { return base::rmView(); }
+        TMV_INLINE TMV_MAYBE_CREF(type,const_transpose_type) transpose() const
+        { return base::transpose(); }
+        TMV_INLINE TMV_MAYBE_CREF(type,const_conjugate_type) conjugate() const
+        { return base::conjugate(); }
+        TMV_INLINE TMV_MAYBE_CREF(type,const_adjoint_type) adjoint() const
+        { return base::adjoint(); }
+        TMV_INLINE const_realpart_type realPart() const
+        { return base::realPart(); }
+        TMV_INLINE const_imagpart_type imagPart() const
+        { return base::imagPart(); }
+        TMV_INLINE TMV_MAYBE_CREF(type,const_nonconj_type) nonConj() const
+        { return base::nonConj(); }
+
+
+        //
+        // Auxilliary routines
+        //
+
+        TMV_INLINE const type& mat() const
+        { return static_cast<const type&>(*this); }
+        TMV_INLINE type& mat()
+        { return static_cast<type&>(*this); }
+
+        TMV_INLINE rowmajor_iterator rowmajor_begin()
+        { return rowmajor_iterator(&mat(),0,0); }
+        TMV_INLINE rowmajor_iterator rowmajor_end()
+        {
+            return rowmajor_iterator(
+                &mat(), size(), Maybe<_upper>::select(size(),0));
+        }
+
+        TMV_INLINE colmajor_iterator colmajor_begin()
+        { return colmajor_iterator(&mat(),0,0); }
+        TMV_INLINE colmajor_iterator colmajor_end()
+        {
+            return colmajor_iterator(
+                &mat(), Maybe<_upper>::select(0,size()), size());
+        }
+
+        TMV_INLINE const_rowmajor_iterator rowmajor_begin() const
+        { return base::rowmajor_begin(); }
+        TMV_INLINE const_rowmajor_iterator rowmajor_end() const
+        { return base::rowmajor_end(); }
+        TMV_INLINE const_colmajor_iterator colmajor_begin() const
+        { return base::colmajor_begin(); }
+        TMV_INLINE const_colmajor_iterator colmajor_end() const
+        { return base::colmajor_end(); }
+
+
+        // Note that these last functions need to be defined in a more derived
+        // class than this, or an infinite loop will result when compiling.
+        // Also, cref and cptr from above.
+
+        TMV_INLINE ptrdiff_t colsize() const { return mat().size(); }
+        TMV_INLINE ptrdiff_t rowsize() const { return mat().size(); }
+        TMV_INLINE ptrdiff_t size() const { return mat().size(); }
+        TMV_INLINE ptrdiff_t stepi() const { return mat().stepi(); }
+        TMV_INLINE ptrdiff_t stepj() const { return mat().stepj(); }
+
+        TMV_INLINE value_type* ptr() { return mat().ptr(); }
+        TMV_INLINE reference ref(ptrdiff_t i, ptrdiff_t j)
+        { return mat().ref(i,j); }
+        TMV_INLINE value_type cref(ptrdiff_t i, ptrdiff_t j) const
+        { return mat().cref(i,j); }
+
+    }; // BaseMatrix_Sym_Mutable
+
+
+    // This helper class helps decide calc_type for composite classes:
+    // (There are no SmallSymMatrix classes, so the sizes are ignored.)
+    template <class T, ptrdiff_t cs, ptrdiff_t rs, int A>
+    struct MCopyHelper<T,Sym,cs,rs,A>
+    { typedef SymMatrix<T,(A & ~AllDivStatus)|NoAlias> type; };
+    template <class T, ptrdiff_t cs, ptrdiff_t rs, int A>
+    struct MCopyHelper<T,RealSym,cs,rs,A>
+    { typedef SymMatrix<T,(A & ~AllDivStatus)|NoAlias> type; };
+    template <class T, ptrdiff_t cs, ptrdiff_t rs, int A>
+    struct MCopyHelper<T,Herm,cs,rs,A>
+    { typedef HermMatrix<T,(A & ~AllDivStatus)|NoAlias> type; };
+
+    template <class T, ptrdiff_t cs, ptrdiff_t rs, ptrdiff_t si, ptrdiff_t sj, int A>
+    struct MViewHelper<T,Sym,cs,rs,si,sj,A>
+    {
+        enum { A2 = A | NoAlias };
+        typedef SymMatrixView<T,A2> type;
+        typedef ConstSymMatrixView<T,A2> ctype;
+    };
+    template <class T, ptrdiff_t cs, ptrdiff_t rs, ptrdiff_t si, ptrdiff_t sj, int A>
+    struct MViewHelper<T,RealSym,cs,rs,si,sj,A>
+    {
+        enum { A2 = A | NoAlias };
+        typedef SymMatrixView<T,A2> type;
+        typedef ConstSymMatrixView<T,A2> ctype;
+    };
+    template <class T, ptrdiff_t cs, ptrdiff_t rs, ptrdiff_t si, ptrdiff_t sj, int A>
+    struct MViewHelper<T,Herm,cs,rs,si,sj,A>
+    {
+        enum { A2 = A | NoAlias };
+        typedef HermMatrixView<T,A2> type;
+        typedef ConstHermMatrixView<T,A2> ctype;
+    };
+
+
+    //
+    // Copy Matrices
+    //
+
+    template <int algo, class M1, class M2>
+    struct CopyS_Helper;
+
+    // algo 11: Loop over the stored triangle of m1 using cref.
+    // This is the only way to deal with packed storage.
+    template <class M1, class M2>
+    struct CopyS_Helper<11,M1,M2>
+    {
+        static void call(const M1& m1, M2& m2)
+        {
+            const ptrdiff_t n = m1.size();
+            for(ptrdiff_t j=0;j<n;++j) {
+                const ptrdiff_t i1 = m1.isupper() ? 0 : j;
+                const ptrdiff_t i2 = m1.isupper() ? j+1 : n;
+                for(ptrdiff_t i=i1;i<i2;++i) m2.ref(i,j) = m1.cref(i,j);
+            }
+        }
+    };
+
+    // algo 12: Copy the lower triangle.
+    template <class M1, class M2>
+    struct CopyS_Helper<12,M1,M2>
+    {
+        static TMV_INLINE void call(const M1& m1, M2& m2)
+        {
+            typename M1::const_lowertri_type m1l = m1.lowerTri();
+            typename M2::lowertri_type m2l = m2.lowerTri();
+            Copy(m1l,m2l);
+        }
+    };
+
+    template <class M1, class M2>
+    inline void Copy(
+        const BaseMatrix_Sym<M1>& m1, BaseMatrix_Sym_Mutable<M2>& m2)
+    {
+        TMVStaticAssert((ShapeTraits2<M1::_shape,M2::_shape>::assignable));
+        TMVAssert(m1.size() == m2.size());
+        const int algo = (M1::_packed || M2::_packed) ? 11 : 12;
+        CopyS_Helper<algo,M1,M2>::call(m1.mat(),m2.mat());
+    }
+
+    template <class M1, class M2>
+    inline void Copy(
+        const BaseMatrix_Diag<M1>& m1, BaseMatrix_Sym_Mutable<M2>& m2)
+    {
+        TMVAssert(m1.size() == m2.size());
+        m2.setZero();
+        const ptrdiff_t n = m1.size();
+        for(ptrdiff_t i=0;i<n;++i) m2.ref(i,i) = m1.cref(i,i);
+    }
+
+    //
+    // M = S
+    //
+
+    template <int algo, class M1, class M2>
+    struct CopySM_Helper;
+
+    // algo 11: Loop over the stored triangle of m1 using cref.
+    template <class M1, class M2>
+    struct CopySM_Helper<11,M1,M2>
+    {
+        static void call(const M1& m1, M2& m2)
+        {
+            const ptrdiff_t n = m1.size();
+            for(ptrdiff_t j=0;j<n;++j) {
+                m2.ref(j,j) = m1.cref(j,j);
+                for(ptrdiff_t i=j+1;i<n;++i) {
+                    m2.ref(i,j) = m1.cref(i,j);
+                    m2.ref(j,i) = m1.cref(j,i);
+                }
+            }
+        }
+    };
+
+    // algo 12: Copy the other triangle first, then the stored triangle.
+    // This way it works correctly if m2 is the same storage as m1.
+    template <class M1, class M2>
+    struct CopySM_Helper<12,M1,M2>
+    {
+        static void call(const M1& m1, M2& m2)
+        {
+            const ptrdiff_t n = m1.size();
+            if (n > 1) {
+                if (m1.isupper()) {
+                    typename M2::lowertri_type::offdiag_type m2l =
+                        m2.lowerTri().offDiag();
+                    Copy(m1.lowerTri().offDiag(),m2l);
+                } else {
+                    typename M2::uppertri_type::offdiag_type m2u =
+                        m2.upperTri().offDiag();
+                    Copy(m1.upperTri().offDiag(),m2u);
+                }
+            }
+            if (m1.isupper()) {
+                typename M2::uppertri_type m2u = m2.upperTri();
+                Copy(m1.upperTri(),m2u);
+            } else {
+                typename M2::lowertri_type m2l = m2.lowerTri();
+                Copy(m1.lowerTri(),m2l);
+            }
+        }
+    };
+
+    template <class M1, class M2>
+    inline void Copy(
+        const BaseMatrix_Sym<M1>& m1, BaseMatrix_Rec_Mutable<M2>& m2)
+    {
+        TMVAssert(m1.size() == m2.colsize());
+        TMVAssert(m1.size() == m2.rowsize());
+        const int algo = M1::_packed ? 11 : 12;
+        CopySM_Helper<algo,M1,M2>::call(m1.mat(),m2.mat());
+    }
+
+
+    //
+    // Trace
+    //
+
+    // The generic DoTrace uses diag(), which isn't available for
+    // packed storage.
+    template <class M>
+    TMV_INLINE typename M::value_type Trace(const BaseMatrix_Sym<M>& m)
+    { return m.trace(); }
+
+
+    //
+    // TMV_Text
+    //
+
+    template <class M>
+    inline std::string TMV_Text(const BaseMatrix_Sym<M>& m)
+    {
+        std::ostringstream s;
+        s << "BaseMatrix_Sym< "<<TMV_Text(m.mat())<<" >";
+        return s.str();
+    }
+
+    template <class M>
+    inline std::string TMV_Text(const BaseMatrix_Sym_Mutable<M>& m)
+    {
+        std::ostringstream s;
+        s << "BaseMatrix_Sym_Mutable< "<<TMV_Text(m.mat())<<" >";
+        return s.str();
+    }
+
+} // namespace tmv
+
+#endif
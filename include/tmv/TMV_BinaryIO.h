@@ -0,0 +1,713 @@
+
+
+// This file defines a binary file format for Matrix, BandMatrix,
+// UpperTriMatrix, LowerTriMatrix, DiagMatrix and Vector.
+//
+// The text format written by operator<< is convenient, but reading it
+// back goes through the istream one character at a time, which is
+// very slow for large matrices.  The binary format stores the elements
+// exactly as they are in memory, so reading a file is limited by the
+// speed of the disk rather than the parsing.
+//
+// The file starts with a 128 byte header that gives the version, the
+// kind of matrix, the element type, the storage order, the sizes and
+// the band widths.  The data follow immediately after, one column (or
+// row for RowMajor storage) after the other:
+//
+// Matrix:      M x N elements, ColMajor or RowMajor.
+// BandMatrix:  Each column holds lo+hi+1 elements, from row j-hi to row
+//              j+lo, with zeros for the rows outside the matrix.
+//              (This is the same as LAPACK's band storage.)  RowMajor
+//              is the same for each row.  DiagMajor BandMatrices are
+//              written as ColMajor.
+// UpperTriMatrix, LowerTriMatrix:
+//              The full N x N matrix, with zeros in the other triangle,
+//              and 1's on the diagonal if it is UnitDiag.
+// DiagMatrix, Vector:
+//              N elements.
+//
+// The data always start at byte 128, so they are aligned in a memory
+// mapped file.  The numbers are written in the native byte order, and
+// reading a file written on a machine with the other byte order
+// throws a BinaryReadError.
+//
+// The functions are:
+//
+// WriteBinary(os, m)
+// WriteBinary(filename, m)
+//     Write m in the binary format.  m may be any Matrix, BandMatrix,
+//     TriMatrix, DiagMatrix or Vector (or a view of one).
+//     If the file can't be opened or written, this throws a
+//     BinaryWriteError.
+//
+// ReadBinary(is, m)
+// ReadBinary(filename, m)
+//     Read a file into m, which is resized to match.  m must be a
+//     Matrix, BandMatrix, UpperTriMatrix, LowerTriMatrix, DiagMatrix
+//     or Vector whose value_type is the same as the one in the file.
+//     The storage order of m does not need to match the file.
+//
+// BinaryMatrixWriter<T> w(os, colsize, rowsize, stor)
+//     Write a Matrix one column (or row for RowMajor) at a time, so
+//     the full matrix never needs to be in memory.  Each call to
+//     w.write(v) writes the next column (row).
+//
+// MappedBinaryFile f(filename)
+//     Map the file into memory and return views directly into the
+//     mapped memory.  No copy is made, and pages are only read from
+//     the disk when they are accessed.  The views are only valid while
+//     f exists.
+//         f.header()                 the header
+//         f.matrixView<T>()          a ConstMatrixView<T>
+//         f.bandMatrixView<T>()      a ConstBandMatrixView<T>
+//         f.upperTriMatrixView<T>()  a ConstUpperTriMatrixView<T>
+//         f.lowerTriMatrixView<T>()  a ConstLowerTriMatrixView<T>
+//         f.diagMatrixView<T>()      a ConstDiagMatrixView<T>
+//         f.vectorView<T>()          a ConstVectorView<T>
+//     Memory mapping uses mmap, so it is only available on POSIX
+//     systems.  On other systems, the file is read into memory instead.
+
+#ifndef TMV_BinaryIO_H
+#define TMV_BinaryIO_H
+
+#include "TMV_BaseMatrix_Rec.h"
+#include "TMV_BaseMatrix_Band.h"
+#include "TMV_BaseMatrix_Tri.h"
+#include "TMV_BaseMatrix_Diag.h"
+#include "TMV_Vector.h"
+#include "TMV_Matrix.h"
+#include "TMV_BandMatrix.h"
+#include "TMV_TriMatrix.h"
+#include "TMV_DiagMatrix.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TMV_USE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace tmv {
+
+    //
+    // The header
+    //
+
+    enum {
+        BinaryVersion = 1,
+        BinaryHeaderSize = 128,
+        BinaryEndian = 0x01020304
+    };
+
+    // The codes for the element types.  Complex types add 16.
+    template <class T>
+    struct BinaryTypeCode { enum { value = 0 }; };
+    template <>
+    struct BinaryTypeCode<float> { enum { value = 1 }; };
+    template <>
+    struct BinaryTypeCode<double> { enum { value = 2 }; };
+    template <>
+    struct BinaryTypeCode<long double> { enum { value = 3 }; };
+    template <>
+    struct BinaryTypeCode<int> { enum { value = 4 }; };
+    template <class T>
+    struct BinaryTypeCode<std::complex<T> >
+    { enum { value = BinaryTypeCode<T>::value + 16 }; };
+
+    struct BinaryHeader
+    {
+        char magic[8];           // "TMV BIN" + '\0'
+        unsigned int endian;     // BinaryEndian
+        unsigned int version;    // BinaryVersion
+        unsigned int kind;       // 'M', 'B', 'U', 'L', 'D' or 'V'
+        unsigned int type;       // BinaryTypeCode<T>::value
+        unsigned int elemsize;   // sizeof(T)
+        unsigned int stor;       // 'C' or 'R'
+        unsigned int unitdiag;   // 1 for a UnitDiag TriMatrix
+        unsigned int reserved1;
+        long long colsize;
+        long long rowsize;
+        long long nlo;           // For BandMatrix
+        long long nhi;
+        long long dataoffset;    // The byte at which the data start
+        long long datasize;      // The number of elements
+        char reserved2[40];
+    };
+
+    inline std::string BinaryKindName(unsigned int kind)
+    {
+        switch (kind) {
+          case 'M' : return "Matrix";
+          case 'B' : return "BandMatrix";
+          case 'U' : return "UpperTriMatrix";
+          case 'L' : return "LowerTriMatrix";
+          case 'D' : return "DiagMatrix";
+          case 'V' : return "Vector";
+          default : return "unknown";
+        }
+    }
+
+    // The number of elements stored for each kind.
+    inline long long BinaryDataSize(
+        unsigned int kind, unsigned int stor,
+        long long cs, long long rs, long long lo, long long hi)
+    {
+        if (kind == 'M' || kind == 'U' || kind == 'L') return cs*rs;
+        else if (kind == 'B') {
+            if (cs == 0 || rs == 0) return 0;
+            const long long nlines = stor == 'R' ?
+                TMV_MIN(cs,rs+lo) : TMV_MIN(rs,cs+hi);
+            return nlines * (lo+hi+1);
+        } else return cs;
+    }
+
+    template <class T>
+    inline BinaryHeader MakeBinaryHeader(
+        unsigned int kind, unsigned int stor, ptrdiff_t cs, ptrdiff_t rs,
+        ptrdiff_t lo=0, ptrdiff_t hi=0, bool unit=false)
+    {
+        TMVStaticAssert(sizeof(BinaryHeader) == BinaryHeaderSize);
+        TMVStaticAssert(BinaryTypeCode<T>::value != 0);
+        BinaryHeader h;
+        std::memset(&h,0,sizeof(h));
+        std::memcpy(h.magic,"TMV BIN",8);
+        h.endian = BinaryEndian;
+        h.version = BinaryVersion;
+        h.kind = kind;
+        h.type = BinaryTypeCode<T>::value;
+        h.elemsize = sizeof(T);
+        h.stor = stor;
+        h.unitdiag = unit;
+        h.colsize = cs;
+        h.rowsize = rs;
+        h.nlo = lo;
+        h.nhi = hi;
+        h.dataoffset = BinaryHeaderSize;
+        h.datasize = BinaryDataSize(kind,stor,cs,rs,lo,hi);
+        return h;
+    }
+
+    //
+    // Errors
+    //
+
+#ifndef TMV_NO_THROW
+    class BinaryReadError :
+        public ReadError
+    {
+    public :
+        std::string msg;
+
+        BinaryReadError(std::string s) throw() :
+            ReadError("binary file"), msg(s) {}
+        ~BinaryReadError() throw() {}
+
+        void write(std::ostream& os) const throw()
+        { os<<"TMV Read Error: Reading binary file\n"<<msg<<std::endl; }
+        const char* what() const throw()
+        { return msg.c_str(); }
+    };
+#endif
+
+    inline void ThrowBinaryReadError(std::string s)
+    {
+#ifdef TMV_NO_THROW
+        std::cerr<<"TMV Read Error: Reading binary file\n"<<s<<std::endl;
+        exit(1);
+#else
+        throw BinaryReadError(s);
+#endif
+    }
+
+#ifndef TMV_NO_THROW
+    class BinaryWriteError :
+        public Error
+    {
+    public :
+        std::string msg;
+
+        BinaryWriteError(std::string s) throw() :
+            Error("Error writing binary file: ",s), msg(s) {}
+        ~BinaryWriteError() throw() {}
+
+        void write(std::ostream& os) const throw()
+        { os<<"TMV Write Error: Writing binary file\n"<<msg<<std::endl; }
+        const char* what() const throw()
+        { return msg.c_str(); }
+    };
+#endif
+
+    inline void ThrowBinaryWriteError(std::string s)
+    {
+#ifdef TMV_NO_THROW
+        std::cerr<<"TMV Write Error: Writing binary file\n"<<s<<std::endl;
+        exit(1);
+#else
+        throw BinaryWriteError(s);
+#endif
+    }
+
+    // Check that h is a valid header for a file with kind (one of kinds)
+    // and value_type T.  The data need to start on a multiple of
+    // sizeof(T), so the views into a MappedBinaryFile are aligned.
+    template <class T>
+    inline void CheckBinaryHeader(const BinaryHeader& h, const char* kinds)
+    {
+        if (std::memcmp(h.magic,"TMV BIN",8) != 0)
+            ThrowBinaryReadError("Not a TMV binary file");
+        if (h.endian != BinaryEndian)
+            ThrowBinaryReadError("File was written with the other byte order");
+        if (h.version > BinaryVersion)
+            ThrowBinaryReadError("File was written by a newer version of TMV");
+        if (!std::strchr(kinds,int(h.kind)) || h.kind == 0)
+            ThrowBinaryReadError(
+                "File holds a "+BinaryKindName(h.kind)+", not a "+
+                BinaryKindName(kinds[0]));
+        if (h.type != unsigned(BinaryTypeCode<T>::value) ||
+            h.elemsize != sizeof(T))
+            ThrowBinaryReadError("Element type in file does not match");
+        if ((h.stor != 'C' && h.stor != 'R') ||
+            h.colsize < 0 || h.rowsize < 0 || h.nlo < 0 || h.nhi < 0 ||
+            h.dataoffset < BinaryHeaderSize ||
+            h.dataoffset % sizeof(T) != 0 ||
+            h.datasize != BinaryDataSize(
+                h.kind,h.stor,h.colsize,h.rowsize,h.nlo,h.nhi))
+            ThrowBinaryReadError("Invalid header");
+    }
+
+    //
+    // Write
+    //
+
+    // Write the elements of v, using buf if v isn't contiguous.
+    template <class T, class V>
+    inline void WriteBinaryLine(std::ostream& os, const V& v, Vector<T>& buf)
+    {
+        const ptrdiff_t n = v.size();
+        if (n == 0) return;
+        if (v.step() == 1 && !v.isconj()) {
+            os.write(reinterpret_cast<const char*>(v.cptr()),n*sizeof(T));
+        } else {
+            buf.subVector(0,n) = v;
+            os.write(reinterpret_cast<const char*>(buf.cptr()),n*sizeof(T));
+        }
+    }
+
+    inline void WriteBinaryHeader(std::ostream& os, const BinaryHeader& h)
+    { os.write(reinterpret_cast<const char*>(&h),sizeof(h)); }
+
+    template <class V>
+    inline void WriteBinary(std::ostream& os, const BaseVector<V>& v)
+    {
+        typedef typename V::value_type T;
+        const ptrdiff_t n = v.size();
+        WriteBinaryHeader(os,MakeBinaryHeader<T>('V','C',n,1));
+        Vector<T> buf(n);
+        WriteBinaryLine(os,v.vec(),buf);
+    }
+
+    template <class M>
+    inline void WriteBinary(std::ostream& os, const BaseMatrix_Diag<M>& m)
+    {
+        typedef typename M::value_type T;
+        const ptrdiff_t n = m.size();
+        WriteBinaryHeader(os,MakeBinaryHeader<T>('D','C',n,n));
+        Vector<T> buf(n);
+        WriteBinaryLine(os,m.diag(),buf);
+    }
+
+    template <class M>
+    inline void WriteBinary(std::ostream& os, const BaseMatrix_Rec<M>& m)
+    {
+        typedef typename M::value_type T;
+        const M& mm = m.mat();
+        const ptrdiff_t cs = mm.colsize();
+        const ptrdiff_t rs = mm.rowsize();
+        const bool rm = mm.isrm();
+        WriteBinaryHeader(os,MakeBinaryHeader<T>('M',rm?'R':'C',cs,rs));
+        Vector<T> buf(rm ? rs : cs);
+        if (rm)
+            for(ptrdiff_t i=0;i<cs;++i) WriteBinaryLine(os,mm.get_row(i),buf);
+        else
+            for(ptrdiff_t j=0;j<rs;++j) WriteBinaryLine(os,mm.get_col(j),buf);
+    }
+
+    template <class M>
+    inline void WriteBinary(std::ostream& os, const BaseMatrix_Band<M>& m)
+    {
+        typedef typename M::value_type T;
+        const M& mm = m.mat();
+        const ptrdiff_t cs = mm.colsize();
+        const ptrdiff_t rs = mm.rowsize();
+        const ptrdiff_t lo = mm.nlo();
+        const ptrdiff_t hi = mm.nhi();
+        const bool rm = mm.isrm();
+        const BinaryHeader h = MakeBinaryHeader<T>(
+            'B',rm?'R':'C',cs,rs,lo,hi);
+        WriteBinaryHeader(os,h);
+        const ptrdiff_t nlines = cs == 0 || rs == 0 ? 0 :
+            rm ? TMV_MIN(cs,rs+lo) : TMV_MIN(rs,cs+hi);
+        Vector<T> line(lo+hi+1);
+        Vector<T> buf(lo+hi+1);
+        for(ptrdiff_t k=0;k<nlines;++k) {
+            // Line k holds elements k-hi..k+lo of column k
+            // (or k-lo..k+hi of row k).
+            const ptrdiff_t k0 = k - (rm ? lo : hi);
+            const ptrdiff_t i1 = TMV_MAX(k0,ptrdiff_t(0));
+            const ptrdiff_t i2 = TMV_MIN(k0+lo+hi+1,rm ? rs : cs);
+            line.setZero();
+            if (rm) line.subVector(i1-k0,i2-k0) = mm.get_row(k,i1,i2);
+            else line.subVector(i1-k0,i2-k0) = mm.get_col(k,i1,i2);
+            WriteBinaryLine(os,line,buf);
+        }
+    }
+
+    template <class M>
+    inline void WriteBinary(std::ostream& os, const BaseMatrix_Tri<M>& m)
+    {
+        typedef typename M::value_type T;
+        const M& mm = m.mat();
+        const ptrdiff_t n = mm.size();
+        const bool rm = mm.isrm();
+        const bool upper = mm.isupper();
+        const bool unit = mm.isunit();
+        WriteBinaryHeader(os,MakeBinaryHeader<T>(
+                upper?'U':'L',rm?'R':'C',n,n,0,0,unit));
+        Vector<T> line(n);
+        Vector<T> buf(n);
+        for(ptrdiff_t k=0;k<n;++k) {
+            // Column k of an upper triangle has elements 0..k.
+            // Row k of an upper triangle has elements k..n-1.
+            const bool first = (upper != rm);
+            const ptrdiff_t i1 = first ? 0 : (unit ? k+1 : k);
+            const ptrdiff_t i2 = first ? (unit ? k : k+1) : n;
+            line.setZero();
+            if (unit) line(k) = T(1);
+            if (i1 < i2) {
+                if (rm) line.subVector(i1,i2) = mm.get_row(k,i1,i2);
+                else line.subVector(i1,i2) = mm.get_col(k,i1,i2);
+            }
+            WriteBinaryLine(os,line,buf);
+        }
+    }
+
+    template <class X>
+    inline void WriteBinary(const std::string& file, const X& x)
+    {
+        std::ofstream fout(file.c_str(),std::ios::binary);
+        if (!fout) ThrowBinaryWriteError("Unable to open "+file);
+        WriteBinary(fout,x);
+        if (!fout) ThrowBinaryWriteError("Error writing "+file);
+    }
+
+    // Write a Matrix one column at a time (or one row for RowMajor).
+    template <class T>
+    class BinaryMatrixWriter
+    {
+    public :
+        BinaryMatrixWriter(
+            std::ostream& os, ptrdiff_t cs, ptrdiff_t rs,
+            StorageType stor=ColMajor) :
+            itsos(os), itscs(cs), itsrs(rs), itsrm(stor == RowMajor),
+            itsk(0), itsbuf(itsrm ? rs : cs)
+        {
+            TMVAssert(stor == ColMajor || stor == RowMajor);
+            WriteBinaryHeader(
+                itsos,MakeBinaryHeader<T>('M',itsrm?'R':'C',cs,rs));
+        }
+
+        // Write the next column (row).
+        template <class V>
+        void write(const BaseVector<V>& v)
+        {
+            TMVStaticAssert((Traits2<T,typename V::value_type>::sametype));
+            TMVAssert(itsk < (itsrm ? itscs : itsrs));
+            TMVAssert(v.size() == (itsrm ? itsrs : itscs));
+            WriteBinaryLine(itsos,v.vec(),itsbuf);
+            ++itsk;
+        }
+
+        // The number of columns (rows) written so far
+        ptrdiff_t count() const { return itsk; }
+        bool done() const { return itsk == (itsrm ? itscs : itsrs); }
+
+    private :
+        std::ostream& itsos;
+        ptrdiff_t itscs, itsrs;
+        bool itsrm;
+        ptrdiff_t itsk;
+        Vector<T> itsbuf;
+
+        BinaryMatrixWriter(const BinaryMatrixWriter<T>&);
+        void operator=(const BinaryMatrixWriter<T>&);
+    };
+
+    //
+    // Read
+    //
+
+    template <class T>
+    inline BinaryHeader ReadBinaryHeader(std::istream& is, const char* kinds)
+    {
+        BinaryHeader h;
+        if (!is.read(reinterpret_cast<char*>(&h),sizeof(h)))
+            ThrowBinaryReadError("Unable to read header");
+        CheckBinaryHeader<T>(h,kinds);
+        if (h.dataoffset > BinaryHeaderSize)
+            is.ignore(h.dataoffset - BinaryHeaderSize);
+        return h;
+    }
+
+    template <class T>
+    inline void ReadBinaryLine(std::istream& is, T* p, ptrdiff_t n)
+    {
+        if (n > 0 && !is.read(reinterpret_cast<char*>(p),n*sizeof(T)))
+            ThrowBinaryReadError("File ended prematurely");
+    }
+
+    template <class T, int A>
+    inline void ReadBinary(std::istream& is, Vector<T,A>& v)
+    {
+        const BinaryHeader h = ReadBinaryHeader<T>(is,"VD");
+        v.resize(h.colsize);
+        ReadBinaryLine(is,v.ptr(),v.size());
+    }
+
+    template <class T, int A>
+    inline void ReadBinary(std::istream& is, DiagMatrix<T,A>& m)
+    {
+        const BinaryHeader h = ReadBinaryHeader<T>(is,"DV");
+        m.resize(h.colsize);
+        ReadBinaryLine(is,m.ptr(),m.size());
+    }
+
+    template <class T, int A>
+    inline void ReadBinary(std::istream& is, Matrix<T,A>& m)
+    {
+        const BinaryHeader h = ReadBinaryHeader<T>(is,"M");
+        const ptrdiff_t cs = h.colsize;
+        const ptrdiff_t rs = h.rowsize;
+        const bool rm = h.stor == 'R';
+        m.resize(cs,rs);
+        if (rm ? m.isrm() : m.iscm()) {
+            // Same storage, so read directly into m.
+            ReadBinaryLine(is,m.ptr(),cs*rs);
+        } else {
+            Vector<T> buf(rm ? rs : cs);
+            if (rm) for(ptrdiff_t i=0;i<cs;++i) {
+                ReadBinaryLine(is,buf.ptr(),rs);
+                m.get_row(i) = buf;
+            } else for(ptrdiff_t j=0;j<rs;++j) {
+                ReadBinaryLine(is,buf.ptr(),cs);
+                m.get_col(j) = buf;
+            }
+        }
+    }
+
+    template <class T, int A>
+    inline void ReadBinary(std::istream& is, BandMatrix<T,A>& m)
+    {
+        const BinaryHeader h = ReadBinaryHeader<T>(is,"B");
+        const ptrdiff_t cs = h.colsize;
+        const ptrdiff_t rs = h.rowsize;
+        const ptrdiff_t lo = h.nlo;
+        const ptrdiff_t hi = h.nhi;
+        const bool rm = h.stor == 'R';
+        m.resize(cs,rs,lo,hi);
+        const ptrdiff_t nlines = cs == 0 || rs == 0 ? 0 :
+            rm ? TMV_MIN(cs,rs+lo) : TMV_MIN(rs,cs+hi);
+        Vector<T> buf(lo+hi+1);
+        for(ptrdiff_t k=0;k<nlines;++k) {
+            ReadBinaryLine(is,buf.ptr(),lo+hi+1);
+            const ptrdiff_t k0 = k - (rm ? lo : hi);
+            const ptrdiff_t i1 = TMV_MAX(k0,ptrdiff_t(0));
+            const ptrdiff_t i2 = TMV_MIN(k0+lo+hi+1,rm ? rs : cs);
+            if (rm) m.get_row(k,i1,i2) = buf.subVector(i1-k0,i2-k0);
+            else m.get_col(k,i1,i2) = buf.subVector(i1-k0,i2-k0);
+        }
+    }
+
+    // Read an upper or lower triangle into the storage of m.
+    template <class M>
+    inline void ReadBinaryTri(std::istream& is, M& m, const BinaryHeader& h)
+    {
+        typedef typename M::value_type T;
+        const ptrdiff_t n = h.colsize;
+        if (h.rowsize != h.colsize) ThrowBinaryReadError("Invalid header");
+        if (m.isunit() && !h.unitdiag)
+            ThrowBinaryReadError(
+                "Cannot read a NonUnitDiag TriMatrix into a UnitDiag one");
+        m.resize(n);
+        const bool rm = h.stor == 'R';
+        const bool upper = m.isupper();
+        const bool unit = m.isunit();
+        MatrixView<T> full(m.ptr(),n,n,m.stepi(),m.stepj());
+        Vector<T> buf(n);
+        for(ptrdiff_t k=0;k<n;++k) {
+            ReadBinaryLine(is,buf.ptr(),n);
+            const bool first = (upper != rm);
+            const ptrdiff_t i1 = first ? 0 : (unit ? k+1 : k);
+            const ptrdiff_t i2 = first ? (unit ? k : k+1) : n;
+            if (i1 < i2) {
+                if (rm) full.get_row(k,i1,i2) = buf.subVector(i1,i2);
+                else full.get_col(k,i1,i2) = buf.subVector(i1,i2);
+            }
+        }
+    }
+
+    template <class T, int A>
+    inline void ReadBinary(std::istream& is, UpperTriMatrix<T,A>& m)
+    { ReadBinaryTri(is,m,ReadBinaryHeader<T>(is,"U")); }
+
+    template <class T, int A>
+    inline void ReadBinary(std::istream& is, LowerTriMatrix<T,A>& m)
+    { ReadBinaryTri(is,m,ReadBinaryHeader<T>(is,"L")); }
+
+    template <class X>
+    inline void ReadBinary(const std::string& file, X& x)
+    {
+        std::ifstream fin(file.c_str(),std::ios::binary);
+        if (!fin) ThrowBinaryReadError("Unable to open "+file);
+        ReadBinary(fin,x);
+    }
+
+    //
+    // Memory mapped files
+    //
+
+    class MappedBinaryFile
+    {
+    public :
+        explicit MappedBinaryFile(const std::string& file) :
+            itsfile(file), itsp(0), itssize(0)
+        {
+#ifdef TMV_USE_MMAP
+            const int fd = ::open(file.c_str(),O_RDONLY);
+            if (fd < 0) ThrowBinaryReadError("Unable to open "+file);
+            struct stat st;
+            if (::fstat(fd,&st) != 0) {
+                ::close(fd);
+                ThrowBinaryReadError("Unable to stat "+file);
+            }
+            itssize = st.st_size;
+            if (itssize < ptrdiff_t(BinaryHeaderSize)) {
+                ::close(fd);
+                ThrowBinaryReadError("File is too small: "+file);
+            }
+            void* p = ::mmap(0,itssize,PROT_READ,MAP_SHARED,fd,0);
+            ::close(fd);
+            if (p == MAP_FAILED) ThrowBinaryReadError("Unable to map "+file);
+            itsp = static_cast<char*>(p);
+#else
+            std::ifstream fin(file.c_str(),std::ios::binary);
+            if (!fin) ThrowBinaryReadError("Unable to open "+file);
+            fin.seekg(0,std::ios::end);
+            itssize = fin.tellg();
+            fin.seekg(0,std::ios::beg);
+            if (itssize < ptrdiff_t(BinaryHeaderSize))
+                ThrowBinaryReadError("File is too small: "+file);
+            itsbuf.resize(itssize);
+            itsp = itsbuf.get();
+            if (!fin.read(itsp,itssize))
+                ThrowBinaryReadError("Unable to read "+file);
+#endif
+            std::memcpy(&itsh,itsp,sizeof(itsh));
+        }
+
+        ~MappedBinaryFile()
+        {
+#ifdef TMV_USE_MMAP
+            if (itsp) ::munmap(itsp,itssize);
+#endif
+        }
+
+        const BinaryHeader& header() const { return itsh; }
+        const std::string& filename() const { return itsfile; }
+
+        template <class T>
+        ConstMatrixView<T> matrixView() const
+        {
+            const T* p = data<T>("M");
+            const ptrdiff_t cs = itsh.colsize;
+            const ptrdiff_t rs = itsh.rowsize;
+            return itsh.stor == 'R' ?
+                ConstMatrixView<T>(p,cs,rs,rs,1) :
+                ConstMatrixView<T>(p,cs,rs,1,cs);
+        }
+
+        template <class T>
+        ConstBandMatrixView<T> bandMatrixView() const
+        {
+            const T* p = data<T>("B");
+            const ptrdiff_t cs = itsh.colsize;
+            const ptrdiff_t rs = itsh.rowsize;
+            const ptrdiff_t lo = itsh.nlo;
+            const ptrdiff_t hi = itsh.nhi;
+            // Line k starts at k*(lo+hi+1), and element (i,j) is at
+            // (i-j+hi) in column j (or j-i+lo in row i).
+            return itsh.stor == 'R' ?
+                ConstBandMatrixView<T>(p+lo,cs,rs,lo,hi,lo+hi,1) :
+                ConstBandMatrixView<T>(p+hi,cs,rs,lo,hi,1,lo+hi);
+        }
+
+        template <class T>
+        ConstUpperTriMatrixView<T> upperTriMatrixView() const
+        {
+            const T* p = data<T>("U");
+            const ptrdiff_t n = itsh.colsize;
+            const DiagType dt = itsh.unitdiag ? UnitDiag : NonUnitDiag;
+            return itsh.stor == 'R' ?
+                ConstUpperTriMatrixView<T>(p,n,n,1,dt) :
+                ConstUpperTriMatrixView<T>(p,n,1,n,dt);
+        }
+
+        template <class T>
+        ConstLowerTriMatrixView<T> lowerTriMatrixView() const
+        {
+            const T* p = data<T>("L");
+            const ptrdiff_t n = itsh.colsize;
+            const DiagType dt = itsh.unitdiag ? UnitDiag : NonUnitDiag;
+            return itsh.stor == 'R' ?
+                ConstLowerTriMatrixView<T>(p,n,n,1,dt) :
+                ConstLowerTriMatrixView<T>(p,n,1,n,dt);
+        }
+
+        template <class T>
+        ConstDiagMatrixView<T> diagMatrixView() const
+        { return ConstDiagMatrixView<T>(data<T>("DV"),itsh.colsize,1); }
+
+        template <class T>
+        ConstVectorView<T> vectorView() const
+        { return ConstVectorView<T>(data<T>("VD"),itsh.colsize,1); }
+
+    private :
+
+        template <class T>
+        const T* data(const char* kinds) const
+        {
+            CheckBinaryHeader<T>(itsh,kinds);
+            if (itsh.dataoffset + itsh.datasize * ptrdiff_t(sizeof(T)) >
+                itssize)
+                ThrowBinaryReadError("File is too small: "+itsfile);
+            return reinterpret_cast<const T*>(itsp + itsh.dataoffset);
+        }
+
+        std::string itsfile;
+        BinaryHeader itsh;
+        char* itsp;
+        ptrdiff_t itssize;
+#ifndef TMV_USE_MMAP
+        AlignedArray<char> itsbuf;
+#endif
+
+        MappedBinaryFile(const MappedBinaryFile&);
+        void operator=(const MappedBinaryFile&);
+    };
+
+} // namespace tmv
+
+#endif
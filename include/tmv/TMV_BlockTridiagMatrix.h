@@ -0,0 +1,586 @@
+//---------------------------------------------------------------------------
+//
+// This file defines the TMV BlockTridiagMatrix class, which holds a
+// square matrix made of n x n dense blocks, each of size bs x bs,
+// of which only the three central block diagonals are nonzero:
+//
+//    ( D0 C0             )
+//    ( L0 D1 C1          )
+//    (    L1 D2 C2       )
+//    (       ..  ..  ..  )
+//    (          Ln-2 Dn-1)
+//
+// These come up a lot in implicit PDE solvers, where each block couples
+// the bs variables at one grid point (or one line of a grid) to those
+// of its neighbors.  Storing them as a BandMatrix with nlo = nhi = 2bs-1
+// wastes a lot of memory on the zeros inside the band, and the band
+// algorithms can't use the dense block kernels (MultMM, LU_Decompose).
+//
+// The blocks are stored as three column major arrays of blocks, so each
+// block is a contiguous bs x bs column major matrix.
+//
+// The functions that use it are:
+//
+//    BlockTridiag_MultMV(A, x, y)       y = A x
+//    BlockTridiag_MultMM(A, X, Y)       Y = A X
+//    BlockTridiag_Decompose(A, P)       Block LU decomposition in place
+//                                       (the block Thomas algorithm).
+//    BlockTridiag_SolveInPlace(A, P, b) b = A^-1 b using the
+//                                       decomposition in A,P.
+//                                       b may be a vector or a matrix.
+//    BlockTridiag_SolveCR(A, b)         b = A^-1 b using block cyclic
+//                                       reduction.  A is not modified.
+//
+// The block Thomas algorithm is the block version of the usual
+// tridiagonal LU decomposition:
+//
+//    D'0 = D0,  C'k = D'k^-1 Ck,  D'k+1 = Dk+1 - Lk C'k
+//
+// Each D'k is decomposed with LU_Decompose (which pivots within the block)
+// and C'k is found with LU_SolveInPlace, and the updates are MultMM
+// calls.  There is no pivoting between blocks, so this is only stable
+// for matrices where the D'k stay well conditioned, e.g. block diagonally
+// dominant matrices, which is the usual case for these problems.
+// On output, A.diag(k) holds the LU decomposition of D'k, with the pivots
+// in P[k*bs .. (k+1)*bs], and A.upper(k) holds C'k.  P must have
+// room for n*bs values.
+//
+// The Thomas algorithm is inherently sequential from one block to the
+// next.  Block cyclic reduction instead eliminates the odd numbered
+// block rows using the even numbered ones, all of which can be done in
+// parallel.  This leaves a block tridiagonal system of half the size
+// for the even numbered unknowns, which is done the same way until there
+// is only one block left.  Then the odd unknowns at each level are found
+// from the even ones (again in parallel).  It takes about 2-3 times as
+// many flops as the Thomas algorithm, so it is only faster with
+// several threads.  It has the same stability properties as the Thomas
+// algorithm.  With OpenMP, each level is split among the threads
+// when it has at least TMV_BLOCKTRIDIAG_OPENMP_THRESH * bs^3 flops.
+//
+//
+// Constructors:
+//
+//    BlockTridiagMatrix<T>(ptrdiff_t n, ptrdiff_t bs)
+//        Makes a block tridiagonal matrix of n x n blocks, each bs x bs,
+//        with _uninitialized_ values.
+//
+//    BlockTridiagMatrix<T>(ptrdiff_t n, ptrdiff_t bs, T x)
+//        Makes the same with all the values in the three block diagonals
+//        equal to x.
+//
+// Access:
+//
+//    nBlocks(), blockSize()
+//        n and bs respectively.
+//
+//    colsize(), rowsize()
+//        The full size of the matrix, n*bs.
+//
+//    diag(k)            Block (k,k)     k = 0..n-1
+//    lower(k)           Block (k+1,k)   k = 0..n-2
+//    upper(k)           Block (k,k+1)   k = 0..n-2
+//        Returns a MatrixView of the given block.
+//
+//    A(i,j)
+//        Returns the (i,j) element of the full matrix (0 outside the
+//        three block diagonals).
+//
+//    setZero(), setAllTo(x)
+//        Set all the values in the three block diagonals.
+
+
+#ifndef TMV_BlockTridiagMatrix_H
+#define TMV_BlockTridiagMatrix_H
+
+#include "TMV_Matrix.h"
+#include "TMV_Vector.h"
+#include "TMV_Permutation.h"
+#include "TMV_LUDecompose.h"
+#include "TMV_LUDiv.h"
+#include "TMV_ProdMM.h"
+#include "TMV_ProdMV.h"
+#include "TMV_SumMM.h"
+#include "TMV_CopyM.h"
+#include <vector>
+#include <deque>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace tmv {
+
+    // The minimum flops for one level of the cyclic reduction, in units
+    // of bs^3, to split it among the threads.
+#ifndef TMV_BLOCKTRIDIAG_OPENMP_THRESH
+#define TMV_BLOCKTRIDIAG_OPENMP_THRESH 64
+#endif
+
+    template <class T>
+    class BlockTridiagMatrix
+    {
+    public:
+
+        typedef T value_type;
+        typedef BlockTridiagMatrix<T> type;
+        typedef Matrix<T,ColMajor> storage_type;
+        typedef typename storage_type::colrange_type block_type;
+        typedef typename storage_type::const_colrange_type const_block_type;
+
+        BlockTridiagMatrix(ptrdiff_t n, ptrdiff_t bs) :
+            itsn(n), itsbs(bs),
+            itsd(bs,n*bs), itsl(bs,(n>0?n-1:0)*bs), itsu(bs,(n>0?n-1:0)*bs)
+        { TMVAssert(n >= 0 && bs >= 0); }
+
+        BlockTridiagMatrix(ptrdiff_t n, ptrdiff_t bs, T x) :
+            itsn(n), itsbs(bs),
+            itsd(bs,n*bs,x), itsl(bs,(n>0?n-1:0)*bs,x),
+            itsu(bs,(n>0?n-1:0)*bs,x)
+        { TMVAssert(n >= 0 && bs >= 0); }
+
+        TMV_INLINE ptrdiff_t nBlocks() const { return itsn; }
+        TMV_INLINE ptrdiff_t blockSize() const { return itsbs; }
+        TMV_INLINE ptrdiff_t colsize() const { return itsn*itsbs; }
+        TMV_INLINE ptrdiff_t rowsize() const { return itsn*itsbs; }
+
+        TMV_INLINE const_block_type diag(ptrdiff_t k) const
+        {
+            TMVAssert(k >= 0 && k < itsn);
+            return itsd.cColRange(k*itsbs,(k+1)*itsbs);
+        }
+        TMV_INLINE const_block_type lower(ptrdiff_t k) const
+        {
+            TMVAssert(k >= 0 && k < itsn-1);
+            return itsl.cColRange(k*itsbs,(k+1)*itsbs);
+        }
+        TMV_INLINE const_block_type upper(ptrdiff_t k) const
+        {
+            TMVAssert(k >= 0 && k < itsn-1);
+            return itsu.cColRange(k*itsbs,(k+1)*itsbs);
+        }
+        TMV_INLINE block_type diag(ptrdiff_t k)
+        {
+            TMVAssert(k >= 0 && k < itsn);
+            return itsd.cColRange(k*itsbs,(k+1)*itsbs);
+        }
+        TMV_INLINE block_type lower(ptrdiff_t k)
+        {
+            TMVAssert(k >= 0 && k < itsn-1);
+            return itsl.cColRange(k*itsbs,(k+1)*itsbs);
+        }
+        TMV_INLINE block_type upper(ptrdiff_t k)
+        {
+            TMVAssert(k >= 0 && k < itsn-1);
+            return itsu.cColRange(k*itsbs,(k+1)*itsbs);
+        }
+
+        T operator()(ptrdiff_t i, ptrdiff_t j) const
+        {
+            TMVAssert(i >= 0 && i < colsize());
+            TMVAssert(j >= 0 && j < rowsize());
+            const ptrdiff_t bi = i / itsbs, bj = j / itsbs;
+            const ptrdiff_t ii = i - bi*itsbs, jj = j - bj*itsbs;
+            if (bi == bj) return itsd.cref(ii,j);
+            else if (bi == bj+1) return itsl.cref(ii,j);
+            else if (bj == bi+1) return itsu.cref(ii,j-itsbs);
+            else return T(0);
+        }
+
+        type& setZero()
+        { itsd.setZero(); itsl.setZero(); itsu.setZero(); return *this; }
+
+        type& setAllTo(const T& x)
+        {
+            itsd.setAllTo(x); itsl.setAllTo(x); itsu.setAllTo(x);
+            return *this;
+        }
+
+    private:
+
+        ptrdiff_t itsn;
+        ptrdiff_t itsbs;
+        storage_type itsd;
+        storage_type itsl;
+        storage_type itsu;
+
+    }; // BlockTridiagMatrix
+
+    template <class T>
+    inline std::string TMV_Text(const BlockTridiagMatrix<T>& )
+    { return std::string("BlockTridiagMatrix<")+TMV_Text(T())+">"; }
+
+
+    //
+    // Y = A X
+    //
+
+    template <class T, class T2>
+    inline void BlockTridiag_MultMM(
+        const BlockTridiagMatrix<T>& A, const ConstMatrixView<T2>& X,
+        MatrixView<T2> Y)
+    {
+        const ptrdiff_t n = A.nBlocks();
+        const ptrdiff_t bs = A.blockSize();
+        TMVAssert(X.colsize() == A.rowsize());
+        TMVAssert(Y.colsize() == A.colsize());
+        TMVAssert(X.rowsize() == Y.rowsize());
+        for(ptrdiff_t k=0; k<n; ++k) {
+            MatrixView<T2> Yk = Y.rowRange(k*bs,(k+1)*bs);
+            Yk.noAlias() = A.diag(k) * X.rowRange(k*bs,(k+1)*bs);
+            if (k > 0)
+                Yk.noAlias() += A.lower(k-1) * X.rowRange((k-1)*bs,k*bs);
+            if (k < n-1)
+                Yk.noAlias() += A.upper(k) * X.rowRange((k+1)*bs,(k+2)*bs);
+        }
+    }
+
+    template <class T, class M1, class M2>
+    inline void BlockTridiag_MultMM(
+        const BlockTridiagMatrix<T>& A, const BaseMatrix_Rec<M1>& X,
+        BaseMatrix_Rec_Mutable<M2>& Y)
+    {
+        typedef typename M2::value_type T2;
+        if (M1::_conj) {
+            Matrix<T2,ColMajor> X1 = X;
+            BlockTridiag_MultMM(A,X1,Y);
+        } else if (M2::_conj) {
+            Matrix<T2,ColMajor> Y1(Y.colsize(),Y.rowsize());
+            BlockTridiag_MultMM(A,X,Y1);
+            Y = Y1;
+        } else {
+            BlockTridiag_MultMM(
+                A,ConstMatrixView<T2>(X.cptr(),X.colsize(),X.rowsize(),
+                                      X.stepi(),X.stepj()),
+                MatrixView<T2>(Y.ptr(),Y.colsize(),Y.rowsize(),
+                               Y.stepi(),Y.stepj()));
+        }
+    }
+
+    template <class T, class V1, class V2>
+    inline void BlockTridiag_MultMV(
+        const BlockTridiagMatrix<T>& A, const BaseVector_Calc<V1>& x,
+        BaseVector_Mutable<V2>& y)
+    {
+        const ptrdiff_t n = A.nBlocks();
+        const ptrdiff_t bs = A.blockSize();
+        TMVAssert(x.size() == A.rowsize());
+        TMVAssert(y.size() == A.colsize());
+        typedef typename V1::const_subvector_type V1s;
+        typedef typename V2::subvector_type V2s;
+        for(ptrdiff_t k=0; k<n; ++k) {
+            V2s yk = y.vec().cSubVector(k*bs,(k+1)*bs);
+            V1s xk = x.vec().cSubVector(k*bs,(k+1)*bs);
+            yk.noAlias() = A.diag(k) * xk;
+            if (k > 0) {
+                V1s xkm1 = x.vec().cSubVector((k-1)*bs,k*bs);
+                yk.noAlias() += A.lower(k-1) * xkm1;
+            }
+            if (k < n-1) {
+                V1s xkp1 = x.vec().cSubVector((k+1)*bs,(k+2)*bs);
+                yk.noAlias() += A.upper(k) * xkp1;
+            }
+        }
+    }
+
+
+    //
+    // Block Thomas algorithm
+    //
+
+    template <class T>
+    inline void BlockTridiag_Decompose(BlockTridiagMatrix<T>& A, ptrdiff_t* P)
+    {
+        const ptrdiff_t n = A.nBlocks();
+        const ptrdiff_t bs = A.blockSize();
+        typedef typename BlockTridiagMatrix<T>::block_type B;
+        for(ptrdiff_t k=0; k<n; ++k) {
+            B Dk = A.diag(k);
+            LU_Decompose(Dk,P+k*bs);
+            if (k < n-1) {
+                // C'k = D'k^-1 Ck
+                B Ck = A.upper(k);
+                LU_SolveInPlace(Dk,Permutation(bs,P+k*bs,true),Ck);
+                // D'k+1 = Dk+1 - Lk C'k
+                B Dkp1 = A.diag(k+1);
+                Dkp1.noAlias() -= A.lower(k) * Ck;
+            }
+        }
+    }
+
+    template <class T, class T2>
+    inline void BlockTridiag_SolveInPlace(
+        const BlockTridiagMatrix<T>& A, const ptrdiff_t* P, MatrixView<T2> X)
+    {
+        const ptrdiff_t n = A.nBlocks();
+        const ptrdiff_t bs = A.blockSize();
+        TMVAssert(X.colsize() == A.colsize());
+        // Forward: Yk = D'k^-1 (Bk - Lk-1 Yk-1)
+        for(ptrdiff_t k=0; k<n; ++k) {
+            MatrixView<T2> Xk = X.rowRange(k*bs,(k+1)*bs);
+            if (k > 0)
+                Xk.noAlias() -= A.lower(k-1) * X.rowRange((k-1)*bs,k*bs);
+            LU_SolveInPlace(A.diag(k),Permutation(bs,P+k*bs,true),Xk);
+        }
+        // Backward: Xk = Yk - C'k Xk+1
+        for(ptrdiff_t k=n-2; k>=0; --k) {
+            MatrixView<T2> Xk = X.rowRange(k*bs,(k+1)*bs);
+            Xk.noAlias() -= A.upper(k) * X.rowRange((k+1)*bs,(k+2)*bs);
+        }
+    }
+
+    template <class T, class M2>
+    inline void BlockTridiag_SolveInPlace(
+        const BlockTridiagMatrix<T>& A, const ptrdiff_t* P,
+        BaseMatrix_Rec_Mutable<M2>& X)
+    {
+        typedef typename M2::value_type T2;
+        if (M2::_conj) {
+            Matrix<T2,ColMajor> X1 = X;
+            BlockTridiag_SolveInPlace(A,P,X1);
+            X = X1;
+        } else {
+            BlockTridiag_SolveInPlace(
+                A,P,MatrixView<T2>(X.ptr(),X.colsize(),X.rowsize(),
+                                   X.stepi(),X.stepj()));
+        }
+    }
+
+    template <class T, class V2>
+    inline void BlockTridiag_SolveInPlace(
+        const BlockTridiagMatrix<T>& A, const ptrdiff_t* P,
+        BaseVector_Mutable<V2>& b)
+    {
+        typedef typename V2::value_type T2;
+        TMVAssert(b.size() == A.colsize());
+        Matrix<T2,ColMajor> X(b.size(),1);
+        X.col(0) = b.vec();
+        BlockTridiag_SolveInPlace(A,P,X);
+        b.vec() = X.col(0);
+    }
+
+
+    //
+    // Block cyclic reduction
+    //
+
+    // The system at one level of the reduction: n block rows, each with
+    // blocks L (coupling to row k-1), D, C (coupling to row k+1), and
+    // the right hand side rows B.
+    template <class T, class T2>
+    struct BlockTridiag_CRLevel
+    {
+        ptrdiff_t n, bs, nrhs;
+        Matrix<T,ColMajor> L, D, C;
+        Matrix<T2,ColMajor> B;
+        // For the odd rows: Y = D^-1 ( L C B )
+        Matrix<T2,ColMajor> Y;
+
+        // The levels are made empty and then sized with resize, so
+        // adding one to the list of levels doesn't copy the blocks.
+        BlockTridiag_CRLevel() : n(0), bs(0), nrhs(0) {}
+
+        void resize(ptrdiff_t _n, ptrdiff_t _bs, ptrdiff_t _nrhs)
+        {
+            n = _n; bs = _bs; nrhs = _nrhs;
+            L.resize(bs,n*bs);
+            L.setZero();
+            D.resize(bs,n*bs);
+            C.resize(bs,n*bs);
+            C.setZero();
+            B.resize(n*bs,nrhs);
+            Y.resize(bs,(n/2)*(2*bs+nrhs));
+        }
+
+        MatrixView<T,ColMajor> Lk(ptrdiff_t k)
+        { return L.colRange(k*bs,(k+1)*bs); }
+        MatrixView<T,ColMajor> Dk(ptrdiff_t k)
+        { return D.colRange(k*bs,(k+1)*bs); }
+        MatrixView<T,ColMajor> Ck(ptrdiff_t k)
+        { return C.colRange(k*bs,(k+1)*bs); }
+        MatrixView<T2> Bk(ptrdiff_t k)
+        { return B.rowRange(k*bs,(k+1)*bs); }
+        // For odd k, the parts of Y = D^-1 (L C B).
+        MatrixView<T2,ColMajor> Yk(ptrdiff_t k)
+        {
+            const ptrdiff_t w = 2*bs+nrhs;
+            return Y.colRange((k/2)*w,(k/2+1)*w);
+        }
+    };
+
+    template <class T, class T2>
+    inline void BlockTridiag_CRReduce(
+        BlockTridiag_CRLevel<T,T2>& lev, BlockTridiag_CRLevel<T,T2>& next)
+    {
+        const ptrdiff_t n = lev.n;
+        const ptrdiff_t bs = lev.bs;
+        const ptrdiff_t nrhs = lev.nrhs;
+        const ptrdiff_t nodd = n/2;
+        const ptrdiff_t neven = (n+1)/2;
+        TMVAssert(next.n == neven);
+#ifdef _OPENMP
+        const bool par =
+            n >= 4 && omp_get_level() == 0 && omp_get_max_threads() > 1 &&
+            double(n) * (2*bs+nrhs) >= TMV_BLOCKTRIDIAG_OPENMP_THRESH * bs;
+#endif
+
+        // Y_j = D_j^-1 ( L_j C_j B_j ) for the odd rows j.
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (par)
+#endif
+        for(ptrdiff_t r=0; r<nodd; ++r) {
+            const ptrdiff_t j = 2*r+1;
+            std::vector<ptrdiff_t> P(bs);
+            MatrixView<T,ColMajor> Dj = lev.Dk(j);
+            LU_Decompose(Dj,&P[0]);
+            MatrixView<T2,ColMajor> Yj = lev.Yk(j);
+            Yj.colRange(0,bs) = lev.Lk(j);
+            Yj.colRange(bs,2*bs) = lev.Ck(j);
+            Yj.colRange(2*bs,2*bs+nrhs) = lev.Bk(j);
+            LU_SolveInPlace(Dj,Permutation(bs,&P[0],true),Yj);
+        }
+
+        // The new even rows i = 2r:
+        // D' = D_i - L_i Y_i-1(C) - C_i Y_i+1(L)
+        // L' = -L_i Y_i-1(L)
+        // C' = -C_i Y_i+1(C)
+        // B' = B_i - L_i Y_i-1(B) - C_i Y_i+1(B)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (par)
+#endif
+        for(ptrdiff_t r=0; r<neven; ++r) {
+            const ptrdiff_t i = 2*r;
+            MatrixView<T,ColMajor> Dp = next.Dk(r);
+            MatrixView<T2> Bp = next.Bk(r);
+            Dp = lev.Dk(i);
+            Bp = lev.Bk(i);
+            if (i > 0) {
+                MatrixView<T,ColMajor> Li = lev.Lk(i);
+                MatrixView<T2,ColMajor> Y = lev.Yk(i-1);
+                Dp.noAlias() -= Li * Y.colRange(bs,2*bs);
+                Bp.noAlias() -= Li * Y.colRange(2*bs,2*bs+nrhs);
+                MatrixView<T,ColMajor> Lp = next.Lk(r);
+                Lp.noAlias() = -Li * Y.colRange(0,bs);
+            }
+            if (i < n-1) {
+                MatrixView<T,ColMajor> Ci = lev.Ck(i);
+                MatrixView<T2,ColMajor> Y = lev.Yk(i+1);
+                Dp.noAlias() -= Ci * Y.colRange(0,bs);
+                Bp.noAlias() -= Ci * Y.colRange(2*bs,2*bs+nrhs);
+                if (i < n-2) {
+                    MatrixView<T,ColMajor> Cp = next.Ck(r);
+                    Cp.noAlias() = -Ci * Y.colRange(bs,2*bs);
+                }
+            }
+        }
+    }
+
+    // Given the solution of the even rows in next.B, find the odd ones
+    // and put the full solution in lev.B.
+    template <class T, class T2>
+    inline void BlockTridiag_CRBackSub(
+        BlockTridiag_CRLevel<T,T2>& lev, BlockTridiag_CRLevel<T,T2>& next)
+    {
+        const ptrdiff_t n = lev.n;
+        const ptrdiff_t bs = lev.bs;
+        const ptrdiff_t nrhs = lev.nrhs;
+        const ptrdiff_t nodd = n/2;
+        const ptrdiff_t neven = (n+1)/2;
+#ifdef _OPENMP
+        const bool par =
+            n >= 4 && omp_get_level() == 0 && omp_get_max_threads() > 1 &&
+            double(n) * nrhs >= TMV_BLOCKTRIDIAG_OPENMP_THRESH * bs;
+#endif
+        for(ptrdiff_t r=0; r<neven; ++r) lev.Bk(2*r) = next.Bk(r);
+
+        // x_j = Y_j(B) - Y_j(L) x_j-1 - Y_j(C) x_j+1
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (par)
+#endif
+        for(ptrdiff_t r=0; r<nodd; ++r) {
+            const ptrdiff_t j = 2*r+1;
+            MatrixView<T2,ColMajor> Y = lev.Yk(j);
+            MatrixView<T2> Xj = lev.Bk(j);
+            Xj = Y.colRange(2*bs,2*bs+nrhs);
+            Xj.noAlias() -= Y.colRange(0,bs) * lev.Bk(j-1);
+            if (j < n-1)
+                Xj.noAlias() -= Y.colRange(bs,2*bs) * lev.Bk(j+1);
+        }
+    }
+
+    template <class T, class T2>
+    inline void BlockTridiag_SolveCR(
+        const BlockTridiagMatrix<T>& A, MatrixView<T2> X)
+    {
+        const ptrdiff_t n = A.nBlocks();
+        const ptrdiff_t bs = A.blockSize();
+        const ptrdiff_t nrhs = X.rowsize();
+        TMVAssert(X.colsize() == A.colsize());
+        if (n == 0 || bs == 0 || nrhs == 0) return;
+
+        // The levels are done as T2 for the Y matrices, so if T is real
+        // and T2 is complex, the reduced blocks are complex too.
+        typedef BlockTridiag_CRLevel<T2,T2> Level;
+        // A deque, since push_back doesn't invalidate references to the
+        // levels that are already there.
+        std::deque<Level> levels;
+        levels.push_back(Level());
+        Level& lev0 = levels.front();
+        lev0.resize(n,bs,nrhs);
+        for(ptrdiff_t k=0; k<n; ++k) {
+            lev0.Dk(k) = A.diag(k);
+            if (k > 0) lev0.Lk(k) = A.lower(k-1);
+            if (k < n-1) lev0.Ck(k) = A.upper(k);
+        }
+        lev0.B = X;
+
+        while (levels.back().n > 1) {
+            Level& lev = levels.back();
+            levels.push_back(Level());
+            levels.back().resize((lev.n+1)/2,bs,nrhs);
+            BlockTridiag_CRReduce(lev,levels.back());
+        }
+
+        // The last level has a single block.
+        Level& last = levels.back();
+        std::vector<ptrdiff_t> P(bs);
+        MatrixView<T2,ColMajor> D0 = last.Dk(0);
+        LU_Decompose(D0,&P[0]);
+        MatrixView<T2> B0 = last.Bk(0);
+        LU_SolveInPlace(D0,Permutation(bs,&P[0],true),B0);
+
+        for(ptrdiff_t l=levels.size()-1; l>0; --l)
+            BlockTridiag_CRBackSub(levels[l-1],levels[l]);
+        X = lev0.B;
+    }
+
+    template <class T, class M2>
+    inline void BlockTridiag_SolveCR(
+        const BlockTridiagMatrix<T>& A, BaseMatrix_Rec_Mutable<M2>& X)
+    {
+        typedef typename M2::value_type T2;
+        if (M2::_conj) {
+            Matrix<T2,ColMajor> X1 = X;
+            BlockTridiag_SolveCR(A,X1);
+            X = X1;
+        } else {
+            BlockTridiag_SolveCR(
+                A,MatrixView<T2>(X.ptr(),X.colsize(),X.rowsize(),
+                                 X.stepi(),X.stepj()));
+        }
+    }
+
+    template <class T, class V2>
+    inline void BlockTridiag_SolveCR(
+        const BlockTridiagMatrix<T>& A, BaseVector_Mutable<V2>& b)
+    {
+        typedef typename V2::value_type T2;
+        TMVAssert(b.size() == A.colsize());
+        Matrix<T2,ColMajor> X(b.size(),1);
+        X.col(0) = b.vec();
+        BlockTridiag_SolveCR(A,X);
+        b.vec() = X.col(0);
+    }
+
+} // namespace tmv
+
+#endif
@@ -0,0 +1,520 @@
+//---------------------------------------------------------------------------
+//
+// This file contains the driver code for doing division using
+// Cholesky Decomposition.
+//
+// The Cholesky decomposition is only valid for a hermitian positive
+// definite matrix A (or a real symmetric positive definite matrix).
+// Then A can be decomposed into:
+//
+// A = L L^H
+//
+// where L is lower triangular with a real positive diagonal.
+// This takes half the flops of an LU decomposition, and no pivoting
+// is required for stability.
+//
+// Only the lower triangle of A is used.  So if A is a regular Matrix,
+// it is up to the user to make sure that A is actually hermitian.
+// If A is not positive definite, a NonPosDef error is thrown when
+// the decomposition is done.
+//
+// The determinant of A is just the square of the product of the
+// diagonal elements of L.
+//
+
+
+#ifndef TMV_CHD_H
+#define TMV_CHD_H
+
+#include "TMV_BaseMatrix_Rec.h"
+#include "TMV_Divider.h"
+#include "TMV_Array.h"
+#include "TMV_MultMM_Funcs.h"
+
+#ifdef PRINTALGO_CH
+#include <iostream>
+#endif
+
+namespace tmv {
+
+    // In TMV_CHDecompose.h
+    template <class M>
+    inline void CH_Decompose(BaseMatrix_Rec_Mutable<M>& m);
+
+    // In TMV_CHDiv.h
+    template <class M1, class M2>
+    inline void CH_SolveInPlace(
+        const BaseMatrix_Rec<M1>& m1, BaseMatrix_Rec_Mutable<M2>& m2);
+    template <class M1, class V2>
+    inline void CH_SolveInPlace(
+        const BaseMatrix_Rec<M1>& m1, BaseVector_Mutable<V2>& v2);
+    template <class M1>
+    inline void CH_Inverse(BaseMatrix_Rec_Mutable<M1>& m1);
+
+
+    // The point of the Impl class here is to implement the transfer of
+    // ownership copy semantics.
+    template <class M>
+    struct CHD_Impl;
+
+    template <class M>
+    class CHD
+    {
+    public :
+
+        typedef typename M::value_type T;
+        typedef typename M::real_type RT;
+        typedef typename M::complex_type CT;
+        typedef typename M::float_type FT;
+        typedef typename M::zfloat_type ZFT;
+
+        typedef typename CHD_Impl<M>::llx_type llx_type;
+        typedef const llx_type& getllx_type;
+        typedef typename llx_type::const_lowertri_type getl_type;
+
+        //
+        // Constructors
+        //
+
+        // Sets up the internal storage and does the decomposition.
+        template <class M2>
+        CHD(const BaseMatrix<M2>& A, bool _inplace=false);
+
+        // The copy constructor has transfer of ownership semantics.
+        CHD(const CHD<M>& rhs);
+
+        // Clean up the internal storage
+        ~CHD();
+
+
+        //
+        // Perform the division in place
+        //
+        template <class M2>
+        void solveInPlace(BaseMatrix_Rec_Mutable<M2>& m2) const;
+        template <class V2>
+        void solveInPlace(BaseVector_Mutable<V2>& v2) const;
+
+        // A^T = A* for a hermitian matrix, so A^T x = b is
+        // solved as A x* = b*.
+        template <class M2>
+        void solveTransposeInPlace(BaseMatrix_Rec_Mutable<M2>& m2) const;
+        template <class V2>
+        void solveTransposeInPlace(BaseVector_Mutable<V2>& v2) const;
+
+        //
+        // Next the not-in-place division
+        // For CH, we just copy m1->m3 and do the in-place version.
+        //
+
+        template <class M1, class M2>
+        void solve(
+            const BaseMatrix<M1>& m1, BaseMatrix_Rec_Mutable<M2>& m2) const
+        { solveInPlace(m2=m1); }
+        template <class V1, class V2>
+        void solve(
+            const BaseVector<V1>& v1, BaseVector_Mutable<V2>& v2) const
+        { solveInPlace(v2=v1); }
+
+        template <class M1, class M2>
+        void solveTranspose(
+            const BaseMatrix<M1>& m1, BaseMatrix_Rec_Mutable<M2>& m2) const
+        { solveTransposeInPlace(m2=m1); }
+        template <class V1, class V2>
+        void solveTranspose(
+            const BaseVector<V1>& v1, BaseVector_Mutable<V2>& v2) const
+        { solveTransposeInPlace(v2=v1); }
+
+
+        //
+        // Determinant
+        //
+
+        T det() const;
+        FT logDet(ZFT* sign) const;
+        bool isSingular() const;
+
+
+        //
+        // Inverse
+        //
+
+        template <class M2>
+        void makeInverse(BaseMatrix_Rec_Mutable<M2>& minv) const;
+
+
+        //
+        // InverseATA
+        //
+
+        template <class M2>
+        void makeInverseATA(BaseMatrix_Rec_Mutable<M2>& ata) const;
+
+
+        //
+        // Condition (kappa_inf)
+        //
+
+        RT condition(RT normInf) const;
+
+
+        //
+        // Access Decomposition
+        //
+
+        getl_type getL() const;
+        getllx_type getLLx() const;
+
+        bool preferInPlace() const { return true; }
+
+    private :
+
+        mutable std::auto_ptr<CHD_Impl<M> > pimpl;
+
+        ptrdiff_t size() const;
+
+        // op= not allowed.
+        CHD<M>& operator=(const CHD<M>&);
+    };
+
+    template <class T>
+    class InstCHD :
+        public CHD<Matrix<T,ColMajor> >,
+        public Divider<T>
+    {
+    public :
+        typedef CHD<Matrix<T,ColMajor> > base;
+        typedef typename base::RT RT;
+        typedef typename base::CT CT;
+        typedef typename base::FT FT;
+        typedef typename base::ZFT ZFT;
+
+        // Sets up the internal storage and does the decomposition.
+        template <int C>
+        InstCHD(const ConstMatrixView<T,C>& A, bool _inplace=false);
+        InstCHD(const InstCHD<T>& rhs);
+        ~InstCHD();
+
+        // These are the virtual functions from the Divider base class.
+        void doSolveInPlace(MatrixView<RT> m2) const;
+        void doSolveInPlace(MatrixView<CT> m2) const;
+        void doSolveInPlace(MatrixView<CT,Conj> m2) const;
+        void doSolveInPlace(VectorView<RT> v2) const;
+        void doSolveInPlace(VectorView<CT> v2) const;
+        void doSolveInPlace(VectorView<CT,Conj> v2) const;
+
+        void doSolveTransposeInPlace(MatrixView<RT> m2) const;
+        void doSolveTransposeInPlace(MatrixView<CT> m2) const;
+        void doSolveTransposeInPlace(MatrixView<CT,Conj> m2) const;
+        void doSolveTransposeInPlace(VectorView<RT> v2) const;
+        void doSolveTransposeInPlace(VectorView<CT> v2) const;
+        void doSolveTransposeInPlace(VectorView<CT,Conj> v2) const;
+
+        void doSolve(
+            const ConstMatrixView<RT>& m1, MatrixView<RT> m2) const;
+        void doSolve(
+            const ConstMatrixView<RT>& m1, MatrixView<CT> m2) const;
+        void doSolve(
+            const ConstMatrixView<RT>& m1, MatrixView<CT,Conj> m2) const;
+        void doSolve(
+            const ConstMatrixView<CT>& m1, MatrixView<CT> m2) const;
+        void doSolve(
+            const ConstMatrixView<CT>& m1, MatrixView<CT,Conj> m2) const;
+        void doSolve(
+            const ConstMatrixView<CT,Conj>& m1, MatrixView<CT> m2) const;
+        void doSolve(
+            const ConstMatrixView<CT,Conj>& m1, MatrixView<CT,Conj> m2) const;
+        void doSolve(
+            const ConstVectorView<RT>& v1, VectorView<RT> v2) const;
+        void doSolve(
+            const ConstVectorView<RT>& v1, VectorView<CT> v2) const;
+        void doSolve(
+            const ConstVectorView<RT>& v1, VectorView<CT,Conj> v2) const;
+        void doSolve(
+            const ConstVectorView<CT>& v1, VectorView<CT> v2) const;
+        void doSolve(
+            const ConstVectorView<CT>& v1, VectorView<CT,Conj> v2) const;
+        void doSolve(
+            const ConstVectorView<CT,Conj>& v1, VectorView<CT> v2) const;
+        void doSolve(
+            const ConstVectorView<CT,Conj>& v1, VectorView<CT,Conj> v2) const;
+
+        void doSolveTranspose(
+            const ConstMatrixView<RT>& m1, MatrixView<RT> m2) const;
+        void doSolveTranspose(
+            const ConstMatrixView<RT>& m1, MatrixView<CT> m2) const;
+        void doSolveTranspose(
+            const ConstMatrixView<RT>& m1, MatrixView<CT,Conj> m2) const;
+        void doSolveTranspose(
+            const ConstMatrixView<CT>& m1, MatrixView<CT> m2) const;
+        void doSolveTranspose(
+            const ConstMatrixView<CT>& m1, MatrixView<CT,Conj> m2) const;
+        void doSolveTranspose(
+            const ConstMatrixView<CT,Conj>& m1, MatrixView<CT> m2) const;
+        void doSolveTranspose(
+            const ConstMatrixView<CT,Conj>& m1, MatrixView<CT,Conj> m2) const;
+        void doSolveTranspose(
+            const ConstVectorView<RT>& v1, VectorView<RT> v2) const;
+        void doSolveTranspose(
+            const ConstVectorView<RT>& v1, VectorView<CT> v2) const;
+        void doSolveTranspose(
+            const ConstVectorView<RT>& v1, VectorView<CT,Conj> v2) const;
+        void doSolveTranspose(
+            const ConstVectorView<CT>& v1, VectorView<CT> v2) const;
+        void doSolveTranspose(
+            const ConstVectorView<CT>& v1, VectorView<CT,Conj> v2) const;
+        void doSolveTranspose(
+            const ConstVectorView<CT,Conj>& v1, VectorView<CT> v2) const;
+        void doSolveTranspose(
+            const ConstVectorView<CT,Conj>& v1, VectorView<CT,Conj> v2) const;
+
+        T det() const;
+        FT logDet(ZFT* sign) const;
+        bool isSingular() const;
+
+        void doMakeInverse(MatrixView<RT> minv) const;
+        void doMakeInverse(MatrixView<CT> minv) const;
+        void doMakeInverse(MatrixView<CT,Conj> minv) const;
+
+        void doMakeInverseATA(MatrixView<RT> ata) const;
+        void doMakeInverseATA(MatrixView<CT> ata) const;
+        void doMakeInverseATA(MatrixView<CT,Conj> ata) const;
+
+        RT condition(RT normInf) const;
+        bool preferInPlace() const;
+
+    private :
+        // op= not allowed.
+        InstCHD<T>& operator=(const InstCHD<T>&);
+    };
+
+    // Now the instantiation and definition.
+    template <bool isvalid>
+    struct CHHelper;
+
+    template <>
+    struct CHHelper<true>
+    {
+        template <class M1, class M2>
+        static inline void solveInPlace(const M1& LLx, M2& m2)
+        { CH_SolveInPlace(LLx,m2); }
+        template <class M1, class M2>
+        static inline void solveTransposeInPlace(const M1& LLx, M2& m2)
+        {
+            typename M2::conjugate_type m2c = m2.conjugate();
+            CH_SolveInPlace(LLx,m2c);
+        }
+        template <class M1, class M2>
+        static inline void makeInverse(const M1& LLx, M2& m2)
+        {
+            // As for LU, this might be the same storage if LLx was
+            // done in place, so don't use noAlias() here.
+            m2 = LLx;
+            CH_Inverse(m2);
+        }
+        template <class M1, class M2>
+        static inline void makeInverseATA(const M1& LLx, M2& m2)
+        {
+            // (A^H A)^-1 = A^-1 A^-H = A^-1 A^-1 for hermitian A.
+            typedef typename M1::value_type T;
+            typedef typename M1::real_type RT;
+            Matrix<T,ColMajor|NoDivider> minv = LLx;
+            CH_Inverse(minv);
+            typename M2::noalias_type m2na = m2.noAlias();
+            MultMM<false>(Scaling<1,RT>(),minv,minv,m2na);
+        }
+    };
+    template <>
+    struct CHHelper<false>
+    {
+        template <class M1, class M2>
+        static inline void solveInPlace(const M1& , M2& ) {}
+        template <class M1, class M2>
+        static inline void solveTransposeInPlace(const M1& , M2& ) {}
+        template <class M1, class M2>
+        static inline void makeInverse(const M1& , M2& ) {}
+        template <class M1, class M2>
+        static inline void makeInverseATA(const M1& , M2& ) {}
+    };
+
+    template <class M>
+    struct CHD_Impl
+    {
+        typedef typename M::value_type T;
+        typedef MatrixView<T,ColMajor|NoAlias> llx_type;
+
+        template <class M2>
+        CHD_Impl(const BaseMatrix_Rec<M2>& A, bool _inplace) :
+            // inplace only if matrix is colmajor
+            inplace(A.iscm() && _inplace),
+            Aptr( inplace ? 0 : A.colsize()*A.colsize() ),
+            LLx(
+                inplace ? A.nonConst().ptr() : Aptr.get() ,
+                A.colsize() , A.colsize() , 1 ,
+                inplace ? A.stepj() : A.colsize() )
+        {
+            TMVStaticAssert((Sizes<M2::_colsize,M2::_rowsize>::same));
+            TMVAssert(A.colsize() == A.rowsize());
+            if (!inplace) LLx = A;
+            else Maybe<M2::_conj>::conjself(LLx);
+            CH_Decompose(LLx);
+#ifdef PRINTALGO_CH
+            std::cout<<"CHD_Impl constructor\n";
+            std::cout<<"inplace = "<<inplace<<std::endl;
+            std::cout<<"A = "<<A<<std::endl;
+            std::cout<<"LLx = "<<LLx<<std::endl;
+#endif
+        }
+
+        // If A is not a BaseMatrix_Rec, can't do it in place.
+        template <class M2>
+        CHD_Impl(const BaseMatrix<M2>& A, bool ) :
+            inplace(false),
+            Aptr( A.colsize()*A.colsize() ),
+            LLx(Aptr.get(),A.colsize(),A.colsize(),1,A.colsize())
+        {
+            TMVStaticAssert((Sizes<M2::_colsize,M2::_rowsize>::same));
+            TMVAssert(A.colsize() == A.rowsize());
+            LLx = A;
+            CH_Decompose(LLx);
+        }
+
+        const bool inplace;
+        AlignedArray<T> Aptr;
+        llx_type LLx;
+    };
+
+    template <class M> template <class M2>
+    CHD<M>::CHD(const BaseMatrix<M2>& A, bool inplace) :
+        pimpl(new CHD_Impl<M>(A.mat(),inplace)) {}
+
+    template <class M>
+    CHD<M>::CHD(const CHD<M>& rhs) : pimpl(rhs.pimpl.release()) {}
+
+    template <class M>
+    CHD<M>::~CHD() {}
+
+    template <class M> template <class M2>
+    void CHD<M>::solveInPlace(BaseMatrix_Rec_Mutable<M2>& m2) const
+    {
+        TMVAssert(m2.colsize() == size());
+        const bool isvalid = M::isreal || M2::iscomplex;
+        CHHelper<isvalid>::solveInPlace(pimpl->LLx,m2.mat());
+    }
+
+    template <class M> template <class M2>
+    void CHD<M>::solveTransposeInPlace(BaseMatrix_Rec_Mutable<M2>& m2) const
+    {
+        TMVAssert(m2.colsize() == size());
+        const bool isvalid = M::isreal || M2::iscomplex;
+        CHHelper<isvalid>::solveTransposeInPlace(pimpl->LLx,m2.mat());
+    }
+
+    template <class M> template <class V2>
+    void CHD<M>::solveInPlace(BaseVector_Mutable<V2>& v2) const
+    {
+        TMVAssert(v2.size() == size());
+        const bool isvalid = M::isreal || V2::iscomplex;
+        CHHelper<isvalid>::solveInPlace(pimpl->LLx,v2.vec());
+    }
+
+    template <class M> template <class V2>
+    void CHD<M>::solveTransposeInPlace(BaseVector_Mutable<V2>& v2) const
+    {
+        TMVAssert(v2.size() == size());
+        const bool isvalid = M::isreal || V2::iscomplex;
+        CHHelper<isvalid>::solveTransposeInPlace(pimpl->LLx,v2.vec());
+    }
+
+    template <class M>
+    typename M::value_type CHD<M>::det() const
+    {
+        const T d = getL().det();
+        return TMV_NORM(d);
+    }
+
+    template <class M>
+    typename M::float_type CHD<M>::logDet(typename M::zfloat_type* sign) const
+    {
+        // The diagonal of L is real and positive, so the sign is 1.
+        typename M::float_type ret = getL().logDet(sign);
+        if (sign) *sign = typename M::zfloat_type(1);
+        return typename M::float_type(2) * ret;
+    }
+
+    template <class M>
+    bool CHD<M>::isSingular() const
+    { return getL().isSingular(); }
+
+    template <class M> template <class M2>
+    void CHD<M>::makeInverse(BaseMatrix_Rec_Mutable<M2>& minv) const
+    {
+        TMVAssert(minv.colsize() == size());
+        TMVAssert(minv.rowsize() == size());
+        const bool isvalid = M::isreal || M2::iscomplex;
+        CHHelper<isvalid>::makeInverse(pimpl->LLx,minv.mat());
+    }
+
+    template <class M> template <class M2>
+    void CHD<M>::makeInverseATA(BaseMatrix_Rec_Mutable<M2>& ata) const
+    {
+        TMVAssert(ata.colsize() == size());
+        TMVAssert(ata.rowsize() == size());
+        const bool isvalid = M::isreal || M2::iscomplex;
+        CHHelper<isvalid>::makeInverseATA(pimpl->LLx,ata.mat());
+    }
+
+    template <class M>
+    typename CHD<M>::getl_type CHD<M>::getL() const
+    { return pimpl->LLx.lowerTri(); }
+
+    template <class M>
+    typename CHD<M>::getllx_type CHD<M>::getLLx() const
+    { return pimpl->LLx; }
+
+    template <class M>
+    typename M::real_type CHD<M>::condition(RT normInf) const
+    {
+        // As for LUD, this is the slow O(N^3) version.
+        if (isSingular()) {
+            return normInf / TMV_Epsilon<RT>();
+        } else {
+            Matrix<T> minv(size(),size());
+            makeInverse(minv);
+            return normInf * minv.normInf();
+        }
+    }
+
+    template <class M>
+    ptrdiff_t CHD<M>::size() const
+    { return pimpl->LLx.colsize(); }
+
+
+    template <class M, class M2>
+    static bool CheckDecomp(
+        const CHD<M>& chd, const BaseMatrix_Calc<M2>& m, std::ostream* fout=0)
+    {
+        typedef typename M2::real_type RT;
+        bool printmat = fout;
+        if (printmat) {
+            *fout << "CH:\n";
+            *fout << m << std::endl;
+            *fout << "L = "<<chd.getL()<<std::endl;
+        }
+        typename M::copy_type llt = chd.getL()*chd.getL().adjoint();
+        if (printmat) {
+            *fout << "LLt = "<<llt<<std::endl;
+        }
+        RT nm = Norm(llt-m);
+        nm /= TMV_NORM(Norm(chd.getL()));
+        if (fout) {
+            *fout << "Norm(M-LLt)/Norm(LLt) = "<<nm<<" <? ";
+            *fout << RT(m.colsize())<<"*"<<TMV_Epsilon<RT>();
+            *fout << " = "<<RT(m.colsize())*TMV_Epsilon<RT>()<<std::endl;
+        }
+        return nm < RT(m.colsize())*TMV_Epsilon<RT>();
+    }
+
+} // namespace tmv
+
+#endif
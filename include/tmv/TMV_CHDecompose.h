@@ -0,0 +1,285 @@
+
+#ifndef TMV_CHDecompose_H
+#define TMV_CHDecompose_H
+
+#include "TMV_BaseMatrix_Rec.h"
+#include "TMV_BaseMatrix_Tri.h"
+#include "TMV_MultMV.h"
+#include "TMV_MultMM.h"
+#include "TMV_DivMU.h"
+#include "TMV_SymMatrix.h"
+#include "TMV_RankKMMS.h"
+#include "TMV_AlgoTrace.h"
+
+#ifdef PRINTALGO_CH
+#include <iostream>
+#endif
+
+// RECURSE = the maximum size to stop recursing in algo 21.
+// Below this, the unblocked algo 11 is used.
+#ifndef TMV_CH_RECURSE
+#define TMV_CH_RECURSE 32
+#endif
+
+namespace tmv {
+
+    //
+    // Cholesky decomposition: A = L L^H
+    //
+    // Only the lower triangle of A is referenced, and it is overwritten
+    // by L.  The strict upper triangle is left alone.
+    // If A is not positive definite, a NonPosDef error is thrown.
+    //
+
+    // Defined in TMV_CHDecompose.cpp
+    template <class T>
+    void InstCH_Decompose(MatrixView<T> m);
+
+    template <int algo, ptrdiff_t s, class M>
+    struct CHDecompose_Helper;
+
+    // Record a call in the algorithm trace.  (See TMV_AlgoTrace.h)
+    // The unblocked algorithm for small known sizes isn't traced.
+    template <ptrdiff_t s, class M>
+    class CHDecompose_Trace : public AlgoTrace
+    {
+    public:
+        enum { sz = sizeof(typename M::value_type) };
+        enum { nflops = M::iscomplex ? 8 : 2 };
+
+        CHDecompose_Trace(int algo, const M& m) :
+            AlgoTrace(
+                algo < 21 ? 0 : "CH_Decompose", algo,
+                m.colsize(), m.rowsize(), 0,
+                nflops * double(m.colsize()) * m.colsize() * m.colsize() / 6.,
+                double(sz) * m.colsize() * m.colsize()) {}
+    };
+
+    // algo 0: Trivial, nothing to do (N == 0)
+    template <ptrdiff_t s, class M>
+    struct CHDecompose_Helper<0,s,M>
+    { static TMV_INLINE void call(M& ) {} };
+
+    // algo 11: Unblocked, left-looking algorithm.
+    //
+    // A(j:N,j) = L(j:N,0:j+1) L(j,0:j+1)^H
+    //          = L(j:N,0:j) L(j,0:j)^H + L(j:N,j) L(j,j)
+    //
+    // So the j column is:
+    // v = A(j:N,j) - L(j:N,0:j) L(j,0:j)^H
+    // L(j,j) = sqrt(v(0))
+    // L(j+1:N,j) = v(1:) / L(j,j)
+    template <ptrdiff_t s, class M1>
+    struct CHDecompose_Helper<11,s,M1>
+    {
+        static void call(M1& A)
+        {
+            typedef typename M1::value_type T;
+            typedef typename M1::real_type RT;
+            const ptrdiff_t N = s==Unknown ? A.colsize() : s;
+            const ptrdiff_t xx = Unknown;
+#ifdef PRINTALGO_CH
+            std::cout<<"CHDecompose algo 11: N,s = "<<N<<','<<s<<std::endl;
+#endif
+            typedef typename M1::col_sub_type M1c;
+            typedef typename M1::const_row_sub_type::const_conjugate_type M1r;
+            typedef typename M1::const_submatrix_type M1s;
+
+            for (ptrdiff_t j=0; j<N; ++j) {
+                M1c Ajb = A.get_col(j,j,N);
+                if (j > 0) {
+                    //A.col(j,j,N) -= A.subMatrix(j,N,0,j) *
+                    //    A.row(j,0,j).conjugate();
+                    M1r Lj = A.get_row(j,0,j).conjugate();
+                    MultMV_Helper<-2,xx,xx,true,-1,RT,M1s,M1r,M1c>::call(
+                        Scaling<-1,RT>(),A.cSubMatrix(j,N,0,j),Lj,Ajb);
+                }
+                const RT ajj = TMV_REAL(A.cref(j,j));
+                if (!(ajj > RT(0))) ThrowNonPosDef("CH_Decompose");
+                const RT ljj = TMV_SQRT(ajj);
+                A.ref(j,j) = T(ljj);
+                if (j+1 < N) {
+                    M1c Ajc = A.get_col(j,j+1,N);
+                    Scale(Scaling<0,RT>(RT(1)/ljj),Ajc);
+                }
+            }
+        }
+    };
+
+    // algo 21: Recursive blocked algorithm.
+    //
+    // [ A00  *  ] = [ L00  0  ] [ L00^H L10^H ]
+    // [ A10 A11 ]   [ L10 L11 ] [  0    L11^H ]
+    //
+    // 1) Decompose A00 = L00 L00^H
+    // 2) L10 = A10 L00^-H  (i.e. L10^H = L00^-1 A10^H)
+    // 3) A11 -= L10 L10^H  (only the lower triangle)
+    // 4) Decompose A11 = L11 L11^H
+    //
+    // Most of the work is in step 3, which is a rank-k update, so it
+    // runs at close to the MultMM speed, but only does half the flops.
+    template <ptrdiff_t s, class M1>
+    struct CHDecompose_Helper<21,s,M1>
+    {
+        static void call(M1& A)
+        {
+            typedef typename M1::value_type T;
+            typedef typename M1::real_type RT;
+            const ptrdiff_t N = s==Unknown ? A.colsize() : s;
+            const ptrdiff_t xx = Unknown;
+#ifdef PRINTALGO_CH
+            std::cout<<"CHDecompose algo 21: N,s = "<<N<<','<<s<<std::endl;
+#endif
+            if (N <= TMV_CH_RECURSE) {
+                CHDecompose_Helper<11,s,M1>::call(A);
+                return;
+            }
+            typedef typename M1::submatrix_type M1s;
+            typedef typename M1s::adjoint_type M1sa;
+            typedef typename M1s::const_lowertri_type M1l;
+
+            // (If N > 16, round N/2 up to a multiple of 16.)
+            const ptrdiff_t Nx = N > 16 ? ((((N-1)>>5)+1)<<4) : (N>>1);
+            M1s A00 = A.cSubMatrix(0,Nx,0,Nx);
+            M1s A10 = A.cSubMatrix(Nx,N,0,Nx);
+            M1s A11 = A.cSubMatrix(Nx,N,Nx,N);
+
+            CHDecompose_Helper<21,xx,M1s>::call(A00);
+
+            //A10 %= A00.lowerTri().adjoint();
+            M1sa A10a = A10.adjoint();
+            M1l L00 = A00.lowerTri();
+            LDivEqMU_Helper<-2,xx,xx,M1sa,M1l>::call(A10a,L00);
+
+            //A11.lowerTri() -= A10 * A10.adjoint();
+            HermMatrixView<T> A11h(A11.ptr(),N-Nx,A11.stepi(),A11.stepj());
+            RankKUpdate<true>(Scaling<-1,RT>(),A10,A11h);
+
+            CHDecompose_Helper<21,xx,M1s>::call(A11);
+        }
+    };
+
+    // algo 81: Copy to colmajor
+    template <ptrdiff_t s, class M>
+    struct CHDecompose_Helper<81,s,M>
+    {
+        static void call(M& m)
+        {
+#ifdef PRINTALGO_CH
+            std::cout<<"CHDecompose algo 81: s = "<<s<<std::endl;
+#endif
+            typedef typename M::value_type T;
+            typedef typename MCopyHelper<T,Rec,s,s,ColMajor>::type Mcm;
+            ScratchScope scope;
+            Mcm mcm = m;
+            CHDecompose_Helper<-2,s,Mcm>::call(mcm);
+            m.noAlias() = mcm;
+        }
+    };
+
+    // algo 90: call InstCH_Decompose
+    template <ptrdiff_t s, class M>
+    struct CHDecompose_Helper<90,s,M>
+    {
+        static TMV_INLINE void call(M& m)
+        { InstCH_Decompose(m.xView()); }
+    };
+
+    // algo 97: Conjugate
+    // If A* = L L^H, then A = L* (L*)^H, so we can just decompose A*.
+    template <ptrdiff_t s, class M>
+    struct CHDecompose_Helper<97,s,M>
+    {
+        static TMV_INLINE void call(M& m)
+        {
+            typedef typename M::conjugate_type Mc;
+            Mc mc = m.conjugate();
+            CHDecompose_Helper<-2,s,Mc>::call(mc);
+        }
+    };
+
+    // algo -3: Determine which algorithm to use
+    template <ptrdiff_t s, class M>
+    struct CHDecompose_Helper<-3,s,M>
+    {
+        static TMV_INLINE void call(M& m)
+        {
+            const int algo = (
+                s == 0 ? 0 :
+                ( s != Unknown && s <= TMV_CH_RECURSE ) ? 11 :
+                !M::_colmajor ? 81 :
+                21 );
+#ifdef PRINTALGO_CH
+            std::cout<<"CHDecompose algo -3: N,s = "<<m.colsize()<<
+                ','<<s<<std::endl;
+#endif
+            CHDecompose_Trace<s,M> trace(algo,m);
+            CHDecompose_Helper<algo,s,M>::call(m);
+        }
+    };
+
+    // algo -2: Check for inst
+    template <ptrdiff_t s, class M>
+    struct CHDecompose_Helper<-2,s,M>
+    {
+        static TMV_INLINE void call(M& m)
+        {
+            typedef typename M::value_type T;
+            const bool inst =
+                (s == Unknown || s > 16) &&
+                Traits<T>::isinst;
+            const int algo =
+                s == 0 ? 0 :
+                M::_conj ? 97 :
+                inst ? 90 :
+                -3;
+            CHDecompose_Helper<algo,s,M>::call(m);
+        }
+    };
+
+    template <ptrdiff_t s, class M>
+    struct CHDecompose_Helper<-1,s,M>
+    {
+        static TMV_INLINE void call(M& m)
+        { CHDecompose_Helper<-2,s,M>::call(m); }
+    };
+
+    template <class M>
+    inline void InlineCH_Decompose(BaseMatrix_Rec_Mutable<M>& m)
+    {
+        TMVStaticAssert((Sizes<M::_colsize,M::_rowsize>::same));
+        TMVAssert(m.colsize() == m.rowsize());
+        const ptrdiff_t s = Sizes<M::_colsize,M::_rowsize>::size;
+        typedef typename M::cview_type Mv;
+        TMV_MAYBE_REF(M,Mv) mv = m.cView();
+        CHDecompose_Helper<-3,s,Mv>::call(mv);
+    }
+
+    template <class M>
+    inline void CH_Decompose(BaseMatrix_Rec_Mutable<M>& m)
+    {
+        TMVStaticAssert((Sizes<M::_colsize,M::_rowsize>::same));
+        TMVAssert(m.colsize() == m.rowsize());
+        const ptrdiff_t s = Sizes<M::_colsize,M::_rowsize>::size;
+        typedef typename M::cview_type Mv;
+        TMV_MAYBE_REF(M,Mv) mv = m.cView();
+        CHDecompose_Helper<-2,s,Mv>::call(mv);
+    }
+
+    // Allow views as an argument by value (for convenience)
+    template <class T, int A>
+    TMV_INLINE void CH_Decompose(MatrixView<T,A> m)
+    {
+        typedef MatrixView<T,A> M;
+        CH_Decompose(static_cast<BaseMatrix_Rec_Mutable<M>&>(m));
+    }
+    template <class T, ptrdiff_t M, ptrdiff_t N, ptrdiff_t Si, ptrdiff_t Sj, int A>
+    TMV_INLINE void CH_Decompose(SmallMatrixView<T,M,N,Si,Sj,A> m)
+    {
+        typedef SmallMatrixView<T,M,N,Si,Sj,A> MM;
+        CH_Decompose(static_cast<BaseMatrix_Rec_Mutable<MM>&>(m));
+    }
+
+} // namespace tmv
+
+#endif
@@ -0,0 +1,75 @@
+
+#ifndef TMV_CHDiv_H
+#define TMV_CHDiv_H
+
+#include "TMV_BaseMatrix_Rec.h"
+#include "TMV_BaseMatrix_Tri.h"
+#include "TMV_DivVM_Funcs.h"
+#include "TMV_DivMM_Funcs.h"
+#include "TMV_MultMM_Funcs.h"
+
+namespace tmv {
+
+    //
+    // Solve A x = b given the Cholesky decomposition A = L L^H,
+    // where L is stored in the lower triangle of m1.
+    //
+    // x = L^-H L^-1 b
+    //
+    // Both steps are triangular solves, which use the blocked
+    // TriLDivEq routines.
+    //
+
+    template <class M1, class M2>
+    inline void CH_SolveInPlace(
+        const BaseMatrix_Rec<M1>& m1, BaseMatrix_Rec_Mutable<M2>& m2)
+    {
+        TMVAssert(m1.colsize() == m1.rowsize());
+        TMVAssert(m1.colsize() == m2.colsize());
+        typename M2::noalias_type m2na = m2.noAlias();
+        TriLDivEq(m2na,m1.lowerTri());
+        TriLDivEq(m2na,m1.lowerTri().adjoint());
+    }
+
+    template <class M1, class V2>
+    inline void CH_SolveInPlace(
+        const BaseMatrix_Rec<M1>& m1, BaseVector_Mutable<V2>& v2)
+    {
+        TMVAssert(m1.colsize() == m1.rowsize());
+        TMVAssert(m1.colsize() == v2.size());
+        typename V2::noalias_type v2na = v2.noAlias();
+        TriLDivEq(v2na,m1.lowerTri());
+        TriLDivEq(v2na,m1.lowerTri().adjoint());
+    }
+
+    //
+    // Calculate A^-1 from the Cholesky decomposition in place:
+    //
+    // A^-1 = L^-H L^-1
+    //
+    // First L is inverted in place.  Then we copy L^-H into the
+    // upper triangle, and do the in-place UL product as for LU_Inverse.
+    // (The diagonal of L is real, so L and L^H share the same diagonal.)
+    //
+
+    template <class M1>
+    inline void CH_Inverse(BaseMatrix_Rec_Mutable<M1>& m1)
+    {
+        TMVAssert(m1.colsize() == m1.rowsize());
+        const ptrdiff_t N = m1.colsize();
+        if (N == 0) return;
+        typename M1::lowertri_type L = m1.lowerTri();
+        L.invertSelf();
+        if (N > 1) {
+            typename M1::uppertri_type::offdiag_type Uo =
+                m1.upperTri().offDiag();
+            Uo = L.offDiag().adjoint();
+        }
+        const Scaling<1,typename M1::real_type> one;
+        typename M1::noalias_type m1na = m1.noAlias();
+        MultMM<false>(one,m1.upperTri(),L,m1na);
+    }
+
+} // namespace tmv
+
+#endif
@@ -250,6 +250,195 @@ namespace tmv {
         { Unroller<0,cs,0,rs>::unroll(m1,m2); }
     };
 
+    // The block size for the transposing copy (algos 40-42).
+    // Two blocks of this size need to fit comfortably in L1 cache.
+#ifndef TMV_COPYM_BLOCK
+#define TMV_COPYM_BLOCK 32
+#endif
+
+    // TransposeCopy copies the M x N rowmajor matrix A, whose rows are 
+    // lda apart, into the colmajor matrix B, whose columns are ldb apart.
+    // It is done in TMV_COPYM_BLOCK x TMV_COPYM_BLOCK blocks, so the 
+    // cache lines of A and B that are used for each block stay in cache 
+    // until we have used all of them.
+    // TransposeCopy_Block does each block.  The float and double versions
+    // transpose small tiles in SSE registers.
+    template <class T>
+    static inline void TransposeCopy_Scalar(
+        const ptrdiff_t m, const ptrdiff_t n,
+        const T* A, const ptrdiff_t lda, T* B, const ptrdiff_t ldb)
+    {
+        for(ptrdiff_t j=0;j<n;++j,++A,B+=ldb) {
+            const T* Aj = A;
+            for(ptrdiff_t i=0;i<m;++i,Aj+=lda) B[i] = *Aj;
+        }
+    }
+
+    template <class T>
+    struct TransposeCopy_Block
+    {
+        static TMV_INLINE void call(
+            const ptrdiff_t m, const ptrdiff_t n,
+            const T* A, const ptrdiff_t lda, T* B, const ptrdiff_t ldb)
+        { TransposeCopy_Scalar(m,n,A,lda,B,ldb); }
+    };
+
+#ifdef __SSE__
+    template <>
+    struct TransposeCopy_Block<float>
+    {
+        static inline void call(
+            const ptrdiff_t m, const ptrdiff_t n,
+            const float* A, const ptrdiff_t lda, float* B, const ptrdiff_t ldb)
+        {
+            const ptrdiff_t m4 = m & ~3;
+            const ptrdiff_t n4 = n & ~3;
+            __m128 r0,r1,r2,r3;
+            for(ptrdiff_t j=0;j<n4;j+=4) {
+                const float* Aj = A+j;
+                float* B0 = B+j*ldb;
+                float* B1 = B0+ldb;
+                float* B2 = B1+ldb;
+                float* B3 = B2+ldb;
+                for(ptrdiff_t i=0;i<m4;i+=4) {
+                    const float* Aij = Aj+i*lda;
+                    r0 = _mm_loadu_ps(Aij);
+                    r1 = _mm_loadu_ps(Aij+lda);
+                    r2 = _mm_loadu_ps(Aij+2*lda);
+                    r3 = _mm_loadu_ps(Aij+3*lda);
+                    _MM_TRANSPOSE4_PS(r0,r1,r2,r3);
+                    _mm_storeu_ps(B0+i,r0);
+                    _mm_storeu_ps(B1+i,r1);
+                    _mm_storeu_ps(B2+i,r2);
+                    _mm_storeu_ps(B3+i,r3);
+                }
+            }
+            if (m4 < m) TransposeCopy_Scalar(
+                m-m4,n4,A+m4*lda,lda,B+m4,ldb);
+            if (n4 < n) TransposeCopy_Scalar(
+                m,n-n4,A+n4,lda,B+n4*ldb,ldb);
+        }
+    };
+#endif
+
+#ifdef __SSE2__
+    template <>
+    struct TransposeCopy_Block<double>
+    {
+        static inline void call(
+            const ptrdiff_t m, const ptrdiff_t n,
+            const double* A, const ptrdiff_t lda, double* B, const ptrdiff_t ldb)
+        {
+            const ptrdiff_t m2 = m & ~1;
+            const ptrdiff_t n2 = n & ~1;
+            __m128d r0,r1;
+            for(ptrdiff_t j=0;j<n2;j+=2) {
+                const double* Aj = A+j;
+                double* B0 = B+j*ldb;
+                double* B1 = B0+ldb;
+                for(ptrdiff_t i=0;i<m2;i+=2) {
+                    const double* Aij = Aj+i*lda;
+                    r0 = _mm_loadu_pd(Aij);
+                    r1 = _mm_loadu_pd(Aij+lda);
+                    _mm_storeu_pd(B0+i,_mm_unpacklo_pd(r0,r1));
+                    _mm_storeu_pd(B1+i,_mm_unpackhi_pd(r0,r1));
+                }
+            }
+            if (m2 < m) TransposeCopy_Scalar(
+                m-m2,n2,A+m2*lda,lda,B+m2,ldb);
+            if (n2 < n) TransposeCopy_Scalar(
+                m,n-n2,A+n2,lda,B+n2*ldb,ldb);
+        }
+    };
+#endif
+
+    template <class T>
+    static void TransposeCopy(
+        const ptrdiff_t M, const ptrdiff_t N,
+        const T* A, const ptrdiff_t lda, T* B, const ptrdiff_t ldb)
+    {
+        const ptrdiff_t nb = TMV_COPYM_BLOCK;
+        for(ptrdiff_t j1=0;j1<N;j1+=nb) {
+            const ptrdiff_t n = TMV_MIN(nb,N-j1);
+            for(ptrdiff_t i1=0;i1<M;i1+=nb) {
+                const ptrdiff_t m = TMV_MIN(nb,M-i1);
+                TransposeCopy_Block<T>::call(
+                    m,n,A+i1*lda+j1,lda,B+i1+j1*ldb,ldb);
+            }
+        }
+    }
+
+    // algo 40: Opposite storage, determine which algorithm to use
+    template <ptrdiff_t cs, ptrdiff_t rs, class M1, class M2>
+    struct CopyM_Helper<40,cs,rs,M1,M2>
+    {
+        static TMV_INLINE void call(const M1& m1, M2& m2)
+        {
+            typedef typename M1::value_type T1;
+            typedef typename M2::value_type T2;
+            const bool sse = Traits2<T1,T2>::sametype && (
+#ifdef __SSE__
+                Traits2<T1,float>::sametype ||
+#endif
+#ifdef __SSE2__
+                Traits2<T1,double>::sametype ||
+#endif
+                false );
+            const int algo = sse ? 42 : 41;
+            CopyM_Helper<algo,cs,rs,M1,M2>::call(m1,m2);
+        }
+    };
+
+    // algo 41: Opposite storage: copy in blocks
+    // One of m1 and m2 is rowmajor and the other is colmajor, so whichever
+    // way we loop, one of them is accessed with a large stride.  Copying
+    // one TMV_COPYM_BLOCK x TMV_COPYM_BLOCK block at a time means each 
+    // cache line of the strided one is fully used while it is in cache.
+    template <ptrdiff_t cs, ptrdiff_t rs, class M1, class M2>
+    struct CopyM_Helper<41,cs,rs,M1,M2>
+    {
+        static void call(const M1& m1, M2& m2)
+        {
+            const ptrdiff_t M = cs == Unknown ? m2.colsize() : cs;
+            const ptrdiff_t N = rs == Unknown ? m2.rowsize() : rs;
+            typedef typename M1::const_submatrix_type M1s;
+            typedef typename M2::submatrix_type M2s;
+            const ptrdiff_t nb = TMV_COPYM_BLOCK;
+            const bool cm2 = m2.iscm();
+            for(ptrdiff_t j1=0;j1<N;j1+=nb) {
+                const ptrdiff_t j2 = TMV_MIN(j1+nb,N);
+                for(ptrdiff_t i1=0;i1<M;i1+=nb) {
+                    const ptrdiff_t i2 = TMV_MIN(i1+nb,M);
+                    M1s m1s = m1.cSubMatrix(i1,i2,j1,j2);
+                    M2s m2s = m2.cSubMatrix(i1,i2,j1,j2);
+                    if (cm2)
+                        CopyM_Helper<11,Unknown,Unknown,M1s,M2s>::call(m1s,m2s);
+                    else
+                        CopyM_Helper<21,Unknown,Unknown,M1s,M2s>::call(m1s,m2s);
+                }
+            }
+        }
+    };
+
+    // algo 42: Opposite storage, float or double: use TransposeCopy
+    template <ptrdiff_t cs, ptrdiff_t rs, class M1, class M2>
+    struct CopyM_Helper<42,cs,rs,M1,M2>
+    {
+        static void call(const M1& m1, M2& m2)
+        {
+            const ptrdiff_t M = cs == Unknown ? m2.colsize() : cs;
+            const ptrdiff_t N = rs == Unknown ? m2.rowsize() : rs;
+            if (m2.iscm()) {
+                TMVAssert(m1.isrm());
+                TransposeCopy(M,N,m1.cptr(),m1.stepi(),m2.ptr(),m2.stepj());
+            } else {
+                // m1.transpose() is rowmajor and m2.transpose() is colmajor.
+                TMVAssert(m1.iscm() && m2.isrm());
+                TransposeCopy(N,M,m1.cptr(),m1.stepj(),m2.ptr(),m2.stepi());
+            }
+        }
+    };
+
     // algo 31: Unknown sizes, determine which algorithm to use
     template <ptrdiff_t cs, ptrdiff_t rs, class M1, class M2>
     struct CopyM_Helper<31,cs,rs,M1,M2>
@@ -259,6 +448,10 @@ namespace tmv {
             if (m1.canLinearize() && m2.canLinearize() &&
                 m1.stepi() == m2.stepi() && m1.stepj() == m2.stepj()) 
                 CopyM_Helper<1,cs,rs,M1,M2>::call(m1,m2);
+            else if (m1.colsize() > TMV_COPYM_BLOCK && 
+                     m1.rowsize() > TMV_COPYM_BLOCK &&
+                     ( (m1.isrm() && m2.iscm()) || (m1.iscm() && m2.isrm()) ))
+                CopyM_Helper<40,cs,rs,M1,M2>::call(m1,m2);
             else if ((m1.isrm() && m2.isrm()) || 
                      ( !(m1.iscm() && m2.iscm()) &&
                        (m1.colsize() > m1.rowsize()) ) )
@@ -380,12 +573,17 @@ namespace tmv {
             const bool allcm = M1::_colmajor && M2::_colmajor;
             const bool canlin = 
                 M1::_canlin && M2::_canlin && (allrm || allcm);
+            const bool opposite = 
+                (M1::_rowmajor && M2::_colmajor) ||
+                (M1::_colmajor && M2::_rowmajor);
             const int algo = 
                 (cs == 0 || rs == 0) ? 0 :
                 canlin ? 1 :
                 rs == 1 ? 2 : 
                 cs == 1 ? 3 :
                 TMV_OPT == 0 ? (allrm ? 21 : 11) :
+                ( opposite && cs != Unknown && rs != Unknown &&
+                  cs > TMV_COPYM_BLOCK && rs > TMV_COPYM_BLOCK ) ? 40 :
                 ( cs != Unknown && rs != Unknown ) ? (
                     ( IntTraits2<cs,rs>::prod <= int(128/sizeof(T2)) ) ? (
                         ( M1::_rowmajor && M2::_rowmajor ) ? 25 : 15 ) :
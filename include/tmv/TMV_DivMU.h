@@ -14,6 +14,7 @@
 
 #ifdef _OPENMP
 #include "omp.h"
+#include <vector>
 #ifdef PRINTALGO_DivU_OMP
 #include <fstream>
 #endif
@@ -77,9 +78,16 @@
 #endif
 
 // The minimum value of (M^2*N / 16^3) to use multiple threads.
-// (We also require that N > 64 so we have something to split.)
+// (We also require that N >= 64, so a solve with only a few right hand
+// sides doesn't start a parallel region.)
 #define TMV_DIVMU_OMP_THRESH 64
 
+// The size of the row blocks and column tiles for the task parallel
+// algorithm (algo 37).
+#ifndef TMV_DIVMU_OMP_TILE
+#define TMV_DIVMU_OMP_TILE 128
+#endif
+
 
 namespace tmv {
 
@@ -854,7 +862,7 @@ namespace tmv {
                 LDivEqMU_Helper<algo2,cs,rs,M1,M2>::call(m1,m2);
 #ifdef _OPENMP
             else if (N >= 64 && Mc*Mc*Nc > TMV_DIVMU_OMP_THRESH)
-                LDivEqMU_Helper<36,cs,rs,M1,M2>::call(m1,m2);
+                LDivEqMU_Helper<37,cs,rs,M1,M2>::call(m1,m2);
 #endif
             else
                 LDivEqMU_Helper<algo3,cs,rs,M1,M2>::call(m1,m2);
@@ -871,6 +879,9 @@ namespace tmv {
     // that is a multiple of 16.  This way we get the maximum advantage from
     // our blocking structure while keeping the threads as balanced as 
     // possible.
+    // This isn't selected automatically any more, since algo 37 balances
+    // the work better, but it is kept so speed/TMV_Speed_TriDiv.cpp can
+    // compare the two.
     template <ptrdiff_t cs, ptrdiff_t rs, class M1, class M2>
     struct LDivEqMU_Helper<36,cs,rs,M1,M2>
     {
@@ -948,6 +959,121 @@ namespace tmv {
     };
 #endif
 
+#ifdef _OPENMP
+    // algo 37: Split problem into tiles and do them as OpenMP tasks.
+    // The rows are split into blocks of TMV_DIVMU_OMP_TILE, and the 
+    // columns of m1 into tiles of the same width.  Each column tile is 
+    // independent of the others, and within a column tile, the block
+    // back substitution (for UpperTri):
+    //   X_k /= U_kk
+    //   X_i -= U_ik X_k   for i < k
+    // only requires each update to wait for the X_k that it uses.
+    // So the updates for the different i run in parallel, and the next
+    // diagonal block can start as soon as its own updates are done,
+    // rather than waiting for the whole MultMM step of algo 17.
+    // (LowerTri is the same, going forward.)
+    // Task dependencies need OpenMP 4.0.  For earlier versions, only the 
+    // column tiles are done in parallel.
+    template <ptrdiff_t cs, ptrdiff_t rs, class M1, class M2>
+    struct LDivEqMU_Helper<37,cs,rs,M1,M2>
+    {
+        static void call(M1& m1, const M2& m2)
+        {
+#ifdef PRINTALGO_DivU
+            const ptrdiff_t M = cs==Unknown ? m1.colsize() : cs;
+            const ptrdiff_t N = rs==Unknown ? m1.rowsize() : rs;
+            std::cout<<"LDivEqMU algo 37: M,N,cs,rs = "<<M<<','<<N<<
+                ','<<cs<<','<<rs<<std::endl;
+#endif
+            const bool upper = M2::_upper;
+            const int algo2 = upper ? 17 : 27;
+            // As in MultMM, check omp_get_level() rather than 
+            // omp_in_parallel(), so we don't start a new parallel region
+            // if the user has called this from within an inactive one.
+            if (omp_get_level() > 0 || omp_get_max_threads() == 1) {
+                LDivEqMU_Helper<algo2,cs,rs,M1,M2>::call(m1,m2);
+                return;
+            }
+#pragma omp parallel
+            {
+#pragma omp single
+                {
+                    tasks(m1,m2);
+                }
+            }
+        }
+
+        static void tasks(M1& m1, const M2& m2)
+        {
+            const ptrdiff_t M = cs==Unknown ? m1.colsize() : cs;
+            const ptrdiff_t N = rs==Unknown ? m1.rowsize() : rs;
+            const bool upper = M2::_upper;
+            const int algo2 = upper ? 17 : 27;
+            const ptrdiff_t xx = Unknown;
+            const ptrdiff_t nb = TMV_DIVMU_OMP_TILE;
+            const ptrdiff_t nc = (N-1)/nb + 1;
+
+#if _OPENMP >= 201307
+            typedef typename M2::real_type RT;
+            typedef typename M2::const_subtrimatrix_type M2a;
+            typedef typename M2::const_submatrix_type M2b;
+            typedef typename M1::submatrix_type M1s;
+            typedef typename M1::const_submatrix_type M1sc;
+            const Scaling<-1,RT> mone;
+
+            // One dependency flag for each tile of m1.
+            const ptrdiff_t nr = (M-1)/nb + 1;
+            std::vector<char> flags(nr*nc);
+            char* dep = &flags[0];
+
+            for(ptrdiff_t kk=0;kk<nr;++kk) {
+                const ptrdiff_t k = upper ? nr-1-kk : kk;
+                const ptrdiff_t k1 = k*nb;
+                const ptrdiff_t k2 = TMV_MIN(M,k1+nb);
+                for(ptrdiff_t c=0;c<nc;++c) {
+                    const ptrdiff_t j1 = c*nb;
+                    const ptrdiff_t j2 = TMV_MIN(N,j1+nb);
+#pragma omp task default(shared) firstprivate(k1,k2,j1,j2) \
+                    depend(inout: dep[k*nc+c])
+                    {
+                        M1s Xk = m1.cSubMatrix(k1,k2,j1,j2);
+                        M2a Ukk = m2.cSubTriMatrix(k1,k2);
+                        LDivEqMU_Helper<algo2,xx,xx,M1s,M2a>::call(Xk,Ukk);
+                    }
+                    const ptrdiff_t i1 = upper ? 0 : k+1;
+                    const ptrdiff_t i2 = upper ? k : nr;
+                    for(ptrdiff_t i=i1;i<i2;++i) {
+                        const ptrdiff_t ii1 = i*nb;
+                        const ptrdiff_t ii2 = TMV_MIN(M,ii1+nb);
+#pragma omp task default(shared) firstprivate(k1,k2,j1,j2,ii1,ii2) \
+                        depend(in: dep[k*nc+c]) depend(inout: dep[i*nc+c])
+                        {
+                            M1s Xi = m1.cSubMatrix(ii1,ii2,j1,j2);
+                            M1sc Xk = m1.cSubMatrix(k1,k2,j1,j2);
+                            M2b Uik = m2.cSubMatrix(ii1,ii2,k1,k2);
+                            MultMM_Helper<-2,xx,xx,xx,true,-1,RT,M2b,M1sc,M1s>::
+                                call(mone,Uik,Xk,Xi);
+                        }
+                    }
+                }
+            }
+#else
+            typedef typename M1::colrange_type M1c;
+            for(ptrdiff_t c=0;c<nc;++c) {
+                const ptrdiff_t j1 = c*nb;
+                const ptrdiff_t j2 = TMV_MIN(N,j1+nb);
+#pragma omp task default(shared) firstprivate(j1,j2)
+                {
+                    M1c m1c = m1.cColRange(j1,j2);
+                    LDivEqMU_Helper<algo2,cs,xx,M1c,M2>::call(m1c,m2);
+                }
+            }
+#endif
+#pragma omp taskwait
+        }
+    };
+#endif
+
     // algo 38: Unknown cs, check if M is small
     template <ptrdiff_t cs, ptrdiff_t rs, class M1, class M2>
     struct LDivEqMU_Helper<38,cs,rs,M1,M2>
@@ -997,6 +1123,7 @@ namespace tmv {
             std::cout<<"LDivEqMU algo 81: M,N,cs,rs = "<<M<<','<<N<<
                 ','<<cs<<','<<rs<<std::endl;
 #endif
+            ScratchScope scope;
             typename M1::noalias_type m1na = m1.noAlias();
             TriLDivEq(m1na,m2.copy());
         }
@@ -1018,6 +1145,7 @@ namespace tmv {
             // I think rowmajor is usually better, since it only inverts
             // the diagonal elements of m2 once each.
             typedef typename MCopyHelper<T1,Rec,cs,rs,RowMajor>::type M1c;
+            ScratchScope scope;
             M1c m1c = m1;
             TriLDivEq(m1c,m2);
             m1.noAlias() = m1c;
@@ -1165,7 +1293,8 @@ namespace tmv {
             // 
             // Overall drivers:
             // 31 = Choose algorithm based on the (runtime) size
-            // 36 = Parallelize using openmp 
+            // 36 = Parallelize using openmp (only called explicitly)
+            // 37 = Parallelize using openmp tasks on tiles
             // 38 = Check if M is small
 
             const bool upper = M2::_upper;
@@ -1191,7 +1320,7 @@ namespace tmv {
                 cs <= 3 && (rs == Unknown || rs > 3) ? 16 :
                 rs == Unknown ? 31 :
 #ifdef _OPENMP
-                (rs >= 64 && McMcNc >= TMV_DIVMU_OMP_THRESH) ? 36 :
+                (rs >= 64 && McMcNc >= TMV_DIVMU_OMP_THRESH) ? 37 :
 #endif
                 17  :
 
@@ -1204,7 +1333,7 @@ namespace tmv {
                 cs <= 3 && (rs == Unknown || rs > 3) ? 26 :
                 rs == Unknown ? 31 :
 #ifdef _OPENMP
-                (rs >= 64 && McMcNc >= TMV_DIVMU_OMP_THRESH) ? 36 :
+                (rs >= 64 && McMcNc >= TMV_DIVMU_OMP_THRESH) ? 37 :
 #endif
                 27 ;
 #ifdef PRINTALGO_DivU
@@ -0,0 +1,446 @@
+
+
+#ifndef TMV_EigenDecompose_H
+#define TMV_EigenDecompose_H
+
+#include "TMV_BaseMatrix_Rec.h"
+#include "TMV_BaseMatrix_Sym.h"
+#include "TMV_EigenDecompose_Tridiag.h"
+#include "TMV_EigenDecompose_DC.h"
+#include "TMV_PackedQ.h"
+
+#ifdef PRINTALGO_EIGEN
+#include <iostream>
+#endif
+
+namespace tmv {
+
+    //
+    // Eigen_Decompose: A = Z diag(lambda) Z^H
+    //
+    // A is hermitian (or real symmetric), and only its lower triangle
+    // is referenced.  On output, A is overwritten by the (unitary)
+    // matrix of eigenvectors, Z, and lambda holds the eigenvalues
+    // in increasing order.
+    //
+    // Eigen_Values(A,lambda) finds just the eigenvalues.
+    // A is overwritten by the Householder vectors of the
+    // tridiagonalization.
+    //
+    // Eigen_DecomposeLargest(A,Z,lambda) finds the k = lambda.size()
+    // largest eigenvalues (in decreasing order), and their eigenvectors
+    // in the columns of Z, which is N x k.
+    // A is overwritten by the Householder vectors of the
+    // tridiagonalization.
+    //
+    // All of these first reduce A to a real symmetric tridiagonal
+    // matrix with the blocked Tridiagonalize routine.
+    // For complex A, the sub-diagonal E is made real by a diagonal
+    // unitary transformation:
+    // T = Phi Tr Phi^H, with phi_0 = 1, phi_j+1 = phi_j E_j / |E_j|.
+    // Then the full decomposition uses the divide and conquer
+    // algorithm on Tr, the values alone use the QL algorithm, and
+    // the k largest use bisection and inverse iteration.
+    //
+
+    // Defined in TMV_EigenDecompose.cpp
+    template <class T, class RT>
+    void InstEigen_Decompose(
+        MatrixView<T> A, VectorView<RT> lambda, bool StoreZ);
+    template <class T, class RT>
+    void InstEigen_DecomposeLargest(
+        MatrixView<T> A, MatrixView<T> Z, VectorView<RT> lambda);
+
+    // Tridiagonalize A and make the sub-diagonal real.
+    // On output, D,Er are the real tridiagonal matrix, and
+    // phase holds the diagonal of Phi.
+    template <class M1, class T, class RT>
+    inline void Eigen_ReduceToTridiagonal(
+        M1& A, Vector<RT>& beta, Vector<RT>& D, Vector<RT>& Er,
+        Vector<T>& phase)
+    {
+        const ptrdiff_t N = A.colsize();
+        Vector<T> E(N-1);
+        Tridiagonalize(A,beta,D,E);
+        phase(0) = T(1);
+        for(ptrdiff_t j=0;j<N-1;++j) {
+            const RT ae = TMV_ABS(E(j));
+            Er(j) = ae;
+            phase(j+1) = ae == RT(0) ? phase(j) : phase(j) * (E(j) / ae);
+        }
+    }
+
+    template <int algo, ptrdiff_t s, class M1, class V1>
+    struct EigenDecompose_Helper;
+
+    // algo 0: Trivial, nothing to do (N == 0)
+    template <ptrdiff_t s, class M1, class V1>
+    struct EigenDecompose_Helper<0,s,M1,V1>
+    { static TMV_INLINE void call(M1& , V1& , bool ) {} };
+
+    // algo 11: Tridiagonalize, then divide and conquer (or QL for values).
+    template <ptrdiff_t s, class M1, class V1>
+    struct EigenDecompose_Helper<11,s,M1,V1>
+    {
+        static void call(M1& A, V1& lambda, bool StoreZ)
+        {
+            typedef typename M1::value_type T;
+            typedef typename M1::real_type RT;
+            const ptrdiff_t N = s==Unknown ? A.colsize() : s;
+#ifdef PRINTALGO_EIGEN
+            std::cout<<"EigenDecompose algo 11: N,s = "<<N<<','<<s<<std::endl;
+#endif
+            if (N == 1) {
+                lambda.ref(0) = TMV_REAL(A.cref(0,0));
+                if (StoreZ) A.ref(0,0) = T(1);
+                return;
+            }
+
+            Vector<RT> beta(N-1);
+            Vector<RT> D(N);
+            Vector<RT> Er(N-1);
+            Vector<T> phase(N);
+            Eigen_ReduceToTridiagonal(A,beta,D,Er,phase);
+
+            if (!StoreZ) {
+                Eigen_DecomposeFromTridiagonal_QL(
+                    MatrixView<RT,ColMajor>(0,0,0,1,1),D.view(),Er.view());
+                lambda = D;
+                lambda.sort(Ascend);
+                return;
+            }
+
+            Matrix<RT,ColMajor|NoDivider> Zr(N,N);
+            Eigen_DecomposeFromTridiagonal_DC(Zr.view(),D.view(),Er.view());
+            lambda = D;
+
+            // Z = Q Phi Zr
+            // Q is [ 1 0 ; 0 Q1 ], where Q1 is stored in packed form
+            // in A(1:N,0:N-1).  Copy it out, since A gets Z.
+            Matrix<T,ColMajor|NoDivider> Q1 = A.subMatrix(1,N,0,N-1);
+            for(ptrdiff_t i=0;i<N;++i) A.row(i) = phase(i) * Zr.row(i);
+            typename M1::rowrange_type A1 = A.rowRange(1,N);
+            PackedQ_MultEq(Q1,beta,A1);
+        }
+    };
+
+    // algo 90: call InstEigen_Decompose
+    template <ptrdiff_t s, class M1, class V1>
+    struct EigenDecompose_Helper<90,s,M1,V1>
+    {
+        static TMV_INLINE void call(M1& A, V1& lambda, bool StoreZ)
+        { InstEigen_Decompose(A.xView(),lambda.xView(),StoreZ); }
+    };
+
+    // algo 97: Conjugate
+    // If A* = Z L Z^H, then A = Z* L (Z*)^H, and Z* is what
+    // ends up in A.
+    template <ptrdiff_t s, class M1, class V1>
+    struct EigenDecompose_Helper<97,s,M1,V1>
+    {
+        static TMV_INLINE void call(M1& A, V1& lambda, bool StoreZ)
+        {
+            typedef typename M1::conjugate_type M1c;
+            M1c Ac = A.conjugate();
+            EigenDecompose_Helper<-2,s,M1c,V1>::call(Ac,lambda,StoreZ);
+        }
+    };
+
+    // algo -3: Determine which algorithm to use
+    template <ptrdiff_t s, class M1, class V1>
+    struct EigenDecompose_Helper<-3,s,M1,V1>
+    {
+        static TMV_INLINE void call(M1& A, V1& lambda, bool StoreZ)
+        {
+            const int algo = s == 0 ? 0 : 11;
+            EigenDecompose_Helper<algo,s,M1,V1>::call(A,lambda,StoreZ);
+        }
+    };
+
+    // algo -2: Check for inst
+    template <ptrdiff_t s, class M1, class V1>
+    struct EigenDecompose_Helper<-2,s,M1,V1>
+    {
+        static TMV_INLINE void call(M1& A, V1& lambda, bool StoreZ)
+        {
+            typedef typename M1::value_type T;
+            const bool inst =
+                (s == Unknown || s > 16) &&
+                Traits<T>::isinst;
+            const int algo =
+                s == 0 ? 0 :
+                M1::_conj ? 97 :
+                inst ? 90 :
+                -3;
+            EigenDecompose_Helper<algo,s,M1,V1>::call(A,lambda,StoreZ);
+        }
+    };
+
+    template <ptrdiff_t s, class M1, class V1>
+    struct EigenDecompose_Helper<-1,s,M1,V1>
+    {
+        static TMV_INLINE void call(M1& A, V1& lambda, bool StoreZ)
+        { EigenDecompose_Helper<-2,s,M1,V1>::call(A,lambda,StoreZ); }
+    };
+
+    template <class M1, class V1>
+    inline void InlineEigen_Decompose(
+        BaseMatrix_Rec_Mutable<M1>& A, BaseVector_Mutable<V1>& lambda,
+        bool StoreZ)
+    {
+        TMVStaticAssert(Traits<typename V1::value_type>::isreal);
+        TMVStaticAssert((Traits2<
+                         typename M1::value_type,
+                         typename V1::value_type>::samebase));
+        TMVStaticAssert((Sizes<M1::_colsize,M1::_rowsize>::same));
+        TMVStaticAssert((Sizes<M1::_rowsize,V1::_size>::same));
+        TMVAssert(A.colsize() == A.rowsize());
+        TMVAssert(A.rowsize() == lambda.size());
+        const ptrdiff_t s1 = Sizes<M1::_colsize,M1::_rowsize>::size;
+        const ptrdiff_t s = Sizes<s1,V1::_size>::size;
+        typedef typename M1::cview_type M1v;
+        typedef typename V1::cview_type V1v;
+        TMV_MAYBE_REF(M1,M1v) Av = A.cView();
+        TMV_MAYBE_REF(V1,V1v) lv = lambda.cView();
+        EigenDecompose_Helper<-3,s,M1v,V1v>::call(Av,lv,StoreZ);
+    }
+
+    template <class M1, class V1>
+    inline void Eigen_Decompose(
+        BaseMatrix_Rec_Mutable<M1>& A, BaseVector_Mutable<V1>& lambda)
+    {
+        TMVStaticAssert(Traits<typename V1::value_type>::isreal);
+        TMVStaticAssert((Traits2<
+                         typename M1::value_type,
+                         typename V1::value_type>::samebase));
+        TMVStaticAssert((Sizes<M1::_colsize,M1::_rowsize>::same));
+        TMVStaticAssert((Sizes<M1::_rowsize,V1::_size>::same));
+        TMVAssert(A.colsize() == A.rowsize());
+        TMVAssert(A.rowsize() == lambda.size());
+        const ptrdiff_t s1 = Sizes<M1::_colsize,M1::_rowsize>::size;
+        const ptrdiff_t s = Sizes<s1,V1::_size>::size;
+        typedef typename M1::cview_type M1v;
+        typedef typename V1::cview_type V1v;
+        TMV_MAYBE_REF(M1,M1v) Av = A.cView();
+        TMV_MAYBE_REF(V1,V1v) lv = lambda.cView();
+        EigenDecompose_Helper<-2,s,M1v,V1v>::call(Av,lv,true);
+    }
+
+    template <class M1, class V1>
+    inline void Eigen_Values(
+        BaseMatrix_Rec_Mutable<M1>& A, BaseVector_Mutable<V1>& lambda)
+    {
+        TMVStaticAssert(Traits<typename V1::value_type>::isreal);
+        TMVStaticAssert((Traits2<
+                         typename M1::value_type,
+                         typename V1::value_type>::samebase));
+        TMVStaticAssert((Sizes<M1::_colsize,M1::_rowsize>::same));
+        TMVStaticAssert((Sizes<M1::_rowsize,V1::_size>::same));
+        TMVAssert(A.colsize() == A.rowsize());
+        TMVAssert(A.rowsize() == lambda.size());
+        const ptrdiff_t s1 = Sizes<M1::_colsize,M1::_rowsize>::size;
+        const ptrdiff_t s = Sizes<s1,V1::_size>::size;
+        typedef typename M1::cview_type M1v;
+        typedef typename V1::cview_type V1v;
+        TMV_MAYBE_REF(M1,M1v) Av = A.cView();
+        TMV_MAYBE_REF(V1,V1v) lv = lambda.cView();
+        EigenDecompose_Helper<-2,s,M1v,V1v>::call(Av,lv,false);
+    }
+
+    // Start from a SymMatrix or HermMatrix: Copy it into Z,
+    // and decompose that.
+    template <class M1, class M2, class V1>
+    inline void Eigen_Decompose(
+        const BaseMatrix_Sym<M1>& A, BaseMatrix_Rec_Mutable<M2>& Z,
+        BaseVector_Mutable<V1>& lambda)
+    {
+        TMVAssert(A.size() == Z.colsize());
+        Z = A;
+        Eigen_Decompose(Z,lambda);
+    }
+
+    template <int algo, ptrdiff_t s, class M1, class M2, class V1>
+    struct EigenDecomposeLargest_Helper;
+
+    // algo 0: Trivial, nothing to do (N == 0 or k == 0)
+    template <ptrdiff_t s, class M1, class M2, class V1>
+    struct EigenDecomposeLargest_Helper<0,s,M1,M2,V1>
+    { static TMV_INLINE void call(M1& , M2& , V1& ) {} };
+
+    // algo 11: Tridiagonalize, then bisection and inverse iteration.
+    template <ptrdiff_t s, class M1, class M2, class V1>
+    struct EigenDecomposeLargest_Helper<11,s,M1,M2,V1>
+    {
+        static void call(M1& A, M2& Z, V1& lambda)
+        {
+            typedef typename M1::value_type T;
+            typedef typename M1::real_type RT;
+            const ptrdiff_t N = s==Unknown ? A.colsize() : s;
+            const ptrdiff_t k = lambda.size();
+#ifdef PRINTALGO_EIGEN
+            std::cout<<"EigenDecomposeLargest algo 11: N,k = "<<
+                N<<','<<k<<std::endl;
+#endif
+            if (k == 0) return;
+            if (N == 1) {
+                lambda.ref(0) = TMV_REAL(A.cref(0,0));
+                Z.ref(0,0) = T(1);
+                return;
+            }
+
+            Vector<RT> beta(N-1);
+            Vector<RT> D(N);
+            Vector<RT> Er(N-1);
+            Vector<T> phase(N);
+            Eigen_ReduceToTridiagonal(A,beta,D,Er,phase);
+
+            Vector<RT> lam(k);
+            Matrix<RT,ColMajor|NoDivider> Zr(N,k);
+            Eigen_LargestFromTridiagonal(
+                Zr.view(),D.view(),Er.view(),lam.view());
+            lambda = lam;
+
+            // Z = Q Phi Zr
+            for(ptrdiff_t i=0;i<N;++i) Z.row(i) = phase(i) * Zr.row(i);
+            typename M2::rowrange_type Z1 = Z.rowRange(1,N);
+            PackedQ_MultEq(A.subMatrix(1,N,0,N-1),beta,Z1);
+        }
+    };
+
+    // algo 90: call InstEigen_DecomposeLargest
+    template <ptrdiff_t s, class M1, class M2, class V1>
+    struct EigenDecomposeLargest_Helper<90,s,M1,M2,V1>
+    {
+        static TMV_INLINE void call(M1& A, M2& Z, V1& lambda)
+        { InstEigen_DecomposeLargest(A.xView(),Z.xView(),lambda.xView()); }
+    };
+
+    // algo 97: Conjugate
+    template <ptrdiff_t s, class M1, class M2, class V1>
+    struct EigenDecomposeLargest_Helper<97,s,M1,M2,V1>
+    {
+        static TMV_INLINE void call(M1& A, M2& Z, V1& lambda)
+        {
+            typedef typename M1::conjugate_type M1c;
+            typedef typename M2::conjugate_type M2c;
+            M1c Ac = A.conjugate();
+            M2c Zc = Z.conjugate();
+            EigenDecomposeLargest_Helper<-2,s,M1c,M2c,V1>::call(
+                Ac,Zc,lambda);
+        }
+    };
+
+    // algo -3: Determine which algorithm to use
+    template <ptrdiff_t s, class M1, class M2, class V1>
+    struct EigenDecomposeLargest_Helper<-3,s,M1,M2,V1>
+    {
+        static TMV_INLINE void call(M1& A, M2& Z, V1& lambda)
+        {
+            const int algo = s == 0 ? 0 : 11;
+            EigenDecomposeLargest_Helper<algo,s,M1,M2,V1>::call(A,Z,lambda);
+        }
+    };
+
+    // algo -2: Check for inst
+    template <ptrdiff_t s, class M1, class M2, class V1>
+    struct EigenDecomposeLargest_Helper<-2,s,M1,M2,V1>
+    {
+        static TMV_INLINE void call(M1& A, M2& Z, V1& lambda)
+        {
+            typedef typename M1::value_type T;
+            const bool inst =
+                (s == Unknown || s > 16) &&
+                Traits<T>::isinst;
+            const int algo =
+                s == 0 ? 0 :
+                M1::_conj ? 97 :
+                (inst && !M2::_conj) ? 90 :
+                -3;
+            EigenDecomposeLargest_Helper<algo,s,M1,M2,V1>::call(A,Z,lambda);
+        }
+    };
+
+    template <ptrdiff_t s, class M1, class M2, class V1>
+    struct EigenDecomposeLargest_Helper<-1,s,M1,M2,V1>
+    {
+        static TMV_INLINE void call(M1& A, M2& Z, V1& lambda)
+        { EigenDecomposeLargest_Helper<-2,s,M1,M2,V1>::call(A,Z,lambda); }
+    };
+
+    template <class M1, class M2, class V1>
+    inline void InlineEigen_DecomposeLargest(
+        BaseMatrix_Rec_Mutable<M1>& A, BaseMatrix_Rec_Mutable<M2>& Z,
+        BaseVector_Mutable<V1>& lambda)
+    {
+        TMVStaticAssert(Traits<typename V1::value_type>::isreal);
+        TMVStaticAssert((Traits2<
+                         typename M1::value_type,
+                         typename V1::value_type>::samebase));
+        TMVStaticAssert((Traits2<
+                         typename M1::value_type,
+                         typename M2::value_type>::sametype));
+        TMVStaticAssert((Sizes<M1::_colsize,M1::_rowsize>::same));
+        TMVStaticAssert((Sizes<M1::_colsize,M2::_colsize>::same));
+        TMVStaticAssert((Sizes<M2::_rowsize,V1::_size>::same));
+        TMVAssert(A.colsize() == A.rowsize());
+        TMVAssert(A.colsize() == Z.colsize());
+        TMVAssert(Z.rowsize() == lambda.size());
+        TMVAssert(lambda.size() <= A.colsize());
+        const ptrdiff_t s = Sizes<M1::_colsize,M1::_rowsize>::size;
+        typedef typename M1::cview_type M1v;
+        typedef typename M2::cview_type M2v;
+        typedef typename V1::cview_type V1v;
+        TMV_MAYBE_REF(M1,M1v) Av = A.cView();
+        TMV_MAYBE_REF(M2,M2v) Zv = Z.cView();
+        TMV_MAYBE_REF(V1,V1v) lv = lambda.cView();
+        EigenDecomposeLargest_Helper<-3,s,M1v,M2v,V1v>::call(Av,Zv,lv);
+    }
+
+    template <class M1, class M2, class V1>
+    inline void Eigen_DecomposeLargest(
+        BaseMatrix_Rec_Mutable<M1>& A, BaseMatrix_Rec_Mutable<M2>& Z,
+        BaseVector_Mutable<V1>& lambda)
+    {
+        TMVStaticAssert(Traits<typename V1::value_type>::isreal);
+        TMVStaticAssert((Traits2<
+                         typename M1::value_type,
+                         typename V1::value_type>::samebase));
+        TMVStaticAssert((Traits2<
+                         typename M1::value_type,
+                         typename M2::value_type>::sametype));
+        TMVStaticAssert((Sizes<M1::_colsize,M1::_rowsize>::same));
+        TMVStaticAssert((Sizes<M1::_colsize,M2::_colsize>::same));
+        TMVStaticAssert((Sizes<M2::_rowsize,V1::_size>::same));
+        TMVAssert(A.colsize() == A.rowsize());
+        TMVAssert(A.colsize() == Z.colsize());
+        TMVAssert(Z.rowsize() == lambda.size());
+        TMVAssert(lambda.size() <= A.colsize());
+        const ptrdiff_t s = Sizes<M1::_colsize,M1::_rowsize>::size;
+        typedef typename M1::cview_type M1v;
+        typedef typename M2::cview_type M2v;
+        typedef typename V1::cview_type V1v;
+        TMV_MAYBE_REF(M1,M1v) Av = A.cView();
+        TMV_MAYBE_REF(M2,M2v) Zv = Z.cView();
+        TMV_MAYBE_REF(V1,V1v) lv = lambda.cView();
+        EigenDecomposeLargest_Helper<-2,s,M1v,M2v,V1v>::call(Av,Zv,lv);
+    }
+
+    // Allow views as an argument by value (for convenience)
+    template <class T, int A, class V1>
+    TMV_INLINE void Eigen_Decompose(
+        MatrixView<T,A> m, BaseVector_Mutable<V1>& lambda)
+    {
+        typedef MatrixView<T,A> M;
+        Eigen_Decompose(static_cast<BaseMatrix_Rec_Mutable<M>&>(m),lambda);
+    }
+    template <class T, int A, class V1>
+    TMV_INLINE void Eigen_Values(
+        MatrixView<T,A> m, BaseVector_Mutable<V1>& lambda)
+    {
+        typedef MatrixView<T,A> M;
+        Eigen_Values(static_cast<BaseMatrix_Rec_Mutable<M>&>(m),lambda);
+    }
+
+} // namespace tmv
+
+#endif
@@ -0,0 +1,588 @@
+
+
+#ifndef TMV_EigenDecompose_DC_H
+#define TMV_EigenDecompose_DC_H
+
+#include "TMV_SVDecompose_DC.h"
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Sub-problems of size <= TMV_EIGEN_DC_LIMIT are done with the QL algorithm.
+#define TMV_EIGEN_DC_LIMIT 32
+#ifndef TMV_MAXITER
+#define TMV_MAXITER 100
+#endif
+
+// The task-parallel region is started for problems with
+// N >= TMV_EIGEN_DC_OPENMP_THRESH, and each divide step of size at least
+// TMV_EIGEN_DC_OPENMP_TASKMIN does its two halves as separate tasks.
+// (The same as for the SVD.)
+#define TMV_EIGEN_DC_OPENMP_THRESH 256
+#define TMV_EIGEN_DC_OPENMP_TASKMIN 128
+
+namespace tmv {
+
+    //
+    // Eigensystem of a real symmetric tridiagonal matrix T:
+    //
+    // T = Z diag(D) Z^T
+    //
+    // T is given by D (the diagonal) and E (the sub-diagonal).
+    // On output, D holds the eigenvalues and Z the eigenvectors.
+    // The input values of E are destroyed.
+    //
+    // Three routines are provided:
+    //
+    // Eigen_DecomposeFromTridiagonal_QL uses the implicit QL algorithm.
+    // It is used for the eigenvalues alone, and for the small
+    // sub-problems of the divide and conquer algorithm.
+    //
+    // Eigen_DecomposeFromTridiagonal_DC uses Cuppen's divide and conquer
+    // algorithm.  The secular equation that comes up in the conquer
+    // step is solved with the same code that the SVD uses.
+    //
+    // Eigen_LargestFromTridiagonal finds only the k largest eigenvalues
+    // using bisection, and their eigenvectors with inverse iteration.
+    //
+
+    template <class RT>
+    inline RT EigenHypot(RT a, RT b)
+    {
+        a = TMV_ABS(a);
+        b = TMV_ABS(b);
+        if (a < b) TMV_SWAP(a,b);
+        if (a == RT(0)) return RT(0);
+        const RT r = b/a;
+        return a * TMV_SQRT(RT(1) + r*r);
+    }
+
+    // The implicit QL algorithm with Wilkinson shifts.
+    // If Z.cptr() == 0, then only the eigenvalues are found.
+    // Otherwise, the rotations are applied to the columns of Z.
+    // The eigenvalues are not sorted.
+    template <class RT>
+    void Eigen_DecomposeFromTridiagonal_QL(
+        MatrixView<RT,ColMajor> Z, VectorView<RT,Unit> D,
+        VectorView<RT,Unit> E)
+    {
+        const ptrdiff_t N = D.size();
+        if (N <= 1) return;
+        TMVAssert(E.size() == N-1);
+        TMVAssert(!Z.cptr() || Z.rowsize() == N);
+        const RT eps = TMV_Epsilon<RT>();
+        const ptrdiff_t nz = Z.cptr() ? Z.colsize() : 0;
+
+        ScratchScope scope;
+        Vector<RT> e(N);
+        e.subVector(0,N-1) = E;
+        e(N-1) = RT(0);
+
+        RT f(0);
+        RT tst1(0);
+        for(ptrdiff_t l=0;l<N;++l) {
+            // Find the first small sub-diagonal element.
+            tst1 = TMV_MAX(tst1,TMV_ABS(D(l))+TMV_ABS(e(l)));
+            ptrdiff_t m = l;
+            while (m < N-1 && TMV_ABS(e(m)) > eps*tst1) ++m;
+
+            // If m == l, D(l) is already an eigenvalue.
+            // Otherwise, iterate.
+            if (m > l) {
+                int iter = 0;
+                do {
+                    if (++iter > TMV_MAXITER) {
+                        TMV_Warning(
+                            "Eigen_DecomposeFromTridiagonal_QL: "
+                            "No convergence after TMV_MAXITER iterations");
+                        break;
+                    }
+                    // Compute the implicit shift
+                    RT g = D(l);
+                    RT p = (D(l+1)-g) / (RT(2)*e(l));
+                    RT r = EigenHypot(p,RT(1));
+                    if (p < RT(0)) r = -r;
+                    D(l) = e(l) / (p+r);
+                    D(l+1) = e(l) * (p+r);
+                    const RT dl1 = D(l+1);
+                    RT h = g - D(l);
+                    for(ptrdiff_t i=l+2;i<N;++i) D(i) -= h;
+                    f += h;
+
+                    // Implicit QL transformation.
+                    p = D(m);
+                    RT c = RT(1);
+                    RT c2 = c;
+                    RT c3 = c;
+                    const RT el1 = e(l+1);
+                    RT s(0);
+                    RT s2(0);
+                    for(ptrdiff_t i=m-1;i>=l;--i) {
+                        c3 = c2;
+                        c2 = c;
+                        s2 = s;
+                        g = c * e(i);
+                        h = c * p;
+                        r = EigenHypot(p,e(i));
+                        e(i+1) = s * r;
+                        s = e(i) / r;
+                        c = p / r;
+                        p = c * D(i) - s * g;
+                        D(i+1) = h + s * (c * g + s * D(i));
+
+                        // Accumulate the transformation.
+                        RT* zi = Z.ptr() + i*Z.stepj();
+                        RT* zi1 = zi + Z.stepj();
+                        for(ptrdiff_t k=0;k<nz;++k) {
+                            h = zi1[k];
+                            zi1[k] = s * zi[k] + c * h;
+                            zi[k] = c * zi[k] - s * h;
+                        }
+                    }
+                    p = -s * s2 * c3 * el1 * e(l) / dl1;
+                    e(l) = s * p;
+                    D(l) = c * p;
+                } while (TMV_ABS(e(l)) > eps*tst1);
+            }
+            D(l) += f;
+            e(l) = RT(0);
+        }
+    }
+
+    // The conquer step: Find the eigensystem of diag(D) + z z^T,
+    // and update Z <- Z X, where X are the eigenvectors.
+    //
+    // Some of the eigenvalues may be found directly (deflation):
+    //
+    // If z_i is small, then D(i) is already an eigenvalue.
+    //
+    // If D(i) and D(j) are close, then a Givens rotation can zero
+    // one of z_i, z_j, and the corresponding D is an eigenvalue.
+    //
+    // For the rest, D is sorted and distinct, and all z_i are nonzero,
+    // so the eigenvalues are the roots of the secular equation:
+    //
+    // 1 + Sum_i z_i^2 / (D_i - lambda) = 0
+    //
+    // The SVD divide and conquer algorithm has to solve
+    //
+    // 1 + Sum_i z_i^2 / (d_i^2 - s^2) = 0
+    //
+    // with 0 <= d_0 < d_1 < ... which is the same equation with
+    // d_i = sqrt(D_i - D_0) and lambda = D_0 + s^2.
+    // So we use FindDCSingularValues to find the roots.
+    // The eigenvectors are x_j(i) = z_i / (D_i - lambda_j), which we
+    // compute from the differences d_i - s_j that are returned in W.
+    template <class RT>
+    void Eigen_DC_Merge(
+        MatrixView<RT,ColMajor> Z, VectorView<RT,Unit> D,
+        VectorView<RT,Unit> z, bool intask)
+    {
+        const ptrdiff_t N = D.size();
+        const RT eps = TMV_Epsilon<RT>();
+
+        // Sort D into increasing order.
+        Permutation P(N);
+        D.sort(P,Ascend);
+        z = P * z;
+        Z = Z * P.transpose();
+
+        // Deflate.
+        // Keep the non-deflated values in the front, in order.
+        const RT normsqz = z.normSq();
+        const RT normz = TMV_SQRT(normsqz);
+        const RT tol = RT(8) * eps * TMV_MAX(D.normInf(),normsqz);
+        ptrdiff_t Nd = 0;
+        for(ptrdiff_t i=0;i<N;++i) {
+            if (TMV_ABS(z(i))*normz <= tol) continue;
+            if (Nd > 0) {
+                const ptrdiff_t p = Nd-1;
+                const RT r = EigenHypot(z(p),z(i));
+                const RT c = z(i)/r;
+                const RT s = z(p)/r;
+                const RT t = D(i) - D(p);
+                if (TMV_ABS(t*c*s) <= tol) {
+                    // Rotate z(p) into z(i), and then p is deflated.
+                    z(i) = r;
+                    z(p) = RT(0);
+                    const RT dp = D(p);
+                    D(p) = c*c*dp + s*s*D(i);
+                    D(i) = s*s*dp + c*c*D(i);
+                    RT* zp = Z.ptr() + p*Z.stepj();
+                    RT* zi = Z.ptr() + i*Z.stepj();
+                    for(ptrdiff_t k=0;k<Z.colsize();++k) {
+                        const RT h = zp[k];
+                        zp[k] = c*h - s*zi[k];
+                        zi[k] = s*h + c*zi[k];
+                    }
+                    // Now i takes the place of p in the non-deflated list.
+                    Z.swapCols(p,i);
+                    TMV_SWAP(D(p),D(i));
+                    TMV_SWAP(z(p),z(i));
+                    continue;
+                }
+            }
+            if (i != Nd) {
+                Z.swapCols(Nd,i);
+                TMV_SWAP(D(Nd),D(i));
+                TMV_SWAP(z(Nd),z(i));
+            }
+            ++Nd;
+        }
+
+        if (Nd == 1) {
+            D(0) += z(0)*z(0);
+        } else if (Nd > 1) {
+            VectorView<RT,Unit> DN = D.subVector(0,Nd);
+            VectorView<RT,Unit> zN = z.subVector(0,Nd);
+            const RT d0 = DN(0);
+
+            // d_i = sqrt(D_i - D_0), and rescale to avoid issues with
+            // underflow/overflow as in the SVD.
+            Vector<RT> d(Nd);
+            d(0) = RT(0);
+            for(ptrdiff_t i=1;i<Nd;++i) d(i) = TMV_SQRT(DN(i)-d0);
+            const RT scale = TMV_MAX(zN.maxAbsElement(),d(Nd-1));
+            d /= scale;
+            zN /= scale;
+
+            Vector<RT> S(Nd);
+            Matrix<RT,ColMajor> W(Nd,Nd); // W(i,j) = d(i)-S(j)
+            FindDCSingularValues(S,RT(1),d,zN,W,intask);
+
+            // Update z's to numerically more stable values.
+            // (See SVDecomposeFromBidiagonal_DC.)
+            for(ptrdiff_t i=0;i<Nd;++i) {
+                const RT di = d(i);
+                RT prod = -W(i,Nd-1)*(S(Nd-1) + di);
+                for(ptrdiff_t k=0;k<i;++k) {
+                    prod *= -W(i,k)/(d(k)-di);
+                    prod *= (S(k)+di)/(d(k)+di);
+                }
+                for(ptrdiff_t k=i+1;k<Nd;++k) {
+                    prod *= -W(i,k-1)/(d(k)-di);
+                    prod *= (S(k-1)+di)/(d(k)+di);
+                }
+                prod = TMV_SQRT(prod);
+                if (zN(i) > 0) zN(i) = prod;
+                else zN(i) = -prod;
+            }
+
+            // x_j(i) = z_i / (d_i^2 - s_j^2)
+            //        = z_i / ((d_i-s_j) (d_i+s_j))
+            for(ptrdiff_t j=0;j<Nd;++j) {
+                VectorView<RT,Unit> xj = W.col(j);
+                for(ptrdiff_t i=0;i<Nd;++i)
+                    xj(i) = zN(i) / (xj(i) * (d(i)+S(j)));
+                xj /= Norm(xj);
+            }
+            Z.colRange(0,Nd) *= W;
+
+            // lambda_j = D_0 + s_j^2
+            for(ptrdiff_t j=0;j<Nd;++j) {
+                const RT sj = scale * S(j);
+                DN(j) = d0 + sj*sj;
+            }
+        }
+    }
+
+    template <class RT>
+    void Eigen_DC_Divide(
+        MatrixView<RT,ColMajor> Z, VectorView<RT,Unit> D,
+        VectorView<RT,Unit> E, bool intask);
+
+    template <class RT>
+    inline void Eigen_DC_SubProblems(
+        MatrixView<RT,ColMajor> Z, VectorView<RT,Unit> D,
+        VectorView<RT,Unit> E, ptrdiff_t K, bool intask)
+    {
+        const ptrdiff_t N = D.size();
+        MatrixView<RT,ColMajor> Z1 = Z.subMatrix(0,K,0,K);
+        MatrixView<RT,ColMajor> Z2 = Z.subMatrix(K,N,K,N);
+        VectorView<RT,Unit> D1 = D.subVector(0,K);
+        VectorView<RT,Unit> D2 = D.subVector(K,N);
+        VectorView<RT,Unit> E1 = E.subVector(0,K-1);
+        VectorView<RT,Unit> E2 = E.subVector(K,N-1);
+#ifdef _OPENMP
+        // This follows the task structure of SVDecomposeFromBidiagonal_DC.
+        if (intask) {
+            if (N >= TMV_EIGEN_DC_OPENMP_TASKMIN) {
+#pragma omp task default(shared)
+                Eigen_DC_Divide(Z1,D1,E1,true);
+                Eigen_DC_Divide(Z2,D2,E2,true);
+#pragma omp taskwait
+                return;
+            }
+        } else if (N >= TMV_EIGEN_DC_OPENMP_THRESH &&
+                   omp_get_level() == 0 && omp_get_max_threads() > 1) {
+#pragma omp parallel
+            {
+#pragma omp single
+                {
+#pragma omp task default(shared)
+                    Eigen_DC_Divide(Z1,D1,E1,true);
+                    Eigen_DC_Divide(Z2,D2,E2,true);
+#pragma omp taskwait
+                }
+            }
+            return;
+        }
+#endif
+        Eigen_DC_Divide(Z1,D1,E1,intask);
+        Eigen_DC_Divide(Z2,D2,E2,intask);
+    }
+
+    // The divide step:
+    //
+    // T = [ T1  0  ] + rho [ e_K-1 ] [ e_K-1 ]^T
+    //     [ 0   T2 ]       [ s e_0 ] [ s e_0 ]
+    //
+    // where b = E(K-1), rho = |b|, s = sign(b), and T1,T2 are the
+    // corresponding diagonal blocks of T with rho subtracted from
+    // their touching corners.
+    // If T1 = Z1 D1 Z1^T and T2 = Z2 D2 Z2^T, then
+    // T = diag(Z1,Z2) (diag(D1,D2) + z z^T) diag(Z1,Z2)^T
+    // where z = sqrt(rho) (last row of Z1, s * first row of Z2).
+    template <class RT>
+    void Eigen_DC_Divide(
+        MatrixView<RT,ColMajor> Z, VectorView<RT,Unit> D,
+        VectorView<RT,Unit> E, bool intask)
+    {
+        const ptrdiff_t N = D.size();
+        if (N <= TMV_EIGEN_DC_LIMIT) {
+            Z.setToIdentity();
+            Eigen_DecomposeFromTridiagonal_QL(Z,D,E);
+            return;
+        }
+        const ptrdiff_t K = N/2;
+        const RT b = E(K-1);
+        const RT rho = TMV_ABS(b);
+        D(K-1) -= rho;
+        D(K) -= rho;
+        Z.subMatrix(0,K,K,N).setZero();
+        Z.subMatrix(K,N,0,K).setZero();
+
+        Eigen_DC_SubProblems(Z,D,E,K,intask);
+
+        ScratchScope scope;
+        Vector<RT> z(N);
+        z.subVector(0,K) = Z.row(K-1,0,K);
+        z.subVector(K,N) = Z.row(K,K,N);
+        if (b < RT(0)) z.subVector(K,N) *= RT(-1);
+        z *= TMV_SQRT(rho);
+
+        Eigen_DC_Merge(Z,D,z.view(),intask);
+    }
+
+    // Z must be N x N.  On output, the eigenvalues in D are sorted
+    // into increasing order.
+    template <class RT>
+    void Eigen_DecomposeFromTridiagonal_DC(
+        MatrixView<RT,ColMajor> Z, VectorView<RT,Unit> D,
+        VectorView<RT,Unit> E)
+    {
+        const ptrdiff_t N = D.size();
+        TMVAssert(Z.colsize() == N);
+        TMVAssert(Z.rowsize() == N);
+        TMVAssert(E.size() == N-1);
+        if (N == 0) return;
+
+        // Scale T so that its largest element is 1.
+        RT scale = D.maxAbsElement();
+        if (N > 1) scale = TMV_MAX(scale,E.maxAbsElement());
+        if (scale == RT(0)) { Z.setToIdentity(); return; }
+        D /= scale;
+        E /= scale;
+
+        Eigen_DC_Divide(Z,D,E,false);
+
+        Permutation P(N);
+        D.sort(P,Ascend);
+        Z = Z * P.transpose();
+        D *= scale;
+    }
+
+    // The number of eigenvalues of T less than x.
+    // This is the number of negative pivots in the LDL^T decomposition
+    // of T - x I.
+    template <class RT>
+    inline ptrdiff_t Eigen_SturmCount(
+        const VectorView<RT,Unit>& D, const Vector<RT>& Esq,
+        RT x, RT pivmin)
+    {
+        const ptrdiff_t N = D.size();
+        ptrdiff_t count = 0;
+        RT q = D(0) - x;
+        if (TMV_ABS(q) < pivmin) q = -pivmin;
+        if (q < RT(0)) ++count;
+        for(ptrdiff_t i=1;i<N;++i) {
+            q = D(i) - x - Esq(i-1)/q;
+            if (TMV_ABS(q) < pivmin) q = -pivmin;
+            if (q < RT(0)) ++count;
+        }
+        return count;
+    }
+
+    // Find the k largest eigenvalues of T, where k = lambda.size().
+    // lambda is returned in decreasing order, and Z (N x k) gets the
+    // corresponding eigenvectors.
+    //
+    // The eigenvalues are found by bisection using the Sturm count,
+    // and each eigenvector by inverse iteration on T - lambda I.
+    // Eigenvectors whose eigenvalues are in a cluster are
+    // orthogonalized against the previous ones in the cluster,
+    // as in the LAPACK routine stein.
+    template <class RT>
+    void Eigen_LargestFromTridiagonal(
+        MatrixView<RT,ColMajor> Z, VectorView<RT,Unit> D,
+        VectorView<RT,Unit> E, VectorView<RT,Unit> lambda)
+    {
+        const ptrdiff_t N = D.size();
+        const ptrdiff_t k = lambda.size();
+        TMVAssert(k <= N);
+        TMVAssert(E.size() == N-1);
+        TMVAssert(Z.colsize() == N);
+        TMVAssert(Z.rowsize() == k);
+        if (k == 0) return;
+        if (N == 1) { lambda(0) = D(0); Z(0,0) = RT(1); return; }
+
+        const RT eps = TMV_Epsilon<RT>();
+        ScratchScope scope;
+
+        // Gershgorin bounds for the eigenvalues.
+        Vector<RT> Esq(N-1);
+        RT lo = D(0) - TMV_ABS(E(0));
+        RT hi = D(0) + TMV_ABS(E(0));
+        RT maxEsq = RT(0);
+        for(ptrdiff_t i=0;i<N-1;++i) {
+            Esq(i) = E(i)*E(i);
+            if (Esq(i) > maxEsq) maxEsq = Esq(i);
+            const RT r = TMV_ABS(E(i)) + (i+1<N-1 ? TMV_ABS(E(i+1)) : RT(0));
+            lo = TMV_MIN(lo,D(i+1)-r);
+            hi = TMV_MAX(hi,D(i+1)+r);
+        }
+        const RT normT = TMV_MAX(TMV_ABS(lo),TMV_ABS(hi));
+        const RT pivmin =
+            std::numeric_limits<RT>::min() * TMV_MAX(RT(1),maxEsq);
+        const RT fudge = RT(2)*N*eps*normT + RT(4)*pivmin;
+        const RT atol = eps*normT;
+        lo -= fudge;
+        hi += fudge;
+
+        // Bisection for each eigenvalue.
+        // lambda(j) is the eigenvalue with index N-1-j in increasing order,
+        // and it is less than or equal to lambda(j-1).
+        for(ptrdiff_t j=0;j<k;++j) {
+            const ptrdiff_t index = N-1-j;
+            RT a = lo;
+            RT b = j == 0 ? hi : TMV_MIN(hi,lambda(j-1)+fudge);
+            while (b-a > RT(2)*eps*TMV_MAX(TMV_ABS(a),TMV_ABS(b)) + atol) {
+                const RT mid = (a+b)/RT(2);
+                if (Eigen_SturmCount(D,Esq,mid,pivmin) > index) b = mid;
+                else a = mid;
+            }
+            lambda(j) = (a+b)/RT(2);
+        }
+
+        // Inverse iteration for each eigenvector.
+        // Solve (T - lambda I) x = b with the LU decomposition with
+        // partial pivoting.  Since T is tridiagonal, U has two
+        // super-diagonals (du1,du2), and L has a single sub-diagonal (l).
+        const RT ortol = RT(1.e-3) * normT;
+        const RT pertol = RT(10) * eps * normT;
+        const int maxits = 5;
+        Vector<RT> dd(N);
+        Vector<RT> du1(N);
+        Vector<RT> du2(N);
+        Vector<RT> l(N);
+        AlignedArray<int> piv(N);
+        ptrdiff_t j1 = 0;   // The first eigenvalue in the current cluster
+        RT lamprev = lambda(0);
+        for(ptrdiff_t j=0;j<k;++j) {
+            RT lam = lambda(j);
+            if (j > 0) {
+                if (lamprev - lam > ortol) j1 = j;
+                // Perturb lambda slightly if it is too close to the
+                // previous one, so the vectors come out different.
+                if (lamprev - lam < pertol) lam = lamprev - pertol;
+            }
+            lamprev = lam;
+
+            // LU decompose T - lam I
+            for(ptrdiff_t i=0;i<N;++i) dd(i) = D(i) - lam;
+            for(ptrdiff_t i=0;i<N-1;++i) du1(i) = E(i);
+            RT sub = N > 1 ? E(0) : RT(0);
+            for(ptrdiff_t i=0;i<N-1;++i) {
+                // Rows i,i+1 have: [ dd(i) du1(i) du2(i)  ]
+                //                  [ sub   dd(i+1) E(i+1) ]
+                const RT next = i+1<N-1 ? E(i+1) : RT(0);
+                if (TMV_ABS(dd(i)) >= TMV_ABS(sub)) {
+                    piv[i] = 0;
+                    if (dd(i) == RT(0)) dd(i) = pertol;
+                    l(i) = sub / dd(i);
+                    dd(i+1) -= l(i)*du1(i);
+                    du2(i) = RT(0);
+                    du1(i+1) = next;
+                } else {
+                    piv[i] = 1;
+                    l(i) = dd(i) / sub;
+                    const RT a1 = du1(i);
+                    dd(i) = sub;
+                    du1(i) = dd(i+1);
+                    du2(i) = next;
+                    dd(i+1) = a1 - l(i)*du1(i);
+                    du1(i+1) = -l(i)*next;
+                }
+                sub = i+2<N ? E(i+1) : RT(0);
+            }
+            if (dd(N-1) == RT(0)) dd(N-1) = pertol;
+
+            // Deterministic starting vector
+            VectorView<RT,Unit> x = Z.col(j);
+            for(ptrdiff_t i=0;i<N;++i)
+                x(i) = RT(1) + RT(((i*7919+j*104729) % 1000)) * RT(1.e-3);
+
+            for(int it=0;it<maxits;++it) {
+                // Orthogonalize against the previous vectors in the
+                // cluster.
+                for(ptrdiff_t jj=j1;jj<j;++jj) {
+                    VectorView<RT,Unit> xjj = Z.col(jj);
+                    x -= (xjj*x) * xjj;
+                }
+                // Solve L U y = x
+                for(ptrdiff_t i=0;i<N-1;++i) {
+                    if (piv[i]) {
+                        const RT xi = x(i);
+                        x(i) = x(i+1);
+                        x(i+1) = xi - l(i)*x(i);
+                    } else {
+                        x(i+1) -= l(i)*x(i);
+                    }
+                }
+                x(N-1) /= dd(N-1);
+                x(N-2) = (x(N-2) - du1(N-2)*x(N-1)) / dd(N-2);
+                for(ptrdiff_t i=N-3;i>=0;--i)
+                    x(i) = (x(i) - du1(i)*x(i+1) - du2(i)*x(i+2)) / dd(i);
+
+                const RT xnorm = Norm(x);
+                x /= xnorm;
+                // Converged once the growth is large enough.
+                if (it > 0 && xnorm * TMV_SQRT(eps) * normT > RT(1)) break;
+            }
+            for(ptrdiff_t jj=j1;jj<j;++jj) {
+                VectorView<RT,Unit> xjj = Z.col(jj);
+                x -= (xjj*x) * xjj;
+            }
+            x /= Norm(x);
+        }
+    }
+
+} // namespace tmv
+
+#undef TMV_EIGEN_DC_LIMIT
+#undef TMV_EIGEN_DC_OPENMP_THRESH
+#undef TMV_EIGEN_DC_OPENMP_TASKMIN
+
+#endif
@@ -0,0 +1,410 @@
+
+
+#ifndef TMV_EigenDecompose_Tridiag_H
+#define TMV_EigenDecompose_Tridiag_H
+
+#include "TMV_BaseMatrix_Rec.h"
+#include "TMV_Householder.h"
+#include "TMV_SymMatrix.h"
+#include "TMV_MultSV.h"
+#include "TMV_RankKMMS.h"
+
+#ifdef PRINTALGO_EIGEN
+#include <iostream>
+#endif
+
+// BLOCKSIZE is the block size to use in algo 21.
+#define TMV_TRIDIAG_BLOCKSIZE 32
+
+namespace tmv {
+
+    //
+    // Tridiagonalize: A = Q T Q^H
+    //
+    // A is hermitian (or real symmetric), and only its lower triangle
+    // is referenced.  T is a real symmetric (or hermitian) tridiagonal
+    // matrix, which is returned as two vectors:
+    // D is the (real) diagonal, E is the sub-diagonal.
+    // For complex A, E is complex in general.
+    //
+    // Q = H0 H1 ... H(N-2) is stored in packed form as for QR_Decompose,
+    // but shifted down one row: The Householder vector of Hj is in
+    // A(j+1:N,j), with the first element, A(j+1,j), implicitly 1.
+    // So Q(1:N,1:N) is the packed Q in A.subMatrix(1,N,0,N-1) with beta.
+    // The diagonal and super-diagonal of A are left with the original
+    // values of A, and A(j+1,j) is set to E(j).
+    //
+
+    // Defined in TMV_EigenDecompose_Tridiag.cpp
+    template <class T, class RT>
+    void InstTridiagonalize(
+        MatrixView<T> A, VectorView<RT> beta,
+        VectorView<RT> D, VectorView<T> E);
+
+    template <int algo, ptrdiff_t s, class M1, class V1, class V2, class V3>
+    struct Tridiagonalize_Helper;
+
+    // One step of the unblocked algorithm:
+    // Find the Householder reflection Hj that zeros A(j+2:N,j) and
+    // apply it to both sides of A22 = A(j+1:N,j+1:N):
+    //
+    // A22 <- H A22 H = A22 - v w^H - w v^H
+    // where p = beta A22 v and w = p - 1/2 beta (v^H p) v.
+    //
+    // Only the lower triangle of A22 is updated.
+    template <class M1, class V>
+    inline void Tridiagonalize_Step(
+        M1& A, ptrdiff_t j, ptrdiff_t N,
+        typename M1::real_type& bj, typename M1::value_type& ej, V w)
+    {
+        typedef typename M1::value_type T;
+        typedef typename M1::real_type RT;
+        typedef typename M1::col_sub_type M1c;
+        typedef typename M1::submatrix_type M1s;
+        typedef typename M1s::col_sub_type M1sc;
+        const ptrdiff_t n = N-j-1;
+
+        M1c u = A.col(j,j+2,N);
+        HouseholderReflect(A.ref(j+1,j),u,bj);
+        ej = A.cref(j+1,j);
+        if (bj == RT(0)) return;
+        A.ref(j+1,j) = T(1);
+
+        M1c v = A.col(j,j+1,N);
+        M1s A22 = A.subMatrix(j+1,N,j+1,N);
+        HermMatrixView<T> A22h(A22.ptr(),n,A22.stepi(),A22.stepj());
+        MultMV<false>(Scaling<0,RT>(bj),A22h,v,w);
+        const T alpha = -RT(0.5) * bj * (v.conjugate() * w);
+        w += alpha * v;
+
+        for(ptrdiff_t c=0;c<n;++c) {
+            M1sc A22c = A22.col(c,c,n);
+            A22c -= TMV_CONJ(w.cref(c)) * v.subVector(c,n);
+            A22c -= TMV_CONJ(v.cref(c)) * w.subVector(c,n);
+        }
+        A.ref(j+1,j) = ej;
+    }
+
+    // algo 0: Trivial, nothing to do (N == 0)
+    template <ptrdiff_t s, class M1, class V1, class V2, class V3>
+    struct Tridiagonalize_Helper<0,s,M1,V1,V2,V3>
+    { static TMV_INLINE void call(M1& , V1& , V2& , V3& ) {} };
+
+    // algo 11: Non-blocked algorithm
+    template <ptrdiff_t s, class M1, class V1, class V2, class V3>
+    struct Tridiagonalize_Helper<11,s,M1,V1,V2,V3>
+    {
+        static void call(M1& A, V1& beta, V2& D, V3& E)
+        {
+            typedef typename M1::value_type T;
+            typedef typename M1::real_type RT;
+            const ptrdiff_t N = s==Unknown ? A.colsize() : s;
+#ifdef PRINTALGO_EIGEN
+            std::cout<<"Tridiagonalize algo 11: N,s = "<<N<<','<<s<<std::endl;
+#endif
+            typedef typename VCopyHelper<T,s>::type Vx;
+            Vx tempBase = VectorSizer<T>(N);
+
+            RT bj;
+            T ej;
+            for(ptrdiff_t j=0;j<N-1;++j) {
+                D.ref(j) = TMV_REAL(A.cref(j,j));
+                Tridiagonalize_Step(
+                    A,j,N,bj,ej,tempBase.subVector(0,N-j-1));
+                beta.ref(j) = bj;
+                E.ref(j) = ej;
+            }
+            D.ref(N-1) = TMV_REAL(A.cref(N-1,N-1));
+        }
+    };
+
+    // algo 21: Blocked algorithm
+    //
+    // This is the same idea as the blocked Bidiagonalize algorithm,
+    // but since the updates on both sides are the same, we only need
+    // to store one extra matrix, W.  After NB steps:
+    //
+    // A22 <- A22 - V W^H - W V^H
+    //
+    // where V holds the Householder vectors for the block, and
+    // W(:,k) = beta_k A22' v_k - 1/2 beta_k^2 (v_k^H A22' v_k) v_k,
+    // with A22' = A22 - V W^H - W V^H using the first k columns of V,W.
+    //
+    // Each column of A is updated with the previous V,W columns just
+    // before its reflection is found.  At the end of the block, the rest
+    // of the matrix gets a single rank-2k update, which only does the
+    // lower triangle.
+    template <ptrdiff_t s, class M1, class V1, class V2, class V3>
+    struct Tridiagonalize_Helper<21,s,M1,V1,V2,V3>
+    {
+        static void call(M1& A, V1& beta, V2& D, V3& E)
+        {
+            typedef typename M1::value_type T;
+            typedef typename M1::real_type RT;
+            const ptrdiff_t N = s==Unknown ? A.colsize() : s;
+#ifdef PRINTALGO_EIGEN
+            std::cout<<"Tridiagonalize algo 21: N,s = "<<N<<','<<s<<std::endl;
+#endif
+            typedef typename M1::col_sub_type M1c;
+            typedef typename M1::submatrix_type M1s;
+            typedef typename VCopyHelper<T,s>::type Vx;
+            Vx tempBase = VectorSizer<T>(N);
+
+            const ptrdiff_t NB = TMV_TRIDIAG_BLOCKSIZE;
+            typedef typename MCopyHelper<T,Rec,s,NB>::type M4;
+            typedef typename M4::col_sub_type M4c;
+            typedef typename M4::submatrix_type M4s;
+            typedef typename VCopyHelper<T,NB>::type Vt;
+            typedef typename Vt::subvector_type Vts;
+
+            M4 W = MatrixSizer<T>(N,NB);
+            Vt temp = VectorSizer<T>(NB);
+
+            ptrdiff_t j1 = 0;
+            RT bj;
+            for(ptrdiff_t j2=j1+NB;j2<N-1;j1=j2,j2+=NB) {
+                for(ptrdiff_t j=j1,jj=0;j<j2;++j,++jj) {
+                    // jj = j-j1
+
+                    // Update current column:
+                    // A(j:N,j) -= V(j:N,0:jj) W(j,0:jj)^H
+                    //           + W(j:N,0:jj) V(j,0:jj)^H
+                    M1c a = A.col(j,j,N);
+                    if (jj > 0) {
+                        M1s V0 = A.subMatrix(j,N,j1,j);
+                        M4s W0 = W.subMatrix(j,N,0,jj);
+                        a -= V0 * W0.row(0).conjugate();
+                        a -= W0 * V0.row(0).conjugate();
+                    }
+                    D.ref(j) = TMV_REAL(A.cref(j,j));
+
+                    // Do the Householder reflection.
+                    // Set the top of the Householder vector to be
+                    // explicitly 1 while we use it.
+                    M1c u = A.col(j,j+2,N);
+                    HouseholderReflect(A.ref(j+1,j),u,bj);
+                    beta.ref(j) = bj;
+                    E.ref(j) = A.cref(j+1,j);
+                    A.ref(j+1,j) = T(1);
+
+                    // w = beta (A22 - V W^H - W V^H) v
+                    M1c v = A.col(j,j+1,N);
+                    M4c w = W.col(jj,j+1,N);
+                    M1s A22 = A.subMatrix(j+1,N,j+1,N);
+                    HermMatrixView<T> A22h(
+                        A22.ptr(),N-j-1,A22.stepi(),A22.stepj());
+                    MultMV<false>(Scaling<0,RT>(bj),A22h,v,w);
+                    if (jj > 0) {
+                        M1s V1x = A.subMatrix(j+1,N,j1,j);
+                        M4s W1x = W.subMatrix(j+1,N,0,jj);
+                        Vts t = temp.subVector(0,jj);
+                        t = W1x.adjoint() * v;
+                        t *= bj;
+                        w -= V1x * t;
+                        t = V1x.adjoint() * v;
+                        t *= bj;
+                        w -= W1x * t;
+                    }
+                    // w -= 1/2 beta (v^H w) v
+                    const T alpha = -RT(0.5) * bj * (v.conjugate() * w);
+                    w += alpha * v;
+                }
+
+                // Update the rest of the matrix:
+                // A(j2:N,j2:N) -= V W^H + W V^H
+                M1s A22 = A.subMatrix(j2,N,j2,N);
+                HermMatrixView<T> A22h(
+                    A22.ptr(),N-j2,A22.stepi(),A22.stepj());
+                Rank2KUpdate<true>(
+                    Scaling<-1,RT>(),A.subMatrix(j2,N,j1,j2),
+                    W.subMatrix(j2,N,0,NB),A22h);
+
+                for(ptrdiff_t j=j1;j<j2;++j) A.ref(j+1,j) = E.cref(j);
+            }
+
+            // Do the ones that don't fit into blocks.
+            T ej;
+            for(ptrdiff_t j=j1;j<N-1;++j) {
+                D.ref(j) = TMV_REAL(A.cref(j,j));
+                Tridiagonalize_Step(
+                    A,j,N,bj,ej,tempBase.subVector(0,N-j-1));
+                beta.ref(j) = bj;
+                E.ref(j) = ej;
+            }
+            D.ref(N-1) = TMV_REAL(A.cref(N-1,N-1));
+        }
+    };
+
+    // algo 31: Decide which algorithm to use based on runtime size
+    template <ptrdiff_t s, class M1, class V1, class V2, class V3>
+    struct Tridiagonalize_Helper<31,s,M1,V1,V2,V3>
+    {
+        static void call(M1& A, V1& beta, V2& D, V3& E)
+        {
+            typedef typename M1::value_type T;
+            const ptrdiff_t N = s==Unknown ? A.colsize() : s;
+#ifdef PRINTALGO_EIGEN
+            std::cout<<"Tridiagonalize algo 31: N,s = "<<N<<','<<s<<std::endl;
+#endif
+            const ptrdiff_t l2cache = TMV_L2_CACHE*1024/sizeof(T);
+            if (N*N <= l2cache)
+                Tridiagonalize_Helper<11,s,M1,V1,V2,V3>::call(A,beta,D,E);
+            else
+                Tridiagonalize_Helper<21,s,M1,V1,V2,V3>::call(A,beta,D,E);
+        }
+    };
+
+    // algo 81: Copy to colmajor
+    template <ptrdiff_t s, class M1, class V1, class V2, class V3>
+    struct Tridiagonalize_Helper<81,s,M1,V1,V2,V3>
+    {
+        static void call(M1& A, V1& beta, V2& D, V3& E)
+        {
+#ifdef PRINTALGO_EIGEN
+            std::cout<<"Tridiagonalize algo 81: s = "<<s<<std::endl;
+#endif
+            typedef typename M1::value_type T;
+            typedef typename MCopyHelper<T,Rec,s,s,ColMajor>::type Mcm;
+            ScratchScope scope;
+            Mcm Acm = A;
+            Tridiagonalize_Helper<-2,s,Mcm,V1,V2,V3>::call(Acm,beta,D,E);
+            A.noAlias() = Acm;
+        }
+    };
+
+    // algo 90: call InstTridiagonalize
+    template <ptrdiff_t s, class M1, class V1, class V2, class V3>
+    struct Tridiagonalize_Helper<90,s,M1,V1,V2,V3>
+    {
+        static TMV_INLINE void call(M1& A, V1& beta, V2& D, V3& E)
+        { InstTridiagonalize(A.xView(),beta.xView(),D.xView(),E.xView()); }
+    };
+
+    // algo 97: Conjugate
+    // If A* = Q T Q^H, then A = Q* T* (Q*)^H.  The Householder vectors
+    // are conjugated, which happens automatically, and E is conjugated.
+    template <ptrdiff_t s, class M1, class V1, class V2, class V3>
+    struct Tridiagonalize_Helper<97,s,M1,V1,V2,V3>
+    {
+        static TMV_INLINE void call(M1& A, V1& beta, V2& D, V3& E)
+        {
+            typedef typename M1::conjugate_type M1c;
+            typedef typename V3::conjugate_type V3c;
+            M1c Ac = A.conjugate();
+            V3c Ec = E.conjugate();
+            Tridiagonalize_Helper<-2,s,M1c,V1,V2,V3c>::call(Ac,beta,D,Ec);
+        }
+    };
+
+    // algo -3: Determine which algorithm to use
+    template <ptrdiff_t s, class M1, class V1, class V2, class V3>
+    struct Tridiagonalize_Helper<-3,s,M1,V1,V2,V3>
+    {
+        static TMV_INLINE void call(M1& A, V1& beta, V2& D, V3& E)
+        {
+            const int algo = (
+                s == 0 ? 0 :
+                !M1::_colmajor ? 81 :
+                ( s != Unknown && s <= 2*TMV_TRIDIAG_BLOCKSIZE ) ? 11 :
+                31 );
+#ifdef PRINTALGO_EIGEN
+            std::cout<<"Tridiagonalize algo -3: N,s = "<<A.colsize()<<
+                ','<<s<<std::endl;
+#endif
+            Tridiagonalize_Helper<algo,s,M1,V1,V2,V3>::call(A,beta,D,E);
+        }
+    };
+
+    // algo -2: Check for inst
+    template <ptrdiff_t s, class M1, class V1, class V2, class V3>
+    struct Tridiagonalize_Helper<-2,s,M1,V1,V2,V3>
+    {
+        static TMV_INLINE void call(M1& A, V1& beta, V2& D, V3& E)
+        {
+            typedef typename M1::value_type T;
+            const bool inst =
+                (s == Unknown || s > 16) &&
+                Traits<T>::isinst;
+            const int algo =
+                s == 0 ? 0 :
+                M1::_conj ? 97 :
+                (inst && !V3::_conj) ? 90 :
+                -3;
+            Tridiagonalize_Helper<algo,s,M1,V1,V2,V3>::call(A,beta,D,E);
+        }
+    };
+
+    template <ptrdiff_t s, class M1, class V1, class V2, class V3>
+    struct Tridiagonalize_Helper<-1,s,M1,V1,V2,V3>
+    {
+        static TMV_INLINE void call(M1& A, V1& beta, V2& D, V3& E)
+        { Tridiagonalize_Helper<-2,s,M1,V1,V2,V3>::call(A,beta,D,E); }
+    };
+
+    template <class M1, class V1, class V2, class V3>
+    inline void InlineTridiagonalize(
+        BaseMatrix_Rec_Mutable<M1>& A, BaseVector_Mutable<V1>& beta,
+        BaseVector_Mutable<V2>& D, BaseVector_Mutable<V3>& E)
+    {
+        TMVStaticAssert(Traits<typename V1::value_type>::isreal);
+        TMVStaticAssert(Traits<typename V2::value_type>::isreal);
+        TMVStaticAssert((Traits2<
+                         typename M1::value_type,
+                         typename V1::value_type>::samebase));
+        TMVStaticAssert((Traits2<
+                         typename M1::value_type,
+                         typename V3::value_type>::sametype));
+        TMVStaticAssert((Sizes<M1::_colsize,M1::_rowsize>::same));
+        TMVStaticAssert((Sizes<M1::_rowsize,V2::_size>::same));
+        TMVAssert(A.colsize() == A.rowsize());
+        TMVAssert(A.rowsize() == D.size());
+        TMVAssert(A.rowsize() == beta.size()+1);
+        TMVAssert(A.rowsize() == E.size()+1);
+        const ptrdiff_t s1 = Sizes<M1::_colsize,M1::_rowsize>::size;
+        const ptrdiff_t s = Sizes<s1,V2::_size>::size;
+        typedef typename M1::cview_type M1v;
+        typedef typename V1::cview_type V1v;
+        typedef typename V2::cview_type V2v;
+        typedef typename V3::cview_type V3v;
+        TMV_MAYBE_REF(M1,M1v) Av = A.cView();
+        TMV_MAYBE_REF(V1,V1v) bv = beta.cView();
+        TMV_MAYBE_REF(V2,V2v) Dv = D.cView();
+        TMV_MAYBE_REF(V3,V3v) Ev = E.cView();
+        Tridiagonalize_Helper<-3,s,M1v,V1v,V2v,V3v>::call(Av,bv,Dv,Ev);
+    }
+
+    template <class M1, class V1, class V2, class V3>
+    inline void Tridiagonalize(
+        BaseMatrix_Rec_Mutable<M1>& A, BaseVector_Mutable<V1>& beta,
+        BaseVector_Mutable<V2>& D, BaseVector_Mutable<V3>& E)
+    {
+        TMVStaticAssert(Traits<typename V1::value_type>::isreal);
+        TMVStaticAssert(Traits<typename V2::value_type>::isreal);
+        TMVStaticAssert((Traits2<
+                         typename M1::value_type,
+                         typename V1::value_type>::samebase));
+        TMVStaticAssert((Traits2<
+                         typename M1::value_type,
+                         typename V3::value_type>::sametype));
+        TMVStaticAssert((Sizes<M1::_colsize,M1::_rowsize>::same));
+        TMVStaticAssert((Sizes<M1::_rowsize,V2::_size>::same));
+        TMVAssert(A.colsize() == A.rowsize());
+        TMVAssert(A.rowsize() == D.size());
+        TMVAssert(A.rowsize() == beta.size()+1);
+        TMVAssert(A.rowsize() == E.size()+1);
+        const ptrdiff_t s1 = Sizes<M1::_colsize,M1::_rowsize>::size;
+        const ptrdiff_t s = Sizes<s1,V2::_size>::size;
+        typedef typename M1::cview_type M1v;
+        typedef typename V1::cview_type V1v;
+        typedef typename V2::cview_type V2v;
+        typedef typename V3::cview_type V3v;
+        TMV_MAYBE_REF(M1,M1v) Av = A.cView();
+        TMV_MAYBE_REF(V1,V1v) bv = beta.cView();
+        TMV_MAYBE_REF(V2,V2v) Dv = D.cView();
+        TMV_MAYBE_REF(V3,V3v) Ev = E.cView();
+        Tridiagonalize_Helper<-2,s,M1v,V1v,V2v,V3v>::call(Av,bv,Dv,Ev);
+    }
+
+} // namespace tmv
+
+#endif
@@ -33,6 +33,8 @@
 #ifndef TMV_IOStyle_H
 #define TMV_IOStyle_H
 
+#include "TMV_TextConvert.h"
+
 namespace tmv {
 
     class IOStyle 
@@ -87,6 +89,15 @@ namespace tmv {
         IOStyle& useDefaultPrecision()
         { prec = -1; return *this; }
 
+        // Use the buffered, locale-independent conversions in 
+        // TMV_TextConvert.h.  With the default precision, values are
+        // written with the fewest digits that read back exactly.
+        IOStyle& fast()
+        { usefast = true; return *this; }
+
+        IOStyle& noFast()
+        { usefast = false; return *this; }
+
         // Revert to the default values.
         IOStyle& setToDefault()
         { *this = getDefaultSingleton(); return *this; }
@@ -114,6 +125,7 @@ namespace tmv {
         std::string final;
         double thresh;
         int prec; // -1 = don't change precision.
+        bool usefast;
 
         void write(std::ostream& os)
         {
@@ -121,7 +133,7 @@ namespace tmv {
                 << simplesize << " " << usecompact << " '"
                 << start << "' '" << lparen << "' '" << space << "' '" 
                 << rparen << "' '" << rowend << "' '" << final << "' "
-                << thresh << " " << prec;
+                << thresh << " " << prec << " " << usefast;
         }
 
         // Helper for dealing with threshold writing.
@@ -143,7 +155,7 @@ namespace tmv {
             usecompact(false),
             start("\n"), lparen("( "), space("  "),
             rparen(" )"), rowend("\n"), final("\n"),
-            thresh(0.), prec(-1) {}
+            thresh(0.), prec(-1), usefast(false) {}
 
         // Use a singleton idiom for the default IOStyle:
         static inline IOStyle& getDefaultSingleton() 
@@ -177,6 +189,9 @@ namespace tmv {
     inline IOStyle PrecIO(int prec) 
     { return IOStyle().setPrecision(prec); }
 
+    inline IOStyle FastIO()
+    { return IOStyle().fast(); }
+
     inline IOStyle EigenIO()
     { return IOStyle().noPrefix().fullMatrix().markup("",""," ","","\n",""); }
 
@@ -188,47 +203,62 @@ namespace tmv {
 
         void begin() const 
         {
-            if (s.prec >= 0) {
+            if (s.usefast) {
+                buf.reserve(bufsize);
+            } else if (s.prec >= 0) {
                 oldprec = os.precision(s.prec);
             }
         }
         
         void end() const 
         {
-            if (s.prec >= 0) {
+            if (s.usefast) {
+                flush();
+            } else if (s.prec >= 0) {
                 os.precision(oldprec);
             }
         }
                 
         void writeCode(const std::string& code) const
-        { if (s.usecode) os << code << s.space; }
+        { if (s.usecode) { put(code); put(s.space); } }
 
         void writeSize(ptrdiff_t n) const
-        { if (s.writesize) os << n << s.space; }
+        {
+            if (s.writesize) {
+                if (s.usefast) putValue(n);
+                else os << n;
+                put(s.space);
+            }
+        }
         void writeSimpleSize(ptrdiff_t n) const
         { if (s.simplesize) writeSize(n); }
         void writeFullSize(ptrdiff_t n) const
         { if (!s.simplesize) writeSize(n); }
 
         void writeStart() const
-        { os << s.start; }
+        { put(s.start); }
         void writeLParen() const
-        { os << s.lparen; }
+        { put(s.lparen); }
         void writeSpace() const
-        { os << s.space; }
+        { put(s.space); }
         void writeRParen() const
-        { os << s.rparen; }
+        { put(s.rparen); }
         void writeRowEnd() const
-        { os << s.rowend; }
+        { put(s.rowend); }
         void writeFinal() const
-        { os << s.final; }
+        { put(s.final); }
 
         template <class T>
         void writeValue(const T& x) const
-        { os << Value(s.outVal(x)); }
+        {
+            if (s.usefast) putValue(s.outVal(x));
+            else os << Value(s.outVal(x));
+        }
 
         bool isCompact() const
         { return s.usecompact; }
+        bool isFast() const
+        { return s.usefast; }
 
         std::ostream& getos() const { return os; }
         const IOStyle& getstyle() const { return s; }
@@ -239,6 +269,28 @@ namespace tmv {
 
         mutable std::streamsize oldprec;
 
+        // For the fast IO, the output is collected in buf, which is
+        // written to os when it gets to bufsize and in end().
+        enum { bufsize = 1<<16 };
+        mutable std::string buf;
+
+        void put(const std::string& str) const
+        { if (s.usefast) buf += str; else os << str; }
+
+        template <class T>
+        void putValue(const T& x) const
+        {
+            char temp[TMV_TEXT_BUFSIZE];
+            buf.append(temp,FormatText(temp,x,s.prec));
+            if (buf.size() >= size_t(bufsize)) flush();
+        }
+
+        void flush() const
+        {
+            os.write(buf.data(),buf.size());
+            buf.clear();
+        }
+
         // This bit is to workaround a bug in pgCC that was fixed in version 7.
         // I don't know if versions earlier than 6.1 had the bug, but 
         // I apply the workaround to all version before 7.
@@ -269,7 +321,19 @@ namespace tmv {
             else {
                 skipWhiteSpace();
                 std::string getstr(str.size(),' ');
-                for(size_t i=0;i<str.size();++i) is.get(getstr[i]);
+                if (s.usefast) {
+                    std::streambuf* sb = is.rdbuf();
+                    for(size_t i=0;i<str.size();++i) {
+                        const int c = sb->sbumpc();
+                        if (c == EOF) {
+                            is.setstate(std::ios::eofbit|std::ios::failbit);
+                            break;
+                        }
+                        getstr[i] = char(c);
+                    }
+                } else {
+                    for(size_t i=0;i<str.size();++i) is.get(getstr[i]);
+                }
                 if (getstr != str) { 
                     exp = str;
                     got = getstr;
@@ -334,8 +398,11 @@ namespace tmv {
         bool readSize(ptrdiff_t& n, std::string& exp, std::string& got) const
         {
             if (s.writesize) {
-                skipWhiteSpace();
-                is >> n;
+                if (s.usefast) readValue(n);
+                else {
+                    skipWhiteSpace();
+                    is >> n;
+                }
                 if (!is) return false;
                 else return readSpace(exp,got);
             } else {
@@ -351,15 +418,59 @@ namespace tmv {
 
         template <class T>
         bool readValue(T& x) const
+        {
+            if (s.usefast) {
+                std::string tok;
+                readToken(tok);
+                const char* p = tok.data();
+                const char* end = p + tok.size();
+                if (!is || !ParseText(p,end,x) || p != end) {
+                    is.setstate(std::ios::failbit);
+                    return false;
+                }
+                return true;
+            } else {
+                skipWhiteSpace();
+                is >> x;
+                if (!is) return false;
+                else return true;
+            }
+        }
+
+        // Read the text of the next value (for the fast IO) and append
+        // it to str.  This is everything up to the next character that
+        // can't be part of a number, or the closing ) of a complex value.
+        // Returns false if there are no such characters.
+        bool readToken(std::string& str) const
         {
             skipWhiteSpace();
-            is >> x;
-            if (!is) return false;
-            else return true;
+            std::streambuf* sb = is.rdbuf();
+            const size_t n0 = str.size();
+            int c = sb->sgetc();
+            if (c == '(') {
+                do { 
+                    str += char(sb->sbumpc()); 
+                    c = sb->sgetc(); 
+                } while (c != ')' && c != EOF);
+                if (c == ')') str += char(sb->sbumpc()); 
+            } else {
+                while (IsTextNumberChar(c)) {
+                    str += char(c);
+                    c = sb->snextc();
+                }
+            }
+            if (c == EOF) is.setstate(std::ios::eofbit);
+            if (str.size() == n0) {
+                is.setstate(std::ios::failbit);
+                return false;
+            }
+            return true;
         }
 
         bool isCompact() const
         { return s.usecompact; }
+        bool isFast() const
+        { return s.usefast; }
 
         std::istream& getis() const { return is; }
         const IOStyle& getstyle() const { return s; }
@@ -370,10 +481,18 @@ namespace tmv {
 
         void skipWhiteSpace() const
         {
-            static std::string whitespace = " \n\t\v\r\f";
-            char c;
-            do { is.get(c); } while (whitespace.find(c) != std::string::npos);
-            is.unget();
+            if (s.usefast) {
+                std::streambuf* sb = is.rdbuf();
+                int c = sb->sgetc();
+                while (IsTextSpace(c)) c = sb->snextc();
+                if (c == EOF) is.setstate(std::ios::eofbit);
+            } else {
+                static std::string whitespace = " \n\t\v\r\f";
+                char c;
+                do { is.get(c); } 
+                while (whitespace.find(c) != std::string::npos);
+                is.unget();
+            }
         }
 
         static std::string trim(std::string s)
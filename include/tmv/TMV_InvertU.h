@@ -9,6 +9,10 @@
 #include "TMV_MultUM.h"
 #include "TMV_InvertD.h"
 
+#ifdef _OPENMP
+#include "omp.h"
+#endif
+
 #ifdef PRINTALGO_InvU
 #include <iostream>
 #include "tmv/TMV_TriMatrixIO.h"
@@ -38,6 +42,15 @@
 #define TMV_INVU_RECURSE 1
 #endif
 
+// The minimum size to use multiple threads.
+#define TMV_INVU_OMP_THRESH 256
+
+// The minimum size of a diagonal block to invert as a separate task,
+// and the width of the column tiles for the off-diagonal products.
+#ifndef TMV_INVU_OMP_TILE
+#define TMV_INVU_OMP_TILE 128
+#endif
+
 namespace tmv {
 
     // Defined in TMV_InvertU.cpp
@@ -322,6 +335,111 @@ namespace tmv {
         }
     };
 
+#ifdef _OPENMP
+    // algo 37: Same as algo 17, but with OpenMP tasks.
+    // A00 and A11 are independent, so they are inverted as separate 
+    // tasks (recursively, down to blocks of TMV_INVU_OMP_TILE).
+    // Then the two products for B01 are done in place, so only the 
+    // columns (rows for the second one) can be split, which we do in
+    // tiles of TMV_INVU_OMP_TILE.
+    template <ptrdiff_t s, class M>
+    struct InvertU_Helper<37,s,M>
+    {
+        static void call(M& m)
+        {
+            const ptrdiff_t N = m.size();
+#ifdef PRINTALGO_InvU
+            std::cout<<"InvU algo 37: N,s,x = "<<N<<','<<s<<std::endl;
+#endif
+            // As in MultMM, check omp_get_level() rather than 
+            // omp_in_parallel(), so we don't start a new parallel region
+            // if the user has called this from within an inactive one.
+            if (N < TMV_INVU_OMP_THRESH || 
+                omp_get_level() > 0 || omp_get_max_threads() == 1) {
+                InvertU_Helper<17,s,M>::call(m);
+                return;
+            }
+            typedef typename M::subtrimatrix_type Mst;
+            Mst mst = m.cSubTriMatrix(0,N);
+#pragma omp parallel
+            {
+#pragma omp single
+                {
+                    recurse(mst);
+                }
+            }
+        }
+
+        template <class M2>
+        static void recurse(M2& m)
+        {
+            const ptrdiff_t N = m.size();
+            if (N <= 2*TMV_INVU_OMP_TILE) {
+                InvertU_Helper<17,Unknown,M2>::call(m);
+                return;
+            }
+            const ptrdiff_t Nx = ((((N-1)>>5)+1)<<4);
+            const ptrdiff_t xx = Unknown;
+            const ptrdiff_t nb = TMV_INVU_OMP_TILE;
+
+            typedef typename M2::submatrix_type Msm;
+            typedef typename M2::subtrimatrix_type Mst;
+            typedef typename M2::const_subtrimatrix_type Mstc;
+            typedef typename Mst::const_transpose_type Mstct;
+            typedef typename Msm::colrange_type Msmc;
+            typedef typename Msm::const_colrange_type Msmcc;
+            typedef typename Msm::rowrange_type Msmr;
+            typedef typename Msmr::transpose_type Msmrt;
+            typedef typename Msmr::const_transpose_type Msmrct;
+            typedef typename M2::real_type RT;
+
+            Mst A00 = m.cSubTriMatrix(0,Nx);
+            Msm A01 = m.cSubMatrix(0,Nx,Nx,N);
+            Mst A11 = m.cSubTriMatrix(Nx,N);
+            Mstc A00c = A00;
+            Mstct A11ct = A11.transpose();
+
+            // B00 = A00^-1, B11 = A11^-1
+#pragma omp task default(shared)
+            recurse(A00);
+            recurse(A11);
+#pragma omp taskwait
+
+            // B01 = -B00 A01
+            const ptrdiff_t nc = (N-Nx-1)/nb + 1;
+            Scaling<-1,RT> mone;
+            for(ptrdiff_t c=0;c<nc;++c) {
+                const ptrdiff_t j1 = c*nb;
+                const ptrdiff_t j2 = TMV_MIN(N-Nx,j1+nb);
+#pragma omp task default(shared) firstprivate(j1,j2)
+                {
+                    Msmc B01c = A01.cColRange(j1,j2);
+                    Msmcc A01c = B01c;
+                    MultUM_Helper<17,xx,xx,false,-1,RT,Mstc,Msmcc,Msmc>::
+                        call(mone,A00c,A01c,B01c);
+                }
+            }
+#pragma omp taskwait
+
+            // B01 = B01 B11
+            const ptrdiff_t nr = (Nx-1)/nb + 1;
+            Scaling<1,RT> one;
+            for(ptrdiff_t r=0;r<nr;++r) {
+                const ptrdiff_t i1 = r*nb;
+                const ptrdiff_t i2 = TMV_MIN(Nx,i1+nb);
+#pragma omp task default(shared) firstprivate(i1,i2)
+                {
+                    Msmrt B01t = A01.cRowRange(i1,i2).transpose();
+                    Msmrct A01t = B01t;
+                    MultUM_Helper<27,xx,xx,false,1,RT,Mstct,Msmrct,Msmrt>::
+                        call(one,A11ct,A01t,B01t);
+                }
+            }
+#pragma omp taskwait
+        }
+    };
+#endif
+
     // algo 50: Invert the diagonal.
     // I invert the diagonal first, since it is more efficient to 
     // use the sse commands if possible.
@@ -393,6 +511,9 @@ namespace tmv {
                 s == 1 ? ( M::_unit ? 0 : 1 ) :
                 unroll ? 16 :
                 TMV_OPT == 0 ? ( M::_rowmajor ? 12 : 11 ) :
+#ifdef _OPENMP
+                (s == Unknown || s >= TMV_INVU_OMP_THRESH) ? 37 :
+#endif
                 17;
 #ifdef PRINTALGO_InvU
             std::cout<<"InlineInvertU (algo -4): \n";
@@ -422,6 +543,7 @@ namespace tmv {
             // 12 = row major
             // 16 = unroll
             // 17 = recurse
+            // 37 = recurse with openmp tasks
 
             const int algo = 
                 ( s == 0 ) ? 0 :
@@ -0,0 +1,594 @@
+//---------------------------------------------------------------------------
+//
+// This file contains the driver code for doing division using
+// an LDL Decomposition (Bunch-Kaufman).
+//
+// This decomposition works for any hermitian (or symmetric) matrix,
+// positive definite or not.  A is decomposed into:
+//
+// A = P L D L^H P^T
+//
+// where P is a permutation, L is unit lower triangular, and D is
+// block diagonal with 1x1 and 2x2 blocks.  The pivoting is the
+// Bunch-Kaufman partial pivoting strategy, which is stable for
+// indefinite matrices.  (For a complex symmetric matrix, L^H is
+// replaced by L^T.)
+//
+// L is stored in the strict lower triangle of a square matrix, and
+// the diagonal of D is stored on its diagonal.  The sub-diagonal of
+// D is stored in a separate vector xD of length N-1, where xD(k) = 0
+// means that D(k,k) is a 1x1 block.
+//
+// As for CHD, only the lower triangle of A is used.
+//
+// The determinant is just the product of the determinants of the
+// blocks of D, since det(P) det(P^T) = 1 and det(L) = 1.
+//
+
+
+#ifndef TMV_LDLD_H
+#define TMV_LDLD_H
+
+#include "TMV_BaseMatrix_Rec.h"
+#include "TMV_Vector.h"
+#include "TMV_Permutation.h"
+#include "TMV_Divider.h"
+#include "TMV_MultMM_Funcs.h"
+
+#ifdef PRINTALGO_LDL
+#include <iostream>
+#endif
+
+namespace tmv {
+
+    // In TMV_LDLDecompose.h
+    template <bool herm, class M, class V>
+    inline void LDL_Decompose(
+        BaseMatrix_Rec_Mutable<M>& m, BaseVector_Mutable<V>& xD,
+        Permutation& P);
+
+    // In TMV_LDLDiv.h
+    template <bool herm, class M1, class V1, class M2>
+    inline void LDL_SolveInPlace(
+        const BaseMatrix_Rec<M1>& m1, const BaseVector<V1>& xD,
+        const Permutation& P, BaseMatrix_Rec_Mutable<M2>& m2);
+    template <bool herm, class M1, class V1, class V2>
+    inline void LDL_SolveInPlace(
+        const BaseMatrix_Rec<M1>& m1, const BaseVector<V1>& xD,
+        const Permutation& P, BaseVector_Mutable<V2>& v2);
+
+
+    // The point of the Impl class here is to implement the transfer of
+    // ownership copy semantics.
+    template <class M>
+    struct LDLD_Impl;
+
+    template <class M>
+    class LDLD
+    {
+    public :
+
+        typedef typename M::value_type T;
+        typedef typename M::real_type RT;
+        typedef typename M::complex_type CT;
+        typedef typename M::float_type FT;
+        typedef typename M::zfloat_type ZFT;
+
+        // A regular Matrix is taken to be hermitian.
+        // Only a complex SymMatrix uses the symmetric version.
+        enum { herm = M::_shape != Sym };
+
+        typedef typename LDLD_Impl<M>::lx_type lx_type;
+        typedef const lx_type& getlx_type;
+        typedef typename lx_type::const_unit_lowertri_type getl_type;
+        typedef const Vector<T>& getxd_type;
+
+        //
+        // Constructors
+        //
+
+        // Sets up the internal storage and does the decomposition.
+        template <class M2>
+        LDLD(const BaseMatrix<M2>& A, bool _inplace=false);
+
+        // The copy constructor has transfer of ownership semantics.
+        LDLD(const LDLD<M>& rhs);
+
+        // Clean up the internal storage
+        ~LDLD();
+
+
+        //
+        // Perform the division in place
+        //
+        template <class M2>
+        void solveInPlace(BaseMatrix_Rec_Mutable<M2>& m2) const;
+        template <class V2>
+        void solveInPlace(BaseVector_Mutable<V2>& v2) const;
+
+        // A^T = A* for a hermitian matrix, and A^T = A for a symmetric one.
+        template <class M2>
+        void solveTransposeInPlace(BaseMatrix_Rec_Mutable<M2>& m2) const;
+        template <class V2>
+        void solveTransposeInPlace(BaseVector_Mutable<V2>& v2) const;
+
+        //
+        // Next the not-in-place division
+        // For LDL, we just copy m1->m3 and do the in-place version.
+        //
+
+        template <class M1, class M2>
+        void solve(
+            const BaseMatrix<M1>& m1, BaseMatrix_Rec_Mutable<M2>& m2) const
+        { solveInPlace(m2=m1); }
+        template <class V1, class V2>
+        void solve(
+            const BaseVector<V1>& v1, BaseVector_Mutable<V2>& v2) const
+        { solveInPlace(v2=v1); }
+
+        template <class M1, class M2>
+        void solveTranspose(
+            const BaseMatrix<M1>& m1, BaseMatrix_Rec_Mutable<M2>& m2) const
+        { solveTransposeInPlace(m2=m1); }
+        template <class V1, class V2>
+        void solveTranspose(
+            const BaseVector<V1>& v1, BaseVector_Mutable<V2>& v2) const
+        { solveTransposeInPlace(v2=v1); }
+
+
+        //
+        // Determinant
+        //
+
+        T det() const;
+        FT logDet(ZFT* sign) const;
+        bool isSingular() const;
+
+
+        //
+        // Inverse
+        //
+
+        template <class M2>
+        void makeInverse(BaseMatrix_Rec_Mutable<M2>& minv) const;
+
+
+        //
+        // InverseATA
+        //
+
+        template <class M2>
+        void makeInverseATA(BaseMatrix_Rec_Mutable<M2>& ata) const;
+
+
+        //
+        // Condition (kappa_inf)
+        //
+
+        RT condition(RT normInf) const;
+
+
+        //
+        // Access Decomposition
+        //
+
+        getl_type getL() const;
+        getxd_type getxD() const;
+        const Permutation& getP() const;
+        getlx_type getLx() const;
+
+        bool preferInPlace() const { return true; }
+
+    private :
+
+        mutable std::auto_ptr<LDLD_Impl<M> > pimpl;
+
+        ptrdiff_t size() const;
+
+        // Returns the determinant of the k-th block of D, and the
+        // size of the block in bs.
+        T blockDet(ptrdiff_t k, ptrdiff_t& bs) const;
+
+        // op= not allowed.
+        LDLD<M>& operator=(const LDLD<M>&);
+    };
+
+    template <class T>
+    class InstLDLD :
+        public LDLD<Matrix<T,ColMajor> >,
+        public Divider<T>
+    {
+    public :
+        typedef LDLD<Matrix<T,ColMajor> > base;
+        typedef typename base::RT RT;
+        typedef typename base::CT CT;
+        typedef typename base::FT FT;
+        typedef typename base::ZFT ZFT;
+
+        // Sets up the internal storage and does the decomposition.
+        template <int C>
+        InstLDLD(const ConstMatrixView<T,C>& A, bool _inplace=false);
+        InstLDLD(const InstLDLD<T>& rhs);
+        ~InstLDLD();
+
+        // These are the virtual functions from the Divider base class.
+        void doSolveInPlace(MatrixView<RT> m2) const;
+        void doSolveInPlace(MatrixView<CT> m2) const;
+        void doSolveInPlace(MatrixView<CT,Conj> m2) const;
+        void doSolveInPlace(VectorView<RT> v2) const;
+        void doSolveInPlace(VectorView<CT> v2) const;
+        void doSolveInPlace(VectorView<CT,Conj> v2) const;
+
+        void doSolveTransposeInPlace(MatrixView<RT> m2) const;
+        void doSolveTransposeInPlace(MatrixView<CT> m2) const;
+        void doSolveTransposeInPlace(MatrixView<CT,Conj> m2) const;
+        void doSolveTransposeInPlace(VectorView<RT> v2) const;
+        void doSolveTransposeInPlace(VectorView<CT> v2) const;
+        void doSolveTransposeInPlace(VectorView<CT,Conj> v2) const;
+
+        void doSolve(
+            const ConstMatrixView<RT>& m1, MatrixView<RT> m2) const;
+        void doSolve(
+            const ConstMatrixView<RT>& m1, MatrixView<CT> m2) const;
+        void doSolve(
+            const ConstMatrixView<RT>& m1, MatrixView<CT,Conj> m2) const;
+        void doSolve(
+            const ConstMatrixView<CT>& m1, MatrixView<CT> m2) const;
+        void doSolve(
+            const ConstMatrixView<CT>& m1, MatrixView<CT,Conj> m2) const;
+        void doSolve(
+            const ConstMatrixView<CT,Conj>& m1, MatrixView<CT> m2) const;
+        void doSolve(
+            const ConstMatrixView<CT,Conj>& m1, MatrixView<CT,Conj> m2) const;
+        void doSolve(
+            const ConstVectorView<RT>& v1, VectorView<RT> v2) const;
+        void doSolve(
+            const ConstVectorView<RT>& v1, VectorView<CT> v2) const;
+        void doSolve(
+            const ConstVectorView<RT>& v1, VectorView<CT,Conj> v2) const;
+        void doSolve(
+            const ConstVectorView<CT>& v1, VectorView<CT> v2) const;
+        void doSolve(
+            const ConstVectorView<CT>& v1, VectorView<CT,Conj> v2) const;
+        void doSolve(
+            const ConstVectorView<CT,Conj>& v1, VectorView<CT> v2) const;
+        void doSolve(
+            const ConstVectorView<CT,Conj>& v1, VectorView<CT,Conj> v2) const;
+
+        void doSolveTranspose(
+            const ConstMatrixView<RT>& m1, MatrixView<RT> m2) const;
+        void doSolveTranspose(
+            const ConstMatrixView<RT>& m1, MatrixView<CT> m2) const;
+        void doSolveTranspose(
+            const ConstMatrixView<RT>& m1, MatrixView<CT,Conj> m2) const;
+        void doSolveTranspose(
+            const ConstMatrixView<CT>& m1, MatrixView<CT> m2) const;
+        void doSolveTranspose(
+            const ConstMatrixView<CT>& m1, MatrixView<CT,Conj> m2) const;
+        void doSolveTranspose(
+            const ConstMatrixView<CT,Conj>& m1, MatrixView<CT> m2) const;
+        void doSolveTranspose(
+            const ConstMatrixView<CT,Conj>& m1, MatrixView<CT,Conj> m2) const;
+        void doSolveTranspose(
+            const ConstVectorView<RT>& v1, VectorView<RT> v2) const;
+        void doSolveTranspose(
+            const ConstVectorView<RT>& v1, VectorView<CT> v2) const;
+        void doSolveTranspose(
+            const ConstVectorView<RT>& v1, VectorView<CT,Conj> v2) const;
+        void doSolveTranspose(
+            const ConstVectorView<CT>& v1, VectorView<CT> v2) const;
+        void doSolveTranspose(
+            const ConstVectorView<CT>& v1, VectorView<CT,Conj> v2) const;
+        void doSolveTranspose(
+            const ConstVectorView<CT,Conj>& v1, VectorView<CT> v2) const;
+        void doSolveTranspose(
+            const ConstVectorView<CT,Conj>& v1, VectorView<CT,Conj> v2) const;
+
+        T det() const;
+        FT logDet(ZFT* sign) const;
+        bool isSingular() const;
+
+        void doMakeInverse(MatrixView<RT> minv) const;
+        void doMakeInverse(MatrixView<CT> minv) const;
+        void doMakeInverse(MatrixView<CT,Conj> minv) const;
+
+        void doMakeInverseATA(MatrixView<RT> ata) const;
+        void doMakeInverseATA(MatrixView<CT> ata) const;
+        void doMakeInverseATA(MatrixView<CT,Conj> ata) const;
+
+        RT condition(RT normInf) const;
+        bool preferInPlace() const;
+
+    private :
+        // op= not allowed.
+        InstLDLD<T>& operator=(const InstLDLD<T>&);
+    };
+
+    // Now the instantiation and definition.
+    template <bool isvalid, bool herm>
+    struct LDLHelper;
+
+    template <bool herm>
+    struct LDLHelper<true,herm>
+    {
+        template <class M1, class V1, class M2>
+        static inline void solveInPlace(
+            const M1& Lx, const V1& xD, const Permutation& P, M2& m2)
+        { LDL_SolveInPlace<herm>(Lx,xD,P,m2); }
+        template <class M1, class V1, class M2>
+        static inline void solveTransposeInPlace(
+            const M1& Lx, const V1& xD, const Permutation& P, M2& m2)
+        {
+            // The permutation steps can't swap through a conjugate view,
+            // so conjugate m2 in place rather than using m2.conjugate().
+            Maybe<herm>::conjself(m2);
+            LDL_SolveInPlace<herm>(Lx,xD,P,m2);
+            Maybe<herm>::conjself(m2);
+        }
+        template <class M1, class V1, class M2>
+        static inline void makeInverseATA(
+            const M1& Lx, const V1& xD, const Permutation& P, M2& m2)
+        {
+            typedef typename M1::value_type T;
+            typedef typename M1::real_type RT;
+            Matrix<T,ColMajor|NoDivider> minv(Lx.colsize(),Lx.colsize());
+            minv.setToIdentity();
+            LDL_SolveInPlace<herm>(Lx,xD,P,minv);
+            typename M2::noalias_type m2na = m2.noAlias();
+            MultMM<false>(Scaling<1,RT>(),minv,minv.adjoint(),m2na);
+        }
+    };
+    template <bool herm>
+    struct LDLHelper<false,herm>
+    {
+        template <class M1, class V1, class M2>
+        static inline void solveInPlace(
+            const M1& , const V1& , const Permutation& , M2& ) {}
+        template <class M1, class V1, class M2>
+        static inline void solveTransposeInPlace(
+            const M1& , const V1& , const Permutation& , M2& ) {}
+        template <class M1, class V1, class M2>
+        static inline void makeInverseATA(
+            const M1& , const V1& , const Permutation& , M2& ) {}
+    };
+
+    template <class M>
+    struct LDLD_Impl
+    {
+        typedef typename M::value_type T;
+        typedef MatrixView<T,ColMajor|NoAlias> lx_type;
+        enum { herm = M::_shape != Sym };
+
+        template <class M2>
+        LDLD_Impl(const BaseMatrix_Rec<M2>& A, bool _inplace) :
+            // inplace only if matrix is colmajor
+            inplace(A.iscm() && _inplace),
+            Aptr( inplace ? 0 : A.colsize()*A.colsize() ),
+            Lx(
+                inplace ? A.nonConst().ptr() : Aptr.get() ,
+                A.colsize() , A.colsize() , 1 ,
+                inplace ? A.stepj() : A.colsize() ),
+            xD(TMV_MAX(A.colsize()-1,ptrdiff_t(0))),
+            P(A.colsize())
+        {
+            TMVStaticAssert((Sizes<M2::_colsize,M2::_rowsize>::same));
+            TMVAssert(A.colsize() == A.rowsize());
+            if (!inplace) Lx = A;
+            else Maybe<M2::_conj>::conjself(Lx);
+            LDL_Decompose<herm>(Lx,xD,P);
+#ifdef PRINTALGO_LDL
+            std::cout<<"LDLD_Impl constructor\n";
+            std::cout<<"inplace = "<<inplace<<std::endl;
+            std::cout<<"A = "<<A<<std::endl;
+            std::cout<<"Lx = "<<Lx<<std::endl;
+            std::cout<<"xD = "<<xD<<std::endl;
+            std::cout<<"P = "<<P<<std::endl;
+#endif
+        }
+
+        // If A is not a BaseMatrix_Rec, can't do it in place.
+        template <class M2>
+        LDLD_Impl(const BaseMatrix<M2>& A, bool ) :
+            inplace(false),
+            Aptr( A.colsize()*A.colsize() ),
+            Lx(Aptr.get(),A.colsize(),A.colsize(),1,A.colsize()),
+            xD(TMV_MAX(A.colsize()-1,ptrdiff_t(0))),
+            P(A.colsize())
+        {
+            TMVStaticAssert((Sizes<M2::_colsize,M2::_rowsize>::same));
+            TMVAssert(A.colsize() == A.rowsize());
+            Lx = A;
+            LDL_Decompose<herm>(Lx,xD,P);
+        }
+
+        const bool inplace;
+        AlignedArray<T> Aptr;
+        lx_type Lx;
+        Vector<T> xD;
+        Permutation P;
+    };
+
+    template <class M> template <class M2>
+    LDLD<M>::LDLD(const BaseMatrix<M2>& A, bool inplace) :
+        pimpl(new LDLD_Impl<M>(A.mat(),inplace)) {}
+
+    template <class M>
+    LDLD<M>::LDLD(const LDLD<M>& rhs) : pimpl(rhs.pimpl.release()) {}
+
+    template <class M>
+    LDLD<M>::~LDLD() {}
+
+    template <class M> template <class M2>
+    void LDLD<M>::solveInPlace(BaseMatrix_Rec_Mutable<M2>& m2) const
+    {
+        TMVAssert(m2.colsize() == size());
+        const bool isvalid = M::isreal || M2::iscomplex;
+        LDLHelper<isvalid,herm>::solveInPlace(
+            pimpl->Lx,pimpl->xD,pimpl->P,m2.mat());
+    }
+
+    template <class M> template <class M2>
+    void LDLD<M>::solveTransposeInPlace(BaseMatrix_Rec_Mutable<M2>& m2) const
+    {
+        TMVAssert(m2.colsize() == size());
+        const bool isvalid = M::isreal || M2::iscomplex;
+        LDLHelper<isvalid,herm>::solveTransposeInPlace(
+            pimpl->Lx,pimpl->xD,pimpl->P,m2.mat());
+    }
+
+    template <class M> template <class V2>
+    void LDLD<M>::solveInPlace(BaseVector_Mutable<V2>& v2) const
+    {
+        TMVAssert(v2.size() == size());
+        const bool isvalid = M::isreal || V2::iscomplex;
+        LDLHelper<isvalid,herm>::solveInPlace(
+            pimpl->Lx,pimpl->xD,pimpl->P,v2.vec());
+    }
+
+    template <class M> template <class V2>
+    void LDLD<M>::solveTransposeInPlace(BaseVector_Mutable<V2>& v2) const
+    {
+        TMVAssert(v2.size() == size());
+        const bool isvalid = M::isreal || V2::iscomplex;
+        LDLHelper<isvalid,herm>::solveTransposeInPlace(
+            pimpl->Lx,pimpl->xD,pimpl->P,v2.vec());
+    }
+
+    template <class M>
+    typename M::value_type LDLD<M>::blockDet(ptrdiff_t k, ptrdiff_t& bs) const
+    {
+        const lx_type& Lx = pimpl->Lx;
+        const Vector<T>& xD = pimpl->xD;
+        if (k+1 < size() && xD(k) != T(0)) {
+            bs = 2;
+            const T d21 = xD(k);
+            const T d12 = herm ? TMV_CONJ(d21) : d21;
+            return Lx(k,k)*Lx(k+1,k+1) - d12*d21;
+        } else {
+            bs = 1;
+            return Lx(k,k);
+        }
+    }
+
+    template <class M>
+    typename M::value_type LDLD<M>::det() const
+    {
+        T ret(1);
+        ptrdiff_t bs;
+        for(ptrdiff_t k=0; k<size(); k+=bs) ret *= blockDet(k,bs);
+        return ret;
+    }
+
+    template <class M>
+    typename M::float_type LDLD<M>::logDet(typename M::zfloat_type* sign) const
+    {
+        FT ret(0);
+        if (sign) *sign = ZFT(1);
+        ptrdiff_t bs;
+        for(ptrdiff_t k=0; k<size(); k+=bs) {
+            const T d = blockDet(k,bs);
+            const FT absd = TMV_ABS(d);
+            ret += TMV_LOG(absd);
+            if (sign) {
+                if (absd == FT(0)) *sign = ZFT(0);
+                else *sign *= ZFT(d) / absd;
+            }
+        }
+        return ret;
+    }
+
+    template <class M>
+    bool LDLD<M>::isSingular() const
+    {
+        ptrdiff_t bs;
+        for(ptrdiff_t k=0; k<size(); k+=bs)
+            if (blockDet(k,bs) == T(0)) return true;
+        return false;
+    }
+
+    template <class M> template <class M2>
+    void LDLD<M>::makeInverse(BaseMatrix_Rec_Mutable<M2>& minv) const
+    {
+        TMVAssert(minv.colsize() == size());
+        TMVAssert(minv.rowsize() == size());
+        minv.setToIdentity();
+        solveInPlace(minv);
+    }
+
+    template <class M> template <class M2>
+    void LDLD<M>::makeInverseATA(BaseMatrix_Rec_Mutable<M2>& ata) const
+    {
+        // (A^H A)^-1 = A^-1 A^-H = A^-1 (A^-1)^H
+        TMVAssert(ata.colsize() == size());
+        TMVAssert(ata.rowsize() == size());
+        const bool isvalid = M::isreal || M2::iscomplex;
+        LDLHelper<isvalid,herm>::makeInverseATA(
+            pimpl->Lx,pimpl->xD,pimpl->P,ata.mat());
+    }
+
+    template <class M>
+    typename LDLD<M>::getl_type LDLD<M>::getL() const
+    { return pimpl->Lx.unitLowerTri(); }
+
+    template <class M>
+    typename LDLD<M>::getxd_type LDLD<M>::getxD() const
+    { return pimpl->xD; }
+
+    template <class M>
+    const Permutation& LDLD<M>::getP() const
+    { return pimpl->P; }
+
+    template <class M>
+    typename LDLD<M>::getlx_type LDLD<M>::getLx() const
+    { return pimpl->Lx; }
+
+    template <class M>
+    typename M::real_type LDLD<M>::condition(RT normInf) const
+    {
+        // As for LUD, this is the slow O(N^3) version.
+        if (isSingular()) {
+            return normInf / TMV_Epsilon<RT>();
+        } else {
+            Matrix<T> minv(size(),size());
+            makeInverse(minv);
+            return normInf * minv.normInf();
+        }
+    }
+
+    template <class M>
+    ptrdiff_t LDLD<M>::size() const
+    { return pimpl->Lx.colsize(); }
+
+
+    template <class M, class M2>
+    static bool CheckDecomp(
+        const LDLD<M>& ldld, const BaseMatrix_Calc<M2>& m, std::ostream* fout=0)
+    {
+        typedef typename M2::value_type T;
+        typedef typename M2::real_type RT;
+        bool printmat = fout;
+        if (printmat) {
+            *fout << "LDL:\n";
+            *fout << m << std::endl;
+            *fout << "L = "<<ldld.getL()<<std::endl;
+            *fout << "xD = "<<ldld.getxD()<<std::endl;
+            *fout << "P = "<<ldld.getP()<<std::endl;
+        }
+        // Rather than multiply out P L D L^H P^T, just check that
+        // A^-1 A = 1.
+        const ptrdiff_t N = m.colsize();
+        Matrix<T> ainva(m);
+        ldld.solveInPlace(ainva);
+        for(ptrdiff_t i=0;i<N;++i) ainva(i,i) -= T(1);
+        RT nm = Norm(ainva);
+        if (fout) {
+            *fout << "Norm(A^-1 A - 1) = "<<nm<<" <? ";
+            *fout << RT(N)<<"*"<<TMV_Epsilon<RT>()<<"*cond";
+            *fout << std::endl;
+        }
+        return nm < RT(N)*TMV_Epsilon<RT>()*ldld.condition(m.normInf());
+    }
+
+} // namespace tmv
+
+#endif
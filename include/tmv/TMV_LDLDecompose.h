@@ -0,0 +1,570 @@
+
+#ifndef TMV_LDLDecompose_H
+#define TMV_LDLDecompose_H
+
+#include "TMV_BaseMatrix_Rec.h"
+#include "TMV_BaseMatrix_Tri.h"
+#include "TMV_BaseVector.h"
+#include "TMV_MultMV.h"
+#include "TMV_MultMM.h"
+#include "TMV_MultXV.h"
+#include "TMV_MultXM.h"
+#include "TMV_SwapV.h"
+#include "TMV_RankKMMS.h"
+#include "TMV_Permutation.h"
+
+#ifdef PRINTALGO_LDL
+#include <iostream>
+#endif
+
+// BLOCKSIZE is the panel width to use in algo 21.
+#ifndef TMV_LDL_BLOCKSIZE
+#define TMV_LDL_BLOCKSIZE 64
+#endif
+
+namespace tmv {
+
+    //
+    // LDL decomposition with Bunch-Kaufman pivoting:
+    //
+    // A = P L D L^H P^T    (HermMatrix, herm = true)
+    // A = P L D L^T P^T    (SymMatrix, herm = false)
+    //
+    // L is unit lower triangular, and D is block diagonal with 1x1 and
+    // 2x2 blocks.  Only the lower triangle of A is referenced.
+    // On output, the strict lower triangle of A holds L, the diagonal
+    // holds the diagonal of D, and xD holds the sub-diagonal of D
+    // (which is 0 except for the first row of each 2x2 block).
+    //
+    // P is stored as a series of swaps, the same way as for LU.
+    // The pivots are chosen following Bunch and Kaufman (1977), which
+    // keeps the growth of the elements of L bounded without needing
+    // to search the whole trailing matrix.
+    //
+
+    // Defined in TMV_LDLDecompose.cpp
+    template <class T>
+    void InstLDL_Decompose(
+        MatrixView<T> m, VectorView<T> xD, ptrdiff_t* P, bool herm);
+
+    // The parts of the calculation that are different for a hermitian
+    // or a symmetric matrix:  x^H vs x^T, and whether D is real.
+    template <bool herm>
+    struct LDL_Helper // herm = false
+    {
+        template <class T>
+        static TMV_INLINE T cj(const T& x) { return x; }
+        template <class T>
+        static TMV_INLINE T diag(const T& x) { return x; }
+        template <class T>
+        static TMV_INLINE typename Traits<T>::real_type absdiag(const T& x)
+        { return TMV_ABS(x); }
+        template <class V>
+        static TMV_INLINE const V& cjv(const V& v) { return v; }
+    };
+    template <>
+    struct LDL_Helper<true>
+    {
+        template <class T>
+        static TMV_INLINE T cj(const T& x) { return TMV_CONJ(x); }
+        template <class T>
+        static TMV_INLINE T diag(const T& x) { return T(TMV_REAL(x)); }
+        template <class T>
+        static TMV_INLINE typename Traits<T>::real_type absdiag(const T& x)
+        { return TMV_ABS(TMV_REAL(x)); }
+        template <class V>
+        static TMV_INLINE typename V::const_conjugate_type cjv(const V& v)
+        { return v.conjugate(); }
+    };
+
+    // Interchange rows and columns kk and kp of the trailing part
+    // of A (in the lower triangle), where kp > kk.  This also swaps
+    // the rows of the columns to the left of kk (the L columns that are
+    // already done).
+    template <bool herm, class M1>
+    inline void LDL_SymSwap(M1& A, ptrdiff_t kk, ptrdiff_t kp)
+    {
+        typedef typename M1::value_type T;
+        typedef LDL_Helper<herm> H;
+        const ptrdiff_t N = A.colsize();
+        TMVAssert(kk < kp);
+        if (kk > 0) {
+            typename M1::row_sub_type r1 = A.get_row(kk,0,kk);
+            typename M1::row_sub_type r2 = A.get_row(kp,0,kk);
+            Swap(r1,r2);
+        }
+        if (kp+1 < N) {
+            typename M1::col_sub_type c1 = A.get_col(kk,kp+1,N);
+            typename M1::col_sub_type c2 = A.get_col(kp,kp+1,N);
+            Swap(c1,c2);
+        }
+        for(ptrdiff_t j=kk+1;j<kp;++j) {
+            const T t = H::cj(A.cref(j,kk));
+            A.ref(j,kk) = H::cj(A.cref(kp,j));
+            A.ref(kp,j) = t;
+        }
+        A.ref(kp,kk) = H::cj(A.cref(kp,kk));
+        const T t = A.cref(kk,kk);
+        A.ref(kk,kk) = A.cref(kp,kp);
+        A.ref(kp,kp) = t;
+    }
+
+    template <int algo, bool herm, ptrdiff_t s, class M, class V>
+    struct LDLDecompose_Helper;
+
+    // algo 0: Trivial, nothing to do (N == 0)
+    template <bool herm, ptrdiff_t s, class M, class V>
+    struct LDLDecompose_Helper<0,herm,s,M,V>
+    { static TMV_INLINE void call(M& , V& , ptrdiff_t* ) {} };
+
+    // algo 11: Unblocked, right-looking algorithm.
+    // Each step chooses a 1x1 or 2x2 pivot, and then does the
+    // rank-1 or rank-2 update of the trailing matrix.
+    template <bool herm, ptrdiff_t s, class M1, class V>
+    struct LDLDecompose_Helper<11,herm,s,M1,V>
+    {
+        static void call(M1& A, V& xD, ptrdiff_t* P)
+        {
+            typedef typename M1::value_type T;
+            typedef typename M1::real_type RT;
+            typedef LDL_Helper<herm> H;
+            const ptrdiff_t N = s==Unknown ? A.colsize() : s;
+#ifdef PRINTALGO_LDL
+            std::cout<<"LDLDecompose algo 11: N,s = "<<N<<','<<s<<std::endl;
+#endif
+            typedef typename M1::col_sub_type M1c;
+            const RT alpha = (RT(1) + TMV_SQRT(RT(17)))/RT(8);
+
+            for (ptrdiff_t k=0; k<N;) {
+                // Choose the pivot
+                ptrdiff_t kstep = 1, kp = k;
+                const RT absakk = H::absdiag(A.cref(k,k));
+                ptrdiff_t imax = k;
+                RT colmax(0);
+                if (k+1 < N) {
+                    colmax = A.get_col(k,k+1,N).maxAbsElement(&imax);
+                    imax += k+1;
+                }
+                if (TMV_MAX(absakk,colmax) > RT(0) && absakk < alpha*colmax) {
+                    RT rowmax = A.get_row(imax,k,imax).maxAbsElement();
+                    if (imax+1 < N) rowmax = TMV_MAX(
+                        rowmax,A.get_col(imax,imax+1,N).maxAbsElement());
+                    if (absakk >= alpha*colmax*(colmax/rowmax)) {
+                        kp = k;
+                    } else if (H::absdiag(A.cref(imax,imax)) >= alpha*rowmax) {
+                        kp = imax;
+                    } else {
+                        kp = imax;
+                        kstep = 2;
+                    }
+                }
+                const ptrdiff_t kk = k+kstep-1;
+                if (kp != kk) LDL_SymSwap<herm>(A,kk,kp);
+
+                if (kstep == 1) {
+                    // 1x1 pivot:
+                    // A22 -= x d^-1 x^H
+                    // L(k+1:N,k) = x d^-1
+                    const T d = H::diag(A.cref(k,k));
+                    A.ref(k,k) = d;
+                    if (k+1 < N) xD.ref(k) = T(0);
+                    // If d == 0, then the whole column is 0, so there
+                    // is nothing to do.  D is singular.
+                    if (k+1 < N && d != T(0)) {
+                        const T invd = RT(1)/d;
+                        M1c x = A.get_col(k,k+1,N);
+                        for(ptrdiff_t j=k+1;j<N;++j) {
+                            M1c Aj = A.get_col(j,j,N);
+                            MultXV<true>(
+                                Scaling<0,T>(-invd*H::cj(x.cref(j-k-1))),
+                                x.cSubVector(j-k-1,N-k-1),Aj);
+                            A.ref(j,j) = H::diag(A.cref(j,j));
+                        }
+                        Scale(Scaling<0,T>(invd),x);
+                    }
+                } else {
+                    // 2x2 pivot:
+                    // A22 -= X D^-1 X^H
+                    // L(k+2:N,k:k+2) = X D^-1
+                    const T d11 = H::diag(A.cref(k,k));
+                    const T d22 = H::diag(A.cref(k+1,k+1));
+                    const T d21 = A.cref(k+1,k);
+                    const T det = d11*d22 - H::cj(d21)*d21;
+                    const T invdet = RT(1)/det;
+                    A.ref(k,k) = d11;
+                    A.ref(k+1,k+1) = d22;
+                    A.ref(k+1,k) = T(0);
+                    xD.ref(k) = d21;
+                    if (k+2 < N) {
+                        M1c x0 = A.get_col(k,k+2,N);
+                        M1c x1 = A.get_col(k+1,k+2,N);
+                        ScratchScope scope;
+                        Vector<T> w0(N-k-2);
+                        Vector<T> w1(N-k-2);
+                        for(ptrdiff_t i=0;i<N-k-2;++i) {
+                            const T a0 = x0.cref(i);
+                            const T a1 = x1.cref(i);
+                            w0(i) = (a0*d22 - a1*d21) * invdet;
+                            w1(i) = (a1*d11 - a0*H::cj(d21)) * invdet;
+                        }
+                        for(ptrdiff_t j=k+2;j<N;++j) {
+                            const ptrdiff_t jj = j-k-2;
+                            M1c Aj = A.get_col(j,j,N);
+                            MultXV<true>(
+                                Scaling<0,T>(-H::cj(x0.cref(jj))),
+                                w0.subVector(jj,N-k-2),Aj);
+                            MultXV<true>(
+                                Scaling<0,T>(-H::cj(x1.cref(jj))),
+                                w1.subVector(jj,N-k-2),Aj);
+                            A.ref(j,j) = H::diag(A.cref(j,j));
+                        }
+                        x0 = w0;
+                        x1 = w1;
+                    }
+                }
+                if (kstep == 1) {
+                    P[k] = kp;
+                } else {
+                    P[k] = k;
+                    P[k+1] = kp;
+                }
+                k += kstep;
+            }
+        }
+    };
+
+    // algo 21: Blocked, left-looking within each panel.
+    //
+    // This is the same algorithm as LAPACK's sytrf.  Each panel of
+    // (up to) nb columns is decomposed using the algo 11 pivoting
+    // strategy, but the columns of the panel are only updated as they
+    // are needed, using W = L D, which is stored in a temporary.
+    // Then the trailing matrix is updated all at once with
+    // A22 -= L21 W21^H, which is a MultMM call for the off-diagonal
+    // blocks.  So most of the flops are done at the MultMM speed.
+    template <bool herm, ptrdiff_t s, class M1, class V>
+    struct LDLDecompose_Helper<21,herm,s,M1,V>
+    {
+        typedef typename M1::value_type T;
+        typedef typename M1::real_type RT;
+        typedef typename M1::submatrix_type M1s;
+        typedef typename V::subvector_type Vs;
+        typedef Matrix<T,ColMajor|NoDivider|NoAlias> Mw;
+        typedef typename Mw::submatrix_type Mws;
+
+        // Decompose the panel starting at the first column of B.
+        // Returns the number of columns that were done.
+        static ptrdiff_t panel(M1s& B, Mws& W, Vs& xD, ptrdiff_t* P)
+        {
+            typedef LDL_Helper<herm> H;
+            typedef typename M1s::col_sub_type M1c;
+            typedef typename Mws::col_sub_type Mwc;
+            const ptrdiff_t N = B.colsize();
+            const ptrdiff_t nb = W.rowsize();
+            const RT alpha = (RT(1) + TMV_SQRT(RT(17)))/RT(8);
+
+            ptrdiff_t k=0;
+            // Stop at nb-1, since a 2x2 pivot needs two columns of W.
+            while (k < nb-1 && k < N) {
+                // Copy column k of B to W(:,k) and update it.
+                Mwc Wk = W.get_col(k,k,N);
+                Wk = B.get_col(k,k,N);
+                if (k > 0) {
+                    MultMV<true>(
+                        Scaling<-1,RT>(),B.cSubMatrix(k,N,0,k),
+                        H::cjv(W.get_row(k,0,k)),Wk);
+                }
+                W.ref(k,k) = H::diag(W.cref(k,k));
+
+                // Choose the pivot
+                ptrdiff_t kstep = 1, kp = k;
+                const RT absakk = H::absdiag(W.cref(k,k));
+                ptrdiff_t imax = k;
+                RT colmax(0);
+                if (k+1 < N) {
+                    colmax = W.get_col(k,k+1,N).maxAbsElement(&imax);
+                    imax += k+1;
+                }
+                if (TMV_MAX(absakk,colmax) > RT(0) && absakk < alpha*colmax) {
+                    // Copy column imax to W(:,k+1) and update it.
+                    Mwc Wk1 = W.get_col(k+1,k,N);
+                    for(ptrdiff_t i=k;i<imax;++i)
+                        W.ref(i,k+1) = H::cj(B.cref(imax,i));
+                    W.get_col(k+1,imax,N) = B.get_col(imax,imax,N);
+                    if (k > 0) {
+                        MultMV<true>(
+                            Scaling<-1,RT>(),B.cSubMatrix(k,N,0,k),
+                            H::cjv(W.get_row(imax,0,k)),Wk1);
+                    }
+                    W.ref(imax,k+1) = H::diag(W.cref(imax,k+1));
+
+                    RT rowmax = W.get_col(k+1,k,imax).maxAbsElement();
+                    if (imax+1 < N) rowmax = TMV_MAX(
+                        rowmax,W.get_col(k+1,imax+1,N).maxAbsElement());
+                    if (absakk >= alpha*colmax*(colmax/rowmax)) {
+                        kp = k;
+                    } else if (H::absdiag(W.cref(imax,k+1)) >= alpha*rowmax) {
+                        kp = imax;
+                        Wk = Wk1;
+                    } else {
+                        kp = imax;
+                        kstep = 2;
+                    }
+                }
+
+                const ptrdiff_t kk = k+kstep-1;
+                if (kp != kk) {
+                    // Copy the non-updated column kk to column kp.
+                    // (Column kp is already in W.)
+                    B.ref(kp,kp) = B.cref(kk,kk);
+                    for(ptrdiff_t j=kk+1;j<kp;++j)
+                        B.ref(kp,j) = H::cj(B.cref(j,kk));
+                    if (kp+1 < N)
+                        B.get_col(kp,kp+1,N) = B.get_col(kk,kp+1,N);
+                    // Interchange rows kk and kp in the first kk columns
+                    // of B and the first kk+1 columns of W.
+                    if (kk > 0) {
+                        typename M1s::row_sub_type r1 = B.get_row(kk,0,kk);
+                        typename M1s::row_sub_type r2 = B.get_row(kp,0,kk);
+                        Swap(r1,r2);
+                    }
+                    typename Mws::row_sub_type w1 = W.get_row(kk,0,kk+1);
+                    typename Mws::row_sub_type w2 = W.get_row(kp,0,kk+1);
+                    Swap(w1,w2);
+                }
+
+                if (kstep == 1) {
+                    // Store L(k) in column k of B
+                    M1c Bk = B.get_col(k,k,N);
+                    Bk = W.get_col(k,k,N);
+                    if (k+1 < N) {
+                        xD.ref(k) = T(0);
+                        const T d = B.cref(k,k);
+                        if (d != T(0)) {
+                            M1c Bkb = B.get_col(k,k+1,N);
+                            Scale(Scaling<0,T>(RT(1)/d),Bkb);
+                        }
+                    }
+                } else {
+                    // Store L(k) and L(k+1) in columns k and k+1 of B
+                    const T d11 = W.cref(k,k);
+                    const T d22 = W.cref(k+1,k+1);
+                    const T d21 = W.cref(k+1,k);
+                    const T invdet = RT(1) / (d11*d22 - H::cj(d21)*d21);
+                    for(ptrdiff_t i=k+2;i<N;++i) {
+                        const T a0 = W.cref(i,k);
+                        const T a1 = W.cref(i,k+1);
+                        B.ref(i,k) = (a0*d22 - a1*d21) * invdet;
+                        B.ref(i,k+1) = (a1*d11 - a0*H::cj(d21)) * invdet;
+                    }
+                    B.ref(k,k) = d11;
+                    B.ref(k+1,k) = T(0);
+                    B.ref(k+1,k+1) = d22;
+                    xD.ref(k) = d21;
+                }
+                if (kstep == 1) {
+                    P[k] = kp;
+                } else {
+                    P[k] = k;
+                    P[k+1] = kp;
+                }
+                k += kstep;
+            }
+
+            // Update the trailing matrix:
+            // A22 -= L21 W21^H  (lower triangle only)
+            const ptrdiff_t kb = k;
+            const ptrdiff_t nbu = TMV_RANKK_BLOCK;
+            typedef typename M1s::const_submatrix_type M1sc;
+            typedef typename Mws::const_submatrix_type Mwsc;
+            for(ptrdiff_t j1=kb;j1<N;j1+=nbu) {
+                const ptrdiff_t j2 = TMV_MIN(N,j1+nbu);
+                M1sc L1 = B.cSubMatrix(j1,j2,0,kb);
+                Mwsc W1 = W.cSubMatrix(j1,j2,0,kb);
+                // The diagonal block is done in full in a temporary.
+                ScratchScope scope;
+                Matrix<T,ColMajor|NoDivider|NoAlias> d(j2-j1,j2-j1);
+                MultMM<false>(
+                    Scaling<1,RT>(),L1,RankK_Trans<herm>::call(W1),d);
+                M1s Bd = B.cSubMatrix(j1,j2,j1,j2);
+                typename M1s::lowertri_type Bdl = Bd.lowerTri();
+                MultXM<true>(Scaling<-1,RT>(),d.lowerTri(),Bdl);
+                if (herm) for(ptrdiff_t i=j1;i<j2;++i)
+                    B.ref(i,i) = H::diag(B.cref(i,i));
+                if (j2 < N) {
+                    M1s B21 = B.cSubMatrix(j2,N,j1,j2);
+                    MultMM<true>(
+                        Scaling<-1,RT>(),B.cSubMatrix(j2,N,0,kb),
+                        RankK_Trans<herm>::call(W1),B21);
+                }
+            }
+            return kb;
+        }
+
+        static void call(M1& A, V& xD, ptrdiff_t* P)
+        {
+            const ptrdiff_t N = s==Unknown ? A.colsize() : s;
+            const ptrdiff_t xx = Unknown;
+            const ptrdiff_t nb = TMV_LDL_BLOCKSIZE;
+#ifdef PRINTALGO_LDL
+            std::cout<<"LDLDecompose algo 21: N,s = "<<N<<','<<s<<std::endl;
+#endif
+            ScratchScope scope;
+            Mw Wfull(N,nb);
+
+            ptrdiff_t k0 = 0;
+            while (k0 < N) {
+                M1s B = A.cSubMatrix(k0,N,k0,N);
+                Vs xDb = xD.cSubVector(k0,N-1);
+                ptrdiff_t kb;
+                if (N-k0 <= nb) {
+                    // Do the last panel all at once.
+                    LDLDecompose_Helper<11,herm,xx,M1s,Vs>::call(B,xDb,P+k0);
+                    kb = N-k0;
+                } else {
+                    Mws W = Wfull.cSubMatrix(0,N-k0,0,nb);
+                    kb = panel(B,W,xDb,P+k0);
+                }
+                // Adjust the pivots to be relative to the full matrix,
+                // and apply the new permutations to the columns to the left.
+                for(ptrdiff_t i=k0;i<k0+kb;++i) P[i] += k0;
+                if (k0 > 0) A.cColRange(0,k0).cPermuteRows(P,k0,k0+kb);
+                k0 += kb;
+            }
+        }
+    };
+
+    // algo 81: Copy to colmajor
+    template <bool herm, ptrdiff_t s, class M, class V>
+    struct LDLDecompose_Helper<81,herm,s,M,V>
+    {
+        static void call(M& m, V& xD, ptrdiff_t* P)
+        {
+#ifdef PRINTALGO_LDL
+            std::cout<<"LDLDecompose algo 81: s = "<<s<<std::endl;
+#endif
+            typedef typename M::value_type T;
+            typedef typename MCopyHelper<T,Rec,s,s,ColMajor>::type Mcm;
+            ScratchScope scope;
+            Mcm mcm = m;
+            LDLDecompose_Helper<-2,herm,s,Mcm,V>::call(mcm,xD,P);
+            m.noAlias() = mcm;
+        }
+    };
+
+    // algo 90: call InstLDL_Decompose
+    template <bool herm, ptrdiff_t s, class M, class V>
+    struct LDLDecompose_Helper<90,herm,s,M,V>
+    {
+        static TMV_INLINE void call(M& m, V& xD, ptrdiff_t* P)
+        { InstLDL_Decompose(m.xView(),xD.xView(),P,herm); }
+    };
+
+    // algo 97: Conjugate
+    template <bool herm, ptrdiff_t s, class M, class V>
+    struct LDLDecompose_Helper<97,herm,s,M,V>
+    {
+        static TMV_INLINE void call(M& m, V& xD, ptrdiff_t* P)
+        {
+            typedef typename M::conjugate_type Mc;
+            typedef typename V::conjugate_type Vc;
+            Mc mc = m.conjugate();
+            Vc xDc = xD.conjugate();
+            LDLDecompose_Helper<-2,herm,s,Mc,Vc>::call(mc,xDc,P);
+        }
+    };
+
+    // algo -3: Determine which algorithm to use
+    template <bool herm, ptrdiff_t s, class M, class V>
+    struct LDLDecompose_Helper<-3,herm,s,M,V>
+    {
+        static TMV_INLINE void call(M& m, V& xD, ptrdiff_t* P)
+        {
+            const int algo = (
+                s == 0 ? 0 :
+                ( s != Unknown && s <= TMV_LDL_BLOCKSIZE ) ? 11 :
+                !M::_colmajor ? 81 :
+                21 );
+#ifdef PRINTALGO_LDL
+            std::cout<<"LDLDecompose algo -3: N,s = "<<m.colsize()<<
+                ','<<s<<std::endl;
+#endif
+            LDLDecompose_Helper<algo,herm,s,M,V>::call(m,xD,P);
+        }
+    };
+
+    // algo -2: Check for inst
+    template <bool herm, ptrdiff_t s, class M, class V>
+    struct LDLDecompose_Helper<-2,herm,s,M,V>
+    {
+        static TMV_INLINE void call(M& m, V& xD, ptrdiff_t* P)
+        {
+            typedef typename M::value_type T;
+            const bool inst =
+                (s == Unknown || s > 16) &&
+                Traits2<T,typename V::value_type>::sametype &&
+                (M::_conj == int(V::_conj)) &&
+                Traits<T>::isinst;
+            const int algo =
+                s == 0 ? 0 :
+                M::_conj ? 97 :
+                inst ? 90 :
+                -3;
+            LDLDecompose_Helper<algo,herm,s,M,V>::call(m,xD,P);
+        }
+    };
+
+    template <bool herm, ptrdiff_t s, class M, class V>
+    struct LDLDecompose_Helper<-1,herm,s,M,V>
+    {
+        static TMV_INLINE void call(M& m, V& xD, ptrdiff_t* P)
+        { LDLDecompose_Helper<-2,herm,s,M,V>::call(m,xD,P); }
+    };
+
+    template <bool herm, class M, class V>
+    inline void InlineLDL_Decompose(
+        BaseMatrix_Rec_Mutable<M>& m, BaseVector_Mutable<V>& xD,
+        ptrdiff_t* P)
+    {
+        TMVStaticAssert((Sizes<M::_colsize,M::_rowsize>::same));
+        TMVAssert(m.colsize() == m.rowsize());
+        TMVAssert(xD.size() == TMV_MAX(m.colsize()-1,ptrdiff_t(0)));
+        const ptrdiff_t s = Sizes<M::_colsize,M::_rowsize>::size;
+        typedef typename M::cview_type Mv;
+        typedef typename V::cview_type Vv;
+        TMV_MAYBE_REF(M,Mv) mv = m.cView();
+        TMV_MAYBE_REF(V,Vv) xDv = xD.cView();
+        LDLDecompose_Helper<-3,herm,s,Mv,Vv>::call(mv,xDv,P);
+    }
+
+    template <bool herm, class M, class V>
+    inline void LDL_Decompose(
+        BaseMatrix_Rec_Mutable<M>& m, BaseVector_Mutable<V>& xD,
+        ptrdiff_t* P)
+    {
+        TMVStaticAssert((Sizes<M::_colsize,M::_rowsize>::same));
+        TMVAssert(m.colsize() == m.rowsize());
+        TMVAssert(xD.size() == TMV_MAX(m.colsize()-1,ptrdiff_t(0)));
+        const ptrdiff_t s = Sizes<M::_colsize,M::_rowsize>::size;
+        typedef typename M::cview_type Mv;
+        typedef typename V::cview_type Vv;
+        TMV_MAYBE_REF(M,Mv) mv = m.cView();
+        TMV_MAYBE_REF(V,Vv) xDv = xD.cView();
+        LDLDecompose_Helper<-2,herm,s,Mv,Vv>::call(mv,xDv,P);
+    }
+
+    // This function is a friend of Permutation class.
+    template <bool herm, class M, class V>
+    inline void LDL_Decompose(
+        BaseMatrix_Rec_Mutable<M>& m, BaseVector_Mutable<V>& xD,
+        Permutation& P)
+    {
+        TMVAssert(P.size() == m.colsize());
+        P.allocateMem();
+        LDL_Decompose<herm>(m,xD,P.getMem());
+        P.isinv = true;
+    }
+
+} // namespace tmv
+
+#endif
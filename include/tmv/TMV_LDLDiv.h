@@ -0,0 +1,112 @@
+
+#ifndef TMV_LDLDiv_H
+#define TMV_LDLDiv_H
+
+#include "TMV_BaseMatrix_Rec.h"
+#include "TMV_BaseMatrix_Tri.h"
+#include "TMV_Permutation.h"
+#include "TMV_DivVM_Funcs.h"
+#include "TMV_DivMM_Funcs.h"
+#include "TMV_LDLDecompose.h"
+
+namespace tmv {
+
+    //
+    // Solve A x = b given the decomposition A = P L D L^H P^T
+    // (or P L D L^T P^T for a symmetric matrix):
+    //
+    // x = P L^-H D^-1 L^-1 P^T b
+    //
+
+    // Solve D x = b in place for the block diagonal D.
+    // The diagonal of D is on the diagonal of m1, and the
+    // sub-diagonal is in xD.
+    template <bool herm, class M1, class V1, class M2>
+    inline void LDL_SolveDInPlace(
+        const M1& m1, const V1& xD, M2& m2)
+    {
+        typedef typename M1::value_type T1;
+        typedef typename M2::value_type T2;
+        typedef LDL_Helper<herm> H;
+        const ptrdiff_t N = m1.colsize();
+        const ptrdiff_t nrhs = m2.rowsize();
+        for(ptrdiff_t k=0;k<N;) {
+            if (k+1 < N && xD.cref(k) != T1(0)) {
+                const T1 d11 = m1.cref(k,k);
+                const T1 d22 = m1.cref(k+1,k+1);
+                const T1 d21 = xD.cref(k);
+                const T1 invdet = T1(1) / (d11*d22 - H::cj(d21)*d21);
+                for(ptrdiff_t j=0;j<nrhs;++j) {
+                    const T2 b0 = m2.cref(k,j);
+                    const T2 b1 = m2.cref(k+1,j);
+                    m2.ref(k,j) = (d22*b0 - H::cj(d21)*b1) * invdet;
+                    m2.ref(k+1,j) = (d11*b1 - d21*b0) * invdet;
+                }
+                k += 2;
+            } else {
+                const T1 invd = T1(1) / m1.cref(k,k);
+                for(ptrdiff_t j=0;j<nrhs;++j) m2.ref(k,j) *= invd;
+                k += 1;
+            }
+        }
+    }
+
+    template <bool herm, class M1, class V1, class V2>
+    inline void LDL_SolveDInPlaceV(
+        const M1& m1, const V1& xD, V2& v2)
+    {
+        typedef typename M1::value_type T1;
+        typedef typename V2::value_type T2;
+        typedef LDL_Helper<herm> H;
+        const ptrdiff_t N = m1.colsize();
+        for(ptrdiff_t k=0;k<N;) {
+            if (k+1 < N && xD.cref(k) != T1(0)) {
+                const T1 d11 = m1.cref(k,k);
+                const T1 d22 = m1.cref(k+1,k+1);
+                const T1 d21 = xD.cref(k);
+                const T1 invdet = T1(1) / (d11*d22 - H::cj(d21)*d21);
+                const T2 b0 = v2.cref(k);
+                const T2 b1 = v2.cref(k+1);
+                v2.ref(k) = (d22*b0 - H::cj(d21)*b1) * invdet;
+                v2.ref(k+1) = (d11*b1 - d21*b0) * invdet;
+                k += 2;
+            } else {
+                v2.ref(k) *= T1(1) / m1.cref(k,k);
+                k += 1;
+            }
+        }
+    }
+
+    template <bool herm, class M1, class V1, class M2>
+    inline void LDL_SolveInPlace(
+        const BaseMatrix_Rec<M1>& m1, const BaseVector<V1>& xD,
+        const Permutation& P, BaseMatrix_Rec_Mutable<M2>& m2)
+    {
+        TMVAssert(m1.colsize() == m1.rowsize());
+        TMVAssert(m1.colsize() == m2.colsize());
+        typename M2::noalias_type m2na = m2.noAlias();
+        P.inverse().applyOnLeft(m2na);
+        TriLDivEq(m2na,m1.unitLowerTri());
+        LDL_SolveDInPlace<herm>(m1.mat(),xD.vec(),m2na);
+        TriLDivEq(m2na,RankK_Trans<herm>::call(m1.unitLowerTri()));
+        P.applyOnLeft(m2na);
+    }
+
+    template <bool herm, class M1, class V1, class V2>
+    inline void LDL_SolveInPlace(
+        const BaseMatrix_Rec<M1>& m1, const BaseVector<V1>& xD,
+        const Permutation& P, BaseVector_Mutable<V2>& v2)
+    {
+        TMVAssert(m1.colsize() == m1.rowsize());
+        TMVAssert(m1.colsize() == v2.size());
+        typename V2::noalias_type v2na = v2.noAlias();
+        P.inverse().applyOnLeft(v2na);
+        TriLDivEq(v2na,m1.unitLowerTri());
+        LDL_SolveDInPlaceV<herm>(m1.mat(),xD.vec(),v2na);
+        TriLDivEq(v2na,RankK_Trans<herm>::call(m1.unitLowerTri()));
+        P.applyOnLeft(v2na);
+    }
+
+} // namespace tmv
+
+#endif
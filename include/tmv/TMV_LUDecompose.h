@@ -10,6 +10,12 @@
 #include "TMV_DivVU.h"
 #include "TMV_DivMU.h"
 #include "TMV_Permutation.h"
+#include "TMV_AlgoTrace.h"
+
+#ifdef _OPENMP
+#include "omp.h"
+#include <vector>
+#endif
 
 #ifdef PRINTALGO_LU
 #include <iostream>
@@ -46,6 +52,29 @@
 #define TMV_LU_RECURSE 1
 #endif
 
+// PAR_BLOCKSIZE is the panel width to use in the OpenMP algo 31.
+// This is larger than BLOCKSIZE, since each trailing update is a separate
+// task, and we want those to be big enough to use the packed MultMM.
+#ifndef TMV_LU_PAR_BLOCKSIZE
+#define TMV_LU_PAR_BLOCKSIZE 128
+#endif
+
+// LOOKAHEAD = how many panels the factorization in algo 31 is allowed
+// to get ahead of the trailing updates.  With 1, the factorization
+// of panel k+1 overlaps with the rest of the trailing update from 
+// panel k.  Larger values let the panel factorizations (which are 
+// mostly serial) run further ahead, at the cost of more scattered 
+// memory access in the updates.
+#ifndef TMV_LU_LOOKAHEAD
+#define TMV_LU_LOOKAHEAD 2
+#endif
+
+// OPENMP_THRESH = the minimum min(M,N) for which InstLU_Decompose 
+// uses the OpenMP algo 31.
+#ifndef TMV_LU_OPENMP_THRESH
+#define TMV_LU_OPENMP_THRESH 512
+#endif
+
 // INLINE_MV = Inline the MV (MultMV, LDivEqVU) calls.
 #if TMV_OPT >= 1
 #define TMV_LU_INLINE_MV
@@ -65,6 +94,32 @@ namespace tmv {
     template <int algo, ptrdiff_t cs, ptrdiff_t rs, class M>
     struct LUDecompose_Helper;
 
+    // Record a call in the algorithm trace.  (See TMV_AlgoTrace.h)
+    // The small algorithms and small known sizes aren't traced.
+    template <ptrdiff_t cs, ptrdiff_t rs, class M1>
+    class LUDecompose_Trace : public AlgoTrace
+    {
+    public:
+        enum { small = (
+                cs != Unknown && rs != Unknown && cs <= 16 && rs <= 16 ) };
+        enum { sz = sizeof(typename M1::value_type) };
+        enum { nflops = M1::iscomplex ? 8 : 2 };
+
+        LUDecompose_Trace(int algo, const M1& m) :
+            AlgoTrace(
+                small || algo < 11 ? 0 : "LU_Decompose", algo,
+                m.colsize(), m.rowsize(), 0,
+                nflops * flops(m.colsize(),m.rowsize()),
+                2. * sz * m.colsize() * m.rowsize()) {}
+
+        // The number of multiply-adds for an MxN LU decomposition.
+        static double flops(double M, double N)
+        {
+            const double R = TMV_MIN(M,N);
+            return M*N*R - (M+N)*R*R/2. + R*R*R/3.;
+        }
+    };
+
     // algo 0: Trivial, nothing to do (M == 0 or 1, or N == 0)
     template <ptrdiff_t cs, ptrdiff_t rs, class M>
     struct LUDecompose_Helper<0,cs,rs,M>
@@ -640,6 +695,145 @@ namespace tmv {
         }
     };
 
+#ifdef _OPENMP
+    // algo 31: OpenMP block algorithm with lookahead
+    template <ptrdiff_t cs, ptrdiff_t rs, class M1>
+    struct LUDecompose_Helper<31,cs,rs,M1>
+    {
+        typedef typename M1::value_type T;
+        typedef typename M1::real_type RT;
+        typedef typename M1::submatrix_type M1s;
+        typedef typename M1::const_submatrix_type M1sc;
+        typedef typename M1s::const_unit_lowertri_type M1l;
+
+        // Decompose the panel with columns cb[k]..cb[k+1].
+        static void factor(M1& A, ptrdiff_t* P, const ptrdiff_t* cb, 
+                           ptrdiff_t k)
+        {
+            const ptrdiff_t xx = Unknown;
+            const ptrdiff_t M = A.colsize();
+            const ptrdiff_t j1 = cb[k];
+            const ptrdiff_t j2 = cb[k+1];
+            M1s A0 = A.cSubMatrix(j1,M,j1,j2);
+            LUDecompose_Helper<27,xx,xx,M1s>::call(A0,P+j1);
+            for(ptrdiff_t i=j1;i<j2;++i) P[i]+=j1;
+        }
+
+        // Apply the row swaps and the update from panel k to the 
+        // column block cb[j]..cb[j+1].
+        static void update(M1& A, const ptrdiff_t* P, const ptrdiff_t* cb,
+                           ptrdiff_t k, ptrdiff_t j)
+        {
+            const ptrdiff_t xx = Unknown;
+            const ptrdiff_t M = A.colsize();
+            const ptrdiff_t k1 = cb[k];
+            const ptrdiff_t k2 = cb[k+1];
+            const ptrdiff_t j1 = cb[j];
+            const ptrdiff_t j2 = cb[j+1];
+            M1s Aj = A.cSubMatrix(0,M,j1,j2);
+            Aj.cPermuteRows(P,k1,k2);
+
+            // Solve for U01
+            //A01 /= A00.unitLowerTri();
+            M1s A01 = A.cSubMatrix(k1,k2,j1,j2);
+            M1l L00 = A.cSubMatrix(k1,k2,k1,k2).unitLowerTri();
+            LDivEqMU_Helper<-2,xx,xx,M1s,M1l>::call(A01,L00);
+
+            // Solve for A~
+            if (k2 < M) {
+                //A11 -= A10 * A01;
+                M1s A11 = A.cSubMatrix(k2,M,j1,j2);
+                MultMM_Helper<-2,xx,xx,xx,true,-1,RT,M1sc,M1sc,M1s>::call(
+                    Scaling<-1,RT>(),A.cSubMatrix(k2,M,k1,k2),A01,A11);
+            }
+        }
+
+        static void call(M1& A, ptrdiff_t* P)
+        {
+            // This is the same calculation as the block algorithm 21,
+            // but the steps are done as OpenMP tasks, and the order is
+            // determined by the data dependencies rather than by a
+            // strict loop over the panels.
+            //
+            // The columns are split into blocks of PAR_BLOCKSIZE.
+            // For each panel k, there is one task to decompose the panel
+            // and one task for each column block j > k to apply the row 
+            // swaps and the update from panel k.  Each update task only 
+            // touches its own column block, so the row swaps are done 
+            // in parallel along with the rest of the update.
+            //
+            // The decomposition of panel k+1 only needs the update of 
+            // its own column block from panel k, so it can start while 
+            // the updates of the rest of the trailing matrix are still 
+            // running.  This is the lookahead.  To keep the panels from 
+            // getting arbitrarily far ahead, the decomposition of panel 
+            // k waits for all of the updates from panel k-LOOKAHEAD-1.
+            //
+            // The swaps from later panels are not applied to the L 
+            // columns to the left until the end, since those are still
+            // being read by the update tasks.  Then each column block 
+            // is done in parallel.
+
+            const ptrdiff_t N = rs==Unknown ? A.rowsize() : rs;
+            const ptrdiff_t M = cs==Unknown ? A.colsize() : cs;
+            const ptrdiff_t Nx = TMV_LU_PAR_BLOCKSIZE;
+            const ptrdiff_t R = TMV_MIN(N,M);
+            const ptrdiff_t la = TMV_LU_LOOKAHEAD;
+#ifdef PRINTALGO_LU
+            std::cout<<"LUDecompose algo 31: M,N,cs,rs = "<<M<<','<<N<<
+                ','<<cs<<','<<rs<<std::endl;
+#endif
+            LUDecompose_Trace<cs,rs,M1> trace(31,A);
+
+            // The boundaries of the column blocks.  The first np blocks
+            // are the panels to be decomposed.  Any columns past R are
+            // only updated.
+            std::vector<ptrdiff_t> cbv;
+            for(ptrdiff_t j=0;j<R;j+=Nx) cbv.push_back(j);
+            const ptrdiff_t np = cbv.size();
+            for(ptrdiff_t j=R;j<N;j+=Nx) cbv.push_back(j);
+            const ptrdiff_t nb = cbv.size();
+            cbv.push_back(N);
+            const ptrdiff_t* cb = &cbv[0];
+
+            // These are only used as the dependency addresses for the 
+            // tasks.  The extra element in stepdep is a dummy for the
+            // first few panels, which don't need to wait for anything.
+            std::vector<char> coldepv(nb);
+            std::vector<char> stepdepv(np+1);
+            char* coldep = &coldepv[0];
+            char* stepdep = &stepdepv[0];
+
+#pragma omp parallel
+            {
+#pragma omp single
+                {
+                    for(ptrdiff_t k=0;k<np;++k) {
+                        const ptrdiff_t kw = k > la ? k-la-1 : np;
+#pragma omp task firstprivate(k) \
+                        depend(inout:coldep[k]) depend(inout:stepdep[kw])
+                        factor(A,P,cb,k);
+
+                        for(ptrdiff_t j=k+1;j<nb;++j) {
+#pragma omp task firstprivate(k,j) \
+                            depend(in:coldep[k]) depend(inout:coldep[j]) \
+                            depend(in:stepdep[k])
+                            update(A,P,cb,k,j);
+                        }
+                    }
+                }
+
+                // Apply the later permutations to the left columns.
+#pragma omp for schedule(dynamic)
+                for(ptrdiff_t j=0;j<np-1;++j) {
+                    M1s Aj = A.cSubMatrix(0,M,cb[j],cb[j+1]);
+                    Aj.cPermuteRows(P,cb[j+1],R);
+                }
+            }
+        }
+    };
+#endif
+
     // algo 81: Copy to colmajor
     template <ptrdiff_t cs, ptrdiff_t rs, class M>
     struct LUDecompose_Helper<81,cs,rs,M>
@@ -649,8 +843,10 @@ namespace tmv {
 #ifdef PRINTALGO_LU
             std::cout<<"LUDecompose algo 81: cs,rs = "<<cs<<','<<rs<<std::endl;
 #endif
+            LUDecompose_Trace<cs,rs,M> trace(81,m);
             typedef typename M::value_type T;
             typedef typename MCopyHelper<T,Rec,cs,rs,ColMajor>::type Mcm;
+            ScratchScope scope;
             Mcm mcm = m;
             LUDecompose_Helper<-2,cs,rs,Mcm>::call(mcm,P);
             m.noAlias() = mcm;
@@ -701,6 +897,7 @@ namespace tmv {
 #ifdef XDEBUG_LU
             Matrix<T> mi = m;
 #endif
+            LUDecompose_Trace<cs,rs,M1> trace(algo,m);
             LUDecompose_Helper<algo,cs,rs,M1>::call(m,P);
 #ifdef XDEBUG_LU
             Matrix<T> lu = m.unitLowerTri() * m.upperTri();
@@ -816,6 +1013,7 @@ namespace tmv {
 
 #undef TMV_LU_RECURSE
 #undef TMV_LU_BLOCKSIZE
+#undef TMV_LU_PAR_BLOCKSIZE
 
 } // namespace tmv
 
@@ -151,7 +151,10 @@
 //
 //    type& transposeSelf() 
 //        Transposes the elements of a square matrix
-//        The matrix must be square for this function.
+//        The matrix must be square for this function, except for a 
+//        Matrix (not a view), where a non-square M x N matrix becomes 
+//        N x M.  The storage is transposed in place, so this doesn't 
+//        need memory for a second copy of the matrix.
 //
 //    type& setToIdentity(value_type x = 1)
 //        Set to the identity matrix, or 
@@ -566,8 +569,13 @@
 //    the decomposition if it hasn't be done yet.
 //
 //    Likewise:
-//    qrd(), qrpd(), svd() return the corresponding Divider classes for
-//    those algorithms.
+//    qrd(), qrpd(), svd(), chd(), ldld() return the corresponding
+//    Divider classes for those algorithms.
+//
+//    CH and LDL are only valid for hermitian matrices.  Only the lower
+//    triangle of the matrix is used for these, so it is up to the user
+//    to make sure the matrix really is hermitian.  CH additionally
+//    requires the matrix to be positive definite.
 //
 
 
@@ -596,6 +604,10 @@ namespace tmv {
     template <class T> class InstQRPD;
     template <class M> class SVD;
     template <class T> class InstSVD;
+    template <class M> class CHD;
+    template <class T> class InstCHD;
+    template <class M> class LDLD;
+    template <class T> class InstLDLD;
 
     // The MatrixDivHelper class breaks up into two other classes:
     // MatrixDivHelper1<M,true> and MatrixDivHelper1<M,false>
@@ -621,6 +633,8 @@ namespace tmv {
         typedef const InstQRD<T>& qrd_type;
         typedef const InstQRPD<T>& qrpd_type;
         typedef const InstSVD<T>& svd_type;
+        typedef const InstCHD<T>& chd_type;
+        typedef const InstLDLD<T>& ldld_type;
 
         MatrixDivHelper2();
         ~MatrixDivHelper2();
@@ -632,7 +646,8 @@ namespace tmv {
         void divideUsing(DivType dt) const
         {
             TMVAssert(dt == tmv::LU || dt == tmv::QR || 
-                      dt == tmv::QRP || dt == tmv::SV);
+                      dt == tmv::QRP || dt == tmv::SV ||
+                      dt == tmv::CH || dt == tmv::LDL);
             DivHelper<T>::divideUsing(dt);
         }
 
@@ -640,6 +655,8 @@ namespace tmv {
         qrd_type qrd() const;
         qrpd_type qrpd() const;
         svd_type svd() const;
+        chd_type chd() const;
+        ldld_type ldld() const;
 
         virtual ConstMatrixView<T> getConstView() const=0;
 
@@ -673,12 +690,16 @@ namespace tmv {
         typedef typename Traits<M>::qrd_type qrd_type;
         typedef typename Traits<M>::qrpd_type qrpd_type;
         typedef typename Traits<M>::svd_type svd_type;
+        typedef typename Traits<M>::chd_type chd_type;
+        typedef typename Traits<M>::ldld_type ldld_type;
 
         TMV_INLINE void resetDivType() const {} 
         TMV_INLINE lud_type lud() const { return lud_type(mat2(),false); }
         TMV_INLINE qrd_type qrd() const { return qrd_type(mat2(),false); }
         TMV_INLINE qrpd_type qrpd() const { return qrpd_type(mat2(),false); }
         TMV_INLINE svd_type svd() const { return svd_type(mat2(),false); }
+        TMV_INLINE chd_type chd() const { return chd_type(mat2(),false); }
+        TMV_INLINE ldld_type ldld() const { return ldld_type(mat2(),false); }
 
         TMV_INLINE const M& mat2() const
         { return static_cast<const M&>(*this); }
@@ -757,6 +778,10 @@ namespace tmv {
                 const InstQRPD<T>& , QRPD<copy_type> >::type qrpd_type;
         typedef typename TypeSelect<_hasdivider ,
                 const InstSVD<T>& , SVD<copy_type> >::type svd_type;
+        typedef typename TypeSelect<_hasdivider ,
+                const InstCHD<T>& , CHD<copy_type> >::type chd_type;
+        typedef typename TypeSelect<_hasdivider ,
+                const InstLDLD<T>& , LDLD<copy_type> >::type ldld_type;
 
         enum { vecA = (
                 (_fort ? FortranStyle : 0) |
@@ -1026,6 +1051,19 @@ namespace tmv {
 #endif
         }
 
+        type& transposeSelf()
+        {
+            if (itscs == itsrs) {
+                base_mut::transposeSelf();
+            } else {
+                if (_rowmajor) InPlaceTransposeStorage(ptr(),itsrs,itscs);
+                else InPlaceTransposeStorage(ptr(),itscs,itsrs);
+                TMV_SWAP(itscs,itsrs);
+                divhelper::resetDivType();
+            }
+            return *this;
+        }
+
         TMV_INLINE ptrdiff_t ls() const { return linsize; }
         TMV_INLINE ptrdiff_t colsize() const { return itscs; }
         TMV_INLINE ptrdiff_t rowsize() const { return itsrs; }
@@ -1043,6 +1081,9 @@ namespace tmv {
         ptrdiff_t linsize;
         AlignedArray<T> itsm;
 
+        template <class T2, int A1, int A2>
+        friend void ChangeMajor(Matrix<T2,A1>& m1, Matrix<T2,A2>& m2);
+
     }; // Matrix
 
     template <class T, int A0>
@@ -1108,6 +1149,10 @@ namespace tmv {
                 const InstQRPD<T>& , QRPD<copy_type> >::type qrpd_type;
         typedef typename TypeSelect<_hasdivider ,
                 const InstSVD<T>& , SVD<copy_type> >::type svd_type;
+        typedef typename TypeSelect<_hasdivider ,
+                const InstCHD<T>& , CHD<copy_type> >::type chd_type;
+        typedef typename TypeSelect<_hasdivider ,
+                const InstLDLD<T>& , LDLD<copy_type> >::type ldld_type;
 
         enum { vecA = (
                 (_fort ? FortranStyle : 0) |
@@ -1381,6 +1426,10 @@ namespace tmv {
                 const InstQRPD<T>& , QRPD<copy_type> >::type qrpd_type;
         typedef typename TypeSelect<_hasdivider ,
                 const InstSVD<T>& , SVD<copy_type> >::type svd_type;
+        typedef typename TypeSelect<_hasdivider ,
+                const InstCHD<T>& , CHD<copy_type> >::type chd_type;
+        typedef typename TypeSelect<_hasdivider ,
+                const InstLDLD<T>& , LDLD<copy_type> >::type ldld_type;
 
         enum { vecA = (
                 (_fort ? FortranStyle : 0) |
@@ -1694,6 +1743,31 @@ namespace tmv {
     template <class T, int A>
     TMV_INLINE void Swap(Matrix<T,A>& m1, Matrix<T,A>& m2)
     { m1.swapWith(m2); }
+
+    //
+    // ChangeMajor
+    //
+    // Move the contents of m1 into m2, which has the opposite storage
+    // order (RowMajor vs ColMajor).  The storage is transposed in place 
+    // and then handed over to m2, so this doesn't need memory for a 
+    // second copy of the matrix.  m1 is left as a 0 x 0 matrix.
+    //
+
+    template <class T, int A1, int A2>
+    inline void ChangeMajor(Matrix<T,A1>& m1, Matrix<T,A2>& m2)
+    {
+        TMVStaticAssert(int(Matrix<T,A1>::_rowmajor) == 
+                        int(Matrix<T,A2>::_colmajor));
+        // After this, the storage of m1 is that of the original m1
+        // in m2's storage order.
+        m1.transposeSelf();
+        m2.itscs = m1.itsrs;
+        m2.itsrs = m1.itscs;
+        m2.linsize = m1.linsize;
+        m2.itsm.swapWith(m1.itsm);
+        m2.resetDivType();
+        m1.resize(0,0);
+    }
     template <class M, class T, int A>
     TMV_INLINE void Swap(
         BaseMatrix_Rec_Mutable<M>& m1, MatrixView<T,A> m2)
@@ -4,6 +4,13 @@
 
 #include "TMV_BaseMatrix_Rec.h"
 #include "TMV_IOStyle.h"
+#include <vector>
+
+// The fast text read (algo 12) collects the text of this many values
+// at a time before converting them.  If there are at least
+// TMV_READ_OPENMP_THRESH of them, the conversion is done in parallel.
+#define TMV_READ_BLOCKSIZE 65536
+#define TMV_READ_OPENMP_THRESH 4096
 
 namespace tmv {
 
@@ -282,6 +289,135 @@ namespace tmv {
         }
     };
 
+    // algo 12: Fast text IO.
+    // The markup is read sequentially as in algo 11, but the text of
+    // each value is just stored until we have a block of rows.  Then
+    // the values in the block are converted (in parallel if OpenMP
+    // is enabled).
+    template <class M1>
+    struct ReadM_Helper<12,M1>
+    {
+        static void call(const TMV_Reader& reader, M1& m)
+        {
+            typedef typename M1::value_type T;
+            typedef typename Traits<T>::real_type RT;
+            const ptrdiff_t M = m.colsize();
+            const ptrdiff_t N = m.rowsize();
+            const ptrdiff_t nb = N > 0 ? 
+                TMV_MAX(ptrdiff_t(1),TMV_READ_BLOCKSIZE/N) : M;
+            std::string exp, got;
+            std::string text;
+            // The value (i,j) in the current block is text[k1,k2) with
+            // k1 = offset[(i-i1)*N+j] and k2 = offset[(i-i1)*N+j+1].
+            std::vector<size_t> offset;
+            std::vector<ptrdiff_t> badj;
+            // Make sure the static table used by ParseText is set up 
+            // before the parallel region.
+            TextPow10<RT>::get();
+            if (!reader.readStart(exp,got)) {
+#ifdef NOTHROW
+                std::cerr<<"Matrix Read Error: "<<got<<" != "<<exp<<std::endl;
+                exit(1);
+#else
+                throw MatrixReadError<T>(0,0,m,reader.getis(),exp,got);
+#endif
+            }
+            for(ptrdiff_t i1=0;i1<M;i1+=nb) {
+                const ptrdiff_t i2 = TMV_MIN(M,i1+nb);
+                text.clear();
+                offset.clear();
+                offset.push_back(0);
+                for(ptrdiff_t i=i1;i<i2;++i) {
+                    if (!reader.readLParen(exp,got)) {
+#ifdef NOTHROW
+                        std::cerr<<"Matrix Read Error: "<<got<<" != "<<exp<<std::endl;
+                        exit(1);
+#else
+                        throw MatrixReadError<T>(i,0,m,reader.getis(),exp,got);
+#endif
+                    }
+                    for(ptrdiff_t j=0;j<N;++j) {
+                        if (j>0) {
+                            if (!reader.readSpace(exp,got)) {
+#ifdef NOTHROW
+                                std::cerr<<"Matrix Read Error: "<<got<<" != "<<exp<<std::endl;
+                                exit(1);
+#else
+                                throw MatrixReadError<T>(i,j,m,reader.getis(),exp,got);
+#endif
+                            }
+                        }
+                        if (!reader.readToken(text)) {
+#ifdef NOTHROW
+                            std::cerr<<"Matrix Read Error: reading value\n";
+                            exit(1);
+#else
+                            throw MatrixReadError<T>(i,j,m,reader.getis());
+#endif
+                        }
+                        offset.push_back(text.size());
+                    }
+                    if (!reader.readRParen(exp,got)) {
+#ifdef NOTHROW
+                        std::cerr<<"Matrix Read Error: "<<got<<" != "<<exp<<std::endl;
+                        exit(1);
+#else
+                        throw MatrixReadError<T>(i,N,m,reader.getis(),exp,got);
+#endif
+                    }
+                    if (i < M-1 && !reader.readRowEnd(exp,got)) {
+#ifdef NOTHROW
+                        std::cerr<<"Matrix Read Error: "<<got<<" != "<<exp<<std::endl;
+                        exit(1);
+#else
+                        throw MatrixReadError<T>(i,N,m,reader.getis(),exp,got);
+#endif
+                    }
+                }
+
+                // Convert the values.  badj[i-i1] is the first j that
+                // couldn't be converted in row i, or -1.
+                const int nrows = int(i2-i1);
+                badj.assign(nrows,-1);
+                const char* buf = text.data();
+#ifdef _OPENMP
+#pragma omp parallel for if (nrows*N >= TMV_READ_OPENMP_THRESH)
+#endif
+                for(int ii=0;ii<nrows;++ii) {
+                    const size_t* off = &offset[ii*N];
+                    T temp;
+                    for(ptrdiff_t j=0;j<N;++j) {
+                        const char* p = buf + off[j];
+                        const char* end = buf + off[j+1];
+                        if (!ParseText(p,end,temp) || p != end) {
+                            badj[ii] = j;
+                            break;
+                        }
+                        m.ref(i1+ii,j) = temp;
+                    }
+                }
+                for(int ii=0;ii<nrows;++ii) if (badj[ii] >= 0) {
+                    reader.getis().setstate(std::ios::failbit);
+#ifdef NOTHROW
+                    std::cerr<<"Matrix Read Error: reading value\n";
+                    exit(1);
+#else
+                    throw MatrixReadError<T>(
+                        i1+ii,badj[ii],m,reader.getis());
+#endif
+                }
+            }
+            if (!reader.readFinal(exp,got)) {
+#ifdef NOTHROW
+                std::cerr<<"Matrix Read Error: "<<got<<" != "<<exp<<std::endl;
+                exit(1);
+#else
+                throw MatrixReadError<T>(M,0,m,reader.getis(),exp,got);
+#endif
+            }
+        }
+    };
+
     // algo 90: Call inst
     template <class M1>
     struct ReadM_Helper<90,M1>
@@ -303,12 +439,15 @@ namespace tmv {
         }
     };
              
-    // algo -3: Only one algorithm, so call it.
+    // algo -3: Determine which algorithm to use
     template <class M1>
     struct ReadM_Helper<-3,M1>
     {
         static TMV_INLINE void call(const TMV_Reader& reader, M1& m)
-        { ReadM_Helper<11,M1>::call(reader,m); }
+        {
+            if (reader.isFast()) ReadM_Helper<12,M1>::call(reader,m);
+            else ReadM_Helper<11,M1>::call(reader,m); 
+        }
     };
              
     // algo -2: Check for inst
@@ -9,6 +9,8 @@
 #include "TMV_MultMM_Funcs.h"
 #include "TMV_MultXM_Funcs.h"
 #include "TMV_Prefetch.h"
+#include "TMV_AlgoTrace.h"
+#include "TMV_Tuning.h"
 
 #ifdef _OPENMP
 #include "omp.h"
@@ -55,6 +57,17 @@
 #define TMV_MM_USE_RECURSIVE_BLOCK
 #endif
 
+// For large real matrices, the packed panel algorithm in 
+// TMV_MultMM_Packed.h is faster than either block algorithm, since
+// its blocking is tuned to each level of the cache, and its 
+// micro-kernel keeps a whole block of the product in registers.
+// It requires M,N,K to all be at least TMV_MM_MIN_PACKED (see 
+// TMV_MultMM_Packed.h).  Like the recursive block algorithm, we only 
+// require TMV_OPT = 2.
+#if TMV_OPT >= 2
+#define TMV_MM_USE_PACKED
+#endif
+
 // For extremely large matrices, it is worth using a recursive Winograd
 // algorithm where only 7 matrix multiplies are needed to do the 8
 // submatrix calculations in:
@@ -105,72 +118,10 @@
 // (That's an empirical value for my Intel Core 2 Duo.)
 #define TMV_MM_PREFETCH 2048
 
-// The minimum size to use a recursive Winograd algorithm
-// (This is repeated in TMV_MultMM_Winograd.h where it is also used.)
-#ifdef TMV_MM_USE_RECURSIVE_BLOCK
-#define TMV_MM_MIN_WINOGRAD 2048
-#else
-#define TMV_MM_MIN_WINOGRAD 1024
-#endif
-
-// The minimum value of Mb*Nb*Kb*Kb to use recursive algorithm.
-// This formula for the crossover between algorithms 63 and 64 is
-// purely empirical on my MacBook (with an Intel Core 2 Duo processor),
-// so it might not even be the right thing to parametrize on other
-// machines.  On the other hand, the difference between the two algorithms
-// isn't _that_ extreme.  At most I've seen about a factor of 2, so
-// if I use the less optimal algorithm for some sizes, it's not that
-// terrible a mistake.
-#define TMV_MM_MIN_RECURSIVE 16*1024
-
-// The minimum value of (M*N*K / 16^3) to use multiple threads.
-// (We also require that M or N > 64 so we have something to split.)
-// The computer that I did most of the testing on only has 2 processors,
-// so this optimization might be particular to having 2 threads.
-// TODO: Investigate the timings when more than 2 threads are available.
-#define TMV_MM_OPENMP_THRESH 64
-// There are some sizes where this selection formula doesn't quite work,
-// but it seems to be not too bad.  But maybe this deserves a bit more
-// work to find a better formula, since the ratio of time for omp to
-// not using omp is not at all monotonic in M*N*K.  So perhaps a 
-// different formula would be better.
-
-//                    no omp    omp    omp/not    M*N*K/16^3
-//  16 x  16 x  16    1.275    9.503    7.453       1
-//  16 x  16 x  64    1.224    4.716    3.852       4
-//  64 x  16 x  16    1.168    2.891    2.475       4
-//  16 x  64 x  16    1.122    2.752    2.452       4
-//  16 x  16 x 256    1.259    2.158    1.714      16
-//  64 x  64 x  16    1.070    1.303    1.217      16
-//  16 x 256 x  16    1.126    1.250    1.110      16
-// 256 x  16 x  16    1.186    1.186    1.000      16
-//  64 x  16 x  64    1.145    1.096    0.957      16
-//  16 x  64 x  64    1.146    1.051    0.917      16
-
-// ^^^^ My formula says don't use omp
-// vvvv My formula says use omp
-
-//  64 x  64 x  64    0.655    0.679    1.036      64
-//  64 x  16 x 256    1.201    1.213    1.009      64
-//  16 x  64 x 256    1.191    1.195    1.003      64
-// 256 x  16 x 256    0.566    0.551    0.973     256
-//  64 x 256 x  64    0.465    0.412    0.886     256
-//  64 x  64 x 256    0.619    0.546    0.882     256
-// 256 x  64 x  64    0.463    0.406    0.876     256
-// 256 x  64 x 256    0.431    0.334    0.774    1024
-//  64 x 256 x  16    1.055    0.836    0.792      64
-// 256 x  64 x  16    1.098    0.840    0.765      64
-//  64 x 256 x 256    0.444    0.317    0.713    1024
-// 256 x 256 x  16    1.080    0.722    0.668     256
-// 256 x 256 x  64    0.429    0.271    0.631    1024
-// 256 x 256 x 256    0.401    0.239    0.596    4096
-//  16 x 256 x  64    1.124    0.539    0.479      64
-// 256 x  16 x  64    1.143    0.537    0.469      64
-//  16 x 256 x 256    1.143    0.528    0.461     256
-
-// The minimum value of (M*N*K / 16^3) to use copying algorithm
-// where each block is copied to temporary storage in a block structure.
-#define TMV_MM_MIN_COPY_ALGO 4
+// The crossover points that are used at run time when the sizes aren't
+// known at compile time (TMV_MM_MIN_WINOGRAD, TMV_MM_MIN_RECURSIVE, 
+// TMV_MM_MIN_PACKED, TMV_MM_OPENMP_THRESH and TMV_MM_MIN_COPY_ALGO)
+// are in the tuning profile.  Their defaults are in TMV_Tuning.h.
 
 // ZeroIX controls whether ix = -1 should act like ix = 1 or ix = 0.
 #define TMV_MM_ZeroIX (ix==0)
@@ -204,6 +155,30 @@ namespace tmv {
     template <int algo, ptrdiff_t cs, ptrdiff_t rs, ptrdiff_t xs, bool add, int ix, class T, class M1, class M2, class M3>
     struct MultMM_Helper;
 
+    // Record a call to one of the algorithms below in the algorithm
+    // trace.  (See TMV_AlgoTrace.h.)  Products whose sizes are all 
+    // known to be small aren't traced.
+    template <ptrdiff_t cs, ptrdiff_t rs, ptrdiff_t xs, bool add, class M1, class M3>
+    class MultMM_Trace : public AlgoTrace
+    {
+    public:
+        enum { small = (
+                cs != Unknown && rs != Unknown && xs != Unknown &&
+                cs <= 16 && rs <= 16 && xs <= 16 ) };
+        enum { sz = sizeof(typename M3::value_type) };
+        enum { nflops = M3::iscomplex ? 8 : 2 };
+
+        MultMM_Trace(int algo, const M1& m1, const M3& m3) :
+            AlgoTrace(
+                small ? 0 : "MultMM", algo,
+                m3.colsize(), m3.rowsize(), m1.rowsize(),
+                double(nflops) * m3.colsize() * m3.rowsize() * m1.rowsize(),
+                double(sz) * (
+                    m1.colsize() * m1.rowsize() + 
+                    m1.rowsize() * m3.rowsize() + 
+                    (add ? 2 : 1) * m3.colsize() * m3.rowsize())) {}
+    };
+
     // algo 0: Trivial, nothing to do.
     template <ptrdiff_t cs, ptrdiff_t rs, ptrdiff_t xs, bool add, int ix, class T, class M1, class M2, class M3>
     struct MultMM_Helper<0,cs,rs,xs,add,ix,T,M1,M2,M3>
@@ -1337,6 +1312,7 @@ namespace tmv {
         static TMV_INLINE void call(
             const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
         {
+            MultMM_Trace<cs,rs,xs,add,M1,M3> trace(63,m1,m3);
 #ifdef PRINTALGO_MM
             const ptrdiff_t M = cs==Unknown ? m3.colsize() : cs;
             const ptrdiff_t N = rs==Unknown ? m3.rowsize() : rs;
@@ -1359,6 +1335,7 @@ namespace tmv {
         static TMV_INLINE void call(
             const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
         {
+            MultMM_Trace<cs,rs,xs,add,M1,M3> trace(64,m1,m3);
 #ifdef PRINTALGO_MM
             const ptrdiff_t M = cs==Unknown ? m3.colsize() : cs;
             const ptrdiff_t N = rs==Unknown ? m3.rowsize() : rs;
@@ -1370,6 +1347,29 @@ namespace tmv {
         }
     };
 
+    // algo 65: Pack m1 and m2 into panels sized for each level of the
+    // cache, and use a register-blocked micro-kernel on them.
+    // This is only used for real matrices that all have the same type.
+    // The dividing line between this and algos 63,64 is set by 
+    // TMV_MM_MIN_PACKED.
+    template <ptrdiff_t cs, ptrdiff_t rs, ptrdiff_t xs, bool add, int ix, class T, class M1, class M2, class M3>
+    struct MultMM_Helper<65,cs,rs,xs,add,ix,T,M1,M2,M3>
+    {
+        static TMV_INLINE void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
+        {
+            MultMM_Trace<cs,rs,xs,add,M1,M3> trace(65,m1,m3);
+#ifdef PRINTALGO_MM
+            const ptrdiff_t M = cs==Unknown ? m3.colsize() : cs;
+            const ptrdiff_t N = rs==Unknown ? m3.rowsize() : rs;
+            const ptrdiff_t K = xs==Unknown ? m1.rowsize() : xs;
+            std::cout<<"MM algo 65: M,N,K,cs,rs,xs,x = "<<M<<','<<N<<','<<K<<
+                ','<<cs<<','<<rs<<','<<xs<<','<<T(x)<<std::endl;
+#endif
+            MultMM_Packed<add>(x,m1,m2,m3);
+        }
+    };
+
     // algo 66: Split problem into 4 parts then call another algorithm
     // to finish the work.  This is used after a bad_alloc error
     // to split the problem into chunks that will require less temporary
@@ -1383,6 +1383,7 @@ namespace tmv {
         static void call(
             const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
         {
+            MultMM_Trace<cs,rs,xs,add,M1,M3> trace(66,m1,m3);
             const ptrdiff_t M = cs==Unknown ? m3.colsize() : cs;
             const ptrdiff_t N = rs==Unknown ? m3.rowsize() : rs;
 #ifdef PRINTALGO_MM
@@ -1434,6 +1435,7 @@ namespace tmv {
         static void call(
             const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
         {
+            MultMM_Trace<cs,rs,xs,add,M1,M3> trace(67,m1,m3);
 #ifdef PRINTALGO_MM
             const ptrdiff_t M = cs==Unknown ? m3.colsize() : cs;
             const ptrdiff_t N = rs==Unknown ? m3.rowsize() : rs;
@@ -1468,6 +1470,7 @@ namespace tmv {
         static TMV_INLINE void call(
             const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
         {
+            MultMM_Trace<cs,rs,xs,add,M1,M3> trace(68,m1,m3);
 #ifdef PRINTALGO_MM
             const ptrdiff_t M = cs==Unknown ? m3.colsize() : cs;
             const ptrdiff_t N = rs==Unknown ? m3.rowsize() : rs;
@@ -1482,29 +1485,20 @@ namespace tmv {
 #ifdef _OPENMP
     // algo 69: Split problem into smaller parts with OpenMP for 
     // parallelization.
-    // We take a pretty simple approach here, and just split up m2 and m3
-    // matrices by columns and let each thread do a single matrix.
-    // Then each thread calls algo 63 to calculate its product.
-    // Also, we require that all but the last thread has a column width
-    // that is a multiple of 16.  This way we get the maximum advantage from
-    // our blocking structure while keeping the threads as balanced as 
-    // possible.
-    //
-    // Also, if M is larger than N, then we split the rows of m1 and m3
-    // instead.
-    //
-    // TODO: This way of doing things means that m1 (or m2) gets copied
-    // separately for each thread, which is obviously inefficient.
-    // So we can improve this by loading up the m1 sub-blocks once
-    // here before doing the algo 63 recursion.  But this would require
-    // significantly more coding to arrange this correctly, so I haven't
-    // done so yet.
+    // m3 is split into 2D tiles (and K is split as well if there aren't
+    // enough tiles to go around), and the threads take tiles from a 
+    // work-stealing queue until they are all done.  Tile widths are 
+    // multiples of 16 to get the maximum advantage from our blocking 
+    // structure.  For real matrices, each tile is done with the packed
+    // algorithm (algo 65), and each thread reuses its packed buffers
+    // for all of its tiles.  See TMV_MultMM_OpenMP.h for the details.
     template <ptrdiff_t cs, ptrdiff_t rs, ptrdiff_t xs, bool add, int ix, class T, class M1, class M2, class M3>
     struct MultMM_Helper<69,cs,rs,xs,add,ix,T,M1,M2,M3>
     {
         static TMV_INLINE void call(
             const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
         {
+            MultMM_Trace<cs,rs,xs,add,M1,M3> trace(69,m1,m3);
 #ifdef PRINTALGO_MM
             const ptrdiff_t M = cs==Unknown ? m3.colsize() : cs;
             const ptrdiff_t N = rs==Unknown ? m3.rowsize() : rs;
@@ -1539,6 +1533,7 @@ namespace tmv {
             const ptrdiff_t Nc = N < 16 ? 1 : (N>>4); // = N/16
             const ptrdiff_t Kc = K < 16 ? 1 : (K>>4); // = K/16
             const bool twobig = (Mb&&Nb) || (Mb&&Kb) || (Nb&&Kb);
+            const TuningProfile& tune = GetTuning();
 
             TMVStaticAssert(!M3::_rowmajor);
             const bool ccc = M1::_colmajor && M2::_colmajor && M3::_colmajor;
@@ -1563,12 +1558,19 @@ namespace tmv {
             if ( (M < 16 && N < 16 && K < 16) ||
                  (M <= 3 || N <= 3 || K <= 3) ||
                  ( ( M < 16 || N < 16 || K < 16 ) &&
-                   ( !twobig || (Mc * Nc * Kc < TMV_MM_MIN_COPY_ALGO) ) ) )
+                   ( !twobig || (Mc * Nc * Kc < tune.mm_min_copy_algo) ) ) ) {
+                MultMM_Trace<cs,rs,xs,add,M1,M3> trace(algo2,m1,m3);
                 MultMM_Helper<algo2,cs,rs,xs,add,ix,T,M1,M2,M3>::call(
                     x,m1,m2,m3);
+            }
 #ifdef _OPENMP
-            else if (!omp_in_parallel() && (Mb || Nb) && 
-                     ( Mc * Nc * Kc >= TMV_MM_OPENMP_THRESH ) )
+            // Note: omp_in_parallel() is false inside a parallel region
+            // that only has one thread, so we check omp_get_level()
+            // instead.  Otherwise a single-threaded algo 69 would 
+            // come right back here for its sub-product.
+            else if (omp_get_level() == 0 && omp_get_max_threads() > 1 &&
+                     (Mb || Nb || Kb) && 
+                     ( Mc * Nc * Kc >= tune.mm_openmp_thresh ) )
                 MultMM_Helper<69,cs,rs,xs,add,ix,T,M1,M2,M3>::call(x,m1,m2,m3);
 #endif
             else 
@@ -1598,8 +1600,8 @@ namespace tmv {
 #endif
 
 #ifdef TMV_MM_USE_WINOGRAD
-            if (M >= TMV_MM_MIN_WINOGRAD && N >= TMV_MM_MIN_WINOGRAD && 
-                K >= TMV_MM_MIN_WINOGRAD)
+            const ptrdiff_t minwin = GetTuning().mm_min_winograd;
+            if (M >= minwin && N >= minwin && K >= minwin)
                 MultMM_Helper<68,cs,rs,xs,add,ix,T,M1,M2,M3>::call(x,m1,m2,m3);
             else
 #endif
@@ -1620,19 +1622,39 @@ namespace tmv {
                 ','<<cs<<','<<rs<<','<<xs<<','<<T(x)<<std::endl;
 #endif
 
-#ifdef TMV_MM_USE_RECURSIVE_BLOCK
+#if defined(TMV_MM_USE_RECURSIVE_BLOCK) || defined(TMV_MM_USE_PACKED)
             const ptrdiff_t M = cs==Unknown ? m3.colsize() : cs;
             const ptrdiff_t N = rs==Unknown ? m3.rowsize() : rs;
             const ptrdiff_t K = xs==Unknown ? m1.rowsize() : xs;
+#endif
+#ifdef TMV_MM_USE_RECURSIVE_BLOCK
             const ptrdiff_t Mb = (M>>6); // = M/64
             const ptrdiff_t Nb = (N>>6); // = N/64
             const ptrdiff_t Kb = (K>>6); // = K/64
 #endif
 
             TMVStaticAssert(!M3::_rowmajor);
+#if defined(TMV_MM_USE_RECURSIVE_BLOCK) || defined(TMV_MM_USE_PACKED)
+            const TuningProfile& tune = GetTuning();
+#endif
 
+#ifdef TMV_MM_USE_PACKED
+            typedef typename M1::value_type T1;
+            typedef typename M2::value_type T2;
+            typedef typename M3::value_type T3;
+            const bool packable = 
+                !M3::iscomplex && 
+                Traits2<T1,T3>::sametype && Traits2<T2,T3>::sametype;
+            // Make sure algo 65 isn't even instantiated for the others.
+            const int algo65 = packable ? 65 : 64;
+            if (packable && M >= tune.mm_min_packed && 
+                N >= tune.mm_min_packed && K >= tune.mm_min_packed)
+                MultMM_Helper<algo65,cs,rs,xs,add,ix,T,M1,M2,M3>::call(
+                    x,m1,m2,m3);
+            else
+#endif
 #ifdef TMV_MM_USE_RECURSIVE_BLOCK
-            if (Mb*Nb*Kb*Kb >= TMV_MM_MIN_RECURSIVE)
+            if (Mb*Nb*Kb*Kb >= tune.mm_min_recursive)
                 MultMM_Helper<63,cs,rs,xs,add,ix,T,M1,M2,M3>::call(x,m1,m2,m3);
             else
 #endif
@@ -1765,6 +1787,11 @@ namespace tmv {
 
     template <int ix, class T, class M> class ProdXM;
 
+    // Algos 81-83 make a temporary copy, which is destroyed before the
+    // call returns, so each one opens a ScratchScope to take the copy's
+    // memory from the scratch arena rather than the heap.
+    // (See TMV_Array.h)
+
     // algo 81: copy x*m1
     template <ptrdiff_t cs, ptrdiff_t rs, ptrdiff_t xs, bool add, int ix, class T, class M1, class M2, class M3>
     struct MultMM_Helper<81,cs,rs,xs,add,ix,T,M1,M2,M3>
@@ -1772,6 +1799,7 @@ namespace tmv {
         static void call(
             const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
         {
+            MultMM_Trace<cs,rs,xs,add,M1,M3> trace(81,m1,m3);
 #ifdef PRINTALGO_MM
             const ptrdiff_t M = cs == Unknown ? m3.colsize() : cs;
             const ptrdiff_t K = xs == Unknown ? m1.rowsize() : xs;
@@ -1785,6 +1813,7 @@ namespace tmv {
             typedef typename Traits2<T,T1>::type PT1;
             const int A = M2::_colmajor || M3::_rowmajor ? RowMajor : ColMajor;
             typedef typename MCopyHelper<PT1,Rec,cs,xs,A>::type M1c;
+            ScratchScope scope;
             typename M3::noalias_type m3na = m3.noAlias();
             MultMM<add>(one,M1c(ProdXM<ix,T,M1>(x,m1)),m2,m3na);
         }
@@ -1797,6 +1826,7 @@ namespace tmv {
         static void call(
             const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
         {
+            MultMM_Trace<cs,rs,xs,add,M1,M3> trace(82,m1,m3);
 #ifdef PRINTALGO_MM
             const ptrdiff_t M = cs == Unknown ? m3.colsize() : cs;
             const ptrdiff_t N = rs == Unknown ? m3.rowsize() : rs;
@@ -1810,6 +1840,7 @@ namespace tmv {
             typedef typename Traits2<T,T2>::type PT2;
             const int A = M1::_colmajor && M3::_rowmajor ? RowMajor : ColMajor;
             typedef typename MCopyHelper<PT2,Rec,xs,rs,A>::type M2c;
+            ScratchScope scope;
             typename M3::noalias_type m3na = m3.noAlias();
             MultMM<add>(one,m1,M2c(ProdXM<ix,T,M2>(x,m2)),m3na);
         }
@@ -1822,6 +1853,7 @@ namespace tmv {
         static void call(
             const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
         {
+            MultMM_Trace<cs,rs,xs,add,M1,M3> trace(83,m1,m3);
 #ifdef PRINTALGO_MM
             const ptrdiff_t M = cs == Unknown ? m3.colsize() : cs;
             const ptrdiff_t N = rs == Unknown ? m3.rowsize() : rs;
@@ -1834,6 +1866,7 @@ namespace tmv {
             typedef typename Traits2<T1,T2>::type PT3;
             const int A = M1::_rowmajor && M2::_rowmajor ? RowMajor : ColMajor;
             typedef typename MCopyHelper<PT3,Rec,cs,rs,A>::type M3c;
+            ScratchScope scope;
             typename M3::noalias_type m3na = m3.noAlias();
             MultXM<add>(x,M3c(m1*m2),m3na);
         }
@@ -2063,6 +2096,8 @@ namespace tmv {
             // 62 = Simpler loop over M,N,then K in blocks.
             // 63 = Same pattern as 61, but copy m1,m2 into a block structure
             // 64 = Same pattern as 62, but copy m1,m2 into a block structure
+            // 65 = Pack m1,m2 into cache-sized panels and use a 
+            //      register-blocked micro-kernel (real only)
             // 66 = A simple division into 4 submatrices, 
             //      then call another algo.
             // 68 = Alberto and Nicolau's "hybrid Winograd" algorithm
@@ -2124,6 +2159,15 @@ namespace tmv {
             const bool do_recursive = MbNbKb2 >= TMV_MM_MIN_RECURSIVE;
 #else
             const bool do_recursive = false;
+#endif
+#ifdef TMV_MM_USE_PACKED
+            const bool do_packed =
+                !M3::iscomplex &&
+                Traits2<T1,T3>::sametype && Traits2<T2,T3>::sametype &&
+                cs >= TMV_MM_MIN_PACKED && rs >= TMV_MM_MIN_PACKED && 
+                xs >= TMV_MM_MIN_PACKED;
+#else
+            const bool do_packed = false;
 #endif
             const bool do_block = 
                 (cs >= 16 && rs >= 16 && xs >= 16) ||
@@ -2153,6 +2197,7 @@ namespace tmv {
                     71 ) :
                 do_openmp ? 69 :
                 do_winograd ? 68 :
+                do_packed ? 65 :
                 do_recursive ? 63 :
                 do_block ? 64 :
                 // For known sizes, the MultMV calls (algo 11,21) seem 
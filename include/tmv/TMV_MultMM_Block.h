@@ -2187,6 +2187,7 @@ namespace tmv {
             std::cout<<"m2 size = "<<size2<<std::endl;
             std::cout<<"m3 size = "<<size3<<std::endl;
 #endif
+            ScratchScope scope;
             AlignedArray<RT> m1_temp(size1);
             AlignedArray<RT> m2_temp(size2);
             AlignedArray<RT> m3_temp(size3);
@@ -2268,6 +2269,7 @@ namespace tmv {
             std::cout<<"m2 size = "<<size2<<std::endl;
             std::cout<<"m3 size = "<<size3<<std::endl;
 #endif
+            ScratchScope scope;
             AlignedArray<RT> m1_temp(size1);
             AlignedArray<RT> m2_temp(size2);
             AlignedArray<RT> m3_temp(size3);
@@ -2352,6 +2354,7 @@ namespace tmv {
             std::cout<<"m2 size = "<<size2<<std::endl;
             std::cout<<"m3 size = "<<size3<<std::endl;
 #endif
+            ScratchScope scope;
             AlignedArray<RT> m1_temp(size1);
             AlignedArray<RT> m2_temp(size2);
             AlignedArray<RT> m3_temp(size3);
@@ -2424,6 +2427,7 @@ namespace tmv {
             std::cout<<"m2 size = "<<size2<<std::endl;
             std::cout<<"m3 size = "<<size3<<std::endl;
 #endif
+            ScratchScope scope;
             AlignedArray<RT> m1_temp(size1);
             AlignedArray<RT> m2_temp(size2);
             AlignedArray<RT> m3_temp(size3);
@@ -3103,6 +3107,8 @@ namespace tmv {
         const ptrdiff_t size2y = two2*Nc*KB;
         const ptrdiff_t size3 = two3*MB*NB;
 
+        // The block storage comes from the scratch arena. (See TMV_Array.h)
+        ScratchScope scope;
         AlignedArray<RT> m3_temp(size3);
         RT* m3p = m3_temp;
         if (N >= M) {
@@ -29,6 +29,12 @@ namespace tmv {
         const Scaling<ix,T>& x, const BaseMatrix_Rec<M1>& m1,
         const BaseMatrix_Rec<M2>& m2, BaseMatrix_Rec_Mutable<M3>& m3);
 
+    // From TMV_MultMM_Packed.h
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    inline void MultMM_Packed(
+        const Scaling<ix,T>& x, const BaseMatrix_Rec<M1>& m1,
+        const BaseMatrix_Rec<M2>& m2, BaseMatrix_Rec_Mutable<M3>& m3);
+
     // From TMV_MultMM_Winograd.h
     template <bool add, int ix, class T, class M1, class M2, class M3>
     inline void MultMM_Winograd(
@@ -237,6 +243,22 @@ namespace tmv {
         const Scaling<ix,T>& x, const BaseMatrix_Diag<M1>& m1,
         const BaseMatrix_Band<M2>& m2, BaseMatrix_Diag_Mutable<M3>& m3);
 
+    // From TMV_MultSM.h
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    inline void MultMM(
+        const Scaling<ix,T>& x, const BaseMatrix_Sym<M1>& m1,
+        const BaseMatrix_Rec<M2>& m2, BaseMatrix_Rec_Mutable<M3>& m3);
+
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    inline void MultMM(
+        const Scaling<ix,T>& x, const BaseMatrix_Rec<M1>& m1,
+        const BaseMatrix_Sym<M2>& m2, BaseMatrix_Rec_Mutable<M3>& m3);
+
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    inline void MultMM(
+        const Scaling<ix,T>& x, const BaseMatrix_Sym<M1>& m1,
+        const BaseMatrix_Sym<M2>& m2, BaseMatrix_Rec_Mutable<M3>& m3);
+
 
 } // namespace tmv
 
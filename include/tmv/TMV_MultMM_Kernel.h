@@ -1277,6 +1277,72 @@ namespace tmv {
 #define TMV_STATIC 
 #else
 #define TMV_STATIC static
+#endif
+
+#if defined(__AVX__)
+    // If we have AVX commands available, we use the wider registers for 
+    // the blocks where K is a known multiple of the vector length.
+    // See TMV_MultMM_Kernel_AVX.h for the details.
+#ifdef __AVX512F__
+#define TMV_AVX_512
+#endif
+#ifdef __FMA__
+#define TMV_AVX_FMA
+#endif
+#include "TMV_MultMM_Kernel_AVX.h"
+#undef TMV_AVX_512
+#undef TMV_AVX_FMA
+
+    template <ptrdiff_t M2, ptrdiff_t N2, ptrdiff_t K, int ix, class T>
+    static TMV_INLINE bool cpu_multmm_M_N_K(
+        const ptrdiff_t M1, const ptrdiff_t N1,
+        const Scaling<ix,T>& x, const T* A, const T* B, T* C0)
+    { avx_multmm_M_N_K<M2,N2,K>(M1,N1,x,A,B,C0); return true; }
+#define TMV_AVX_KERNELS
+
+#elif defined(TMV_USE_CPU_DISPATCH)
+    // If the library is compiled for a generic cpu with TMV_CPU_DISPATCH,
+    // we compile the AVX kernel twice: once for AVX2 with FMA and once 
+    // for AVX-512.  Then we pick one at run time according to what the
+    // cpu supports.  If neither is supported, cpu_multmm_M_N_K returns
+    // false and the SSE or generic kernel is used instead.
+    namespace avx2 {
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#define TMV_AVX_FMA
+#include "TMV_MultMM_Kernel_AVX.h"
+#undef TMV_AVX_FMA
+#pragma GCC pop_options
+    }
+
+    namespace avx512 {
+#pragma GCC push_options
+#pragma GCC target("avx512f,fma")
+#define TMV_AVX_512
+#define TMV_AVX_FMA
+#include "TMV_MultMM_Kernel_AVX.h"
+#undef TMV_AVX_512
+#undef TMV_AVX_FMA
+#pragma GCC pop_options
+    }
+
+    template <ptrdiff_t M2, ptrdiff_t N2, ptrdiff_t K, int ix, class T>
+    static TMV_INLINE bool cpu_multmm_M_N_K(
+        const ptrdiff_t M1, const ptrdiff_t N1,
+        const Scaling<ix,T>& x, const T* A, const T* B, T* C0)
+    {
+        switch (TMV_CPUArch()) {
+          case CPU_AVX512 :
+               avx512::avx_multmm_M_N_K<M2,N2,K>(M1,N1,x,A,B,C0);
+               return true;
+          case CPU_AVX2 :
+               avx2::avx_multmm_M_N_K<M2,N2,K>(M1,N1,x,A,B,C0);
+               return true;
+          default :
+               return false;
+        }
+    }
+#define TMV_AVX_KERNELS
 #endif
 
     // TODO: This is hard-coded for just float, double, int, and long double.
@@ -3209,21 +3275,36 @@ namespace tmv {
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,float>& x,
         const float* A0, const float* B0, float* C0)
-    { sse_multmm_16_16_16(x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<16,16,16>(16,16,x,A0,B0,C0)) return;
+#endif
+        sse_multmm_16_16_16(x,A0,B0,C0);
+    }
 
     template <int ix>
     TMV_STATIC void multmm_M_16_16(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,float>& x,
         const float* A0, const float* B0, float* C0)
-    { sse_multmm_M_16_16<Unknown>(M,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<Unknown,16,16>(M,16,x,A0,B0,C0)) return;
+#endif
+        sse_multmm_M_16_16<Unknown>(M,x,A0,B0,C0);
+    }
 
     template <int ix>
     TMV_STATIC void multmm_16_N_16(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,float>& x,
         const float* A0, const float* B0, float* C0)
-    { sse_multmm_16_N_16<Unknown>(N,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<16,Unknown,16>(16,N,x,A0,B0,C0)) return;
+#endif
+        sse_multmm_16_N_16<Unknown>(N,x,A0,B0,C0);
+    }
 
     template <int ix>
     TMV_STATIC void multmm_16_16_K(
@@ -3247,42 +3328,72 @@ namespace tmv {
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,float>& x,
         const float* A0, const float* B0, float* C0)
-    { sse_multmm_16_16_32(x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<16,16,32>(16,16,x,A0,B0,C0)) return;
+#endif
+        sse_multmm_16_16_32(x,A0,B0,C0);
+    }
 
     template <int ix>
     TMV_STATIC void multmm_M_16_32(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,float>& x,
         const float* A0, const float* B0, float* C0)
-    { sse_multmm_M_16_32<Unknown>(M,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<Unknown,16,32>(M,16,x,A0,B0,C0)) return;
+#endif
+        sse_multmm_M_16_32<Unknown>(M,x,A0,B0,C0);
+    }
 
     template <int ix>
     TMV_STATIC void multmm_16_N_32(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,float>& x,
         const float* A0, const float* B0, float* C0)
-    { sse_multmm_16_N_32<Unknown>(N,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<16,Unknown,32>(16,N,x,A0,B0,C0)) return;
+#endif
+        sse_multmm_16_N_32<Unknown>(N,x,A0,B0,C0);
+    }
 
     template <int ix>
     TMV_STATIC void multmm_16_16_64(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,float>& x,
         const float* A0, const float* B0, float* C0)
-    { sse_multmm_16_16_64(x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<16,16,64>(16,16,x,A0,B0,C0)) return;
+#endif
+        sse_multmm_16_16_64(x,A0,B0,C0);
+    }
 
     template <int ix>
     TMV_STATIC void multmm_M_16_64(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,float>& x,
         const float* A0, const float* B0, float* C0)
-    { sse_multmm_M_16_64<Unknown>(M,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<Unknown,16,64>(M,16,x,A0,B0,C0)) return;
+#endif
+        sse_multmm_M_16_64<Unknown>(M,x,A0,B0,C0);
+    }
 
     template <int ix>
     TMV_STATIC void multmm_16_N_64(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,float>& x,
         const float* A0, const float* B0, float* C0)
-    { sse_multmm_16_N_64<Unknown>(N,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<16,Unknown,64>(16,N,x,A0,B0,C0)) return;
+#endif
+        sse_multmm_16_N_64<Unknown>(N,x,A0,B0,C0);
+    }
 
 #else
     // If no SSE, then repeat the 16 block version to call generic.
@@ -3332,14 +3443,24 @@ namespace tmv {
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,float>& x, 
         const float* A0, const float* B0, float* C0)
-    { sse_multmm_M_16_16<M2>(M,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<M2,16,16>(M,16,x,A0,B0,C0)) return;
+#endif
+        sse_multmm_M_16_16<M2>(M,x,A0,B0,C0);
+    }
 
     template <ptrdiff_t N2, int ix>
     TMV_INLINE void multmm_16_N_16_known(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,float>& x,
         const float* A0, const float* B0, float* C0)
-    { sse_multmm_16_N_16<N2>(N,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<16,N2,16>(16,N,x,A0,B0,C0)) return;
+#endif
+        sse_multmm_16_N_16<N2>(N,x,A0,B0,C0);
+    }
 
     template <ptrdiff_t K2, int ix>
     TMV_INLINE void multmm_16_16_K_known(
@@ -3353,28 +3474,48 @@ namespace tmv {
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,float>& x,
         const float* A0, const float* B0, float* C0)
-    { sse_multmm_M_16_32<M2>(M,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<M2,16,32>(M,16,x,A0,B0,C0)) return;
+#endif
+        sse_multmm_M_16_32<M2>(M,x,A0,B0,C0);
+    }
 
     template <ptrdiff_t N2, int ix>
     TMV_INLINE void multmm_16_N_32_known(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,float>& x,
         const float* A0, const float* B0, float* C0)
-    { sse_multmm_16_N_32<N2>(N,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<16,N2,32>(16,N,x,A0,B0,C0)) return;
+#endif
+        sse_multmm_16_N_32<N2>(N,x,A0,B0,C0);
+    }
 
     template <ptrdiff_t M2, int ix>
     TMV_INLINE void multmm_M_16_64_known(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,float>& x,
         const float* A0, const float* B0, float* C0)
-    { sse_multmm_M_16_64<M2>(M,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<M2,16,64>(M,16,x,A0,B0,C0)) return;
+#endif
+        sse_multmm_M_16_64<M2>(M,x,A0,B0,C0);
+    }
 
     template <ptrdiff_t N2, int ix>
     TMV_INLINE void multmm_16_N_64_known(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,float>& x,
         const float* A0, const float* B0, float* C0)
-    { sse_multmm_16_N_64<N2>(N,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<16,N2,64>(16,N,x,A0,B0,C0)) return;
+#endif
+        sse_multmm_16_N_64<N2>(N,x,A0,B0,C0);
+    }
 
 #else
     template <ptrdiff_t M2, int ix>
@@ -4968,42 +5109,72 @@ namespace tmv {
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,double>& x,
         const double* A0, const double* B0, double* C0)
-    { sse2_multmm_16_16_16(x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<16,16,16>(16,16,x,A0,B0,C0)) return;
+#endif
+        sse2_multmm_16_16_16(x,A0,B0,C0);
+    }
 
     template <int ix>
     TMV_STATIC void multmm_16_16_32(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,double>& x,
         const double* A0, const double* B0, double* C0)
-    { sse2_multmm_16_16_32(x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<16,16,32>(16,16,x,A0,B0,C0)) return;
+#endif
+        sse2_multmm_16_16_32(x,A0,B0,C0);
+    }
 
     template <int ix>
     TMV_STATIC void multmm_M_16_16(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,double>& x,
         const double* A0, const double* B0, double* C0)
-    { sse2_multmm_M_16_16<Unknown>(M,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<Unknown,16,16>(M,16,x,A0,B0,C0)) return;
+#endif
+        sse2_multmm_M_16_16<Unknown>(M,x,A0,B0,C0);
+    }
 
     template <int ix>
     TMV_STATIC void multmm_M_16_32(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,double>& x,
         const double* A0, const double* B0, double* C0)
-    { sse2_multmm_M_16_32<Unknown>(M,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<Unknown,16,32>(M,16,x,A0,B0,C0)) return;
+#endif
+        sse2_multmm_M_16_32<Unknown>(M,x,A0,B0,C0);
+    }
 
     template <int ix>
     TMV_STATIC void multmm_16_N_16(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,double>& x,
         const double* A0, const double* B0, double* C0)
-    { sse2_multmm_16_N_16<Unknown>(N,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<16,Unknown,16>(16,N,x,A0,B0,C0)) return;
+#endif
+        sse2_multmm_16_N_16<Unknown>(N,x,A0,B0,C0);
+    }
 
     template <int ix>
     TMV_STATIC void multmm_16_N_32(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,double>& x,
         const double* A0, const double* B0, double* C0)
-    { sse2_multmm_16_N_32<Unknown>(N,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<16,Unknown,32>(16,N,x,A0,B0,C0)) return;
+#endif
+        sse2_multmm_16_N_32<Unknown>(N,x,A0,B0,C0);
+    }
 
     template <int ix>
     TMV_STATIC void multmm_16_16_K(
@@ -5069,28 +5240,48 @@ namespace tmv {
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,double>& x,
         const double* A0, const double* B0, double* C0)
-    { sse2_multmm_M_16_16<M2>(M,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<M2,16,16>(M,16,x,A0,B0,C0)) return;
+#endif
+        sse2_multmm_M_16_16<M2>(M,x,A0,B0,C0);
+    }
 
     template <ptrdiff_t M2, int ix>
     TMV_INLINE void multmm_M_16_32_known(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,double>& x,
         const double* A0, const double* B0, double* C0)
-    { sse2_multmm_M_16_32<M2>(M,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<M2,16,32>(M,16,x,A0,B0,C0)) return;
+#endif
+        sse2_multmm_M_16_32<M2>(M,x,A0,B0,C0);
+    }
 
     template <ptrdiff_t N2, int ix>
     TMV_INLINE void multmm_16_N_16_known(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,double>& x,
         const double* A0, const double* B0, double* C0)
-    { sse2_multmm_16_N_16<N2>(N,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<16,N2,16>(16,N,x,A0,B0,C0)) return;
+#endif
+        sse2_multmm_16_N_16<N2>(N,x,A0,B0,C0);
+    }
 
     template <ptrdiff_t N2, int ix>
     TMV_INLINE void multmm_16_N_32_known(
         const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
         const Scaling<ix,double>& x,
         const double* A0, const double* B0, double* C0)
-    { sse2_multmm_16_N_32<N2>(N,x,A0,B0,C0); }
+    {
+#ifdef TMV_AVX_KERNELS
+        if (cpu_multmm_M_N_K<16,N2,32>(16,N,x,A0,B0,C0)) return;
+#endif
+        sse2_multmm_16_N_32<N2>(N,x,A0,B0,C0);
+    }
 
     template <ptrdiff_t K2, int ix>
     TMV_INLINE void multmm_16_16_K_known(
@@ -0,0 +1,199 @@
+// This file has the AVX version of the block matrix product kernel
+// that is used by TMV_MultMM_Kernel.h for the blocks where K is a known 
+// multiple of the vector length.  (i.e. the 16, 32 and 64 K blocks.  
+// The K cleanup still uses the SSE or generic versions.)
+//
+// The storage of the blocks is the same as for the SSE kernels:
+// A is stored by rows and B by columns, each with a stride of K, 
+// and C is column major with a stride of M.  So each element of C is 
+// the dot product of two contiguous runs of K values.  We accumulate
+// a 2x2 block of these in vector registers and then sum across the
+// vector at the end.
+//
+// If TMV_AVX_512 is defined, the same kernel is used with 512 bit 
+// registers.  If TMV_AVX_FMA is defined, we use the fused multiply-add
+// commands.
+//
+// Complex products don't need anything special here, since the 
+// block algorithms in TMV_MultMM_Block.h split complex matrices into
+// their real and imaginary parts before calling the kernels.
+//
+// Note: there is intentionally no include guard here.  When the library
+// is compiled with TMV_CPU_DISPATCH, this file is included once for 
+// each instruction set inside its own namespace, so all the versions 
+// can coexist and the best one is chosen at run time.
+
+    template <class T>
+    struct AVX_Helper;
+
+    template <>
+    struct AVX_Helper<float>
+    {
+#ifdef TMV_AVX_512
+        typedef __m512 vec;
+        enum { size = 16 };
+        static TMV_INLINE vec zero() 
+        { return _mm512_setzero_ps(); }
+        static TMV_INLINE vec load(const float* p) 
+        { return _mm512_loadu_ps(p); }
+        static TMV_INLINE vec fma(const vec& a, const vec& b, const vec& c)
+        { return _mm512_fmadd_ps(a,b,c); }
+        static TMV_INLINE float sum(const vec& a) 
+        { return _mm512_reduce_add_ps(a); }
+#else
+        typedef __m256 vec;
+        enum { size = 8 };
+        static TMV_INLINE vec zero() 
+        { return _mm256_setzero_ps(); }
+        static TMV_INLINE vec load(const float* p) 
+        { return _mm256_loadu_ps(p); }
+        static TMV_INLINE vec fma(const vec& a, const vec& b, const vec& c)
+        {
+#ifdef TMV_AVX_FMA
+            return _mm256_fmadd_ps(a,b,c); 
+#else
+            return _mm256_add_ps(_mm256_mul_ps(a,b),c); 
+#endif
+        }
+        static TMV_INLINE float sum(const vec& a) 
+        {
+            __m128 s = _mm_add_ps(
+                _mm256_castps256_ps128(a),_mm256_extractf128_ps(a,1));
+            s = _mm_add_ps(s,_mm_movehl_ps(s,s));
+            s = _mm_add_ss(s,_mm_shuffle_ps(s,s,1));
+            return _mm_cvtss_f32(s);
+        }
+#endif
+    };
+
+    template <>
+    struct AVX_Helper<double>
+    {
+#ifdef TMV_AVX_512
+        typedef __m512d vec;
+        enum { size = 8 };
+        static TMV_INLINE vec zero() 
+        { return _mm512_setzero_pd(); }
+        static TMV_INLINE vec load(const double* p) 
+        { return _mm512_loadu_pd(p); }
+        static TMV_INLINE vec fma(const vec& a, const vec& b, const vec& c)
+        { return _mm512_fmadd_pd(a,b,c); }
+        static TMV_INLINE double sum(const vec& a) 
+        { return _mm512_reduce_add_pd(a); }
+#else
+        typedef __m256d vec;
+        enum { size = 4 };
+        static TMV_INLINE vec zero() 
+        { return _mm256_setzero_pd(); }
+        static TMV_INLINE vec load(const double* p) 
+        { return _mm256_loadu_pd(p); }
+        static TMV_INLINE vec fma(const vec& a, const vec& b, const vec& c)
+        {
+#ifdef TMV_AVX_FMA
+            return _mm256_fmadd_pd(a,b,c); 
+#else
+            return _mm256_add_pd(_mm256_mul_pd(a,b),c); 
+#endif
+        }
+        static TMV_INLINE double sum(const vec& a) 
+        {
+            __m128d s = _mm_add_pd(
+                _mm256_castpd256_pd128(a),_mm256_extractf128_pd(a,1));
+            s = _mm_add_sd(s,_mm_unpackhi_pd(s,s));
+            return _mm_cvtsd_f64(s);
+        }
+#endif
+    };
+
+    template <ptrdiff_t M2, ptrdiff_t N2, ptrdiff_t K, int ix, class T>
+    static void avx_multmm_M_N_K(
+        const ptrdiff_t M1, const ptrdiff_t N1,
+        const Scaling<ix,T>& x, const T* A, const T* B, T* C0)
+    {
+        typedef AVX_Helper<T> AVX;
+        typedef typename AVX::vec vec;
+        const ptrdiff_t nv = AVX::size;
+        TMVStaticAssert(K % nv == 0);
+
+        const ptrdiff_t M = (M2 == Unknown ? M1 : M2);
+        const ptrdiff_t N = (N2 == Unknown ? N1 : N2);
+        const ptrdiff_t M_2 = M>>1;        // = M/2
+        const ptrdiff_t Mc = M-(M_2<<1);   // = M%2
+        const ptrdiff_t N_2 = N>>1;        // = N/2
+        const ptrdiff_t Nc = N-(N_2<<1);   // = N%2
+        const ptrdiff_t Kx2 = K<<1;        // = K*2
+
+        vec a0, a1, b0, b1;
+        vec C00, C01, C10, C11;
+
+        const T* A0;
+        const T* B0 = B;
+        T* C1 = C0 + M;
+
+        ptrdiff_t i,j,k;
+
+        j = N_2; if (j) do {
+            A0 = A;
+            i = M_2; if (i) do {
+                C00 = C01 = C10 = C11 = AVX::zero();
+                for (k=0; k<K; k+=nv) {
+                    a0 = AVX::load(A0+k);
+                    a1 = AVX::load(A0+K+k);
+                    b0 = AVX::load(B0+k);
+                    b1 = AVX::load(B0+K+k);
+                    C00 = AVX::fma(a0,b0,C00);
+                    C10 = AVX::fma(a1,b0,C10);
+                    C01 = AVX::fma(a0,b1,C01);
+                    C11 = AVX::fma(a1,b1,C11);
+                }
+                C0[0] += x * AVX::sum(C00);
+                C0[1] += x * AVX::sum(C10);
+                C1[0] += x * AVX::sum(C01);
+                C1[1] += x * AVX::sum(C11);
+                A0 += Kx2;
+                C0 += 2;
+                C1 += 2;
+            } while (--i);
+            if (Mc) {
+                C00 = C01 = AVX::zero();
+                for (k=0; k<K; k+=nv) {
+                    a0 = AVX::load(A0+k);
+                    b0 = AVX::load(B0+k);
+                    b1 = AVX::load(B0+K+k);
+                    C00 = AVX::fma(a0,b0,C00);
+                    C01 = AVX::fma(a0,b1,C01);
+                }
+                *C0++ += x * AVX::sum(C00);
+                *C1++ += x * AVX::sum(C01);
+            }
+            B0 += Kx2;
+            C0 += M;
+            C1 += M;
+        } while (--j);
+        if (Nc) {
+            A0 = A;
+            i = M_2; if (i) do {
+                C00 = C10 = AVX::zero();
+                for (k=0; k<K; k+=nv) {
+                    a0 = AVX::load(A0+k);
+                    a1 = AVX::load(A0+K+k);
+                    b0 = AVX::load(B0+k);
+                    C00 = AVX::fma(a0,b0,C00);
+                    C10 = AVX::fma(a1,b0,C10);
+                }
+                C0[0] += x * AVX::sum(C00);
+                C0[1] += x * AVX::sum(C10);
+                A0 += Kx2;
+                C0 += 2;
+            } while (--i);
+            if (Mc) {
+                C00 = AVX::zero();
+                for (k=0; k<K; k+=nv) {
+                    a0 = AVX::load(A0+k);
+                    b0 = AVX::load(B0+k);
+                    C00 = AVX::fma(a0,b0,C00);
+                }
+                *C0 += x * AVX::sum(C00);
+            }
+        }
+    }
@@ -5,6 +5,10 @@
 
 #include "TMV_BaseMatrix_Rec.h"
 #include "TMV_MultMM.h"
+#include "TMV_MultMM_Packed.h"
+#include "TMV_MultXM.h"
+#include "TMV_Array.h"
+#include <vector>
 
 namespace tmv {
 
@@ -24,25 +28,280 @@ namespace tmv {
     // Algo 69: OpenMPMultMM
     //
 
+    // The target number of tiles for each thread.  Having several
+    // tiles per thread lets the threads that finish early pick up 
+    // the slack from the others.
+#ifndef TMV_MM_OPENMP_TILES_PER_THREAD
+#define TMV_MM_OPENMP_TILES_PER_THREAD 4
+#endif
+
+    // The minimum tile size in M and N.  Smaller tiles are not 
+    // efficient for the block and packed algorithms that do the work
+    // for each tile.
+#ifndef TMV_MM_OPENMP_MIN_TILE
+#define TMV_MM_OPENMP_MIN_TILE 64
+#endif
+
+    // The minimum tile size in K when we need to split K as well.
+    // Each of these tiles needs its own temporary copy of the m3 tile,
+    // and then a (locked) addition into m3, so we don't want them to 
+    // be too small.
+#ifndef TMV_MM_OPENMP_MIN_KTILE
+#define TMV_MM_OPENMP_MIN_KTILE 256
+#endif
+
+    // Choose the tile sizes MT, NT, KT for splitting an M x N x K 
+    // product among nthreads threads.
+    // We keep halving the larger of MT,NT until we have enough tiles,
+    // or the tiles would get smaller than TMV_MM_OPENMP_MIN_TILE.
+    // If that still doesn't give each thread at least one tile (e.g.
+    // for a small M x N result with a very large K), then we split K 
+    // as well.  Tile sizes are kept to multiples of 16 to maximize the 
+    // efficiency of blocking in each tile.
+    inline void MultMM_OpenMP_Tiles(
+        const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
+        const int nthreads, ptrdiff_t& MT, ptrdiff_t& NT, ptrdiff_t& KT)
+    {
+        const ptrdiff_t mint = TMV_MM_OPENMP_MIN_TILE;
+        const ptrdiff_t target = 
+            ptrdiff_t(nthreads) * TMV_MM_OPENMP_TILES_PER_THREAD;
+        MT = M; NT = N; KT = K;
+        ptrdiff_t nm = 1, nn = 1;
+        while (nm * nn < target) {
+            if (MT >= NT && MT >= 2*mint) 
+                MT = ((((MT+1)/2-1)>>4)+1)<<4;
+            else if (NT >= 2*mint) 
+                NT = ((((NT+1)/2-1)>>4)+1)<<4;
+            else if (MT >= 2*mint) 
+                MT = ((((MT+1)/2-1)>>4)+1)<<4;
+            else break;
+            nm = (M+MT-1)/MT;
+            nn = (N+NT-1)/NT;
+        }
+        if (nm * nn < nthreads) {
+            ptrdiff_t nk = (target + nm*nn - 1) / (nm*nn);
+            nk = TMV_MIN(nk, K/TMV_MM_OPENMP_MIN_KTILE);
+            if (nk > 1) KT = ((((K+nk-1)/nk-1)>>4)+1)<<4;
+        }
+    }
+
+    // A work-stealing queue of tiles.
+    // Each thread starts out owning a contiguous range of the tiles.  
+    // It takes tiles from the front of its own range, and when that is 
+    // empty, it steals tiles from the back of the other threads' ranges.
+    // Neighboring tiles share the same rows of m1 or columns of m2,
+    // so each thread mostly works on nearby memory, and the stealing
+    // balances the load when some tiles (or threads) are slower than 
+    // others.
+    class MultMM_TileQueue
+    {
+    public :
+        MultMM_TileQueue(const ptrdiff_t ntiles, const int nthreads) :
+            nt(nthreads), q(new Range[nthreads])
+        {
+            for (int i=0; i<nt; ++i) {
+                q[i].begin = ntiles * i / nt;
+                q[i].end = ntiles * (i+1) / nt;
+                omp_init_lock(&q[i].lock);
+            }
+        }
+        ~MultMM_TileQueue()
+        {
+            for (int i=0; i<nt; ++i) omp_destroy_lock(&q[i].lock);
+            delete [] q;
+        }
+
+        // Return the next tile for thread mythread to do, or -1 if 
+        // there are none left.
+        ptrdiff_t next(const int mythread)
+        {
+            ptrdiff_t t = -1;
+            Range& mine = q[mythread];
+            omp_set_lock(&mine.lock);
+            if (mine.begin < mine.end) t = mine.begin++;
+            omp_unset_lock(&mine.lock);
+            for (int i=1; t < 0 && i<nt; ++i) {
+                Range& other = q[(mythread+i) % nt];
+                omp_set_lock(&other.lock);
+                if (other.begin < other.end) t = --other.end;
+                omp_unset_lock(&other.lock);
+            }
+            return t;
+        }
+
+    private :
+        // Pad each range to its own cache line, so the threads aren't 
+        // fighting over the same line when they take their own tiles.
+        struct Range
+        {
+            ptrdiff_t begin, end;
+            omp_lock_t lock;
+            char pad[64];
+        };
+        const int nt;
+        Range* q;
+
+        MultMM_TileQueue(const MultMM_TileQueue& );
+        MultMM_TileQueue& operator=(const MultMM_TileQueue& );
+    };
+
+    // The work done by each thread for one tile.
+    // The packable version (real matrices that all have the same type)
+    // calls the packed algorithm directly, so each thread can reuse 
+    // its packed buffers for all the tiles it does.
+    // Otherwise, each tile calls algo1 as a normal sub-product.
+    template <bool packable, int algo1, bool add, int ix, class T, class M1, class M2, class M3>
+    struct MultMM_OpenMP_Worker;
+
+    template <int algo1, bool add, int ix, class T, class M1, class M2, class M3>
+    struct MultMM_OpenMP_Worker<true,algo1,add,ix,T,M1,M2,M3>
+    {
+        typedef typename M3::value_type T3;
+        const T3 x;
+        const M1& m1;
+        const M2& m2;
+        M3& m3;
+        MultMM_Packed_Workspace<T3> ws;
+        AlignedArray<T3> temp;
+        ptrdiff_t ntemp;
+
+        MultMM_OpenMP_Worker(
+            const Scaling<ix,T>& _x, const M1& _m1, const M2& _m2, M3& _m3) :
+            x(Traits<T3>::convert(T(_x))), m1(_m1), m2(_m2), m3(_m3), 
+            ntemp(0) {}
+
+        // If ksplit, then this is only part of the K sum, so we do the 
+        // product into a temporary and add it to m3 under the lock.
+        void tile(
+            const ptrdiff_t i1, const ptrdiff_t i2, 
+            const ptrdiff_t j1, const ptrdiff_t j2,
+            const ptrdiff_t k1, const ptrdiff_t k2, 
+            const bool ksplit, omp_lock_t* lock)
+        {
+            const ptrdiff_t mt = i2-i1, nt = j2-j1, kt = k2-k1;
+            const ptrdiff_t Asi = m1.stepi(), Asj = m1.stepj();
+            const ptrdiff_t Bsi = m2.stepi(), Bsj = m2.stepj();
+            const ptrdiff_t Csi = m3.stepi(), Csj = m3.stepj();
+            const T3* A = m1.cptr() + i1*Asi + k1*Asj;
+            const T3* B = m2.cptr() + k1*Bsi + j1*Bsj;
+            T3* C = m3.ptr() + i1*Csi + j1*Csj;
+            if (!ksplit) {
+                if (!add) 
+                    for (ptrdiff_t j=0; j<nt; ++j) 
+                        for (ptrdiff_t i=0; i<mt; ++i) 
+                            C[i*Csi+j*Csj] = T3(0);
+                MultMM_PackedCalc(
+                    ws,mt,nt,kt,x,A,Asi,Asj,B,Bsi,Bsj,C,Csi,Csj);
+            } else {
+                if (mt*nt > ntemp) { temp.resize(mt*nt); ntemp = mt*nt; }
+                T3* Ct = temp.get();
+                for (ptrdiff_t i=0; i<mt*nt; ++i) Ct[i] = T3(0);
+                MultMM_PackedCalc(ws,mt,nt,kt,x,A,Asi,Asj,B,Bsi,Bsj,Ct,1,mt);
+                omp_set_lock(lock);
+                for (ptrdiff_t j=0; j<nt; ++j) 
+                    for (ptrdiff_t i=0; i<mt; ++i) 
+                        C[i*Csi+j*Csj] += Ct[j*mt+i];
+                omp_unset_lock(lock);
+            }
+        }
+    };
+
+    template <int algo1, bool add, int ix, class T, class M1, class M2, class M3>
+    struct MultMM_OpenMP_Worker<false,algo1,add,ix,T,M1,M2,M3>
+    {
+        typedef typename M3::value_type T3;
+        typedef typename Traits<T3>::real_type RT;
+        const Scaling<ix,T>& x;
+        const M1& m1;
+        const M2& m2;
+        M3& m3;
+
+        MultMM_OpenMP_Worker(
+            const Scaling<ix,T>& _x, const M1& _m1, const M2& _m2, M3& _m3) :
+            x(_x), m1(_m1), m2(_m2), m3(_m3) {}
+
+        void tile(
+            const ptrdiff_t i1, const ptrdiff_t i2, 
+            const ptrdiff_t j1, const ptrdiff_t j2,
+            const ptrdiff_t k1, const ptrdiff_t k2, 
+            const bool ksplit, omp_lock_t* lock)
+        {
+            typedef typename M1::const_submatrix_type M1s;
+            typedef typename M2::const_submatrix_type M2s;
+            typedef typename M3::submatrix_type M3s;
+            const ptrdiff_t xx = Unknown;
+            M1s m1s = m1.cSubMatrix(i1,i2,k1,k2);
+            M2s m2s = m2.cSubMatrix(k1,k2,j1,j2);
+            M3s m3s = m3.cSubMatrix(i1,i2,j1,j2);
+            if (!ksplit) {
+                MultMM_Helper<algo1,xx,xx,xx,add,ix,T,M1s,M2s,M3s>::call(
+                    x,m1s,m2s,m3s);
+            } else {
+                typedef Matrix<T3,ColMajor|NoDivider|NoAlias> Mt;
+                typedef typename Mt::view_type Mtv;
+                Mt temp(i2-i1,j2-j1);
+                Mtv tempv = temp.view();
+                MultMM_Helper<algo1,xx,xx,xx,false,ix,T,M1s,M2s,Mtv>::call(
+                    x,m1s,m2s,tempv);
+                omp_set_lock(lock);
+                MultXM<true>(Scaling<1,RT>(),temp,m3s);
+                omp_unset_lock(lock);
+            }
+        }
+    };
+
     template <int algo, ptrdiff_t cs, ptrdiff_t rs, ptrdiff_t xs, bool add, int ix, class T, class M1, class M2, class M3>
     struct MultMM_OpenMP_Helper;
 
-    // algo 69: Split the output matrix, m3, into strips.  
-    // Use either row strips or columns strips according to whether there
-    // are more rows or columns.  Also, round each strip up to a multiple 
-    // of 16 rows or columns to maximize the efficiency of blocking in 
-    // each section.
-    // Then call the normal block algorithm for each section.
+    // algo 69: Split the product into 2D tiles of m3 (or 3D tiles, 
+    // also splitting K, when there aren't enough 2D tiles for all the 
+    // threads).  See MultMM_OpenMP_Tiles for how the tile sizes are
+    // chosen.  The threads take tiles from a work-stealing queue
+    // until they are all done.
     template <ptrdiff_t cs, ptrdiff_t rs, ptrdiff_t xs, bool add, int ix, class T, class M1, class M2, class M3>
     struct MultMM_OpenMP_Helper<69,cs,rs,xs,add,ix,T,M1,M2,M3>
     {
+        // The tiles are numbered with k varying fastest, then i, 
+        // then j, so each thread's initial range is a compact set of
+        // tiles with nearby data.
+        template <class Worker>
+        static void doTiles(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3,
+            const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
+            const ptrdiff_t MT, const ptrdiff_t NT, const ptrdiff_t KT,
+            const int nthreads, std::vector<omp_lock_t>& locks)
+        {
+            const ptrdiff_t nm = (M+MT-1)/MT;
+            const ptrdiff_t nn = (N+NT-1)/NT;
+            const ptrdiff_t nk = (K+KT-1)/KT;
+            const bool ksplit = nk > 1;
+            MultMM_TileQueue queue(nm*nn*nk,nthreads);
+#pragma omp parallel num_threads(nthreads)
+            {
+                const int mythread = omp_get_thread_num();
+                Worker worker(x,m1,m2,m3);
+                for (ptrdiff_t t; (t = queue.next(mythread)) >= 0; ) {
+                    const ptrdiff_t k = t % nk;
+                    const ptrdiff_t ij = t / nk;
+                    const ptrdiff_t i = ij % nm;
+                    const ptrdiff_t j = ij / nm;
+                    const ptrdiff_t i1 = i*MT, i2 = TMV_MIN(M,i1+MT);
+                    const ptrdiff_t j1 = j*NT, j2 = TMV_MIN(N,j1+NT);
+                    const ptrdiff_t k1 = k*KT, k2 = TMV_MIN(K,k1+KT);
+                    worker.tile(
+                        i1,i2,j1,j2,k1,k2,ksplit,
+                        ksplit ? &locks[ij] : 0);
+                }
+            }
+        }
+
         static void call(
             const Scaling<ix,T> x, const M1& m1, const M2& m2, M3& m3)
         {
             const ptrdiff_t M = cs==Unknown ? m3.colsize() : cs;
             const ptrdiff_t N = rs==Unknown ? m3.rowsize() : rs;
-#ifdef PRINTALGO_MM
             const ptrdiff_t K = xs==Unknown ? m1.rowsize() : xs;
+#ifdef PRINTALGO_MM
             std::cout<<"MM algo 69: M,N,K,cs,rs,xs,x = "<<M<<','<<N<<','<<K<<
                 ','<<cs<<','<<rs<<','<<xs<<','<<T(x)<<std::endl;
 #endif
@@ -67,17 +326,27 @@ namespace tmv {
 #endif
                 Traits<T3>::isinst;
 
+#ifdef TMV_MM_USE_PACKED
+            const bool packable = 
+                !M3::iscomplex &&
+                Traits2<T1,T3>::sametype && Traits2<T2,T3>::sametype;
+#else
+            const bool packable = false;
+#endif
+
             // If we are in this function, then we pretty much know that 
             // we want to do one of the large matrix algorithms (63,64,68)
             // for the sub-problems.  So we call algo 72 to determine which
             // one to use.  
             // The algo1 selection here mimics that selection
             // when the sizes are known.
-            // It's not perfect, since it uses the unthreaded M,N,K, rather
-            // than either M/nthreads or N/nthreads, but it should usually
-            // select a pretty good algorithm, and it keeps the 
-            // compiler from instantiating the three possible algorithms
-            // due to the if statements in algo 72.
+            // It's not perfect, since it uses the full M,N,K, rather
+            // than the tile sizes, but it should usually select a 
+            // pretty good algorithm, and it keeps the compiler from 
+            // instantiating the three possible algorithms due to the 
+            // if statements in algo 72.
+            // (The packable case only uses algo1 when there is just 
+            // one thread.)
             const int algo1 = 
                 inst ? -2 : 
                 (cs == Unknown || rs == Unknown || xs == Unknown) ? 72 :
@@ -90,49 +359,40 @@ namespace tmv {
 #endif
                 64;
 
-#pragma omp parallel
-            {
-                int num_threads = omp_get_num_threads();
-                int mythread = omp_get_thread_num();
-                if (num_threads == 1) {
-                    MultMM_Helper<algo1,cs,rs,xs,add,ix,T,M1,M2,M3>::call(
-                        x,m1,m2,m3);
-                } else if (M > N) {
-                    ptrdiff_t Mx = M / num_threads;
-                    Mx = ((((Mx-1)>>4)+1)<<4); // round up to mult of 16
-                    ptrdiff_t i1 = mythread * Mx;
-                    ptrdiff_t i2 = (mythread+1) * Mx;
-                    if (i2 > M || mythread == num_threads-1) i2 = M;
-                    if (i1 < M) {
-                        // Need to make sure, since we rounded up Mx!
-                        typedef typename M1::const_rowrange_type M1r;
-                        typedef typename M3::rowrange_type M3r;
-                        const ptrdiff_t csx = Unknown; 
-                        M1r m1r = m1.cRowRange(i1,i2);
-                        M3r m3r = m3.cRowRange(i1,i2);
-
-                        MultMM_Helper<
-                            algo1,csx,rs,xs,add,ix,T,M1r,M2,M3r>::call(
-                                x,m1r,m2,m3r);
-                    }
-                } else {
-                    ptrdiff_t Nx = N / num_threads;
-                    Nx = ((((Nx-1)>>4)+1)<<4); 
-                    ptrdiff_t j1 = mythread * Nx;
-                    ptrdiff_t j2 = (mythread+1) * Nx;
-                    if (j2 > N || mythread == num_threads-1) j2 = N;
-                    if (j1 < N)  {
-                        typedef typename M2::const_colrange_type M2c;
-                        typedef typename M3::colrange_type M3c;
-                        const ptrdiff_t rsx = Unknown; 
-                        M2c m2c = m2.cColRange(j1,j2);
-                        M3c m3c = m3.cColRange(j1,j2);
-                        MultMM_Helper<
-                            algo1,cs,rsx,xs,add,ix,T,M1,M2c,M3c>::call(
-                                x,m1,m2c,m3c);
-                    }
-                }
+            const int nthreads = omp_get_max_threads();
+            if (nthreads == 1 || M == 0 || N == 0 || K == 0) {
+                MultMM_Helper<algo1,cs,rs,xs,add,ix,T,M1,M2,M3>::call(
+                    x,m1,m2,m3);
+                return;
             }
+
+            ptrdiff_t MT, NT, KT;
+            MultMM_OpenMP_Tiles(M,N,K,nthreads,MT,NT,KT);
+            const ptrdiff_t nm = (M+MT-1)/MT;
+            const ptrdiff_t nn = (N+NT-1)/NT;
+            const ptrdiff_t nk = (K+KT-1)/KT;
+            const bool ksplit = nk > 1;
+#ifdef PRINTALGO_MM
+            std::cout<<"MM algo 69: tiles = "<<MT<<" x "<<NT<<" x "<<KT<<
+                " ("<<nm*nn*nk<<" tiles for "<<nthreads<<" threads)\n";
+#endif
+
+            // When K is split, all the K tiles add into m3, so start with 
+            // m3 = 0 if !add.  Each m3 tile gets a lock for the additions.
+            if (ksplit && !add) m3.setZero();
+            std::vector<omp_lock_t> locks(ksplit ? nm*nn : 0);
+            for (size_t i=0; i<locks.size(); ++i) omp_init_lock(&locks[i]);
+
+            if (add || ksplit)
+                doTiles<MultMM_OpenMP_Worker<
+                    packable,algo1,true,ix,T,M1,M2,M3> >(
+                        x,m1,m2,m3,M,N,K,MT,NT,KT,nthreads,locks);
+            else
+                doTiles<MultMM_OpenMP_Worker<
+                    packable,algo1,false,ix,T,M1,M2,M3> >(
+                        x,m1,m2,m3,M,N,K,MT,NT,KT,nthreads,locks);
+
+            for (size_t i=0; i<locks.size(); ++i) omp_destroy_lock(&locks[i]);
         }
     };
 
@@ -0,0 +1,537 @@
+
+
+#ifndef TMV_MultMM_Packed_H
+#define TMV_MultMM_Packed_H
+
+#include "TMV_BaseMatrix_Rec.h"
+#include "TMV_MultXM_Funcs.h"
+#include "TMV_MultMM_Funcs.h"
+#include "TMV_Array.h"
+#include "TMV_Tuning.h"
+
+#ifdef PRINTALGO_MM
+#include <iostream>
+#endif
+
+// This file has the packed panel algorithm for large real matrix
+// products.  It is the same basic idea as the algorithms in GotoBLAS
+// and BLIS.  The calculation is broken up as follows:
+//
+// for jc = 0..N step NC          (NC columns of B and C)
+//   for pc = 0..K step KC        (KC x NC panel of B -> packed, L3 cache)
+//     for ic = 0..M step MC      (MC x KC panel of A -> packed, L2 cache)
+//       for jr = 0..NC step NR   (KC x NR sliver of B stays in L1)
+//         for ir = 0..MC step MR
+//           C(MR x NR) += x * A(MR x KC) * B(KC x NR)  (micro-kernel)
+//
+// The packed copies store each MR x KC sliver of A and each KC x NR
+// sliver of B contiguously in the order the micro-kernel reads them,
+// so the inner loop only ever reads sequential memory.  The slivers
+// on the edges are padded with zeros, so the micro-kernel is always
+// called with full MR x NR blocks.  When the block of C is not a full
+// MR x NR block, the kernel writes to a small temporary, which is
+// then added to C.
+//
+// The values of MC, KC, NC are set by MultMM_Packed_Sizes<T> below,
+// which can be specialized for a particular type if you want to tune
+// them for your machine.  MR and NR are set by the micro-kernel.
+// For float and double with SSE or AVX, this is 2 vector registers
+// by 6 columns.  (See TMV_MultMM_Packed_Kernel.h.)  Other real types
+// use a generic 4x4 kernel.
+//
+// This algorithm is only for real matrices where all three have the
+// same type.  Complex and mixed type products are sent to the regular
+// block algorithm (algo 64 in TMV_MultMM.h).
+
+// The minimum value of M, N and K to use the packed algorithm is
+// TMV_MM_MIN_PACKED, whose default is in TMV_Tuning.h.
+
+namespace tmv {
+
+    // Defined in TMV_MultMM_Packed.cpp
+    template <class T1, int C1, class T2, int C2, class T3>
+    void InstMultMM_Packed(
+        const T3 x,
+        const ConstMatrixView<T1,C1>& m1,
+        const ConstMatrixView<T2,C2>& m2, MatrixView<T3> m3);
+    template <class T1, int C1, class T2, int C2, class T3>
+    void InstAddMultMM_Packed(
+        const T3 x,
+        const ConstMatrixView<T1,C1>& m1,
+        const ConstMatrixView<T2,C2>& m2, MatrixView<T3> m3);
+
+    // The cache blocking parameters:
+    // MC x KC values of A should fit comfortably in the L2 cache.
+    // KC x NC values of B should fit in the L3 cache.
+    // And KC x NR values of B should fit in the L1 cache alongside
+    // the MR x KC sliver of A currently being used.
+    // MC is rounded down to a multiple of MR and NC to a multiple of NR
+    // when they are used, so the values here don't need to be exact
+    // multiples of any particular kernel size.
+    template <class T>
+    struct MultMM_Packed_Sizes
+    { enum { MC = 96, KC = 256, NC = 4080 }; };
+    template <>
+    struct MultMM_Packed_Sizes<float>
+    { enum { MC = 192, KC = 256, NC = 4080 }; };
+    template <>
+    struct MultMM_Packed_Sizes<double>
+    { enum { MC = 96, KC = 256, NC = 4080 }; };
+
+    // The generic micro-kernel for any type.
+    template <class T, int MR, int NR>
+    static void generic_packed_kernel(
+        const ptrdiff_t K, const T* A, const T* B, T* C,
+        const ptrdiff_t ldc, const T x)
+    {
+        T c[MR*NR];
+        for (int i=0; i<MR*NR; ++i) c[i] = T(0);
+        for (ptrdiff_t k=K; k; --k) {
+            for (int j=0; j<NR; ++j) {
+                const T bj = B[j];
+                for (int i=0; i<MR; ++i) c[j*MR+i] += A[i] * bj;
+            }
+            A += MR;
+            B += NR;
+        }
+        for (int j=0; j<NR; ++j, C+=ldc)
+            for (int i=0; i<MR; ++i) C[i] += x * c[j*MR+i];
+    }
+
+#if defined(__AVX__)
+    // If the code is compiled with AVX, use the wider registers.
+#ifdef __AVX512F__
+#define TMV_AVX_512
+#endif
+#ifdef __FMA__
+#define TMV_AVX_FMA
+#endif
+#define TMV_AVX
+#include "TMV_MultMM_Packed_Kernel.h"
+#undef TMV_AVX_512
+#undef TMV_AVX_FMA
+#undef TMV_AVX
+#else
+    // Otherwise, the base version uses SSE if available.
+#include "TMV_MultMM_Packed_Kernel.h"
+#endif
+
+#ifdef TMV_USE_CPU_DISPATCH
+    // With TMV_CPU_DISPATCH, also compile the AVX2 and AVX-512 kernels
+    // and select one at run time.  (cf. TMV_MultMM_Kernel.h)
+    namespace avx2 {
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#define TMV_AVX
+#define TMV_AVX_FMA
+#include "TMV_MultMM_Packed_Kernel.h"
+#undef TMV_AVX
+#undef TMV_AVX_FMA
+#pragma GCC pop_options
+    }
+
+    namespace avx512 {
+#pragma GCC push_options
+#pragma GCC target("avx512f,fma")
+#define TMV_AVX_512
+#define TMV_AVX_FMA
+#include "TMV_MultMM_Packed_Kernel.h"
+#undef TMV_AVX_512
+#undef TMV_AVX_FMA
+#pragma GCC pop_options
+    }
+#endif
+
+    // The micro-kernel to use along with its block size.
+    template <class T>
+    struct MultMM_Packed_Kernel
+    {
+        typedef void (*kernel_type)(
+            const ptrdiff_t K, const T* A, const T* B, T* C,
+            const ptrdiff_t ldc, const T x);
+        ptrdiff_t MR, NR;
+        kernel_type kernel;
+
+        MultMM_Packed_Kernel(ptrdiff_t mr, ptrdiff_t nr, kernel_type k) :
+            MR(mr), NR(nr), kernel(k) {}
+    };
+
+    template <class T>
+    struct MultMM_Packed_Select
+    {
+        static TMV_INLINE MultMM_Packed_Kernel<T> get()
+        {
+            return MultMM_Packed_Kernel<T>(
+                4,4,&generic_packed_kernel<T,4,4>);
+        }
+    };
+
+#ifdef TMV_USE_CPU_DISPATCH
+#define TMV_PACKED_SELECT(T) \
+    static TMV_INLINE MultMM_Packed_Kernel<T> get() \
+    { \
+        switch (TMV_CPUArch()) { \
+          case CPU_AVX512 : \
+               return MultMM_Packed_Kernel<T>( \
+                   2*avx512::Packed_Vec<T>::size,6, \
+                   &avx512::packed_simd_kernel<T>); \
+          case CPU_AVX2 : \
+               return MultMM_Packed_Kernel<T>( \
+                   2*avx2::Packed_Vec<T>::size,6, \
+                   &avx2::packed_simd_kernel<T>); \
+          default : \
+               return MultMM_Packed_Kernel<T>( \
+                   2*Packed_Vec<T>::size,6,&packed_simd_kernel<T>); \
+        } \
+    }
+#else
+#define TMV_PACKED_SELECT(T) \
+    static TMV_INLINE MultMM_Packed_Kernel<T> get() \
+    { \
+        return MultMM_Packed_Kernel<T>( \
+            2*Packed_Vec<T>::size,6,&packed_simd_kernel<T>); \
+    }
+#endif
+
+#ifdef TMV_PACKED_FLOAT
+    template <>
+    struct MultMM_Packed_Select<float>
+    { TMV_PACKED_SELECT(float) };
+#endif
+#ifdef TMV_PACKED_DOUBLE
+    template <>
+    struct MultMM_Packed_Select<double>
+    { TMV_PACKED_SELECT(double) };
+#endif
+
+#undef TMV_PACKED_SELECT
+#undef TMV_PACKED_FLOAT
+#undef TMV_PACKED_DOUBLE
+
+    // Pack an mc x kc block of A (with steps si,sj) into slivers of
+    // MR rows.  Each sliver is stored with the MR values for each k
+    // together, and the last one is padded with zeros.
+    template <class T>
+    static void MultMM_PackA(
+        const ptrdiff_t mc, const ptrdiff_t kc,
+        const T* A, const ptrdiff_t si, const ptrdiff_t sj,
+        const ptrdiff_t MR, T* Ap)
+    {
+        for (ptrdiff_t i=0; i<mc; i+=MR, A+=MR*si, Ap+=MR*kc) {
+            const ptrdiff_t mr = TMV_MIN(MR,mc-i);
+            if (si == 1) {
+                // Column major: read down each column.
+                const T* Ak = A;
+                T* Apk = Ap;
+                for (ptrdiff_t k=kc; k; --k, Ak+=sj, Apk+=MR) {
+                    ptrdiff_t ii=0;
+                    for (; ii<mr; ++ii) Apk[ii] = Ak[ii];
+                    for (; ii<MR; ++ii) Apk[ii] = T(0);
+                }
+            } else {
+                // Otherwise read along each row.
+                for (ptrdiff_t ii=0; ii<MR; ++ii) {
+                    T* Api = Ap + ii;
+                    if (ii < mr) {
+                        const T* Ai = A + ii*si;
+                        for (ptrdiff_t k=kc; k; --k, Ai+=sj, Api+=MR)
+                            *Api = *Ai;
+                    } else {
+                        for (ptrdiff_t k=kc; k; --k, Api+=MR)
+                            *Api = T(0);
+                    }
+                }
+            }
+        }
+    }
+
+    // Pack a kc x nc block of B (with steps si,sj) into slivers of
+    // NR columns.  Each sliver is stored with the NR values for each k
+    // together, and the last one is padded with zeros.
+    template <class T>
+    static void MultMM_PackB(
+        const ptrdiff_t kc, const ptrdiff_t nc,
+        const T* B, const ptrdiff_t si, const ptrdiff_t sj,
+        const ptrdiff_t NR, T* Bp)
+    {
+        for (ptrdiff_t j=0; j<nc; j+=NR, B+=NR*sj, Bp+=NR*kc) {
+            const ptrdiff_t nr = TMV_MIN(NR,nc-j);
+            if (sj == 1) {
+                // Row major: read along each row.
+                const T* Bk = B;
+                T* Bpk = Bp;
+                for (ptrdiff_t k=kc; k; --k, Bk+=si, Bpk+=NR) {
+                    ptrdiff_t jj=0;
+                    for (; jj<nr; ++jj) Bpk[jj] = Bk[jj];
+                    for (; jj<NR; ++jj) Bpk[jj] = T(0);
+                }
+            } else {
+                // Otherwise read down each column.
+                for (ptrdiff_t jj=0; jj<NR; ++jj) {
+                    T* Bpj = Bp + jj;
+                    if (jj < nr) {
+                        const T* Bj = B + jj*sj;
+                        for (ptrdiff_t k=kc; k; --k, Bj+=si, Bpj+=NR)
+                            *Bpj = *Bj;
+                    } else {
+                        for (ptrdiff_t k=kc; k; --k, Bpj+=NR)
+                            *Bpj = T(0);
+                    }
+                }
+            }
+        }
+    }
+
+    // Do the two innermost loops for a packed mc x kc block of A and a
+    // packed kc x nc block of B:  C(mc x nc) += x * Ap * Bp
+    template <class T>
+    static void MultMM_PackedBlock(
+        const MultMM_Packed_Kernel<T>& kern,
+        const ptrdiff_t mc, const ptrdiff_t nc, const ptrdiff_t kc,
+        const T x, const T* Ap, const T* Bp,
+        T* C, const ptrdiff_t si, const ptrdiff_t sj, T* Ctemp)
+    {
+        const ptrdiff_t MR = kern.MR;
+        const ptrdiff_t NR = kern.NR;
+        for (ptrdiff_t j=0; j<nc; j+=NR, Bp+=NR*kc) {
+            const ptrdiff_t nr = TMV_MIN(NR,nc-j);
+            const T* Api = Ap;
+            T* Cij = C + j*sj;
+            for (ptrdiff_t i=0; i<mc; i+=MR, Api+=MR*kc, Cij+=MR*si) {
+                const ptrdiff_t mr = TMV_MIN(MR,mc-i);
+                if (si == 1 && mr == MR && nr == NR) {
+                    kern.kernel(kc,Api,Bp,Cij,sj,x);
+                } else {
+                    for (ptrdiff_t k=0; k<MR*NR; ++k) Ctemp[k] = T(0);
+                    kern.kernel(kc,Api,Bp,Ctemp,MR,x);
+                    for (ptrdiff_t jj=0; jj<nr; ++jj)
+                        for (ptrdiff_t ii=0; ii<mr; ++ii)
+                            Cij[ii*si+jj*sj] += Ctemp[jj*MR+ii];
+                }
+            }
+        }
+    }
+
+    // The workspace for the packed algorithm: the micro-kernel to use,
+    // the block sizes, and the memory for the packed panels.
+    // The OpenMP version (TMV_MultMM_OpenMP.h) keeps one of these for 
+    // each thread, so the memory is reused for all the tiles that 
+    // a thread calculates.
+    template <class T>
+    struct MultMM_Packed_Workspace
+    {
+        MultMM_Packed_Workspace() : 
+            kern(MultMM_Packed_Select<T>::get()),
+            MC(TMV_MAX(ptrdiff_t(MultMM_Packed_Sizes<T>::MC)/kern.MR,
+                       ptrdiff_t(1))*kern.MR),
+            NC(TMV_MAX(ptrdiff_t(MultMM_Packed_Sizes<T>::NC)/kern.NR,
+                       ptrdiff_t(1))*kern.NR),
+            KC(MultMM_Packed_Sizes<T>::KC),
+            nA(0), nB(0), Ctemp(kern.MR*kern.NR) {}
+
+        // Make sure the panels are large enough for an M x N x K product.
+        // Only allocate as much as we need for smaller matrices.
+        void reserve(const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K)
+        {
+            const ptrdiff_t MR = kern.MR;
+            const ptrdiff_t NR = kern.NR;
+            const ptrdiff_t kcmax = TMV_MIN(K,KC);
+            const ptrdiff_t na = TMV_MIN((M+MR-1)/MR*MR,MC) * kcmax;
+            const ptrdiff_t nb = TMV_MIN((N+NR-1)/NR*NR,NC) * kcmax;
+            if (na > nA) { Ap.resize(na); nA = na; }
+            if (nb > nB) { Bp.resize(nb); nB = nb; }
+        }
+
+        const MultMM_Packed_Kernel<T> kern;
+        const ptrdiff_t MC, NC, KC;
+        ptrdiff_t nA, nB;
+        AlignedArray<T> Ap, Bp, Ctemp;
+
+    private :
+        MultMM_Packed_Workspace(const MultMM_Packed_Workspace<T>& );
+        MultMM_Packed_Workspace& operator=(
+            const MultMM_Packed_Workspace<T>& );
+    };
+
+    // C += x * A * B, where A is M x K with steps Asi,Asj, etc.
+    template <class T>
+    static void MultMM_PackedCalc(
+        MultMM_Packed_Workspace<T>& ws, 
+        const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K, const T x,
+        const T* A, const ptrdiff_t Asi, const ptrdiff_t Asj,
+        const T* B, const ptrdiff_t Bsi, const ptrdiff_t Bsj,
+        T* C, const ptrdiff_t Csi, const ptrdiff_t Csj)
+    {
+        if (M == 0 || N == 0 || K == 0) return;
+        ws.reserve(M,N,K);
+        const ptrdiff_t MC = ws.MC, NC = ws.NC, KC = ws.KC;
+        T* Ap = ws.Ap.get();
+        T* Bp = ws.Bp.get();
+
+        for (ptrdiff_t jc=0; jc<N; jc+=NC) {
+            const ptrdiff_t nc = TMV_MIN(NC,N-jc);
+            for (ptrdiff_t pc=0; pc<K; pc+=KC) {
+                const ptrdiff_t kc = TMV_MIN(KC,K-pc);
+                MultMM_PackB(kc,nc,B+pc*Bsi+jc*Bsj,Bsi,Bsj,ws.kern.NR,Bp);
+                for (ptrdiff_t ic=0; ic<M; ic+=MC) {
+                    const ptrdiff_t mc = TMV_MIN(MC,M-ic);
+                    MultMM_PackA(mc,kc,A+ic*Asi+pc*Asj,Asi,Asj,ws.kern.MR,Ap);
+                    MultMM_PackedBlock(
+                        ws.kern,mc,nc,kc,x,Ap,Bp,
+                        C+ic*Csi+jc*Csj,Csi,Csj,ws.Ctemp.get());
+                }
+            }
+        }
+    }
+
+    template <int algo, bool add, int ix, class T, class M1, class M2, class M3>
+    struct MultMM_Packed_Helper;
+
+    // algo 11: The packed panel algorithm
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    struct MultMM_Packed_Helper<11,add,ix,T,M1,M2,M3>
+    {
+        static void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
+        {
+            typedef typename M3::value_type T3;
+            TMVStaticAssert(!Traits<T3>::iscomplex);
+            TMVStaticAssert((Traits2<typename M1::value_type,T3>::sametype));
+            TMVStaticAssert((Traits2<typename M2::value_type,T3>::sametype));
+            const ptrdiff_t M = m3.colsize();
+            const ptrdiff_t N = m3.rowsize();
+            const ptrdiff_t K = m1.rowsize();
+#ifdef PRINTALGO_MM
+            std::cout<<"MMPacked algo 11: M,N,K = "<<M<<','<<N<<','<<K<<
+                std::endl;
+#endif
+            if (!add) m3.setZero();
+            MultMM_Packed_Workspace<T3> ws;
+            MultMM_PackedCalc(
+                ws,M,N,K,Traits<T3>::convert(T(x)),
+                m1.cptr(),m1.stepi(),m1.stepj(),
+                m2.cptr(),m2.stepi(),m2.stepj(),
+                m3.ptr(),m3.stepi(),m3.stepj());
+        }
+    };
+
+    // algo 12: Complex or mixed types.  Use the regular block algorithm.
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    struct MultMM_Packed_Helper<12,add,ix,T,M1,M2,M3>
+    {
+        static TMV_INLINE void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
+        { MultMM_Block<add>(x,m1,m2,m3); }
+    };
+
+    // algo 90: call inst
+    template <int ix, class T, class M1, class M2, class M3>
+    struct MultMM_Packed_Helper<90,false,ix,T,M1,M2,M3>
+    {
+        static TMV_INLINE void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
+        {
+            typedef typename M3::value_type VT;
+            VT xx = Traits<VT>::convert(T(x));
+            InstMultMM_Packed(xx,m1.xView(),m2.xView(),m3.xView());
+        }
+    };
+    template <int ix, class T, class M1, class M2, class M3>
+    struct MultMM_Packed_Helper<90,true,ix,T,M1,M2,M3>
+    {
+        static TMV_INLINE void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
+        {
+            typedef typename M3::value_type VT;
+            VT xx = Traits<VT>::convert(T(x));
+            InstAddMultMM_Packed(xx,m1.xView(),m2.xView(),m3.xView());
+        }
+    };
+
+    // algo -3: Only one real algorithm here, so do it.
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    struct MultMM_Packed_Helper<-3,add,ix,T,M1,M2,M3>
+    {
+        static TMV_INLINE void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
+        {
+            typedef typename M1::value_type T1;
+            typedef typename M2::value_type T2;
+            typedef typename M3::value_type T3;
+            const bool packable =
+                !Traits<T3>::iscomplex &&
+                Traits2<T1,T3>::sametype &&
+                Traits2<T2,T3>::sametype;
+            const int algo = packable ? 11 : 12;
+            MultMM_Packed_Helper<algo,add,ix,T,M1,M2,M3>::call(x,m1,m2,m3);
+        }
+    };
+
+    // algo -2: Check for inst
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    struct MultMM_Packed_Helper<-2,add,ix,T,M1,M2,M3>
+    {
+        static TMV_INLINE void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
+        {
+            TMVStaticAssert(!M3::_conj);
+            typedef typename M1::value_type T1;
+            typedef typename M2::value_type T2;
+            typedef typename M3::value_type T3;
+            const bool inst =
+                !Traits<T3>::iscomplex &&
+                Traits2<T1,T3>::sametype &&
+                Traits2<T2,T3>::sametype &&
+                Traits<T3>::isinst;
+            const int algo =
+                inst ? 90 :
+                -3;
+            MultMM_Packed_Helper<algo,add,ix,T,M1,M2,M3>::call(x,m1,m2,m3);
+        }
+    };
+
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    struct MultMM_Packed_Helper<-1,add,ix,T,M1,M2,M3>
+    {
+        static TMV_INLINE void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
+        { MultMM_Packed_Helper<-2,add,ix,T,M1,M2,M3>::call(x,m1,m2,m3); }
+    };
+
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    inline void MultMM_Packed(
+        const Scaling<ix,T>& x, const BaseMatrix_Rec<M1>& m1,
+        const BaseMatrix_Rec<M2>& m2, BaseMatrix_Rec_Mutable<M3>& m3)
+    {
+        TMVAssert(m1.colsize() == m3.colsize());
+        TMVAssert(m1.rowsize() == m2.colsize());
+        TMVAssert(m2.rowsize() == m3.rowsize());
+        typedef typename M1::const_xview_type M1v;
+        typedef typename M2::const_xview_type M2v;
+        typedef typename M3::xview_type M3v;
+        TMV_MAYBE_CREF(M1,M1v) m1v = m1.xView();
+        TMV_MAYBE_CREF(M2,M2v) m2v = m2.xView();
+        TMV_MAYBE_REF(M3,M3v) m3v = m3.xView();
+        MultMM_Packed_Helper<-2,add,ix,T,M1v,M2v,M3v>::call(x,m1v,m2v,m3v);
+    }
+
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    inline void InlineMultMM_Packed(
+        const Scaling<ix,T>& x, const BaseMatrix_Rec<M1>& m1,
+        const BaseMatrix_Rec<M2>& m2, BaseMatrix_Rec_Mutable<M3>& m3)
+    {
+        TMVAssert(m1.colsize() == m3.colsize());
+        TMVAssert(m1.rowsize() == m2.colsize());
+        TMVAssert(m2.rowsize() == m3.rowsize());
+        typedef typename M1::const_xview_type M1v;
+        typedef typename M2::const_xview_type M2v;
+        typedef typename M3::xview_type M3v;
+        TMV_MAYBE_CREF(M1,M1v) m1v = m1.xView();
+        TMV_MAYBE_CREF(M2,M2v) m2v = m2.xView();
+        TMV_MAYBE_REF(M3,M3v) m3v = m3.xView();
+        MultMM_Packed_Helper<-3,add,ix,T,M1v,M2v,M3v>::call(x,m1v,m2v,m3v);
+    }
+
+} // namespace tmv
+
+#endif
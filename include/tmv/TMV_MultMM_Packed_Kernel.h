@@ -0,0 +1,198 @@
+
+
+// This file has the register-blocked micro-kernel used by the packed
+// algorithm in TMV_MultMM_Packed.h.
+//
+// The kernel calculates C += x * A * B for a 2S x 6 block of C, where
+// S is the number of values in a vector register.  A is a packed sliver
+// of 2S rows, stored with the 2S values for each k together, and B is
+// a packed sliver of 6 columns, stored with the 6 values for each k
+// together.  So each step in k is two vector loads from A, six
+// broadcasts from B and twelve multiply-adds into the accumulators,
+// which all stay in registers for the whole K loop.  (12 accumulators
+// plus 2 for A and 1 for B is 15, which fits in the 16 registers
+// available for SSE and AVX.)
+//
+// C is column major with a stride of ldc.  The edges where the block
+// of C is not a full 2S x 6 are handled by the caller.
+//
+// The instruction set is chosen by macros:
+// If TMV_AVX_512 is defined, we use the 512 bit registers.
+// Else if TMV_AVX is defined, we use the 256 bit registers, with the
+// fused multiply-add commands if TMV_AVX_FMA is also defined.
+// Otherwise, we use SSE (for float) and SSE2 (for double) if available.
+// Other types just use the generic kernel in TMV_MultMM_Packed.h.
+//
+// Note: there is intentionally no include guard here.  When the library
+// is compiled with TMV_CPU_DISPATCH, this file is included once for
+// each instruction set inside its own namespace, just like
+// TMV_MultMM_Kernel_AVX.h.
+
+    template <class T>
+    struct Packed_Vec;
+
+#if defined(TMV_AVX_512)
+#define TMV_PACKED_FLOAT
+    template <>
+    struct Packed_Vec<float>
+    {
+        typedef __m512 vec;
+        enum { size = 16 };
+        static TMV_INLINE vec zero() { return _mm512_setzero_ps(); }
+        static TMV_INLINE vec load(const float* p)
+        { return _mm512_loadu_ps(p); }
+        static TMV_INLINE vec bcast(const float* p)
+        { return _mm512_set1_ps(*p); }
+        static TMV_INLINE vec fma(const vec& a, const vec& b, const vec& c)
+        { return _mm512_fmadd_ps(a,b,c); }
+        static TMV_INLINE void update(float* p, const vec& x, const vec& c)
+        { _mm512_storeu_ps(p,_mm512_fmadd_ps(x,c,_mm512_loadu_ps(p))); }
+    };
+#elif defined(TMV_AVX)
+#define TMV_PACKED_FLOAT
+    template <>
+    struct Packed_Vec<float>
+    {
+        typedef __m256 vec;
+        enum { size = 8 };
+        static TMV_INLINE vec zero() { return _mm256_setzero_ps(); }
+        static TMV_INLINE vec load(const float* p)
+        { return _mm256_loadu_ps(p); }
+        static TMV_INLINE vec bcast(const float* p)
+        { return _mm256_broadcast_ss(p); }
+        static TMV_INLINE vec fma(const vec& a, const vec& b, const vec& c)
+        {
+#ifdef TMV_AVX_FMA
+            return _mm256_fmadd_ps(a,b,c);
+#else
+            return _mm256_add_ps(_mm256_mul_ps(a,b),c);
+#endif
+        }
+        static TMV_INLINE void update(float* p, const vec& x, const vec& c)
+        { _mm256_storeu_ps(p,fma(x,c,_mm256_loadu_ps(p))); }
+    };
+#elif defined(__SSE__)
+#define TMV_PACKED_FLOAT
+    template <>
+    struct Packed_Vec<float>
+    {
+        typedef __m128 vec;
+        enum { size = 4 };
+        static TMV_INLINE vec zero() { return _mm_setzero_ps(); }
+        static TMV_INLINE vec load(const float* p)
+        { return _mm_loadu_ps(p); }
+        static TMV_INLINE vec bcast(const float* p)
+        { return _mm_load1_ps(p); }
+        static TMV_INLINE vec fma(const vec& a, const vec& b, const vec& c)
+        { return _mm_add_ps(_mm_mul_ps(a,b),c); }
+        static TMV_INLINE void update(float* p, const vec& x, const vec& c)
+        { _mm_storeu_ps(p,fma(x,c,_mm_loadu_ps(p))); }
+    };
+#endif
+
+#if defined(TMV_AVX_512)
+#define TMV_PACKED_DOUBLE
+    template <>
+    struct Packed_Vec<double>
+    {
+        typedef __m512d vec;
+        enum { size = 8 };
+        static TMV_INLINE vec zero() { return _mm512_setzero_pd(); }
+        static TMV_INLINE vec load(const double* p)
+        { return _mm512_loadu_pd(p); }
+        static TMV_INLINE vec bcast(const double* p)
+        { return _mm512_set1_pd(*p); }
+        static TMV_INLINE vec fma(const vec& a, const vec& b, const vec& c)
+        { return _mm512_fmadd_pd(a,b,c); }
+        static TMV_INLINE void update(double* p, const vec& x, const vec& c)
+        { _mm512_storeu_pd(p,_mm512_fmadd_pd(x,c,_mm512_loadu_pd(p))); }
+    };
+#elif defined(TMV_AVX)
+#define TMV_PACKED_DOUBLE
+    template <>
+    struct Packed_Vec<double>
+    {
+        typedef __m256d vec;
+        enum { size = 4 };
+        static TMV_INLINE vec zero() { return _mm256_setzero_pd(); }
+        static TMV_INLINE vec load(const double* p)
+        { return _mm256_loadu_pd(p); }
+        static TMV_INLINE vec bcast(const double* p)
+        { return _mm256_broadcast_sd(p); }
+        static TMV_INLINE vec fma(const vec& a, const vec& b, const vec& c)
+        {
+#ifdef TMV_AVX_FMA
+            return _mm256_fmadd_pd(a,b,c);
+#else
+            return _mm256_add_pd(_mm256_mul_pd(a,b),c);
+#endif
+        }
+        static TMV_INLINE void update(double* p, const vec& x, const vec& c)
+        { _mm256_storeu_pd(p,fma(x,c,_mm256_loadu_pd(p))); }
+    };
+#elif defined(__SSE2__)
+#define TMV_PACKED_DOUBLE
+    template <>
+    struct Packed_Vec<double>
+    {
+        typedef __m128d vec;
+        enum { size = 2 };
+        static TMV_INLINE vec zero() { return _mm_setzero_pd(); }
+        static TMV_INLINE vec load(const double* p)
+        { return _mm_loadu_pd(p); }
+        static TMV_INLINE vec bcast(const double* p)
+        { return _mm_load1_pd(p); }
+        static TMV_INLINE vec fma(const vec& a, const vec& b, const vec& c)
+        { return _mm_add_pd(_mm_mul_pd(a,b),c); }
+        static TMV_INLINE void update(double* p, const vec& x, const vec& c)
+        { _mm_storeu_pd(p,fma(x,c,_mm_loadu_pd(p))); }
+    };
+#endif
+
+#if defined(TMV_PACKED_FLOAT) || defined(TMV_PACKED_DOUBLE)
+    template <class T>
+    static void packed_simd_kernel(
+        const ptrdiff_t K, const T* A, const T* B, T* C,
+        const ptrdiff_t ldc, const T x)
+    {
+        typedef Packed_Vec<T> V;
+        typedef typename V::vec vec;
+        const ptrdiff_t S = V::size;
+
+        vec c00 = V::zero(), c10 = V::zero();
+        vec c01 = V::zero(), c11 = V::zero();
+        vec c02 = V::zero(), c12 = V::zero();
+        vec c03 = V::zero(), c13 = V::zero();
+        vec c04 = V::zero(), c14 = V::zero();
+        vec c05 = V::zero(), c15 = V::zero();
+        vec a0, a1, b;
+
+        for (ptrdiff_t k=K; k; --k) {
+            a0 = V::load(A);
+            a1 = V::load(A+S);
+            b = V::bcast(B);
+            c00 = V::fma(a0,b,c00); c10 = V::fma(a1,b,c10);
+            b = V::bcast(B+1);
+            c01 = V::fma(a0,b,c01); c11 = V::fma(a1,b,c11);
+            b = V::bcast(B+2);
+            c02 = V::fma(a0,b,c02); c12 = V::fma(a1,b,c12);
+            b = V::bcast(B+3);
+            c03 = V::fma(a0,b,c03); c13 = V::fma(a1,b,c13);
+            b = V::bcast(B+4);
+            c04 = V::fma(a0,b,c04); c14 = V::fma(a1,b,c14);
+            b = V::bcast(B+5);
+            c05 = V::fma(a0,b,c05); c15 = V::fma(a1,b,c15);
+            A += 2*S;
+            B += 6;
+        }
+
+        const vec xx = V::bcast(&x);
+        V::update(C,xx,c00); V::update(C+S,xx,c10); C += ldc;
+        V::update(C,xx,c01); V::update(C+S,xx,c11); C += ldc;
+        V::update(C,xx,c02); V::update(C+S,xx,c12); C += ldc;
+        V::update(C,xx,c03); V::update(C+S,xx,c13); C += ldc;
+        V::update(C,xx,c04); V::update(C+S,xx,c14); C += ldc;
+        V::update(C,xx,c05); V::update(C+S,xx,c15);
+    }
+#endif
+
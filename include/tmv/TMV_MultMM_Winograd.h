@@ -5,14 +5,7 @@
 
 #include "TMV_BaseMatrix_Rec.h"
 #include "TMV_MultXM_Funcs.h"
-
-#ifndef TMV_MM_MIN_WINOGRAD
-#ifdef TMV_USE_RECURSIVE_BLOCK
-#define TMV_MM_MIN_WINOGRAD 2048
-#else
-#define TMV_MM_MIN_WINOGRAD 1024
-#endif
-#endif
+#include "TMV_Tuning.h"
 
 namespace tmv {
 
@@ -158,8 +151,8 @@ namespace tmv {
             typedef typename M3::value_type T3;
             typedef typename Traits<T3>::real_type RT;
 
-            if (M < TMV_MM_MIN_WINOGRAD && N < TMV_MM_MIN_WINOGRAD && 
-                K < TMV_MM_MIN_WINOGRAD) {
+            const ptrdiff_t minwin = GetTuning().mm_min_winograd;
+            if (M < minwin && N < minwin && K < minwin) {
                 return MultMM_Winograd_Helper<12,add,ix,T,M1,M2,M3>::call(
                     x,m1,m2,m3);
             }
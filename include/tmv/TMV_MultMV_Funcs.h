@@ -70,6 +70,18 @@ namespace tmv {
         const Scaling<ix,T>& x, const BaseMatrix_Band<M1>& m1,
         const BaseVector_Calc<V2>& v2, BaseVector_Mutable<V3>& v3);
 
+    // From TMV_MultSV.h:
+    template <bool add, int ix, class T, class M1, class V2, class V3>
+    inline void MultMV(
+        const Scaling<ix,T>& x, const BaseMatrix_Sym<M1>& m1,
+        const BaseVector_Calc<V2>& v2, BaseVector_Mutable<V3>& v3);
+
+    template <bool add, int ix, class T, class V1, class M2, class V3>
+    inline void MultVM(
+        const Scaling<ix,T>& x, const BaseVector_Calc<V1>& v1,
+        const BaseMatrix_Sym<M2>& m2, BaseVector_Mutable<V3>& v3);
+
+
 } // namespace tmv
 
 #endif
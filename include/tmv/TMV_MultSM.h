@@ -0,0 +1,255 @@
+
+
+#ifndef TMV_MultSM_H
+#define TMV_MultSM_H
+
+#include "TMV_BaseMatrix_Sym.h"
+#include "TMV_BaseMatrix_Rec.h"
+#include "TMV_MultMM_Funcs.h"
+#include "TMV_MultXM_Funcs.h"
+#include "TMV_Array.h"
+
+#ifdef PRINTALGO_SM
+#include <iostream>
+#endif
+
+// The number of rows of the symmetric matrix to do at a time.
+// Each step does a (nb x nb) diagonal block and two products with
+// the (n-j2) x nb panel below it, so this should be large enough for
+// those products to run at the full MultMM speed.
+#ifndef TMV_SYMMM_BLOCK
+#define TMV_SYMMM_BLOCK 128
+#endif
+
+namespace tmv {
+
+    //
+    // M (+)= x * S * M
+    // M (+)= x * M * S
+    // M (+)= x * S * S
+    //
+
+    // The part of S below a diagonal block is P = S(j2:n,j1:j2).
+    // Then the rows below the block get P * B(j1:j2) and the block
+    // rows get P^T * B(j2:n) (or P^H for a hermitian matrix).
+    template <bool herm>
+    struct SymMultMM_Panel // herm = false
+    {
+        template <int ix, class T, class M1, class M2, class M3>
+        static TMV_INLINE void callT(
+            const Scaling<ix,T>& x, const M1& p, const M2& m2, M3& m3)
+        { MultMM<true>(x,p.transpose(),m2,m3); }
+    };
+    template <>
+    struct SymMultMM_Panel<true>
+    {
+        template <int ix, class T, class M1, class M2, class M3>
+        static TMV_INLINE void callT(
+            const Scaling<ix,T>& x, const M1& p, const M2& m2, M3& m3)
+        { MultMM<true>(x,p.adjoint(),m2,m3); }
+    };
+
+    // Copy the diagonal block S(j1:j2,j1:j2) and the panel below it
+    // S(j2:n,j1:j2) from a symmetric matrix.  For non-packed storage,
+    // the panel is just a view into the lower triangle.
+    template <bool packed>
+    struct SymMultMM_Block // packed = false
+    {
+        template <class M1, class M2>
+        static TMV_INLINE void diag(
+            const M1& m1, ptrdiff_t j1, ptrdiff_t j2, M2& d)
+        { Copy(m1.cSubSymMatrix(j1,j2),d); }
+
+        template <class M1, class M2>
+        static TMV_INLINE typename M1::const_lowertri_type::const_submatrix_type
+            panel(const M1& m1, ptrdiff_t j1, ptrdiff_t j2, M2& )
+        { return m1.lowerTri().cSubMatrix(j2,m1.size(),j1,j2); }
+    };
+    template <>
+    struct SymMultMM_Block<true>
+    {
+        template <class M1, class M2>
+        static void diag(
+            const M1& m1, ptrdiff_t j1, ptrdiff_t j2, M2& d)
+        {
+            for(ptrdiff_t j=j1;j<j2;++j) for(ptrdiff_t i=j1;i<j2;++i)
+                d.ref(i-j1,j-j1) = m1.cref(i,j);
+        }
+
+        template <class M1, class M2>
+        static typename M2::submatrix_type panel(
+            const M1& m1, ptrdiff_t j1, ptrdiff_t j2, M2& temp)
+        {
+            const ptrdiff_t n = m1.size();
+            for(ptrdiff_t j=j1;j<j2;++j) for(ptrdiff_t i=j2;i<n;++i)
+                temp.ref(i-j2,j-j1) = m1.cref(i,j);
+            return temp.cSubMatrix(0,n-j2,0,j2-j1);
+        }
+    };
+
+    template <int algo, bool add, int ix, class T, class M1, class M2, class M3>
+    struct SymMultMM_Helper;
+
+    // algo 11: Loop over block columns of m1, using MultMM for each
+    // piece.  Each element of the stored triangle of m1 is only
+    // read once (for packed storage, it is copied once).
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    struct SymMultMM_Helper<11,add,ix,T,M1,M2,M3>
+    {
+        static void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
+        {
+            typedef typename M1::value_type T1;
+            const ptrdiff_t n = m1.size();
+            const ptrdiff_t nb = TMV_SYMMM_BLOCK;
+            const ptrdiff_t nd = TMV_MIN(n,nb);
+#ifdef PRINTALGO_SM
+            std::cout<<"SM algo 11: n,N,nb = "<<n<<','<<m3.rowsize()<<
+                ','<<nb<<std::endl;
+#endif
+            Maybe<!add>::zero(m3);
+
+            // The temporaries come from the scratch arena.
+            // (See TMV_Array.h)
+            ScratchScope scope;
+            typedef Matrix<T1,ColMajor|NoDivider|NoAlias> Mt;
+            Mt d(nd,nd);
+            Mt p(M1::_packed ? TMV_MAX(n-nd,ptrdiff_t(0)) : 0,
+                 M1::_packed ? nd : 0);
+
+            for(ptrdiff_t j1=0;j1<n;j1+=nb) {
+                const ptrdiff_t j2 = TMV_MIN(n,j1+nb);
+                typename Mt::submatrix_type d1 = d.cSubMatrix(0,j2-j1,0,j2-j1);
+                SymMultMM_Block<M1::_packed>::diag(m1,j1,j2,d1);
+
+                typename M2::const_rowrange_type m2a = m2.cRowRange(j1,j2);
+                typename M3::rowrange_type m3a = m3.cRowRange(j1,j2);
+                MultMM<true>(x,d1,m2a,m3a);
+
+                if (j2 < n) {
+                    typename M2::const_rowrange_type m2b = m2.cRowRange(j2,n);
+                    typename M3::rowrange_type m3b = m3.cRowRange(j2,n);
+                    MultMM<true>(
+                        x,SymMultMM_Block<M1::_packed>::panel(m1,j1,j2,p),
+                        m2a,m3b);
+                    SymMultMM_Panel<M1::_herm>::callT(
+                        x,SymMultMM_Block<M1::_packed>::panel(m1,j1,j2,p),
+                        m2b,m3a);
+                }
+            }
+        }
+    };
+
+    // algo 99: Check for aliases
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    struct SymMultMM_Helper<99,add,ix,T,M1,M2,M3>
+    {
+        static void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
+        {
+            if (SameStorage(m1,m3) || SameStorage(m2,m3)) {
+                typedef typename M3::value_type T3;
+                Matrix<T3,ColMajor|NoDivider|NoAlias> m3c(
+                    m3.colsize(),m3.rowsize());
+                SymMultMM_Helper<-3,false,ix,T,M1,M2,
+                    Matrix<T3,ColMajor|NoDivider|NoAlias> >::call(
+                        x,m1,m2,m3c);
+                typename M3::noalias_type m3na = m3.noAlias();
+                MultXM<add>(Scaling<1,typename M3::real_type>(),m3c,m3na);
+            } else {
+                SymMultMM_Helper<-3,add,ix,T,M1,M2,M3>::call(x,m1,m2,m3);
+            }
+        }
+    };
+
+    // algo -3: Determine which algorithm to use
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    struct SymMultMM_Helper<-3,add,ix,T,M1,M2,M3>
+    {
+        static TMV_INLINE void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
+        { SymMultMM_Helper<11,add,ix,T,M1,M2,M3>::call(x,m1,m2,m3); }
+    };
+
+    // algo -1: Check for aliases?
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    struct SymMultMM_Helper<-1,add,ix,T,M1,M2,M3>
+    {
+        static TMV_INLINE void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
+        {
+            const int algo = M3::_checkalias ? 99 : -3;
+            SymMultMM_Helper<algo,add,ix,T,M1,M2,M3>::call(x,m1,m2,m3);
+        }
+    };
+
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    inline void MultMM(
+        const Scaling<ix,T>& x, const BaseMatrix_Sym<M1>& m1,
+        const BaseMatrix_Rec<M2>& m2, BaseMatrix_Rec_Mutable<M3>& m3)
+    {
+        TMVAssert(m1.size() == m2.colsize());
+        TMVAssert(m1.size() == m3.colsize());
+        TMVAssert(m2.rowsize() == m3.rowsize());
+        typedef typename M1::const_cview_type M1v;
+        typedef typename M2::const_cview_type M2v;
+        typedef typename M3::cview_type M3v;
+        TMV_MAYBE_CREF(M1,M1v) m1v = m1.cView();
+        TMV_MAYBE_CREF(M2,M2v) m2v = m2.cView();
+        TMV_MAYBE_REF(M3,M3v) m3v = m3.cView();
+        SymMultMM_Helper<-1,add,ix,T,M1v,M2v,M3v>::call(x,m1v,m2v,m3v);
+    }
+
+    // M * S = (S^T * M^T)^T.  For a SymMatrix, S^T = S.
+    // For a HermMatrix, we use (S^H * M^H)^H = (S * M^H)^H instead.
+    template <bool herm>
+    struct MultMS_Helper // herm = false
+    {
+        template <bool add, int ix, class T, class M1, class M2, class M3>
+        static TMV_INLINE void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
+        {
+            typename M3::transpose_type m3t = m3.transpose();
+            MultMM<add>(x,m2,m1.transpose(),m3t);
+        }
+    };
+    template <>
+    struct MultMS_Helper<true>
+    {
+        template <bool add, int ix, class T, class M1, class M2, class M3>
+        static TMV_INLINE void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
+        {
+            typename M3::adjoint_type m3a = m3.adjoint();
+            MultMM<add>(TMV_CONJ(x),m2,m1.adjoint(),m3a);
+        }
+    };
+
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    inline void MultMM(
+        const Scaling<ix,T>& x, const BaseMatrix_Rec<M1>& m1,
+        const BaseMatrix_Sym<M2>& m2, BaseMatrix_Rec_Mutable<M3>& m3)
+    {
+        TMVAssert(m1.rowsize() == m2.size());
+        TMVAssert(m1.colsize() == m3.colsize());
+        TMVAssert(m2.size() == m3.rowsize());
+        MultMS_Helper<M2::_herm>::template call<add>(
+            x,m1.mat(),m2.mat(),m3.mat());
+    }
+
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    inline void MultMM(
+        const Scaling<ix,T>& x, const BaseMatrix_Sym<M1>& m1,
+        const BaseMatrix_Sym<M2>& m2, BaseMatrix_Rec_Mutable<M3>& m3)
+    {
+        TMVAssert(m1.size() == m2.size());
+        TMVAssert(m1.size() == m3.colsize());
+        TMVAssert(m2.size() == m3.rowsize());
+        typedef typename M2::value_type T2;
+        Matrix<T2,ColMajor|NoDivider|NoAlias> m2c = m2;
+        MultMM<add>(x,m1,m2c,m3);
+    }
+
+} // namespace tmv
+
+#endif
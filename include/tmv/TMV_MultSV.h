@@ -0,0 +1,171 @@
+
+
+#ifndef TMV_MultSV_H
+#define TMV_MultSV_H
+
+#include "TMV_BaseMatrix_Sym.h"
+#include "TMV_BaseVector.h"
+#include "TMV_MultXV_Funcs.h"
+#include "TMV_MultMV_Funcs.h"
+
+#ifdef PRINTALGO_SV
+#include <iostream>
+#endif
+
+namespace tmv {
+
+    //
+    // v (+)= x * S * v
+    // v (+)= x * v * S
+    //
+
+    template <int algo, bool add, int ix, class T, class M1, class V2, class V3>
+    struct MultSV_Helper;
+
+    // algo 11: Loop over the stored triangle of m1 using cref.
+    // This is the only option for packed storage.
+    template <bool add, int ix, class T, class M1, class V2, class V3>
+    struct MultSV_Helper<11,add,ix,T,M1,V2,V3>
+    {
+        static void call(
+            const Scaling<ix,T>& x, const M1& m1, const V2& v2, V3& v3)
+        {
+            typedef typename Traits2<
+                typename M1::value_type,typename V2::value_type>::type PT;
+            const ptrdiff_t n = m1.size();
+#ifdef PRINTALGO_SV
+            std::cout<<"SV algo 11: n = "<<n<<std::endl;
+#endif
+            Vector<PT> temp(n,PT(0));
+            for(ptrdiff_t j=0;j<n;++j) {
+                const PT vj = v2.cref(j);
+                temp(j) += m1.cref(j,j) * vj;
+                const ptrdiff_t i1 = m1.isupper() ? 0 : j+1;
+                const ptrdiff_t i2 = m1.isupper() ? j : n;
+                for(ptrdiff_t i=i1;i<i2;++i) {
+                    temp(i) += m1.cref(i,j) * vj;
+                    temp(j) += m1.cref(j,i) * v2.cref(i);
+                }
+            }
+            MultXV<add>(x,temp,v3);
+        }
+    };
+
+    // algo 21: Use the triangle views of m1.
+    // v3 (+)= x * L * v2, then v3 += x * offdiag(U) * v2.
+    template <bool add, int ix, class T, class M1, class V2, class V3>
+    struct MultSV_Helper<21,add,ix,T,M1,V2,V3>
+    {
+        static void call(
+            const Scaling<ix,T>& x, const M1& m1, const V2& v2, V3& v3)
+        {
+            const ptrdiff_t n = m1.size();
+#ifdef PRINTALGO_SV
+            std::cout<<"SV algo 21: n = "<<n<<std::endl;
+#endif
+            typename M1::const_lowertri_type m1l = m1.lowerTri();
+            MultMV<add>(x,m1l,v2,v3);
+            if (n > 1) {
+                typename V2::const_subvector_type v2b = v2.cSubVector(1,n);
+                typename V3::subvector_type v3a = v3.cSubVector(0,n-1);
+                MultMV<true>(x,m1.upperTri().offDiag(),v2b,v3a);
+            }
+        }
+    };
+
+    // algo 99: Check for aliases
+    template <bool add, int ix, class T, class M1, class V2, class V3>
+    struct MultSV_Helper<99,add,ix,T,M1,V2,V3>
+    {
+        static void call(
+            const Scaling<ix,T>& x, const M1& m1, const V2& v2, V3& v3)
+        {
+            // Both algorithms read v2 after writing to parts of v3, so
+            // if they share storage, we need a copy of v2.
+            if (SameStorage(v2,v3)) {
+                typename V2::copy_type v2c = v2;
+                typedef typename V2::copy_type::const_cview_type V2c;
+                MultSV_Helper<-3,add,ix,T,M1,V2c,V3>::call(
+                    x,m1,v2c.cView(),v3);
+            } else {
+                MultSV_Helper<-3,add,ix,T,M1,V2,V3>::call(x,m1,v2,v3);
+            }
+        }
+    };
+
+    // algo -3: Determine which algorithm to use
+    template <bool add, int ix, class T, class M1, class V2, class V3>
+    struct MultSV_Helper<-3,add,ix,T,M1,V2,V3>
+    {
+        static TMV_INLINE void call(
+            const Scaling<ix,T>& x, const M1& m1, const V2& v2, V3& v3)
+        {
+            const int algo = M1::_packed ? 11 : 21;
+            MultSV_Helper<algo,add,ix,T,M1,V2,V3>::call(x,m1,v2,v3);
+        }
+    };
+
+    // algo -1: Check for aliases?
+    template <bool add, int ix, class T, class M1, class V2, class V3>
+    struct MultSV_Helper<-1,add,ix,T,M1,V2,V3>
+    {
+        static TMV_INLINE void call(
+            const Scaling<ix,T>& x, const M1& m1, const V2& v2, V3& v3)
+        {
+            const int algo = V3::_checkalias ? 99 : -3;
+            MultSV_Helper<algo,add,ix,T,M1,V2,V3>::call(x,m1,v2,v3);
+        }
+    };
+
+    template <bool add, int ix, class T, class M1, class V2, class V3>
+    inline void MultMV(
+        const Scaling<ix,T>& x, const BaseMatrix_Sym<M1>& m1,
+        const BaseVector_Calc<V2>& v2, BaseVector_Mutable<V3>& v3)
+    {
+        TMVAssert(m1.size() == v2.size());
+        TMVAssert(m1.size() == v3.size());
+        typedef typename M1::const_cview_type M1v;
+        typedef typename V2::const_cview_type V2v;
+        typedef typename V3::cview_type V3v;
+        TMV_MAYBE_CREF(M1,M1v) m1v = m1.cView();
+        TMV_MAYBE_CREF(V2,V2v) v2v = v2.cView();
+        TMV_MAYBE_REF(V3,V3v) v3v = v3.cView();
+        MultSV_Helper<-1,add,ix,T,M1v,V2v,V3v>::call(x,m1v,v2v,v3v);
+    }
+
+    // v * S = S^T * v.  For a SymMatrix, S^T = S.  For a HermMatrix,
+    // S^T = conj(S), so we use conj(v3) = conj(x) * S * conj(v1).
+    template <bool herm>
+    struct MultVS_Helper // herm = false
+    {
+        template <bool add, int ix, class T, class V1, class M2, class V3>
+        static TMV_INLINE void call(
+            const Scaling<ix,T>& x, const V1& v1, const M2& m2, V3& v3)
+        { MultMV<add>(x,m2,v1,v3); }
+    };
+    template <>
+    struct MultVS_Helper<true>
+    {
+        template <bool add, int ix, class T, class V1, class M2, class V3>
+        static TMV_INLINE void call(
+            const Scaling<ix,T>& x, const V1& v1, const M2& m2, V3& v3)
+        {
+            typename V3::conjugate_type v3c = v3.conjugate();
+            MultMV<add>(TMV_CONJ(x),m2,v1.conjugate(),v3c);
+        }
+    };
+
+    template <bool add, int ix, class T, class V1, class M2, class V3>
+    inline void MultVM(
+        const Scaling<ix,T>& x, const BaseVector_Calc<V1>& v1,
+        const BaseMatrix_Sym<M2>& m2, BaseVector_Mutable<V3>& v3)
+    {
+        TMVAssert(m2.size() == v1.size());
+        TMVAssert(m2.size() == v3.size());
+        MultVS_Helper<M2::_herm>::template call<add>(
+            x,v1.vec(),m2.mat(),v3.vec());
+    }
+
+} // namespace tmv
+
+#endif
@@ -15,6 +15,7 @@
 
 #ifdef _OPENMP
 #include "omp.h"
+#include <vector>
 #ifdef PRINTALGO_UM_OMP
 #include <fstream>
 #endif
@@ -58,9 +59,16 @@
 #endif
 
 // The minimum value of (M^2*N / 16^3) to use multiple threads.
-// (We also require that N > 64 so we have something to split.)
+// (We also require that N >= 64, so a product with only a few columns
+// doesn't start a parallel region.)
 #define TMV_UM_OMP_THRESH 64
 
+// The size of the row blocks and column tiles for the task parallel
+// algorithm (algo 37).
+#ifndef TMV_UM_OMP_TILE
+#define TMV_UM_OMP_TILE 128
+#endif
+
 namespace tmv {
 
     // Defined in TMV_MultUM.cpp
@@ -1399,7 +1407,7 @@ namespace tmv {
 #ifdef TMV_UM_SMALL
                 (rs != Unknown && rs <= 3) ? 0 :
 #endif
-                (rs == Unknown || rs >= 64) ? 36 :
+                (rs == Unknown || rs >= 64) ? 37 :
                 0;
 #endif
             const int algo5 =
@@ -1467,6 +1475,9 @@ namespace tmv {
     // that is a multiple of 16.  This way we get the maximum advantage from
     // our blocking structure while keeping the threads as balanced as 
     // possible.
+    // This isn't selected automatically any more, since algo 37 balances
+    // the work better, but it is kept so speed/TMV_Speed_TriDiv.cpp can
+    // compare the two.
     template <ptrdiff_t cs, ptrdiff_t rs, bool add, int ix, class T, class M1, class M2, class M3>
     struct MultUM_Helper<36,cs,rs,add,ix,T,M1,M2,M3>
     {
@@ -1550,6 +1561,111 @@ namespace tmv {
     };
 #endif
 
+#ifdef _OPENMP
+    // algo 37: Split problem into tiles and do them as OpenMP tasks.
+    // The rows of m3 are split into blocks of TMV_UM_OMP_TILE, and the
+    // columns into tiles of the same width.  For UpperTri, each tile is
+    // Y_ic (+)= x U_ii X_ic + x U_i,k>i X_k>i,c
+    // which only reads m1 and m2, so all the tiles are independent.
+    // The rows with the most work are started first.
+    // If m3 is the same storage as m2 (i.e. m3 = m1 * m3), the rows
+    // have to be done in order, so then we only split the columns,
+    // like algo 36, but with more tiles than threads for better balance.
+    template <ptrdiff_t cs, ptrdiff_t rs, bool add, int ix, class T, class M1, class M2, class M3>
+    struct MultUM_Helper<37,cs,rs,add,ix,T,M1,M2,M3>
+    {
+        static void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
+        {
+#ifdef PRINTALGO_UM
+            const ptrdiff_t M = cs==Unknown ? m3.colsize() : cs;
+            const ptrdiff_t N = rs==Unknown ? m3.rowsize() : rs;
+            std::cout<<"UM algo 37: M,N,cs,rs,x = "<<M<<','<<N<<
+                ','<<cs<<','<<rs<<','<<T(x)<<std::endl;
+#endif
+            const bool upper = M1::_upper;
+            const int algo2 = upper ? 17 : 27;
+            // As in MultMM, check omp_get_level() rather than 
+            // omp_in_parallel(), so we don't start a new parallel region
+            // if the user has called this from within an inactive one.
+            if (omp_get_level() > 0 || omp_get_max_threads() == 1) {
+                MultUM_Helper<algo2,cs,rs,add,ix,T,M1,M2,M3>::call(
+                    x,m1,m2,m3);
+                return;
+            }
+#pragma omp parallel
+            {
+#pragma omp single
+                {
+                    tasks(x,m1,m2,m3);
+                }
+            }
+        }
+
+        static void tasks(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3)
+        {
+            const ptrdiff_t M = cs==Unknown ? m3.colsize() : cs;
+            const ptrdiff_t N = rs==Unknown ? m3.rowsize() : rs;
+            const bool upper = M1::_upper;
+            const int algo2 = upper ? 17 : 27;
+            const ptrdiff_t xx = Unknown;
+            const ptrdiff_t nb = TMV_UM_OMP_TILE;
+            const ptrdiff_t nc = (N-1)/nb + 1;
+
+            if (ExactSameStorage(m2,m3)) {
+                typedef typename M2::const_colrange_type M2c;
+                typedef typename M3::colrange_type M3c;
+                for(ptrdiff_t c=0;c<nc;++c) {
+                    const ptrdiff_t j1 = c*nb;
+                    const ptrdiff_t j2 = TMV_MIN(N,j1+nb);
+#pragma omp task default(shared) firstprivate(j1,j2)
+                    {
+                        M2c m2c = m2.cColRange(j1,j2);
+                        M3c m3c = m3.cColRange(j1,j2);
+                        MultUM_Helper<algo2,cs,xx,add,ix,T,M1,M2c,M3c>::call(
+                            x,m1,m2c,m3c);
+                    }
+                }
+            } else {
+                typedef typename M1::const_subtrimatrix_type M1a;
+                typedef typename M1::const_submatrix_type M1b;
+                typedef typename M2::const_submatrix_type M2s;
+                typedef typename M3::submatrix_type M3s;
+                const ptrdiff_t nr = (M-1)/nb + 1;
+                for(ptrdiff_t ii=0;ii<nr;++ii) {
+                    const ptrdiff_t i = upper ? ii : nr-1-ii;
+                    const ptrdiff_t i1 = i*nb;
+                    const ptrdiff_t i2 = TMV_MIN(M,i1+nb);
+                    // The range of m2 rows multiplied by the off-diagonal 
+                    // part of m1.
+                    const ptrdiff_t k1 = upper ? i2 : 0;
+                    const ptrdiff_t k2 = upper ? M : i1;
+                    for(ptrdiff_t c=0;c<nc;++c) {
+                        const ptrdiff_t j1 = c*nb;
+                        const ptrdiff_t j2 = TMV_MIN(N,j1+nb);
+#pragma omp task default(shared) firstprivate(i1,i2,k1,k2,j1,j2)
+                        {
+                            M1a Aii = m1.cSubTriMatrix(i1,i2);
+                            M2s Xi = m2.cSubMatrix(i1,i2,j1,j2);
+                            M3s Yi = m3.cSubMatrix(i1,i2,j1,j2);
+                            MultUM_Helper<algo2,xx,xx,add,ix,T,M1a,M2s,M3s>::
+                                call(x,Aii,Xi,Yi);
+                            if (k2 > k1) {
+                                M1b Aik = m1.cSubMatrix(i1,i2,k1,k2);
+                                M2s Xk = m2.cSubMatrix(k1,k2,j1,j2);
+                                MultMM_Helper<-2,xx,xx,xx,true,ix,T,M1b,M2s,M3s>::
+                                    call(x,Aik,Xk,Yi);
+                            }
+                        }
+                    }
+                }
+            }
+#pragma omp taskwait
+        }
+    };
+#endif
+
     // algo 38: Unknown cs, check if M is small
     template <ptrdiff_t cs, ptrdiff_t rs, bool add, int ix, class T, class M1, class M2, class M3>
     struct MultUM_Helper<38,cs,rs,add,ix,T,M1,M2,M3>
@@ -1920,7 +2036,8 @@ namespace tmv {
             // Overall drivers:
             // 31 = Choose algorithm based on the (runtime) size
             // 33 = Bad majority, copy m2 and turn into a MultEq operation.
-            // 36 = Parallelize using openmp 
+            // 36 = Parallelize using openmp (only called explicitly)
+            // 37 = Parallelize using openmp tasks on tiles
             // 38 = Check if M is small
 
             const bool xcc = M2::_colmajor && M3::_colmajor;
@@ -1959,7 +2076,7 @@ namespace tmv {
                 rs == Unknown ? 31 :
                 rs <= 3 ? 11 :
 #ifdef _OPENMP
-                (rs >= 64 && McMcNc >= TMV_UM_OMP_THRESH) ? 36 :
+                (rs >= 64 && McMcNc >= TMV_UM_OMP_THRESH) ? 37 :
 #endif
                 17  :
 
@@ -1973,7 +2090,7 @@ namespace tmv {
                 rs == Unknown ? 31 :
                 rs <= 3 ? 21 :
 #ifdef _OPENMP
-                (rs >= 64 && McMcNc >= TMV_UM_OMP_THRESH) ? 36 :
+                (rs >= 64 && McMcNc >= TMV_UM_OMP_THRESH) ? 37 :
 #endif
                 27 ;
 #ifdef PRINTALGO_UM
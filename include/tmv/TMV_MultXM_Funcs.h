@@ -86,6 +86,21 @@ namespace tmv {
         const Scaling<ix,T>& x, const BaseMatrix_Tri<M1>& m1,
         BaseMatrix_Band_Mutable<M2>& m2);
 
+    // From TMV_MultXS.h:
+    template <int ix, class T, class M>
+    inline void Scale(
+        const Scaling<ix,T>& x, BaseMatrix_Sym_Mutable<M>& m);
+
+    template <bool add, int ix, class T, class M1, class M2>
+    inline void MultXM(
+        const Scaling<ix,T>& x, const BaseMatrix_Sym<M1>& m1,
+        BaseMatrix_Sym_Mutable<M2>& m2);
+
+    template <bool add, int ix, class T, class M1, class M2>
+    inline void MultXM(
+        const Scaling<ix,T>& x, const BaseMatrix_Sym<M1>& m1,
+        BaseMatrix_Rec_Mutable<M2>& m2);
+
 
 } // namespace tmv
 
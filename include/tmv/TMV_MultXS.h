@@ -0,0 +1,116 @@
+
+
+#ifndef TMV_MultXS_H
+#define TMV_MultXS_H
+
+#include "TMV_BaseMatrix_Sym.h"
+#include "TMV_MultXV_Funcs.h"
+#include "TMV_MultXM_Funcs.h"
+
+namespace tmv {
+
+    //
+    // S *= x
+    //
+
+    template <int ix, class T, class M>
+    inline void Scale(
+        const Scaling<ix,T>& x, BaseMatrix_Sym_Mutable<M>& m)
+    {
+        // A hermitian matrix times a complex number isn't hermitian.
+        TMVAssert(!M::_herm || TMV_IMAG(T(x)) == 0);
+        SymElements_Helper<M::_packed>::scale(x,m.mat());
+    }
+
+
+    //
+    // S += x * S
+    // M += x * S
+    //
+
+    // Without packed storage, we can use the triangle views.
+    // Packed storage doesn't have triangle views, so loop over
+    // the stored triangle (or the full matrix) using cref.
+    template <bool packed>
+    struct AddXS_Helper // packed = false
+    {
+        template <int ix, class T, class M1, class M2>
+        static void addToSym(const Scaling<ix,T>& x, const M1& m1, M2& m2)
+        {
+            typename M1::const_lowertri_type m1l = m1.lowerTri();
+            typename M2::lowertri_type m2l = m2.lowerTri();
+            MultXM<true>(x,m1l,m2l);
+        }
+        template <int ix, class T, class M1, class M2>
+        static void addToRec(const Scaling<ix,T>& x, const M1& m1, M2& m2)
+        {
+            const ptrdiff_t n = m1.size();
+            typename M1::const_lowertri_type m1l = m1.lowerTri();
+            typename M2::lowertri_type m2l = m2.lowerTri();
+            MultXM<true>(x,m1l,m2l);
+            if (n > 1) {
+                typename M2::uppertri_type::offdiag_type m2u =
+                    m2.upperTri().offDiag();
+                MultXM<true>(x,m1.upperTri().offDiag(),m2u);
+            }
+        }
+    };
+    template <>
+    struct AddXS_Helper<true>
+    {
+        template <int ix, class T, class M1, class M2>
+        static void addToSym(const Scaling<ix,T>& x, const M1& m1, M2& m2)
+        {
+            const ptrdiff_t n = m2.size();
+            for(ptrdiff_t j=0;j<n;++j) {
+                const ptrdiff_t i1 = m2.isupper() ? 0 : j;
+                const ptrdiff_t i2 = m2.isupper() ? j+1 : n;
+                for(ptrdiff_t i=i1;i<i2;++i)
+                    m2.ref(i,j) += x * m1.cref(i,j);
+            }
+        }
+        template <int ix, class T, class M1, class M2>
+        static void addToRec(const Scaling<ix,T>& x, const M1& m1, M2& m2)
+        {
+            const ptrdiff_t n = m1.size();
+            for(ptrdiff_t j=0;j<n;++j)
+                for(ptrdiff_t i=0;i<n;++i)
+                    m2.ref(i,j) += x * m1.cref(i,j);
+        }
+    };
+
+    template <bool add, int ix, class T, class M1, class M2>
+    inline void MultXM(
+        const Scaling<ix,T>& x, const BaseMatrix_Sym<M1>& m1,
+        BaseMatrix_Sym_Mutable<M2>& m2)
+    {
+        TMVStaticAssert((ShapeTraits2<M1::_shape,M2::_shape>::assignable));
+        TMVAssert(!M2::_herm || TMV_IMAG(T(x)) == 0);
+        TMVAssert(m1.size() == m2.size());
+        if (!add) {
+            Copy(m1,m2);
+            Scale(x,m2);
+        } else {
+            AddXS_Helper<(M1::_packed || M2::_packed)>::addToSym(
+                x,m1.mat(),m2.mat());
+        }
+    }
+
+    template <bool add, int ix, class T, class M1, class M2>
+    inline void MultXM(
+        const Scaling<ix,T>& x, const BaseMatrix_Sym<M1>& m1,
+        BaseMatrix_Rec_Mutable<M2>& m2)
+    {
+        TMVAssert(m1.size() == m2.colsize());
+        TMVAssert(m1.size() == m2.rowsize());
+        if (!add) {
+            Copy(m1,m2);
+            Scale(x,m2);
+        } else {
+            AddXS_Helper<M1::_packed>::addToRec(x,m1.mat(),m2.mat());
+        }
+    }
+
+} // namespace tmv
+
+#endif
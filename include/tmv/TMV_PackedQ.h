@@ -101,6 +101,14 @@
 // BLOCKSIZE is the block size to use in algo 21
 #define TMV_QR_BLOCKSIZE 48
 
+// OPENMP_MINCOLS = the minimum number of columns of m2 to give to each
+// thread when InstPackedQ_MultEq and InstPackedQ_LDivEq split up the
+// columns of m2 with OpenMP.  (Also used for the columns of Q in 
+// InstUnpackQ.)
+// OPENMP_THRESH = the minimum M*N*K for which they use OpenMP.
+#define TMV_QR_OPENMP_MINCOLS 16
+#define TMV_QR_OPENMP_THRESH 1048576
+
 namespace tmv {
 
     // 
@@ -512,29 +512,11 @@ namespace tmv {
         template <class M>
         friend void BandLU_Decompose(BaseMatrix_Band_Mutable<M>& m, Permutation& P);
 
-#if 0
-        template <class T>
+        // In TMV_LDLDecompose.h
+        template <bool herm, class M, class V>
         friend void LDL_Decompose(
-            const SymMatrixView<T>& A, const SymBandMatrixView<T>& D,
-            Permutation& P)
-        {
-            TMVAssert(P.size() == A.colsize());
-            P.allocateMem();
-            LDL_Decompose(A,D,P.getMem());
-            P.isinv = true;
-        }
-
-        template <class T>
-        friend void LDL_Decompose(
-            const SymMatrixView<T>& A, const VectorView<T>& xD,
-            Permutation& P, TMV_RealType(T)& logdet, T& signdet)
-        {
-            TMVAssert(P.size() == A.size());
-            P.allocateMem();
-            LDL_Decompose(A,xD,P.getMem(),logdet,signdet);
-            P.isinv = true;
-        }
-#endif
+            BaseMatrix_Rec_Mutable<M>& m, BaseVector_Mutable<V>& xD,
+            Permutation& P);
 
         template <class V>
         friend void DoVectorSort(
@@ -5,6 +5,7 @@
 #include "TMV_BaseMatrix_Rec.h"
 #include "TMV_SwapV.h"
 #include "TMV_Prefetch.h"
+#include "TMV_AlgoTrace.h"
 
 //#define PRINTALGO_PERM
 
@@ -31,6 +32,24 @@ namespace tmv {
     template <int algo, ptrdiff_t cs, ptrdiff_t rs, class M1>
     struct PermuteRows_Helper;
 
+    // Record a call in the algorithm trace.  (See TMV_AlgoTrace.h)
+    // K is the number of rows that are swapped.
+    template <ptrdiff_t cs, ptrdiff_t rs, class M1>
+    class PermuteRows_Trace : public AlgoTrace
+    {
+    public:
+        enum { small = (
+                cs != Unknown && rs != Unknown && cs <= 16 && rs <= 16 ) };
+        enum { sz = sizeof(typename M1::value_type) };
+
+        PermuteRows_Trace(
+            const char* op, int algo, const M1& m, 
+            const ptrdiff_t i1, const ptrdiff_t i2) :
+            AlgoTrace(
+                small ? 0 : op, algo, m.colsize(), m.rowsize(), i2-i1, 0.,
+                4. * sz * (i2-i1) * m.rowsize()) {}
+    };
+
     // algo 11: Simple loop over columns
     template <ptrdiff_t cs, ptrdiff_t rs, class M1>
     struct PermuteRows_Helper<11,cs,rs,M1>
@@ -206,6 +225,7 @@ namespace tmv {
             //std::cout<<"m = "<<m<<std::endl;
             std::cout<<"algo = "<<algo<<std::endl;
 #endif
+            PermuteRows_Trace<cs,rs,M1> trace("PermuteRows",algo,m,i1,i2);
             PermuteRows_Helper<algo,cs,rs,M1>::call(m,p,i1,i2);
 #ifdef PRINTALGO_PERM
             //std::cout<<"m => "<<m<<std::endl;
@@ -464,6 +484,8 @@ namespace tmv {
             //std::cout<<"m = "<<m<<std::endl;
             std::cout<<"algo = "<<algo<<std::endl;
 #endif
+            PermuteRows_Trace<cs,rs,M1> trace(
+                "ReversePermuteRows",algo,m,i1,i2);
             ReversePermuteRows_Helper<algo,cs,rs,M1>::call(m,p,i1,i2);
 #ifdef PRINTALGO_PERM
             //std::cout<<"m => "<<m<<std::endl;
@@ -6,6 +6,8 @@
 #include "TMV_BaseMatrix_Rec.h"
 #include "TMV_BaseMatrix_Tri.h"
 #include "TMV_Householder.h"
+#include "TMV_AlgoTrace.h"
+#include "TMV_Tuning.h"
 //#include "TMV_MultMM.h"
 //#include "TMV_DivVU.h"
 //#include "TMV_DivMU.h"
@@ -23,6 +25,16 @@
 // BLOCKSIZE is the block size to use in algo 21, etc.
 #define TMV_QR_BLOCKSIZE 48
 
+// TSQR_RATIO = the minimum M/N for which InstQR_Decompose uses the
+// OpenMP tall-skinny QR (TSQR) in TMV_QRDecompose.cpp.
+// TSQR_MINSIZE = the minimum M*N for which it is used.
+// TSQR_MINTHREADS = the minimum number of threads for which it is used.
+// (TSQR does about 3 times as many flops as the serial algorithm, so 
+// it isn't faster with only 2 or 3 threads.)
+#define TMV_QR_TSQR_RATIO 8
+#define TMV_QR_TSQR_MINSIZE 262144
+#define TMV_QR_TSQR_MINTHREADS 4
+
 
 namespace tmv {
 
@@ -33,6 +45,28 @@ namespace tmv {
     template <int algo, ptrdiff_t cs, ptrdiff_t rs, class M, class V>
     struct QRDecompose_Helper;
 
+    // Record a call in the algorithm trace.  (See TMV_AlgoTrace.h)
+    template <ptrdiff_t cs, ptrdiff_t rs, class M1>
+    class QRDecompose_Trace : public AlgoTrace
+    {
+    public:
+        enum { small = (
+                cs != Unknown && rs != Unknown && cs <= 16 && rs <= 16 ) };
+        enum { sz = sizeof(typename M1::value_type) };
+        enum { nflops = M1::iscomplex ? 8 : 2 };
+
+        QRDecompose_Trace(int algo, const M1& m) :
+            AlgoTrace(
+                small ? 0 : "QR_Decompose", algo,
+                m.colsize(), m.rowsize(), 0,
+                nflops * flops(m.colsize(),m.rowsize()),
+                2. * sz * m.colsize() * m.rowsize()) {}
+
+        // The number of multiply-adds for an MxN Householder QR.
+        static double flops(double M, double N)
+        { return M >= N ? N*N*(M-N/3.) : M*M*(N-M/3.); }
+    };
+
     // algo 0: Trivial, nothing to do (M == 0 or 1, or N == 0)
     template <ptrdiff_t cs, ptrdiff_t rs, class M, class V>
     struct QRDecompose_Helper<0,cs,rs,M,V>
@@ -657,28 +691,40 @@ namespace tmv {
                 ','<<cs<<','<<rs<<std::endl;
 #endif
             const int algo27 = 
-                (rs == Unknown || rs <= 128) ? 27 : 0;
+                (rs == Unknown || rs <= TMV_QR_MAX_RECURSIVE) ? 27 : 0;
             const int algo22 = 
-                (rs == Unknown || rs > 128) ? 22 : 0;
-            const ptrdiff_t l2cache = TMV_L2_CACHE*1024/sizeof(T);
+                (rs == Unknown || rs > TMV_QR_MAX_RECURSIVE) ? 22 : 0;
+            // The crossover points are in the tuning profile.
+            // (See TMV_Tuning.h.)  If rs is known, then only one of 
+            // algo27 and algo22 is instantiated, so we have to use the 
+            // compile time value for the second one.
+            const TuningProfile& tune = GetTuning();
+            const ptrdiff_t l2cache = tune.qr_min_blocked/sizeof(T);
+            const ptrdiff_t maxrec = 
+                rs == Unknown ? tune.qr_max_recursive : TMV_QR_MAX_RECURSIVE;
 
             // I'm assuming that this first transition is primarily 
             // memory related.  If the full matrix fits in the L2 cache,
             // then all the recursion and blocking stuff don't help much.
             // And the extra calculations for doing the Z matrix are
             // just wasted extra flops.  
-            if (M*N <= l2cache)
+            if (M*N <= l2cache) {
+                QRDecompose_Trace<cs,rs,M1> trace(11,A);
                 QRDecompose_Helper<11,cs,rs,M1,V>::call(A,beta);
+            }
 
             // I'm not sure if this next transition should really be 
             // in terms of one of the caches...  
             // I did my testing for T = double, so sizeof(T) = 8,
             // and this transition seemed pretty independent of M.
             // But perhaps (N*N*2 <= l2cache) ?
-            else if (N <= 128)
+            else if (N <= maxrec) {
+                QRDecompose_Trace<cs,rs,M1> trace(27,A);
                 QRDecompose_Helper<algo27,cs,rs,M1,V>::call(A,beta);
-            else
+            } else {
+                QRDecompose_Trace<cs,rs,M1> trace(22,A);
                 QRDecompose_Helper<algo22,cs,rs,M1,V>::call(A,beta);
+            }
         }
     };
 
@@ -741,8 +787,10 @@ namespace tmv {
 #ifdef PRINTALGO_QR
             std::cout<<"QRDecompose algo 81: cs,rs = "<<cs<<','<<rs<<std::endl;
 #endif
+            QRDecompose_Trace<cs,rs,M> trace(81,m);
             typedef typename M::value_type T;
             typedef typename MCopyHelper<T,Rec,cs,rs>::type Mcm;
+            ScratchScope scope;
             Mcm mcm = m;
             QRDecompose_Helper<-2,cs,rs,Mcm,V>::call(mcm,beta);
             typename M::noalias_type mna = m.noAlias();
@@ -796,10 +844,10 @@ namespace tmv {
                         (csrs <= l1cache ? 16 : 26) ) :
                     cs == Unknown ? 33 : 
                     cs <= 128 ? 11 : 26) :
-                rsrs > l2cache ? (rs <= 128 ? 27 : 22) :
+                rsrs > l2cache ? (rs <= TMV_QR_MAX_RECURSIVE ? 27 : 22) :
                 cs == Unknown ? 31 : 
                 csrs <= l2cache ? 11 :
-                rs <= 128 ? 27 : 22;
+                rs <= TMV_QR_MAX_RECURSIVE ? 27 : 22;
 #ifdef PRINTALGO_QR
             std::cout<<"Inline QRDecompose: \n";
             std::cout<<"m = "<<TMV_Text(m)<<std::endl;
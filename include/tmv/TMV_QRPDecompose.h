@@ -7,6 +7,7 @@
 #include "TMV_BaseMatrix_Tri.h"
 #include "TMV_Householder.h"
 #include "TMV_Permutation.h"
+#include "TMV_Tuning.h"
 //#include "TMV_MultMM.h"
 //#include "TMV_DivVU.h"
 //#include "TMV_DivMU.h"
@@ -831,7 +832,9 @@ namespace tmv {
             std::cout<<"QRPDecompose algo 31: M,N,cs,rs = "<<M<<','<<N<<
                 ','<<cs<<','<<rs<<std::endl;
 #endif
-            const ptrdiff_t l2cache = TMV_L2_CACHE*1024/sizeof(T);
+            // The crossover point is in the tuning profile.
+            // (See TMV_Tuning.h.)
+            const ptrdiff_t l2cache = GetTuning().qrp_min_blocked/sizeof(T);
 
 #ifdef PRINTALGO_QR
             std::cout<<"M*N = "<<M*N<<std::endl;
@@ -879,6 +882,7 @@ namespace tmv {
 #endif
             typedef typename M::value_type T;
             typedef typename MCopyHelper<T,Rec,cs,rs>::type Mcm;
+            ScratchScope scope;
             Mcm mcm = m;
             QRPDecompose_Helper<-2,cs,rs,Mcm,V>::call(mcm,beta,P,strict);
             typename M::noalias_type mna = m.noAlias();
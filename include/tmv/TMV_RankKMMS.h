@@ -0,0 +1,251 @@
+
+
+#ifndef TMV_RankKMMS_H
+#define TMV_RankKMMS_H
+
+#include "TMV_BaseMatrix_Sym.h"
+#include "TMV_BaseMatrix_Rec.h"
+#include "TMV_MultMM_Funcs.h"
+#include "TMV_MultXM_Funcs.h"
+#include "TMV_Array.h"
+
+#ifdef PRINTALGO_RankK
+#include <iostream>
+#endif
+
+// The size of the diagonal blocks of the symmetric matrix.
+// The diagonal blocks are computed in full in a temporary and then
+// only the stored triangle is added into the SymMatrix.  Everything
+// off the diagonal blocks is only computed once.
+#ifndef TMV_RANKK_BLOCK
+#define TMV_RANKK_BLOCK 64
+#endif
+
+namespace tmv {
+
+    //
+    // S (+)= x * A * A^T       (SymMatrix)
+    // S (+)= x * A * A^H       (HermMatrix, x real)
+    // S (+)= x * A * B^T + x * B * A^T
+    // S (+)= x * A * B^H + conj(x) * B * A^H
+    //
+    // Only the stored triangle of S is written, so these take
+    // about half the flops of the corresponding MultMM calls.
+    //
+
+    // B^T for a SymMatrix, B^H for a HermMatrix.
+    template <bool herm>
+    struct RankK_Trans // herm = false
+    {
+        template <class M>
+        static TMV_INLINE typename M::const_transpose_type call(const M& m)
+        { return m.transpose(); }
+    };
+    template <>
+    struct RankK_Trans<true>
+    {
+        template <class M>
+        static TMV_INLINE typename M::const_adjoint_type call(const M& m)
+        { return m.adjoint(); }
+    };
+
+    // Add the lower triangle of the full temporary d into S.
+    template <bool packed>
+    struct RankK_AddDiagBlock // packed = false
+    {
+        template <class M1, class M2>
+        static void call(const M1& d, ptrdiff_t i1, ptrdiff_t i2, M2& m2)
+        {
+            typename M2::lowertri_type::subtrimatrix_type m2d =
+                m2.lowerTri().cSubTriMatrix(i1,i2);
+            MultXM<true>(
+                Scaling<1,typename M2::real_type>(),d.lowerTri(),m2d);
+        }
+    };
+    template <>
+    struct RankK_AddDiagBlock<true>
+    {
+        template <class M1, class M2>
+        static void call(const M1& d, ptrdiff_t i1, ptrdiff_t i2, M2& m2)
+        {
+            for(ptrdiff_t j=i1;j<i2;++j) for(ptrdiff_t i=j;i<i2;++i)
+                m2.ref(i,j) += d.cref(i-i1,j-i1);
+        }
+    };
+
+    // Add the off-diagonal block S(mid:i2,i1:mid).  Without packed
+    // storage, this is a view of the lower triangle, so MultMM writes
+    // directly into S.  Packed storage uses a temporary panel.
+    template <bool packed>
+    struct RankK_OffDiag // packed = false
+    {
+        template <int ix, class T, class M1, class M2, class M3>
+        static void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3,
+            ptrdiff_t i1, ptrdiff_t mid, ptrdiff_t i2, bool two)
+        {
+            const bool herm = M3::_herm;
+            typename M1::const_rowrange_type a1 = m1.cRowRange(i1,mid);
+            typename M1::const_rowrange_type a2 = m1.cRowRange(mid,i2);
+            typename M2::const_rowrange_type b1 = m2.cRowRange(i1,mid);
+            typename M2::const_rowrange_type b2 = m2.cRowRange(mid,i2);
+            typename M3::lowertri_type::submatrix_type m21 =
+                m3.lowerTri().cSubMatrix(mid,i2,i1,mid);
+            MultMM<true>(x,a2,RankK_Trans<herm>::call(b1),m21);
+            if (two) {
+                Scaling<0,T> x2(herm ? TMV_CONJ(T(x)) : T(x));
+                MultMM<true>(x2,b2,RankK_Trans<herm>::call(a1),m21);
+            }
+        }
+    };
+    template <>
+    struct RankK_OffDiag<true>
+    {
+        template <int ix, class T, class M1, class M2, class M3>
+        static void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3,
+            ptrdiff_t i1, ptrdiff_t mid, ptrdiff_t i2, bool two)
+        {
+            typedef typename M3::value_type T3;
+            const bool herm = M3::_herm;
+            typename M1::const_rowrange_type a1 = m1.cRowRange(i1,mid);
+            typename M1::const_rowrange_type a2 = m1.cRowRange(mid,i2);
+            typename M2::const_rowrange_type b1 = m2.cRowRange(i1,mid);
+            typename M2::const_rowrange_type b2 = m2.cRowRange(mid,i2);
+            ScratchScope scope;
+            Matrix<T3,ColMajor|NoDivider|NoAlias> p(i2-mid,mid-i1);
+            MultMM<false>(x,a2,RankK_Trans<herm>::call(b1),p);
+            if (two) {
+                Scaling<0,T> x2(herm ? TMV_CONJ(T(x)) : T(x));
+                MultMM<true>(x2,b2,RankK_Trans<herm>::call(a1),p);
+            }
+            for(ptrdiff_t j=i1;j<mid;++j) for(ptrdiff_t i=mid;i<i2;++i)
+                m3.ref(i,j) += p.cref(i-mid,j-i1);
+        }
+    };
+
+    template <int algo, int ix, class T, class M1, class M2, class M3>
+    struct Rank2KUpdate_Helper;
+
+    // algo 11: Diagonal block of size <= nb.
+    // Use a full temporary, and then add the lower triangle into m3.
+    template <int ix, class T, class M1, class M2, class M3>
+    struct Rank2KUpdate_Helper<11,ix,T,M1,M2,M3>
+    {
+        static void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3,
+            ptrdiff_t i1, ptrdiff_t i2, bool two)
+        {
+            typedef typename M3::value_type T3;
+            const bool herm = M3::_herm;
+            ScratchScope scope;
+            Matrix<T3,ColMajor|NoDivider|NoAlias> d(i2-i1,i2-i1);
+            typename M1::const_rowrange_type a = m1.cRowRange(i1,i2);
+            typename M2::const_rowrange_type b = m2.cRowRange(i1,i2);
+            MultMM<false>(x,a,RankK_Trans<herm>::call(b),d);
+            if (two) {
+                Scaling<0,T> x2(herm ? TMV_CONJ(T(x)) : T(x));
+                MultMM<true>(x2,b,RankK_Trans<herm>::call(a),d);
+            }
+            // The diagonal of a hermitian matrix is exactly real, but
+            // the products above can leave rounding errors in the
+            // imaginary parts.
+            if (herm) for(ptrdiff_t i=0;i<i2-i1;++i)
+                d.ref(i,i) = TMV_REAL(d.cref(i,i));
+            RankK_AddDiagBlock<M3::_packed>::call(d,i1,i2,m3);
+        }
+    };
+
+    // algo 21: Recursive: split S into
+    //    [ S11  *  ]
+    //    [ S21 S22 ]
+    // where the split is a multiple of nb.  S21 is a normal MultMM.
+    template <int ix, class T, class M1, class M2, class M3>
+    struct Rank2KUpdate_Helper<21,ix,T,M1,M2,M3>
+    {
+        static void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3,
+            ptrdiff_t i1, ptrdiff_t i2, bool two)
+        {
+            const ptrdiff_t nb = TMV_RANKK_BLOCK;
+            const ptrdiff_t n = i2-i1;
+#ifdef PRINTALGO_RankK
+            std::cout<<"RankK algo 21: i1,i2 = "<<i1<<','<<i2<<std::endl;
+#endif
+            if (n <= nb) {
+                Rank2KUpdate_Helper<11,ix,T,M1,M2,M3>::call(
+                    x,m1,m2,m3,i1,i2,two);
+                return;
+            }
+            const ptrdiff_t nblocks = (n-1)/nb + 1;
+            const ptrdiff_t mid = i1 + (nblocks/2)*nb;
+            call(x,m1,m2,m3,i1,mid,two);
+            call(x,m1,m2,m3,mid,i2,two);
+            RankK_OffDiag<M3::_packed>::call(x,m1,m2,m3,i1,mid,i2,two);
+        }
+    };
+
+    // algo -3: Determine which algorithm to use
+    template <int ix, class T, class M1, class M2, class M3>
+    struct Rank2KUpdate_Helper<-3,ix,T,M1,M2,M3>
+    {
+        static TMV_INLINE void call(
+            const Scaling<ix,T>& x, const M1& m1, const M2& m2, M3& m3,
+            ptrdiff_t i1, ptrdiff_t i2, bool two)
+        {
+            Rank2KUpdate_Helper<21,ix,T,M1,M2,M3>::call(
+                x,m1,m2,m3,i1,i2,two);
+        }
+    };
+
+    template <bool add, int ix, class T, class M1, class M3>
+    inline void RankKUpdate(
+        const Scaling<ix,T>& x, const BaseMatrix_Rec<M1>& m1,
+        BaseMatrix_Sym_Mutable<M3>& m3)
+    {
+        // x * A * A^H is only hermitian if x is real.
+        TMVAssert(!M3::_herm || TMV_IMAG(T(x)) == 0);
+        TMVAssert(m1.colsize() == m3.size());
+        typedef typename M1::const_cview_type M1v;
+        typedef typename M3::cview_type M3v;
+        TMV_MAYBE_CREF(M1,M1v) m1v = m1.cView();
+        TMV_MAYBE_REF(M3,M3v) m3v = m3.cView();
+        Maybe<!add>::zero(m3v);
+        Rank2KUpdate_Helper<-3,ix,T,M1v,M1v,M3v>::call(
+            x,m1v,m1v,m3v,0,m3.size(),false);
+    }
+
+    template <bool add, int ix, class T, class M1, class M2, class M3>
+    inline void Rank2KUpdate(
+        const Scaling<ix,T>& x, const BaseMatrix_Rec<M1>& m1,
+        const BaseMatrix_Rec<M2>& m2, BaseMatrix_Sym_Mutable<M3>& m3)
+    {
+        TMVAssert(m1.colsize() == m3.size());
+        TMVAssert(m2.colsize() == m3.size());
+        TMVAssert(m1.rowsize() == m2.rowsize());
+        typedef typename M1::const_cview_type M1v;
+        typedef typename M2::const_cview_type M2v;
+        typedef typename M3::cview_type M3v;
+        TMV_MAYBE_CREF(M1,M1v) m1v = m1.cView();
+        TMV_MAYBE_CREF(M2,M2v) m2v = m2.cView();
+        TMV_MAYBE_REF(M3,M3v) m3v = m3.cView();
+        Maybe<!add>::zero(m3v);
+        Rank2KUpdate_Helper<-3,ix,T,M1v,M2v,M3v>::call(
+            x,m1v,m2v,m3v,0,m3.size(),true);
+    }
+
+    template <bool add, class T, class M1, class M3>
+    inline void RankKUpdate(
+        const T& x, const BaseMatrix_Rec<M1>& m1,
+        BaseMatrix_Sym_Mutable<M3>& m3)
+    { RankKUpdate<add>(Scaling<0,T>(x),m1,m3); }
+
+    template <bool add, class T, class M1, class M2, class M3>
+    inline void Rank2KUpdate(
+        const T& x, const BaseMatrix_Rec<M1>& m1,
+        const BaseMatrix_Rec<M2>& m2, BaseMatrix_Sym_Mutable<M3>& m3)
+    { Rank2KUpdate<add>(Scaling<0,T>(x),m1,m2,m3); }
+
+} // namespace tmv
+
+#endif
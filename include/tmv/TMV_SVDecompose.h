@@ -908,6 +908,7 @@ namespace tmv {
 #endif
             typedef typename Mu::value_type T;
             typedef typename MCopyHelper<T,Rec,cs,rs>::type Mucm;
+            ScratchScope scope;
             Mucm Ucm = U;
             SVDecompose_Helper<-2,cs,rs,Mucm,Ms,Mv>::call(
                 Ucm,S,V,signdet,logdet,StoreU);
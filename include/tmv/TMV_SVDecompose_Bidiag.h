@@ -5,6 +5,7 @@
 
 #include "TMV_SVDecompose.h"
 #include "TMV_Householder.h"
+#include "TMV_Tuning.h"
 
 #ifdef PRINTALGO_SVD
 #include <iostream>
@@ -326,7 +327,10 @@ namespace tmv {
             std::cout<<"Bidiagonalize algo 31: M,N,cs,rs = "<<
                 M<<','<<N<<','<<cs<<','<<rs<<std::endl;
 #endif
-            const ptrdiff_t l2cache = TMV_L2_CACHE*1024/sizeof(T);
+            // The crossover point is in the tuning profile.
+            // (See TMV_Tuning.h.)
+            const ptrdiff_t l2cache = 
+                GetTuning().bidiag_min_blocked/sizeof(T);
             if (M*N <= l2cache)
                 Bidiagonalize_Helper<11,cs,rs,M1,V1,V2,V3,V4>::call(
                     A,Ubeta,Vbeta,D,E);
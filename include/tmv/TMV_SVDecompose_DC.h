@@ -29,6 +29,15 @@
 #define TMV_DC_LIMIT 32
 #define TMV_MAXITER 100
 
+// With OpenMP, the two halves of each divide step are done as separate
+// tasks when the problem is at least TMV_DC_OPENMP_TASKMIN in size.
+// The task-parallel region is only started for problems with
+// N >= TMV_DC_OPENMP_THRESH.  And the secular equation solves in the
+// conquer step are split into chunks of TMV_DC_OPENMP_CHUNK values.
+#define TMV_DC_OPENMP_THRESH 256
+#define TMV_DC_OPENMP_TASKMIN 128
+#define TMV_DC_OPENMP_CHUNK 16
+
 namespace tmv {
 
     // Defined in TMV_SVDecompose_DC.cpp
@@ -715,11 +724,32 @@ namespace tmv {
         return s;
     }
 
+    // The loops over k in FindDCSingularValues are trivially parallel,
+    // since each k only writes S[k] (and column k of diffmat).  So each
+    // thread writes its answers directly with no locking.
+    //
+    // When we are inside the task-parallel recursion of algo 11 (intask),
+    // we are already in a parallel region, so the loop is split into
+    // chunks of TMV_DC_OPENMP_CHUNK values, each of which is a task.
+    // Otherwise, if we are not already in a parallel region, we use a
+    // normal omp for loop.  The number of iterations needed for each
+    // singular value varies quite a bit, so the chunks are scheduled
+    // dynamically in either case.
+    //
+    // For some reason pgCC requires an actual int for the omp
+    // for loop, not just a signed integer type.  So ptrdiff_t
+    // can't be used.
+#ifdef PLATFORM_COMPILER_PGI
+#define TMV_INT_OMP int
+#else
+#define TMV_INT_OMP ptrdiff_t
+#endif
+
     template <class V1, class T, class V2, class V3, class M1>
     void FindDCSingularValues(
         BaseVector_Mutable<V1>& S, T rho,
         const BaseVector_Calc<V2>& D, const BaseVector_Calc<V3>& z,
-        BaseMatrix_Rec_Mutable<M1>& diffmat)
+        BaseMatrix_Rec_Mutable<M1>& diffmat, bool intask=false)
     {
         dbgcout<<"Start FindDCSV: "<<std::endl;
         dbgcout<<"D = "<<D<<std::endl;
@@ -732,52 +762,61 @@ namespace tmv {
         TMVAssert(S.size() == diffmat.rowsize());
 
         const ptrdiff_t N = S.size();
+        // The workspace vectors come from the scratch arena.
+        // Each task or thread needs its own scope. (See TMV_Array.h)
+        ScratchScope scope;
         Vector<T> zsq(N);
         for(ptrdiff_t j=0;j<N;j++) zsq[j] = z[j]*z[j];
         const T normsqz = zsq.sumElements();
 
 #ifdef _OPENMP
-#pragma omp parallel 
-        {
-            Vector<T> diff(N);
-            Vector<T> sum(N);
-            T Sk;
-            // For some reason pgCC requires an actual int for the omp
-            // for loop, not just a signed integer type.  So ptrdiff_t
-            // can't be used.
-#ifdef PLATFORM_COMPILER_PGI
-#define TMV_INT_OMP int
-#else
-#define TMV_INT_OMP ptrdiff_t
-#endif
-#pragma omp for
-            for(TMV_INT_OMP k=0;k<N;k++) {
-                Sk = FindDCSingularValue(k,N,rho,D,z,zsq,normsqz,diff,sum);
-#pragma omp critical
+        const ptrdiff_t nb = TMV_DC_OPENMP_CHUNK;
+        if (intask && N >= 2*nb) {
+            for(ptrdiff_t k1=0;k1<N;k1+=nb) {
+                const ptrdiff_t k2 = TMV_MIN(k1+nb,N);
+#pragma omp task default(shared) firstprivate(k1,k2)
                 {
-                    dbgcout<<"Before assign answer for  k = "<<k<<std::endl;
-                    S[k] = Sk;
-                    diffmat.col(k) = diff;
-                    dbgcout<<"Done assign answer for  k = "<<k<<std::endl;
+                    ScratchScope scope1;
+                    Vector<T> sum(N);
+                    for(ptrdiff_t k=k1;k<k2;k++) {
+                        typename M1::col_type diff = diffmat.col(k);
+                        S[k] = FindDCSingularValue(
+                            k,N,rho,D,z,zsq,normsqz,diff,sum);
+                    }
                 }
             }
-            dbgcout<<"After omp for loop\n";
-        }
-        dbgcout<<"After omp parallel region\n";
-#else
-        Vector<T> sum(N);
-        for(ptrdiff_t k=0;k<N;k++) {
-            typename M1::col_type diff = diffmat.col(k);
-            S[k] = FindDCSingularValue(k,N,rho,D,z,zsq,normsqz,diff,sum);
-        }
+#pragma omp taskwait
+        } else if (!intask && N >= 2*nb && 
+                   omp_get_level() == 0 && omp_get_max_threads() > 1) {
+#pragma omp parallel
+            {
+                ScratchScope scope1;
+                Vector<T> sum(N);
+#pragma omp for schedule(dynamic,TMV_DC_OPENMP_CHUNK)
+                for(TMV_INT_OMP k=0;k<N;k++) {
+                    typename M1::col_type diff = diffmat.col(k);
+                    S[k] = FindDCSingularValue(
+                        k,N,rho,D,z,zsq,normsqz,diff,sum);
+                }
+            }
+        } else 
 #endif
+        {
+            ScratchScope scope1;
+            Vector<T> sum(N);
+            for(ptrdiff_t k=0;k<N;k++) {
+                typename M1::col_type diff = diffmat.col(k);
+                S[k] = FindDCSingularValue(k,N,rho,D,z,zsq,normsqz,diff,sum);
+            }
+        }
         dbgcout<<"S => "<<S<<std::endl;
     }
 
     template <class V1, class T, class V2, class V3>
     void FindDCSingularValues(
         BaseVector_Mutable<V1>& S, T rho,
-        const BaseVector_Calc<V2>& D, const BaseVector_Calc<V3>& z)
+        const BaseVector_Calc<V2>& D, const BaseVector_Calc<V3>& z,
+        bool intask=false)
     {
         dbgcout<<"Start FindDCSV (No diffmat): "<<std::endl;
         dbgcout<<"D = "<<D<<std::endl;
@@ -787,35 +826,53 @@ namespace tmv {
         TMVAssert(S.size() == z.size());
 
         const ptrdiff_t N = S.size();
+        // The workspace vectors come from the scratch arena.
+        // Each task or thread needs its own scope. (See TMV_Array.h)
+        ScratchScope scope;
         Vector<T> zsq(N);
         for(ptrdiff_t j=0;j<N;j++) zsq[j] = z[j]*z[j];
         T normsqz = zsq.sumElements();
 
 #ifdef _OPENMP
+        const ptrdiff_t nb = TMV_DC_OPENMP_CHUNK;
+        if (intask && N >= 2*nb) {
+            for(ptrdiff_t k1=0;k1<N;k1+=nb) {
+                const ptrdiff_t k2 = TMV_MIN(k1+nb,N);
+#pragma omp task default(shared) firstprivate(k1,k2)
+                {
+                    ScratchScope scope1;
+                    Vector<T> diff(N);
+                    Vector<T> sum(N);
+                    for(ptrdiff_t k=k1;k<k2;k++) 
+                        S[k] = FindDCSingularValue(
+                            k,N,rho,D,z,zsq,normsqz,diff,sum);
+                }
+            }
+#pragma omp taskwait
+        } else if (!intask && N >= 2*nb && 
+                   omp_get_level() == 0 && omp_get_max_threads() > 1) {
 #pragma omp parallel
+            {
+                ScratchScope scope1;
+                Vector<T> diff(N);
+                Vector<T> sum(N);
+#pragma omp for schedule(dynamic,TMV_DC_OPENMP_CHUNK)
+                for(TMV_INT_OMP k=0;k<N;k++) 
+                    S[k] = FindDCSingularValue(
+                        k,N,rho,D,z,zsq,normsqz,diff,sum);
+            }
+        } else 
+#endif
         {
+            ScratchScope scope1;
             Vector<T> diff(N);
             Vector<T> sum(N);
-            T Sk;
-#pragma omp for
-            for(TMV_INT_OMP k=0;k<N;k++) {
-                Sk = FindDCSingularValue(k,N,rho,D,z,zsq,normsqz,diff,sum);
-#pragma omp critical
-                {
-                    S[k] = Sk;
-                }
-            }
-#undef TMV_INT_OMP
-        }
-#else
-        Vector<T> diff(N);
-        Vector<T> sum(N);
-        for(ptrdiff_t k=0;k<N;k++) {
-            S[k] = FindDCSingularValue(k,N,rho,D,z,zsq,normsqz,diff,sum);
+            for(ptrdiff_t k=0;k<N;k++) 
+                S[k] = FindDCSingularValue(k,N,rho,D,z,zsq,normsqz,diff,sum);
         }
-#endif
         dbgcout<<"S => "<<S<<std::endl;
     }
+#undef TMV_INT_OMP
 
     template <int algo, ptrdiff_t cs, ptrdiff_t rs, class Mu, class Vd, class Ve, class Mv>
     struct SVDecomposeFromBidiagonal_DC_Helper;
@@ -854,9 +911,156 @@ namespace tmv {
     template <ptrdiff_t cs, ptrdiff_t rs, class Mu, class Vd, class Ve, class Mv>
     struct SVDecomposeFromBidiagonal_DC_Helper<11,cs,rs,Mu,Vd,Ve,Mv>
     {
+        typedef typename Vd::value_type RT;
+        typedef typename Vd::subvector_type Vds;
+        typedef typename Ve::subvector_type Ves;
+        typedef Matrix<RT,RowMajor|NoDivider> Mvc;
+        typedef typename Mvc::view_type Mvcv;
+        typedef typename Mvc::rowrange_type Mvcs;
+        typedef Matrix<RT,ColMajor|NoDivider> Muc;
+        typedef typename Muc::view_type Mucv;
+        enum { xx = Unknown };
+
+        // The left sub-problem is D(0:K), E(0:K) (with E(K-1) zeroed by
+        // BidiagonalZeroLastCol), which sets z(0:K+1) and updates 
+        // U.colRange(0,K) and V.rowRange(0,K+1).
+        static void leftProblem(
+            Mu& U, Vd& D, Ve& E, Mv& V, bool UisI, bool VisI,
+            ptrdiff_t K, Vector<RT>& z, bool intask)
+        {
+            const RT DK = D(K);
+            Vds D1 = D.subVector(0,K);
+            Ves E1 = E.subVector(0,K);
+            Ves E1x = E.subVector(0,K-1);
+            Mvc V1(K+1,V.cptr()?K+1:1);
+            dbgcout<<"V1: "<<V1.cptr()<<"  "<<V1.colsize()<<"  "<<V1.rowsize()<<"  "<<V1.stepi()<<"  "<<V1.stepj()<<std::endl;
+            Mvcv V1v = V1.view();
+            Mvcs V1x = V1.rowRange(0,K);
+            if (V.cptr()) V1.setToIdentity();
+            else V1.col(0).makeBasis(K); // only need col(K)
+            BidiagonalZeroLastCol(D1,E1,V1v);
+            if (U.cptr()) {
+                Muc U1(K,K);
+                dbgcout<<"U1: "<<U1.cptr()<<"  "<<U1.colsize()<<"  "<<U1.rowsize()<<"  "<<U1.stepi()<<"  "<<U1.stepj()<<std::endl;
+                Mucv U1v = U1.view();
+                U1.setToIdentity();
+                SVDecomposeFromBidiagonal_DC_Helper<
+                    11,xx,xx,Mucv,Vds,Ves,Mvcv>::divide(
+                        U1v,D1,E1x,V1x,true,false,intask);
+                if (UisI) U.subMatrix(0,K,0,K) = U1;
+                else U.colRange(0,K) *= U1;
+            } else {
+                SVDecomposeFromBidiagonal_DC_Helper<
+                    11,xx,xx,Mu,Vds,Ves,Mvcv>::divide(
+                        U,D1,E1x,V1x,false,false,intask);
+            }
+            dbgcout<<"After left sub-problem\n";
+            z.subVector(0,K+1) = DK * V1.col(V.cptr() ? K : 0);
+            dbgcout<<"After z = DK * V1.col\n";
+            if (V.cptr()) {
+                dbgcout<<"VisI = "<<VisI<<std::endl;
+                dbgcout<<"K = "<<K<<std::endl;
+                dbgcout<<"V steps = "<<V.stepi()<<"  "<<V.stepj()<<std::endl;
+                dbgcout<<"V.rowRange(0,K+1) = "<<V.rowRange(0,K+1)<<std::endl;
+                dbgcout<<"steps = "<<V.rowRange(0,K+1).stepi()<<"  "<<V.rowRange(0,K+1).stepj()<<std::endl;
+                dbgcout<<"V const steps = "<<V.constView().stepi()<<"  "<<V.constView().stepj()<<std::endl;
+                dbgcout<<"V.const.rowRange(0,K+1) = "<<V.constView().rowRange(0,K+1)<<std::endl;
+                dbgcout<<"steps = "<<V.constView().rowRange(0,K+1).stepi()<<"  "<<V.constView().rowRange(0,K+1).stepj()<<std::endl;
+                if (VisI) V.subMatrix(0,K+1,0,K+1) = V1;
+                else V.rowRange(0,K+1) = V1 * V.rowRange(0,K+1);
+                dbgcout<<"After set V\n";
+            }
+        }
+
+        // The right sub-problem is D(K+1:N), E(K+1:N-1), which sets 
+        // z(K+1:N) and updates U.colRange(K+1,N) and V.rowRange(K+1,N).
+        // So the two sub-problems write to disjoint parts of U, D, E, V
+        // and z, and can be done at the same time.
+        static void rightProblem(
+            Mu& U, Vd& D, Ve& E, Mv& V, bool UisI, bool VisI,
+            ptrdiff_t K, Vector<RT>& z, bool intask)
+        {
+            const ptrdiff_t N = D.size();
+            const RT EK = E(K);
+            Vds D2 = D.subVector(K+1,N);
+            Ves E2 = E.subVector(K+1,N-1);
+            Mvc V2(N-K-1,V.cptr()?N-K-1:1);
+            dbgcout<<"V2: "<<V2.cptr()<<"  "<<V2.colsize()<<"  "<<V2.rowsize()<<"  "<<V2.stepi()<<"  "<<V2.stepj()<<std::endl;
+            Mvcv V2v = V2.view();
+            if (V.cptr()) V2.setToIdentity();
+            else V2.col(0).makeBasis(0); // only need col(0)
+            if (U.cptr()) {
+                Muc U2(N-K-1,N-K-1);
+                dbgcout<<"U2: "<<U2.cptr()<<"  "<<U2.colsize()<<"  "<<U2.rowsize()<<"  "<<U2.stepi()<<"  "<<U2.stepj()<<std::endl;
+                Mucv U2v = U2.view();
+                U2.setToIdentity();
+                SVDecomposeFromBidiagonal_DC_Helper<
+                    11,xx,xx,Mucv,Vds,Ves,Mvcv>::divide(
+                        U2v,D2,E2,V2v,true,V.cptr(),intask);
+                if (UisI) U.subMatrix(K+1,N,K+1,N) = U2;
+                else U.colRange(K+1,N) *= U2;
+            } else {
+                SVDecomposeFromBidiagonal_DC_Helper<
+                    11,xx,xx,Mu,Vds,Ves,Mvcv>::divide(
+                        U,D2,E2,V2v,false,V.cptr(),intask);
+            }
+            dbgcout<<"After right sub-problem\n";
+            z.subVector(K+1,N) = EK * V2.col(0);
+            if (V.cptr()) {
+                if (VisI) V.subMatrix(K+1,N,K+1,N) = V2;
+                else V.rowRange(K+1,N) = V2 * V.rowRange(K+1,N);
+            }
+        }
+
+        static void subProblems(
+            Mu& U, Vd& D, Ve& E, Mv& V, bool UisI, bool VisI,
+            ptrdiff_t K, Vector<RT>& z, bool intask)
+        {
+#ifdef _OPENMP
+            // The first time through with a large enough problem, we start
+            // a parallel region, and from then on (intask == true), each 
+            // divide step that is large enough does its left sub-problem
+            // as a new task while this thread does the right sub-problem.
+            // The conquer steps within the tasks then split their 
+            // secular equation solves into tasks as well.
+            //
+            // As in MultMM, check omp_get_level() rather than 
+            // omp_in_parallel(), so we don't start a new parallel region
+            // if the user has called this from within an inactive one.
+            const ptrdiff_t N = D.size();
+            if (intask) {
+                if (N >= TMV_DC_OPENMP_TASKMIN) {
+#pragma omp task default(shared)
+                    leftProblem(U,D,E,V,UisI,VisI,K,z,true);
+                    rightProblem(U,D,E,V,UisI,VisI,K,z,true);
+#pragma omp taskwait
+                    return;
+                }
+            } else if (N >= TMV_DC_OPENMP_THRESH && 
+                       omp_get_level() == 0 && omp_get_max_threads() > 1) {
+#pragma omp parallel
+                {
+#pragma omp single
+                    {
+#pragma omp task default(shared)
+                        leftProblem(U,D,E,V,UisI,VisI,K,z,true);
+                        rightProblem(U,D,E,V,UisI,VisI,K,z,true);
+#pragma omp taskwait
+                    }
+                }
+                return;
+            }
+#endif
+            leftProblem(U,D,E,V,UisI,VisI,K,z,intask);
+            rightProblem(U,D,E,V,UisI,VisI,K,z,intask);
+        }
+
         static void call(Mu& U, Vd& D, Ve& E, Mv& V, bool UisI, bool VisI)
+        { divide(U,D,E,V,UisI,VisI,false); }
+
+        static void divide(
+            Mu& U, Vd& D, Ve& E, Mv& V, bool UisI, bool VisI, bool intask)
         {
-            typedef typename Vd::value_type RT;
             TMVStaticAssert(Traits<RT>::isreal);
 
             ptrdiff_t N = rs==Unknown ? D.size() : rs;
@@ -1017,15 +1221,6 @@ namespace tmv {
             if (V.cptr()) dbgcout<<"Norm(VVt -1) = "<<Norm(V0*V0.adjoint()-T(1))<<std::endl;
             else dbgcout<<"No input V\n";
 #endif
-            typedef typename Vd::subvector_type Vds;
-            typedef typename Ve::subvector_type Ves;
-            typedef Matrix<RT,RowMajor|NoDivider> Mvc;
-            typedef typename Mvc::view_type Mvcv;
-            typedef typename Mvc::rowrange_type Mvcs;
-            typedef Matrix<RT,ColMajor|NoDivider> Muc;
-            typedef typename Muc::view_type Mucv;
-            const ptrdiff_t xx = Unknown;
-
             // If N is too small, use the QR method
 
             // Also, when we aren't making the U and V matrices, it seems 
@@ -1042,83 +1237,9 @@ namespace tmv {
             }
             dbgcout<<"N > "<<TMV_DC_LIMIT<<std::endl;
             ptrdiff_t K = (N-1)/2;
-            const RT DK = D(K);
-            const RT EK = E(K);
             Vector<RT> z(N,RT(0));
-
-            // Do the left sub-problem
-            Vds D1 = D.subVector(0,K);
-            Ves E1 = E.subVector(0,K);
-            Ves E1x = E.subVector(0,K-1);
-            Mvc V1(K+1,V.cptr()?K+1:1);
-            dbgcout<<"V1: "<<V1.cptr()<<"  "<<V1.colsize()<<"  "<<V1.rowsize()<<"  "<<V1.stepi()<<"  "<<V1.stepj()<<std::endl;
-            Mvcv V1v = V1.view();
-            Mvcs V1x = V1.rowRange(0,K);
-            if (V.cptr()) V1.setToIdentity();
-            else V1.col(0).makeBasis(K); // only need col(K)
-            BidiagonalZeroLastCol(D1,E1,V1v);
-            if (U.cptr()) {
-                Muc U1(K,K);
-                dbgcout<<"U1: "<<U1.cptr()<<"  "<<U1.colsize()<<"  "<<U1.rowsize()<<"  "<<U1.stepi()<<"  "<<U1.stepj()<<std::endl;
-                Mucv U1v = U1.view();
-                U1.setToIdentity();
-                SVDecomposeFromBidiagonal_DC_Helper<
-                    11,xx,xx,Mucv,Vds,Ves,Mvcv>::call(
-                        U1v,D1,E1x,V1x,true,false);
-                if (UisI) U.subMatrix(0,K,0,K) = U1;
-                else U.colRange(0,K) *= U1;
-            } else {
-                SVDecomposeFromBidiagonal_DC_Helper<
-                    11,xx,xx,Mu,Vds,Ves,Mvcv>::call(
-                        U,D1,E1x,V1x,false,false);
-            }
-            dbgcout<<"After left sub-problem\n";
-            z.subVector(0,K+1) = DK * V1.col(V.cptr() ? K : 0);
-            dbgcout<<"After z = DK * V1.col\n";
-            if (V.cptr()) {
-                dbgcout<<"VisI = "<<VisI<<std::endl;
-                dbgcout<<"K = "<<K<<std::endl;
-                dbgcout<<"V steps = "<<V.stepi()<<"  "<<V.stepj()<<std::endl;
-                dbgcout<<"V.rowRange(0,K+1) = "<<V.rowRange(0,K+1)<<std::endl;
-                dbgcout<<"steps = "<<V.rowRange(0,K+1).stepi()<<"  "<<V.rowRange(0,K+1).stepj()<<std::endl;
-                dbgcout<<"V const steps = "<<V.constView().stepi()<<"  "<<V.constView().stepj()<<std::endl;
-                dbgcout<<"V.const.rowRange(0,K+1) = "<<V.constView().rowRange(0,K+1)<<std::endl;
-                dbgcout<<"steps = "<<V.constView().rowRange(0,K+1).stepi()<<"  "<<V.constView().rowRange(0,K+1).stepj()<<std::endl;
-                if (VisI) V.subMatrix(0,K+1,0,K+1) = V1;
-                else V.rowRange(0,K+1) = V1 * V.rowRange(0,K+1);
-                dbgcout<<"After set V\n";
-            }
-
-            // Do the right sub-problem
-            Vds D2 = D.subVector(K+1,N);
-            Ves E2 = E.subVector(K+1,N-1);
-            Mvc V2(N-K-1,V.cptr()?N-K-1:1);
-            dbgcout<<"V2: "<<V2.cptr()<<"  "<<V2.colsize()<<"  "<<V2.rowsize()<<"  "<<V2.stepi()<<"  "<<V2.stepj()<<std::endl;
-            Mvcv V2v = V2.view();
-            if (V.cptr()) V2.setToIdentity();
-            else V2.col(0).makeBasis(0); // only need col(0)
-            if (U.cptr()) {
-                Muc U2(N-K-1,N-K-1);
-                dbgcout<<"U2: "<<U2.cptr()<<"  "<<U2.colsize()<<"  "<<U2.rowsize()<<"  "<<U2.stepi()<<"  "<<U2.stepj()<<std::endl;
-                Mucv U2v = U2.view();
-                U2.setToIdentity();
-                SVDecomposeFromBidiagonal_DC_Helper<
-                    11,xx,xx,Mucv,Vds,Ves,Mvcv>::call(
-                        U2v,D2,E2,V2v,true,V.cptr());
-                if (UisI) U.subMatrix(K+1,N,K+1,N) = U2;
-                else U.colRange(K+1,N) *= U2;
-            } else {
-                SVDecomposeFromBidiagonal_DC_Helper<
-                    11,xx,xx,Mu,Vds,Ves,Mvcv>::call(
-                        U,D2,E2,V2v,false,V.cptr());
-            }
-            dbgcout<<"After right sub-problem\n";
-            z.subVector(K+1,N) = EK * V2.col(0);
+            subProblems(U,D,E,V,UisI,VisI,K,z,intask);
             D(K) = RT(0);
-            if (V.cptr()) {
-                if (VisI) V.subMatrix(K+1,N,K+1,N) = V2;
-                else V.rowRange(K+1,N) = V2 * V.rowRange(K+1,N);
-            }
             dbgcout<<"Done subproblems (N="<<N<<")\n";
 #ifdef XDEBUG_SVD
             dbgcout<<"D = "<<D<<std::endl;
@@ -1357,7 +1478,7 @@ namespace tmv {
 
                 if (U.cptr() || V.cptr()) {
                     Matrix<RT,ColMajor> W(N,N); // W(i,j) = D(i)-S(j)
-                    FindDCSingularValues(S,RT(1),DN,zN,W);
+                    FindDCSingularValues(S,RT(1),DN,zN,W,intask);
                     dbgcout<<"S = "<<S<<std::endl;
 
                     // Update z's to numerically more stable values:
@@ -1415,7 +1536,7 @@ namespace tmv {
                         U.colRange(0,N) *= W;
                     }
                 } else {
-                    FindDCSingularValues(S,RT(1),DN,zN);
+                    FindDCSingularValues(S,RT(1),DN,zN,intask);
                     dbgcout<<"S = "<<S<<std::endl;
                 }
 
@@ -1526,21 +1647,13 @@ namespace tmv {
         }
     };
 
-    // TODO: Make OpenMP algorithm.
     // A note about OpenMP here:
     // Both the divide step (the recursion in algo 11)
     // and the conquer step (the loop in FindDCSingularValues) are
-    // pontentially parallelizable.  However, recursive functions do not
-    // lend themselves to being parallelized by OpenMP very easily.
-    // So I think I need to rewrite the divide step in a way that does
-    // not rely on recursion before I apply OPENMP pragmas to it.
-    // (Possibly use recursion to make a list of problems to do, and
-    // then have OpenMP parallelize the list of tasks at each level.)
-    // Anyway, for now we only have recursion in the FindDCSingularValues 
-    // function.
-    //
-    // Update: The new OpenMP 3.0 task feature may make this a lot easier.
-    // Try that first!
+    // parallelized.  The recursion uses OpenMP 3.0 tasks for the two 
+    // halves of each divide step (see subProblems above), and the 
+    // secular equation solves write their results directly with no
+    // critical section, since each one only writes its own S[k] and W.col(k).
 
     // algo 90: call InstSV_DecomposeFromBidiagonal_DC
     template <ptrdiff_t cs, ptrdiff_t rs, class Mu, class Vd, class Ve, class Mv>
@@ -1757,6 +1870,9 @@ namespace tmv {
 } // namespace tmv
 
 #undef TMV_DC_LIMIT
+#undef TMV_DC_OPENMP_THRESH
+#undef TMV_DC_OPENMP_TASKMIN
+#undef TMV_DC_OPENMP_CHUNK
 
 #endif
 
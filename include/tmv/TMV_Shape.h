@@ -397,6 +397,7 @@ namespace tmv {
                 nolower3 ? (
                     bothband ? bothunit ? UnitUpperBand : UpperBand :
                     bothunit ? UnitUpperTri : UpperTri ) :
+                bothsym && bothherm ? (eitherband ? RealSymBand : RealSym) :
                 bothsym ? (eitherband ? SymBand : Sym) :
                 bothherm ? (eitherband ? HermBand : Herm) :
                 eitherband ? Band : Rec ) };
@@ -406,6 +407,7 @@ namespace tmv {
                 noupper && nolower2 ? Diag :
                 noupper ? ( bothband ? LowerBand : LowerTri ) :
                 nolower ? ( bothband ? UpperBand : UpperTri ) :
+                bothsym && bothherm ? ( bothband ? RealSymBand : RealSym ) :
                 bothsym ? ( bothband ? SymBand : Sym ) :
                 bothherm ? ( bothband ? HermBand : Herm ) :
                 bothband || noupper2 || nolower2 ? Band :
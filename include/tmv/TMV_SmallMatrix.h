@@ -81,6 +81,10 @@ namespace tmv {
     template <class T> class InstQRPD;
     template <class M> class SVD;
     template <class T> class InstSVD;
+    template <class M> class CHD;
+    template <class T> class InstCHD;
+    template <class M> class LDLD;
+    template <class T> class InstLDLD;
 
     //
     // SmallMatrix
@@ -154,6 +158,10 @@ namespace tmv {
                 const InstQRPD<T>& , QRPD<copy_type> >::type qrpd_type;
         typedef typename TypeSelect<_hasdivider ,
                 const InstSVD<T>& , SVD<copy_type> >::type svd_type;
+        typedef typename TypeSelect<_hasdivider ,
+                const InstCHD<T>& , CHD<copy_type> >::type chd_type;
+        typedef typename TypeSelect<_hasdivider ,
+                const InstLDLD<T>& , LDLD<copy_type> >::type ldld_type;
 
         enum { vecA = (
                 (_fort ? FortranStyle : 0) |
@@ -504,6 +512,10 @@ namespace tmv {
                 const InstQRPD<T>& , QRPD<copy_type> >::type qrpd_type;
         typedef typename TypeSelect<_hasdivider ,
                 const InstSVD<T>& , SVD<copy_type> >::type svd_type;
+        typedef typename TypeSelect<_hasdivider ,
+                const InstCHD<T>& , CHD<copy_type> >::type chd_type;
+        typedef typename TypeSelect<_hasdivider ,
+                const InstLDLD<T>& , LDLD<copy_type> >::type ldld_type;
 
         enum { vecA = (
                 (_fort ? FortranStyle : 0) |
@@ -841,6 +853,10 @@ namespace tmv {
                 const InstQRPD<T>& , QRPD<copy_type> >::type qrpd_type;
         typedef typename TypeSelect<_hasdivider ,
                 const InstSVD<T>& , SVD<copy_type> >::type svd_type;
+        typedef typename TypeSelect<_hasdivider ,
+                const InstCHD<T>& , CHD<copy_type> >::type chd_type;
+        typedef typename TypeSelect<_hasdivider ,
+                const InstLDLD<T>& , LDLD<copy_type> >::type ldld_type;
 
         enum { vecA = (
                 (_fort ? FortranStyle : 0) |
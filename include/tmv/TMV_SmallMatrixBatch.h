@@ -0,0 +1,945 @@
+//---------------------------------------------------------------------------
+//
+// This file defines the TMV SmallMatrixBatch class, which holds a batch
+// of n independent M x N matrices, along with batched versions of the
+// common operations on them:
+//
+//    BatchMultMM<add>(x, A, B, C)   C[b] (+)= x * A[b] * B[b]
+//    BatchDet(A, d)                 d[b] = Det(A[b])
+//    BatchInvert(A, Ainv)           Ainv[b] = A[b]^-1
+//    BatchLU_Decompose(A, P)        A[b] = P[b] L[b] U[b] (in place)
+//    BatchLU_Solve(A, P, B)         B[b] = A[b]^-1 B[b], with A,P from
+//                                   BatchLU_Decompose.
+//    BatchCH_Decompose(A)           A[b] = L[b] L[b]^t (in place, using
+//                                   the lower triangle of A[b])
+//    BatchCH_Solve(A, B)            B[b] = A[b]^-1 B[b], with A from
+//                                   BatchCH_Decompose.
+//
+// The point of this is to handle the case where you have thousands
+// (or millions) of small matrices, say 2x2 to 8x8, to which you want
+// to apply the same operation.  Calling the SmallMatrix functions
+// for each one in turn spends most of its time on the overhead of
+// each call and can't use the vector registers very well.
+//
+// So the batch uses a "structure of arrays" storage: element (i,j) of
+// all n matrices is stored contiguously, and matrix b has its (i,j)
+// element at p[(i+j*M)*stride + b].  All the algorithms are written
+// with the innermost loop over the batch index b, which the compiler
+// can vectorize.  Each argument is processed in chunks of
+// TMV_BATCH_BLOCKSIZE matrices, so the chunk stays in cache for all
+// of the loops over i,j,k.
+//
+// With OpenMP, the chunks are split among the threads when the batch
+// has at least TMV_BATCH_OPENMP_THRESH matrices.
+//
+// Like SmallMatrix, there is no alias checking, so the output of
+// BatchMultMM should not be the same memory as either input.
+// (BatchInvert is ok with Ainv being the same as A.)
+//
+// The pivots for BatchLU_Decompose are stored as a batch of N x 1
+// int "matrices", i.e. SmallMatrixBatch<int,N,1>.  As for LU_Decompose,
+// P[b](k) is the row that was swapped with row k at step k.
+// A singular A[b] is not an error for BatchLU_Decompose, but it will
+// give inf or nan values from BatchLU_Solve.  BatchCH_Decompose throws
+// a NonPosDef exception if any of the A[b] is not positive definite.
+//
+//
+// Constructors:
+//
+//    SmallMatrixBatch<T,M,N>(ptrdiff_t n)
+//        Makes a batch of n M x N matrices with _uninitialized_ values.
+//        The stride is n rounded up to a multiple of TMV_BATCH_ALIGN.
+//
+//    SmallMatrixBatch<T,M,N>(ptrdiff_t n, T x)
+//        Makes a batch of n M x N matrices with all values = x.
+//
+//    SmallMatrixBatchView<T,M,N>(T* p, ptrdiff_t n, ptrdiff_t stride)
+//    ConstSmallMatrixBatchView<T,M,N>(const T* p, ptrdiff_t n,
+//            ptrdiff_t stride)
+//        A view of existing data stored in the above layout.
+//
+// Access:
+//
+//    size()
+//        The number of matrices in the batch.
+//
+//    stride()
+//        The step between element (i,j) and element (i+1,j) of the
+//        same matrix.  (So element (i,j+1) is M*stride further along.)
+//
+//    elem(i,j)
+//        Returns a VectorView of the (i,j) elements of all n matrices.
+//
+//    batch[b]
+//        Returns a SmallMatrixView of matrix b.
+//
+//    subBatch(b1,b2)
+//        Returns a view of matrices b1 .. b2-1.
+//
+//    setZero(), setAllTo(x), setToIdentity()
+//        Set all of the matrices to the given values.
+
+
+#ifndef TMV_SmallMatrixBatch_H
+#define TMV_SmallMatrixBatch_H
+
+#include "TMV_SmallMatrix.h"
+#include "TMV_Vector.h"
+#include "TMV_Array.h"
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace tmv {
+
+    // The number of matrices in each chunk of the batch.
+    // The largest temporary needed by the algorithms is one chunk
+    // of an N x N matrix.  (64 * 8x8 doubles = 32 KB.)
+#ifndef TMV_BATCH_BLOCKSIZE
+#define TMV_BATCH_BLOCKSIZE 64
+#endif
+
+    // The largest chunk temporary to put on the stack.  Larger ones
+    // (i.e. for large N) come from the scratch arena instead, since each
+    // OpenMP thread has its own, fairly small, stack.
+#ifndef TMV_BATCH_STACK_BYTES
+#define TMV_BATCH_STACK_BYTES 65536
+#endif
+
+    // The stride of a SmallMatrixBatch is a multiple of this many
+    // elements, so each elem(i,j) starts on an aligned boundary.
+#ifndef TMV_BATCH_ALIGN
+#define TMV_BATCH_ALIGN 8
+#endif
+
+    // The minimum batch size to split among the threads.
+#ifndef TMV_BATCH_OPENMP_THRESH
+#define TMV_BATCH_OPENMP_THRESH 4096
+#endif
+
+    template <class T, ptrdiff_t M, ptrdiff_t N>
+    class ConstSmallMatrixBatchView
+    {
+    public:
+
+        typedef T value_type;
+        typedef ConstSmallMatrixBatchView<T,M,N> type;
+        typedef ConstSmallMatrixView<T,M,N> const_matrix_type;
+        typedef ConstVectorView<T,Unit> const_elem_type;
+
+        TMV_INLINE ConstSmallMatrixBatchView(
+            const T* p, ptrdiff_t n, ptrdiff_t s) :
+            itsp(p), itsn(n), itss(s)
+        { TMVAssert(s >= n); }
+
+        TMV_INLINE ptrdiff_t size() const { return itsn; }
+        TMV_INLINE ptrdiff_t stride() const { return itss; }
+        TMV_INLINE const T* cptr() const { return itsp; }
+
+        TMV_INLINE const_elem_type elem(ptrdiff_t i, ptrdiff_t j) const
+        {
+            TMVAssert(i>=0 && i<M);
+            TMVAssert(j>=0 && j<N);
+            return const_elem_type(itsp+(i+j*M)*itss,itsn);
+        }
+
+        TMV_INLINE const_matrix_type operator[](ptrdiff_t b) const
+        {
+            TMVAssert(b>=0 && b<itsn);
+            return const_matrix_type(itsp+b,M,N,itss,M*itss);
+        }
+
+        TMV_INLINE type subBatch(ptrdiff_t b1, ptrdiff_t b2) const
+        {
+            TMVAssert(b1>=0 && b1<=b2 && b2<=itsn);
+            return type(itsp+b1,b2-b1,itss);
+        }
+
+    protected:
+
+        const T* itsp;
+        ptrdiff_t itsn;
+        ptrdiff_t itss;
+
+    }; // ConstSmallMatrixBatchView
+
+    template <class T, ptrdiff_t M, ptrdiff_t N>
+    class SmallMatrixBatchView :
+        public ConstSmallMatrixBatchView<T,M,N>
+    {
+    public:
+
+        typedef ConstSmallMatrixBatchView<T,M,N> base;
+        typedef SmallMatrixBatchView<T,M,N> type;
+        typedef SmallMatrixView<T,M,N> matrix_type;
+        typedef VectorView<T,Unit> elem_type;
+
+        TMV_INLINE SmallMatrixBatchView(T* p, ptrdiff_t n, ptrdiff_t s) :
+            base(p,n,s) {}
+
+        TMV_INLINE T* ptr() const { return const_cast<T*>(this->itsp); }
+
+        // As for the other views, assignment copies the data.
+        TMV_INLINE const type& operator=(const type& b2) const
+        { copyFrom(b2); return *this; }
+
+        TMV_INLINE elem_type elem(ptrdiff_t i, ptrdiff_t j) const
+        {
+            TMVAssert(i>=0 && i<M);
+            TMVAssert(j>=0 && j<N);
+            return elem_type(ptr()+(i+j*M)*this->itss,this->itsn);
+        }
+
+        TMV_INLINE matrix_type operator[](ptrdiff_t b) const
+        {
+            TMVAssert(b>=0 && b<this->itsn);
+            return matrix_type(ptr()+b,M,N,this->itss,M*this->itss);
+        }
+
+        TMV_INLINE type subBatch(ptrdiff_t b1, ptrdiff_t b2) const
+        {
+            TMVAssert(b1>=0 && b1<=b2 && b2<=this->itsn);
+            return type(ptr()+b1,b2-b1,this->itss);
+        }
+
+        void setAllTo(const T x) const
+        {
+            for(ptrdiff_t ij=0;ij<M*N;++ij) {
+                T* p = ptr() + ij*this->itss;
+                std::fill(p,p+this->itsn,x);
+            }
+        }
+
+        TMV_INLINE void setZero() const
+        { setAllTo(T(0)); }
+
+        void setToIdentity() const
+        {
+            TMVStaticAssert(M == N);
+            setZero();
+            for(ptrdiff_t i=0;i<N;++i) {
+                T* p = ptr() + i*(N+1)*this->itss;
+                std::fill(p,p+this->itsn,T(1));
+            }
+        }
+
+        template <class T2>
+        void copyFrom(const ConstSmallMatrixBatchView<T2,M,N>& b2) const
+        {
+            TMVAssert(b2.size() == this->itsn);
+            for(ptrdiff_t ij=0;ij<M*N;++ij) {
+                const T2* p2 = b2.cptr() + ij*b2.stride();
+                std::copy(p2,p2+this->itsn,ptr()+ij*this->itss);
+            }
+        }
+
+    }; // SmallMatrixBatchView
+
+    template <class T, ptrdiff_t M, ptrdiff_t N>
+    class SmallMatrixBatch :
+        public SmallMatrixBatchView<T,M,N>
+    {
+    public:
+
+        typedef SmallMatrixBatchView<T,M,N> base;
+        typedef SmallMatrixBatch<T,M,N> type;
+
+        explicit SmallMatrixBatch(ptrdiff_t n) :
+            base(0,n,AlignedStride(n)), itsm(M*N*AlignedStride(n))
+        { this->itsp = itsm.get(); }
+
+        SmallMatrixBatch(ptrdiff_t n, const T x) :
+            base(0,n,AlignedStride(n)), itsm(M*N*AlignedStride(n))
+        { this->itsp = itsm.get(); this->setAllTo(x); }
+
+        SmallMatrixBatch(const type& b2) :
+            base(0,b2.size(),b2.stride()), itsm(M*N*b2.stride())
+        { this->itsp = itsm.get(); this->copyFrom(b2); }
+
+        template <class T2>
+        SmallMatrixBatch(const ConstSmallMatrixBatchView<T2,M,N>& b2) :
+            base(0,b2.size(),AlignedStride(b2.size())),
+            itsm(M*N*AlignedStride(b2.size()))
+        { this->itsp = itsm.get(); this->copyFrom(b2); }
+
+        type& operator=(const type& b2)
+        {
+            TMVAssert(b2.size() == this->size());
+            if (&b2 != this) this->copyFrom(b2);
+            return *this;
+        }
+
+        TMV_INLINE T* ptr() { return itsm.get(); }
+        TMV_INLINE const T* cptr() const { return itsm.get(); }
+
+        static ptrdiff_t AlignedStride(ptrdiff_t n)
+        { return ((n + TMV_BATCH_ALIGN - 1) / TMV_BATCH_ALIGN) * TMV_BATCH_ALIGN; }
+
+    private:
+
+        AlignedArray<T> itsm;
+
+    }; // SmallMatrixBatch
+
+
+    // The storage for a chunk temporary of n elements.
+    // Use this inside a ScratchScope, so the large ones come from the
+    // scratch arena rather than the heap.
+    template <class T, ptrdiff_t n, 
+              bool small = (n*sizeof(T) <= TMV_BATCH_STACK_BYTES)>
+    struct BatchChunkTemp
+    {
+        T p[n];
+        T* get() { return p; }
+    };
+
+    template <class T, ptrdiff_t n>
+    struct BatchChunkTemp<T,n,false>
+    {
+        AlignedArray<T> p;
+        BatchChunkTemp() : p(n) {}
+        T* get() { return p.get(); }
+    };
+
+    //
+    // The driver for all of the batch operations.
+    // f(p1,n1) does the work for the n1 matrices starting at
+    // matrix number p1.
+    //
+
+    template <class F>
+    inline void BatchLoop(const ptrdiff_t n, const F& f)
+    {
+        const ptrdiff_t nb = TMV_BATCH_BLOCKSIZE;
+#ifdef _OPENMP
+        // As in MultMM, check omp_get_level() rather than omp_in_parallel(),
+        // so we don't start a new parallel region if we are already in one.
+        if (n >= TMV_BATCH_OPENMP_THRESH &&
+            omp_get_level() == 0 && omp_get_max_threads() > 1) {
+            const int nchunks = int((n-1)/nb + 1);
+#pragma omp parallel for schedule(static)
+            for(int c=0;c<nchunks;++c) {
+                const ptrdiff_t b1 = ptrdiff_t(c)*nb;
+                f(b1,TMV_MIN(nb,n-b1));
+            }
+            return;
+        }
+#endif
+        for(ptrdiff_t b1=0;b1<n;b1+=nb) f(b1,TMV_MIN(nb,n-b1));
+    }
+
+
+    //
+    // BatchMultMM
+    //
+
+    template <bool add, class T, ptrdiff_t M, ptrdiff_t K, ptrdiff_t N>
+    struct BatchMultMM_Helper
+    {
+        const T x;
+        const ConstSmallMatrixBatchView<T,M,K>& A;
+        const ConstSmallMatrixBatchView<T,K,N>& B;
+        const SmallMatrixBatchView<T,M,N>& C;
+
+        BatchMultMM_Helper(
+            const T _x, const ConstSmallMatrixBatchView<T,M,K>& _A,
+            const ConstSmallMatrixBatchView<T,K,N>& _B,
+            const SmallMatrixBatchView<T,M,N>& _C) :
+            x(_x), A(_A), B(_B), C(_C) {}
+
+        void operator()(const ptrdiff_t b1, const ptrdiff_t n) const
+        {
+            const ptrdiff_t sa = A.stride();
+            const ptrdiff_t sb = B.stride();
+            const ptrdiff_t sc = C.stride();
+            T sum[TMV_BATCH_BLOCKSIZE];
+            for(ptrdiff_t j=0;j<N;++j) for(ptrdiff_t i=0;i<M;++i) {
+                for(ptrdiff_t b=0;b<n;++b) sum[b] = T(0);
+                for(ptrdiff_t k=0;k<K;++k) {
+                    const T* aik = A.cptr() + (i+k*M)*sa + b1;
+                    const T* bkj = B.cptr() + (k+j*K)*sb + b1;
+                    for(ptrdiff_t b=0;b<n;++b) sum[b] += aik[b] * bkj[b];
+                }
+                T* cij = C.ptr() + (i+j*M)*sc + b1;
+                if (add)
+                    for(ptrdiff_t b=0;b<n;++b) cij[b] += x * sum[b];
+                else
+                    for(ptrdiff_t b=0;b<n;++b) cij[b] = x * sum[b];
+            }
+        }
+    };
+
+    template <bool add, class T, ptrdiff_t M, ptrdiff_t K, ptrdiff_t N>
+    inline void BatchMultMM(
+        const T x, const ConstSmallMatrixBatchView<T,M,K>& A,
+        const ConstSmallMatrixBatchView<T,K,N>& B,
+        const SmallMatrixBatchView<T,M,N>& C)
+    {
+        TMVAssert(A.size() == C.size());
+        TMVAssert(B.size() == C.size());
+        BatchLoop(C.size(),BatchMultMM_Helper<add,T,M,K,N>(x,A,B,C));
+    }
+
+
+    //
+    // The LU decomposition of a chunk of n matrices, each N x N,
+    // starting at a with a stride of s.  The pivots go into p with
+    // a stride of ps.  Returns nothing, but if dp is not 0,
+    // dp[b] is set to the parity of the permutation (+-1).
+    //
+
+    template <class T, ptrdiff_t N>
+    inline void BatchLU_Chunk(
+        T* a, const ptrdiff_t s, int* p, const ptrdiff_t ps,
+        const ptrdiff_t n, T* dp)
+    {
+        typedef typename Traits<T>::real_type RT;
+        int piv[TMV_BATCH_BLOCKSIZE];
+        RT maxval[TMV_BATCH_BLOCKSIZE];
+        T inv[TMV_BATCH_BLOCKSIZE];
+        if (dp) for(ptrdiff_t b=0;b<n;++b) dp[b] = T(1);
+
+        for(ptrdiff_t k=0;k<N;++k) {
+            // Find the pivot for each matrix.
+            // This is written with a select rather than a branch, so
+            // it can still be vectorized.
+            const T* akk = a + k*(N+1)*s;
+            for(ptrdiff_t b=0;b<n;++b) {
+                piv[b] = int(k);
+                maxval[b] = TMV_ABS2(akk[b]);
+            }
+            for(ptrdiff_t i=k+1;i<N;++i) {
+                const T* aik = a + (i+k*N)*s;
+                for(ptrdiff_t b=0;b<n;++b) {
+                    const RT v = TMV_ABS2(aik[b]);
+                    const bool bigger = v > maxval[b];
+                    maxval[b] = bigger ? v : maxval[b];
+                    piv[b] = bigger ? int(i) : piv[b];
+                }
+            }
+            int* pk = p + k*ps;
+            for(ptrdiff_t b=0;b<n;++b) pk[b] = piv[b];
+
+            // Swap the rows.  The swaps are different for each matrix,
+            // so this part doesn't vectorize, but it is only O(N^2).
+            for(ptrdiff_t b=0;b<n;++b) if (piv[b] != k) {
+                const ptrdiff_t ip = piv[b];
+                for(ptrdiff_t j=0;j<N;++j)
+                    TMV_SWAP(a[(k+j*N)*s+b],a[(ip+j*N)*s+b]);
+                if (dp) dp[b] = -dp[b];
+            }
+
+            // Scale the column below the diagonal.
+            // As in LU_Decompose, a zero pivot is allowed.  Just skip
+            // the scaling in that case.
+            for(ptrdiff_t b=0;b<n;++b)
+                inv[b] = akk[b] == T(0) ? T(0) : T(1) / akk[b];
+            for(ptrdiff_t i=k+1;i<N;++i) {
+                T* aik = a + (i+k*N)*s;
+                for(ptrdiff_t b=0;b<n;++b) aik[b] *= inv[b];
+            }
+
+            // Update the rest of the matrix.
+            for(ptrdiff_t j=k+1;j<N;++j) {
+                const T* akj = a + (k+j*N)*s;
+                for(ptrdiff_t i=k+1;i<N;++i) {
+                    const T* aik = a + (i+k*N)*s;
+                    T* aij = a + (i+j*N)*s;
+                    for(ptrdiff_t b=0;b<n;++b) aij[b] -= aik[b] * akj[b];
+                }
+            }
+        }
+    }
+
+    // Solve A x = b for a chunk of n LU-decomposed N x N matrices (a,p)
+    // and N x K right hand sides (x), overwriting x with the solution.
+    template <class T, ptrdiff_t N, ptrdiff_t K>
+    inline void BatchLUSolve_Chunk(
+        const T* a, const ptrdiff_t s, const int* p, const ptrdiff_t ps,
+        T* x, const ptrdiff_t sx, const ptrdiff_t n)
+    {
+        T inv[TMV_BATCH_BLOCKSIZE];
+
+        // x = P^-1 x
+        for(ptrdiff_t k=0;k<N;++k) {
+            const int* pk = p + k*ps;
+            for(ptrdiff_t b=0;b<n;++b) if (pk[b] != k) {
+                const ptrdiff_t ip = pk[b];
+                for(ptrdiff_t j=0;j<K;++j)
+                    TMV_SWAP(x[(k+j*N)*sx+b],x[(ip+j*N)*sx+b]);
+            }
+        }
+
+        for(ptrdiff_t j=0;j<K;++j) {
+            // x = L^-1 x
+            for(ptrdiff_t k=0;k<N;++k) {
+                const T* xkj = x + (k+j*N)*sx;
+                for(ptrdiff_t i=k+1;i<N;++i) {
+                    const T* aik = a + (i+k*N)*s;
+                    T* xij = x + (i+j*N)*sx;
+                    for(ptrdiff_t b=0;b<n;++b) xij[b] -= aik[b] * xkj[b];
+                }
+            }
+            // x = U^-1 x
+            for(ptrdiff_t k=N-1;k>=0;--k) {
+                const T* akk = a + k*(N+1)*s;
+                T* xkj = x + (k+j*N)*sx;
+                for(ptrdiff_t b=0;b<n;++b) inv[b] = T(1) / akk[b];
+                for(ptrdiff_t b=0;b<n;++b) xkj[b] *= inv[b];
+                for(ptrdiff_t i=0;i<k;++i) {
+                    const T* aik = a + (i+k*N)*s;
+                    T* xij = x + (i+j*N)*sx;
+                    for(ptrdiff_t b=0;b<n;++b) xij[b] -= aik[b] * xkj[b];
+                }
+            }
+        }
+    }
+
+
+    //
+    // BatchLU_Decompose, BatchLU_Solve
+    //
+
+    template <class T, ptrdiff_t N>
+    struct BatchLUDecompose_Helper
+    {
+        const SmallMatrixBatchView<T,N,N>& A;
+        const SmallMatrixBatchView<int,N,1>& P;
+
+        BatchLUDecompose_Helper(
+            const SmallMatrixBatchView<T,N,N>& _A,
+            const SmallMatrixBatchView<int,N,1>& _P) : A(_A), P(_P) {}
+
+        void operator()(const ptrdiff_t b1, const ptrdiff_t n) const
+        {
+            BatchLU_Chunk<T,N>(
+                A.ptr()+b1,A.stride(),P.ptr()+b1,P.stride(),n,(T*)(0));
+        }
+    };
+
+    template <class T, ptrdiff_t N>
+    inline void BatchLU_Decompose(
+        const SmallMatrixBatchView<T,N,N>& A,
+        const SmallMatrixBatchView<int,N,1>& P)
+    {
+        TMVAssert(P.size() == A.size());
+        BatchLoop(A.size(),BatchLUDecompose_Helper<T,N>(A,P));
+    }
+
+    template <class T, ptrdiff_t N, ptrdiff_t K>
+    struct BatchLUSolve_Helper
+    {
+        const ConstSmallMatrixBatchView<T,N,N>& A;
+        const ConstSmallMatrixBatchView<int,N,1>& P;
+        const SmallMatrixBatchView<T,N,K>& B;
+
+        BatchLUSolve_Helper(
+            const ConstSmallMatrixBatchView<T,N,N>& _A,
+            const ConstSmallMatrixBatchView<int,N,1>& _P,
+            const SmallMatrixBatchView<T,N,K>& _B) : A(_A), P(_P), B(_B) {}
+
+        void operator()(const ptrdiff_t b1, const ptrdiff_t n) const
+        {
+            BatchLUSolve_Chunk<T,N,K>(
+                A.cptr()+b1,A.stride(),P.cptr()+b1,P.stride(),
+                B.ptr()+b1,B.stride(),n);
+        }
+    };
+
+    template <class T, ptrdiff_t N, ptrdiff_t K>
+    inline void BatchLU_Solve(
+        const ConstSmallMatrixBatchView<T,N,N>& A,
+        const ConstSmallMatrixBatchView<int,N,1>& P,
+        const SmallMatrixBatchView<T,N,K>& B)
+    {
+        TMVAssert(P.size() == A.size());
+        TMVAssert(B.size() == A.size());
+        BatchLoop(A.size(),BatchLUSolve_Helper<T,N,K>(A,P,B));
+    }
+
+
+    //
+    // BatchDet
+    //
+
+    // The algorithms are numbered to match the ones in TMV_Det.h:
+    // algo 1: N == 1
+    // algo 2: N == 2
+    // algo 3: N == 3
+    // algo 4: N == 4
+    // algo 11: Use the LU decomposition of a copy of each chunk.
+    template <int algo, class T, ptrdiff_t N>
+    struct BatchDet_Helper;
+
+    template <class T, ptrdiff_t N>
+    struct BatchDet_Helper<1,T,N>
+    {
+        static void call(const T* a, const ptrdiff_t , T* d, const ptrdiff_t n)
+        { for(ptrdiff_t b=0;b<n;++b) d[b] = a[b]; }
+    };
+
+    template <class T, ptrdiff_t N>
+    struct BatchDet_Helper<2,T,N>
+    {
+        static void call(const T* a, const ptrdiff_t s, T* d, const ptrdiff_t n)
+        {
+            const T* a00 = a;     const T* a01 = a+2*s;
+            const T* a10 = a+s;   const T* a11 = a+3*s;
+            for(ptrdiff_t b=0;b<n;++b)
+                d[b] = a00[b]*a11[b] - a01[b]*a10[b];
+        }
+    };
+
+    template <class T, ptrdiff_t N>
+    struct BatchDet_Helper<3,T,N>
+    {
+        static void call(const T* a, const ptrdiff_t s, T* d, const ptrdiff_t n)
+        {
+            const T* a00 = a;     const T* a01 = a+3*s; const T* a02 = a+6*s;
+            const T* a10 = a+s;   const T* a11 = a+4*s; const T* a12 = a+7*s;
+            const T* a20 = a+2*s; const T* a21 = a+5*s; const T* a22 = a+8*s;
+            for(ptrdiff_t b=0;b<n;++b)
+                d[b] =
+                    a00[b]*(a11[b]*a22[b]-a12[b]*a21[b]) -
+                    a01[b]*(a10[b]*a22[b]-a12[b]*a20[b]) +
+                    a02[b]*(a10[b]*a21[b]-a11[b]*a20[b]);
+        }
+    };
+
+    template <class T, ptrdiff_t N>
+    struct BatchDet_Helper<4,T,N>
+    {
+        static void call(const T* a, const ptrdiff_t s, T* d, const ptrdiff_t n)
+        {
+            // See DetM_Helper<4> for the derivation of this formula.
+            // (Here the letters are a..p going across the rows.)
+            const T* ma = a;     const T* mb = a+4*s;
+            const T* mc = a+8*s; const T* md = a+12*s;
+            const T* me = a+s;   const T* mf = a+5*s;
+            const T* mg = a+9*s; const T* mh = a+13*s;
+            const T* mi = a+2*s; const T* mj = a+6*s;
+            const T* mk = a+10*s; const T* ml = a+14*s;
+            const T* mm = a+3*s; const T* mn = a+7*s;
+            const T* mo = a+11*s; const T* mp = a+15*s;
+            for(ptrdiff_t b=0;b<n;++b)
+                d[b] =
+                    (ma[b]*mf[b]-mb[b]*me[b])*(mk[b]*mp[b]-ml[b]*mo[b]) -
+                    (ma[b]*mg[b]-mc[b]*me[b])*(mj[b]*mp[b]-ml[b]*mn[b]) +
+                    (ma[b]*mh[b]-md[b]*me[b])*(mj[b]*mo[b]-mk[b]*mn[b]) +
+                    (mb[b]*mg[b]-mc[b]*mf[b])*(mi[b]*mp[b]-ml[b]*mm[b]) -
+                    (mb[b]*mh[b]-md[b]*mf[b])*(mi[b]*mo[b]-mk[b]*mm[b]) +
+                    (mc[b]*mh[b]-md[b]*mg[b])*(mi[b]*mn[b]-mj[b]*mm[b]);
+        }
+    };
+
+    template <class T, ptrdiff_t N>
+    struct BatchDet_Helper<11,T,N>
+    {
+        static void call(const T* a, const ptrdiff_t s, T* d, const ptrdiff_t n)
+        {
+            const ptrdiff_t nb = TMV_BATCH_BLOCKSIZE;
+            ScratchScope scope;
+            BatchChunkTemp<T,N*N*TMV_BATCH_BLOCKSIZE> lutemp;
+            BatchChunkTemp<int,N*TMV_BATCH_BLOCKSIZE> ptemp;
+            T* lu = lutemp.get();
+            int* p = ptemp.get();
+            for(ptrdiff_t ij=0;ij<N*N;++ij)
+                std::copy(a+ij*s,a+ij*s+n,lu+ij*nb);
+            BatchLU_Chunk<T,N>(lu,nb,p,nb,n,d);
+            for(ptrdiff_t k=0;k<N;++k) {
+                const T* ukk = lu + k*(N+1)*nb;
+                for(ptrdiff_t b=0;b<n;++b) d[b] *= ukk[b];
+            }
+        }
+    };
+
+    template <class T, ptrdiff_t N>
+    struct BatchDetM_Helper
+    {
+        const ConstSmallMatrixBatchView<T,N,N>& A;
+        T* d;
+        const ptrdiff_t ds;
+
+        BatchDetM_Helper(
+            const ConstSmallMatrixBatchView<T,N,N>& _A, T* _d, ptrdiff_t _ds) :
+            A(_A), d(_d), ds(_ds) {}
+
+        void operator()(const ptrdiff_t b1, const ptrdiff_t n) const
+        {
+            const int algo = N <= 4 ? int(N) : 11;
+            if (ds == 1) {
+                BatchDet_Helper<algo,T,N>::call(
+                    A.cptr()+b1,A.stride(),d+b1,n);
+            } else {
+                T dd[TMV_BATCH_BLOCKSIZE];
+                BatchDet_Helper<algo,T,N>::call(
+                    A.cptr()+b1,A.stride(),dd,n);
+                for(ptrdiff_t b=0;b<n;++b) d[(b1+b)*ds] = dd[b];
+            }
+        }
+    };
+
+    template <class T, ptrdiff_t N, class V>
+    inline void BatchDet(
+        const ConstSmallMatrixBatchView<T,N,N>& A, BaseVector_Mutable<V>& d)
+    {
+        TMVStaticAssert((Traits2<T,typename V::value_type>::sametype));
+        TMVStaticAssert(!V::_conj);
+        TMVAssert(d.size() == A.size());
+        BatchLoop(A.size(),BatchDetM_Helper<T,N>(A,d.ptr(),d.step()));
+    }
+
+
+    //
+    // BatchInvert
+    //
+
+    // algo 1: N == 1
+    // algo 2: N == 2
+    // algo 3: N == 3
+    // algo 11: Use the LU decomposition of a copy of each chunk, and
+    //          solve for the identity matrix.
+    // All of these are safe for ai to be the same memory as a.
+    template <int algo, class T, ptrdiff_t N>
+    struct BatchInvert_Helper;
+
+    template <class T, ptrdiff_t N>
+    struct BatchInvert_Helper<1,T,N>
+    {
+        static void call(
+            const T* a, const ptrdiff_t , T* ai, const ptrdiff_t ,
+            const ptrdiff_t n)
+        { for(ptrdiff_t b=0;b<n;++b) ai[b] = T(1) / a[b]; }
+    };
+
+    template <class T, ptrdiff_t N>
+    struct BatchInvert_Helper<2,T,N>
+    {
+        static void call(
+            const T* a, const ptrdiff_t s, T* ai, const ptrdiff_t si,
+            const ptrdiff_t n)
+        {
+            for(ptrdiff_t b=0;b<n;++b) {
+                const T a00 = a[b];     const T a01 = a[2*s+b];
+                const T a10 = a[s+b];   const T a11 = a[3*s+b];
+                const T invdet = T(1) / (a00*a11 - a01*a10);
+                ai[b] = a11 * invdet;
+                ai[si+b] = -a10 * invdet;
+                ai[2*si+b] = -a01 * invdet;
+                ai[3*si+b] = a00 * invdet;
+            }
+        }
+    };
+
+    template <class T, ptrdiff_t N>
+    struct BatchInvert_Helper<3,T,N>
+    {
+        static void call(
+            const T* a, const ptrdiff_t s, T* ai, const ptrdiff_t si,
+            const ptrdiff_t n)
+        {
+            for(ptrdiff_t b=0;b<n;++b) {
+                const T a00 = a[b];     const T a01 = a[3*s+b];
+                const T a02 = a[6*s+b];
+                const T a10 = a[s+b];   const T a11 = a[4*s+b];
+                const T a12 = a[7*s+b];
+                const T a20 = a[2*s+b]; const T a21 = a[5*s+b];
+                const T a22 = a[8*s+b];
+                // The cofactors
+                const T c00 = a11*a22-a12*a21;
+                const T c01 = a12*a20-a10*a22;
+                const T c02 = a10*a21-a11*a20;
+                const T invdet = T(1) / (a00*c00 + a01*c01 + a02*c02);
+                ai[b] = c00 * invdet;
+                ai[si+b] = c01 * invdet;
+                ai[2*si+b] = c02 * invdet;
+                ai[3*si+b] = (a02*a21-a01*a22) * invdet;
+                ai[4*si+b] = (a00*a22-a02*a20) * invdet;
+                ai[5*si+b] = (a01*a20-a00*a21) * invdet;
+                ai[6*si+b] = (a01*a12-a02*a11) * invdet;
+                ai[7*si+b] = (a02*a10-a00*a12) * invdet;
+                ai[8*si+b] = (a00*a11-a01*a10) * invdet;
+            }
+        }
+    };
+
+    template <class T, ptrdiff_t N>
+    struct BatchInvert_Helper<11,T,N>
+    {
+        static void call(
+            const T* a, const ptrdiff_t s, T* ai, const ptrdiff_t si,
+            const ptrdiff_t n)
+        {
+            const ptrdiff_t nb = TMV_BATCH_BLOCKSIZE;
+            ScratchScope scope;
+            BatchChunkTemp<T,N*N*TMV_BATCH_BLOCKSIZE> lutemp;
+            BatchChunkTemp<int,N*TMV_BATCH_BLOCKSIZE> ptemp;
+            T* lu = lutemp.get();
+            int* p = ptemp.get();
+            for(ptrdiff_t ij=0;ij<N*N;++ij)
+                std::copy(a+ij*s,a+ij*s+n,lu+ij*nb);
+            BatchLU_Chunk<T,N>(lu,nb,p,nb,n,(T*)(0));
+            for(ptrdiff_t j=0;j<N;++j) for(ptrdiff_t i=0;i<N;++i)
+                std::fill(ai+(i+j*N)*si,ai+(i+j*N)*si+n,T(i==j?1:0));
+            BatchLUSolve_Chunk<T,N,N>(lu,nb,p,nb,ai,si,n);
+        }
+    };
+
+    template <class T, ptrdiff_t N>
+    struct BatchInvertM_Helper
+    {
+        const ConstSmallMatrixBatchView<T,N,N>& A;
+        const SmallMatrixBatchView<T,N,N>& Ainv;
+
+        BatchInvertM_Helper(
+            const ConstSmallMatrixBatchView<T,N,N>& _A,
+            const SmallMatrixBatchView<T,N,N>& _Ainv) : A(_A), Ainv(_Ainv) {}
+
+        void operator()(const ptrdiff_t b1, const ptrdiff_t n) const
+        {
+            const int algo = N <= 3 ? int(N) : 11;
+            BatchInvert_Helper<algo,T,N>::call(
+                A.cptr()+b1,A.stride(),Ainv.ptr()+b1,Ainv.stride(),n);
+        }
+    };
+
+    template <class T, ptrdiff_t N>
+    inline void BatchInvert(
+        const ConstSmallMatrixBatchView<T,N,N>& A,
+        const SmallMatrixBatchView<T,N,N>& Ainv)
+    {
+        TMVAssert(Ainv.size() == A.size());
+        BatchLoop(A.size(),BatchInvertM_Helper<T,N>(A,Ainv));
+    }
+
+
+    //
+    // BatchCH_Decompose, BatchCH_Solve
+    //
+
+    template <class T, ptrdiff_t N>
+    struct BatchCHDecompose_Helper
+    {
+        typedef typename Traits<T>::real_type RT;
+        const SmallMatrixBatchView<T,N,N>& A;
+        ptrdiff_t* nfail;
+
+        BatchCHDecompose_Helper(
+            const SmallMatrixBatchView<T,N,N>& _A, ptrdiff_t* _nfail) :
+            A(_A), nfail(_nfail) {}
+
+        void operator()(const ptrdiff_t b1, const ptrdiff_t n) const
+        {
+            // The usual column by column algorithm:
+            // L(j,j) = sqrt(A(j,j) - Sum_k<j |L(j,k)|^2)
+            // L(i,j) = (A(i,j) - Sum_k<j L(i,k) L(j,k)*) / L(j,j)
+            const ptrdiff_t s = A.stride();
+            T* a = A.ptr() + b1;
+            RT inv[TMV_BATCH_BLOCKSIZE];
+            ptrdiff_t nbad = 0;
+            for(ptrdiff_t j=0;j<N;++j) {
+                T* ajj = a + j*(N+1)*s;
+                for(ptrdiff_t k=0;k<j;++k) {
+                    const T* ajk = a + (j+k*N)*s;
+                    for(ptrdiff_t b=0;b<n;++b) ajj[b] -= TMV_NORM(ajk[b]);
+                }
+                for(ptrdiff_t b=0;b<n;++b) {
+                    const RT d = TMV_REAL(ajj[b]);
+                    if (d > RT(0)) {
+                        ajj[b] = TMV_SQRT(d);
+                        inv[b] = RT(1) / TMV_REAL(ajj[b]);
+                    } else {
+                        ++nbad;
+                        inv[b] = RT(0);
+                    }
+                }
+                for(ptrdiff_t k=0;k<j;++k) {
+                    const T* ajk = a + (j+k*N)*s;
+                    for(ptrdiff_t i=j+1;i<N;++i) {
+                        const T* aik = a + (i+k*N)*s;
+                        T* aij = a + (i+j*N)*s;
+                        for(ptrdiff_t b=0;b<n;++b)
+                            aij[b] -= aik[b] * TMV_CONJ(ajk[b]);
+                    }
+                }
+                for(ptrdiff_t i=j+1;i<N;++i) {
+                    T* aij = a + (i+j*N)*s;
+                    for(ptrdiff_t b=0;b<n;++b) aij[b] *= inv[b];
+                }
+            }
+            if (nbad) {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+                *nfail += nbad;
+            }
+        }
+    };
+
+    template <class T, ptrdiff_t N>
+    inline void BatchCH_Decompose(const SmallMatrixBatchView<T,N,N>& A)
+    {
+        ptrdiff_t nfail = 0;
+        BatchLoop(A.size(),BatchCHDecompose_Helper<T,N>(A,&nfail));
+        if (nfail) ThrowNonPosDef("BatchCH_Decompose");
+    }
+
+    template <class T, ptrdiff_t N, ptrdiff_t K>
+    struct BatchCHSolve_Helper
+    {
+        const ConstSmallMatrixBatchView<T,N,N>& A;
+        const SmallMatrixBatchView<T,N,K>& B;
+
+        BatchCHSolve_Helper(
+            const ConstSmallMatrixBatchView<T,N,N>& _A,
+            const SmallMatrixBatchView<T,N,K>& _B) : A(_A), B(_B) {}
+
+        void operator()(const ptrdiff_t b1, const ptrdiff_t n) const
+        {
+            const ptrdiff_t s = A.stride();
+            const ptrdiff_t sx = B.stride();
+            const T* a = A.cptr() + b1;
+            T* x = B.ptr() + b1;
+            for(ptrdiff_t j=0;j<K;++j) {
+                // x = L^-1 x
+                for(ptrdiff_t k=0;k<N;++k) {
+                    const T* akk = a + k*(N+1)*s;
+                    T* xkj = x + (k+j*N)*sx;
+                    for(ptrdiff_t b=0;b<n;++b) xkj[b] /= TMV_REAL(akk[b]);
+                    for(ptrdiff_t i=k+1;i<N;++i) {
+                        const T* aik = a + (i+k*N)*s;
+                        T* xij = x + (i+j*N)*sx;
+                        for(ptrdiff_t b=0;b<n;++b)
+                            xij[b] -= aik[b] * xkj[b];
+                    }
+                }
+                // x = Lt^-1 x
+                for(ptrdiff_t k=N-1;k>=0;--k) {
+                    const T* akk = a + k*(N+1)*s;
+                    T* xkj = x + (k+j*N)*sx;
+                    for(ptrdiff_t i=k+1;i<N;++i) {
+                        const T* aik = a + (i+k*N)*s;
+                        const T* xij = x + (i+j*N)*sx;
+                        for(ptrdiff_t b=0;b<n;++b)
+                            xkj[b] -= TMV_CONJ(aik[b]) * xij[b];
+                    }
+                    for(ptrdiff_t b=0;b<n;++b) xkj[b] /= TMV_REAL(akk[b]);
+                }
+            }
+        }
+    };
+
+    template <class T, ptrdiff_t N, ptrdiff_t K>
+    inline void BatchCH_Solve(
+        const ConstSmallMatrixBatchView<T,N,N>& A,
+        const SmallMatrixBatchView<T,N,K>& B)
+    {
+        TMVAssert(B.size() == A.size());
+        BatchLoop(A.size(),BatchCHSolve_Helper<T,N,K>(A,B));
+    }
+
+} // namespace tmv
+
+#endif
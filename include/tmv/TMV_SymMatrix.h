@@ -0,0 +1,1320 @@
+//---------------------------------------------------------------------------
+//
+// This file defines the TMV SymMatrix and HermMatrix classes.
+//
+// A SymMatrix is a symmetric matrix, m(i,j) = m(j,i), and a HermMatrix
+// is a hermitian matrix, m(i,j) = conj(m(j,i)).  For real value types,
+// the two are the same thing.
+//
+// Only one triangle of the matrix is stored.  The other triangle is
+// obtained from it by symmetry.
+//
+// As usual, the first template parameter is the type of the data,
+// and the optional second template parameter specifies the known
+// attributes.  The valid attributs for a SymMatrix are:
+// - ColMajor or RowMajor
+// - CStyle or FortranStyle
+// - Lower or Upper
+// - Packed or not
+// The defaults are (ColMajor,CStyle,Lower) if you do not specify
+// otherwise.
+//
+// Lower or Upper gives which triangle is actually stored in memory.
+// The normal storage uses a full n x n block of memory, and only
+// the elements in the stored triangle are referenced.
+// Packed storage uses only n(n+1)/2 elements, with the stored triangle
+// packed in the usual LAPACK way: for Lower|ColMajor (or equivalently
+// Upper|RowMajor) the columns of the lower triangle follow each other
+// in memory, and for Lower|RowMajor (or Upper|ColMajor) the rows
+// of the lower triangle follow each other.  Packed matrices do not
+// have any of the views described below besides view() itself, and
+// the various kernel functions use a slower loop for them.
+//
+// Constructors:
+//
+//    SymMatrix<T,A>(int n)
+//        Makes a SymMatrix with column size = row size = n
+//        with _uninitialized_ values.
+//
+//    SymMatrix<T,A>(int n, T x)
+//        Makes a SymMatrix with all values = x
+//
+//    SymMatrix<T,A>(const Matrix<T>& m)
+//        Makes a SymMatrix which copies the stored triangle of m.
+//        The other triangle of m is ignored.
+//
+//    SymMatrix<T,A>(const SymMatrix<T>& m)
+//    SymMatrix<T,A>(const DiagMatrix<T>& m)
+//        Copy constructors.
+//
+//    HermMatrix is the same with Herm in place of Sym.  For a HermMatrix,
+//    the diagonal elements must be real.
+//
+//
+// Access Functions
+//
+//    int colsize() const
+//    int rowsize() const
+//    int size() const
+//        Return the dimensions of the SymMatrix
+//
+//    value_type operator()(int i, int j) const
+//    value_type cref(int i, int j) const
+//        Return the (i,j) element of the SymMatrix.  This may be in either
+//        triangle.
+//
+//    reference operator()(int i, int j)
+//    reference ref(int i, int j)
+//        Return a reference to the (i,j) element of the SymMatrix.
+//        Assigning to m(i,j) is the same as assigning to m(j,i).
+//
+//    diag_type diag()
+//    const_diag_type diag() const
+//        Return the main diagonal
+//
+//
+// Functions of Matrices:
+//
+//    The usual norms and sums of the elements are all available:
+//    trace, sumElements, sumAbsElements, maxAbsElement, normSq, normF,
+//    norm1, normInf, norm2, condition.  These only loop over the
+//    stored triangle.
+//
+//
+// Modifying Functions
+//
+//    type& setZero()
+//    type& setAllTo(value_type x)
+//    type& addToAll(value_type x)
+//    type& clip(real_type thresh)
+//    type& applyToAll(const F& f)
+//    type& conjugateSelf()
+//    type& transposeSelf()
+//    type& setToIdentity(value_type x = 1)
+//    Swap(SymMatrix& m1, SymMatrix& m2)
+//
+//
+// Views of a SymMatrix:
+//
+//    (As usual, all of these have a const_version as well.)
+//
+//    subsymmatrix_type subSymMatrix(int i1, int i2)
+//        Returns the SymMatrix which runs from i1 to i2 along the diagonal
+//        (not including i2).
+//
+//    submatrix_type subMatrix(int i1, int i2, int j1, int j2)
+//        Returns a regular MatrixView of a portion of the matrix.
+//        This needs to be entirely within the stored triangle.
+//
+//    uppertri_type upperTri()
+//    lowertri_type lowerTri()
+//        Returns a TriMatrixView of the upper or lower triangle.
+//        Either one is valid, regardless of which triangle is stored.
+//
+//    view_type view()
+//    transpose_type transpose()
+//    conjugate_type conjugate()
+//    adjoint_type adjoint()
+//    realpart_type realPart()
+//    imagpart_type imagPart()
+//        The imagPart of a HermMatrix is anti-symmetric, so that
+//        one is not allowed.
+//
+//
+// I/O:
+//
+//    os << m
+//        Writes m to ostream os in the usual Matrix format
+//
+//    os << CompactIO() << m
+//        Writes m to ostream os in the following compact format:
+//        For a SymMatrix:
+//          S n
+//          ( m(0,0) )
+//          ( m(1,0) m(1,1) )
+//          ...
+//          ( m(n-1,0) ... m(n-1,n-1) )
+//        For a HermMatrix, the initial S is replaced with H.
+//
+//
+// Arithmetic:
+//
+//    The basic arithmetic with a SymMatrix and a Vector or another Matrix
+//    is available.  See TMV_MultSV.h, TMV_MultSM.h and TMV_RankKMMS.h for
+//    the special routines for symmetric matrices, in particular the 
+//    rank-k updates
+//    m += x * A * A.transpose() and m += x * (A * B.transpose() + B *
+//    A.transpose()), which only calculate the stored triangle of m.
+//
+
+
+#ifndef TMV_SymMatrix_H
+#define TMV_SymMatrix_H
+
+#include "TMV_BaseMatrix_Sym.h"
+#include "TMV_VIt.h"
+#include "TMV_MIt.h"
+#include "TMV_Array.h"
+
+namespace tmv {
+
+    //
+    // The attributes of a SymMatrix or HermMatrix.
+    //
+
+    template <int A0>
+    struct SymMatrixAttrib
+    {
+        enum { A = (A0 & ~NoDivider & ~CheckAlias & ~WithDivider) | (
+                ( Attrib<A0>::rowmajor ? 0 : ColMajor ) |
+                ( Attrib<A0>::upper ? 0 : Lower ) )};
+        enum { okA = (
+                !Attrib<A>::conj &&
+                (Attrib<A>::rowmajor || Attrib<A>::colmajor) &&
+                (Attrib<A>::rowmajor != int(Attrib<A>::colmajor)) &&
+                !Attrib<A>::diagmajor &&
+                !Attrib<A>::unitdiag &&
+                !Attrib<A>::nonunitdiag &&
+                !Attrib<A>::zerodiag &&
+                (Attrib<A>::upper != int(Attrib<A>::lower)) &&
+                !Attrib<A>::checkalias &&
+                !Attrib<A0>::nodivider &&
+                !Attrib<A0>::withdivider )};
+    };
+
+    template <class T, int A0>
+    struct SymViewAttrib
+    {
+        enum { A = (A0 & ~NoDivider & ~CheckAlias) | (
+                ( Attrib<A0>::upper ? 0 : Lower ) )};
+        enum { okA = (
+                !Attrib<A>::diagmajor &&
+                !Attrib<A>::unitdiag &&
+                !Attrib<A>::nonunitdiag &&
+                !Attrib<A>::zerodiag &&
+                !Attrib<A>::packed &&
+                (Attrib<A>::upper != int(Attrib<A>::lower)) &&
+                !Attrib<A>::checkalias &&
+                !Attrib<A>::nodivider &&
+                !Attrib<A>::withdivider &&
+                ( Traits<T>::iscomplex || !Attrib<A>::conj ) )};
+    };
+
+    // The index into the packed storage of an element (i,j) in the
+    // stored triangle.  colpack is true for Lower|ColMajor and
+    // Upper|RowMajor, where the columns of the lower triangle are
+    // contiguous in memory.  Otherwise the rows of the lower triangle are.
+    template <bool upper, bool colpack>
+    struct SymPackedIndex
+    {
+        static TMV_INLINE ptrdiff_t call(ptrdiff_t n, ptrdiff_t i, ptrdiff_t j)
+        {
+            const ptrdiff_t r = upper ? j : i;
+            const ptrdiff_t c = upper ? i : j;
+            return c*(2*n-c+1)/2 + r-c;
+        }
+    };
+    template <bool upper>
+    struct SymPackedIndex<upper,false>
+    {
+        static TMV_INLINE ptrdiff_t call(ptrdiff_t , ptrdiff_t i, ptrdiff_t j)
+        {
+            const ptrdiff_t r = upper ? j : i;
+            const ptrdiff_t c = upper ? i : j;
+            return r*(r+1)/2 + c;
+        }
+    };
+
+    // Assigning a general matrix to a SymMatrix is not allowed, since
+    // it is not known to be symmetric.  But the constructor takes the
+    // stored triangle of a general matrix, ignoring the other triangle.
+    template <bool assignable_to_sym>
+    struct SymCopy // assignable
+    {
+        template <class M1, class M2>
+        static TMV_INLINE void copy(
+            const BaseMatrix<M1>& m1, BaseMatrix_Sym_Mutable<M2>& m2)
+        { m2.noAlias() = m1; }
+    };
+    template <>
+    struct SymCopy<false>
+    {
+        template <class M1, class M2>
+        static void copy(
+            const BaseMatrix<M1>& m1, BaseMatrix_Sym_Mutable<M2>& m2)
+        {
+            typename M1::calc_type m1c = m1.calc();
+            const ptrdiff_t n = m2.size();
+            for(ptrdiff_t j=0;j<n;++j) {
+                const ptrdiff_t i1 = m2.isupper() ? 0 : j;
+                const ptrdiff_t i2 = m2.isupper() ? j+1 : n;
+                for(ptrdiff_t i=i1;i<i2;++i) m2.ref(i,j) = m1c.cref(i,j);
+            }
+        }
+    };
+
+    template <bool herm, class T>
+    struct SymRefHelper // herm = false, or real T
+    {
+        template <bool C>
+        static TMV_INLINE typename AuxRef<T,C>::reference makeRef(
+            T& x, bool )
+        { return typename AuxRef<T,C>::reference(x); }
+    };
+    template <class T>
+    struct SymRefHelper<true,std::complex<T> >
+    {
+        template <bool C>
+        static TMV_INLINE HermRef<std::complex<T> > makeRef(
+            std::complex<T>& x, bool mirror)
+        { return HermRef<std::complex<T> >(x,C != mirror); }
+    };
+
+
+    //
+    // SymMatrix
+    //
+
+    template <class T, int A0>
+    struct Traits<SymMatrix<T,A0> > :
+        public SymTraits<T,SymMatrixAttrib<A0>::A,false,SymMatrix<T,A0> >
+    {
+        enum { okA = SymMatrixAttrib<A0>::okA };
+    };
+
+    template <class T, int A>
+    class SymMatrix :
+        public BaseMatrix_Sym_Mutable<SymMatrix<T,A> >
+    {
+    public:
+        typedef SymMatrix<T,A> type;
+        typedef BaseMatrix_Sym_Mutable<type> base_mut;
+        typedef typename Traits<type>::reference reference;
+        typedef VectorView<T,Unit> linearview_type;
+        typedef ConstVectorView<T,Unit> const_linearview_type;
+
+        enum { _colsize = Traits<type>::_size };
+        enum { _rowsize = Traits<type>::_size };
+        enum { _size = Traits<type>::_size };
+        enum { _shape = Traits<type>::_shape };
+        enum { _fort = Traits<type>::_fort };
+        enum { _calc = Traits<type>::_calc };
+        enum { _rowmajor = Traits<type>::_rowmajor };
+        enum { _colmajor = Traits<type>::_colmajor };
+        enum { _conj = Traits<type>::_conj };
+        enum { _checkalias = Traits<type>::_checkalias };
+        enum { _stepi = Traits<type>::_stepi };
+        enum { _stepj = Traits<type>::_stepj };
+        enum { _diagstep = Traits<type>::_diagstep };
+        enum { _herm = Traits<type>::_herm };
+        enum { _packed = Traits<type>::_packed };
+        enum { _upper = Traits<type>::_upper };
+        enum { _attrib = Traits<type>::_attrib };
+
+        //
+        // Constructors
+        //
+
+        explicit SymMatrix(ptrdiff_t n=0) :
+            itss(n), itsm(_packed ? n*(n+1)/2 : n*n)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            TMVAssert(n >= 0);
+#ifdef TMV_EXTRA_DEBUG
+            this->setAllTo(Traits<T>::constr_value());
+#endif
+        }
+
+        SymMatrix(ptrdiff_t n, T x) :
+            itss(n), itsm(_packed ? n*(n+1)/2 : n*n)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            TMVAssert(n >= 0);
+            this->setAllTo(x);
+        }
+
+        SymMatrix(const type& m2) :
+            itss(m2.size()), itsm(_packed ? itss*(itss+1)/2 : itss*itss)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            this->noAlias() = m2;
+        }
+
+        template <class M2>
+        SymMatrix(const BaseMatrix<M2>& m2) :
+            itss(m2.rowsize()), itsm(_packed ? itss*(itss+1)/2 : itss*itss)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            const bool assignable =
+                ShapeTraits2<M2::_shape,_shape>::assignable;
+            TMVStaticAssert(M2::_calc || assignable);
+            TMVAssert(m2.colsize() == size());
+            TMVAssert(m2.rowsize() == size());
+            SymCopy<assignable>::copy(m2,*this);
+        }
+
+        template <class M2>
+        SymMatrix(const BaseMatrix_Sym<M2>& m2) :
+            itss(m2.size()), itsm(_packed ? itss*(itss+1)/2 : itss*itss)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            typename Traits<type>::noalias_type na = this->noAlias();
+            m2.assignTo(na);
+        }
+
+        template <class M2>
+        SymMatrix(const BaseMatrix_Diag<M2>& m2) :
+            itss(m2.size()), itsm(_packed ? itss*(itss+1)/2 : itss*itss)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            Copy(m2.calc(),*this);
+        }
+
+        ~SymMatrix()
+        {
+#ifdef TMV_EXTRA_DEBUG
+            this->setAllTo(Traits<T>::destr_value());
+#endif
+        }
+
+
+        //
+        // Op=
+        //
+
+        TMV_INLINE type& operator=(const type& m2)
+        { if (this != &m2) base_mut::operator=(m2); return *this; }
+
+        template <class M2>
+        TMV_INLINE type& operator=(const BaseMatrix<M2>& m2)
+        { base_mut::operator=(m2); return *this; }
+
+        TMV_INLINE type& operator=(T x)
+        { base_mut::operator=(x); return *this; }
+
+
+        //
+        // Auxilliary Functions
+        //
+
+        TMV_INLINE const T* cptr() const { return itsm; }
+        TMV_INLINE T* ptr() { return itsm; }
+
+        T cref(ptrdiff_t i, ptrdiff_t j) const
+        {
+            return isStored(i,j) ? itsm[index(i,j)] :
+                DoConj<_herm>(itsm[index(j,i)]);
+        }
+
+        reference ref(ptrdiff_t i, ptrdiff_t j)
+        {
+            const bool mirror = !isStored(i,j);
+            return SymRefHelper<_herm,T>::template makeRef<false>(
+                itsm[mirror ? index(j,i) : index(i,j)], mirror);
+        }
+
+        // The whole storage as a single vector.  This is mostly useful for
+        // Packed storage, where the elements are all contiguous.
+        TMV_INLINE linearview_type linearView()
+        { return linearview_type(itsm,nStored(),1); }
+        TMV_INLINE const_linearview_type linearView() const
+        { return const_linearview_type(itsm,nStored(),1); }
+
+        void swapWith(type& m2)
+        {
+            TMVAssert(m2.size() == size());
+            if (itsm.get() == m2.itsm.get()) return;
+            itsm.swapWith(m2.itsm);
+        }
+
+        void resize(const ptrdiff_t s)
+        {
+            TMVAssert(s >= 0);
+            itss = s;
+            itsm.resize(_packed ? s*(s+1)/2 : s*s);
+#ifdef TMV_EXTRA_DEBUG
+            this->setAllTo(Traits<T>::constr_value());
+#endif
+        }
+
+        TMV_INLINE ptrdiff_t size() const { return itss; }
+        ptrdiff_t nElements() const { return itss*(itss+1)/2; }
+        TMV_INLINE ptrdiff_t stepi() const { return _rowmajor ? itss : 1; }
+        TMV_INLINE ptrdiff_t stepj() const { return _rowmajor ? 1 : itss; }
+        TMV_INLINE bool isconj() const { return false; }
+        TMV_INLINE bool isrm() const { return _rowmajor; }
+        TMV_INLINE bool iscm() const { return _colmajor; }
+
+    private :
+
+        TMV_INLINE bool isStored(ptrdiff_t i, ptrdiff_t j) const
+        { return _upper ? i <= j : i >= j; }
+        TMV_INLINE ptrdiff_t index(ptrdiff_t i, ptrdiff_t j) const
+        {
+            return _packed ?
+                SymPackedIndex<_upper,(_upper==int(_rowmajor))>::call(itss,i,j) :
+                i*stepi() + j*stepj();
+        }
+        TMV_INLINE ptrdiff_t nStored() const
+        { return _packed ? itss*(itss+1)/2 : itss*itss; }
+
+        ptrdiff_t itss;
+        AlignedArray<T> itsm;
+
+    }; // SymMatrix
+
+    template <class T, int A0>
+    struct Traits<ConstSymMatrixView<T,A0> > :
+        public SymTraits<T,SymViewAttrib<T,A0>::A,false,
+                         ConstSymMatrixView<T,A0> >
+    {
+        enum { okA = SymViewAttrib<T,A0>::okA };
+    };
+
+    template <class T, int A>
+    class ConstSymMatrixView :
+        public BaseMatrix_Sym<ConstSymMatrixView<T,A> >
+    {
+    public:
+        typedef ConstSymMatrixView<T,A> type;
+
+        enum { _colsize = Traits<type>::_size };
+        enum { _rowsize = Traits<type>::_size };
+        enum { _size = Traits<type>::_size };
+        enum { _shape = Traits<type>::_shape };
+        enum { _fort = Traits<type>::_fort };
+        enum { _calc = Traits<type>::_calc };
+        enum { _rowmajor = Traits<type>::_rowmajor };
+        enum { _colmajor = Traits<type>::_colmajor };
+        enum { _conj = Traits<type>::_conj };
+        enum { _checkalias = Traits<type>::_checkalias };
+        enum { _stepi = Traits<type>::_stepi };
+        enum { _stepj = Traits<type>::_stepj };
+        enum { _diagstep = Traits<type>::_diagstep };
+        enum { _herm = Traits<type>::_herm };
+        enum { _packed = Traits<type>::_packed };
+        enum { _upper = Traits<type>::_upper };
+        enum { _attrib = Traits<type>::_attrib };
+
+        //
+        // Constructors
+        //
+
+        ConstSymMatrixView(const T* m, ptrdiff_t s, ptrdiff_t si, ptrdiff_t sj) :
+            itsm(m), itss(s), itssi(si), itssj(sj)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+        }
+
+        ConstSymMatrixView(const T* m, ptrdiff_t s, ptrdiff_t si) :
+            itsm(m), itss(s), itssi(si), itssj(_stepj)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            TMVStaticAssert(_stepj != Unknown);
+        }
+
+        ConstSymMatrixView(const T* m, ptrdiff_t s) :
+            itsm(m), itss(s), itssi(_stepi), itssj(_stepj)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            TMVStaticAssert(_stepi != Unknown);
+            TMVStaticAssert(_stepj != Unknown);
+        }
+
+        ConstSymMatrixView(const type& m2) :
+            itsm(m2.cptr()), itss(m2.size()),
+            itssi(m2.stepi()), itssj(m2.stepj())
+        {
+            TMVStaticAssert(Traits<type>::okA);
+        }
+
+        template <int A2>
+        ConstSymMatrixView(const ConstSymMatrixView<T,A2>& m2) :
+            itsm(m2.cptr()), itss(m2.size()),
+            itssi(m2.stepi()), itssj(m2.stepj())
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            TMVStaticAssert(Attrib<A>::conj == int(Attrib<A2>::conj));
+            TMVStaticAssert(Attrib<A>::upper == int(Attrib<A2>::upper));
+        }
+
+        template <int A2>
+        ConstSymMatrixView(const SymMatrixView<T,A2>& m2) :
+            itsm(m2.cptr()), itss(m2.size()),
+            itssi(m2.stepi()), itssj(m2.stepj())
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            TMVStaticAssert(Attrib<A>::conj == int(Attrib<A2>::conj));
+            TMVStaticAssert(Attrib<A>::upper == int(Attrib<A2>::upper));
+        }
+
+        ~ConstSymMatrixView()
+        {
+#ifdef TMV_EXTRA_DEBUG
+            itsm = 0;
+#endif
+        }
+
+    private :
+        void operator=(const type& m2);
+    public :
+
+        //
+        // Auxilliary Functions
+        //
+
+        TMV_INLINE const T* cptr() const { return itsm; }
+
+        T cref(ptrdiff_t i, ptrdiff_t j) const
+        {
+            return isStored(i,j) ?
+                DoConj<_conj>(itsm[i*stepi() + j*stepj()]) :
+                DoConj<(_conj != int(_herm))>(itsm[j*stepi() + i*stepj()]);
+        }
+
+        TMV_INLINE ptrdiff_t colsize() const { return itss; }
+        TMV_INLINE ptrdiff_t rowsize() const { return itss; }
+        TMV_INLINE ptrdiff_t size() const { return itss; }
+        ptrdiff_t nElements() const { return itss*(itss+1)/2; }
+        TMV_INLINE ptrdiff_t stepi() const { return itssi; }
+        TMV_INLINE ptrdiff_t stepj() const { return itssj; }
+        TMV_INLINE bool isconj() const { return _conj; }
+        TMV_INLINE bool isrm() const
+        {
+            return Traits<type>::_rowmajor ||
+                (!Traits<type>::_colmajor && stepj() == 1);
+        }
+        TMV_INLINE bool iscm() const
+        {
+            return Traits<type>::_colmajor ||
+                (!Traits<type>::_rowmajor && stepi() == 1);
+        }
+
+    private :
+
+        TMV_INLINE bool isStored(ptrdiff_t i, ptrdiff_t j) const
+        { return _upper ? i <= j : i >= j; }
+
+        const T* itsm;
+        const ptrdiff_t itss;
+        const CheckedInt<_stepi> itssi;
+        const CheckedInt<_stepj> itssj;
+
+    }; // ConstSymMatrixView
+
+    template <class T, int A0>
+    struct Traits<SymMatrixView<T,A0> > :
+        public SymTraits<T,SymViewAttrib<T,A0>::A,false,
+                         SymMatrixView<T,A0> >
+    {
+        enum { okA = SymViewAttrib<T,A0>::okA };
+    };
+
+    template <class T, int A>
+    class SymMatrixView :
+        public BaseMatrix_Sym_Mutable<SymMatrixView<T,A> >
+    {
+    public:
+        typedef SymMatrixView<T,A> type;
+        typedef BaseMatrix_Sym_Mutable<type> base_mut;
+        typedef typename Traits<type>::reference reference;
+
+        enum { _colsize = Traits<type>::_size };
+        enum { _rowsize = Traits<type>::_size };
+        enum { _size = Traits<type>::_size };
+        enum { _shape = Traits<type>::_shape };
+        enum { _fort = Traits<type>::_fort };
+        enum { _calc = Traits<type>::_calc };
+        enum { _rowmajor = Traits<type>::_rowmajor };
+        enum { _colmajor = Traits<type>::_colmajor };
+        enum { _conj = Traits<type>::_conj };
+        enum { _checkalias = Traits<type>::_checkalias };
+        enum { _stepi = Traits<type>::_stepi };
+        enum { _stepj = Traits<type>::_stepj };
+        enum { _diagstep = Traits<type>::_diagstep };
+        enum { _herm = Traits<type>::_herm };
+        enum { _packed = Traits<type>::_packed };
+        enum { _upper = Traits<type>::_upper };
+        enum { _attrib = Traits<type>::_attrib };
+
+        //
+        // Constructors
+        //
+
+        SymMatrixView(T* m, ptrdiff_t s, ptrdiff_t si, ptrdiff_t sj) :
+            itsm(m), itss(s), itssi(si), itssj(sj)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+        }
+
+        SymMatrixView(T* m, ptrdiff_t s, ptrdiff_t si) :
+            itsm(m), itss(s), itssi(si), itssj(_stepj)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            TMVStaticAssert(_stepj != Unknown);
+        }
+
+        SymMatrixView(T* m, ptrdiff_t s) :
+            itsm(m), itss(s), itssi(_stepi), itssj(_stepj)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            TMVStaticAssert(_stepi != Unknown);
+            TMVStaticAssert(_stepj != Unknown);
+        }
+
+        SymMatrixView(const type& m2) :
+            itsm(m2.itsm), itss(m2.size()),
+            itssi(m2.stepi()), itssj(m2.stepj())
+        {
+            TMVStaticAssert(Traits<type>::okA);
+        }
+
+        template <int A2>
+        SymMatrixView(SymMatrixView<T,A2> m2) :
+            itsm(m2.ptr()), itss(m2.size()),
+            itssi(m2.stepi()), itssj(m2.stepj())
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            TMVStaticAssert(Attrib<A>::conj == int(Attrib<A2>::conj));
+            TMVStaticAssert(Attrib<A>::upper == int(Attrib<A2>::upper));
+        }
+
+        ~SymMatrixView()
+        {
+#ifdef TMV_EXTRA_DEBUG
+            itsm = 0;
+#endif
+        }
+
+
+        //
+        // Op =
+        //
+
+        TMV_INLINE type& operator=(const type& m2)
+        { if (this != &m2) base_mut::operator=(m2); return *this; }
+
+        template <class M2>
+        TMV_INLINE type& operator=(const BaseMatrix<M2>& m2)
+        { base_mut::operator=(m2); return *this; }
+
+        TMV_INLINE type& operator=(const T x)
+        { base_mut::operator=(x); return *this; }
+
+
+        //
+        // Auxilliary Functions
+        //
+
+        TMV_INLINE const T* cptr() const { return itsm; }
+        TMV_INLINE T* ptr() { return itsm; }
+
+        T cref(ptrdiff_t i, ptrdiff_t j) const
+        {
+            return isStored(i,j) ?
+                DoConj<_conj>(itsm[i*stepi() + j*stepj()]) :
+                DoConj<(_conj != int(_herm))>(itsm[j*stepi() + i*stepj()]);
+        }
+
+        reference ref(ptrdiff_t i, ptrdiff_t j)
+        {
+            const bool mirror = !isStored(i,j);
+            return SymRefHelper<_herm,T>::template makeRef<_conj>(
+                itsm[mirror ? j*stepi() + i*stepj() : i*stepi() + j*stepj()],
+                mirror);
+        }
+
+        TMV_INLINE ptrdiff_t colsize() const { return itss; }
+        TMV_INLINE ptrdiff_t rowsize() const { return itss; }
+        TMV_INLINE ptrdiff_t size() const { return itss; }
+        ptrdiff_t nElements() const { return itss*(itss+1)/2; }
+        TMV_INLINE ptrdiff_t stepi() const { return itssi; }
+        TMV_INLINE ptrdiff_t stepj() const { return itssj; }
+        TMV_INLINE bool isconj() const { return _conj; }
+        TMV_INLINE bool isrm() const
+        {
+            return Traits<type>::_rowmajor ||
+                (!Traits<type>::_colmajor && stepj() == 1);
+        }
+        TMV_INLINE bool iscm() const
+        {
+            return Traits<type>::_colmajor ||
+                (!Traits<type>::_rowmajor && stepi() == 1);
+        }
+
+    private :
+
+        TMV_INLINE bool isStored(ptrdiff_t i, ptrdiff_t j) const
+        { return _upper ? i <= j : i >= j; }
+
+        T* itsm;
+        const ptrdiff_t itss;
+        const CheckedInt<_stepi> itssi;
+        const CheckedInt<_stepj> itssj;
+
+    }; // SymMatrixView
+
+
+    //
+    // HermMatrix
+    //
+
+    template <class T, int A0>
+    struct Traits<HermMatrix<T,A0> > :
+        public SymTraits<T,SymMatrixAttrib<A0>::A,true,HermMatrix<T,A0> >
+    {
+        enum { okA = SymMatrixAttrib<A0>::okA };
+    };
+
+    template <class T, int A>
+    class HermMatrix :
+        public BaseMatrix_Sym_Mutable<HermMatrix<T,A> >
+    {
+    public:
+        typedef HermMatrix<T,A> type;
+        typedef BaseMatrix_Sym_Mutable<type> base_mut;
+        typedef typename Traits<type>::reference reference;
+        typedef VectorView<T,Unit> linearview_type;
+        typedef ConstVectorView<T,Unit> const_linearview_type;
+
+        enum { _colsize = Traits<type>::_size };
+        enum { _rowsize = Traits<type>::_size };
+        enum { _size = Traits<type>::_size };
+        enum { _shape = Traits<type>::_shape };
+        enum { _fort = Traits<type>::_fort };
+        enum { _calc = Traits<type>::_calc };
+        enum { _rowmajor = Traits<type>::_rowmajor };
+        enum { _colmajor = Traits<type>::_colmajor };
+        enum { _conj = Traits<type>::_conj };
+        enum { _checkalias = Traits<type>::_checkalias };
+        enum { _stepi = Traits<type>::_stepi };
+        enum { _stepj = Traits<type>::_stepj };
+        enum { _diagstep = Traits<type>::_diagstep };
+        enum { _herm = Traits<type>::_herm };
+        enum { _packed = Traits<type>::_packed };
+        enum { _upper = Traits<type>::_upper };
+        enum { _attrib = Traits<type>::_attrib };
+
+        //
+        // Constructors
+        //
+
+        explicit HermMatrix(ptrdiff_t n=0) :
+            itss(n), itsm(_packed ? n*(n+1)/2 : n*n)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            TMVAssert(n >= 0);
+#ifdef TMV_EXTRA_DEBUG
+            this->setAllTo(Traits<T>::constr_value());
+#endif
+        }
+
+        HermMatrix(ptrdiff_t n, T x) :
+            itss(n), itsm(_packed ? n*(n+1)/2 : n*n)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            TMVAssert(n >= 0);
+            this->setAllTo(x);
+        }
+
+        HermMatrix(const type& m2) :
+            itss(m2.size()), itsm(_packed ? itss*(itss+1)/2 : itss*itss)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            this->noAlias() = m2;
+        }
+
+        template <class M2>
+        HermMatrix(const BaseMatrix<M2>& m2) :
+            itss(m2.rowsize()), itsm(_packed ? itss*(itss+1)/2 : itss*itss)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            const bool assignable =
+                ShapeTraits2<M2::_shape,_shape>::assignable;
+            TMVStaticAssert(M2::_calc || assignable);
+            TMVAssert(m2.colsize() == size());
+            TMVAssert(m2.rowsize() == size());
+            SymCopy<assignable>::copy(m2,*this);
+        }
+
+        template <class M2>
+        HermMatrix(const BaseMatrix_Sym<M2>& m2) :
+            itss(m2.size()), itsm(_packed ? itss*(itss+1)/2 : itss*itss)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            typename Traits<type>::noalias_type na = this->noAlias();
+            m2.assignTo(na);
+        }
+
+        template <class M2>
+        HermMatrix(const BaseMatrix_Diag<M2>& m2) :
+            itss(m2.size()), itsm(_packed ? itss*(itss+1)/2 : itss*itss)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            Copy(m2.calc(),*this);
+        }
+
+        ~HermMatrix()
+        {
+#ifdef TMV_EXTRA_DEBUG
+            this->setAllTo(Traits<T>::destr_value());
+#endif
+        }
+
+
+        //
+        // Op=
+        //
+
+        TMV_INLINE type& operator=(const type& m2)
+        { if (this != &m2) base_mut::operator=(m2); return *this; }
+
+        template <class M2>
+        TMV_INLINE type& operator=(const BaseMatrix<M2>& m2)
+        { base_mut::operator=(m2); return *this; }
+
+        TMV_INLINE type& operator=(T x)
+        { base_mut::operator=(x); return *this; }
+
+
+        //
+        // Auxilliary Functions
+        //
+
+        TMV_INLINE const T* cptr() const { return itsm; }
+        TMV_INLINE T* ptr() { return itsm; }
+
+        T cref(ptrdiff_t i, ptrdiff_t j) const
+        {
+            return isStored(i,j) ? itsm[index(i,j)] :
+                DoConj<_herm>(itsm[index(j,i)]);
+        }
+
+        reference ref(ptrdiff_t i, ptrdiff_t j)
+        {
+            const bool mirror = !isStored(i,j);
+            return SymRefHelper<_herm,T>::template makeRef<false>(
+                itsm[mirror ? index(j,i) : index(i,j)], mirror);
+        }
+
+        // The whole storage as a single vector.  This is mostly useful for
+        // Packed storage, where the elements are all contiguous.
+        TMV_INLINE linearview_type linearView()
+        { return linearview_type(itsm,nStored(),1); }
+        TMV_INLINE const_linearview_type linearView() const
+        { return const_linearview_type(itsm,nStored(),1); }
+
+        void swapWith(type& m2)
+        {
+            TMVAssert(m2.size() == size());
+            if (itsm.get() == m2.itsm.get()) return;
+            itsm.swapWith(m2.itsm);
+        }
+
+        void resize(const ptrdiff_t s)
+        {
+            TMVAssert(s >= 0);
+            itss = s;
+            itsm.resize(_packed ? s*(s+1)/2 : s*s);
+#ifdef TMV_EXTRA_DEBUG
+            this->setAllTo(Traits<T>::constr_value());
+#endif
+        }
+
+        TMV_INLINE ptrdiff_t size() const { return itss; }
+        ptrdiff_t nElements() const { return itss*(itss+1)/2; }
+        TMV_INLINE ptrdiff_t stepi() const { return _rowmajor ? itss : 1; }
+        TMV_INLINE ptrdiff_t stepj() const { return _rowmajor ? 1 : itss; }
+        TMV_INLINE bool isconj() const { return false; }
+        TMV_INLINE bool isrm() const { return _rowmajor; }
+        TMV_INLINE bool iscm() const { return _colmajor; }
+
+    private :
+
+        TMV_INLINE bool isStored(ptrdiff_t i, ptrdiff_t j) const
+        { return _upper ? i <= j : i >= j; }
+        TMV_INLINE ptrdiff_t index(ptrdiff_t i, ptrdiff_t j) const
+        {
+            return _packed ?
+                SymPackedIndex<_upper,(_upper==int(_rowmajor))>::call(itss,i,j) :
+                i*stepi() + j*stepj();
+        }
+        TMV_INLINE ptrdiff_t nStored() const
+        { return _packed ? itss*(itss+1)/2 : itss*itss; }
+
+        ptrdiff_t itss;
+        AlignedArray<T> itsm;
+
+    }; // HermMatrix
+
+    template <class T, int A0>
+    struct Traits<ConstHermMatrixView<T,A0> > :
+        public SymTraits<T,SymViewAttrib<T,A0>::A,true,
+                         ConstHermMatrixView<T,A0> >
+    {
+        enum { okA = SymViewAttrib<T,A0>::okA };
+    };
+
+    template <class T, int A>
+    class ConstHermMatrixView :
+        public BaseMatrix_Sym<ConstHermMatrixView<T,A> >
+    {
+    public:
+        typedef ConstHermMatrixView<T,A> type;
+
+        enum { _colsize = Traits<type>::_size };
+        enum { _rowsize = Traits<type>::_size };
+        enum { _size = Traits<type>::_size };
+        enum { _shape = Traits<type>::_shape };
+        enum { _fort = Traits<type>::_fort };
+        enum { _calc = Traits<type>::_calc };
+        enum { _rowmajor = Traits<type>::_rowmajor };
+        enum { _colmajor = Traits<type>::_colmajor };
+        enum { _conj = Traits<type>::_conj };
+        enum { _checkalias = Traits<type>::_checkalias };
+        enum { _stepi = Traits<type>::_stepi };
+        enum { _stepj = Traits<type>::_stepj };
+        enum { _diagstep = Traits<type>::_diagstep };
+        enum { _herm = Traits<type>::_herm };
+        enum { _packed = Traits<type>::_packed };
+        enum { _upper = Traits<type>::_upper };
+        enum { _attrib = Traits<type>::_attrib };
+
+        //
+        // Constructors
+        //
+
+        ConstHermMatrixView(const T* m, ptrdiff_t s, ptrdiff_t si, ptrdiff_t sj) :
+            itsm(m), itss(s), itssi(si), itssj(sj)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+        }
+
+        ConstHermMatrixView(const T* m, ptrdiff_t s, ptrdiff_t si) :
+            itsm(m), itss(s), itssi(si), itssj(_stepj)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            TMVStaticAssert(_stepj != Unknown);
+        }
+
+        ConstHermMatrixView(const T* m, ptrdiff_t s) :
+            itsm(m), itss(s), itssi(_stepi), itssj(_stepj)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            TMVStaticAssert(_stepi != Unknown);
+            TMVStaticAssert(_stepj != Unknown);
+        }
+
+        ConstHermMatrixView(const type& m2) :
+            itsm(m2.cptr()), itss(m2.size()),
+            itssi(m2.stepi()), itssj(m2.stepj())
+        {
+            TMVStaticAssert(Traits<type>::okA);
+        }
+
+        template <int A2>
+        ConstHermMatrixView(const ConstHermMatrixView<T,A2>& m2) :
+            itsm(m2.cptr()), itss(m2.size()),
+            itssi(m2.stepi()), itssj(m2.stepj())
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            TMVStaticAssert(Attrib<A>::conj == int(Attrib<A2>::conj));
+            TMVStaticAssert(Attrib<A>::upper == int(Attrib<A2>::upper));
+        }
+
+        template <int A2>
+        ConstHermMatrixView(const HermMatrixView<T,A2>& m2) :
+            itsm(m2.cptr()), itss(m2.size()),
+            itssi(m2.stepi()), itssj(m2.stepj())
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            TMVStaticAssert(Attrib<A>::conj == int(Attrib<A2>::conj));
+            TMVStaticAssert(Attrib<A>::upper == int(Attrib<A2>::upper));
+        }
+
+        ~ConstHermMatrixView()
+        {
+#ifdef TMV_EXTRA_DEBUG
+            itsm = 0;
+#endif
+        }
+
+    private :
+        void operator=(const type& m2);
+    public :
+
+        //
+        // Auxilliary Functions
+        //
+
+        TMV_INLINE const T* cptr() const { return itsm; }
+
+        T cref(ptrdiff_t i, ptrdiff_t j) const
+        {
+            return isStored(i,j) ?
+                DoConj<_conj>(itsm[i*stepi() + j*stepj()]) :
+                DoConj<(_conj != int(_herm))>(itsm[j*stepi() + i*stepj()]);
+        }
+
+        TMV_INLINE ptrdiff_t colsize() const { return itss; }
+        TMV_INLINE ptrdiff_t rowsize() const { return itss; }
+        TMV_INLINE ptrdiff_t size() const { return itss; }
+        ptrdiff_t nElements() const { return itss*(itss+1)/2; }
+        TMV_INLINE ptrdiff_t stepi() const { return itssi; }
+        TMV_INLINE ptrdiff_t stepj() const { return itssj; }
+        TMV_INLINE bool isconj() const { return _conj; }
+        TMV_INLINE bool isrm() const
+        {
+            return Traits<type>::_rowmajor ||
+                (!Traits<type>::_colmajor && stepj() == 1);
+        }
+        TMV_INLINE bool iscm() const
+        {
+            return Traits<type>::_colmajor ||
+                (!Traits<type>::_rowmajor && stepi() == 1);
+        }
+
+    private :
+
+        TMV_INLINE bool isStored(ptrdiff_t i, ptrdiff_t j) const
+        { return _upper ? i <= j : i >= j; }
+
+        const T* itsm;
+        const ptrdiff_t itss;
+        const CheckedInt<_stepi> itssi;
+        const CheckedInt<_stepj> itssj;
+
+    }; // ConstHermMatrixView
+
+    template <class T, int A0>
+    struct Traits<HermMatrixView<T,A0> > :
+        public SymTraits<T,SymViewAttrib<T,A0>::A,true,
+                         HermMatrixView<T,A0> >
+    {
+        enum { okA = SymViewAttrib<T,A0>::okA };
+    };
+
+    template <class T, int A>
+    class HermMatrixView :
+        public BaseMatrix_Sym_Mutable<HermMatrixView<T,A> >
+    {
+    public:
+        typedef HermMatrixView<T,A> type;
+        typedef BaseMatrix_Sym_Mutable<type> base_mut;
+        typedef typename Traits<type>::reference reference;
+
+        enum { _colsize = Traits<type>::_size };
+        enum { _rowsize = Traits<type>::_size };
+        enum { _size = Traits<type>::_size };
+        enum { _shape = Traits<type>::_shape };
+        enum { _fort = Traits<type>::_fort };
+        enum { _calc = Traits<type>::_calc };
+        enum { _rowmajor = Traits<type>::_rowmajor };
+        enum { _colmajor = Traits<type>::_colmajor };
+        enum { _conj = Traits<type>::_conj };
+        enum { _checkalias = Traits<type>::_checkalias };
+        enum { _stepi = Traits<type>::_stepi };
+        enum { _stepj = Traits<type>::_stepj };
+        enum { _diagstep = Traits<type>::_diagstep };
+        enum { _herm = Traits<type>::_herm };
+        enum { _packed = Traits<type>::_packed };
+        enum { _upper = Traits<type>::_upper };
+        enum { _attrib = Traits<type>::_attrib };
+
+        //
+        // Constructors
+        //
+
+        HermMatrixView(T* m, ptrdiff_t s, ptrdiff_t si, ptrdiff_t sj) :
+            itsm(m), itss(s), itssi(si), itssj(sj)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+        }
+
+        HermMatrixView(T* m, ptrdiff_t s, ptrdiff_t si) :
+            itsm(m), itss(s), itssi(si), itssj(_stepj)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            TMVStaticAssert(_stepj != Unknown);
+        }
+
+        HermMatrixView(T* m, ptrdiff_t s) :
+            itsm(m), itss(s), itssi(_stepi), itssj(_stepj)
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            TMVStaticAssert(_stepi != Unknown);
+            TMVStaticAssert(_stepj != Unknown);
+        }
+
+        HermMatrixView(const type& m2) :
+            itsm(m2.itsm), itss(m2.size()),
+            itssi(m2.stepi()), itssj(m2.stepj())
+        {
+            TMVStaticAssert(Traits<type>::okA);
+        }
+
+        template <int A2>
+        HermMatrixView(HermMatrixView<T,A2> m2) :
+            itsm(m2.ptr()), itss(m2.size()),
+            itssi(m2.stepi()), itssj(m2.stepj())
+        {
+            TMVStaticAssert(Traits<type>::okA);
+            TMVStaticAssert(Attrib<A>::conj == int(Attrib<A2>::conj));
+            TMVStaticAssert(Attrib<A>::upper == int(Attrib<A2>::upper));
+        }
+
+        ~HermMatrixView()
+        {
+#ifdef TMV_EXTRA_DEBUG
+            itsm = 0;
+#endif
+        }
+
+
+        //
+        // Op =
+        //
+
+        TMV_INLINE type& operator=(const type& m2)
+        { if (this != &m2) base_mut::operator=(m2); return *this; }
+
+        template <class M2>
+        TMV_INLINE type& operator=(const BaseMatrix<M2>& m2)
+        { base_mut::operator=(m2); return *this; }
+
+        TMV_INLINE type& operator=(const T x)
+        { base_mut::operator=(x); return *this; }
+
+
+        //
+        // Auxilliary Functions
+        //
+
+        TMV_INLINE const T* cptr() const { return itsm; }
+        TMV_INLINE T* ptr() { return itsm; }
+
+        T cref(ptrdiff_t i, ptrdiff_t j) const
+        {
+            return isStored(i,j) ?
+                DoConj<_conj>(itsm[i*stepi() + j*stepj()]) :
+                DoConj<(_conj != int(_herm))>(itsm[j*stepi() + i*stepj()]);
+        }
+
+        reference ref(ptrdiff_t i, ptrdiff_t j)
+        {
+            const bool mirror = !isStored(i,j);
+            return SymRefHelper<_herm,T>::template makeRef<_conj>(
+                itsm[mirror ? j*stepi() + i*stepj() : i*stepi() + j*stepj()],
+                mirror);
+        }
+
+        TMV_INLINE ptrdiff_t colsize() const { return itss; }
+        TMV_INLINE ptrdiff_t rowsize() const { return itss; }
+        TMV_INLINE ptrdiff_t size() const { return itss; }
+        ptrdiff_t nElements() const { return itss*(itss+1)/2; }
+        TMV_INLINE ptrdiff_t stepi() const { return itssi; }
+        TMV_INLINE ptrdiff_t stepj() const { return itssj; }
+        TMV_INLINE bool isconj() const { return _conj; }
+        TMV_INLINE bool isrm() const
+        {
+            return Traits<type>::_rowmajor ||
+                (!Traits<type>::_colmajor && stepj() == 1);
+        }
+        TMV_INLINE bool iscm() const
+        {
+            return Traits<type>::_colmajor ||
+                (!Traits<type>::_rowmajor && stepi() == 1);
+        }
+
+    private :
+
+        TMV_INLINE bool isStored(ptrdiff_t i, ptrdiff_t j) const
+        { return _upper ? i <= j : i >= j; }
+
+        T* itsm;
+        const ptrdiff_t itss;
+        const CheckedInt<_stepi> itssi;
+        const CheckedInt<_stepj> itssj;
+
+    }; // HermMatrixView
+
+
+    //
+    // Swap
+    //
+
+    template <class T, int A>
+    TMV_INLINE void Swap(SymMatrix<T,A>& m1, SymMatrix<T,A>& m2)
+    { m1.swapWith(m2); }
+    template <class T, int A>
+    TMV_INLINE void Swap(HermMatrix<T,A>& m1, HermMatrix<T,A>& m2)
+    { m1.swapWith(m2); }
+
+
+    //
+    // TMV_Text
+    //
+
+    template <class T, int A>
+    inline std::string TMV_Text(const SymMatrix<T,A>& m)
+    {
+        std::ostringstream s;
+        s << "SymMatrix<"<<TMV_Text(T());
+        s << ","<<Attrib<A>::text()<<">";
+        s << "("<<m.size()<<","<<m.stepi()<<","<<m.stepj()<<")";
+        return s.str();
+    }
+
+    template <class T, int A>
+    inline std::string TMV_Text(const ConstSymMatrixView<T,A>& m)
+    {
+        std::ostringstream s;
+        s << "ConstSymMatrixView<"<<TMV_Text(T());
+        s << ","<<Attrib<A>::text()<<">";
+        s << "("<<m.size()<<","<<m.stepi()<<","<<m.stepj()<<")";
+        return s.str();
+    }
+
+    template <class T, int A>
+    inline std::string TMV_Text(const SymMatrixView<T,A>& m)
+    {
+        std::ostringstream s;
+        s << "SymMatrixView<"<<TMV_Text(T());
+        s << ","<<Attrib<A>::text()<<">";
+        s << "("<<m.size()<<","<<m.stepi()<<","<<m.stepj()<<")";
+        return s.str();
+    }
+
+    template <class T, int A>
+    inline std::string TMV_Text(const HermMatrix<T,A>& m)
+    {
+        std::ostringstream s;
+        s << "HermMatrix<"<<TMV_Text(T());
+        s << ","<<Attrib<A>::text()<<">";
+        s << "("<<m.size()<<","<<m.stepi()<<","<<m.stepj()<<")";
+        return s.str();
+    }
+
+    template <class T, int A>
+    inline std::string TMV_Text(const ConstHermMatrixView<T,A>& m)
+    {
+        std::ostringstream s;
+        s << "ConstHermMatrixView<"<<TMV_Text(T());
+        s << ","<<Attrib<A>::text()<<">";
+        s << "("<<m.size()<<","<<m.stepi()<<","<<m.stepj()<<")";
+        return s.str();
+    }
+
+    template <class T, int A>
+    inline std::string TMV_Text(const HermMatrixView<T,A>& m)
+    {
+        std::ostringstream s;
+        s << "HermMatrixView<"<<TMV_Text(T());
+        s << ","<<Attrib<A>::text()<<">";
+        s << "("<<m.size()<<","<<m.stepi()<<","<<m.stepj()<<")";
+        return s.str();
+    }
+
+} // namespace tmv
+
+#endif
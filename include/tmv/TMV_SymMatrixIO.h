@@ -0,0 +1,388 @@
+
+#ifndef TMV_SymMatrixIO_H
+#define TMV_SymMatrixIO_H
+
+#include "TMV_BaseMatrix_Sym.h"
+#include "TMV_IOStyle.h"
+
+namespace tmv {
+
+    //
+    // Write SymMatrix, HermMatrix
+    //
+
+    // There is no compiled sym library yet, so these (and the Read
+    // functions below) are only done inline.
+
+    template <int algo, class M>
+    struct WriteS_Helper;
+
+    // algo 11: Write the lower triangle for compact output, or
+    // the full matrix otherwise.
+    template <class M>
+    struct WriteS_Helper<11,M>
+    {
+        static void call(const TMV_Writer& writer, const M& m)
+        {
+            const ptrdiff_t N = m.size();
+            writer.begin();
+            writer.writeCode(M::_herm ? "H" : "S");
+            writer.writeSize(N);
+            writer.writeSimpleSize(N);
+            writer.writeStart();
+            for(ptrdiff_t i=0;i<N;++i) {
+                writer.writeLParen();
+                const ptrdiff_t j2 = writer.isCompact() ? i+1 : N;
+                for(ptrdiff_t j=0;j<j2;++j) {
+                    if (j > 0) writer.writeSpace();
+                    writer.writeValue(m.cref(i,j));
+                }
+                writer.writeRParen();
+                if (i < N-1) writer.writeRowEnd();
+            }
+            writer.writeFinal();
+            writer.end();
+        }
+    };
+
+    // algo -3: Only one algorithm, so call it.
+    template <class M>
+    struct WriteS_Helper<-3,M>
+    {
+        static TMV_INLINE void call(const TMV_Writer& writer, const M& m)
+        { WriteS_Helper<11,M>::call(writer,m); }
+    };
+
+    template <class M>
+    struct WriteS_Helper<-1,M>
+    {
+        static TMV_INLINE void call(const TMV_Writer& writer, const M& m)
+        { WriteS_Helper<-3,M>::call(writer,m); }
+    };
+
+    template <class M>
+    inline void Write(const TMV_Writer& writer, const BaseMatrix_Sym<M>& m)
+    {
+        typedef typename M::const_cview_type Mv;
+        TMV_MAYBE_CREF(M,Mv) mv = m.cView();
+        WriteS_Helper<-1,Mv>::call(writer,mv);
+    }
+
+    template <class M>
+    inline void InlineWrite(
+        const TMV_Writer& writer, const BaseMatrix_Sym<M>& m)
+    {
+        typedef typename M::const_cview_type Mv;
+        TMV_MAYBE_CREF(M,Mv) mv = m.cView();
+        WriteS_Helper<-3,Mv>::call(writer,mv);
+    }
+
+
+    //
+    // Read SymMatrix, HermMatrix
+    //
+
+#ifndef TMV_NO_THROW
+    template <bool herm, class T>
+    class SymMatrixReadError : 
+        public ReadError
+    {
+    public :
+        typedef typename 
+            TypeSelect<herm,HermMatrix<T>,SymMatrix<T> >::type M;
+#define TAG (herm ? "HermMatrix" : "SymMatrix")
+
+        M m;
+        ptrdiff_t i,j;
+        std::string exp,got;
+        ptrdiff_t s;
+        T v1, v2;
+        bool is, iseof, isbad;
+
+        SymMatrixReadError(
+            std::istream& _is,
+            const std::string& _e, const std::string& _g) throw() :
+            ReadError(TAG),
+            i(0), j(0), exp(_e), got(_g), s(0), v1(0), v2(0),
+            is(_is), iseof(_is.eof()), isbad(_is.bad()) {}
+
+        template <class M2>
+        SymMatrixReadError(
+            const BaseMatrix_Sym<M2>& _m, std::istream& _is, ptrdiff_t _s) throw() :
+            ReadError(TAG),
+            m(_m), i(0), j(0), s(_s), v1(0), v2(0),
+            is(_is), iseof(_is.eof()), isbad(_is.bad()) {}
+        template <class M2>
+        SymMatrixReadError(
+            ptrdiff_t _i, ptrdiff_t _j, const BaseMatrix_Sym<M2>& _m,
+            std::istream& _is,
+            const std::string& _e, const std::string& _g) throw() :
+            ReadError(TAG),
+            m(_m), i(_i), j(_j), exp(_e), got(_g), 
+            s(_m.size()), v1(0), v2(0),
+            is(_is), iseof(_is.eof()), isbad(_is.bad()) {}
+        template <class M2>
+        SymMatrixReadError(
+            ptrdiff_t _i, ptrdiff_t _j, const BaseMatrix_Sym<M2>& _m, 
+            std::istream& _is) throw() :
+            ReadError(TAG),
+            m(_m), i(_i), j(_j), s(_m.size()), v1(0), v2(0),
+            is(_is), iseof(_is.eof()), isbad(_is.bad()) {}
+        template <class M2>
+        SymMatrixReadError(
+            ptrdiff_t _i, ptrdiff_t _j, const BaseMatrix_Sym<M2>& _m, 
+            std::istream& _is, T _v1, T _v2) throw() :
+            ReadError(TAG),
+            m(_m), i(_i), j(_j), s(_m.size()), v1(_v1), v2(_v2),
+            is(_is), iseof(_is.eof()), isbad(_is.bad()) {}
+
+        SymMatrixReadError(const SymMatrixReadError<herm,T>& rhs) throw() :
+            ReadError(TAG),
+            m(rhs.m), i(rhs.i), j(rhs.j), exp(rhs.exp), got(rhs.got), 
+            s(rhs.s), v1(rhs.v1), v2(rhs.v2),
+            is(rhs.is), iseof(rhs.iseof), isbad(rhs.isbad) {}
+        ~SymMatrixReadError() throw() {}
+
+        void write(std::ostream& os) const throw()
+        {
+            os<<"TMV Read Error: Reading istream input for "<<TAG<<"\n";
+            if (exp != got) {
+                os<<"Wrong format: expected '"<<exp<<"', got '"<<got<<"'.\n";
+            }
+            if (s != m.size()) {
+                os<<"Wrong size: expected "<<m.size()<<", got "<<s<<".\n";
+            }
+            if (!is) {
+                if (iseof) {
+                    os<<"Input stream reached end-of-file prematurely.\n";
+                } else if (isbad) {
+                    os<<"Input stream is corrupted.\n";
+                } else {
+                    os<<"Input stream cannot read next character.\n";
+                }
+            }
+            if (v1 != v2) {
+                if (i == j) {
+                    os<<"Invalid input: Expected real diagonal, got "<<
+                        v1<<".\n";
+                } else {
+                    os<<"Input matrix is not "<<
+                        (herm ? "hermitian" : "symmetric")<<".\n";
+                    os<<"m("<<i<<','<<j<<") = "<<v1<<
+                        " != "<<v2<<" = m("<<j<<','<<i<<")"<<
+                        (herm ? "*" : "")<<".\n";
+                }
+            }
+            if (m.size() > 0) {
+                os<<"The portion of the "<<TAG<<" which was successfully "
+                    "read is: \n";
+                for(ptrdiff_t ii=0;ii<i;++ii) {
+                    os<<"( ";
+                    for(ptrdiff_t jj=0;jj<=ii;++jj) 
+                        os<<' '<<m.cref(ii,jj)<<' ';
+                    os<<" )\n";
+                }
+                os<<"( ";
+                for(ptrdiff_t jj=0;jj<j && jj<=i;++jj) 
+                    os<<' '<<m.cref(i,jj)<<' ';
+                os<<" )\n";
+            }
+        }
+#undef TAG
+
+    };
+#endif
+
+#ifdef NOTHROW
+#define TMV_SYM_READ_ERROR(msg,err) \
+    do { std::cerr<<(M::_herm ? "HermMatrix" : "SymMatrix")<< \
+        " Read Error: "<<msg<<std::endl; exit(1); } while (false)
+#else
+#define TMV_SYM_READ_ERROR(msg,err) \
+    throw SymMatrixReadError<M::_herm,T> err
+#endif
+
+    template <int algo, class M>
+    struct ReadS_Helper;
+
+    // algo 11: Read the lower triangle for compact input, or the full
+    // matrix otherwise.  For the full matrix, the lower triangle is
+    // checked against the upper triangle from the earlier rows.
+    template <class M>
+    struct ReadS_Helper<11,M>
+    {
+        static void call(const TMV_Reader& reader, M& m)
+        {
+            typedef typename M::value_type T;
+            const ptrdiff_t N = m.size();
+            std::string exp, got;
+            T temp;
+            if (!reader.readStart(exp,got)) 
+                TMV_SYM_READ_ERROR(got<<" != "<<exp,
+                                   (0,0,m,reader.getis(),exp,got));
+            for(ptrdiff_t i=0;i<N;++i) {
+                if (!reader.readLParen(exp,got)) 
+                    TMV_SYM_READ_ERROR(got<<" != "<<exp,
+                                       (i,0,m,reader.getis(),exp,got));
+                const ptrdiff_t j2 = reader.isCompact() ? i+1 : N;
+                for(ptrdiff_t j=0;j<j2;++j) {
+                    if (j>0 && !reader.readSpace(exp,got)) 
+                        TMV_SYM_READ_ERROR(got<<" != "<<exp,
+                                           (i,j,m,reader.getis(),exp,got));
+                    if (!reader.readValue(temp)) 
+                        TMV_SYM_READ_ERROR("reading value",
+                                           (i,j,m,reader.getis()));
+                    if (j == i && M::_herm && TMV_IMAG(temp) != 0) 
+                        TMV_SYM_READ_ERROR("non-real diagonal",
+                                           (i,j,m,reader.getis(),
+                                            temp,T(TMV_REAL(temp))));
+                    if (j < i && !reader.isCompact()) {
+                        // m(i,j) was already set from the upper triangle
+                        // in row j, so this value has to match it.
+                        if (temp != T(m.cref(i,j)))
+                            TMV_SYM_READ_ERROR("not symmetric",
+                                               (i,j,m,reader.getis(),
+                                                temp,T(m.cref(i,j))));
+                    } else {
+                        m.ref(i,j) = temp;
+                    }
+                }
+                if (!reader.readRParen(exp,got)) 
+                    TMV_SYM_READ_ERROR(got<<" != "<<exp,
+                                       (i,N,m,reader.getis(),exp,got));
+                if (i < N-1 && !reader.readRowEnd(exp,got)) 
+                    TMV_SYM_READ_ERROR(got<<" != "<<exp,
+                                       (i,N,m,reader.getis(),exp,got));
+            }
+            if (!reader.readFinal(exp,got)) 
+                TMV_SYM_READ_ERROR(got<<" != "<<exp,
+                                   (N,0,m,reader.getis(),exp,got));
+        }
+    };
+
+    // algo -3: Only one algorithm, so call it.
+    template <class M>
+    struct ReadS_Helper<-3,M>
+    {
+        static TMV_INLINE void call(const TMV_Reader& reader, M& m)
+        { ReadS_Helper<11,M>::call(reader,m); }
+    };
+
+    template <class M>
+    struct ReadS_Helper<-1,M>
+    {
+        static TMV_INLINE void call(const TMV_Reader& reader, M& m)
+        { ReadS_Helper<-3,M>::call(reader,m); }
+    };
+
+    template <class M>
+    inline void Read(const TMV_Reader& reader, BaseMatrix_Sym_Mutable<M>& m)
+    {
+        typedef typename M::cview_type Mv;
+        TMV_MAYBE_REF(M,Mv) mv = m.cView();
+        ReadS_Helper<-1,Mv>::call(reader,mv);
+    }
+
+    template <class M>
+    inline void InlineRead(
+        const TMV_Reader& reader, BaseMatrix_Sym_Mutable<M>& m)
+    {
+        typedef typename M::cview_type Mv;
+        TMV_MAYBE_REF(M,Mv) mv = m.cView();
+        ReadS_Helper<-3,Mv>::call(reader,mv);
+    }
+
+    // Read the code and size.  If resize is true, m is resized to the 
+    // size that is read.  Otherwise, it is an error if it doesn't match.
+    template <class M>
+    static void ReadSymHeader(
+        const TMV_Reader& reader, M& m, bool resize)
+    {
+        typedef typename M::value_type T;
+        std::string exp,got;
+        if (!reader.readCode(M::_herm ? "H" : "S",exp,got)) 
+            TMV_SYM_READ_ERROR(got<<" != "<<exp,(reader.getis(),exp,got));
+        ptrdiff_t s=m.size();
+        if (!reader.readSize(s,exp,got)) 
+            TMV_SYM_READ_ERROR("reading size",(reader.getis(),exp,got));
+        if (s != m.size()) {
+            if (resize) m.resize(s);
+            else TMV_SYM_READ_ERROR("wrong size",(m,reader.getis(),s));
+        }
+        s=m.size();
+        if (!reader.readSimpleSize(s,exp,got)) 
+            TMV_SYM_READ_ERROR("reading size",(reader.getis(),exp,got));
+        if (s != m.size()) 
+            TMV_SYM_READ_ERROR("wrong size",(m,reader.getis(),s));
+    }
+
+#undef TMV_SYM_READ_ERROR
+
+
+    // 
+    // Operator overloads for I/O
+    // is >> m
+    //
+
+    template <class M>
+    static std::istream& operator>>(
+        const TMV_Reader& reader, BaseMatrix_Sym_Mutable<M>& m)
+    {
+        ReadSymHeader(reader,m.mat(),false);
+        Read(reader,m);
+        return reader.getis();
+    }
+
+    template <class T, int A>
+    static std::istream& operator>>(
+        const TMV_Reader& reader, SymMatrix<T,A>& m)
+    {
+        ReadSymHeader(reader,m,true);
+        Read(reader,m);
+        return reader.getis();
+    }
+
+    template <class T, int A>
+    static std::istream& operator>>(
+        const TMV_Reader& reader, HermMatrix<T,A>& m)
+    {
+        ReadSymHeader(reader,m,true);
+        Read(reader,m);
+        return reader.getis();
+    }
+
+    template <class T, int A>
+    std::istream& operator>>(std::istream& is, SymMatrix<T,A>& m)
+    { return is >> IOStyle() >> m; }
+
+    template <class T, int A>
+    std::istream& operator>>(std::istream& is, HermMatrix<T,A>& m)
+    { return is >> IOStyle() >> m; }
+
+    template <class T, int A>
+    std::istream& operator>>(
+        const TMV_Reader& reader, SymMatrixView<T,A> m)
+    {
+        return reader >> 
+            static_cast<BaseMatrix_Sym_Mutable<SymMatrixView<T,A> >&>(m);
+    }
+
+    template <class T, int A>
+    std::istream& operator>>(
+        const TMV_Reader& reader, HermMatrixView<T,A> m)
+    {
+        return reader >> 
+            static_cast<BaseMatrix_Sym_Mutable<HermMatrixView<T,A> >&>(m);
+    }
+
+    template <class T, int A>
+    std::istream& operator>>(std::istream& is, SymMatrixView<T,A> m)
+    { return is >> IOStyle() >> m; }
+
+    template <class T, int A>
+    std::istream& operator>>(std::istream& is, HermMatrixView<T,A> m)
+    { return is >> IOStyle() >> m; }
+
+} // namespace tmv
+
+#endif
@@ -0,0 +1,600 @@
+
+
+// This file defines the conversions between numbers and text that are
+// used by the fast text IO (see IOStyle::fast() in TMV_IOStyle.h).
+//
+// FormatText(buf, x, prec)
+//     Write x into buf and return the number of characters written.
+//     buf must have room for at least TMV_TEXT_BUFSIZE characters.
+//     If prec >= 0, x is written with %.{prec}g, which is the same as
+//     os << x with os.precision(prec).  If prec < 0, x is written with
+//     the fewest significant digits (at least digits10) that will read 
+//     back as exactly the same value.  Complex values are written as 
+//     (re,im).
+//
+// ParseText(p, end, x)
+//     Parse a number starting at p.  On success, p is set to the first
+//     character after the number and the return value is true.
+//     The accepted syntax is the same as is >> x: an optional sign,
+//     digits with an optional decimal point, and an optional exponent,
+//     or inf, infinity or nan.  Complex values are (re,im), (re) or re.
+//
+// Both of these use '.' as the decimal point regardless of the locale.
+// Most numbers are parsed directly from their digits, which is exact
+// when there are few enough digits (e.g. at most 15 for double with a
+// small exponent).  Longer numbers are passed to strtod, which is
+// correctly rounded.  For the shortest format, we get a few more 
+// digits than max_digits10 with a single sprintf call, and then check
+// each rounding of them by comparing the rounding error to the spacing
+// of the floating point values near x.  Only when that is too close
+// to call do we need to read the result back with strtod.  With C++17,
+// we use std::to_chars for the shortest format instead, which is about
+// 10 times faster than sprintf.
+
+#ifndef TMV_TextConvert_H
+#define TMV_TextConvert_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <clocale>
+#include <limits>
+#include <sstream>
+#include <locale>
+#include <string>
+#include <complex>
+
+// With C++17, std::to_chars finds the shortest digits directly, which
+// is much faster than the sprintf calls below.
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+#if defined(__cpp_lib_to_chars) && !defined(TMV_NO_TO_CHARS)
+#define TMV_USE_TO_CHARS
+#endif
+
+#define TMV_TEXT_BUFSIZE 128
+
+namespace tmv {
+
+    inline bool IsTextSpace(int c)
+    {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\v' ||
+            c == '\r' || c == '\f';
+    }
+
+    // The characters that can be part of a real number, including
+    // the letters in inf, infinity and nan.
+    inline bool IsTextNumberChar(int c)
+    {
+        switch (c) {
+          case '0' : case '1' : case '2' : case '3' : case '4' :
+          case '5' : case '6' : case '7' : case '8' : case '9' :
+          case '.' : case '+' : case '-' : case 'e' : case 'E' :
+          case 'i' : case 'n' : case 'f' : case 't' : case 'y' : case 'a' :
+          case 'I' : case 'N' : case 'F' : case 'T' : case 'Y' : case 'A' :
+               return true;
+          default :
+               return false;
+        }
+    }
+
+    inline char TextDecimalPoint()
+    {
+        const char* dp = std::localeconv()->decimal_point;
+        return dp && *dp ? *dp : '.';
+    }
+
+    // The powers of 10 that are exact in T.  10^k is exact if
+    // 5^k < 2^digits, i.e. k < digits * log(2)/log(5).
+    // (Integer types don't use these, so they just get 10^0.)
+    template <class T>
+    struct TextPow10
+    {
+        enum { nmax = std::numeric_limits<T>::is_integer ? 0 :
+            std::numeric_limits<T>::digits * 431 / 1000 };
+        T p[nmax+1];
+
+        TextPow10()
+        {
+            p[0] = T(1);
+            for(int k=1;k<=nmax;++k) p[k] = p[k-1] * T(10);
+        }
+
+        static const T* get()
+        {
+            static const TextPow10<T> t;
+            return t.p;
+        }
+    };
+
+    // Case insensitive match of the lower case word w at p.
+    inline bool MatchTextWord(const char* p, const char* end, const char* w)
+    {
+        for(; *w; ++w, ++p) {
+            if (p == end || (*p != *w && *p != *w-'a'+'A')) return false;
+        }
+        return true;
+    }
+
+    // The text from s to end with the '.' changed to the locale's
+    // decimal point, which is what strtod and strtof expect.
+    inline std::string TextWithDecimalPoint(const char* s, const char* end)
+    {
+        std::string str(s,end);
+        const char dp = TextDecimalPoint();
+        if (dp != '.') {
+            const std::string::size_type i = str.find('.');
+            if (i != std::string::npos) str[i] = dp;
+        }
+        return str;
+    }
+
+    // Convert text that isn't handled by the fast path.
+    inline bool ParseTextSlow(const char* s, const char* end, double& x)
+    {
+        const std::string str = TextWithDecimalPoint(s,end);
+        char* e;
+        x = std::strtod(str.c_str(),&e);
+        return e == str.c_str() + str.size();
+    }
+
+    // Use strtof rather than rounding the result of strtod, since
+    // rounding twice is not always correctly rounded.
+    inline bool ParseTextSlow(const char* s, const char* end, float& x)
+    {
+        const std::string str = TextWithDecimalPoint(s,end);
+        char* e;
+        x = std::strtof(str.c_str(),&e);
+        return e == str.c_str() + str.size();
+    }
+
+    template <class T>
+    inline bool ParseTextSlow(const char* s, const char* end, T& x)
+    {
+        std::istringstream ss(std::string(s,end));
+        ss.imbue(std::locale::classic());
+        return (ss >> x) && ss.peek() == EOF;
+    }
+
+    template <bool isint>
+    struct TextNumber;
+
+    // Floating point types
+    template <>
+    struct TextNumber<false>
+    {
+        template <class T>
+        static bool parse(const char*& p, const char* end, T& x)
+        {
+            const char* s = p;
+            bool neg = false;
+            if (s < end && (*s == '+' || *s == '-')) {
+                neg = (*s == '-'); ++s;
+            }
+            if (s < end && (*s == 'i' || *s == 'I')) {
+                if (!MatchTextWord(s,end,"inf")) return false;
+                s += MatchTextWord(s,end,"infinity") ? 8 : 3;
+                x = neg ? -std::numeric_limits<T>::infinity() :
+                    std::numeric_limits<T>::infinity();
+                p = s;
+                return true;
+            }
+            if (s < end && (*s == 'n' || *s == 'N')) {
+                if (!MatchTextWord(s,end,"nan")) return false;
+                x = std::numeric_limits<T>::quiet_NaN();
+                p = s+3;
+                return true;
+            }
+
+            // Accumulate up to 19 significant digits in m, so
+            // the value is m * 10^e10.
+            unsigned long long m = 0;
+            int nd = 0;
+            int e10 = 0;
+            bool anydigits = false;
+            bool inexact = false;
+            for(; s < end && *s >= '0' && *s <= '9'; ++s) {
+                anydigits = true;
+                if (nd < 19) {
+                    m = m*10 + (*s-'0');
+                    if (m) ++nd;
+                } else {
+                    ++e10;
+                    if (*s != '0') inexact = true;
+                }
+            }
+            if (s < end && *s == '.') {
+                for(++s; s < end && *s >= '0' && *s <= '9'; ++s) {
+                    anydigits = true;
+                    if (nd < 19) {
+                        m = m*10 + (*s-'0');
+                        if (m) ++nd;
+                        --e10;
+                    } else if (*s != '0') inexact = true;
+                }
+            }
+            if (!anydigits) return false;
+            if (s < end && (*s == 'e' || *s == 'E')) {
+                const char* s1 = s+1;
+                bool eneg = false;
+                if (s1 < end && (*s1 == '+' || *s1 == '-')) {
+                    eneg = (*s1 == '-'); ++s1;
+                }
+                if (s1 < end && *s1 >= '0' && *s1 <= '9') {
+                    int e = 0;
+                    for(; s1 < end && *s1 >= '0' && *s1 <= '9'; ++s1)
+                        if (e < 100000) e = e*10 + (*s1-'0');
+                    e10 += eneg ? -e : e;
+                    s = s1;
+                }
+            }
+
+            const int nmax = TextPow10<T>::nmax;
+            const int digits = std::numeric_limits<T>::digits;
+            const bool mexact =
+                digits >= 64 || m < ((unsigned long long)(1) << digits);
+            if (m == 0) {
+                x = neg ? -T(0) : T(0);
+            } else if (!inexact && mexact && e10 >= -nmax && e10 <= nmax) {
+                // Both m and 10^|e10| are exact, so there is only one
+                // rounding, which makes the result correctly rounded.
+                const T* pow10 = TextPow10<T>::get();
+                const T y = e10 < 0 ?
+                    T(m) / pow10[-e10] : T(m) * pow10[e10];
+                x = neg ? -y : y;
+            } else {
+                if (!ParseTextSlow(p,s,x)) return false;
+            }
+            p = s;
+            return true;
+        }
+
+        template <class T>
+        static int format(char* buf, T x, int prec)
+        {
+            if (x != x) { std::strcpy(buf,"nan"); return 3; }
+            if (x == std::numeric_limits<T>::infinity())
+            { std::strcpy(buf,"inf"); return 3; }
+            if (x == -std::numeric_limits<T>::infinity())
+            { std::strcpy(buf,"-inf"); return 4; }
+            const char dp = TextDecimalPoint();
+            if (prec >= 0) return sprint(buf,x,prec < 40 ? prec : 40,dp);
+            if (x == T(0)) return sprint(buf,x,1,dp);
+#ifdef TMV_USE_TO_CHARS
+            return shortest(buf,x);
+#else
+
+            // The shortest representation has between digits10 and
+            // max_digits10 significant digits.  Rather than calling
+            // sprintf for each number of digits, get a few more than
+            // p2 digits at once, and round them to p digits ourselves.
+            // (The extra digits make this give the same digits as
+            // %.{p}g except in very rare cases.)
+            const int p1 = std::numeric_limits<T>::digits10;
+            const int p2 = 2 + std::numeric_limits<T>::digits * 30103 / 100000;
+            const int nd = p2+3;
+            char dig[TMV_TEXT_BUFSIZE];
+            const int e = sciDigits(dig,x,nd,dp);
+            bool pow2;
+            const long double h = halfUlp(x,dig,nd,pow2);
+            int n = 0;
+            for(int p=p1; p<=p2; ++p) {
+                char rdig[TMV_TEXT_BUFSIZE];
+                std::memcpy(rdig,dig,p);
+                int re = e;
+                const bool up = roundUp(dig,p,nd);
+                if (up) {
+                    int k = p-1;
+                    while (k >= 0 && rdig[k] == '9') rdig[k--] = '0';
+                    if (k >= 0) ++rdig[k];
+                    else { rdig[0] = '1'; ++re; }
+                }
+                const int c = closeEnough(
+                    dig,p,nd,up,(pow2 && !up) ? h/2 : h);
+                if (c < 0) continue;
+                n = gFormat(buf,x<0,rdig,p,re);
+                if (c > 0 || readsBack(buf,n,x,dp)) return n;
+            }
+            return sprint(buf,x,p2,dp);
+#endif
+        }
+
+#ifdef TMV_USE_TO_CHARS
+        // std::to_chars gives the shortest digits that read back as x.
+        // If that is fewer than digits10, use digits10 digits, rounded 
+        // from the exact value, as above.  (For normal numbers, this is
+        // the same as padding the shortest digits with 0's, but not
+        // for denormals.)
+        template <class T>
+        static int shortest(char* buf, T x)
+        {
+            const int p1 = std::numeric_limits<T>::digits10;
+            const T ax = x < 0 ? -x : x;
+            char dig[TMV_TEXT_BUFSIZE];
+            int e;
+            int p = toCharsDigits(dig,e,std::to_chars(
+                    dig,dig+TMV_TEXT_BUFSIZE-1,ax,
+                    std::chars_format::scientific));
+            if (p < p1) {
+                p = toCharsDigits(dig,e,std::to_chars(
+                        dig,dig+TMV_TEXT_BUFSIZE-1,ax,
+                        std::chars_format::scientific,p1-1));
+            }
+            return gFormat(buf,x<0,dig,p,e);
+        }
+
+        // dig holds d.ddde+XX up to r.ptr.  Remove the decimal point,
+        // set e to the exponent and return the number of digits.
+        static int toCharsDigits(
+            char* dig, int& e, const std::to_chars_result& r)
+        {
+            *r.ptr = '\0';
+            char* t = std::strchr(dig,'e');
+            e = std::atoi(t+1);
+            if (dig[1] != '.') return 1;
+            std::memmove(dig+1,dig+2,t-dig-2);
+            return int(t-dig-1);
+        }
+#endif
+
+        // Half of the spacing between |x| and the next representable 
+        // value away from 0, in units of the last of the nd digits in dig.
+        // Since |x| = f 2^ex ~= D units, where D is the integer dig,
+        // this is 2^(ex-d-1) / (f 2^ex / D) = 2^(-d-1) D / f.
+        // pow2 is set to whether |x| is a power of 2, in which case the
+        // spacing towards 0 is half as large.
+        template <class T>
+        static long double halfUlp(T x, const char* dig, int nd, bool& pow2)
+        {
+            int ex;
+            const T f = std::frexp(x < 0 ? -x : x,&ex);
+            const int emin = std::numeric_limits<T>::min_exponent;
+            const int d = std::numeric_limits<T>::digits;
+            pow2 = (f == T(0.5) && ex > emin);
+            long double D = 0.;
+            for(int i=0; i<nd; ++i) D = D*10 + (dig[i]-'0');
+            return std::ldexp(D / f, (ex < emin ? emin-ex : 0) - d - 1);
+        }
+
+        // Check whether rounding the nd digits in dig to p digits
+        // (rounding up if up) moves it by less than h units of the last 
+        // digit.  Since dig is itself rounded by up to half a unit, the 
+        // answer is only certain if the difference is more than that.
+        // Returns 1 if it does, -1 if it doesn't and 0 if it's too close
+        // to tell.
+        static int closeEnough(
+            const char* dig, int p, int nd, bool up, long double h)
+        {
+            long double tail = 0., scale = 1.;
+            for(int k=p; k<nd; ++k) {
+                tail = tail*10 + (dig[k]-'0');
+                scale *= 10;
+            }
+            const long double diff = up ? scale - tail : tail;
+            const long double eps = 1.e-6;
+            if (diff + 0.5 < h * (1.-eps)) return 1;
+            if (diff - 0.5 > h * (1.+eps)) return -1;
+            return 0;
+        }
+
+        // Whether the n characters in buf (followed by a 0) read back 
+        // as x.  When the locale uses '.' for the decimal point, we 
+        // can call strtod directly for the cases that our parse 
+        // would pass to it anyway.
+        template <class T>
+        static bool readsBack(const char* buf, int n, T x, char dp)
+        {
+            const char* q = buf;
+            T y;
+            return parse(q,buf+n,y) && y == x;
+        }
+
+        static bool readsBack(const char* buf, int n, double x, char dp)
+        {
+            if (dp != '.') return readsBack<double>(buf,n,x,'?');
+            return std::strtod(buf,0) == x;
+        }
+
+        static bool readsBack(const char* buf, int n, float x, char dp)
+        {
+            if (dp != '.') return readsBack<float>(buf,n,x,'?');
+            return std::strtof(buf,0) == x;
+        }
+
+        // Whether to round up when rounding the n digits in dig to p.
+        // Ties go to even, like printf.
+        static bool roundUp(const char* dig, int p, int n)
+        {
+            if (dig[p] != '5') return dig[p] > '5';
+            for(int k=p+1; k<n; ++k) if (dig[k] != '0') return true;
+            return (dig[p-1]-'0') % 2 == 1;
+        }
+
+        template <class T>
+        static int sprint(char* buf, T x, int prec, char dp)
+        {
+            const int n = std::sprintf(buf,"%.*g",prec,double(x));
+            fixPoint(buf,n,dp);
+            return n;
+        }
+
+        static int sprint(char* buf, long double x, int prec, char dp)
+        {
+            const int n = std::sprintf(buf,"%.*Lg",prec,x);
+            fixPoint(buf,n,dp);
+            return n;
+        }
+
+        // Write the first p significant digits of |x| into dig (without 
+        // the decimal point) and return the decimal exponent.
+        template <class T>
+        static int sciDigits(char* dig, T x, int p, char dp)
+        { return sciDigits(dig,(long double)(x),p,dp); }
+
+        static int sciDigits(char* dig, long double x, int p, char dp)
+        {
+            char temp[TMV_TEXT_BUFSIZE];
+            std::sprintf(temp,"%.*Le",p-1,x < 0 ? -x : x);
+            return sciDigits2(dig,temp,p,dp);
+        }
+
+        static int sciDigits(char* dig, double x, int p, char dp)
+        {
+            char temp[TMV_TEXT_BUFSIZE];
+            std::sprintf(temp,"%.*e",p-1,x < 0 ? -x : x);
+            return sciDigits2(dig,temp,p,dp);
+        }
+
+        static int sciDigits(char* dig, float x, int p, char dp)
+        { return sciDigits(dig,double(x),p,dp); }
+
+        // temp is d.ddde+XX
+        static int sciDigits2(char* dig, const char* temp, int p, char dp)
+        {
+            int k = 0;
+            for(const char* t = temp; k < p; ++t) if (*t != dp) dig[k++] = *t;
+            const char* t = std::strchr(temp,'e');
+            return std::atoi(t+1);
+        }
+
+        // Write the p digits in dig with exponent e the way %.{p}g would:
+        // fixed notation if -4 <= e < p and scientific notation 
+        // otherwise, without trailing zeros after the decimal point.
+        static int gFormat(char* buf, bool neg, const char* dig, int P, int e)
+        {
+            int p = P;
+            while (p > 1 && dig[p-1] == '0') --p;
+            int n = 0;
+            if (neg) buf[n++] = '-';
+            if (e >= -4 && e < 0) {
+                buf[n++] = '0';
+                buf[n++] = '.';
+                for(int k=-1; k>e; --k) buf[n++] = '0';
+                for(int k=0; k<p; ++k) buf[n++] = dig[k];
+            } else if (e >= 0 && e < P) {
+                for(int k=0; k<=e; ++k) buf[n++] = k < p ? dig[k] : '0';
+                if (p > e+1) {
+                    buf[n++] = '.';
+                    for(int k=e+1; k<p; ++k) buf[n++] = dig[k];
+                }
+            } else {
+                buf[n++] = dig[0];
+                if (p > 1) {
+                    buf[n++] = '.';
+                    for(int k=1; k<p; ++k) buf[n++] = dig[k];
+                }
+                n += std::sprintf(buf+n,"e%c%02d",e<0?'-':'+',e<0?-e:e);
+            }
+            buf[n] = '\0';
+            return n;
+        }
+
+        static void fixPoint(char* buf, int n, char dp)
+        {
+            if (dp != '.') {
+                char* p = static_cast<char*>(std::memchr(buf,dp,n));
+                if (p) *p = '.';
+            }
+        }
+    };
+
+    // Integer types
+    template <>
+    struct TextNumber<true>
+    {
+        template <class T>
+        static bool parse(const char*& p, const char* end, T& x)
+        {
+            const char* s = p;
+            bool neg = false;
+            if (s < end && (*s == '+' || *s == '-')) {
+                neg = (*s == '-'); ++s;
+            }
+            if (s == end || *s < '0' || *s > '9') return false;
+            T y = 0;
+            for(; s < end && *s >= '0' && *s <= '9'; ++s)
+                y = y*10 + (*s-'0');
+            x = neg ? T(-y) : y;
+            p = s;
+            return true;
+        }
+
+        template <class T>
+        static int format(char* buf, T x, int )
+        {
+            char temp[40];
+            int n = 0;
+            const bool neg = x < 0;
+            do {
+                const int d = int(x % 10);
+                temp[n++] = char('0' + (d < 0 ? -d : d));
+                x /= 10;
+            } while (x != 0);
+            int k = 0;
+            if (neg) buf[k++] = '-';
+            while (n > 0) buf[k++] = temp[--n];
+            buf[k] = '\0';
+            return k;
+        }
+    };
+
+    template <class T>
+    inline bool ParseText(const char*& p, const char* end, T& x)
+    {
+        return TextNumber<std::numeric_limits<T>::is_integer>::parse(
+            p,end,x);
+    }
+
+    template <class T>
+    inline bool ParseText(const char*& p, const char* end, std::complex<T>& x)
+    {
+        T re(0), im(0);
+        const char* s = p;
+        if (s < end && *s == '(') {
+            ++s;
+            while (s < end && IsTextSpace(*s)) ++s;
+            if (!ParseText(s,end,re)) return false;
+            while (s < end && IsTextSpace(*s)) ++s;
+            if (s < end && *s == ',') {
+                ++s;
+                while (s < end && IsTextSpace(*s)) ++s;
+                if (!ParseText(s,end,im)) return false;
+                while (s < end && IsTextSpace(*s)) ++s;
+            }
+            if (s == end || *s != ')') return false;
+            ++s;
+        } else {
+            if (!ParseText(s,end,re)) return false;
+        }
+        x = std::complex<T>(re,im);
+        p = s;
+        return true;
+    }
+
+    template <class T>
+    inline int FormatText(char* buf, const T& x, int prec)
+    {
+        return TextNumber<std::numeric_limits<T>::is_integer>::format(
+            buf,x,prec);
+    }
+
+    template <class T>
+    inline int FormatText(char* buf, const std::complex<T>& x, int prec)
+    {
+        int n = 0;
+        buf[n++] = '(';
+        n += FormatText(buf+n,real(x),prec);
+        buf[n++] = ',';
+        n += FormatText(buf+n,imag(x),prec);
+        buf[n++] = ')';
+        buf[n] = '\0';
+        return n;
+    }
+
+} // namespace tmv
+
+#endif
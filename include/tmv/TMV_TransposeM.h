@@ -4,6 +4,7 @@
 
 #include "TMV_BaseMatrix_Rec.h"
 #include "TMV_SwapV.h"
+#include <vector>
 
 namespace tmv {
 
@@ -24,6 +25,12 @@ namespace tmv {
 #define TMV_TRANSPOSEM_UNROLL 9
 #else
 #define TMV_TRANSPOSEM_UNROLL 0
+#endif
+
+// BLOCK is the size below which the recursive algorithm (algo 21)
+// just swaps the elements directly.
+#ifndef TMV_TRANSPOSEM_BLOCK
+#define TMV_TRANSPOSEM_BLOCK 16
 #endif
 
     template <int algo, ptrdiff_t s, class M1>
@@ -158,6 +165,78 @@ namespace tmv {
         { Unroller<0,s,0,s>::unroll(m); }
     };
 
+    // algo 21: Recursive, cache oblivious
+    // Split the matrix into [ A B ; C D ], transpose A and D in place,
+    // and swap B with C^T.  The swap is also done recursively by 
+    // splitting the longer dimension in half.  So at some level of 
+    // the recursion, the blocks fit in each level of cache, and the
+    // elements are used efficiently from there, without having to know
+    // how big the caches are.
+    // For the large strides of a big matrix, this is much faster than
+    // algo 12, which goes through all of the cache lines of the matrix
+    // for each row.
+    template <ptrdiff_t s, class M1>
+    struct TransposeSelf_Helper<21,s,M1>
+    {
+        typedef typename M1::value_type T;
+
+        static void call(M1& m)
+        {
+            const ptrdiff_t n = s == Unknown ? m.colsize() : s;
+            recurse(m.ptr(),n,m.stepi(),m.stepj());
+        }
+
+        // Transpose the n x n matrix at p.
+        static void recurse(
+            T* p, const ptrdiff_t n, const ptrdiff_t si, const ptrdiff_t sj)
+        {
+            if (n <= TMV_TRANSPOSEM_BLOCK) {
+                for(ptrdiff_t i=1;i<n;++i) 
+                    for(ptrdiff_t j=0;j<i;++j) 
+                        TMV_SWAP(p[i*si+j*sj],p[j*si+i*sj]);
+            } else {
+                const ptrdiff_t n1 = n/2;
+                recurse(p,n1,si,sj);
+                recurse(p+n1*(si+sj),n-n1,si,sj);
+                swapTrans(p+n1*si,p+n1*sj,n-n1,n1,si,sj);
+            }
+        }
+
+        // Swap the m x n matrix at A with the transpose of the 
+        // n x m matrix at B.
+        static void swapTrans(
+            T* A, T* B, const ptrdiff_t m, const ptrdiff_t n,
+            const ptrdiff_t si, const ptrdiff_t sj)
+        {
+            if (m <= TMV_TRANSPOSEM_BLOCK && n <= TMV_TRANSPOSEM_BLOCK) {
+                for(ptrdiff_t j=0;j<n;++j) 
+                    for(ptrdiff_t i=0;i<m;++i) 
+                        TMV_SWAP(A[i*si+j*sj],B[j*si+i*sj]);
+            } else if (m >= n) {
+                const ptrdiff_t m1 = m/2;
+                swapTrans(A,B,m1,n,si,sj);
+                swapTrans(A+m1*si,B+m1*sj,m-m1,n,si,sj);
+            } else {
+                const ptrdiff_t n1 = n/2;
+                swapTrans(A,B,m,n1,si,sj);
+                swapTrans(A+n1*sj,B+n1*si,m,n-n1,si,sj);
+            }
+        }
+    };
+
+    // algo 31: Unknown size, determine which algorithm to use
+    template <ptrdiff_t s, class M1>
+    struct TransposeSelf_Helper<31,s,M1>
+    {
+        static TMV_INLINE void call(M1& m)
+        {
+            if (m.colsize() > 2*TMV_TRANSPOSEM_BLOCK)
+                TransposeSelf_Helper<21,s,M1>::call(m);
+            else
+                TransposeSelf_Helper<12,s,M1>::call(m);
+        }
+    };
+
     // algo 90: Call inst
     template <ptrdiff_t s, class M1>
     struct TransposeSelf_Helper<90,s,M1>
@@ -195,6 +274,8 @@ namespace tmv {
             const int algo = 
                 s == 0 || s == 1 ? 0 :
                 unroll ? 15 :
+                s == Unknown ? 31 :
+                s > 2*TMV_TRANSPOSEM_BLOCK ? 21 :
                 12;
             TransposeSelf_Helper<algo,s,M1>::call(m);
         }
@@ -247,6 +328,41 @@ namespace tmv {
         TransposeSelf_Helper<-3,s,Mv>::call(mv);
     }
 
+    //
+    // InPlaceTransposeStorage
+    //
+    // Transpose the storage of an M x N colmajor matrix in place, so it
+    // becomes the N x M colmajor storage of its transpose.  
+    // Equivalently, the result is the M x N rowmajor storage of the 
+    // original matrix.  (For rowmajor storage, swap M and N.)
+    //
+    // Element k = i + j*M moves to j + i*N = k*N mod (MN-1), so we follow 
+    // the cycles of this permutation, using one bit per element to keep
+    // track of which ones are done.  So the only extra memory is MN/8 
+    // bytes, which lets us switch the storage order of very large
+    // matrices.  See Matrix::transposeSelf() and ChangeMajor().
+    //
+
+    template <class T>
+    void InPlaceTransposeStorage(T* p, const ptrdiff_t M, const ptrdiff_t N)
+    {
+        if (M <= 1 || N <= 1) return;
+        const ptrdiff_t MN1 = M*N-1;
+        std::vector<bool> done(MN1,false);
+        // Elements 0 and MN-1 don't move.
+        for(ptrdiff_t k0=1;k0<MN1;++k0) {
+            if (done[k0]) continue;
+            // Move each element of the cycle into the next position.
+            T x = p[k0];
+            ptrdiff_t k = k0;
+            do {
+                k = (k*N) % MN1;
+                TMV_SWAP(x,p[k]);
+                done[k] = true;
+            } while (k != k0);
+        }
+    }
+
 } // namespace tmv
 
 #endif
@@ -0,0 +1,636 @@
+//---------------------------------------------------------------------------
+//
+// This file defines the TMV TridiagMatrix class, which holds a square
+// n x n tridiagonal matrix as three contiguous vectors:
+//
+//    ( d0 u0             )
+//    ( l0 d1 u1          )
+//    (    l1 d2 u2       )
+//    (       ..  ..  ..  )
+//    (          ln-2 dn-1)
+//
+// A bidiagonal matrix is just a TridiagMatrix with l or u set to 0.
+//
+// This is the same matrix as a BandMatrix with nlo = nhi = 1, but without
+// the strides and the generic band dispatch, so the loops over the three
+// diagonals can be vectorized.  It also has TridiagMatrixBatch, which
+// holds many independent tridiagonal systems of the same size.
+//
+// The functions that use them are:
+//
+//    Tridiag_MultMV(A, x, y)            y = A x
+//    Tridiag_Decompose(A)               A = L U in place (the Thomas
+//                                       algorithm).
+//    Tridiag_SolveInPlace(A, b)         b = A^-1 b using the
+//                                       decomposition in A.
+//                                       b may be a vector or a matrix.
+//    Tridiag_SolveCR(A, b)              b = A^-1 b using cyclic reduction.
+//                                       A is not modified.
+//    BatchTridiag_Decompose(A)          Tridiag_Decompose for each A[b].
+//    BatchTridiag_SolveInPlace(A, X)    Tridiag_SolveInPlace for each
+//                                       A[b] and right hand side X.row(b).
+//
+// The Thomas algorithm is the tridiagonal LU decomposition without
+// pivoting.  L has 1's on the diagonal and l'k = lk / d'k below it,
+// and U has d'k+1 = dk+1 - l'k uk on the diagonal and the original u
+// above it.  These are stored in place of l and d.  Without pivoting,
+// this is only stable for matrices where the d'k don't get too small,
+// e.g. diagonally dominant or positive definite matrices, which is the
+// usual case.  (Use BandMatrix and BandLU_Decompose for the others.)
+// A zero d'k is not an error here, but it will give inf or nan values
+// from Tridiag_SolveInPlace.
+//
+// The Thomas algorithm is sequential from each row to the next.  Cyclic
+// reduction instead eliminates the odd numbered unknowns using the even
+// numbered rows, all of which can be done in parallel, leaving a
+// tridiagonal system of half the size.  This is repeated until there
+// is a single unknown, and then the odd unknowns at each level are found
+// from the even ones (again in parallel).  It takes about 2.5 times as
+// many flops as the Thomas algorithm, so it is only faster with several
+// threads.  With OpenMP, each level is split among the threads when it
+// has at least TMV_TRIDIAG_CR_OPENMP_THRESH rows.
+//
+// TridiagMatrixBatch uses the same "structure of arrays" storage as
+// SmallMatrixBatch: l, d and u are each stored as an nbatch x n column
+// major matrix, so row b holds the diagonals of system b and element k
+// of all the systems is contiguous.  The right hand sides X for the
+// batch solve are stored the same way, so X.row(b) is the right hand
+// side for system b.  The loops are written with the innermost loop
+// over the batch index, which the compiler can vectorize, and the
+// batch is processed in chunks of TMV_BATCH_BLOCKSIZE systems, which
+// are split among the threads as for the SmallMatrixBatch functions.
+// (With gcc, this needs -O3 or -ftree-vectorize, and ideally -mavx,
+// to actually be vectorized.)  Since vector division is slow, after
+// BatchTridiag_Decompose the diagonal holds 1/d'k rather than d'k.
+//
+//
+// Constructors:
+//
+//    TridiagMatrix<T>(ptrdiff_t n)
+//        Makes an n x n tridiagonal matrix with _uninitialized_ values.
+//
+//    TridiagMatrix<T>(ptrdiff_t n, T x)
+//        Makes the same with all the values in the three diagonals = x.
+//
+//    TridiagMatrixBatch<T>(ptrdiff_t nbatch, ptrdiff_t n)
+//    TridiagMatrixBatch<T>(ptrdiff_t nbatch, ptrdiff_t n, T x)
+//        Makes a batch of nbatch n x n tridiagonal matrices.
+//
+// Access:
+//
+//    size(), colsize(), rowsize()
+//        n
+//
+//    diag(), subDiag(), superDiag()
+//        Returns a VectorView of d, l and u respectively.
+//        (For TridiagMatrixBatch, a MatrixView of all of them, where
+//        row b is the diagonal of A[b].  subDiag and superDiag have n-1
+//        columns.)
+//
+//    A(i,j)
+//        Returns the (i,j) element of the full matrix (0 outside the
+//        three diagonals).
+//
+//    nBatch()  (TridiagMatrixBatch only)
+//        The number of matrices in the batch.
+//
+//    setZero(), setAllTo(x)
+//        Set all the values in the three diagonals.
+
+
+#ifndef TMV_TridiagMatrix_H
+#define TMV_TridiagMatrix_H
+
+#include "TMV_Matrix.h"
+#include "TMV_Vector.h"
+#include "TMV_SmallMatrixBatch.h"
+#include <vector>
+#include <deque>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace tmv {
+
+    // The minimum number of rows in one level of the cyclic reduction
+    // to split it among the threads.
+#ifndef TMV_TRIDIAG_CR_OPENMP_THRESH
+#define TMV_TRIDIAG_CR_OPENMP_THRESH 16384
+#endif
+
+    template <class T>
+    class TridiagMatrix
+    {
+    public:
+
+        typedef T value_type;
+        typedef TridiagMatrix<T> type;
+        typedef Vector<T> storage_type;
+        typedef typename storage_type::view_type diag_type;
+        typedef typename storage_type::const_view_type const_diag_type;
+
+        explicit TridiagMatrix(ptrdiff_t n) :
+            itsn(n), itsl(n>0?n-1:0), itsd(n), itsu(n>0?n-1:0)
+        { TMVAssert(n >= 0); }
+
+        TridiagMatrix(ptrdiff_t n, T x) :
+            itsn(n), itsl(n>0?n-1:0,x), itsd(n,x), itsu(n>0?n-1:0,x)
+        { TMVAssert(n >= 0); }
+
+        TMV_INLINE ptrdiff_t size() const { return itsn; }
+        TMV_INLINE ptrdiff_t colsize() const { return itsn; }
+        TMV_INLINE ptrdiff_t rowsize() const { return itsn; }
+
+        TMV_INLINE const_diag_type diag() const { return itsd.view(); }
+        TMV_INLINE const_diag_type subDiag() const { return itsl.view(); }
+        TMV_INLINE const_diag_type superDiag() const { return itsu.view(); }
+        TMV_INLINE diag_type diag() { return itsd.view(); }
+        TMV_INLINE diag_type subDiag() { return itsl.view(); }
+        TMV_INLINE diag_type superDiag() { return itsu.view(); }
+
+        T operator()(ptrdiff_t i, ptrdiff_t j) const
+        {
+            TMVAssert(i >= 0 && i < itsn);
+            TMVAssert(j >= 0 && j < itsn);
+            if (i == j) return itsd.cref(i);
+            else if (i == j+1) return itsl.cref(j);
+            else if (j == i+1) return itsu.cref(i);
+            else return T(0);
+        }
+
+        type& setZero()
+        { itsl.setZero(); itsd.setZero(); itsu.setZero(); return *this; }
+
+        type& setAllTo(const T& x)
+        {
+            itsl.setAllTo(x); itsd.setAllTo(x); itsu.setAllTo(x);
+            return *this;
+        }
+
+    private:
+
+        ptrdiff_t itsn;
+        storage_type itsl;
+        storage_type itsd;
+        storage_type itsu;
+
+    }; // TridiagMatrix
+
+    template <class T>
+    inline std::string TMV_Text(const TridiagMatrix<T>& )
+    { return std::string("TridiagMatrix<")+TMV_Text(T())+">"; }
+
+
+    //
+    // y = A x
+    //
+
+    // The kernel for unit step x and y, which must not overlap.
+    template <class T, class T1, class T2>
+    inline void TridiagMultMV_Loop(
+        const ptrdiff_t n, const T* l, const T* d, const T* u,
+        const T1* x, T2* y)
+    {
+        if (n == 0) return;
+        if (n == 1) { y[0] = d[0]*x[0]; return; }
+        y[0] = d[0]*x[0] + u[0]*x[1];
+        for(ptrdiff_t i=1; i<n-1; ++i)
+            y[i] = l[i-1]*x[i-1] + d[i]*x[i] + u[i]*x[i+1];
+        y[n-1] = l[n-2]*x[n-2] + d[n-1]*x[n-1];
+    }
+
+    template <class T, class T1, class T2>
+    struct TridiagMultMV_Kernel
+    {
+        static void call(
+            const ptrdiff_t n, const T* l, const T* d, const T* u,
+            const T1* x, T2* y)
+        { TridiagMultMV_Loop(n,l,d,u,x,y); }
+    };
+
+#ifdef __SSE2__
+    // The generic loop above only gets vectorized at high optimization
+    // levels, so write the double case out explicitly.
+    template <>
+    struct TridiagMultMV_Kernel<double,double,double>
+    {
+        static void call(
+            const ptrdiff_t n, const double* l, const double* d,
+            const double* u, const double* x, double* y)
+        {
+            if (n < 4) { TridiagMultMV_Loop(n,l,d,u,x,y); return; }
+            y[0] = d[0]*x[0] + u[0]*x[1];
+            ptrdiff_t i=1;
+            __m128d xl,xd,xu,x0,x1,x2,xy;
+            for(; i<n-2; i+=2) {
+                xl = _mm_loadu_pd(l+i-1);
+                xd = _mm_loadu_pd(d+i);
+                xu = _mm_loadu_pd(u+i);
+                x0 = _mm_loadu_pd(x+i-1);
+                x1 = _mm_loadu_pd(x+i);
+                x2 = _mm_loadu_pd(x+i+1);
+                xy = _mm_add_pd(
+                    _mm_add_pd(_mm_mul_pd(xl,x0),_mm_mul_pd(xd,x1)),
+                    _mm_mul_pd(xu,x2));
+                _mm_storeu_pd(y+i,xy);
+            }
+            for(; i<n-1; ++i)
+                y[i] = l[i-1]*x[i-1] + d[i]*x[i] + u[i]*x[i+1];
+            y[n-1] = l[n-2]*x[n-2] + d[n-1]*x[n-1];
+        }
+    };
+#endif
+
+    template <class T, class V1, class V2>
+    inline void Tridiag_MultMV(
+        const TridiagMatrix<T>& A, const BaseVector_Calc<V1>& x,
+        BaseVector_Mutable<V2>& y)
+    {
+        typedef typename V1::value_type T1;
+        typedef typename V2::value_type T2;
+        const ptrdiff_t n = A.size();
+        TMVAssert(x.size() == n);
+        TMVAssert(y.size() == n);
+        if (!V1::_conj && !V2::_conj && x.step() == 1 && y.step() == 1 &&
+            !SameStorage(x.vec(),y.vec())) {
+            TridiagMultMV_Kernel<T,T1,T2>::call(
+                n,A.subDiag().cptr(),A.diag().cptr(),A.superDiag().cptr(),
+                x.vec().cptr(),y.vec().ptr());
+        } else {
+            Vector<T1> x1 = x;
+            Vector<T2> y1(n);
+            TridiagMultMV_Kernel<T,T1,T2>::call(
+                n,A.subDiag().cptr(),A.diag().cptr(),A.superDiag().cptr(),
+                x1.cptr(),y1.ptr());
+            y = y1;
+        }
+    }
+
+
+    //
+    // Thomas algorithm
+    //
+
+    template <class T>
+    inline void Tridiag_Decompose(TridiagMatrix<T>& A)
+    {
+        const ptrdiff_t n = A.size();
+        T* l = A.subDiag().ptr();
+        T* d = A.diag().ptr();
+        const T* u = A.superDiag().cptr();
+        for(ptrdiff_t k=0; k<n-1; ++k) {
+            l[k] /= d[k];
+            d[k+1] -= l[k] * u[k];
+        }
+    }
+
+    // Solve using the decomposition in l,d,u for a single right hand
+    // side x with step s.
+    template <class T, class T2>
+    inline void Tridiag_Solve_Kernel(
+        const ptrdiff_t n, const T* l, const T* d, const T* u,
+        T2* x, const ptrdiff_t s)
+    {
+        if (n == 0) return;
+        // x = L^-1 x
+        for(ptrdiff_t k=1; k<n; ++k) x[k*s] -= l[k-1] * x[(k-1)*s];
+        // x = U^-1 x
+        x[(n-1)*s] /= d[n-1];
+        for(ptrdiff_t k=n-2; k>=0; --k)
+            x[k*s] = (x[k*s] - u[k] * x[(k+1)*s]) / d[k];
+    }
+
+    template <class T, class V2>
+    inline void Tridiag_SolveInPlace(
+        const TridiagMatrix<T>& A, BaseVector_Mutable<V2>& b)
+    {
+        typedef typename V2::value_type T2;
+        TMVAssert(b.size() == A.size());
+        if (V2::_conj) {
+            Vector<T2> b1 = b;
+            Tridiag_SolveInPlace(A,b1);
+            b = b1;
+        } else {
+            Tridiag_Solve_Kernel(
+                A.size(),A.subDiag().cptr(),A.diag().cptr(),
+                A.superDiag().cptr(),b.vec().ptr(),b.step());
+        }
+    }
+
+    template <class T, class M2>
+    inline void Tridiag_SolveInPlace(
+        const TridiagMatrix<T>& A, BaseMatrix_Rec_Mutable<M2>& B)
+    {
+        typedef typename M2::value_type T2;
+        TMVAssert(B.colsize() == A.size());
+        if (M2::_conj) {
+            Matrix<T2,ColMajor> B1 = B;
+            Tridiag_SolveInPlace(A,B1);
+            B = B1;
+        } else {
+            for(ptrdiff_t j=0; j<B.rowsize(); ++j)
+                Tridiag_Solve_Kernel(
+                    A.size(),A.subDiag().cptr(),A.diag().cptr(),
+                    A.superDiag().cptr(),B.mat().ptr()+j*B.stepj(),
+                    B.stepi());
+        }
+    }
+
+
+    //
+    // Cyclic reduction
+    //
+
+    // The system at one level of the reduction: row k is
+    // a[k] x[k-1] + d[k] x[k] + c[k] x[k+1] = b[k]
+    // with a[0] = c[n-1] = 0.
+    template <class T2>
+    struct Tridiag_CRLevel
+    {
+        ptrdiff_t n;
+        std::vector<T2> a, d, c, b;
+
+        Tridiag_CRLevel(ptrdiff_t _n) :
+            n(_n), a(_n,T2(0)), d(_n), c(_n,T2(0)), b(_n) {}
+    };
+
+    template <class T2>
+    inline void Tridiag_CRReduce(
+        const Tridiag_CRLevel<T2>& lev, Tridiag_CRLevel<T2>& next)
+    {
+        const ptrdiff_t n = lev.n;
+        const ptrdiff_t neven = (n+1)/2;
+        TMVAssert(next.n == neven);
+        const T2* a = &lev.a[0];
+        const T2* d = &lev.d[0];
+        const T2* c = &lev.c[0];
+        const T2* b = &lev.b[0];
+#ifdef _OPENMP
+        const bool par =
+            n >= TMV_TRIDIAG_CR_OPENMP_THRESH &&
+            omp_get_level() == 0 && omp_get_max_threads() > 1;
+#endif
+
+        // Row i = 2r uses rows i-1 and i+1 to eliminate x[i-1] and x[i+1]:
+        // alpha = -a[i]/d[i-1], gamma = -c[i]/d[i+1]
+        // a' = alpha a[i-1]
+        // d' = d[i] + alpha c[i-1] + gamma a[i+1]
+        // c' = gamma c[i+1]
+        // b' = b[i] + alpha b[i-1] + gamma b[i+1]
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (par)
+#endif
+        for(ptrdiff_t r=0; r<neven; ++r) {
+            const ptrdiff_t i = 2*r;
+            T2 dp = d[i];
+            T2 bp = b[i];
+            T2 ap(0), cp(0);
+            if (i > 0) {
+                const T2 alpha = -a[i] / d[i-1];
+                ap = alpha * a[i-1];
+                dp += alpha * c[i-1];
+                bp += alpha * b[i-1];
+            }
+            if (i < n-1) {
+                const T2 gamma = -c[i] / d[i+1];
+                cp = gamma * c[i+1];
+                dp += gamma * a[i+1];
+                bp += gamma * b[i+1];
+            }
+            next.a[r] = ap;
+            next.d[r] = dp;
+            next.c[r] = cp;
+            next.b[r] = bp;
+        }
+    }
+
+    // Given the solution of the even rows in next.b, find the odd ones
+    // and put the full solution in lev.b.
+    template <class T2>
+    inline void Tridiag_CRBackSub(
+        Tridiag_CRLevel<T2>& lev, const Tridiag_CRLevel<T2>& next)
+    {
+        const ptrdiff_t n = lev.n;
+        const ptrdiff_t nodd = n/2;
+        const ptrdiff_t neven = (n+1)/2;
+        const T2* a = &lev.a[0];
+        const T2* d = &lev.d[0];
+        const T2* c = &lev.c[0];
+        T2* x = &lev.b[0];
+#ifdef _OPENMP
+        const bool par =
+            n >= TMV_TRIDIAG_CR_OPENMP_THRESH &&
+            omp_get_level() == 0 && omp_get_max_threads() > 1;
+#endif
+
+        // x[j] = (b[j] - a[j] x[j-1] - c[j] x[j+1]) / d[j]
+        // This needs the old b[j] for the odd j, so do these before
+        // copying the even values.
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (par)
+#endif
+        for(ptrdiff_t r=0; r<nodd; ++r) {
+            const ptrdiff_t j = 2*r+1;
+            T2 xj = x[j] - a[j] * next.b[r];
+            if (j < n-1) xj -= c[j] * next.b[r+1];
+            x[j] = xj / d[j];
+        }
+        for(ptrdiff_t r=0; r<neven; ++r) x[2*r] = next.b[r];
+    }
+
+    template <class T, class V2>
+    inline void Tridiag_SolveCR(
+        const TridiagMatrix<T>& A, BaseVector_Mutable<V2>& x)
+    {
+        typedef typename V2::value_type T2;
+        const ptrdiff_t n = A.size();
+        TMVAssert(x.size() == n);
+        if (n == 0) return;
+
+        // As for BlockTridiag_SolveCR, the levels are all done as T2,
+        // and are kept in a deque so lev stays valid in the loop below.
+        typedef Tridiag_CRLevel<T2> Level;
+        std::deque<Level> levels;
+        levels.push_back(Level(n));
+        Level& lev0 = levels.front();
+        for(ptrdiff_t k=0; k<n; ++k) {
+            lev0.d[k] = A.diag().cref(k);
+            if (k > 0) lev0.a[k] = A.subDiag().cref(k-1);
+            if (k < n-1) lev0.c[k] = A.superDiag().cref(k);
+            lev0.b[k] = x.cref(k);
+        }
+
+        while (levels.back().n > 1) {
+            Level& lev = levels.back();
+            levels.push_back(Level((lev.n+1)/2));
+            Tridiag_CRReduce(lev,levels.back());
+        }
+
+        Level& last = levels.back();
+        last.b[0] /= last.d[0];
+
+        for(ptrdiff_t l=levels.size()-1; l>0; --l)
+            Tridiag_CRBackSub(levels[l-1],levels[l]);
+        for(ptrdiff_t k=0; k<n; ++k) x.ref(k) = lev0.b[k];
+    }
+
+
+    //
+    // TridiagMatrixBatch
+    //
+
+    template <class T>
+    class TridiagMatrixBatch
+    {
+    public:
+
+        typedef T value_type;
+        typedef TridiagMatrixBatch<T> type;
+        typedef Matrix<T,ColMajor> storage_type;
+        typedef typename storage_type::view_type diag_type;
+        typedef typename storage_type::const_view_type const_diag_type;
+
+        TridiagMatrixBatch(ptrdiff_t nbatch, ptrdiff_t n) :
+            itsn(n), itsl(nbatch,n>0?n-1:0), itsd(nbatch,n),
+            itsu(nbatch,n>0?n-1:0)
+        { TMVAssert(nbatch >= 0 && n >= 0); }
+
+        TridiagMatrixBatch(ptrdiff_t nbatch, ptrdiff_t n, T x) :
+            itsn(n), itsl(nbatch,n>0?n-1:0,x), itsd(nbatch,n,x),
+            itsu(nbatch,n>0?n-1:0,x)
+        { TMVAssert(nbatch >= 0 && n >= 0); }
+
+        TMV_INLINE ptrdiff_t nBatch() const { return itsd.colsize(); }
+        TMV_INLINE ptrdiff_t size() const { return itsn; }
+        TMV_INLINE ptrdiff_t colsize() const { return itsn; }
+        TMV_INLINE ptrdiff_t rowsize() const { return itsn; }
+
+        TMV_INLINE const_diag_type diag() const { return itsd.view(); }
+        TMV_INLINE const_diag_type subDiag() const { return itsl.view(); }
+        TMV_INLINE const_diag_type superDiag() const { return itsu.view(); }
+        TMV_INLINE diag_type diag() { return itsd.view(); }
+        TMV_INLINE diag_type subDiag() { return itsl.view(); }
+        TMV_INLINE diag_type superDiag() { return itsu.view(); }
+
+        type& setZero()
+        { itsl.setZero(); itsd.setZero(); itsu.setZero(); return *this; }
+
+        type& setAllTo(const T& x)
+        {
+            itsl.setAllTo(x); itsd.setAllTo(x); itsu.setAllTo(x);
+            return *this;
+        }
+
+    private:
+
+        ptrdiff_t itsn;
+        storage_type itsl;
+        storage_type itsd;
+        storage_type itsu;
+
+    }; // TridiagMatrixBatch
+
+    template <class T>
+    inline std::string TMV_Text(const TridiagMatrixBatch<T>& )
+    { return std::string("TridiagMatrixBatch<")+TMV_Text(T())+">"; }
+
+    template <class T>
+    struct BatchTridiagDecompose_Helper
+    {
+        TridiagMatrixBatch<T>& A;
+
+        BatchTridiagDecompose_Helper(TridiagMatrixBatch<T>& _A) : A(_A) {}
+
+        void operator()(const ptrdiff_t b1, const ptrdiff_t nb) const
+        {
+            const ptrdiff_t n = A.size();
+            if (n == 0) return;
+            const ptrdiff_t s = A.nBatch();
+            T* l = A.subDiag().ptr() + b1;
+            T* d = A.diag().ptr() + b1;
+            const T* u = A.superDiag().cptr() + b1;
+            // d is replaced by 1/d' so the solve doesn't need to divide.
+            for(ptrdiff_t k=0; k<n-1; ++k) {
+                T* lk = l + k*s;
+                T* dk = d + k*s;
+                const T* uk = u + k*s;
+                T* dkp1 = d + (k+1)*s;
+                for(ptrdiff_t b=0; b<nb; ++b) {
+                    dk[b] = T(1) / dk[b];
+                    lk[b] *= dk[b];
+                    dkp1[b] -= lk[b] * uk[b];
+                }
+            }
+            T* dlast = d + (n-1)*s;
+            for(ptrdiff_t b=0; b<nb; ++b) dlast[b] = T(1) / dlast[b];
+        }
+    };
+
+    template <class T>
+    inline void BatchTridiag_Decompose(TridiagMatrixBatch<T>& A)
+    { BatchLoop(A.nBatch(),BatchTridiagDecompose_Helper<T>(A)); }
+
+    template <class T, class T2>
+    struct BatchTridiagSolve_Helper
+    {
+        const TridiagMatrixBatch<T>& A;
+        T2* x;
+        const ptrdiff_t sx;
+
+        BatchTridiagSolve_Helper(
+            const TridiagMatrixBatch<T>& _A, T2* _x, ptrdiff_t _sx) :
+            A(_A), x(_x), sx(_sx) {}
+
+        void operator()(const ptrdiff_t b1, const ptrdiff_t nb) const
+        {
+            const ptrdiff_t n = A.size();
+            if (n == 0) return;
+            const ptrdiff_t s = A.nBatch();
+            const T* l = A.subDiag().cptr() + b1;
+            const T* d = A.diag().cptr() + b1;
+            const T* u = A.superDiag().cptr() + b1;
+            T2* xb = x + b1;
+            // x = L^-1 x
+            for(ptrdiff_t k=1; k<n; ++k) {
+                const T* lkm1 = l + (k-1)*s;
+                const T2* xkm1 = xb + (k-1)*sx;
+                T2* xk = xb + k*sx;
+                for(ptrdiff_t b=0; b<nb; ++b) xk[b] -= lkm1[b] * xkm1[b];
+            }
+            // x = U^-1 x
+            T2* xlast = xb + (n-1)*sx;
+            const T* dlast = d + (n-1)*s;
+            for(ptrdiff_t b=0; b<nb; ++b) xlast[b] *= dlast[b];
+            for(ptrdiff_t k=n-2; k>=0; --k) {
+                const T* dk = d + k*s;
+                const T* uk = u + k*s;
+                const T2* xkp1 = xb + (k+1)*sx;
+                T2* xk = xb + k*sx;
+                for(ptrdiff_t b=0; b<nb; ++b)
+                    xk[b] = (xk[b] - uk[b] * xkp1[b]) * dk[b];
+            }
+        }
+    };
+
+    template <class T, class M2>
+    inline void BatchTridiag_SolveInPlace(
+        const TridiagMatrixBatch<T>& A, BaseMatrix_Rec_Mutable<M2>& X)
+    {
+        typedef typename M2::value_type T2;
+        TMVAssert(X.colsize() == A.nBatch());
+        TMVAssert(X.rowsize() == A.size());
+        if (M2::_conj || X.stepi() != 1) {
+            Matrix<T2,ColMajor> X1 = X;
+            BatchTridiag_SolveInPlace(A,X1);
+            X = X1;
+        } else {
+            BatchLoop(
+                A.nBatch(),
+                BatchTridiagSolve_Helper<T,T2>(A,X.mat().ptr(),X.stepj()));
+        }
+    }
+
+} // namespace tmv
+
+#endif
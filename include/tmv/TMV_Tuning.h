@@ -0,0 +1,299 @@
+
+
+// This file defines the tuning profile, which holds the crossover points
+// that the run time algorithm selection uses.
+//
+// Several of the algorithm choices are made according to thresholds
+// that were measured empirically on one particular machine.  e.g. The
+// size at which MultMM switches from the block algorithm to the packed
+// one, or at which QR_Decompose switches from the unblocked algorithm to
+// a blocked one.  The best values depend on the cache sizes, the memory
+// bandwidth, and the vector units of the processor, so they can be
+// quite different on different machines.
+//
+// The compile time macros (TMV_MM_MIN_PACKED, etc.) are the defaults.
+// The first time the profile is needed, it is read from the file named
+// by the environment variable TMV_TUNING_FILE if it is set.  The
+// tmvtune program in the speed directory measures the crossover points
+// on the current machine and writes such a file.
+//
+// The file has one "name value" pair per line.  Lines that start
+// with # are comments.  Any values that aren't listed in the file keep
+// their default values.  The names are:
+//
+// mm_min_copy_algo
+//     The minimum (M*N*K/16^3) to use one of the algorithms that copies
+//     the blocks of the matrices when one of M,N,K is less than 16.
+//     (MultMM algo 71)
+// mm_openmp_thresh
+//     The minimum (M*N*K/16^3) to use the OpenMP algorithm.  (algo 71)
+// mm_min_recursive
+//     The minimum (M/64)*(N/64)*(K/64)^2 to use the recursive block
+//     algorithm rather than the looping one.  (algo 73)
+// mm_min_packed
+//     The minimum M, N and K to use the packed algorithm.  (algo 73)
+// mm_min_winograd
+//     The minimum M, N and K to use the Winograd algorithm, when it is
+//     enabled.  (algo 72 and MultMM_Winograd)
+// qr_min_blocked
+//     The minimum M*N*sizeof(T) (in bytes) to use a blocked algorithm
+//     rather than the unblocked one.  (QR_Decompose algo 31)
+// qr_max_recursive
+//     The maximum N to use the recursive algorithm rather than the
+//     block algorithm.  (QR_Decompose algo 31)
+// qrp_min_blocked
+//     Same as qr_min_blocked for QRP_Decompose algo 31.
+// bidiag_min_blocked
+//     Same as qr_min_blocked for Bidiagonalize algo 31.
+//
+// The following functions let you control the profile:
+//
+// GetTuning()
+//     Return a reference to the current profile.
+// SetTuning(profile)
+//     Replace the current profile.
+// DefaultTuning()
+//     Return a profile with the compile time defaults.
+// LoadTuning(filename)
+//     Read the values in the file into the current profile.  Returns
+//     false if the file could not be read.
+// SaveTuning(filename)
+//     Write the current profile to the file.  Returns false if the file
+//     could not be written.
+// ReadTuning(is, profile)
+// WriteTuning(os, profile)
+//     The same for streams.
+//
+// These functions are not thread safe, so the profile should not be
+// changed while other threads are using TMV.
+
+#ifndef TMV_Tuning_H
+#define TMV_Tuning_H
+
+#include "TMV_Base.h"
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+// The defaults for the crossover points that are used at run time when
+// the sizes aren't known at compile time.  The values that are used at
+// run time are in the tuning profile, which can be measured on each
+// machine with the tmvtune program.
+
+// The minimum size to use a recursive Winograd algorithm.
+// (The larger value goes with TMV_MM_USE_RECURSIVE_BLOCK in 
+// TMV_MultMM.h, which is also set for TMV_OPT >= 2.)
+#ifndef TMV_MM_MIN_WINOGRAD
+#if TMV_OPT >= 2
+#define TMV_MM_MIN_WINOGRAD 2048
+#else
+#define TMV_MM_MIN_WINOGRAD 1024
+#endif
+#endif
+
+// The minimum value of Mb*Nb*Kb*Kb to use recursive algorithm.
+// This formula for the crossover between algorithms 63 and 64 is
+// purely empirical on my MacBook (with an Intel Core 2 Duo processor),
+// so it might not even be the right thing to parametrize on other
+// machines.  On the other hand, the difference between the two algorithms
+// isn't _that_ extreme.  At most I've seen about a factor of 2, so
+// if I use the less optimal algorithm for some sizes, it's not that
+// terrible a mistake.
+#ifndef TMV_MM_MIN_RECURSIVE
+#define TMV_MM_MIN_RECURSIVE 16*1024
+#endif
+
+// The minimum value of M, N, and K to use the packed algorithm in
+// TMV_MultMM_Packed.h.  For smaller matrices, the packing overhead 
+// isn't worth it, and the regular block algorithm is faster.
+#ifndef TMV_MM_MIN_PACKED
+#define TMV_MM_MIN_PACKED 128
+#endif
+
+// The minimum value of (M*N*K / 16^3) to use multiple threads.
+// (We also require that at least one of M, N, K is >= 64.)  The OpenMP
+// algorithm (MultMM algo 69) splits m3 into 2D tiles, and also splits 
+// K when there are too few tiles for the number of threads, so any of
+// the three dimensions gives it something to split.
+#ifndef TMV_MM_OPENMP_THRESH
+#define TMV_MM_OPENMP_THRESH 64
+#endif
+// There are some sizes where this selection formula doesn't quite work,
+// but it seems to be not too bad.  But maybe this deserves a bit more
+// work to find a better formula, since the ratio of time for omp to
+// not using omp is not at all monotonic in M*N*K.  So perhaps a 
+// different formula would be better.
+
+//                    no omp    omp    omp/not    M*N*K/16^3
+//  16 x  16 x  16    1.275    9.503    7.453       1
+//  16 x  16 x  64    1.224    4.716    3.852       4
+//  64 x  16 x  16    1.168    2.891    2.475       4
+//  16 x  64 x  16    1.122    2.752    2.452       4
+//  16 x  16 x 256    1.259    2.158    1.714      16
+//  64 x  64 x  16    1.070    1.303    1.217      16
+//  16 x 256 x  16    1.126    1.250    1.110      16
+// 256 x  16 x  16    1.186    1.186    1.000      16
+//  64 x  16 x  64    1.145    1.096    0.957      16
+//  16 x  64 x  64    1.146    1.051    0.917      16
+
+// ^^^^ My formula says don't use omp
+// vvvv My formula says use omp
+
+//  64 x  64 x  64    0.655    0.679    1.036      64
+//  64 x  16 x 256    1.201    1.213    1.009      64
+//  16 x  64 x 256    1.191    1.195    1.003      64
+// 256 x  16 x 256    0.566    0.551    0.973     256
+//  64 x 256 x  64    0.465    0.412    0.886     256
+//  64 x  64 x 256    0.619    0.546    0.882     256
+// 256 x  64 x  64    0.463    0.406    0.876     256
+// 256 x  64 x 256    0.431    0.334    0.774    1024
+//  64 x 256 x  16    1.055    0.836    0.792      64
+// 256 x  64 x  16    1.098    0.840    0.765      64
+//  64 x 256 x 256    0.444    0.317    0.713    1024
+// 256 x 256 x  16    1.080    0.722    0.668     256
+// 256 x 256 x  64    0.429    0.271    0.631    1024
+// 256 x 256 x 256    0.401    0.239    0.596    4096
+//  16 x 256 x  64    1.124    0.539    0.479      64
+// 256 x  16 x  64    1.143    0.537    0.469      64
+//  16 x 256 x 256    1.143    0.528    0.461     256
+
+// The minimum value of (M*N*K / 16^3) to use copying algorithm
+// where each block is copied to temporary storage in a block structure.
+#ifndef TMV_MM_MIN_COPY_ALGO
+#define TMV_MM_MIN_COPY_ALGO 4
+#endif
+
+// The default for the blocked QR, QRP and bidiagonalization algorithms
+// is for the matrix to not fit in the L2 cache.
+#ifndef TMV_QR_MIN_BLOCKED
+#define TMV_QR_MIN_BLOCKED (TMV_L2_CACHE*1024)
+#endif
+#ifndef TMV_QR_MAX_RECURSIVE
+#define TMV_QR_MAX_RECURSIVE 128
+#endif
+
+namespace tmv {
+
+    struct TuningProfile
+    {
+        ptrdiff_t mm_min_copy_algo;
+        ptrdiff_t mm_openmp_thresh;
+        ptrdiff_t mm_min_recursive;
+        ptrdiff_t mm_min_packed;
+        ptrdiff_t mm_min_winograd;
+        ptrdiff_t qr_min_blocked;
+        ptrdiff_t qr_max_recursive;
+        ptrdiff_t qrp_min_blocked;
+        ptrdiff_t bidiag_min_blocked;
+    };
+
+    inline TuningProfile DefaultTuning()
+    {
+        TuningProfile p;
+        p.mm_min_copy_algo = TMV_MM_MIN_COPY_ALGO;
+        p.mm_openmp_thresh = TMV_MM_OPENMP_THRESH;
+        p.mm_min_recursive = TMV_MM_MIN_RECURSIVE;
+        p.mm_min_packed = TMV_MM_MIN_PACKED;
+        p.mm_min_winograd = TMV_MM_MIN_WINOGRAD;
+        p.qr_min_blocked = TMV_QR_MIN_BLOCKED;
+        p.qr_max_recursive = TMV_QR_MAX_RECURSIVE;
+        p.qrp_min_blocked = TMV_QR_MIN_BLOCKED;
+        p.bidiag_min_blocked = TMV_QR_MIN_BLOCKED;
+        return p;
+    }
+
+    struct TuningField
+    {
+        const char* name;
+        ptrdiff_t TuningProfile::* value;
+    };
+
+    inline const TuningField* TuningFields()
+    {
+        static const TuningField fields[] = {
+            { "mm_min_copy_algo", &TuningProfile::mm_min_copy_algo },
+            { "mm_openmp_thresh", &TuningProfile::mm_openmp_thresh },
+            { "mm_min_recursive", &TuningProfile::mm_min_recursive },
+            { "mm_min_packed", &TuningProfile::mm_min_packed },
+            { "mm_min_winograd", &TuningProfile::mm_min_winograd },
+            { "qr_min_blocked", &TuningProfile::qr_min_blocked },
+            { "qr_max_recursive", &TuningProfile::qr_max_recursive },
+            { "qrp_min_blocked", &TuningProfile::qrp_min_blocked },
+            { "bidiag_min_blocked", &TuningProfile::bidiag_min_blocked },
+            { 0, 0 }
+        };
+        return fields;
+    }
+
+    inline bool ReadTuning(std::istream& is, TuningProfile& p)
+    {
+        std::string line;
+        while (std::getline(is,line)) {
+            std::istringstream ss(line);
+            std::string name;
+            ptrdiff_t value;
+            if (!(ss >> name) || name[0] == '#') continue;
+            if (!(ss >> value)) {
+                TMV_Warning("Invalid line in tuning profile:\n"+line);
+                continue;
+            }
+            const TuningField* f = TuningFields();
+            while (f->name && name != f->name) ++f;
+            if (f->name) p.*(f->value) = value;
+            else TMV_Warning("Unknown name in tuning profile: "+name);
+        }
+        return !is.bad();
+    }
+
+    inline void WriteTuning(std::ostream& os, const TuningProfile& p)
+    {
+        os << "# TMV tuning profile\n";
+        for(const TuningField* f = TuningFields(); f->name; ++f)
+            os << f->name << ' ' << p.*(f->value) << '\n';
+    }
+
+    struct TuningSingleton
+    {
+        static TuningProfile& inst()
+        {
+            static TuningProfile p = init();
+            return p;
+        }
+
+        static TuningProfile init()
+        {
+            TuningProfile p = DefaultTuning();
+            const char* file = std::getenv("TMV_TUNING_FILE");
+            if (file && *file) {
+                std::ifstream fin(file);
+                if (!fin || !ReadTuning(fin,p))
+                    TMV_Warning(
+                        std::string("Unable to read tuning profile ")+file);
+            }
+            return p;
+        }
+    };
+
+    inline TuningProfile& GetTuning()
+    { return TuningSingleton::inst(); }
+
+    inline void SetTuning(const TuningProfile& p)
+    { TuningSingleton::inst() = p; }
+
+    inline bool LoadTuning(const std::string& file)
+    {
+        std::ifstream fin(file.c_str());
+        return fin && ReadTuning(fin,GetTuning());
+    }
+
+    inline bool SaveTuning(const std::string& file)
+    {
+        std::ofstream fout(file.c_str());
+        if (!fout) return false;
+        WriteTuning(fout,GetTuning());
+        return bool(fout);
+    }
+
+} // namespace tmv
+
+#endif
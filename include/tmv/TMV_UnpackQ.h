@@ -209,6 +209,7 @@ namespace tmv {
 #endif
             typedef typename M::value_type T;
             typedef typename MCopyHelper<T,Rec,cs,rs>::type Mcm;
+            ScratchScope scope;
             Mcm Qcm = Q;
             UnpackQ_Helper<-2,cs,rs,Mcm,V>::call(Qcm,beta);
             typename M::noalias_type Qna = Q.noAlias();
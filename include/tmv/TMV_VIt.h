@@ -151,7 +151,7 @@ namespace tmv {
         }
         void swapWith(ConjRef<CT> x2)
         {
-            TMVAssert(&val != &x2);
+            TMVAssert(&val != &x2.val);
             CT temp = x2.val; x2.val = val; val = temp; 
         }
 
@@ -0,0 +1,660 @@
+
+// This is the benchmark suite.  Unlike the other programs in this
+// directory, which are set up by editing the #defines at the top,
+// everything here is chosen on the command line:
+//
+// tmvbench [options]
+//
+//   -op list       The operations to time (default multmm):
+//                      dot     x * y
+//                      axpy    y += a * x
+//                      multmv  y = A * x
+//                      multmm  C = A * B
+//                      lu      LU decomposition (using divideUsing(LU))
+//                      qr      QR decomposition (using divideUsing(QR))
+//                      chol    Cholesky decomposition (using divideUsing(CH))
+//                      solve   X = B / A with B N x N and A already
+//                              LU decomposed
+//   -type list     float, double, cfloat, cdouble (default double)
+//   -stor list     col, row (default col).  The vector operations are
+//                  only done once, with stor = "-".
+//   -n list        The sizes (default 64:1024).  Each item is either
+//                  a single size, a:b to double from a to b, a:b:xf to
+//                  multiply by f, or a:b:s to step by s.
+//   -threads list  The number of OpenMP threads (default 1).
+//   -reps r        The number of timed repetitions (default 10).
+//   -warmup w      The minimum number of untimed calls (default 2).
+//   -mintime t     The minimum time in seconds for each repetition
+//                  (default 0.02).  Small problems are called in a loop
+//                  enough times to take this long.
+//   -csv file      Write the results in CSV format to file.
+//   -json file     Write the results in JSON format to file.
+//   -baseline file Compare the results to a CSV file from an earlier run.
+//   -tol x         The relative slowdown that counts as a regression
+//                  (default 0.1).
+//
+// e.g. tmvbench -op multmm,lu -type double,cdouble -n 100:1000:100
+//
+// The lists are comma separated.  Every combination is run.
+//
+// Each repetition is timed with a monotonic clock, so the times are
+// not affected by changes to the system time.  We report the median
+// time per call, the relative standard deviation of the repetitions,
+// and the GFlop/s and GB/s for the median time.  The flop counts use
+// the nominal count for each operation with complex operations counted
+// as 4 real ones, and the byte counts are the minimum memory traffic:
+// reading each input and writing each output once.
+//
+// When a baseline file is given, each result with the same op, type,
+// stor, threads and n in the baseline is compared to it.  A result is a
+// regression if its rate is lower by more than the larger of the
+// tolerance and twice the relative standard deviation of the two runs.
+// The program returns 2 if any result is a regression, so it can be
+// used in a script.
+//
+// The library should be compiled with the same options as the ones
+// used for this program.
+
+#include "TMV.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <complex>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#if __cplusplus >= 201103L
+#include <chrono>
+#else
+#include <time.h>
+#endif
+
+#ifdef _OPENMP
+#include "omp.h"
+#endif
+
+static double GetTime()
+{
+#if __cplusplus >= 201103L
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+    timespec tp;
+    clock_gettime(CLOCK_MONOTONIC,&tp);
+    return tp.tv_sec + tp.tv_nsec/1.e9;
+#endif
+}
+
+struct Options
+{
+    std::vector<std::string> ops, types, stors;
+    std::vector<ptrdiff_t> ns;
+    std::vector<int> threads;
+    int reps, warmup;
+    double mintime, tol;
+    std::string csv, json, baseline;
+};
+
+struct Result
+{
+    std::string op, type, stor;
+    int threads;
+    ptrdiff_t n;
+    int reps;
+    long loops;
+    double tmin, tmed, tmean, tsd;
+    double flops, bytes;
+
+    double gflops() const { return flops / tmed * 1.e-9; }
+    double gbytes() const { return bytes / tmed * 1.e-9; }
+    double relsd() const { return tmean > 0. ? tsd / tmean : 0.; }
+    std::string key() const
+    {
+        std::ostringstream s;
+        s << op << ',' << type << ',' << stor << ',' << threads << ',' << n;
+        return s.str();
+    }
+};
+
+//
+// The operations
+//
+
+static double Rand() { return double(std::rand()) / RAND_MAX - 0.5; }
+static void SetRand(float& x) { x = float(Rand()); }
+static void SetRand(double& x) { x = Rand(); }
+template <class T>
+static void SetRand(std::complex<T>& x)
+{ x = std::complex<T>(T(Rand()),T(Rand())); }
+
+template <class V>
+static void Randomize(V& v)
+{ for(ptrdiff_t i=0;i<v.size();++i) SetRand(v(i)); }
+
+template <class T, int S>
+static void Randomize(tmv::Matrix<T,S>& m)
+{
+    for(ptrdiff_t i=0;i<m.colsize();++i)
+        for(ptrdiff_t j=0;j<m.rowsize();++j)
+            SetRand(m(i,j));
+}
+
+struct Kernel
+{
+    double flops, bytes;
+    virtual ~Kernel() {}
+    virtual void operator()() = 0;
+};
+
+template <class T>
+struct DotKernel : public Kernel
+{
+    tmv::Vector<T> x, y;
+    T sum;
+    DotKernel(ptrdiff_t n) : x(n), y(n), sum(0)
+    {
+        Randomize(x); Randomize(y);
+        flops = 2.*n; bytes = 2.*n*sizeof(T);
+    }
+    void operator()() { sum += x * y; }
+};
+
+template <class T>
+struct AxpyKernel : public Kernel
+{
+    tmv::Vector<T> x, y;
+    AxpyKernel(ptrdiff_t n) : x(n), y(n)
+    {
+        Randomize(x); Randomize(y);
+        flops = 2.*n; bytes = 3.*n*sizeof(T);
+    }
+    // Alternate the sign so y doesn't grow.
+    void operator()() { y += T(1.e-3) * x; x = -x; }
+};
+
+template <class T, int S>
+struct MultMVKernel : public Kernel
+{
+    tmv::Matrix<T,S> A;
+    tmv::Vector<T> x, y;
+    MultMVKernel(ptrdiff_t n) : A(n,n), x(n), y(n)
+    {
+        Randomize(A); Randomize(x);
+        flops = 2.*n*n; bytes = (n*n + 2.*n)*sizeof(T);
+    }
+    void operator()() { y = A * x; }
+};
+
+template <class T, int S>
+struct MultMMKernel : public Kernel
+{
+    tmv::Matrix<T,S> A, B, C;
+    MultMMKernel(ptrdiff_t n) : A(n,n), B(n,n), C(n,n)
+    {
+        Randomize(A); Randomize(B);
+        flops = 2.*n*n*n; bytes = 3.*n*n*sizeof(T);
+    }
+    void operator()() { C = A * B; }
+};
+
+// The decompositions include copying A into the divider's storage,
+// which is how they are normally done.
+template <class T, int S>
+struct DecompKernel : public Kernel
+{
+    tmv::Matrix<T,S> A;
+    DecompKernel(ptrdiff_t n, tmv::DivType dt, double nflops) : A(n,n)
+    {
+        Randomize(A);
+        if (dt == tmv::CH) {
+            // Make A positive definite.
+            tmv::Matrix<T,S> A0 = A;
+            A = A0 * A0.adjoint();
+            A.diag().addToAll(T(n));
+        }
+        A.saveDiv();
+        A.divideUsing(dt);
+        flops = nflops; bytes = 2.*n*n*sizeof(T);
+    }
+    void operator()() { A.resetDiv(); A.setDiv(); }
+};
+
+template <class T, int S>
+struct SolveKernel : public Kernel
+{
+    tmv::Matrix<T,S> A, B, X;
+    SolveKernel(ptrdiff_t n) : A(n,n), B(n,n), X(n,n)
+    {
+        Randomize(A); Randomize(B);
+        A.diag().addToAll(T(n));
+        A.saveDiv();
+        A.divideUsing(tmv::LU);
+        A.setDiv();
+        flops = 2.*n*n*n; bytes = 3.*n*n*sizeof(T);
+    }
+    void operator()() { X = B / A; }
+};
+
+static bool IsVectorOp(const std::string& op)
+{ return op == "dot" || op == "axpy"; }
+
+template <class T, int S>
+static Kernel* MakeKernel(const std::string& op, ptrdiff_t n)
+{
+    const double x = tmv::Traits<T>::iscomplex ? 4. : 1.;
+    const double n3 = double(n)*n*n;
+    Kernel* k = 0;
+    if (op == "dot") k = new DotKernel<T>(n);
+    else if (op == "axpy") k = new AxpyKernel<T>(n);
+    else if (op == "multmv") k = new MultMVKernel<T,S>(n);
+    else if (op == "multmm") k = new MultMMKernel<T,S>(n);
+    else if (op == "lu") k = new DecompKernel<T,S>(n,tmv::LU,2./3.*n3);
+    else if (op == "qr") k = new DecompKernel<T,S>(n,tmv::QR,4./3.*n3);
+    else if (op == "chol") k = new DecompKernel<T,S>(n,tmv::CH,1./3.*n3);
+    else if (op == "solve") k = new SolveKernel<T,S>(n);
+    else return 0;
+    k->flops *= x;
+    return k;
+}
+
+//
+// The timing
+//
+
+static double Median(std::vector<double> v)
+{
+    std::sort(v.begin(),v.end());
+    const size_t m = v.size()/2;
+    return v.size() % 2 ? v[m] : 0.5*(v[m-1]+v[m]);
+}
+
+static void Measure(Kernel& f, const Options& opt, Result& r)
+{
+    for(int i=0;i<opt.warmup;++i) f();
+
+    // Find the number of loops that takes at least mintime.
+    // These calls also serve as more warm up.
+    long nloops = 1;
+    for(;;) {
+        const double t0 = GetTime();
+        for(long i=0;i<nloops;++i) f();
+        const double t = GetTime() - t0;
+        if (t >= opt.mintime) break;
+        nloops = t > 0. ?
+            long(nloops * 1.2 * opt.mintime / t) + 1 : nloops * 10;
+    }
+
+    std::vector<double> times(opt.reps);
+    for(int k=0;k<opt.reps;++k) {
+        const double t0 = GetTime();
+        for(long i=0;i<nloops;++i) f();
+        times[k] = (GetTime() - t0) / nloops;
+    }
+
+    double sum = 0., sumsq = 0.;
+    for(int k=0;k<opt.reps;++k) sum += times[k];
+    r.tmean = sum / opt.reps;
+    for(int k=0;k<opt.reps;++k)
+        sumsq += (times[k]-r.tmean) * (times[k]-r.tmean);
+    r.tsd = opt.reps > 1 ? std::sqrt(sumsq / (opt.reps-1)) : 0.;
+    r.tmin = *std::min_element(times.begin(),times.end());
+    r.tmed = Median(times);
+    r.reps = opt.reps;
+    r.loops = nloops;
+    r.flops = f.flops;
+    r.bytes = f.bytes;
+}
+
+static void WriteHeader(std::ostream& os)
+{
+    os << "op       type     stor  thr       n   loops   time/call   +-%"
+        "    GFlop/s      GB/s\n";
+}
+
+static void WriteResult(std::ostream& os, const Result& r)
+{
+    os << std::left << std::setw(9) << r.op << std::setw(9) << r.type
+        << std::setw(4) << r.stor << std::right
+        << std::setw(5) << r.threads << std::setw(8) << r.n
+        << std::setw(8) << r.loops
+        << std::setw(12) << std::setprecision(4) << r.tmed
+        << std::setw(6) << std::setprecision(2) << std::fixed
+        << 100.*r.relsd()
+        << std::setw(11) << r.gflops() << std::setw(10) << r.gbytes()
+        << std::endl;
+    os.unsetf(std::ios_base::floatfield);
+    os << std::setprecision(6);
+}
+
+template <class T, int S>
+static void RunStor(
+    const Options& opt, const std::string& type, const std::string& stor,
+    std::vector<Result>& results)
+{
+    for(size_t io=0;io<opt.ops.size();++io) {
+        const std::string& op = opt.ops[io];
+        // Only do the vector ops once.
+        if (IsVectorOp(op) != (stor == "-")) continue;
+        for(size_t it=0;it<opt.threads.size();++it) {
+#ifdef _OPENMP
+            omp_set_num_threads(opt.threads[it]);
+#endif
+            for(size_t in=0;in<opt.ns.size();++in) {
+                Result r;
+                r.op = op; r.type = type; r.stor = stor;
+                r.threads = opt.threads[it];
+                r.n = opt.ns[in];
+                std::srand(1234);
+                Kernel* f = MakeKernel<T,S>(op,r.n);
+                Measure(*f,opt,r);
+                delete f;
+                WriteResult(std::cout,r);
+                results.push_back(r);
+            }
+        }
+    }
+}
+
+template <class T>
+static void RunType(
+    const Options& opt, const std::string& type, std::vector<Result>& results)
+{
+    RunStor<T,tmv::ColMajor>(opt,type,"-",results);
+    for(size_t is=0;is<opt.stors.size();++is) {
+        if (opt.stors[is] == "col")
+            RunStor<T,tmv::ColMajor>(opt,type,"col",results);
+        else
+            RunStor<T,tmv::RowMajor>(opt,type,"row",results);
+    }
+}
+
+//
+// The output formats
+//
+
+static const char* csvheader =
+    "op,type,stor,threads,n,reps,loops,"
+    "time_min,time_median,time_mean,time_stddev,gflops,gbytes";
+
+static void WriteCSV(std::ostream& os, const std::vector<Result>& results)
+{
+    os << csvheader << '\n';
+    os << std::setprecision(8);
+    for(size_t i=0;i<results.size();++i) {
+        const Result& r = results[i];
+        os << r.key() << ',' << r.reps << ',' << r.loops << ','
+            << r.tmin << ',' << r.tmed << ',' << r.tmean << ',' << r.tsd << ','
+            << r.gflops() << ',' << r.gbytes() << '\n';
+    }
+}
+
+static void WriteJSON(std::ostream& os, const std::vector<Result>& results)
+{
+    os << std::setprecision(8);
+    os << "{\n  \"tmv_opt\": " << TMV_OPT << ",\n";
+#ifdef _OPENMP
+    os << "  \"max_threads\": " << omp_get_max_threads() << ",\n";
+#else
+    os << "  \"max_threads\": 1,\n";
+#endif
+    os << "  \"results\": [";
+    for(size_t i=0;i<results.size();++i) {
+        const Result& r = results[i];
+        os << (i ? ",\n" : "\n")
+            << "    {\"op\": \"" << r.op << "\", \"type\": \"" << r.type
+            << "\", \"stor\": \"" << r.stor << "\", \"threads\": "
+            << r.threads << ", \"n\": " << r.n
+            << ", \"reps\": " << r.reps << ", \"loops\": " << r.loops
+            << ", \"time_min\": " << r.tmin
+            << ", \"time_median\": " << r.tmed
+            << ", \"time_mean\": " << r.tmean
+            << ", \"time_stddev\": " << r.tsd
+            << ", \"gflops\": " << r.gflops()
+            << ", \"gbytes\": " << r.gbytes() << "}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+//
+// The baseline comparison
+//
+
+static std::vector<std::string> Split(const std::string& s, char c)
+{
+    std::vector<std::string> v;
+    std::string::size_type i0 = 0;
+    for(;;) {
+        std::string::size_type i1 = s.find(c,i0);
+        v.push_back(s.substr(i0,i1-i0));
+        if (i1 == std::string::npos) break;
+        i0 = i1+1;
+    }
+    return v;
+}
+
+// Returns the number of regressions, or -1 if the file can't be read.
+static int CompareBaseline(
+    const std::string& file, const std::vector<Result>& results, double tol)
+{
+    std::ifstream fin(file.c_str());
+    std::string line;
+    if (!fin || !std::getline(fin,line)) return -1;
+    const std::vector<std::string> names = Split(line,',');
+    const ptrdiff_t imed = std::find(
+        names.begin(),names.end(),"time_median") - names.begin();
+    const ptrdiff_t imean = std::find(
+        names.begin(),names.end(),"time_mean") - names.begin();
+    const ptrdiff_t isd = std::find(
+        names.begin(),names.end(),"time_stddev") - names.begin();
+    const ptrdiff_t nnames = names.size();
+    if (nnames < 5 || imed == nnames || imean == nnames || isd == nnames)
+        return -1;
+
+    // key -> (median time, relative stddev)
+    std::map<std::string,std::pair<double,double> > base;
+    while (std::getline(fin,line)) {
+        const std::vector<std::string> v = Split(line,',');
+        if (ptrdiff_t(v.size()) != nnames) continue;
+        const std::string key = v[0]+','+v[1]+','+v[2]+','+v[3]+','+v[4];
+        const double tmed = std::atof(v[imed].c_str());
+        const double tmean = std::atof(v[imean].c_str());
+        const double tsd = std::atof(v[isd].c_str());
+        base[key] = std::make_pair(tmed, tmean > 0. ? tsd/tmean : 0.);
+    }
+
+    int nregress = 0, ncompare = 0;
+    std::cout << "\nComparison to " << file << ":\n";
+    std::cout << "op       type     stor  thr       n     speedup\n";
+    for(size_t i=0;i<results.size();++i) {
+        const Result& r = results[i];
+        std::map<std::string,std::pair<double,double> >::const_iterator it =
+            base.find(r.key());
+        if (it == base.end() || it->second.first <= 0.) continue;
+        ++ncompare;
+        const double speedup = it->second.first / r.tmed;
+        const double noise = 2. * std::max(r.relsd(),it->second.second);
+        const double thresh = std::max(tol,noise);
+        std::cout << std::left << std::setw(9) << r.op << std::setw(9)
+            << r.type << std::setw(4) << r.stor << std::right
+            << std::setw(5) << r.threads << std::setw(8) << r.n
+            << std::setw(12) << std::setprecision(3) << speedup;
+        if (speedup < 1.-thresh) {
+            std::cout << "   REGRESSION";
+            ++nregress;
+        } else if (speedup > 1.+thresh) {
+            std::cout << "   faster";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::setprecision(6);
+    std::cout << ncompare << " results compared, "
+        << nregress << " regressions\n";
+    return nregress;
+}
+
+//
+// The command line
+//
+
+static void Usage()
+{
+    std::cerr <<
+        "Usage: tmvbench [-op list] [-type list] [-stor list] [-n list]\n"
+        "                [-threads list] [-reps r] [-warmup w]"
+        " [-mintime t]\n"
+        "                [-csv file] [-json file] [-baseline file]"
+        " [-tol x]\n"
+        "See the comments at the top of TMV_Bench.cpp for details.\n";
+}
+
+static bool ParseSizes(const std::string& s, std::vector<ptrdiff_t>& ns)
+{
+    const std::vector<std::string> items = Split(s,',');
+    for(size_t i=0;i<items.size();++i) {
+        const std::vector<std::string> v = Split(items[i],':');
+        const ptrdiff_t a = std::atol(v[0].c_str());
+        if (a <= 0 || v.size() > 3) return false;
+        if (v.size() == 1) { ns.push_back(a); continue; }
+        const ptrdiff_t b = std::atol(v[1].c_str());
+        if (b < a) return false;
+        if (v.size() == 3 && v[2].size() > 0 && v[2][0] != 'x') {
+            const ptrdiff_t step = std::atol(v[2].c_str());
+            if (step <= 0) return false;
+            for(ptrdiff_t n=a;n<=b;n+=step) ns.push_back(n);
+        } else {
+            const double f = v.size() == 3 ?
+                std::atof(v[2].c_str()+1) : 2.;
+            if (!(f > 1.)) return false;
+            for(double n=a;n<=b*(1.+1.e-8);n*=f)
+                ns.push_back(ptrdiff_t(n+0.5));
+        }
+    }
+    return true;
+}
+
+template <class T>
+static bool ParseList(const std::string& s, std::vector<T>& v)
+{
+    const std::vector<std::string> items = Split(s,',');
+    for(size_t i=0;i<items.size();++i) {
+        std::istringstream ss(items[i]);
+        T x;
+        if (!(ss >> x)) return false;
+        v.push_back(x);
+    }
+    return true;
+}
+
+static bool CheckList(
+    const std::vector<std::string>& v, const char* const* valid)
+{
+    for(size_t i=0;i<v.size();++i) {
+        const char* const* p = valid;
+        while (*p && v[i] != *p) ++p;
+        if (!*p) {
+            std::cerr << "Invalid value: " << v[i] << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool ParseArgs(int argc, char** argv, Options& opt)
+{
+    opt.reps = 10; opt.warmup = 2;
+    opt.mintime = 0.02; opt.tol = 0.1;
+    for(int i=1;i<argc;++i) {
+        const std::string a = argv[i];
+        if (i+1 == argc) return false;
+        const std::string v = argv[++i];
+        bool ok = true;
+        if (a == "-op") ok = ParseList(v,opt.ops);
+        else if (a == "-type") ok = ParseList(v,opt.types);
+        else if (a == "-stor") ok = ParseList(v,opt.stors);
+        else if (a == "-n") ok = ParseSizes(v,opt.ns);
+        else if (a == "-threads") ok = ParseList(v,opt.threads);
+        else if (a == "-reps") opt.reps = std::atoi(v.c_str());
+        else if (a == "-warmup") opt.warmup = std::atoi(v.c_str());
+        else if (a == "-mintime") opt.mintime = std::atof(v.c_str());
+        else if (a == "-tol") opt.tol = std::atof(v.c_str());
+        else if (a == "-csv") opt.csv = v;
+        else if (a == "-json") opt.json = v;
+        else if (a == "-baseline") opt.baseline = v;
+        else ok = false;
+        if (!ok) return false;
+    }
+    if (opt.ops.empty()) opt.ops.push_back("multmm");
+    if (opt.types.empty()) opt.types.push_back("double");
+    if (opt.stors.empty()) opt.stors.push_back("col");
+    if (opt.ns.empty()) ParseSizes("64:1024",opt.ns);
+    if (opt.threads.empty()) opt.threads.push_back(1);
+    if (opt.reps < 1 || opt.warmup < 0 || opt.mintime < 0.) return false;
+
+    static const char* const ops[] = {
+        "dot", "axpy", "multmv", "multmm", "lu", "qr", "chol", "solve", 0 };
+    static const char* const types[] = {
+        "float", "double", "cfloat", "cdouble", 0 };
+    static const char* const stors[] = { "col", "row", 0 };
+    if (!CheckList(opt.ops,ops) || !CheckList(opt.types,types) ||
+        !CheckList(opt.stors,stors)) return false;
+    for(size_t i=0;i<opt.threads.size();++i) {
+        if (opt.threads[i] < 1) return false;
+#ifndef _OPENMP
+        if (opt.threads[i] != 1) {
+            std::cerr << "Not compiled with OpenMP, so threads must be 1\n";
+            return false;
+        }
+#endif
+    }
+    return true;
+}
+
+int main(int argc, char** argv) try
+{
+    Options opt;
+    if (!ParseArgs(argc,argv,opt)) {
+        Usage();
+        return 1;
+    }
+
+    std::vector<Result> results;
+    WriteHeader(std::cout);
+    for(size_t i=0;i<opt.types.size();++i) {
+        const std::string& type = opt.types[i];
+        if (type == "float") RunType<float>(opt,type,results);
+        else if (type == "double") RunType<double>(opt,type,results);
+        else if (type == "cfloat")
+            RunType<std::complex<float> >(opt,type,results);
+        else RunType<std::complex<double> >(opt,type,results);
+    }
+
+    if (opt.csv != "") {
+        std::ofstream fout(opt.csv.c_str());
+        WriteCSV(fout,results);
+        if (!fout) std::cerr << "Unable to write " << opt.csv << std::endl;
+    }
+    if (opt.json != "") {
+        std::ofstream fout(opt.json.c_str());
+        WriteJSON(fout,results);
+        if (!fout) std::cerr << "Unable to write " << opt.json << std::endl;
+    }
+    if (opt.baseline != "") {
+        const int nregress = CompareBaseline(opt.baseline,results,opt.tol);
+        if (nregress < 0) {
+            std::cerr << "Unable to read " << opt.baseline << std::endl;
+            return 1;
+        }
+        if (nregress > 0) return 2;
+    }
+    return 0;
+}
+catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+}
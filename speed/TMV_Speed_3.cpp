@@ -595,6 +595,38 @@ static void ClearCache()
     if (Norm(Z) < 5.) exit(1);
 }
 
+// Convert the total time for nloops1 x nloops2 basic products into
+// GFlop/s (counting real operations), so builds with different kernels
+// (e.g. WITH_AVX=true vs the default SSE) can be compared directly.
+static double GFlops(double t)
+{
+    const double nflops = 2. * M * N * K * XFOUR * double(nloops1) * nloops2;
+    return t > 0. ? nflops / t / 1.e9 : 0.;
+}
+
+static const char* KernelName()
+{
+#ifdef TMV_USE_CPU_DISPATCH
+    switch (tmv::TMV_CPUArch()) {
+      case tmv::CPU_AVX512 : return "AVX-512 (run time)";
+      case tmv::CPU_AVX2 : return "AVX2/FMA (run time)";
+      default : return "SSE2 (run time)";
+    }
+#elif defined(__AVX512F__)
+    return "AVX-512";
+#elif defined(__AVX__) && defined(__FMA__)
+    return "AVX2/FMA";
+#elif defined(__AVX__)
+    return "AVX";
+#elif defined(__SSE2__)
+    return "SSE2";
+#elif defined(__SSE__)
+    return "SSE";
+#else
+    return "generic";
+#endif
+}
+
 #ifdef DOMULTMM_CCC
 static void MultMM_CCC(
     const std::vector<tmv::Matrix<T> >& A1,
@@ -3108,6 +3140,9 @@ static void MultMM_CCC(
 
     std::cout<<"E = A * C               "<<t1_reg<<"  "<<t1_small<<"  "<<t1_blas;
     std::cout<<"  "<<t1_eigen<<"  "<<t1_smalleigen<<std::endl;
+    std::cout<<"  (GFlop/s)             "<<GFlops(t1_reg)<<"  "<<GFlops(t1_small);
+    std::cout<<"  "<<GFlops(t1_blas)<<"  "<<GFlops(t1_eigen);
+    std::cout<<"  "<<GFlops(t1_smalleigen)<<std::endl;
 #ifndef BASIC_ONLY
     std::cout<<"E = -A * C              "<<t2_reg<<"  "<<t2_small<<"  "<<t2_blas;
     std::cout<<"  "<<t2_eigen<<"  "<<t2_smalleigen<<std::endl;
@@ -5179,6 +5214,9 @@ static void MultMM_RCC(
 
     std::cout<<"E = B * C               "<<t1_reg<<"  "<<t1_small<<"  "<<t1_blas;
     std::cout<<"  "<<t1_eigen<<"  "<<t1_smalleigen<<std::endl;
+    std::cout<<"  (GFlop/s)             "<<GFlops(t1_reg)<<"  "<<GFlops(t1_small);
+    std::cout<<"  "<<GFlops(t1_blas)<<"  "<<GFlops(t1_eigen);
+    std::cout<<"  "<<GFlops(t1_smalleigen)<<std::endl;
 #ifndef BASIC_ONLY
     std::cout<<"E = -B * C              "<<t2_reg<<"  "<<t2_small<<"  "<<t2_blas;
     std::cout<<"  "<<t2_eigen<<"  "<<t2_smalleigen<<std::endl;
@@ -7753,6 +7791,9 @@ static void MultMM_CRC(
 
     std::cout<<"E = A * D               "<<t1_reg<<"  "<<t1_small<<"  "<<t1_blas;
     std::cout<<"  "<<t1_eigen<<"  "<<t1_smalleigen<<std::endl;
+    std::cout<<"  (GFlop/s)             "<<GFlops(t1_reg)<<"  "<<GFlops(t1_small);
+    std::cout<<"  "<<GFlops(t1_blas)<<"  "<<GFlops(t1_eigen);
+    std::cout<<"  "<<GFlops(t1_smalleigen)<<std::endl;
 #ifndef BASIC_ONLY
     std::cout<<"E = -A * D              "<<t2_reg<<"  "<<t2_small<<"  "<<t2_blas;
     std::cout<<"  "<<t2_eigen<<"  "<<t2_smalleigen<<std::endl;
@@ -9812,6 +9853,9 @@ static void MultMM_RRC(
 
     std::cout<<"E = B * D               "<<t1_reg<<"  "<<t1_small<<"  "<<t1_blas;
     std::cout<<"  "<<t1_eigen<<"  "<<t1_smalleigen<<std::endl;
+    std::cout<<"  (GFlop/s)             "<<GFlops(t1_reg)<<"  "<<GFlops(t1_small);
+    std::cout<<"  "<<GFlops(t1_blas)<<"  "<<GFlops(t1_eigen);
+    std::cout<<"  "<<GFlops(t1_smalleigen)<<std::endl;
 #ifndef BASIC_ONLY
     std::cout<<"E = -B * D              "<<t2_reg<<"  "<<t2_small<<"  "<<t2_blas;
     std::cout<<"  "<<t2_eigen<<"  "<<t2_smalleigen<<std::endl;
@@ -9924,6 +9968,7 @@ int main() try
     std::cout<<"M,N,K = "<<M<<" , "<<N<<" , "<<K<<std::endl;
     std::cout<<"nloops = "<<nloops1<<" x "<<nloops2;
     std::cout<<" = "<<nloops1*nloops2<<std::endl;
+    std::cout<<"MultMM block kernels use "<<KernelName()<<" commands\n";
 #ifdef DOEIGENSMALL
     if (nloops2x == 0)
         std::cout<<"Matrix is too big for the stack, so no \"Eigen Known\" tests.\n";
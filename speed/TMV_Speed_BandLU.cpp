@@ -0,0 +1,244 @@
+//#define PRINTALGO_BandLU
+
+// This tests the blocked band LU decomposition (algo 21 in
+// TMV_BandLUDecompose.h) against the unblocked one (algo 11), which
+// does a rank-1 update for each column.
+//
+// It also tests the solution of A X = B for many right hand sides
+// (nrhs columns) one column at a time (algo 12 in TMV_BandLUDiv.h),
+// in column blocks (algo 22) and with the automatic selection, which
+// splits the blocks among the OpenMP threads.  And it tests the SPIKE
+// solver in TMV_BandSpike.h against the regular LU decomposition and
+// solve for a single right hand side of length Nlong.
+//
+// For each bandwidth, we time the decomposition of an N x N band matrix
+// with nlo = nhi = bandwidth using each algorithm, and with the
+// automatic selection of InlineBandLU_Decompose.  The decomposition does
+// about 2 N nlo (nlo+nhi) flops, which is used for the GFlops.
+// The error check is the relative difference of P L U from A for a
+// random vector.
+
+#include "TMV.h"
+#include "TMV_Band.h"
+#include "tmv/TMV_BandLUDecompose.h"
+#include "tmv/TMV_BandLUDiv.h"
+#include "tmv/TMV_BandSpike.h"
+
+// The matrix size:
+const int N = 4000;
+
+// The number of right hand sides for the solve:
+const int nrhs = 1000;
+
+// The size and bandwidths for the SPIKE solver:
+const int Nlong = 1000000;
+const int nspikes = 3;
+const int spikebands[nspikes] = { 2, 10, 50 };
+
+// The bandwidths to test:
+const int nbands = 8;
+const int bands[nbands] = { 8, 16, 32, 50, 100, 150, 200, 300 };
+
+// Define the type to use:
+//#define TISFLOAT
+//#define TISCOMPLEX
+
+// Set up the target number of operations for each timing
+const double targetnflops = 1.e10; // in real ops
+
+// Define whether you want to include the error checks.
+#define ERRORCHECK
+
+#include <complex>
+
+#ifdef TISFLOAT
+typedef float RT;
+#else
+typedef double RT;
+#endif
+
+#ifdef TISCOMPLEX
+typedef std::complex<RT> T;
+#define XFOUR 4
+#else
+typedef RT T;
+#define XFOUR 1
+#endif
+
+#include <sys/time.h>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+static double GetTime()
+{
+    timeval tp;
+    gettimeofday(&tp,0);
+    return tp.tv_sec + tp.tv_usec/1.e6;
+}
+
+static void Report(
+    const char* name, double t, double nflops, double t0)
+{
+    std::cout<<name<<std::setw(10)<<t<<"  ";
+    std::cout<<std::setw(8)<<nflops/t*1.e-9;
+    if (t0 > 0.) std::cout<<"  speedup = "<<t0/t;
+}
+
+typedef tmv::BandMatrix<T> BM;
+typedef tmv::BandMatrixView<T> BMV;
+const ptrdiff_t xx = tmv::Unknown;
+
+// Apply P L U from the decomposition in A to x.
+static tmv::Vector<T> ApplyPLU(
+    const BM& A, const std::vector<ptrdiff_t>& P, const tmv::Vector<T>& x)
+{
+    const ptrdiff_t lo = A.nlo();
+    const ptrdiff_t hi = A.nhi();
+    tmv::Vector<T> y(N,T(0));
+    for(ptrdiff_t i=0;i<N;++i)
+        for(ptrdiff_t j=i;j<=std::min<ptrdiff_t>(N-1,i+hi);++j) y(i) += A(i,j)*x(j);
+    for(ptrdiff_t j=N-2;j>=0;--j) {
+        for(ptrdiff_t i=j+1;i<=std::min<ptrdiff_t>(N-1,j+lo);++i) y(i) += A(i,j)*y(j);
+        std::swap(y(j),y(P[j]));
+    }
+    return y;
+}
+
+template <int algo>
+static double TimeIt(
+    const char* name, const BM& A0, BM& A1, std::vector<ptrdiff_t>& P,
+    int nloops, double nflops, double t0)
+{
+    BMV A1v = A1.view();
+    A1 = A0;
+    tmv::BandLUDecompose_Helper<algo,xx,xx,BMV>::call(A1v,&P[0]); // warm up
+    double t = 0.;
+    for(int n=0; n<nloops; ++n) {
+        A1 = A0;
+        double t1 = GetTime();
+        if (algo == 0) tmv::InlineBandLU_Decompose(A1,&P[0]);
+        else tmv::BandLUDecompose_Helper<algo,xx,xx,BMV>::call(A1v,&P[0]);
+        t += GetTime() - t1;
+    }
+    t /= nloops;
+    Report(name,t,nflops,t0);
+#ifdef ERRORCHECK
+    tmv::Vector<T> x(N);
+    for(int i=0;i<N;++i) x(i) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+    tmv::Vector<T> y = ApplyPLU(A1,P,x);
+    std::cout<<"   error = "<<Norm(y-A0*x)/Norm(A0*x);
+#endif
+    std::cout<<std::endl;
+    return t;
+}
+
+template <int algo>
+static double TimeSolve(
+    const char* name, const BM& A0, const BM& A1, const tmv::Permutation& P,
+    const tmv::Matrix<T>& B0, double nflops, double t0)
+{
+    typedef tmv::ConstBandMatrixView<T> CBMV;
+    typedef tmv::MatrixView<T> MV;
+    tmv::Matrix<T> B = B0;
+    MV Bv = B.view();
+    CBMV A1v = A1.view();
+    double t1 = GetTime();
+    if (algo == 0) tmv::InlineBandLU_SolveInPlace(A1,P,B);
+    else tmv::BandLU_Solve_Helper<algo,false,xx,xx,CBMV,MV>::call(A1v,P,Bv);
+    double t = GetTime() - t1;
+    Report(name,t,nflops,t0);
+#ifdef ERRORCHECK
+    std::cout<<"   error = "<<Norm(A0*B-B0)/Norm(B0);
+#endif
+    std::cout<<std::endl;
+    return t;
+}
+
+static void TestBand(const int nb)
+{
+    // The storage needs nlo+nhi superdiagonals for the fill.
+    BM A0(N,N,nb,2*nb,T(0));
+    std::srand(1234);
+    for(int i=0;i<N;++i)
+        for(int j=std::max(0,i-nb);j<=std::min<ptrdiff_t>(N-1,i+nb);++j)
+            A0(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+    BM A1 = A0;
+    std::vector<ptrdiff_t> P(N);
+
+    const double nflops = 2. * N * nb * (2*nb) * XFOUR;
+    const int nloops = int(targetnflops / nflops / 10) + 1;
+
+    std::cout<<"N = "<<N<<"  nlo = nhi = "<<nb<<"   ("<<nloops<<" loops)\n";
+    std::cout<<"Decompose          time    GFlops\n";
+    const double t11 = TimeIt<11>("Unblocked      ",A0,A1,P,nloops,nflops,0.);
+    if (nb >= TMV_BANDLU_BLOCKSIZE)
+        TimeIt<21>("Blocked        ",A0,A1,P,nloops,nflops,t11);
+    TimeIt<0>("Automatic      ",A0,A1,P,nloops,nflops,t11);
+    std::cout<<std::endl;
+
+    // The solve uses the decomposition in A1.
+    tmv::Permutation PP(N,&P[0]);
+    tmv::Matrix<T> B0(N,nrhs);
+    for(int i=0;i<N;++i) for(int j=0;j<nrhs;++j)
+        B0(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+    const double nflops2 = 2. * N * nrhs * (3*nb+1) * XFOUR;
+    std::cout<<"Solve (nrhs = "<<nrhs<<")\n";
+    const double t12 = TimeSolve<12>("Column by col  ",A0,A1,PP,B0,nflops2,0.);
+    TimeSolve<22>("Column blocks  ",A0,A1,PP,B0,nflops2,t12);
+    TimeSolve<0>("Automatic      ",A0,A1,PP,B0,nflops2,t12);
+    std::cout<<std::endl;
+}
+
+static void TestSpike(const int nb)
+{
+    BM A0(Nlong,Nlong,nb,nb,T(0));
+    std::srand(1234);
+    for(int i=0;i<Nlong;++i) {
+        for(int j=std::max(0,i-nb);j<=std::min(Nlong-1,i+nb);++j)
+            A0(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+        A0(i,i) += T(2*nb);
+    }
+    tmv::Vector<T> x(Nlong);
+    for(int i=0;i<Nlong;++i) x(i) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+    tmv::Vector<T> b = A0*x;
+
+    std::cout<<"N = "<<Nlong<<"  nlo = nhi = "<<nb<<"  single rhs\n";
+    std::cout<<"Solve              time\n";
+    // The regular decomposition and solve.
+    double t1 = GetTime();
+    BM A1(Nlong,Nlong,nb,2*nb,T(0));
+    A1.cSubBandMatrix(0,Nlong,0,Nlong,nb,nb) = A0;
+    std::vector<ptrdiff_t> P(Nlong);
+    tmv::InlineBandLU_Decompose(A1,&P[0]);
+    tmv::Vector<T> b1 = b;
+    tmv::InlineBandLU_SolveInPlace(A1,tmv::Permutation(Nlong,&P[0]),b1);
+    const double tlu = GetTime() - t1;
+    std::cout<<"LU             "<<std::setw(10)<<tlu;
+#ifdef ERRORCHECK
+    std::cout<<"   error = "<<Norm(b1-x)/Norm(x);
+#endif
+    std::cout<<std::endl;
+
+    t1 = GetTime();
+    tmv::Vector<T> b2 = b;
+    tmv::BandSpike_SolveInPlace(A0,b2);
+    const double tsp = GetTime() - t1;
+    std::cout<<"SPIKE          "<<std::setw(10)<<tsp<<"  speedup = "<<tlu/tsp;
+#ifdef ERRORCHECK
+    std::cout<<"   error = "<<Norm(b2-x)/Norm(x);
+#endif
+    std::cout<<std::endl<<std::endl;
+}
+
+int main() try
+{
+    for(int k=0; k<nbands; ++k) TestBand(bands[k]);
+    for(int k=0; k<nspikes; ++k) TestSpike(spikebands[k]);
+    return 0;
+}
+catch (std::exception& e) {
+    std::cerr<<e.what()<<std::endl;
+    return 1;
+}
@@ -0,0 +1,176 @@
+// This tests the block tridiagonal solvers in TMV_BlockTridiagMatrix.h:
+// the block Thomas algorithm (BlockTridiag_Decompose followed by
+// BlockTridiag_SolveInPlace) and block cyclic reduction
+// (BlockTridiag_SolveCR).  For comparison, it also does the same solve
+// with the matrix stored as a BandMatrix with nlo = nhi = 2bs-1 and
+// the regular band LU decomposition.
+//
+// For each block size, we time the solution of A X = B for an
+// n x n block matrix with nrhs right hand sides.  The times include
+// the decomposition.  The error check is the relative difference of
+// A X from B.
+
+#include "TMV.h"
+#include "TMV_Band.h"
+#include "tmv/TMV_BandLUDecompose.h"
+#include "tmv/TMV_BandLUDiv.h"
+#include "tmv/TMV_BlockTridiagMatrix.h"
+
+// The number of blocks:
+const int nblocks = 2000;
+
+// The number of right hand sides:
+const int nrhs = 4;
+
+// The block sizes to test:
+const int nsizes = 6;
+const int sizes[nsizes] = { 2, 4, 8, 16, 32, 64 };
+
+// Define the type to use:
+//#define TISFLOAT
+//#define TISCOMPLEX
+
+// Set up the target number of operations for each timing
+const double targetnflops = 1.e10; // in real ops
+
+// Define whether you want to include the error checks.
+#define ERRORCHECK
+
+#include <complex>
+
+#ifdef TISFLOAT
+typedef float RT;
+#else
+typedef double RT;
+#endif
+
+#ifdef TISCOMPLEX
+typedef std::complex<RT> T;
+#define XFOUR 4
+#else
+typedef RT T;
+#define XFOUR 1
+#endif
+
+#include <sys/time.h>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+static double GetTime()
+{
+    timeval tp;
+    gettimeofday(&tp,0);
+    return tp.tv_sec + tp.tv_usec/1.e6;
+}
+
+static void Report(const char* name, double t, double t0)
+{
+    std::cout<<name<<std::setw(10)<<t;
+    if (t0 > 0.) std::cout<<"  speedup = "<<t0/t;
+}
+
+typedef tmv::BlockTridiagMatrix<T> BTM;
+typedef tmv::BandMatrix<T> BM;
+
+static void CheckError(const BTM& A0, const tmv::Matrix<T>& X,
+                       const tmv::Matrix<T>& B0)
+{
+#ifdef ERRORCHECK
+    tmv::Matrix<T> B(B0.colsize(),B0.rowsize());
+    tmv::BlockTridiag_MultMM(A0,X,B);
+    std::cout<<"   error = "<<Norm(B-B0)/Norm(B0);
+#endif
+    std::cout<<std::endl;
+}
+
+static void TestBlockSize(const int bs)
+{
+    const int N = nblocks*bs;
+    // Block diagonally dominant, so no pivoting between blocks is needed.
+    BTM A0(nblocks,bs);
+    std::srand(1234);
+    for(int k=0;k<nblocks;++k) {
+        for(int i=0;i<bs;++i) for(int j=0;j<bs;++j) {
+            A0.diag(k)(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+            if (k < nblocks-1) {
+                A0.lower(k)(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+                A0.upper(k)(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+            }
+        }
+        for(int i=0;i<bs;++i) A0.diag(k)(i,i) += T(3*bs);
+    }
+    tmv::Matrix<T> B0(N,nrhs);
+    for(int i=0;i<N;++i) for(int j=0;j<nrhs;++j)
+        B0(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+
+    // The Thomas algorithm does about (14/3) bs^3 flops per block.
+    const double nflops = 14./3. * nblocks * bs * bs * bs * XFOUR;
+    const int nloops = int(targetnflops / nflops / 10) + 1;
+
+    std::cout<<"n = "<<nblocks<<"  bs = "<<bs<<"  nrhs = "<<nrhs;
+    std::cout<<"   ("<<nloops<<" loops)\n";
+    std::cout<<"Solve              time\n";
+
+    // Band LU
+    BM A2(N,N,2*bs-1,4*bs-2,T(0));
+    std::vector<ptrdiff_t> P2(N);
+    tmv::Matrix<T> X2(N,nrhs);
+    double t = 0.;
+    for(int n=0; n<nloops; ++n) {
+        double t1 = GetTime();
+        for(int i=0;i<N;++i) {
+            const int j1 = std::max(0,(i/bs-1)*bs);
+            const int j2 = std::min(N,(i/bs+2)*bs);
+            for(int j=j1;j<j2;++j) A2(i,j) = A0(i,j);
+        }
+        tmv::InlineBandLU_Decompose(A2,&P2[0]);
+        X2 = B0;
+        tmv::InlineBandLU_SolveInPlace(A2,tmv::Permutation(N,&P2[0]),X2);
+        t += GetTime() - t1;
+    }
+    const double tband = t / nloops;
+    Report("Band LU        ",tband,0.);
+    CheckError(A0,X2,B0);
+
+    // Block Thomas
+    BTM A1 = A0;
+    std::vector<ptrdiff_t> P1(N);
+    tmv::Matrix<T> X1(N,nrhs);
+    t = 0.;
+    for(int n=0; n<nloops; ++n) {
+        A1 = A0;
+        X1 = B0;
+        double t1 = GetTime();
+        tmv::BlockTridiag_Decompose(A1,&P1[0]);
+        tmv::BlockTridiag_SolveInPlace(A1,&P1[0],X1);
+        t += GetTime() - t1;
+    }
+    const double tthomas = t / nloops;
+    Report("Block Thomas   ",tthomas,tband);
+    CheckError(A0,X1,B0);
+
+    // Block cyclic reduction
+    tmv::Matrix<T> X3(N,nrhs);
+    t = 0.;
+    for(int n=0; n<nloops; ++n) {
+        X3 = B0;
+        double t1 = GetTime();
+        tmv::BlockTridiag_SolveCR(A0,X3);
+        t += GetTime() - t1;
+    }
+    Report("Cyclic reduct  ",t/nloops,tband);
+    CheckError(A0,X3,B0);
+    std::cout<<std::endl;
+}
+
+int main() try
+{
+    for(int k=0; k<nsizes; ++k) TestBlockSize(sizes[k]);
+    return 0;
+}
+catch (std::exception& e) {
+    std::cerr<<e.what()<<std::endl;
+    return 1;
+}
@@ -0,0 +1,167 @@
+//#define PRINTALGO_CH
+//#define PRINTALGO_LDL
+
+// This tests the Cholesky and LDL decompositions against LU for
+// solving a symmetric (hermitian) positive definite system.
+//
+// For each N, we time the decomposition A = P L U, A = L L^H and
+// A = P L D L^H P^T of the same SPD matrix, and then the solution
+// of A X = B using each decomposition, where B is N x K.
+// Cholesky does N^3/3 flops for the decomposition, LDL does about the
+// same, and LU does 2N^3/3, so the reported GFlops use the LU count
+// to give an effective rate for all three.
+
+#include "TMV.h"
+
+// The sizes to test:
+const int nsizes = 4;
+const int Ns[nsizes] = { 250, 500, 1000, 2000 };
+const int K = 10;
+
+// Define the type to use:
+//#define TISFLOAT
+//#define TISCOMPLEX
+
+// Set up the target number of operations for each timing
+const double targetnflops = 1.e10; // in real ops
+
+// Define whether you want to include the error checks.
+#define ERRORCHECK
+
+#include <complex>
+
+#ifdef TISFLOAT
+typedef float RT;
+#else
+typedef double RT;
+#endif
+
+#ifdef TISCOMPLEX
+typedef std::complex<RT> T;
+#define XFOUR 4
+#else
+typedef RT T;
+#define XFOUR 1
+#endif
+
+#include <sys/time.h>
+#include <iostream>
+#include <iomanip>
+
+static double GetTime()
+{
+    timeval tp;
+    gettimeofday(&tp,0);
+    return tp.tv_sec + tp.tv_usec/1.e6;
+}
+
+static void Report(
+    const char* name, double t, double nflops, double t0)
+{
+    std::cout<<name<<std::setw(10)<<t<<"  ";
+    std::cout<<std::setw(8)<<nflops/t*1.e-9;
+    if (t0 > 0.) std::cout<<"  speedup = "<<t0/t;
+}
+
+static void TestSize(const int N)
+{
+    tmv::Matrix<T> A0(N,N);
+    tmv::Matrix<T> B(N,K);
+    std::srand(1234);
+    for(int i=0;i<N;++i) for(int j=0;j<N;++j)
+        A0(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+    for(int i=0;i<N;++i) for(int j=0;j<K;++j)
+        B(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+
+    // Make A positive definite.
+    tmv::Matrix<T> A = A0 * A0.adjoint();
+    A.diag().addToAll(T(N));
+
+    tmv::Matrix<T> A1(N,N);
+    tmv::Matrix<T> X0(N,K);
+    tmv::Matrix<T> X1(N,K);
+
+    const double nflopsd = 2./3. * N * N * N * XFOUR;
+    const int nloopsd = int(targetnflops / nflopsd) + 1;
+
+    std::cout<<"N = "<<N<<"   ("<<nloopsd<<" loops)\n";
+    std::cout<<"Decompose          time    GFlops\n";
+
+    A1 = A;
+    A1.saveDiv();
+    A1.divideUsing(tmv::LU);
+    A1.setDiv();  // warm up
+    double t0 = GetTime();
+    for(int n=0; n<nloopsd; ++n) { A1.resetDiv(); A1.setDiv(); }
+    const double tlu = (GetTime() - t0) / nloopsd;
+    Report("LU             ",tlu,nflopsd,0.);
+    std::cout<<std::endl;
+    X0 = B / A1;
+
+    A1.divideUsing(tmv::CH);
+    A1.setDiv();
+    t0 = GetTime();
+    for(int n=0; n<nloopsd; ++n) { A1.resetDiv(); A1.setDiv(); }
+    double t = (GetTime() - t0) / nloopsd;
+    Report("CH             ",t,nflopsd,tlu);
+    std::cout<<std::endl;
+
+    A1.divideUsing(tmv::LDL);
+    A1.setDiv();
+    t0 = GetTime();
+    for(int n=0; n<nloopsd; ++n) { A1.resetDiv(); A1.setDiv(); }
+    t = (GetTime() - t0) / nloopsd;
+    Report("LDL            ",t,nflopsd,tlu);
+    std::cout<<std::endl;
+
+    const double nflopss = 2. * N * N * K * XFOUR;
+    const int nloopss = int(targetnflops / nflopss) + 1;
+
+    std::cout<<"Solve A X = B      time    GFlops   ("<<nloopss<<" loops)\n";
+
+    A1.divideUsing(tmv::LU);
+    A1.setDiv();
+    X0 = B / A1;
+    t0 = GetTime();
+    for(int n=0; n<nloopss; ++n) X0 = B / A1;
+    const double tslu = (GetTime() - t0) / nloopss;
+    Report("LU             ",tslu,nflopss,0.);
+#ifdef ERRORCHECK
+    std::cout<<"   resid = "<<Norm(A*X0-B)/(Norm(A)*Norm(X0));
+#endif
+    std::cout<<std::endl;
+
+    A1.divideUsing(tmv::CH);
+    A1.setDiv();
+    X1 = B / A1;
+    t0 = GetTime();
+    for(int n=0; n<nloopss; ++n) X1 = B / A1;
+    t = (GetTime() - t0) / nloopss;
+    Report("CH             ",t,nflopss,tslu);
+#ifdef ERRORCHECK
+    std::cout<<"   diff = "<<Norm(X1-X0)/Norm(X0);
+#endif
+    std::cout<<std::endl;
+
+    A1.divideUsing(tmv::LDL);
+    A1.setDiv();
+    X1 = B / A1;
+    t0 = GetTime();
+    for(int n=0; n<nloopss; ++n) X1 = B / A1;
+    t = (GetTime() - t0) / nloopss;
+    Report("LDL            ",t,nflopss,tslu);
+#ifdef ERRORCHECK
+    std::cout<<"   diff = "<<Norm(X1-X0)/Norm(X0);
+#endif
+    std::cout<<std::endl<<std::endl;
+}
+
+int main() try
+{
+    for(int i=0; i<nsizes; ++i) TestSize(Ns[i]);
+    return 0;
+}
+catch (std::exception& e) {
+    std::cerr<<e.what()<<std::endl;
+    return 1;
+}
@@ -0,0 +1,153 @@
+//#define PRINTALGO_EIGEN
+
+// This tests the symmetric eigensolver against the SVD, which is the
+// other way to get the eigenvalues of a symmetric matrix.
+//
+// For each N, we time:
+// - Eigen_Decompose: all eigenvalues and eigenvectors
+// - Eigen_Values: the eigenvalues alone
+// - Eigen_DecomposeLargest: the K largest eigenvalues and eigenvectors
+// - SV_Decompose: the singular value decomposition of the same matrix
+//
+// The reported GFlops use the nominal 4/3 N^3 flops of the
+// tridiagonalization for all of them, so they are just an effective
+// rate relative to the tridiagonalization.
+
+#include "TMV.h"
+
+// The sizes to test:
+const int nsizes = 4;
+const int Ns[nsizes] = { 250, 500, 1000, 2000 };
+const int K = 10;
+
+// Define the type to use:
+//#define TISFLOAT
+//#define TISCOMPLEX
+
+// Set up the target number of operations for each timing
+const double targetnflops = 1.e10; // in real ops
+
+// Define whether you want to include the error checks.
+#define ERRORCHECK
+
+#include <complex>
+
+#ifdef TISFLOAT
+typedef float RT;
+#else
+typedef double RT;
+#endif
+
+#ifdef TISCOMPLEX
+typedef std::complex<RT> T;
+#define XFOUR 4
+#else
+typedef RT T;
+#define XFOUR 1
+#endif
+
+#include <sys/time.h>
+#include <iostream>
+#include <iomanip>
+
+static double GetTime()
+{
+    timeval tp;
+    gettimeofday(&tp,0);
+    return tp.tv_sec + tp.tv_usec/1.e6;
+}
+
+static void Report(
+    const char* name, double t, double nflops, double t0)
+{
+    std::cout<<name<<std::setw(10)<<t<<"  ";
+    std::cout<<std::setw(8)<<nflops/t*1.e-9;
+    if (t0 > 0.) std::cout<<"  speedup = "<<t0/t;
+}
+
+static void TestSize(const int N)
+{
+    tmv::Matrix<T> A0(N,N);
+    std::srand(1234);
+    for(int i=0;i<N;++i) for(int j=0;j<N;++j)
+        A0(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+
+    // Make A hermitian.  (e.g. a covariance matrix)
+    tmv::Matrix<T> A = A0 * A0.adjoint();
+
+    tmv::Matrix<T> Z(N,N);
+    tmv::Vector<RT> lambda(N);
+    tmv::Matrix<T> Zk(N,K);
+    tmv::Vector<RT> lambdak(K);
+    tmv::Matrix<T> U(N,N);
+    tmv::DiagMatrix<RT> S(N);
+    tmv::Matrix<T> V(N,N);
+
+    const double nflops = 4./3. * N * N * N * XFOUR;
+    const int nloops = int(targetnflops / nflops) + 1;
+
+    std::cout<<"N = "<<N<<"   ("<<nloops<<" loops)\n";
+    std::cout<<"                     time    GFlops\n";
+
+    double t0 = GetTime();
+    for(int n=0; n<nloops; ++n) {
+        U = A;
+        tmv::SV_Decompose(U,S,V);
+    }
+    const double tsvd = (GetTime() - t0) / nloops;
+    Report("SV_Decompose    ",tsvd,nflops,0.);
+    std::cout<<std::endl;
+
+    t0 = GetTime();
+    for(int n=0; n<nloops; ++n) {
+        Z = A;
+        tmv::Eigen_Decompose(Z,lambda);
+    }
+    double t = (GetTime() - t0) / nloops;
+    Report("Eigen_Decompose ",t,nflops,tsvd);
+#ifdef ERRORCHECK
+    tmv::Matrix<T> L(N,N,T(0));
+    L.diag() = lambda;
+    std::cout<<"   resid = "<<Norm(A*Z-Z*L)/Norm(A);
+    std::cout<<"   diff = "<<Norm(lambda.reverse()-S.diag())/Norm(S.diag());
+#endif
+    std::cout<<std::endl;
+
+    t0 = GetTime();
+    for(int n=0; n<nloops; ++n) {
+        Z = A;
+        tmv::Eigen_Values(Z,lambda);
+    }
+    t = (GetTime() - t0) / nloops;
+    Report("Eigen_Values    ",t,nflops,tsvd);
+#ifdef ERRORCHECK
+    std::cout<<"   diff = "<<Norm(lambda.reverse()-S.diag())/Norm(S.diag());
+#endif
+    std::cout<<std::endl;
+
+    t0 = GetTime();
+    for(int n=0; n<nloops; ++n) {
+        Z = A;
+        tmv::Eigen_DecomposeLargest(Z,Zk,lambdak);
+    }
+    t = (GetTime() - t0) / nloops;
+    Report("Largest K       ",t,nflops,tsvd);
+#ifdef ERRORCHECK
+    tmv::Matrix<T> Lk(K,K,T(0));
+    Lk.diag() = lambdak;
+    std::cout<<"   resid = "<<Norm(A*Zk-Zk*Lk)/Norm(A);
+    std::cout<<"   diff = "<<
+        Norm(lambdak-S.diag().subVector(0,K))/Norm(S.diag().subVector(0,K));
+#endif
+    std::cout<<std::endl<<std::endl;
+}
+
+int main() try
+{
+    for(int i=0; i<nsizes; ++i) TestSize(Ns[i]);
+    return 0;
+}
+catch (std::exception& e) {
+    std::cerr<<e.what()<<std::endl;
+    return 1;
+}
@@ -0,0 +1,155 @@
+//#define PRINTALGO_MM
+
+// This tests the effect of putting the matrices in 2 MB pages (rather 
+// than the usual 4 KB pages) on the speed of a large matrix product.
+// For each size N, we time C = A*B with the default allocator, and then
+// with an allocator (see SetAllocator in TMV_Array.h) that gives every 
+// allocation of at least 2 MB its own huge pages.  This includes the 
+// temporary storage used inside the product.  Both are done with 
+// 64 byte alignment (see SetAlignment).
+//
+// The huge page allocator first tries mmap with MAP_HUGETLB, which needs
+// huge pages to be reserved by the system (e.g. in 
+// /proc/sys/vm/nr_hugepages).  If that fails, it uses a normal mmap and 
+// asks for transparent huge pages with madvise.  The number of 
+// allocations that got each kind is printed after each timing.
+//
+// This only works on Linux.
+
+#include "TMV.h"
+
+// The sizes to test:
+const int nsizes = 4;
+const int Ns[nsizes] = { 500, 1000, 2000, 4000 };
+
+// Define the type to use:
+//#define TISFLOAT
+//#define TISCOMPLEX
+
+// Set up the target number of operations for each timing
+const double targetnflops = 1.e10; // in real ops
+
+// Define whether you want to include the error checks.
+#define ERRORCHECK
+
+#include <complex>
+
+#ifdef TISFLOAT
+typedef float RT;
+#else
+typedef double RT;
+#endif
+
+#ifdef TISCOMPLEX
+typedef std::complex<RT> T;
+#define XFOUR 4
+#else
+typedef RT T;
+#define XFOUR 1
+#endif
+
+#include <sys/time.h>
+#include <sys/mman.h>
+#include <iostream>
+#include <iomanip>
+
+static double GetTime()
+{
+    timeval tp;
+    gettimeofday(&tp,0);
+    return tp.tv_sec + tp.tv_usec/1.e6;
+}
+
+const size_t hugepage = 1<<21;
+static int nhugetlb = 0;
+static int nthp = 0;
+
+static size_t HugeSize(size_t nbytes)
+{ return (nbytes + hugepage-1) & ~(hugepage-1); }
+
+static void* HugeAllocate(size_t nbytes, size_t align)
+{
+    if (nbytes < hugepage) 
+        return tmv::AllocationPolicy::defaultAllocate(nbytes,align);
+    const size_t n = HugeSize(nbytes);
+#ifdef MAP_HUGETLB
+    void* p = mmap(0,n,PROT_READ|PROT_WRITE,
+                   MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB,-1,0);
+    if (p != MAP_FAILED) { ++nhugetlb; return p; }
+#endif
+    p = mmap(0,n,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+    if (p == MAP_FAILED) return 0;
+#ifdef MADV_HUGEPAGE
+    madvise(p,n,MADV_HUGEPAGE);
+#endif
+    ++nthp;
+    return p;
+}
+
+static void HugeDeallocate(void* p, size_t nbytes)
+{
+    if (nbytes < hugepage) 
+        tmv::AllocationPolicy::defaultDeallocate(p,nbytes);
+    else 
+        munmap(p,HugeSize(nbytes));
+}
+
+static double TimeMM(const int N, const int nloops, tmv::Matrix<T>& C)
+{
+    tmv::Matrix<T> A(N,N);
+    tmv::Matrix<T> B(N,N);
+    std::srand(1234);
+    for(int i=0;i<N;++i) for(int j=0;j<N;++j)
+        A(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+    for(int i=0;i<N;++i) for(int j=0;j<N;++j)
+        B(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+    tmv::Matrix<T> C1(N,N);
+
+    C1 = A*B;  // warm up
+    const double t0 = GetTime();
+    for(int n=0; n<nloops; ++n) C1 = A*B;
+    const double t = (GetTime() - t0) / nloops;
+    C = C1;
+    return t;
+}
+
+static void TestSize(const int N)
+{
+    const double nflops = 2. * N * N * N * XFOUR;
+    const int nloops = int(targetnflops / nflops) + 1;
+    tmv::Matrix<T> C0(N,N);
+    tmv::Matrix<T> C1(N,N);
+
+    std::cout<<"N = "<<N<<"   ("<<nloops<<" loops)\n";
+    std::cout<<"pages        time    GFlops\n";
+
+    tmv::SetAllocator(0,0);
+    double t = TimeMM(N,nloops,C0);
+    std::cout<<"4 KB   "<<std::setw(10)<<t<<"  ";
+    std::cout<<std::setw(8)<<nflops/t*1.e-9<<std::endl;
+    const double t1 = t;
+
+    nhugetlb = nthp = 0;
+    tmv::SetAllocator(&HugeAllocate,&HugeDeallocate);
+    t = TimeMM(N,nloops,C1);
+    tmv::SetAllocator(0,0);
+    std::cout<<"2 MB   "<<std::setw(10)<<t<<"  ";
+    std::cout<<std::setw(8)<<nflops/t*1.e-9<<"  ";
+    std::cout<<"speedup = "<<t1/t;
+    std::cout<<"   (hugetlb: "<<nhugetlb<<", thp: "<<nthp<<")";
+#ifdef ERRORCHECK
+    std::cout<<"   diff = "<<Norm(C1-C0)/Norm(C0);
+#endif
+    std::cout<<std::endl<<std::endl;
+}
+
+int main() try
+{
+    tmv::SetAlignment(64);
+    for(int i=0; i<nsizes; ++i) TestSize(Ns[i]);
+    return 0;
+}
+catch (std::exception& e) {
+    std::cerr<<e.what()<<std::endl;
+    return 1;
+}
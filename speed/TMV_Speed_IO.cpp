@@ -0,0 +1,162 @@
+
+// This tests the speed of writing and reading a matrix to a file in the
+// text format (operator<< and operator>>), in the text format with
+// the fast IO style (IOStyle::fast()), and in the binary format
+// (WriteBinary, ReadBinary and MappedBinaryFile in TMV_BinaryIO.h).
+//
+// For each N, we time:
+// - Writing an N x N matrix with os << m, os << FastIO() << m and with 
+//   WriteBinary.
+// - Reading it back with is >> m, is >> FastIO() >> m and with ReadBinary.
+// - Mapping the binary file with MappedBinaryFile and computing the
+//   sum of the elements of the view, so every page is actually read.
+//
+// The rates are given in MB/s of matrix data (N*N*sizeof(T)), not of the
+// file size, which is larger for the text format.  Note that the files
+// are probably still in the operating system's cache when they are read,
+// so the binary times are closer to the memory bandwidth than to the
+// disk bandwidth.
+
+#include "TMV.h"
+#include "TMV_Binary.h"
+
+// The sizes to test:
+const int nsizes = 3;
+const int Ns[nsizes] = { 500, 1000, 2000 };
+
+// Define the type to use:
+//#define TISFLOAT
+//#define TISCOMPLEX
+
+// The text format is slow, so only do it for N up to this size.
+const int maxtext = 1000;
+
+// The files to use
+const char* textfile = "tmvspeedio.txt";
+const char* fasttextfile = "tmvspeedio_fast.txt";
+const char* binfile = "tmvspeedio.bin";
+
+#include <complex>
+
+#ifdef TISFLOAT
+typedef float RT;
+#else
+typedef double RT;
+#endif
+
+#ifdef TISCOMPLEX
+typedef std::complex<RT> T;
+#else
+typedef RT T;
+#endif
+
+#include <sys/time.h>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <cstdio>
+
+static double GetTime()
+{
+    timeval tp;
+    gettimeofday(&tp,0);
+    return tp.tv_sec + tp.tv_usec/1.e6;
+}
+
+static void Report(const char* name, double t, double mb, double t0)
+{
+    std::cout<<name<<std::setw(10)<<t<<"  "<<std::setw(10)<<mb/t;
+    if (t0 > 0.) std::cout<<"  speedup = "<<t0/t;
+    std::cout<<std::endl;
+}
+
+static void TestSize(const int N)
+{
+    tmv::Matrix<T> A(N,N);
+    std::srand(1234);
+    for(int i=0;i<N;++i) for(int j=0;j<N;++j)
+        A(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+    tmv::Matrix<T> B(N,N);
+    const double mb = double(N)*N*sizeof(T) / (1024.*1024.);
+
+    std::cout<<"N = "<<N<<"   ("<<mb<<" MB)\n";
+    std::cout<<"                   time        MB/s\n";
+
+    double twt = 0., trt = 0.;
+    if (N <= maxtext) {
+        double t0 = GetTime();
+        {
+            std::ofstream fout(textfile);
+            fout.precision(17);
+            fout << A;
+        }
+        twt = GetTime() - t0;
+        Report("Write text     ",twt,mb,0.);
+
+        t0 = GetTime();
+        {
+            std::ofstream fout(fasttextfile);
+            fout << tmv::FastIO() << A;
+        }
+        double t = GetTime() - t0;
+        Report("Write fast text",t,mb,twt);
+    }
+
+    double t0 = GetTime();
+    tmv::WriteBinary(binfile,A);
+    double t = GetTime() - t0;
+    Report("Write binary   ",t,mb,twt);
+
+    if (N <= maxtext) {
+        t0 = GetTime();
+        {
+            std::ifstream fin(textfile);
+            fin >> B;
+        }
+        trt = GetTime() - t0;
+        Report("Read text      ",trt,mb,0.);
+
+        t0 = GetTime();
+        {
+            std::ifstream fin(fasttextfile);
+            fin >> tmv::FastIO() >> B;
+        }
+        t = GetTime() - t0;
+        Report("Read fast text ",t,mb,trt);
+        if (Norm(B-A) != 0.)
+            std::cout<<"Error: fast text read gave a different matrix\n";
+    }
+
+    t0 = GetTime();
+    tmv::ReadBinary(binfile,B);
+    t = GetTime() - t0;
+    Report("Read binary    ",t,mb,trt);
+    if (Norm(B-A) != 0.)
+        std::cout<<"Error: ReadBinary gave a different matrix\n";
+
+    t0 = GetTime();
+    T sum(0);
+    {
+        tmv::MappedBinaryFile f(binfile);
+        sum = SumElements(f.matrixView<T>());
+    }
+    t = GetTime() - t0;
+    Report("Map and sum    ",t,mb,trt);
+    if (std::abs(sum - SumElements(A)) > 1.e-6 * N)
+        std::cout<<"Error: MappedBinaryFile gave a different matrix\n";
+
+    std::remove(textfile);
+    std::remove(fasttextfile);
+    std::remove(binfile);
+    std::cout<<std::endl;
+}
+
+int main() try
+{
+    for(int k=0;k<nsizes;++k) TestSize(Ns[k]);
+    return 0;
+}
+catch (std::exception& e) {
+    std::cerr<<e.what()<<std::endl;
+    return 1;
+}
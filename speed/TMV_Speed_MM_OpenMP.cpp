@@ -0,0 +1,120 @@
+//#define PRINTALGO_MM
+
+// This tests the strong scaling of the OpenMP matrix product (algo 69 in
+// TMV_MultMM.h).  For each shape, we do the same product with 1, 2, ...
+// up to MAXTHREADS threads, and print the time, GFlops, speedup and
+// parallel efficiency relative to one thread.
+//
+// The shapes include a square product along with tall-skinny,
+// short-wide, and small M x N with a long K, which are the cases where
+// the old row/column strip splitting had trouble.
+//
+// This needs to be compiled with -fopenmp (or the equivalent).
+
+#define TMV_NO_LIB
+#include "TMV.h"
+
+// The shapes to test:
+const int nshapes = 5;
+const int Ms[nshapes] = { 2000, 20000,  200,  128,  500 };
+const int Ns[nshapes] = { 2000,   200, 20000, 128,  500 };
+const int Ks[nshapes] = { 2000,   500,  500, 50000, 500 };
+
+// The maximum number of threads to use.
+// 0 means use omp_get_num_procs().
+const int MAXTHREADS = 0;
+
+// Define the type to use:
+//#define TISFLOAT
+//#define TISCOMPLEX
+
+// Set up the target number of operations for each timing
+const double targetnflops = 1.e10; // in real ops
+
+// Define whether you want to include the error checks.
+#define ERRORCHECK
+
+#include <complex>
+
+#ifdef TISFLOAT
+typedef float RT;
+#else
+typedef double RT;
+#endif
+
+#ifdef TISCOMPLEX
+typedef std::complex<RT> T;
+#define XFOUR 4
+#else
+typedef RT T;
+#define XFOUR 1
+#endif
+
+#include <sys/time.h>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <omp.h>
+
+static double GetTime()
+{
+    timeval tp;
+    gettimeofday(&tp,0);
+    return tp.tv_sec + tp.tv_usec/1.e6;
+}
+
+static void TestShape(const int M, const int N, const int K)
+{
+    tmv::Matrix<T> A(M,K);
+    tmv::Matrix<T> B(K,N);
+    tmv::Matrix<T> C(M,N);
+    for(int i=0;i<M;++i) for(int j=0;j<K;++j)
+        A(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+    for(int i=0;i<K;++i) for(int j=0;j<N;++j)
+        B(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+
+    const double nflops = 2. * M * N * K * XFOUR;
+    const int nloops = int(targetnflops / nflops) + 1;
+
+    const int maxthreads = MAXTHREADS > 0 ? MAXTHREADS : omp_get_num_procs();
+
+#ifdef ERRORCHECK
+    // The reference product uses a single thread.
+    omp_set_num_threads(1);
+    tmv::Matrix<T> C0 = A*B;
+#endif
+
+    std::cout<<"M,N,K = "<<M<<" x "<<N<<" x "<<K;
+    std::cout<<"   ("<<nloops<<" loops)\n";
+    std::cout<<"threads     time    GFlops   speedup  efficiency\n";
+
+    double t1 = 0.;
+    for(int nthreads=1; nthreads<=maxthreads; ++nthreads) {
+        omp_set_num_threads(nthreads);
+        C = A*B;  // warm up
+        const double t0 = GetTime();
+        for(int n=0; n<nloops; ++n) C = A*B;
+        const double t = (GetTime() - t0) / nloops;
+        if (nthreads == 1) t1 = t;
+        std::cout<<std::setw(5)<<nthreads<<"  ";
+        std::cout<<std::setw(10)<<t<<"  ";
+        std::cout<<std::setw(8)<<nflops/t*1.e-9<<"  ";
+        std::cout<<std::setw(8)<<t1/t<<"  ";
+        std::cout<<std::setw(8)<<t1/t/nthreads;
+#ifdef ERRORCHECK
+        std::cout<<"   err = "<<Norm(C-C0)/Norm(C0);
+#endif
+        std::cout<<std::endl;
+    }
+    std::cout<<std::endl;
+}
+
+int main() try
+{
+    for(int i=0; i<nshapes; ++i) TestShape(Ms[i],Ns[i],Ks[i]);
+    return 0;
+}
+catch (std::exception& e) {
+    std::cerr<<e.what()<<std::endl;
+    return 1;
+}
@@ -0,0 +1,182 @@
+//#define PRINTALGO_QR
+
+// This tests the OpenMP versions of the QR decomposition functions
+// against the serial versions.  For each shape, we time:
+//
+// 1) QR_Decompose(A,beta), which uses the tall-skinny TSQR algorithm
+//    in TMV_QRDecompose.cpp when M >> N and there is more than one
+//    thread.
+// 2) PackedQ_LDivEq(A,beta,B), i.e. B = Qt B for K right hand sides,
+//    which splits the columns of B among the threads.
+// 3) UnpackQ(A,beta), which splits the columns of Q among the threads.
+//
+// Each one is done with 1, 2, ... up to MAXTHREADS threads.  The
+// 1 thread timing is the serial path, so the speedup column is
+// relative to that.
+//
+// Note that TSQR does about three times the floating point operations
+// of the serial algorithm, so it is only used with at least 4 threads
+// (TMV_QR_TSQR_MINTHREADS).
+//
+// This needs the library to be compiled with OpenMP, and this file
+// needs to be compiled with -fopenmp (or the equivalent).
+
+#include "TMV.h"
+
+// The shapes to test:
+const int nshapes = 4;
+const int Ms[nshapes] = { 100000, 100000, 20000, 2000 };
+const int Ns[nshapes] = {    500,     50,   200, 2000 };
+const int Ks[nshapes] = {     20,    200,   100,  100 };
+
+// The maximum number of threads to use.
+// 0 means use omp_get_num_procs().
+const int MAXTHREADS = 0;
+
+// Define the type to use:
+//#define TISFLOAT
+//#define TISCOMPLEX
+
+// Set up the target number of operations for each timing
+const double targetnflops = 1.e10; // in real ops
+
+// Define whether you want to include the error checks.
+#define ERRORCHECK
+
+#include <complex>
+
+#ifdef TISFLOAT
+typedef float RT;
+#else
+typedef double RT;
+#endif
+
+#ifdef TISCOMPLEX
+typedef std::complex<RT> T;
+#define XFOUR 4
+#else
+typedef RT T;
+#define XFOUR 1
+#endif
+
+#include <sys/time.h>
+#include <iostream>
+#include <iomanip>
+#include <omp.h>
+
+static double GetTime()
+{
+    timeval tp;
+    gettimeofday(&tp,0);
+    return tp.tv_sec + tp.tv_usec/1.e6;
+}
+
+static void PrintLine(int nthreads, double t, double t1, double nflops)
+{
+    std::cout<<std::setw(5)<<nthreads<<"  ";
+    std::cout<<std::setw(10)<<t<<"  ";
+    std::cout<<std::setw(8)<<nflops/t*1.e-9<<"  ";
+    std::cout<<std::setw(8)<<t1/t;
+}
+
+static void TestShape(const int M, const int N, const int K)
+{
+    tmv::Matrix<T> A0(M,N);
+    tmv::Matrix<T> B0(M,K);
+    for(int i=0;i<M;++i) for(int j=0;j<N;++j)
+        A0(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+    for(int i=0;i<M;++i) for(int j=0;j<K;++j)
+        B0(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+
+    tmv::Matrix<T> A(M,N);
+    tmv::Vector<RT> beta(N);
+    tmv::Matrix<T> B(M,K);
+    tmv::Matrix<T> Q(M,N);
+
+    // The nominal flop counts for the serial algorithms:
+    const double nflops_qr = (2.*M*N*N - 2.*N*N*N/3.) * XFOUR;
+    const double nflops_q = (4.*M*N*K - 2.*N*N*K) * XFOUR;
+    const double nflops_u = (2.*M*N*N - 2.*N*N*N/3.) * XFOUR;
+    const int nloops_qr = int(targetnflops / nflops_qr) + 1;
+    const int nloops_q = int(targetnflops / nflops_q) + 1;
+    const int nloops_u = int(targetnflops / nflops_u) + 1;
+
+    const int maxthreads = MAXTHREADS > 0 ? MAXTHREADS : omp_get_num_procs();
+
+    std::cout<<"M,N,K = "<<M<<" x "<<N<<" x "<<K<<std::endl;
+
+    std::cout<<"QR_Decompose   ("<<nloops_qr<<" loops)\n";
+    std::cout<<"threads     time    GFlops   speedup\n";
+    double t1 = 0.;
+    for(int nthreads=1; nthreads<=maxthreads; ++nthreads) {
+        omp_set_num_threads(nthreads);
+        const double t0 = GetTime();
+        for(int n=0; n<nloops_qr; ++n) {
+            A = A0;
+            tmv::QR_Decompose(A,beta);
+        }
+        const double t = (GetTime() - t0) / nloops_qr;
+        if (nthreads == 1) t1 = t;
+        PrintLine(nthreads,t,t1,nflops_qr);
+#ifdef ERRORCHECK
+        // The R from different algorithms can differ in the phases of
+        // its rows, so check that Q R = A.
+        Q = A;
+        tmv::UnpackQ(Q,beta);
+        tmv::Matrix<T> QR = Q*A.upperTri();
+        std::cout<<"   err = "<<Norm(QR-A0)/Norm(A0);
+#endif
+        std::cout<<std::endl;
+    }
+
+    std::cout<<"PackedQ_LDivEq   ("<<nloops_q<<" loops)\n";
+    std::cout<<"threads     time    GFlops   speedup\n";
+    for(int nthreads=1; nthreads<=maxthreads; ++nthreads) {
+        omp_set_num_threads(nthreads);
+        const double t0 = GetTime();
+        for(int n=0; n<nloops_q; ++n) {
+            B = B0;
+            tmv::PackedQ_LDivEq(A,beta,B);
+        }
+        const double t = (GetTime() - t0) / nloops_q;
+        if (nthreads == 1) t1 = t;
+        PrintLine(nthreads,t,t1,nflops_q);
+#ifdef ERRORCHECK
+        // Q is the unpacked Q from the last QR_Decompose above.
+        tmv::Matrix<T> QtB = Q.adjoint()*B0;
+        std::cout<<"   err = "<<Norm(QtB-B.rowRange(0,N))/Norm(B0);
+#endif
+        std::cout<<std::endl;
+    }
+
+    std::cout<<"UnpackQ   ("<<nloops_u<<" loops)\n";
+    std::cout<<"threads     time    GFlops   speedup\n";
+    for(int nthreads=1; nthreads<=maxthreads; ++nthreads) {
+        omp_set_num_threads(nthreads);
+        const double t0 = GetTime();
+        for(int n=0; n<nloops_u; ++n) {
+            Q = A;
+            tmv::UnpackQ(Q,beta);
+        }
+        const double t = (GetTime() - t0) / nloops_u;
+        if (nthreads == 1) t1 = t;
+        PrintLine(nthreads,t,t1,nflops_u);
+#ifdef ERRORCHECK
+        tmv::Matrix<T> QtQ = Q.adjoint()*Q;
+        QtQ.diag().addToAll(T(-1));
+        std::cout<<"   err = "<<Norm(QtQ);
+#endif
+        std::cout<<std::endl;
+    }
+    std::cout<<std::endl;
+}
+
+int main() try
+{
+    for(int i=0; i<nshapes; ++i) TestShape(Ms[i],Ns[i],Ks[i]);
+    return 0;
+}
+catch (std::exception& e) {
+    std::cerr<<e.what()<<std::endl;
+    return 1;
+}
@@ -0,0 +1,125 @@
+//#define PRINTALGO_SVD
+
+// This tests the strong scaling of the OpenMP divide and conquer SVD
+// of a bidiagonal matrix (algo 11 in TMV_SVDecompose_DC.h).
+// For each size N, we find the SVD of the same random N x N bidiagonal
+// matrix B = U S V with 1, 2, ... up to MAXTHREADS threads, and print
+// the time, speedup and parallel efficiency relative to one thread.
+//
+// The parallelism comes from two places: the two halves of each divide
+// step are done as separate tasks, and the secular equation solves in
+// each conquer step are split among the threads.  The final conquer
+// step is done outside of the task region, so its matrix products
+// use the OpenMP MultMM algorithm as well.
+//
+// The error check uses B V^T = U S, which only needs O(N^2) operations,
+// so it is cheap enough to do even for the largest N.  We also check
+// that the singular values agree with the 1 thread answer.
+//
+// This needs the library to be compiled with OpenMP, and this file
+// needs to be compiled with -fopenmp (or the equivalent).
+
+#include "TMV.h"
+
+// The sizes to test:
+const int nsizes = 5;
+const int Ns[nsizes] = { 500, 1000, 2000, 4000, 8000 };
+
+// The maximum number of threads to use.
+// 0 means use omp_get_num_procs().
+const int MAXTHREADS = 0;
+
+// Define the type to use:
+//#define TISFLOAT
+
+// Set up the target number of operations for each timing
+const double targetnflops = 1.e10; // in real ops
+
+// Define whether you want to include the error checks.
+#define ERRORCHECK
+
+#ifdef TISFLOAT
+typedef float T;
+#else
+typedef double T;
+#endif
+
+#include <sys/time.h>
+#include <iostream>
+#include <iomanip>
+#include <omp.h>
+
+static double GetTime()
+{
+    timeval tp;
+    gettimeofday(&tp,0);
+    return tp.tv_sec + tp.tv_usec/1.e6;
+}
+
+static void TestSize(const int N)
+{
+    tmv::Vector<T> D0(N);
+    tmv::Vector<T> E0(N-1);
+    for(int i=0;i<N;++i) D0(i) = T(std::rand()) / T(RAND_MAX) + T(0.1);
+    for(int i=0;i<N-1;++i) E0(i) = T(std::rand()) / T(RAND_MAX) + T(0.1);
+
+    tmv::Matrix<T> U(N,N);
+    tmv::Matrix<T> V(N,N);
+    tmv::Vector<T> D(N);
+    tmv::Vector<T> E(N-1);
+    tmv::Vector<T> S1(N);
+
+    // The divide and conquer algorithm is dominated by the matrix
+    // products that update U and V, which are roughly 4/3 N^3 each
+    // for the full recursion.
+    const double nflops = 8./3. * N * N * N;
+    const int nloops = int(targetnflops / nflops) + 1;
+
+    const int maxthreads = MAXTHREADS > 0 ? MAXTHREADS : omp_get_num_procs();
+
+    std::cout<<"N = "<<N<<"   ("<<nloops<<" loops)\n";
+    std::cout<<"threads     time   speedup  efficiency\n";
+
+    double t1 = 0.;
+    for(int nthreads=1; nthreads<=maxthreads; ++nthreads) {
+        omp_set_num_threads(nthreads);
+        const double t0 = GetTime();
+        for(int n=0; n<nloops; ++n) {
+            D = D0;
+            E = E0;
+            U.setToIdentity();
+            V.setToIdentity();
+            tmv::SV_DecomposeFromBidiagonal_DC(U,D,E,V,true,true);
+        }
+        const double t = (GetTime() - t0) / nloops;
+        if (nthreads == 1) { t1 = t; S1 = D; }
+        std::cout<<std::setw(5)<<nthreads<<"  ";
+        std::cout<<std::setw(10)<<t<<"  ";
+        std::cout<<std::setw(8)<<t1/t<<"  ";
+        std::cout<<std::setw(8)<<t1/t/nthreads;
+#ifdef ERRORCHECK
+        // Row i of B V^T is D0(i) V.col(i) + E0(i) V.col(i+1).
+        tmv::Matrix<T> US = U;
+        for(int j=0;j<N;++j) US.col(j) *= D(j);
+        for(int i=0;i<N;++i) {
+            US.row(i) -= D0(i) * V.col(i);
+            if (i < N-1) US.row(i) -= E0(i) * V.col(i+1);
+        }
+        const T normB = tmv::TMV_SQRT(NormSq(D0) + NormSq(E0));
+        std::cout<<"   err = "<<Norm(US)/normB;
+        std::cout<<"   S err = "<<Norm(D-S1)/Norm(S1);
+#endif
+        std::cout<<std::endl;
+    }
+    std::cout<<std::endl;
+}
+
+int main() try
+{
+    for(int i=0; i<nsizes; ++i) TestSize(Ns[i]);
+    return 0;
+}
+catch (std::exception& e) {
+    std::cerr<<e.what()<<std::endl;
+    return 1;
+}
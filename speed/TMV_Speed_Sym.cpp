@@ -0,0 +1,159 @@
+//#define PRINTALGO_RankK
+//#define PRINTALGO_SM
+
+// This tests the rank-k update and the symmetric matrix product
+// against the same calculations done with a general Matrix.
+//
+// For each N, we first time S = A * A^T, where A is N x K, three ways:
+// as a regular Matrix product, with RankKUpdate into a SymMatrix
+// (which only computes the lower triangle), and with RankKUpdate into
+// a packed SymMatrix (which also uses half the memory).
+// Then we time C = S * B, where B is N x N, with S as a Matrix and
+// as a SymMatrix.  The SymMatrix version reads each element of
+// the stored triangle once and uses the normal MultMM blocks.
+
+#include "TMV_Sym.h"
+
+// The sizes to test:
+const int nsizes = 4;
+const int Ns[nsizes] = { 250, 500, 1000, 2000 };
+const int Ks[nsizes] = { 250, 500, 1000, 2000 };
+
+// Define the type to use:
+//#define TISFLOAT
+//#define TISCOMPLEX
+
+// Set up the target number of operations for each timing
+const double targetnflops = 1.e10; // in real ops
+
+// Define whether you want to include the error checks.
+#define ERRORCHECK
+
+#include <complex>
+
+#ifdef TISFLOAT
+typedef float RT;
+#else
+typedef double RT;
+#endif
+
+#ifdef TISCOMPLEX
+typedef std::complex<RT> T;
+#define XFOUR 4
+#else
+typedef RT T;
+#define XFOUR 1
+#endif
+
+#include <sys/time.h>
+#include <iostream>
+#include <iomanip>
+
+static double GetTime()
+{
+    timeval tp;
+    gettimeofday(&tp,0);
+    return tp.tv_sec + tp.tv_usec/1.e6;
+}
+
+static void Report(
+    const char* name, double t, double nflops, double t0)
+{
+    std::cout<<name<<std::setw(10)<<t<<"  ";
+    std::cout<<std::setw(8)<<nflops/t*1.e-9;
+    if (t0 > 0.) std::cout<<"  speedup = "<<t0/t;
+}
+
+static void TestSize(const int N, const int K)
+{
+    tmv::Matrix<T> A(N,K);
+    tmv::Matrix<T> B(N,N);
+    std::srand(1234);
+    for(int i=0;i<N;++i) for(int j=0;j<K;++j)
+        A(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+    for(int i=0;i<N;++i) for(int j=0;j<N;++j)
+        B(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+
+    tmv::Matrix<T> S0(N,N);
+    tmv::SymMatrix<T> S1(N);
+    tmv::SymMatrix<T,tmv::Packed> S2(N);
+
+    // The flop counts are for the full calculation in each case,
+    // so the "GFlops" of the symmetric versions are effective rates.
+    const double nflopsk = 2. * N * N * K * XFOUR;
+    const int nloopsk = int(targetnflops / nflopsk) + 1;
+
+    std::cout<<"N = "<<N<<", K = "<<K<<"   ("<<nloopsk<<" loops)\n";
+    std::cout<<"S = A * A^T        time    GFlops\n";
+
+    S0 = A*A.transpose();  // warm up
+    double t0 = GetTime();
+    for(int n=0; n<nloopsk; ++n) S0 = A*A.transpose();
+    const double tfull = (GetTime() - t0) / nloopsk;
+    Report("Matrix         ",tfull,nflopsk,0.);
+    std::cout<<std::endl;
+
+    tmv::RankKUpdate<false>(T(1),A,S1);
+    t0 = GetTime();
+    for(int n=0; n<nloopsk; ++n) tmv::RankKUpdate<false>(T(1),A,S1);
+    double t = (GetTime() - t0) / nloopsk;
+    Report("SymMatrix      ",t,nflopsk,tfull);
+#ifdef ERRORCHECK
+    std::cout<<"   diff = "<<Norm(tmv::Matrix<T>(S1)-S0)/Norm(S0);
+#endif
+    std::cout<<std::endl;
+
+    tmv::RankKUpdate<false>(T(1),A,S2);
+    t0 = GetTime();
+    for(int n=0; n<nloopsk; ++n) tmv::RankKUpdate<false>(T(1),A,S2);
+    t = (GetTime() - t0) / nloopsk;
+    Report("Packed         ",t,nflopsk,tfull);
+#ifdef ERRORCHECK
+    std::cout<<"   diff = "<<Norm(tmv::Matrix<T>(S2)-S0)/Norm(S0);
+#endif
+    std::cout<<std::endl;
+
+    const double nflopsm = 2. * N * N * N * XFOUR;
+    const int nloopsm = int(targetnflops / nflopsm) + 1;
+    tmv::Matrix<T> C0(N,N);
+    tmv::Matrix<T> C1(N,N);
+
+    std::cout<<"C = S * B          time    GFlops   ("<<nloopsm<<" loops)\n";
+
+    C0 = S0*B;  // warm up
+    t0 = GetTime();
+    for(int n=0; n<nloopsm; ++n) C0 = S0*B;
+    const double tfullm = (GetTime() - t0) / nloopsm;
+    Report("Matrix         ",tfullm,nflopsm,0.);
+    std::cout<<std::endl;
+
+    C1 = S1*B;
+    t0 = GetTime();
+    for(int n=0; n<nloopsm; ++n) C1 = S1*B;
+    t = (GetTime() - t0) / nloopsm;
+    Report("SymMatrix      ",t,nflopsm,tfullm);
+#ifdef ERRORCHECK
+    std::cout<<"   diff = "<<Norm(C1-C0)/Norm(C0);
+#endif
+    std::cout<<std::endl;
+
+    C1 = S2*B;
+    t0 = GetTime();
+    for(int n=0; n<nloopsm; ++n) C1 = S2*B;
+    t = (GetTime() - t0) / nloopsm;
+    Report("Packed         ",t,nflopsm,tfullm);
+#ifdef ERRORCHECK
+    std::cout<<"   diff = "<<Norm(C1-C0)/Norm(C0);
+#endif
+    std::cout<<std::endl<<std::endl;
+}
+
+int main() try
+{
+    for(int i=0; i<nsizes; ++i) TestSize(Ns[i],Ks[i]);
+    return 0;
+}
+catch (std::exception& e) {
+    std::cerr<<e.what()<<std::endl;
+    return 1;
+}
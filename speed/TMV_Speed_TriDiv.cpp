@@ -0,0 +1,221 @@
+//#define PRINTALGO_DivU
+//#define PRINTALGO_UM
+//#define PRINTALGO_InvU
+
+// This tests the parallel algorithms for the triangular solve with many
+// right hand sides (LDivEqMU, X = U^-1 X), the triangular multiply
+// (MultUM, Y = U X) and the triangular inverse (InvertU) against the
+// serial recursive algorithm (algo 17 in each case).
+//
+// algo 36 splits the columns of X evenly among the threads.  It is no
+// longer chosen automatically, so it is only called explicitly here.
+// algo 37 splits the problem into tiles and does them as OpenMP tasks,
+// using task dependencies for the solve, so it can also split the rows.
+//
+// For each M and N, U is M x M and X is M x N.  The solve and multiply
+// each do M^2 N flops, and the inverse does M^3/3 flops.
+// The error check is the relative difference of the result from the
+// serial algorithm.
+
+#include "TMV.h"
+
+// The sizes to test:
+const int nsizes = 3;
+const int Ms[nsizes] = { 500, 1000, 2000 };
+const int nrhs = 3;
+const int Ns[nrhs] = { 16, 256, 2000 };
+
+// Define the type to use:
+//#define TISFLOAT
+//#define TISCOMPLEX
+
+// Set up the target number of operations for each timing
+const double targetnflops = 1.e10; // in real ops
+
+// Define whether you want to include the error checks.
+#define ERRORCHECK
+
+#include <complex>
+
+#ifdef TISFLOAT
+typedef float RT;
+#else
+typedef double RT;
+#endif
+
+#ifdef TISCOMPLEX
+typedef std::complex<RT> T;
+#define XFOUR 4
+#else
+typedef RT T;
+#define XFOUR 1
+#endif
+
+#include <sys/time.h>
+#include <iostream>
+#include <iomanip>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+static double GetTime()
+{
+    timeval tp;
+    gettimeofday(&tp,0);
+    return tp.tv_sec + tp.tv_usec/1.e6;
+}
+
+static void Report(
+    const char* name, double t, double nflops, double t0)
+{
+    std::cout<<name<<std::setw(10)<<t<<"  ";
+    std::cout<<std::setw(8)<<nflops/t*1.e-9;
+    if (t0 > 0.) std::cout<<"  speedup = "<<t0/t;
+}
+
+typedef tmv::Matrix<T,tmv::ColMajor> MM;
+typedef MM::view_type MV;
+typedef MM::const_view_type MCV;
+typedef tmv::UpperTriMatrix<T,tmv::NonUnitDiag|tmv::ColMajor> UM;
+typedef UM::view_type UV;
+typedef UM::const_view_type UCV;
+const ptrdiff_t xx = tmv::Unknown;
+
+template <int algo>
+static double TimeDiv(
+    const char* name, const UM& U, const MM& X0, MM& X1, const MM* X17,
+    int nloops, double nflops, double t0)
+{
+    MV X1v = X1.view();
+    UCV Uv = U.view();
+    double t = 0.;
+    for(int n=0; n<nloops; ++n) {
+        X1 = X0;
+        double t1 = GetTime();
+        tmv::LDivEqMU_Helper<algo,xx,xx,MV,UCV>::call(X1v,Uv);
+        t += GetTime() - t1;
+    }
+    t /= nloops;
+    Report(name,t,nflops,t0);
+#ifdef ERRORCHECK
+    if (X17) std::cout<<"   error = "<<Norm(X1-*X17)/Norm(*X17);
+#endif
+    std::cout<<std::endl;
+    return t;
+}
+
+template <int algo>
+static double TimeMult(
+    const char* name, const UM& U, const MM& X0, MM& Y, const MM* Y17,
+    int nloops, double nflops, double t0)
+{
+    MV Yv = Y.view();
+    MCV X0v = X0.view();
+    UCV Uv = U.view();
+    tmv::Scaling<1,RT> one;
+    double t = 0.;
+    for(int n=0; n<nloops; ++n) {
+        double t1 = GetTime();
+        tmv::MultUM_Helper<algo,xx,xx,false,1,RT,UCV,MCV,MV>::call(
+            one,Uv,X0v,Yv);
+        t += GetTime() - t1;
+    }
+    t /= nloops;
+    Report(name,t,nflops,t0);
+#ifdef ERRORCHECK
+    if (Y17) std::cout<<"   error = "<<Norm(Y-*Y17)/Norm(*Y17);
+#endif
+    std::cout<<std::endl;
+    return t;
+}
+
+template <int algo>
+static double TimeInv(
+    const char* name, const UM& U0, UM& U1, const UM* U17,
+    int nloops, double nflops, double t0)
+{
+    UV U1v = U1.view();
+    typedef UV::diag_type DV;
+    double t = 0.;
+    for(int n=0; n<nloops; ++n) {
+        U1 = U0;
+        double t1 = GetTime();
+        // Algos 17 and 37 expect the diagonal to be inverted already.
+        DV d = U1v.diag();
+        tmv::ElemInvert_Helper<-4,xx,DV>::call(d);
+        tmv::InvertU_Helper<algo,xx,UV>::call(U1v);
+        t += GetTime() - t1;
+    }
+    t /= nloops;
+    Report(name,t,nflops,t0);
+#ifdef ERRORCHECK
+    if (U17) std::cout<<"   error = "<<Norm(U1-*U17)/Norm(*U17);
+#endif
+    std::cout<<std::endl;
+    return t;
+}
+
+static void TestSize(const int M)
+{
+    UM U(M);
+    std::srand(1234);
+    for(int j=0;j<M;++j) for(int i=0;i<=j;++i)
+        U(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+    for(int i=0;i<M;++i) U(i,i) += T(M/4);
+
+    for(int k=0;k<nrhs;++k) {
+        const int N = Ns[k];
+        MM X0(M,N);
+        for(int i=0;i<M;++i) for(int j=0;j<N;++j)
+            X0(i,j) = T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5));
+        const double nflops = double(M)*M*N * XFOUR;
+        const int nloops = int(targetnflops / nflops / 10) + 1;
+        std::cout<<"M = "<<M<<"  N = "<<N<<"   ("<<nloops<<" loops)\n";
+
+        MM X17(M,N), X1(M,N);
+        std::cout<<"LDivEq U         time    GFlops\n";
+        const double t17 = TimeDiv<17>(
+            "Serial (17)    ",U,X0,X17,0,nloops,nflops,0.);
+#ifdef _OPENMP
+        TimeDiv<36>("Columns (36)   ",U,X0,X1,&X17,nloops,nflops,t17);
+        TimeDiv<37>("Tasks (37)     ",U,X0,X1,&X17,nloops,nflops,t17);
+#endif
+        TimeDiv<-2>("Automatic      ",U,X0,X1,&X17,nloops,nflops,t17);
+
+        std::cout<<"Mult U           time    GFlops\n";
+        const double u17 = TimeMult<17>(
+            "Serial (17)    ",U,X0,X17,0,nloops,nflops,0.);
+#ifdef _OPENMP
+        TimeMult<36>("Columns (36)   ",U,X0,X1,&X17,nloops,nflops,u17);
+        TimeMult<37>("Tasks (37)     ",U,X0,X1,&X17,nloops,nflops,u17);
+#endif
+        TimeMult<-2>("Automatic      ",U,X0,X1,&X17,nloops,nflops,u17);
+        std::cout<<std::endl;
+    }
+
+    const double nflops = double(M)*M*M/3. * XFOUR;
+    const int nloops = int(targetnflops / nflops / 10) + 1;
+    std::cout<<"M = "<<M<<"   ("<<nloops<<" loops)\n";
+    std::cout<<"Invert U         time    GFlops\n";
+    UM U17(M), U1(M);
+    const double v17 = TimeInv<17>(
+        "Serial (17)    ",U,U17,0,nloops,nflops,0.);
+#ifdef _OPENMP
+    TimeInv<37>("Tasks (37)     ",U,U1,&U17,nloops,nflops,v17);
+#endif
+    std::cout<<std::endl;
+}
+
+int main() try
+{
+#ifdef _OPENMP
+    std::cout<<"Using "<<omp_get_max_threads()<<" threads\n\n";
+#endif
+    for(int k=0; k<nsizes; ++k) TestSize(Ms[k]);
+    return 0;
+}
+catch (std::exception& e) {
+    std::cerr<<e.what()<<std::endl;
+    return 1;
+}
@@ -0,0 +1,222 @@
+// This tests the tridiagonal kernels in TMV_TridiagMatrix.h against the
+// same operations done with a BandMatrix with nlo = nhi = 1:
+//
+// - The multiply y = A x.
+// - The Thomas algorithm (Tridiag_Decompose, Tridiag_SolveInPlace)
+//   and cyclic reduction (Tridiag_SolveCR) against the band LU
+//   decomposition and solve for a single system of size N.
+// - The batch solve (BatchTridiag_Decompose, BatchTridiag_SolveInPlace)
+//   of nbatch systems of size Nsmall against solving each one in turn
+//   with Tridiag_Decompose and Tridiag_SolveInPlace.
+//
+// The error check is the relative difference of the result from the
+// known solution.
+
+#include "TMV.h"
+#include "TMV_Band.h"
+#include "tmv/TMV_BandLUDecompose.h"
+#include "tmv/TMV_BandLUDiv.h"
+#include "tmv/TMV_TridiagMatrix.h"
+
+// The size of the single system:
+const int N = 1000000;
+
+// The number and size of the systems for the batch solve:
+const int nbatch = 100000;
+const int Nsmall = 20;
+
+// Define the type to use:
+//#define TISFLOAT
+//#define TISCOMPLEX
+
+// The number of times to repeat each timing
+const int nloops = 10;
+
+// Define whether you want to include the error checks.
+#define ERRORCHECK
+
+#include <complex>
+
+#ifdef TISFLOAT
+typedef float RT;
+#else
+typedef double RT;
+#endif
+
+#ifdef TISCOMPLEX
+typedef std::complex<RT> T;
+#else
+typedef RT T;
+#endif
+
+#include <sys/time.h>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+static double GetTime()
+{
+    timeval tp;
+    gettimeofday(&tp,0);
+    return tp.tv_sec + tp.tv_usec/1.e6;
+}
+
+static T Rand()
+{ return T(RT(std::rand()) / RT(RAND_MAX) - RT(0.5)); }
+
+static void Report(const char* name, double t, double t0)
+{
+    std::cout<<name<<std::setw(10)<<t;
+    if (t0 > 0.) std::cout<<"  speedup = "<<t0/t;
+}
+
+static void ReportError(const tmv::Vector<T>& x, const tmv::Vector<T>& x0)
+{
+#ifdef ERRORCHECK
+    std::cout<<"   error = "<<Norm(x-x0)/Norm(x0);
+#endif
+    std::cout<<std::endl;
+}
+
+static void TestSingle()
+{
+    // Diagonally dominant, so no pivoting is needed.
+    tmv::TridiagMatrix<T> A(N);
+    tmv::BandMatrix<T> AB(N,N,1,2,T(0));
+    for(int i=0;i<N;++i) {
+        A.diag()(i) = Rand() + T(3);
+        if (i < N-1) { A.subDiag()(i) = Rand(); A.superDiag()(i) = Rand(); }
+    }
+    for(int i=0;i<N;++i) for(int j=std::max(0,i-1);j<=std::min(N-1,i+1);++j)
+        AB(i,j) = A(i,j);
+    tmv::Vector<T> x0(N);
+    for(int i=0;i<N;++i) x0(i) = Rand();
+
+    std::cout<<"N = "<<N<<"\n";
+    std::cout<<"Multiply           time\n";
+    tmv::Vector<T> b(N);
+    double t1 = GetTime();
+    for(int n=0;n<nloops;++n) b = AB * x0;
+    const double tbm = (GetTime()-t1)/nloops;
+    Report("BandMatrix     ",tbm,0.);
+    std::cout<<std::endl;
+
+    tmv::Vector<T> b2(N);
+    t1 = GetTime();
+    for(int n=0;n<nloops;++n) tmv::Tridiag_MultMV(A,x0,b2);
+    Report("TridiagMatrix  ",(GetTime()-t1)/nloops,tbm);
+    ReportError(b2,b);
+
+    std::cout<<"Solve              time\n";
+    tmv::BandMatrix<T> AB1 = AB;
+    std::vector<ptrdiff_t> P(N);
+    tmv::Vector<T> x(N);
+    double t = 0.;
+    for(int n=0;n<nloops;++n) {
+        AB1 = AB;
+        x = b;
+        t1 = GetTime();
+        tmv::InlineBandLU_Decompose(AB1,&P[0]);
+        tmv::InlineBandLU_SolveInPlace(AB1,tmv::Permutation(N,&P[0]),x);
+        t += GetTime()-t1;
+    }
+    const double tlu = t/nloops;
+    Report("Band LU        ",tlu,0.);
+    ReportError(x,x0);
+
+    tmv::TridiagMatrix<T> A1 = A;
+    t = 0.;
+    for(int n=0;n<nloops;++n) {
+        A1 = A;
+        x = b;
+        t1 = GetTime();
+        tmv::Tridiag_Decompose(A1);
+        tmv::Tridiag_SolveInPlace(A1,x);
+        t += GetTime()-t1;
+    }
+    Report("Thomas         ",t/nloops,tlu);
+    ReportError(x,x0);
+
+    t = 0.;
+    for(int n=0;n<nloops;++n) {
+        x = b;
+        t1 = GetTime();
+        tmv::Tridiag_SolveCR(A,x);
+        t += GetTime()-t1;
+    }
+    Report("Cyclic reduct  ",t/nloops,tlu);
+    ReportError(x,x0);
+    std::cout<<std::endl;
+}
+
+static void TestBatch()
+{
+    tmv::TridiagMatrixBatch<T> A(nbatch,Nsmall);
+    tmv::Matrix<T> X0(nbatch,Nsmall);
+    for(int b=0;b<nbatch;++b) for(int i=0;i<Nsmall;++i) {
+        A.diag()(b,i) = Rand() + T(3);
+        if (i < Nsmall-1) {
+            A.subDiag()(b,i) = Rand();
+            A.superDiag()(b,i) = Rand();
+        }
+        X0(b,i) = Rand();
+    }
+    tmv::Matrix<T> B(nbatch,Nsmall);
+    for(int b=0;b<nbatch;++b) for(int i=0;i<Nsmall;++i) {
+        T s = A.diag()(b,i) * X0(b,i);
+        if (i > 0) s += A.subDiag()(b,i-1) * X0(b,i-1);
+        if (i < Nsmall-1) s += A.superDiag()(b,i) * X0(b,i+1);
+        B(b,i) = s;
+    }
+    tmv::Vector<T> x0 = X0.linearView();
+
+    std::cout<<"nbatch = "<<nbatch<<"  N = "<<Nsmall<<"\n";
+    std::cout<<"Solve              time\n";
+    // One at a time.
+    std::vector<tmv::TridiagMatrix<T> > A1(nbatch,tmv::TridiagMatrix<T>(Nsmall));
+    tmv::Matrix<T> X(nbatch,Nsmall);
+    double t = 0.;
+    for(int n=0;n<nloops;++n) {
+        for(int b=0;b<nbatch;++b) {
+            A1[b].diag() = A.diag().row(b);
+            A1[b].subDiag() = A.subDiag().row(b);
+            A1[b].superDiag() = A.superDiag().row(b);
+        }
+        X = B;
+        double t1 = GetTime();
+        for(int b=0;b<nbatch;++b) {
+            tmv::Tridiag_Decompose(A1[b]);
+            tmv::VectorView<T> xb = X.row(b);
+            tmv::Tridiag_SolveInPlace(A1[b],xb);
+        }
+        t += GetTime()-t1;
+    }
+    const double t0 = t/nloops;
+    Report("One at a time  ",t0,0.);
+    ReportError(X.linearView(),x0);
+
+    tmv::TridiagMatrixBatch<T> A2 = A;
+    t = 0.;
+    for(int n=0;n<nloops;++n) {
+        A2 = A;
+        X = B;
+        double t1 = GetTime();
+        tmv::BatchTridiag_Decompose(A2);
+        tmv::BatchTridiag_SolveInPlace(A2,X);
+        t += GetTime()-t1;
+    }
+    Report("Batch          ",t/nloops,t0);
+    ReportError(X.linearView(),x0);
+    std::cout<<std::endl;
+}
+
+int main() try
+{
+    TestSingle();
+    TestBatch();
+    return 0;
+}
+catch (std::exception& e) {
+    std::cerr<<e.what()<<std::endl;
+    return 1;
+}
@@ -0,0 +1,293 @@
+
+// This program measures the crossover points between the algorithms
+// that TMV selects at run time, and writes them to a tuning profile.
+// (See TMV_Tuning.h.)
+//
+// Usage: tmvtune [filename]
+//
+// The default filename is tmv_tuning.txt.  To use the profile, set the
+// environment variable TMV_TUNING_FILE to its name when running a
+// program that uses TMV.
+//
+// For each crossover point, we time the two algorithms on either side
+// of it for a range of sizes, using the tuning profile to force one
+// or the other.  The crossover is the smallest size from which the
+// algorithm for larger matrices is faster for every size tested.
+// If it is never faster, the threshold is set high enough that it is
+// never used.
+//
+// The library should be compiled with the same options as the ones
+// used for this program.
+
+#include "TMV.h"
+
+// Define whether you want to measure the Winograd crossover, which
+// takes a while, since the matrices are very large.  (It is only used
+// if the library is compiled with TMV_OPT = 3.)
+//#define DOWINOGRAD
+
+// The minimum time for each measurement
+const double mintime = 0.05;
+
+#include <sys/time.h>
+#include <iostream>
+#include <iomanip>
+#include <complex>
+#include <vector>
+
+#ifdef _OPENMP
+#include "omp.h"
+#endif
+
+static double GetTime()
+{
+    timeval tp;
+    gettimeofday(&tp,0);
+    return tp.tv_sec + tp.tv_usec/1.e6;
+}
+
+const ptrdiff_t never = ptrdiff_t(1) << 40;
+
+// Each test is a functor that does one calculation with its size
+// set by resize(n).
+template <class F>
+static double TimeIt(F& f)
+{
+    f();  // warm up
+    int nloops = 1;
+    double t;
+    for(;;) {
+        double t0 = GetTime();
+        for(int i=0; i<nloops; ++i) f();
+        t = GetTime() - t0;
+        if (t >= mintime) break;
+        nloops = t > 0. ? int(nloops * 1.5 * mintime / t) + 1 : nloops * 10;
+    }
+    return t / nloops;
+}
+
+// Time f for each size in ns with the threshold set to lo (to use the
+// algorithm for large matrices) and to hi (to use the other one), and
+// return the smallest size from which lo is always faster, or -1 if
+// it is never faster.  If lo < 0, the threshold is set to n itself.
+template <class F>
+static ptrdiff_t FindCrossover(
+    const char* name, F& f, ptrdiff_t tmv::TuningProfile::* value,
+    const std::vector<ptrdiff_t>& ns, ptrdiff_t lo, ptrdiff_t hi)
+{
+    tmv::TuningProfile save = tmv::GetTuning();
+    std::cout<<name<<":\n";
+    std::cout<<"       n      large algo   small algo\n";
+    ptrdiff_t cross = -1;
+    for(size_t i=0; i<ns.size(); ++i) {
+        f.resize(ns[i]);
+        tmv::GetTuning().*value = lo < 0 ? ns[i] : lo;
+        const double tlo = TimeIt(f);
+        tmv::GetTuning().*value = hi;
+        const double thi = TimeIt(f);
+        std::cout<<std::setw(8)<<ns[i]<<"   "<<std::setw(10)<<tlo<<
+            "   "<<std::setw(10)<<thi<<std::endl;
+        if (tlo < thi) { if (cross < 0) cross = ns[i]; }
+        else cross = -1;
+    }
+    tmv::SetTuning(save);
+    return cross;
+}
+
+template <class T>
+static void Randomize(tmv::Matrix<T>& m)
+{
+    for(ptrdiff_t i=0;i<m.colsize();++i)
+        for(ptrdiff_t j=0;j<m.rowsize();++j)
+            m(i,j) = T(double(std::rand()) / RAND_MAX - 0.5);
+}
+
+// C = A * B with A MxK and B KxN.
+// The sizes are (m0 or n, n0 or n, k0 or n), where 0 means n.
+template <class T>
+struct MultTest
+{
+    ptrdiff_t m0, n0, k0;
+    tmv::Matrix<T> A, B, C;
+    MultTest(ptrdiff_t _m0, ptrdiff_t _n0, ptrdiff_t _k0) :
+        m0(_m0), n0(_n0), k0(_k0) {}
+    void resize(ptrdiff_t n)
+    {
+        const ptrdiff_t M = m0 ? m0 : n;
+        const ptrdiff_t N = n0 ? n0 : n;
+        const ptrdiff_t K = k0 ? k0 : n;
+        A.resize(M,K); B.resize(K,N); C.resize(M,N);
+        Randomize(A); Randomize(B);
+    }
+    void operator()() { C = A * B; }
+};
+
+// The decompositions are done on a copy of A0, so the copy is included
+// in the time for both algorithms.
+template <class T>
+struct QRTest
+{
+    tmv::Matrix<T> A0, A;
+    tmv::Vector<typename tmv::Traits<T>::real_type> beta;
+    void resize(ptrdiff_t n)
+    {
+        A0.resize(n,n); A.resize(n,n); beta.resize(n);
+        Randomize(A0);
+    }
+    void operator()() { A = A0; QR_Decompose(A,beta); }
+};
+
+template <class T>
+struct QRPTest
+{
+    tmv::Matrix<T> A0, A;
+    tmv::Vector<typename tmv::Traits<T>::real_type> beta;
+    std::vector<ptrdiff_t> P;
+    void resize(ptrdiff_t n)
+    {
+        A0.resize(n,n); A.resize(n,n); beta.resize(n); P.resize(n);
+        Randomize(A0);
+    }
+    void operator()() { A = A0; QRP_Decompose(A,beta,&P[0]); }
+};
+
+template <class T>
+struct BidiagTest
+{
+    tmv::Matrix<T> A0, A;
+    tmv::Vector<typename tmv::Traits<T>::real_type> Ubeta, Vbeta;
+    tmv::Vector<T> D, E;
+    void resize(ptrdiff_t n)
+    {
+        A0.resize(n,n); A.resize(n,n);
+        Ubeta.resize(n); Vbeta.resize(n-1); D.resize(n); E.resize(n-1);
+        Randomize(A0);
+    }
+    void operator()() { A = A0; Bidiagonalize(A,Ubeta,Vbeta,D,E); }
+};
+
+static std::vector<ptrdiff_t> Sizes(const ptrdiff_t* n, int k)
+{ return std::vector<ptrdiff_t>(n,n+k); }
+
+int main(int argc, char** argv) try
+{
+    const char* file = argc > 1 ? argv[1] : "tmv_tuning.txt";
+    typedef double T;
+    typedef std::complex<double> CT;
+
+    tmv::TuningProfile tune = tmv::DefaultTuning();
+    tmv::SetTuning(tune);
+    ptrdiff_t n;
+
+    // The packed algorithm for real matrices.
+    {
+        const ptrdiff_t ns[] = { 32, 48, 64, 96, 128, 192, 256, 384, 512 };
+        MultTest<T> f(0,0,0);
+        n = FindCrossover(
+            "mm_min_packed",f,&tmv::TuningProfile::mm_min_packed,
+            Sizes(ns,9),0,never);
+        tune.mm_min_packed = n < 0 ? never : n;
+    }
+
+    // The recursive block algorithm.  This only matters when the
+    // packed algorithm isn't used, so we test it with complex matrices.
+    {
+        const ptrdiff_t ns[] = { 64, 128, 192, 256, 384, 512, 768 };
+        MultTest<CT> f(0,0,0);
+        n = FindCrossover(
+            "mm_min_recursive (n^4/64^4)",f,
+            &tmv::TuningProfile::mm_min_recursive,Sizes(ns,7),0,never);
+        tune.mm_min_recursive = n < 0 ? never : (n/64)*(n/64)*(n/64)*(n/64);
+    }
+
+    // The copying algorithms when M is small.
+    {
+        const ptrdiff_t ns[] = { 64, 96, 128, 192, 256, 384, 512 };
+        MultTest<T> f(8,0,0);
+        n = FindCrossover(
+            "mm_min_copy_algo (8 x n x n, n^2/16^2)",f,
+            &tmv::TuningProfile::mm_min_copy_algo,Sizes(ns,7),0,never);
+        tune.mm_min_copy_algo = n < 0 ? never : (n/16)*(n/16);
+    }
+
+#ifdef _OPENMP
+    // The OpenMP algorithm.
+    if (omp_get_max_threads() > 1) {
+        const ptrdiff_t ns[] = { 32, 48, 64, 96, 128, 192, 256 };
+        MultTest<T> f(0,0,0);
+        n = FindCrossover(
+            "mm_openmp_thresh (n^3/16^3)",f,
+            &tmv::TuningProfile::mm_openmp_thresh,Sizes(ns,7),0,never);
+        tune.mm_openmp_thresh = n < 0 ? never : (n/16)*(n/16)*(n/16);
+    }
+#endif
+
+#if defined(DOWINOGRAD) && defined(TMV_MM_USE_WINOGRAD)
+    // The Winograd algorithm.  This also uses the threshold to end
+    // its recursion, so we set it to n rather than a small value.
+    {
+        const ptrdiff_t ns[] = { 1024, 1536, 2048, 3072 };
+        MultTest<T> f(0,0,0);
+        n = FindCrossover(
+            "mm_min_winograd",f,&tmv::TuningProfile::mm_min_winograd,
+            Sizes(ns,4),-1,never);
+        tune.mm_min_winograd = n < 0 ? never : n;
+    }
+#endif
+
+    // The blocked QR algorithms
+    {
+        const ptrdiff_t ns[] = { 32, 48, 64, 96, 128, 192, 256, 384 };
+        QRTest<T> f;
+        n = FindCrossover(
+            "qr_min_blocked (n^2*sizeof(T))",f,
+            &tmv::TuningProfile::qr_min_blocked,Sizes(ns,8),0,never);
+        tune.qr_min_blocked = n < 0 ? never : n*n*sizeof(T);
+    }
+
+    // The recursive QR algorithm vs the block algorithm.
+    // Here the recursive algorithm is the one for smaller sizes.
+    {
+        const ptrdiff_t ns[] = { 64, 96, 128, 192, 256, 384, 512 };
+        QRTest<T> f;
+        tmv::TuningProfile save = tmv::GetTuning();
+        tmv::GetTuning().qr_min_blocked = 0;
+        n = FindCrossover(
+            "qr_max_recursive",f,
+            &tmv::TuningProfile::qr_max_recursive,Sizes(ns,7),0,never);
+        tmv::SetTuning(save);
+        tune.qr_max_recursive = n < 0 ? never : n-1;
+    }
+
+    {
+        const ptrdiff_t ns[] = { 32, 48, 64, 96, 128, 192, 256, 384 };
+        QRPTest<T> f;
+        n = FindCrossover(
+            "qrp_min_blocked (n^2*sizeof(T))",f,
+            &tmv::TuningProfile::qrp_min_blocked,Sizes(ns,8),0,never);
+        tune.qrp_min_blocked = n < 0 ? never : n*n*sizeof(T);
+    }
+
+    {
+        const ptrdiff_t ns[] = { 32, 48, 64, 96, 128, 192, 256, 384 };
+        BidiagTest<T> f;
+        n = FindCrossover(
+            "bidiag_min_blocked (n^2*sizeof(T))",f,
+            &tmv::TuningProfile::bidiag_min_blocked,Sizes(ns,8),0,never);
+        tune.bidiag_min_blocked = n < 0 ? never : n*n*sizeof(T);
+    }
+
+    tmv::SetTuning(tune);
+    std::cout<<std::endl;
+    tmv::WriteTuning(std::cout,tune);
+    if (!tmv::SaveTuning(file)) {
+        std::cerr<<"Unable to write "<<file<<std::endl;
+        return 1;
+    }
+    std::cout<<"\nWrote tuning profile to "<<file<<std::endl;
+    return 0;
+}
+catch (std::exception& e) {
+    std::cerr<<e.what()<<std::endl;
+    return 1;
+}
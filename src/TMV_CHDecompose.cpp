@@ -0,0 +1,41 @@
+
+//#define PRINTALGO_CH
+
+#include "tmv/TMV_CHDecompose.h"
+#include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_TriMatrix.h"
+#include "tmv/TMV_SmallTriMatrix.h"
+#include "tmv/TMV_Vector.h"
+#include "tmv/TMV_CopyM.h"
+#include "tmv/TMV_ScaleV.h"
+#include "tmv/TMV_MultMM_Block.h"
+#include "tmv/TMV_MultMM_Winograd.h"
+#include "tmv/TMV_DivMU.h"
+#include "tmv/TMV_MultXU.h"
+#include "tmv/TMV_MultMV.h"
+
+namespace tmv {
+
+    template <class T> 
+    void InstCH_Decompose(MatrixView<T> A)
+    {
+        if (A.colsize() > 0) {
+            if (A.iscm()) {
+                MatrixView<T,ColMajor> Acm = A;
+                InlineCH_Decompose(Acm);
+            } else {
+                CHDecompose_Trace<Unknown,MatrixView<T> > trace(81,A);
+                Matrix<T,ColMajor|NoDivider> Ac = A;
+                InstCH_Decompose(Ac.xView());
+                InstCopy(Ac.constView().xView(),A);
+            }
+        }
+    }
+
+#define InstFile "TMV_CHDecompose.inst"
+#include "TMV_Inst.h"
+#undef InstFile
+
+} // namespace tmv
+
+
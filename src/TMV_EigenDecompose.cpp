@@ -0,0 +1,70 @@
+
+//#define PRINTALGO_EIGEN
+
+#include "tmv/TMV_EigenDecompose.h"
+#include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_SmallMatrix.h"
+#include "tmv/TMV_Vector.h"
+#include "tmv/TMV_SmallVector.h"
+#include "tmv/TMV_CopyM.h"
+#include "tmv/TMV_ProdMV.h"
+#include "tmv/TMV_ProdMM.h"
+#include "tmv/TMV_ProdXV.h"
+#include "tmv/TMV_ScaleM.h"
+#include "tmv/TMV_ScaleV.h"
+#include "tmv/TMV_MultMM.h"
+#include "tmv/TMV_MultXM.h"
+#include "tmv/TMV_MinMax.h"
+#include "tmv/TMV_SwapV.h"
+#include "tmv/TMV_SortV.h"
+#include "tmv/TMV_Norm.h"
+#include "tmv/TMV_NormV.h"
+#include "tmv/TMV_MultPV.h"
+#include "tmv/TMV_MultPM.h"
+#include "tmv/TMV_PermuteM.h"
+#include "tmv/TMV_SumVV.h"
+#include "tmv/TMV_SumMM.h"
+#include "tmv/TMV_ProdVV.h"
+#include "tmv/TMV_PackedQ.h"
+
+namespace tmv {
+
+    template <class T, class RT>
+    void InstEigen_Decompose(
+        MatrixView<T> A, VectorView<RT> lambda, bool StoreZ)
+    {
+        if (A.colsize() > 0) {
+            if (A.iscm()) {
+                MatrixView<T,ColMajor> Acm = A;
+                InlineEigen_Decompose(Acm,lambda,StoreZ);
+            } else {
+                Matrix<T,ColMajor|NoDivider> Ac = A;
+                InstEigen_Decompose(Ac.xView(),lambda,StoreZ);
+                InstCopy(Ac.constView().xView(),A);
+            }
+        }
+    }
+
+    template <class T, class RT>
+    void InstEigen_DecomposeLargest(
+        MatrixView<T> A, MatrixView<T> Z, VectorView<RT> lambda)
+    {
+        if (A.colsize() > 0 && lambda.size() > 0) {
+            if (A.iscm()) {
+                MatrixView<T,ColMajor> Acm = A;
+                InlineEigen_DecomposeLargest(Acm,Z,lambda);
+            } else {
+                Matrix<T,ColMajor|NoDivider> Ac = A;
+                InstEigen_DecomposeLargest(Ac.xView(),Z,lambda);
+                InstCopy(Ac.constView().xView(),A);
+            }
+        }
+    }
+
+#define InstFile "TMV_EigenDecompose.inst"
+#include "TMV_Inst.h"
+#undef InstFile
+
+} // namespace tmv
+
+
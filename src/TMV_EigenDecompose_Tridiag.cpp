@@ -0,0 +1,59 @@
+
+//#define PRINTALGO_EIGEN
+
+#include "tmv/TMV_EigenDecompose_Tridiag.h"
+#include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_Vector.h"
+#include "tmv/TMV_TriMatrix.h"
+#include "tmv/TMV_SmallTriMatrix.h"
+#include "tmv/TMV_SmallVector.h"
+#include "tmv/TMV_CopyM.h"
+#include "tmv/TMV_MultMV.h"
+#include "tmv/TMV_MultMM.h"
+#include "tmv/TMV_ProdVV.h"
+#include "tmv/TMV_ScaleV.h"
+#include "tmv/TMV_ProdMV.h"
+#include "tmv/TMV_ProdXV.h"
+#include "tmv/TMV_SumVV.h"
+#include "tmv/TMV_SumMM.h"
+#include "tmv/TMV_MultUV.h"
+#include "tmv/TMV_MultXU.h"
+#include "tmv/TMV_MultSV.h"
+#include "tmv/TMV_RankKMMS.h"
+
+namespace tmv {
+
+    template <class T, class RT>
+    void InstTridiagonalize(
+        MatrixView<T> A, VectorView<RT> beta,
+        VectorView<RT> D, VectorView<T> E)
+    {
+        if (A.colsize() > 0) {
+            if (A.iscm() && beta.step() == 1 && D.step() == 1 &&
+                E.step() == 1) {
+                MatrixView<T,ColMajor> Acm = A;
+                VectorView<RT,Unit> bu = beta;
+                VectorView<RT,Unit> Du = D;
+                VectorView<T,Unit> Eu = E;
+                InlineTridiagonalize(Acm,bu,Du,Eu);
+            } else {
+                Matrix<T,ColMajor|NoDivider> Ac = A;
+                Vector<RT> b2(beta.size());
+                Vector<RT> D2(D.size());
+                Vector<T> E2(E.size());
+                InstTridiagonalize(Ac.xView(),b2.xView(),D2.xView(),E2.xView());
+                InstCopy(Ac.constView().xView(),A);
+                beta = b2;
+                D = D2;
+                E = E2;
+            }
+        }
+    }
+
+#define InstFile "TMV_EigenDecompose_Tridiag.inst"
+#include "TMV_Inst.h"
+#undef InstFile
+
+} // namespace tmv
+
+
@@ -0,0 +1,246 @@
+//#define PRINTALGO_LDL
+
+#include "tmv/TMV_LDLD.h"
+#include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_TriMatrix.h"
+#include "tmv/TMV_SmallTriMatrix.h"
+#include "tmv/TMV_Vector.h"
+#include "tmv/TMV_SmallVector.h"
+#include "tmv/TMV_Norm.h"
+#include "tmv/TMV_NormM.h"
+#include "tmv/TMV_MultUL.h"
+#include "tmv/TMV_MultPM.h"
+#include "tmv/TMV_MultPV.h"
+#include "tmv/TMV_ProdMM.h"
+#include "tmv/TMV_SumMM.h"
+#include "tmv/TMV_AddMM.h"
+#include "tmv/TMV_LDLDecompose.h"
+#include "tmv/TMV_LDLDiv.h"
+#include "tmv/TMV_CopyM.h"
+#include "tmv/TMV_SmallMatrix.h"
+#include "tmv/TMV_ConjugateV.h"
+#include "tmv/TMV_Det.h"
+#include "tmv/TMV_ScaleM.h"
+#include "tmv/TMV_MultMM.h"
+#include "tmv/TMV_MultMM_Block.h"
+#include "tmv/TMV_MultMM_Winograd.h"
+#include "tmv/TMV_MultMM_Packed.h"
+#include "tmv/TMV_MultMM_OpenMP.h"
+#include "tmv/TMV_PermuteM.h"
+#include "tmv/TMV_TransposeM.h"
+#include "tmv/TMV_CopyU.h"
+#include "tmv/TMV_DivVU.h"
+#include "tmv/TMV_DivMU.h"
+#include "tmv/TMV_MultXU.h"
+
+namespace tmv {
+
+
+    template <class T> template <int C>
+    InstLDLD<T>::InstLDLD(const ConstMatrixView<T,C>& A, bool _inplace) : 
+        base(A,_inplace) {}
+    template <class T> 
+    InstLDLD<T>::InstLDLD(const InstLDLD<T>& rhs) : base(rhs) {}
+    template <class T> 
+    InstLDLD<T>::~InstLDLD() {}
+
+    template <class T> 
+    void InstLDLD<T>::doSolveInPlace(MatrixView<RT> m2) const 
+    { base::solveInPlace(m2);  }
+    template <class T> 
+    void InstLDLD<T>::doSolveInPlace(MatrixView<CT> m2) const 
+    { base::solveInPlace(m2);  }
+    template <class T> 
+    void InstLDLD<T>::doSolveInPlace(MatrixView<CT,Conj> m2) const 
+    { base::solveInPlace(m2);  }
+    template <class T> 
+    void InstLDLD<T>::doSolveInPlace(VectorView<RT> v2) const 
+    { base::solveInPlace(v2);  }
+    template <class T> 
+    void InstLDLD<T>::doSolveInPlace(VectorView<CT> v2) const 
+    { base::solveInPlace(v2);  }
+    template <class T> 
+    void InstLDLD<T>::doSolveInPlace(VectorView<CT,Conj> v2) const 
+    { base::solveInPlace(v2);  }
+
+    template <class T> 
+    void InstLDLD<T>::doSolveTransposeInPlace(MatrixView<RT> m2) const 
+    { base::solveTransposeInPlace(m2); } 
+    template <class T> 
+    void InstLDLD<T>::doSolveTransposeInPlace(MatrixView<CT> m2) const 
+    { base::solveTransposeInPlace(m2); } 
+    template <class T> 
+    void InstLDLD<T>::doSolveTransposeInPlace(MatrixView<CT,Conj> m2) const 
+    { base::solveTransposeInPlace(m2); } 
+    template <class T> 
+    void InstLDLD<T>::doSolveTransposeInPlace(VectorView<RT> v2) const 
+    { base::solveTransposeInPlace(v2); } 
+    template <class T> 
+    void InstLDLD<T>::doSolveTransposeInPlace(VectorView<CT> v2) const 
+    { base::solveTransposeInPlace(v2); } 
+    template <class T> 
+    void InstLDLD<T>::doSolveTransposeInPlace(VectorView<CT,Conj> v2) const 
+    { base::solveTransposeInPlace(v2); } 
+
+    template <class T> 
+    void InstLDLD<T>::doSolve(
+        const ConstMatrixView<RT>& m1, MatrixView<RT> m2) const 
+    { base::solve(m1,m2); } 
+    template <class T> 
+    void InstLDLD<T>::doSolve(
+        const ConstMatrixView<RT>& m1, MatrixView<CT> m2) const 
+    { base::solve(m1,m2); } 
+    template <class T> 
+    void InstLDLD<T>::doSolve(
+        const ConstMatrixView<RT>& m1, MatrixView<CT,Conj> m2) const 
+    { base::solve(m1,m2); } 
+    template <class T> 
+    void InstLDLD<T>::doSolve(
+        const ConstMatrixView<CT>& m1, MatrixView<CT> m2) const 
+    { base::solve(m1,m2); } 
+    template <class T> 
+    void InstLDLD<T>::doSolve(
+        const ConstMatrixView<CT>& m1, MatrixView<CT,Conj> m2) const 
+    { base::solve(m1,m2); } 
+    template <class T> 
+    void InstLDLD<T>::doSolve(
+        const ConstMatrixView<CT,Conj>& m1, MatrixView<CT> m2) const 
+    { base::solve(m1,m2); } 
+    template <class T> 
+    void InstLDLD<T>::doSolve(
+        const ConstMatrixView<CT,Conj>& m1, MatrixView<CT,Conj> m2) const 
+    { base::solve(m1,m2); } 
+    template <class T> 
+    void InstLDLD<T>::doSolve(
+        const ConstVectorView<RT>& v1, VectorView<RT> v2) const 
+    { base::solve(v1,v2); } 
+    template <class T> 
+    void InstLDLD<T>::doSolve(
+        const ConstVectorView<RT>& v1, VectorView<CT> v2) const 
+    { base::solve(v1,v2); } 
+    template <class T> 
+    void InstLDLD<T>::doSolve(
+        const ConstVectorView<RT>& v1, VectorView<CT,Conj> v2) const 
+    { base::solve(v1,v2); } 
+    template <class T> 
+    void InstLDLD<T>::doSolve(
+        const ConstVectorView<CT>& v1, VectorView<CT> v2) const 
+    { base::solve(v1,v2); } 
+    template <class T> 
+    void InstLDLD<T>::doSolve(
+        const ConstVectorView<CT>& v1, VectorView<CT,Conj> v2) const 
+    { base::solve(v1,v2); } 
+    template <class T> 
+    void InstLDLD<T>::doSolve(
+        const ConstVectorView<CT,Conj>& v1, VectorView<CT> v2) const 
+    { base::solve(v1,v2); } 
+    template <class T> 
+    void InstLDLD<T>::doSolve(
+        const ConstVectorView<CT,Conj>& v1, VectorView<CT,Conj> v2) const 
+    { base::solve(v1,v2); } 
+
+    template <class T> 
+    void InstLDLD<T>::doSolveTranspose(
+        const ConstMatrixView<RT>& m1, MatrixView<RT> m2) const 
+    { base::solveTranspose(m1,m2); }
+    template <class T> 
+    void InstLDLD<T>::doSolveTranspose(
+        const ConstMatrixView<RT>& m1, MatrixView<CT> m2) const 
+    { base::solveTranspose(m1,m2); }
+    template <class T> 
+    void InstLDLD<T>::doSolveTranspose(
+        const ConstMatrixView<RT>& m1, MatrixView<CT,Conj> m2) const 
+    { base::solveTranspose(m1,m2); }
+    template <class T> 
+    void InstLDLD<T>::doSolveTranspose(
+        const ConstMatrixView<CT>& m1, MatrixView<CT> m2) const 
+    { base::solveTranspose(m1,m2); }
+    template <class T> 
+    void InstLDLD<T>::doSolveTranspose(
+        const ConstMatrixView<CT>& m1, MatrixView<CT,Conj> m2) const 
+    { base::solveTranspose(m1,m2); }
+    template <class T> 
+    void InstLDLD<T>::doSolveTranspose(
+        const ConstMatrixView<CT,Conj>& m1, MatrixView<CT> m2) const 
+    { base::solveTranspose(m1,m2); }
+    template <class T> 
+    void InstLDLD<T>::doSolveTranspose(
+        const ConstMatrixView<CT,Conj>& m1, MatrixView<CT,Conj> m2) const 
+    { base::solveTranspose(m1,m2); }
+    template <class T> 
+    void InstLDLD<T>::doSolveTranspose(
+        const ConstVectorView<RT>& v1, VectorView<RT> v2) const 
+    { base::solveTranspose(v1,v2); }
+    template <class T> 
+    void InstLDLD<T>::doSolveTranspose(
+        const ConstVectorView<RT>& v1, VectorView<CT> v2) const 
+    { base::solveTranspose(v1,v2); }
+    template <class T> 
+    void InstLDLD<T>::doSolveTranspose(
+        const ConstVectorView<RT>& v1, VectorView<CT,Conj> v2) const 
+    { base::solveTranspose(v1,v2); }
+    template <class T> 
+    void InstLDLD<T>::doSolveTranspose(
+        const ConstVectorView<CT>& v1, VectorView<CT> v2) const 
+    { base::solveTranspose(v1,v2); }
+    template <class T> 
+    void InstLDLD<T>::doSolveTranspose(
+        const ConstVectorView<CT>& v1, VectorView<CT,Conj> v2) const 
+    { base::solveTranspose(v1,v2); }
+    template <class T> 
+    void InstLDLD<T>::doSolveTranspose(
+        const ConstVectorView<CT,Conj>& v1, VectorView<CT> v2) const 
+    { base::solveTranspose(v1,v2); }
+    template <class T> 
+    void InstLDLD<T>::doSolveTranspose(
+        const ConstVectorView<CT,Conj>& v1, VectorView<CT,Conj> v2) const 
+    { base::solveTranspose(v1,v2); }
+
+    template <class T> 
+    T InstLDLD<T>::det() const
+    { return base::det(); }
+    template <class T> 
+    typename InstLDLD<T>::FT InstLDLD<T>::logDet(
+        typename InstLDLD<T>::ZFT* sign) const
+    { return base::logDet(sign); }
+    template <class T> 
+    bool InstLDLD<T>::isSingular() const
+    { return base::isSingular(); }
+
+    template <class T> 
+    void InstLDLD<T>::doMakeInverse(MatrixView<RT> minv) const 
+    { base::makeInverse(minv); } 
+    template <class T> 
+    void InstLDLD<T>::doMakeInverse(MatrixView<CT> minv) const 
+    { base::makeInverse(minv); } 
+    template <class T> 
+    void InstLDLD<T>::doMakeInverse(MatrixView<CT,Conj> minv) const 
+    { base::makeInverse(minv); } 
+
+    template <class T> 
+    void InstLDLD<T>::doMakeInverseATA(MatrixView<RT> ata) const
+    { base::makeInverseATA(ata); }
+    template <class T> 
+    void InstLDLD<T>::doMakeInverseATA(MatrixView<CT> ata) const
+    { base::makeInverseATA(ata); }
+    template <class T> 
+    void InstLDLD<T>::doMakeInverseATA(MatrixView<CT,Conj> ata) const
+    { base::makeInverseATA(ata); }
+
+    template <class T> 
+    typename InstLDLD<T>::RT InstLDLD<T>::condition(
+        typename InstLDLD<T>::RT normInf) const
+    { return base::condition(normInf); }
+
+    template <class T> 
+    bool InstLDLD<T>::preferInPlace() const
+    { return base::preferInPlace(); }
+
+
+#define InstFile "TMV_LDLD.inst"
+#include "TMV_Inst.h"
+#undef InstFile
+
+} // namespace tmv
+
+
@@ -0,0 +1,47 @@
+
+//#define PRINTALGO_LDL
+
+#include "tmv/TMV_LDLDecompose.h"
+#include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_TriMatrix.h"
+#include "tmv/TMV_SmallTriMatrix.h"
+#include "tmv/TMV_Vector.h"
+#include "tmv/TMV_CopyM.h"
+#include "tmv/TMV_CopyV.h"
+#include "tmv/TMV_SwapV.h"
+#include "tmv/TMV_ScaleV.h"
+#include "tmv/TMV_MinMax.h"
+#include "tmv/TMV_PermuteM.h"
+#include "tmv/TMV_MultMM_Block.h"
+#include "tmv/TMV_MultMM_Winograd.h"
+#include "tmv/TMV_MultXU.h"
+#include "tmv/TMV_MultMV.h"
+#include "tmv/TMV_MultXV.h"
+#include "tmv/TMV_MultXM.h"
+
+namespace tmv {
+
+    template <class T> 
+    void InstLDL_Decompose(
+        MatrixView<T> A, VectorView<T> xD, ptrdiff_t* P, bool herm)
+    {
+        if (A.colsize() > 0) {
+            if (A.iscm()) {
+                MatrixView<T,ColMajor> Acm = A;
+                if (herm) InlineLDL_Decompose<true>(Acm,xD,P);
+                else InlineLDL_Decompose<false>(Acm,xD,P);
+            } else {
+                Matrix<T,ColMajor|NoDivider> Ac = A;
+                InstLDL_Decompose(Ac.xView(),xD,P,herm);
+                InstCopy(Ac.constView().xView(),A);
+            }
+        }
+    }
+
+#define InstFile "TMV_LDLDecompose.inst"
+#include "TMV_Inst.h"
+#undef InstFile
+
+} // namespace tmv
+
+
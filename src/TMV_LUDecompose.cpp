@@ -121,9 +121,22 @@ namespace tmv {
 #ifdef ALAP
                 LapLU_Decompose(Acm,P);
 #else
-                InlineLU_Decompose(Acm,P);
+#ifdef _OPENMP
+                // As in MultMM, check omp_get_level() rather than 
+                // omp_in_parallel(), so we don't start a nested set of 
+                // tasks from within a parallel region.
+                if (omp_get_level() == 0 && omp_get_max_threads() > 1 &&
+                    TMV_MIN(A.colsize(),A.rowsize()) >= TMV_LU_OPENMP_THRESH) {
+                    const ptrdiff_t xx = Unknown;
+                    LUDecompose_Helper<31,xx,xx,MatrixView<T,ColMajor> >::call(
+                        Acm,P);
+                } else 
+#endif
+                    InlineLU_Decompose(Acm,P);
 #endif
             } else {
+                const ptrdiff_t xx = Unknown;
+                LUDecompose_Trace<xx,xx,MatrixView<T> > trace(81,A);
                 Matrix<T,ColMajor|NoDivider> Ac = A;
                 InstLU_Decompose(Ac.xView(),P);
                 InstCopy(Ac.constView().xView(),A);
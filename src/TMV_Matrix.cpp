@@ -17,6 +17,8 @@
 #include "tmv/TMV_QRD.h"
 #include "tmv/TMV_QRPD.h"
 #include "tmv/TMV_SVD.h"
+#include "tmv/TMV_CHD.h"
+#include "tmv/TMV_LDLD.h"
 
 namespace tmv {
 
@@ -635,7 +637,8 @@ namespace tmv {
         if (!this->divIsSet()) {
             DivType dt = this->getDivType();
             TMVAssert(dt == tmv::LU || dt == tmv::QR || 
-                      dt == tmv::QRP || dt == tmv::SV);
+                      dt == tmv::QRP || dt == tmv::SV ||
+                      dt == tmv::CH || dt == tmv::LDL);
             switch (dt) {
               case tmv::LU : 
                    this->divider.reset(new InstLUD<T>(
@@ -653,6 +656,14 @@ namespace tmv {
                    this->divider.reset(new InstSVD<T>(
                        this->getConstView(),this->divIsInPlace()));
                    break;
+              case tmv::CH : 
+                   this->divider.reset(new InstCHD<T>(
+                       this->getConstView(),this->divIsInPlace()));
+                   break;
+              case tmv::LDL : 
+                   this->divider.reset(new InstLDLD<T>(
+                       this->getConstView(),this->divIsInPlace()));
+                   break;
               default :
                    // The above assert should have already failed.
                    // So go ahead and fall through.
@@ -697,6 +708,24 @@ namespace tmv {
         return static_cast<const InstSVD<T>&>(*this->getDiv());
     }
 
+    template <class T>
+    const InstCHD<T>& MatrixDivHelper2<T>::chd() const
+    {
+        this->divideUsing(CH);
+        setDiv();
+        TMVAssert(dynamic_cast<const InstCHD<T>*>(this->getDiv()));
+        return static_cast<const InstCHD<T>&>(*this->getDiv());
+    }
+
+    template <class T>
+    const InstLDLD<T>& MatrixDivHelper2<T>::ldld() const
+    {
+        this->divideUsing(LDL);
+        setDiv();
+        TMVAssert(dynamic_cast<const InstLDLD<T>*>(this->getDiv()));
+        return static_cast<const InstLDLD<T>&>(*this->getDiv());
+    }
+
 #define InstFile "TMV_Matrix.inst"
 #include "TMV_Inst.h"
 #undef InstFile
@@ -6,6 +6,7 @@
 #include "tmv/TMV_MultMM_OpenMP.h"
 #include "tmv/TMV_MultMM_Block.h"
 #include "tmv/TMV_MultMM_Winograd.h"
+#include "tmv/TMV_MultMM_Packed.h"
 #include "tmv/TMV_Matrix.h"
 #include "tmv/TMV_Vector.h"
 
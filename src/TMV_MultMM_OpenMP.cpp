@@ -3,6 +3,7 @@
 #include "tmv/TMV_MultMM_OpenMP.h"
 #include "tmv/TMV_MultMM.h"
 #include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_Vector.h"
 
 namespace tmv {
 
@@ -0,0 +1,43 @@
+
+#include "TMV_Blas.h"
+#include "tmv/TMV_MultMM.h"
+#include "tmv/TMV_MultMM_Packed.h"
+#include "tmv/TMV_MultMM_Block.h"
+#include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_Vector.h"
+
+namespace tmv {
+
+    template <class T1, int C1, class T2, int C2, class T3>
+    void InstMultMM_Packed(
+        const T3 x,
+        const ConstMatrixView<T1,C1>& m1,
+        const ConstMatrixView<T2,C2>& m2, MatrixView<T3> m3)
+    {
+#if !defined(BLAS)
+        InlineMultMM_Packed<false>(Scaling<0,T3>(x),m1,m2,m3); 
+#else
+        InstMultMM(x,m1,m2,m3); 
+#endif
+    }
+
+    template <class T1, int C1, class T2, int C2, class T3>
+    void InstAddMultMM_Packed(
+        const T3 x,
+        const ConstMatrixView<T1,C1>& m1,
+        const ConstMatrixView<T2,C2>& m2, MatrixView<T3> m3)
+    {
+#if !defined(BLAS)
+        InlineMultMM_Packed<true>(Scaling<0,T3>(x),m1,m2,m3); 
+#else
+        InstAddMultMM(x,m1,m2,m3); 
+#endif
+    }
+
+#define InstFile "TMV_MultMM_Packed.inst"
+#include "TMV_Inst.h"
+#undef InstFile
+
+} // namespace tmv
+
+
@@ -2,6 +2,7 @@
 #include "TMV_Blas.h"
 #include "tmv/TMV_MultMM.h"
 #include "tmv/TMV_MultMM_Winograd.h"
+#include "tmv/TMV_MultMM_Packed.h"
 #include "tmv/TMV_MultMM_Block.h"
 #include "tmv/TMV_ScaleM.h"
 #include "tmv/TMV_Matrix.h"
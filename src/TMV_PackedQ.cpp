@@ -19,6 +19,10 @@
 #include "tmv/TMV_SumVV.h"
 #include "tmv/TMV_OProdVV.h"
 
+#ifdef _OPENMP
+#include "omp.h"
+#endif
+
 #ifdef XDEBUG_QR
 #include <iostream>
 #include "TMV_MatrixIO.h"
@@ -758,6 +762,36 @@ namespace tmv {
 #endif
 #endif // LAP
 
+#ifdef _OPENMP
+    // Each column of m2 is independent, so for a matrix m2 with many
+    // columns, we can just split the columns up among the threads.
+    template <bool div, class M1, class V1, class T2>
+    static void ParallelPackedQ_MultEq(
+        const M1& Q, const V1& beta, MatrixView<T2> m2, ptrdiff_t nblocks)
+    {
+        const ptrdiff_t K = m2.rowsize();
+#pragma omp parallel for schedule(static)
+        for(ptrdiff_t i=0;i<nblocks;++i) {
+            MatrixView<T2> m2i = m2.colRange(i*K/nblocks,(i+1)*K/nblocks);
+            if (div) DoPackedQ_LDivEq(Q,beta,m2i);
+            else DoPackedQ_MultEq(Q,beta,m2i);
+        }
+    }
+
+    // Returns the number of column blocks to use, or 1 to not use OpenMP.
+    template <class M1, class M2>
+    static ptrdiff_t PackedQ_NBlocks(const M1& Q, const M2& m2)
+    {
+        if (omp_get_level() > 0) return 1;
+        const ptrdiff_t M = Q.colsize();
+        const ptrdiff_t N = Q.rowsize();
+        const ptrdiff_t K = m2.rowsize();
+        if (M*N*K < TMV_QR_OPENMP_THRESH) return 1;
+        return TMV_MAX(ptrdiff_t(1),TMV_MIN(
+                ptrdiff_t(omp_get_max_threads()),K/TMV_QR_OPENMP_MINCOLS));
+    }
+#endif
+
     template <class T1, int C1, class RT1, class T2>
     void InstPackedQ_MultEq(
         const ConstMatrixView<T1,C1>& Q, const ConstVectorView<RT1>& beta,
@@ -774,7 +808,13 @@ namespace tmv {
         if (Q.isrm() || Q.iscm()) {
             if (beta.step() == 1) {
                 if (m2.iscm() || m2.isrm()) {
-                    DoPackedQ_MultEq(Q,beta,m2); 
+#ifdef _OPENMP
+                    const ptrdiff_t nblocks = PackedQ_NBlocks(Q,m2);
+                    if (nblocks > 1)
+                        ParallelPackedQ_MultEq<false>(Q,beta,m2,nblocks);
+                    else
+#endif
+                        DoPackedQ_MultEq(Q,beta,m2); 
                 } else {
                     Matrix<T2,ColMajor|NoDivider> m2c = m2;
                     InstPackedQ_MultEq(Q,beta,m2c.xView());
@@ -813,7 +853,13 @@ namespace tmv {
         if (Q.isrm() || Q.iscm()) {
             if (beta.step() == 1) {
                 if (m2.iscm() || m2.isrm()) {
-                    DoPackedQ_LDivEq(Q,beta,m2); 
+#ifdef _OPENMP
+                    const ptrdiff_t nblocks = PackedQ_NBlocks(Q,m2);
+                    if (nblocks > 1)
+                        ParallelPackedQ_MultEq<true>(Q,beta,m2,nblocks);
+                    else
+#endif
+                        DoPackedQ_LDivEq(Q,beta,m2); 
                 } else {
                     Matrix<T2,ColMajor|NoDivider> m2c = m2;
                     InstPackedQ_LDivEq(Q,beta,m2c.xView());
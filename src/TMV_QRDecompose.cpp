@@ -20,11 +20,19 @@
 #include "tmv/TMV_MultMM.h"
 #include "tmv/TMV_CopyU.h"
 #include "tmv/TMV_MultUM.h"
+#include "tmv/TMV_UnpackQ.h"
+#include "tmv/TMV_DivMU.h"
 
 #include "tmv/TMV_ProdVV.h"
 #include "tmv/TMV_ProdXM.h"
 #include "tmv/TMV_ProdMM.h"
 #include "tmv/TMV_ProdMV.h"
+#include "tmv/TMV_OProdVV.h"
+
+#ifdef _OPENMP
+#include "omp.h"
+#include <vector>
+#endif
 
 namespace tmv {
 
@@ -180,14 +188,230 @@ namespace tmv {
 #endif
 #endif // LAP
 
+#ifdef _OPENMP
+    // TSQR_Decompose does the QR decomposition of a tall, skinny matrix
+    // (M >> N) with the communication-avoiding "TSQR" algorithm, using
+    // OpenMP to do the different parts at the same time.
+    //
+    // The rows of A are split into p blocks, one per thread, each with
+    // at least 2N rows.  Each block is decomposed separately:
+    //
+    // A_i = Q_i R_i
+    //
+    // Then the R_i are combined pairwise in a binary tree:
+    //
+    // ( R_i     ) = Q_i,i+s R_i'
+    // ( R_i+s   )
+    //
+    // until we are left with a single R at the root.  At each level of 
+    // the tree, the different pairs are done in parallel.
+    //
+    // The result is A = Q R with Q represented as the tree of the Q_i's.
+    // However, the rest of TMV expects the usual packed Householder 
+    // form, so we need to convert Q into that form.  We do this with the
+    // "Householder reconstruction" of Ballard et al (2014):
+    //
+    // First we form the explicit M x N matrix Q in place of A.  This is
+    // done from the root of the tree down to the leaves, since each
+    // node just multiplies its (unpacked) Q by the N x N block of its
+    // parent's Q that corresponds to it.
+    //
+    // Then if Q = H0 H1 ... HN-1 (I 0)T is the product of Householder 
+    // reflections, which in block form is Q = (I - Y Z Yt) (I 0)T, 
+    // we can write:
+    //
+    // Q - (I 0)T = -Y Z Y1t
+    //
+    // where Y1 is the top N x N part of Y.  Y is unit lower trapezoidal,
+    // and Z Y1t is upper triangular, so this is just an LU decomposition
+    // (without pivoting) of Q - (I 0)T.  And the diagonal of -Z Y1t is 
+    // -Z, whose diagonal elements are the beta values.
+    //
+    // The Q we get from TSQR is not necessarily the same as the 
+    // Householder Q.  They can differ by a diagonal matrix of phases:
+    // Q_house = Q D.  We are free to choose D however we want, so at 
+    // each step of the LU decomposition, we choose the phase that makes
+    // the pivot real and negative, -(1+|q_jj|).  This means the beta
+    // values are real as TMV requires, and the pivots are all at least 1 
+    // in absolute value, so the LU decomposition is stable without any
+    // pivoting.  Then R_house = Dt R.
+    //
+    // The LU decomposition of the top N x N block is done by one thread,
+    // and then the rest of the rows are just Y2 = Q2 D U^-1, which is 
+    // done by all the threads on separate blocks of rows.
+    //
+    // This uses about three times as many flops as the normal QR 
+    // decomposition, but almost all of them are done in parallel, 
+    // and each thread only works on its own rows of A for the parts that 
+    // scale with M.
+    //
+    // This is recorded as algo 41 in the algorithm trace.
+    template <class T, class RT>
+    static void TSQR_Decompose(MatrixView<T,ColMajor> A, VectorView<RT> beta)
+    {
+        const ptrdiff_t M = A.colsize();
+        const ptrdiff_t N = A.rowsize();
+        TMVAssert(M >= 4*N);
+        TMVAssert(beta.size() == N);
+        const ptrdiff_t xx = Unknown;
+        QRDecompose_Trace<xx,xx,MatrixView<T,ColMajor> > trace(41,A);
+
+        // The number of leaves.  Each one needs at least 2N rows.
+        const ptrdiff_t p = TMV_MIN(ptrdiff_t(omp_get_max_threads()),M/(2*N));
+        TMVAssert(p >= 2);
+        std::vector<ptrdiff_t> rb(p+1);
+        for(ptrdiff_t i=0;i<=p;++i) rb[i] = i*M/p;
+
+        // The tree nodes.  Level l has nodes (i,i+s) with s = 2^l
+        // for i = 0, 2s, 4s, ... as long as i+s < p.
+        std::vector<ptrdiff_t> nodei, nodes, levelstart;
+        for(ptrdiff_t s=1;s<p;s*=2) {
+            levelstart.push_back(nodei.size());
+            for(ptrdiff_t i=0;i+s<p;i+=2*s) {
+                nodei.push_back(i);
+                nodes.push_back(s);
+            }
+        }
+        const ptrdiff_t nlevels = levelstart.size();
+        const ptrdiff_t nnodes = nodei.size();
+        levelstart.push_back(nnodes);
+
+        Matrix<RT,ColMajor|NoDivider> leafbeta(N,p);
+        Matrix<T,ColMajor|NoDivider> Rs(N,p*N);  // The R for each leaf
+        Matrix<T,ColMajor|NoDivider> Bs(N,p*N);  // The Q block for each leaf
+        Matrix<T,ColMajor|NoDivider> nodeQ(2*N,nnodes*N);
+        Matrix<RT,ColMajor|NoDivider> nodebeta(N,nnodes);
+        Vector<T> D(N);
+        // The number of rows to do at a time in the row-wise steps.
+        const ptrdiff_t Nr = 256;
+
+#pragma omp parallel
+        {
+            // Decompose each leaf.
+#pragma omp for schedule(static,1)
+            for(ptrdiff_t i=0;i<p;++i) {
+                MatrixView<T> Ai = A.rowRange(rb[i],rb[i+1]);
+                InstQR_Decompose(Ai,leafbeta.col(i).xView());
+                MatrixView<T> Ri = Rs.colRange(i*N,(i+1)*N);
+                Ri.setZero();
+                Ri.upperTri() = Ai.rowRange(0,N).upperTri();
+            }
+
+            // Combine the R's up the tree.
+            for(ptrdiff_t l=0;l<nlevels;++l) {
+#pragma omp for schedule(static,1)
+                for(ptrdiff_t k=levelstart[l];k<levelstart[l+1];++k) {
+                    const ptrdiff_t i = nodei[k];
+                    const ptrdiff_t s = nodes[k];
+                    MatrixView<T> Qk = nodeQ.colRange(k*N,(k+1)*N);
+                    MatrixView<T> Ri = Rs.colRange(i*N,(i+1)*N);
+                    Qk.rowRange(0,N) = Ri;
+                    Qk.rowRange(N,2*N) = Rs.colRange((i+s)*N,(i+s+1)*N);
+                    InstQR_Decompose(Qk,nodebeta.col(k).xView());
+                    Ri.upperTri() = Qk.rowRange(0,N).upperTri();
+                }
+            }
+
+            // Now go back down the tree to get the Q block for each leaf.
+#pragma omp single
+            {
+                Bs.colRange(0,N).setToIdentity();
+            }
+            for(ptrdiff_t l=nlevels-1;l>=0;--l) {
+#pragma omp for schedule(static,1)
+                for(ptrdiff_t k=levelstart[l];k<levelstart[l+1];++k) {
+                    const ptrdiff_t i = nodei[k];
+                    const ptrdiff_t s = nodes[k];
+                    MatrixView<T> Qk = nodeQ.colRange(k*N,(k+1)*N);
+                    MatrixView<T> Bi = Bs.colRange(i*N,(i+1)*N);
+                    InstUnpackQ(Qk,nodebeta.col(k).constView().xView());
+                    Matrix<T,ColMajor|NoDivider> temp = Qk * Bi;
+                    Bi = temp.rowRange(0,N);
+                    Bs.colRange((i+s)*N,(i+s+1)*N) = temp.rowRange(N,2*N);
+                }
+            }
+
+            // Form the explicit Q for each leaf.  Do the product with 
+            // the leaf's B a block of rows at a time to keep the temporary
+            // small.
+#pragma omp for schedule(static,1)
+            for(ptrdiff_t i=0;i<p;++i) {
+                MatrixView<T> Ai = A.rowRange(rb[i],rb[i+1]);
+                InstUnpackQ(Ai,leafbeta.col(i).constView().xView());
+                ConstMatrixView<T> Bi = Bs.colRange(i*N,(i+1)*N);
+                const ptrdiff_t Mi = Ai.colsize();
+                Matrix<T,ColMajor|NoDivider> temp(TMV_MIN(Nr,Mi),N);
+                for(ptrdiff_t i1=0;i1<Mi;i1+=Nr) {
+                    const ptrdiff_t i2 = TMV_MIN(i1+Nr,Mi);
+                    MatrixView<T> tempi = temp.rowRange(0,i2-i1);
+                    tempi = Ai.rowRange(i1,i2) * Bi;
+                    Ai.rowRange(i1,i2) = tempi;
+                }
+            }
+
+            // The modified LU decomposition of the top N x N block.
+#pragma omp single
+            {
+                MatrixView<T> W = A.rowRange(0,N);
+                for(ptrdiff_t j=0;j<N;++j) {
+                    const T qjj = W.cref(j,j);
+                    const RT absq = TMV_ABS(qjj);
+                    const T d = absq == RT(0) ? T(-1) : -TMV_CONJ(qjj)/absq;
+                    D(j) = d;
+                    W.col(j) *= d;
+                    W.ref(j,j) -= RT(1);
+                    // W(j,j) = -(1+|qjj|)
+                    W.col(j,j+1,N) /= W.cref(j,j);
+                    W.subMatrix(j+1,N,j+1,N) -= 
+                        W.col(j,j+1,N) ^ W.row(j,j+1,N);
+                }
+            }
+
+            // Y2 = Q2 D U^-1
+            const ptrdiff_t M2 = M-N;
+            const ptrdiff_t nchunk = (M2-1)/(Nr)+1;
+#pragma omp for schedule(static)
+            for(ptrdiff_t c=0;c<nchunk;++c) {
+                const ptrdiff_t i1 = N + c*Nr;
+                const ptrdiff_t i2 = TMV_MIN(i1+Nr,M);
+                MatrixView<T> Y2 = A.rowRange(i1,i2);
+                for(ptrdiff_t j=0;j<N;++j) Y2.col(j) *= D(j);
+                //Y2 %= A.rowRange(0,N).upperTri();
+                MatrixView<T> Y2t = Y2.transpose();
+                TriLDivEq(Y2t,A.rowRange(0,N).upperTri().transpose());
+            }
+        }
+
+        // Finally, R_house = Dt R, and beta = -diag(U)
+        for(ptrdiff_t j=0;j<N;++j) beta(j) = -TMV_REAL(A.cref(j,j));
+        UpperTriMatrixView<T> R = A.rowRange(0,N).upperTri();
+        R = Rs.colRange(0,N).upperTri();
+        for(ptrdiff_t i=0;i<N;++i) R.row(i,i,N) *= TMV_CONJ(D(i));
+    }
+#endif
+
     template <class T, class RT> 
     void InstQR_Decompose(MatrixView<T> A, VectorView<RT> beta)
     {
         if (beta.step() == 1) {
             if (A.iscm()) {
                 MatrixView<T,ColMajor> Acm = A;
-                DoQR_Decompose(Acm,beta);
+#ifdef _OPENMP
+                // As in MultMM, check omp_get_level() rather than 
+                // omp_in_parallel(), so the leaves of the TSQR tree 
+                // don't try to use TSQR themselves.
+                const ptrdiff_t M = A.colsize();
+                const ptrdiff_t N = A.rowsize();
+                if (omp_get_level() == 0 && 
+                    omp_get_max_threads() >= TMV_QR_TSQR_MINTHREADS &&
+                    M >= TMV_QR_TSQR_RATIO*N && M*N >= TMV_QR_TSQR_MINSIZE)
+                    TSQR_Decompose(Acm,beta);
+                else
+#endif
+                    DoQR_Decompose(Acm,beta);
             } else {
+                const ptrdiff_t xx = Unknown;
+                QRDecompose_Trace<xx,xx,MatrixView<T> > trace(81,A);
                 Matrix<T,ColMajor|NoDivider> Ac = A;
                 InstQR_Decompose(Ac.xView(),beta);
                 InstCopy(Ac.constView().xView(),A);
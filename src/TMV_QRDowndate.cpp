@@ -18,6 +18,7 @@
 #include "tmv/TMV_MultMM.h"
 #include "tmv/TMV_MultMM_Block.h"
 #include "tmv/TMV_MultMM_Winograd.h"
+#include "tmv/TMV_MultMM_Packed.h"
 #include "tmv/TMV_MultMM_OpenMP.h"
 #include "tmv/TMV_CopyU.h"
 #include "tmv/TMV_MultUM.h"
@@ -17,6 +17,13 @@
 #include "tmv/TMV_MultUM.h"
 #include "tmv/TMV_MultUU.h"
 #include "tmv/TMV_MultUL.h"
+#include "tmv/TMV_PackedQ.h"
+
+#ifdef _OPENMP
+#include "omp.h"
+#include <cmath>
+#include <vector>
+#endif
 
 namespace tmv {
 
@@ -301,12 +308,63 @@ namespace tmv {
 #endif
 #endif // LAP
 
+#ifdef _OPENMP
+    // Column j of Q is H0 H1 ... Hj e_j, since the later Householder 
+    // matrices don't affect e_j.  So we can do separate blocks of 
+    // columns in parallel, each one with just the Householder matrices
+    // that it needs.  This needs a copy of the packed Householder vectors,
+    // since we are overwriting them as we go.
+    //
+    // The work for the block j1..j2 is proportional to j2*(j2-j1), so 
+    // we make the blocks smaller for larger j to even out the work.
+    template <class T, class RT>
+    static void ParallelUnpackQ(
+        MatrixView<T> Q, const ConstVectorView<RT>& beta, ptrdiff_t nblocks)
+    {
+        const ptrdiff_t N = Q.rowsize();
+        Matrix<T,ColMajor|NoDivider> Qp = Q;
+        Q.setZero();
+        Q.rowRange(0,N).setToIdentity();
+        std::vector<ptrdiff_t> jb(nblocks+1);
+        for(ptrdiff_t k=0;k<=nblocks;++k) 
+            jb[k] = ptrdiff_t(N*std::sqrt(double(k)/double(nblocks)));
+        jb[nblocks] = N;
+#pragma omp parallel for schedule(dynamic)
+        for(ptrdiff_t k=nblocks-1;k>=0;--k) {
+            const ptrdiff_t j1 = jb[k];
+            const ptrdiff_t j2 = jb[k+1];
+            if (j1 < j2) 
+                InstPackedQ_MultEq(
+                    Qp.colRange(0,j2).constView().xView(),beta.subVector(0,j2),
+                    Q.colRange(j1,j2));
+        }
+    }
+
+    // Returns the number of column blocks to use, or 1 to not use OpenMP.
+    // The blocks don't have exactly equal work, so we use a few per 
+    // thread and let the dynamic schedule even them out.
+    static ptrdiff_t UnpackQ_NBlocks(ptrdiff_t M, ptrdiff_t N)
+    {
+        if (omp_get_level() > 0) return 1;
+        if (M*N*N < TMV_QR_OPENMP_THRESH) return 1;
+        return TMV_MAX(ptrdiff_t(1),TMV_MIN(
+                ptrdiff_t(4*omp_get_max_threads()),
+                N/(2*TMV_QR_OPENMP_MINCOLS)));
+    }
+#endif
+
     template <class T, class RT> 
     void InstUnpackQ(MatrixView<T> Q, const ConstVectorView<RT>& beta)
     {
         if (beta.step() == 1) {
             if (Q.iscm()) {
-                DoUnpackQ(Q,beta);
+#ifdef _OPENMP
+                const ptrdiff_t nblocks = 
+                    UnpackQ_NBlocks(Q.colsize(),Q.rowsize());
+                if (nblocks > 1) ParallelUnpackQ(Q,beta,nblocks);
+                else
+#endif
+                    DoUnpackQ(Q,beta);
             } else {
                 Matrix<T,ColMajor|NoDivider> Qc = Q;
                 InstUnpackQ(Qc.xView(),beta);
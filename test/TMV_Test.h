@@ -131,7 +131,8 @@ static inline std::string Text(tmv::DivType d)
         d==tmv::CH ? "CH" :
         d==tmv::QR ? "QR" :
         d==tmv::QRP ? "QRP" :
-        d==tmv::SV ? "SV" : "XX";
+        d==tmv::SV ? "SV" :
+        d==tmv::LDL ? "LDL" : "XX";
 }
 
 static inline std::string Text(tmv::StorageType s)
@@ -143,6 +144,20 @@ static inline std::string Text(tmv::StorageType s)
         "NonMajor";
 }
 
+// Make a T from a real and imaginary part.  For real T, the imaginary
+// part is dropped, which lets the same test code fill both real and
+// complex matrices.
+template <class T>
+struct TestVal
+{ static T make(double re, double ) { return T(re); } };
+
+template <class T>
+struct TestVal<std::complex<T> >
+{
+    static std::complex<T> make(double re, double im)
+    { return std::complex<T>(re,im); }
+};
+
 extern bool XXDEBUG1;
 extern bool XXDEBUG2;
 extern bool XXDEBUG3;
@@ -36,6 +36,13 @@ int main() try {
 #ifdef TEST_DOUBLE
     TestVector<double>();
     TestMatrix<double>();
+    TestMatrixTranspose<double>();
+    TestMatrixMultMM<double>();
+    TestMemory<double>();
+    TestAlgoTrace<double>();
+    TestBinaryIO<double>();
+    TestTextIO<double>();
+    TestTuning<double>();
     TestPermutation<double>();
     TestDiagMatrix<double>();
     TestDiagDiv<double>();
@@ -43,11 +50,23 @@ int main() try {
     TestTriDiv<double>();
     TestMatrixDiv<double>();
     TestMatrixDet<double>();
+    TestMatrixEigen<double>();
+    TestBlockTridiagMatrix<double>();
+    TestTridiagMatrix<double>();
+    TestSymMatrix<double>();
+    TestBandLU<double>();
 #endif // DOUBLE
 
 #ifdef TEST_FLOAT
     TestVector<float>();
     TestMatrix<float>();
+    TestMatrixTranspose<float>();
+    TestMatrixMultMM<float>();
+    TestMemory<float>();
+    TestAlgoTrace<float>();
+    TestBinaryIO<float>();
+    TestTextIO<float>();
+    TestTuning<float>();
     TestPermutation<float>();
     TestDiagMatrix<float>();
     TestDiagDiv<float>();
@@ -55,6 +74,11 @@ int main() try {
     TestTriDiv<float>();
     TestMatrixDiv<float>();
     TestMatrixDet<float>();
+    TestMatrixEigen<float>();
+    TestBlockTridiagMatrix<float>();
+    TestTridiagMatrix<float>();
+    TestSymMatrix<float>();
+    TestBandLU<float>();
 #endif // FLOAT
 
 #ifdef TEST_INT
@@ -69,6 +93,9 @@ int main() try {
 #ifdef TEST_LONGDOUBLE
     TestVector<long double>();
     TestMatrix<long double>();
+    TestMatrixTranspose<long double>();
+    TestMatrixMultMM<long double>();
+    TestBinaryIO<long double>();
     TestPermutation<long double>();
     TestDiagMatrix<long double>();
     TestDiagDiv<long double>();
@@ -76,6 +103,11 @@ int main() try {
     TestTriDiv<long double>();
     TestMatrixDiv<long double>();
     TestMatrixDet<long double>();
+    TestMatrixEigen<long double>();
+    TestBlockTridiagMatrix<long double>();
+    TestTridiagMatrix<long double>();
+    TestSymMatrix<long double>();
+    TestBandLU<long double>();
 #endif // LONGDOUBLE
 
 #endif
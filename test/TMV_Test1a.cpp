@@ -36,18 +36,35 @@ int main() try {
 #ifdef TEST_DOUBLE
     TestVector<double>();
     TestMatrix<double>();
+    TestMatrixTranspose<double>();
+    TestMatrixMultMM<double>();
+    TestMemory<double>();
+    TestAlgoTrace<double>();
+    TestBinaryIO<double>();
+    TestTextIO<double>();
+    TestTuning<double>();
     TestPermutation<double>();
 #endif // DOUBLE
 
 #ifdef TEST_FLOAT
     TestVector<float>();
     TestMatrix<float>();
+    TestMatrixTranspose<float>();
+    TestMatrixMultMM<float>();
+    TestMemory<float>();
+    TestAlgoTrace<float>();
+    TestBinaryIO<float>();
+    TestTextIO<float>();
+    TestTuning<float>();
     TestPermutation<float>();
 #endif // FLOAT
 
 #ifdef TEST_LONGDOUBLE
     TestVector<long double>();
     TestMatrix<long double>();
+    TestMatrixTranspose<long double>();
+    TestMatrixMultMM<long double>();
+    TestBinaryIO<long double>();
     TestPermutation<long double>();
 #endif // LONGDOUBLE
 
@@ -35,12 +35,24 @@ int main() try {
 
 #ifdef TEST_DOUBLE
     TestMatrixDiv<double>();
+    TestMatrixOpenMP<double>();
     TestMatrixDet<double>();
+    TestMatrixEigen<double>();
+    TestBlockTridiagMatrix<double>();
+    TestTridiagMatrix<double>();
+    TestSymMatrix<double>();
+    TestBandLU<double>();
 #endif // DOUBLE
 
 #ifdef TEST_FLOAT
     TestMatrixDiv<float>();
+    TestMatrixOpenMP<float>();
     TestMatrixDet<float>();
+    TestMatrixEigen<float>();
+    TestBlockTridiagMatrix<float>();
+    TestTridiagMatrix<float>();
+    TestSymMatrix<float>();
+    TestBandLU<float>();
 #endif // FLOAT
 
 #ifdef TEST_INT
@@ -50,6 +62,11 @@ int main() try {
 #ifdef TEST_LONGDOUBLE
     TestMatrixDiv<long double>();
     TestMatrixDet<long double>();
+    TestMatrixEigen<long double>();
+    TestBlockTridiagMatrix<long double>();
+    TestTridiagMatrix<long double>();
+    TestSymMatrix<long double>();
+    TestBandLU<long double>();
 #endif // LONGDOUBLE
 
 #endif
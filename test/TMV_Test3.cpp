@@ -41,6 +41,7 @@ int main() try {
     TestAllSmallSquareDiv<double>();
     TestAllSmallNonSquareDiv<double>();
     TestSmallMatrixDet<double>();
+    TestSmallMatrixBatch<double>();
 #endif
 
 #ifdef TEST_FLOAT
@@ -51,6 +52,7 @@ int main() try {
     TestAllSmallSquareDiv<float>();
     TestAllSmallNonSquareDiv<float>();
     TestSmallMatrixDet<float>();
+    TestSmallMatrixBatch<float>();
 #endif
 
 #ifdef TEST_LONGDOUBLE
@@ -61,6 +63,7 @@ int main() try {
     TestAllSmallSquareDiv<long double>();
     TestAllSmallNonSquareDiv<long double>();
     TestSmallMatrixDet<long double>();
+    TestSmallMatrixBatch<long double>();
 #endif 
 
 #ifdef TEST_INT
@@ -36,11 +36,13 @@ int main() try {
 #ifdef TEST_DOUBLE
     TestAllSmallSquareDiv<double>();
     TestSmallMatrixDet<double>();
+    TestSmallMatrixBatch<double>();
 #endif
 
 #ifdef TEST_FLOAT
     TestAllSmallSquareDiv<float>();
     TestSmallMatrixDet<float>();
+    TestSmallMatrixBatch<float>();
 #endif
 
 #ifdef TEST_INT
@@ -50,6 +52,7 @@ int main() try {
 #ifdef TEST_LONGDOUBLE
     TestAllSmallSquareDiv<long double>();
     TestSmallMatrixDet<long double>();
+    TestSmallMatrixBatch<long double>();
 #endif 
 
 #endif 
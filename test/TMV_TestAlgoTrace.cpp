@@ -0,0 +1,214 @@
+
+#include "TMV_Test.h"
+#include "TMV_Test_1.h"
+#include "TMV.h"
+#include <sstream>
+#if __cplusplus >= 201103L
+#include <thread>
+#endif
+
+#ifndef TMV_NO_ALGO_TRACE
+// Find the records for op.  Returns the total number of calls.
+static long FindAlgoTrace(
+    const std::vector<tmv::AlgoTraceRecord>& recs, const std::string& op,
+    std::vector<tmv::AlgoTraceRecord>& found)
+{
+    found.clear();
+    long ncalls = 0;
+    for(size_t i=0;i<recs.size();++i) {
+        if (op == recs[i].op) {
+            found.push_back(recs[i]);
+            ncalls += recs[i].ncalls;
+        }
+    }
+    return ncalls;
+}
+
+// Check that the records for an op are consistent, and that the
+// largest call had sizes M,N,K.  (The algorithms may call other
+// algorithms for parts of the matrix, which are also recorded.)
+static void CheckAlgoTrace(
+    const std::vector<tmv::AlgoTraceRecord>& found,
+    ptrdiff_t M, ptrdiff_t N, ptrdiff_t K, std::string label)
+{
+    Assert(found.size() > 0,label+" recorded");
+    bool foundtop = false;
+    for(size_t i=0;i<found.size();++i) {
+        const tmv::AlgoTraceRecord& r = found[i];
+        Assert(r.ncalls > 0,label+" ncalls");
+        Assert(r.seconds >= 0.,label+" seconds");
+        Assert(r.flops > 0.,label+" flops");
+        Assert(r.bytes > 0.,label+" bytes");
+        const ptrdiff_t mnk[3] = { M, N, K };
+        for(int k=0;k<3;++k) {
+            Assert(r.min[k] <= r.max[k],label+" min <= max");
+            Assert(r.max[k] <= mnk[k],label+" max <= size");
+            Assert(r.mean(k) >= r.min[k] && r.mean(k) <= r.max[k],
+                   label+" mean");
+            long nhist = 0;
+            for(int b=0;b<TMV_ALGO_TRACE_NBINS;++b) nhist += r.hist[k][b];
+            Assert(nhist == r.ncalls,label+" hist");
+        }
+        if (r.max[0] == M && r.max[1] == N && r.max[2] == K) foundtop = true;
+    }
+    Assert(foundtop,label+" top level call");
+}
+
+#if __cplusplus >= 201103L
+static void TraceOneCall()
+{ tmv::AlgoTrace trace("AlgoTraceThread",1,1,2,3,1.,1.); }
+#endif
+
+// Check the run time algorithm trace with an LU decomposition and a
+// matrix product, the log output with several threads writing to it,
+// and that the buffers of threads that have ended are reused.
+template <class T>
+static void TestAlgoTraceRecords()
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    const ptrdiff_t M = 60, N = 40, K = 30;
+    tmv::Matrix<T> a(M,N);
+    tmv::Matrix<T> b(M,K);
+    tmv::Matrix<T> c(K,N);
+    for(ptrdiff_t i=0;i<M;++i) for(ptrdiff_t j=0;j<N;++j)
+        a(i,j) = T(RT(2+(i*j)%7)-RT(i==j?20:0));
+    for(ptrdiff_t i=0;i<M;++i) for(ptrdiff_t j=0;j<K;++j)
+        b(i,j) = T(RT(1+(3*i+j)%5));
+    for(ptrdiff_t i=0;i<K;++i) for(ptrdiff_t j=0;j<N;++j)
+        c(i,j) = T(RT(1+(i+2*j)%3));
+    std::vector<tmv::AlgoTraceRecord> recs, found;
+
+    // Nothing is recorded when the trace is off.
+    tmv::DisableAlgoTrace();
+    tmv::ResetAlgoTrace();
+    Assert(!tmv::IsAlgoTraceEnabled(),"AlgoTrace off by default");
+    {
+        tmv::Matrix<T> lu = a;
+        tmv::Permutation P(M);
+        tmv::LU_Decompose(lu.view(),P);
+        tmv::Matrix<T> m = b*c;
+    }
+    Assert(tmv::GetAlgoTrace(recs) == 0,"AlgoTrace off dropped");
+    Assert(recs.size() == 0,"AlgoTrace off records");
+
+    tmv::EnableAlgoTrace();
+    Assert(tmv::IsAlgoTraceEnabled(),"EnableAlgoTrace");
+    tmv::Matrix<T> lu = a;
+    tmv::Permutation P(M);
+    tmv::LU_Decompose(lu.view(),P);
+    tmv::DisableAlgoTrace();
+    Assert(tmv::GetAlgoTrace(recs) == 0,"AlgoTrace LU dropped");
+    for(size_t i=1;i<recs.size();++i)
+        Assert(!(recs[i] < recs[i-1]),"AlgoTrace sorted");
+    FindAlgoTrace(recs,"LU_Decompose",found);
+    CheckAlgoTrace(found,M,N,0,"AlgoTrace LU_Decompose");
+
+    // The LU decomposition also does some products, so reset the trace
+    // before checking the MultMM records.
+    std::vector<tmv::AlgoTraceRecord> lurecs = recs;
+    tmv::ResetAlgoTrace();
+    tmv::EnableAlgoTrace();
+    tmv::Matrix<T> m(M,N);
+    m = b*c;
+    tmv::DisableAlgoTrace();
+    Assert(tmv::GetAlgoTrace(recs) == 0,"AlgoTrace MultMM dropped");
+    Assert(FindAlgoTrace(recs,"LU_Decompose",found) == 0,
+           "AlgoTrace reset LU_Decompose");
+    FindAlgoTrace(recs,"MultMM",found);
+    CheckAlgoTrace(found,M,N,K,"AlgoTrace MultMM");
+
+    // The trace continues adding to the existing records.
+    tmv::EnableAlgoTrace();
+    tmv::LU_Decompose(lu.view(),P);
+    tmv::DisableAlgoTrace();
+    tmv::GetAlgoTrace(recs);
+    std::vector<tmv::AlgoTraceRecord> found1;
+    Assert(FindAlgoTrace(recs,"LU_Decompose",found) == 
+           FindAlgoTrace(lurecs,"LU_Decompose",found1),
+           "AlgoTrace LU_Decompose again");
+    Assert(FindAlgoTrace(recs,"MultMM",found) >
+           FindAlgoTrace(lurecs,"MultMM",found1),"AlgoTrace MultMM again");
+
+    // The same records are written in both formats.
+    std::ostringstream json;
+    tmv::WriteAlgoTraceJSON(json);
+    Assert(json.str().find("\"op\": \"LU_Decompose\"") != std::string::npos,
+           "AlgoTrace JSON LU_Decompose");
+    Assert(json.str().find("\"op\": \"MultMM\"") != std::string::npos,
+           "AlgoTrace JSON MultMM");
+    std::ostringstream csv;
+    tmv::WriteAlgoTraceCSV(csv);
+    Assert(csv.str().find("\nLU_Decompose,") != std::string::npos,
+           "AlgoTrace CSV LU_Decompose");
+    Assert(csv.str().find("\nMultMM,") != std::string::npos,
+           "AlgoTrace CSV MultMM");
+
+    // Each traced call writes one line to the log, even when several
+    // threads are writing at once.
+    const int nlog = 200;
+    std::ostringstream log;
+    std::ostream* oldlog = tmv::LogAlgoTraceTo(&log);
+    tmv::EnableAlgoTrace();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for(int i=0;i<nlog;++i) {
+        tmv::AlgoTrace trace("AlgoTraceLog",i%3,i,2,3,1.,1.);
+    }
+    tmv::DisableAlgoTrace();
+    Assert(tmv::LogAlgoTraceTo(oldlog) == &log,"LogAlgoTraceTo");
+    std::istringstream login(log.str());
+    std::string line;
+    int nlines = 0;
+    while (std::getline(login,line)) {
+        Assert(line.find("AlgoTraceLog algo ") == 0,"AlgoTrace log line");
+        ++nlines;
+    }
+    Assert(nlines == nlog,"AlgoTrace log lines");
+    tmv::GetAlgoTrace(recs);
+    Assert(FindAlgoTrace(recs,"AlgoTraceLog",found) == nlog,
+           "AlgoTrace log calls");
+    Assert(found.size() == 3,"AlgoTrace log algos");
+
+#if __cplusplus >= 201103L
+    // Threads that start after others have ended take over their
+    // buffers, so the number of buffers doesn't grow, but the calls
+    // from the threads that ended are still counted.
+    const int nthreads = 20;
+    tmv::EnableAlgoTrace();
+    std::thread(&TraceOneCall).join();
+    int nbuf0 = 0;
+    for(tmv::AlgoTraceBuffer* p=tmv::AlgoTraceState::first(); p; p=p->next)
+        ++nbuf0;
+    for(int i=1;i<nthreads;++i) std::thread(&TraceOneCall).join();
+    tmv::DisableAlgoTrace();
+    int nbuf = 0;
+    for(tmv::AlgoTraceBuffer* p=tmv::AlgoTraceState::first(); p; p=p->next)
+        ++nbuf;
+    Assert(nbuf == nbuf0,"AlgoTrace buffers reused");
+    tmv::GetAlgoTrace(recs);
+    Assert(FindAlgoTrace(recs,"AlgoTraceThread",found) == nthreads,
+           "AlgoTrace calls from ended threads");
+#endif
+
+    tmv::ResetAlgoTrace();
+    tmv::GetAlgoTrace(recs);
+    Assert(recs.size() == 0,"ResetAlgoTrace");
+}
+#endif
+
+template <class T>
+void TestAlgoTrace()
+{
+#ifndef TMV_NO_ALGO_TRACE
+    TestAlgoTraceRecords<T>();
+#endif
+    std::cout<<"AlgoTrace<"<<Text(T())<<"> passed all tests\n";
+}
+
+#ifdef TEST_DOUBLE
+template void TestAlgoTrace<double>();
+#endif
+#ifdef TEST_FLOAT
+template void TestAlgoTrace<float>();
+#endif
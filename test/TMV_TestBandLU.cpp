@@ -0,0 +1,372 @@
+
+#include "TMV_Test.h"
+#include "TMV_Test_1.h"
+#include "TMV.h"
+#include "TMV_Band.h"
+#include "tmv/TMV_BandLUDecompose.h"
+#include "tmv/TMV_BandLUDiv.h"
+#include "tmv/TMV_BandSpike.h"
+#include <vector>
+
+// Check that P L U reproduces the original matrix a, where LU and P are 
+// the output of BandLUDecompose_Helper, with L not permuted by later 
+// swaps (cf. the XDEBUG_BandLU check in TMV_BandLUDecompose.h).
+template <class T, class BM>
+static void CheckBandLU(
+    const tmv::Matrix<T>& a, const BM& LU, const ptrdiff_t* P, int nlo,
+    std::string label)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    typedef typename tmv::Traits<RT>::float_type FT;
+    const ptrdiff_t N = a.colsize();
+    tmv::Matrix<T> L(N,N,T(0));
+    for(ptrdiff_t i=0;i<N;++i) L(i,i) = T(1);
+    for(ptrdiff_t i=0;i<N;++i) {
+        const bool okp = P[i] >= i && P[i] <= std::min(i+nlo,N-1);
+        Assert(okp,label+" P range");
+        if (!okp) return;
+        Swap(L.row(i,0,i),L.row(P[i],0,i));
+        const ptrdiff_t end = std::min(i+nlo+1,N);
+        L.col(i,i+1,end) = LU.col(i,i+1,end);
+    }
+    tmv::Matrix<T> U(N,N,T(0));
+    for(ptrdiff_t j=0;j<N;++j) {
+        const ptrdiff_t start = std::max(ptrdiff_t(0),j-LU.nhi());
+        U.col(j,start,j+1) = LU.col(j,start,j+1);
+    }
+    tmv::Matrix<T> PLU = L*U;
+    PLU.reversePermuteRows(P);
+    if (showacc) {
+        std::cout<<label<<": Norm(a-PLU) = "<<Norm(a-PLU)<<
+            "  cf "<<EPS*N*Norm(a)<<std::endl;
+    }
+    Assert(Equal(a,PLU,EPS*N*Norm(a)),label);
+}
+
+// Decompose an N x N band matrix with nlo,nhi with each of the band LU
+// algorithms and check the results.  The diagonal is not dominant, so
+// most columns need to pivot.
+// If zerocol, one of the columns is 0, so the matrix is singular.
+template <class T, tmv::StorageType stor>
+static void DoTestBandLUAlgos(int N, int nlo, int nhi, std::string label,
+                              bool zerocol=false)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    typedef tmv::BandMatrix<T,tmv::ColMajor> BCM;
+    typedef typename BCM::view_type BCMv;
+    typedef tmv::BandMatrix<T,stor> BM;
+    typedef typename BM::view_type BMv;
+    const ptrdiff_t xx = tmv::Unknown;
+
+    if (showstartdone) {
+        std::cout<<"Start DoTestBandLUAlgos: "<<label<<", N,nlo,nhi = "<<
+            N<<','<<nlo<<','<<nhi<<std::endl;
+    }
+
+    tmv::Matrix<T> a(N,N,T(0));
+    for(int i=0;i<N;++i) for(int j=0;j<N;++j) 
+        if (i<=j+nlo && j<=i+nhi) 
+            a(i,j) = TestVal<T>::make(
+                RT((7*i+3*j)%11)-RT(5),RT((i+2*j)%5)-RT(2)) / RT(10);
+    for(int i=0;i<N;++i) a(i,i) += T(RT(1)/RT(4));
+    if (zerocol) a.col(N/3).setZero();
+
+    // The storage needs nlo+nhi superdiagonals for the fill from the 
+    // pivoting.
+    BCM A0(N,N,nlo,nlo+nhi,T(0));
+    for(int i=0;i<N;++i) for(int j=0;j<N;++j) 
+        if (i<=j+nlo && j<=i+nhi) A0(i,j) = a(i,j);
+
+    // algo 11: The regular unblocked algorithm
+    {
+        BCM A = A0;
+        BCMv Av = A.view();
+        std::vector<ptrdiff_t> P(N,-1);
+        tmv::BandLUDecompose_Helper<11,xx,xx,BCMv>::call(Av,&P[0]);
+        CheckBandLU(a,A,&P[0],nlo,label+" algo 11");
+    }
+
+    // algo 21: The blocked algorithm.  This works for any nlo, not 
+    // just nlo >= TMV_BANDLU_BLOCK_MINLO, so test it for all of them.
+    if (nlo > 0) {
+        BCM A = A0;
+        BCMv Av = A.view();
+        std::vector<ptrdiff_t> P(N,-1);
+        tmv::BandLUDecompose_Helper<21,xx,xx,BCMv>::call(Av,&P[0]);
+        CheckBandLU(a,A,&P[0],nlo,label+" algo 21");
+    }
+
+    // algo 31: Tridiagonal
+    if (nlo == 1 && nhi == 1) {
+        BCM A = A0;
+        BCMv Av = A.view();
+        std::vector<ptrdiff_t> P(N,-1);
+        tmv::BandLUDecompose_Helper<31,xx,xx,BCMv>::call(Av,&P[0]);
+        CheckBandLU(a,A,&P[0],nlo,label+" algo 31");
+    }
+
+    // algo -3: The automatic selection, which copies to ColMajor (81) 
+    // or DiagMajor (82) as needed, and then picks from 11, 21 and 31 
+    // at run time (71).
+    {
+        BM A(N,N,nlo,nlo+nhi,T(0));
+        A = A0;
+        BMv Av = A.view();
+        std::vector<ptrdiff_t> P(N,-1);
+        tmv::BandLUDecompose_Helper<-3,xx,xx,BMv>::call(Av,&P[0]);
+        CheckBandLU(a,A,&P[0],nlo,label+" algo -3 "+tmv::TMV_Text(stor));
+    }
+}
+
+template <class T>
+static void TestBandLUAlgos()
+{
+    typedef std::complex<T> CT;
+    const int bs = TMV_BANDLU_BLOCKSIZE;
+    const int minlo = TMV_BANDLU_BLOCK_MINLO;
+
+    // Tridiagonal, with N odd and even.
+    DoTestBandLUAlgos<T,tmv::ColMajor>(41,1,1,"Tridiag");
+    DoTestBandLUAlgos<T,tmv::RowMajor>(40,1,1,"Tridiag");
+    DoTestBandLUAlgos<T,tmv::DiagMajor>(40,1,1,"Tridiag");
+    DoTestBandLUAlgos<CT,tmv::RowMajor>(41,1,1,"Tridiag complex");
+
+    // Narrow bands, which use algo 11 automatically.
+    DoTestBandLUAlgos<T,tmv::ColMajor>(100,4,9,"Narrow");
+    DoTestBandLUAlgos<T,tmv::RowMajor>(100,12,7,"Narrow");
+    DoTestBandLUAlgos<T,tmv::DiagMajor>(50,1,3,"Narrow");
+    DoTestBandLUAlgos<CT,tmv::DiagMajor>(60,5,2,"Narrow complex");
+
+    // Wide bands, which use algo 21 automatically.  
+    // nlo != nhi, nlo not a multiple of the block size, and N not a 
+    // multiple of the block size.
+    DoTestBandLUAlgos<T,tmv::ColMajor>(5*bs+7,minlo,minlo+9,"Wide");
+    DoTestBandLUAlgos<T,tmv::RowMajor>(4*bs+19,minlo+5,3,"Wide");
+    DoTestBandLUAlgos<T,tmv::DiagMajor>(6*bs+1,minlo+bs+3,bs/2,"Wide");
+    DoTestBandLUAlgos<CT,tmv::ColMajor>(5*bs+11,minlo+2,minlo/2,
+                                        "Wide complex");
+    // Singular, with an exactly zero pivot.
+    DoTestBandLUAlgos<T,tmv::ColMajor>(40,1,1,"Tridiag zero col",true);
+    DoTestBandLUAlgos<T,tmv::ColMajor>(100,4,9,"Narrow zero col",true);
+    DoTestBandLUAlgos<T,tmv::RowMajor>(4*bs+19,minlo+5,3,"Wide zero col",
+                                       true);
+
+    // A band wider than the matrix.
+    DoTestBandLUAlgos<T,tmv::ColMajor>(minlo+10,minlo+9,minlo+9,"Full");
+
+    std::cout<<"BandMatrix<"<<Text(T())<<"> passed all LU algo tests\n";
+}
+
+// Solve with each of the BandLU_Solve_Helper algorithms, both normally
+// and transposed, and check the results against the original matrix.
+template <class T>
+static void DoTestBandLUSolveAlgos(int N, int nlo, int nhi, int K,
+                                   std::string label)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    typedef typename tmv::Traits<RT>::float_type FT;
+    typedef tmv::BandMatrix<T,tmv::ColMajor> BM;
+    typedef typename BM::const_view_type BMcv;
+    typedef tmv::Matrix<T,tmv::ColMajor> MM;
+    typedef typename MM::view_type MMv;
+    typedef typename MM::col_type MMc;
+    const ptrdiff_t xx = tmv::Unknown;
+
+    if (showstartdone) {
+        std::cout<<"Start DoTestBandLUSolveAlgos: "<<label<<
+            ", N,nlo,nhi,K = "<<N<<','<<nlo<<','<<nhi<<','<<K<<std::endl;
+    }
+
+    // The diagonal is not dominant, so the decomposition pivots.
+    MM a(N,N,T(0));
+    BM LU(N,N,nlo,nlo+nhi,T(0));
+    for(int i=0;i<N;++i) for(int j=0;j<N;++j) 
+        if (i<=j+nlo && j<=i+nhi) 
+            LU(i,j) = a(i,j) = TestVal<T>::make(
+                RT((5*i+3*j)%11)-RT(4.5),RT((2*i+j)%7)-RT(3)) / RT(10) +
+                (i==j ? T(RT(1)/RT(2)) : T(0));
+    typename BM::view_type LUv = LU.view();
+    std::vector<ptrdiff_t> P(N);
+    tmv::BandLUDecompose_Helper<11,xx,xx,typename BM::view_type>::call(
+        LUv,&P[0]);
+    tmv::Permutation PP(N,&P[0]);
+    BMcv LUcv = LU.view();
+
+    MM b(N,K);
+    for(int i=0;i<N;++i) for(int j=0;j<K;++j)
+        b(i,j) = TestVal<T>::make(RT(1+(i*j)%9)-RT(4),RT(i-j)/RT(N));
+    const FT eps = EPS * FT(N) * Norm(a) * Norm(a.inverse());
+
+    // algo 11: one column at a time
+    {
+        MM x = b;
+        MM xt = b;
+        for(int j=0;j<K;++j) {
+            MMc xj = x.col(j);
+            MMc xtj = xt.col(j);
+            tmv::BandLU_Solve_Helper<11,false,xx,1,BMcv,MMc>::call(
+                LUcv,PP,xj);
+            tmv::BandLU_Solve_Helper<11,true,xx,1,BMcv,MMc>::call(
+                LUcv,PP,xtj);
+        }
+        Assert(Equal(a*x,b,eps*Norm(x)),label+" algo 11");
+        Assert(Equal(a.transpose()*xt,b,eps*Norm(xt)),label+" algo 11 trans");
+    }
+
+#define BANDLU_SOLVE_ALGO(algo) \
+    { \
+        MM x = b; \
+        MMv xv = x.view(); \
+        tmv::BandLU_Solve_Helper<algo,false,xx,xx,BMcv,MMv>::call( \
+            LUcv,PP,xv); \
+        if (showacc) { \
+            std::cout<<"algo "<<algo<<": Norm(ax-b) = "<< \
+                Norm(a*x-b)<<"  cf "<<eps*Norm(x)<<std::endl; \
+        } \
+        Assert(Equal(a*x,b,eps*Norm(x)),label+" algo "#algo); \
+        x = b; \
+        tmv::BandLU_Solve_Helper<algo,true,xx,xx,BMcv,MMv>::call( \
+            LUcv,PP,xv); \
+        Assert(Equal(a.transpose()*x,b,eps*Norm(x)), \
+               label+" algo "#algo" trans"); \
+    }
+
+    BANDLU_SOLVE_ALGO(12)
+    BANDLU_SOLVE_ALGO(21)
+    BANDLU_SOLVE_ALGO(22)
+#ifdef _OPENMP
+    BANDLU_SOLVE_ALGO(32)
+#endif
+#undef BANDLU_SOLVE_ALGO
+}
+
+// The residual b - A x for the band matrix A.
+template <class T, class BM>
+static tmv::Vector<T> BandResid(
+    const BM& A, const tmv::Vector<T>& x, const tmv::Vector<T>& b)
+{
+    const ptrdiff_t N = A.colsize();
+    tmv::Vector<T> r = b;
+    for(ptrdiff_t i=0;i<N;++i) {
+        const ptrdiff_t j1 = std::max(ptrdiff_t(0),i-A.nlo());
+        const ptrdiff_t j2 = std::min(N,i+A.nhi()+1);
+        for(ptrdiff_t j=j1;j<j2;++j) r(i) -= A(i,j) * x(j);
+    }
+    return r;
+}
+
+// Solve with BandSpike_SolveInPlace with various numbers of partitions
+// and check the residual.
+template <class T>
+static void DoTestBandSpike(
+    const tmv::BandMatrix<T>& A, std::string label)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    typedef typename tmv::Traits<RT>::float_type FT;
+    const ptrdiff_t N = A.colsize();
+
+    if (showstartdone) {
+        std::cout<<"Start DoTestBandSpike: "<<label<<", N,nlo,nhi = "<<
+            N<<','<<A.nlo()<<','<<A.nhi()<<std::endl;
+    }
+
+    tmv::Vector<T> b(N);
+    for(ptrdiff_t i=0;i<N;++i) 
+        b(i) = TestVal<T>::make(RT(i%7)-RT(3),RT(1)-RT(i%3));
+    const FT eps = EPS * FT(N) * Norm(A) * FT(10);
+
+    for(int nparts=0; nparts<=7; ++nparts) {
+        tmv::Vector<T> x = b;
+        tmv::BandSpike_SolveInPlace(A,x,nparts);
+        tmv::Vector<T> r = BandResid(A,x,b);
+        if (showacc) {
+            std::cout<<label<<" nparts = "<<nparts<<": Norm(b-Ax) = "<<
+                Norm(r)<<"  cf "<<eps*Norm(x)<<std::endl;
+        }
+        Assert(Norm(r) <= eps*Norm(x),label+" BandSpike");
+    }
+
+    // A strided vector, which is solved in a temporary.
+    tmv::Vector<T> x2(2*N);
+    tmv::VectorView<T> x2s = x2.subVector(0,2*N,2);
+    x2s = b;
+    tmv::BandSpike_SolveInPlace(A,x2s,2);
+    tmv::Vector<T> r2 = BandResid(A,tmv::Vector<T>(x2s),b);
+    Assert(Norm(r2) <= eps*Norm(x2s),label+" BandSpike strided");
+}
+
+template <class T>
+static void TestBandLUSolveAlgos()
+{
+    typedef std::complex<T> CT;
+    // K is not a multiple of TMV_BANDLU_SOLVE_BLOCKSIZE, and the
+    // second case has enough work to use the threads in algo 32.
+    const int K = 2*TMV_BANDLU_SOLVE_BLOCKSIZE + 5;
+    DoTestBandLUSolveAlgos<T>(40,1,1,7,"Tridiag");
+    DoTestBandLUSolveAlgos<T>(400,8,5,K,"Band");
+    DoTestBandLUSolveAlgos<T>(60,0,3,K,"Upper band");
+    DoTestBandLUSolveAlgos<CT>(100,4,6,K,"Band complex");
+}
+
+template <class T>
+static void TestBandSpike()
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    typedef std::complex<T> CT;
+
+    // Diagonally dominant, so each partition is nonsingular.
+    {
+        const int N = 2000, nlo = 3, nhi = 2;
+        tmv::BandMatrix<T> A(N,N,nlo,nhi);
+        tmv::BandMatrix<CT> cA(N,N,nlo,nhi);
+        for(int i=0;i<N;++i) for(int j=0;j<N;++j) 
+            if (i<=j+nlo && j<=i+nhi) {
+                A(i,j) = i==j ? T(8+i%3) : T(RT(1+(i+2*j)%4)/RT(2));
+                cA(i,j) = i==j ? CT(8+i%3,1) : CT(RT(1+(i+j)%3),-1) / RT(2);
+            }
+        DoTestBandSpike(A,"Diag dominant");
+        DoTestBandSpike(cA,"Diag dominant complex");
+    }
+
+    // A nonsingular tridiagonal matrix where the top left corner of
+    // the second partition (for nparts = 2) is singular, so BandSpike
+    // has to fall back to the full LU solution.
+    {
+        const int N = 48;
+        tmv::BandMatrix<T> A(N,N,1,1);
+        for(int i=0;i<N;++i) {
+            A(i,i) = T(4);
+            if (i > 0) A(i,i-1) = T(1);
+            if (i < N-1) A(i,i+1) = T(-1);
+        }
+        A(24,24) = A(24,25) = T(0);
+        A(24,23) = T(1);
+        DoTestBandSpike(A,"Singular partition");
+
+        // Nearly singular is just as bad.  With A(25,24) = 0 too, the
+        // first pivot of that partition is O(eps), which is below the
+        // sqrt(eps) threshold, so this also uses the full LU solution.
+        A(24,24) = T(std::numeric_limits<RT>::epsilon());
+        A(25,24) = T(0);
+        DoTestBandSpike(A,"Nearly singular partition");
+    }
+}
+
+template <class T> void TestBandLU()
+{
+    TestBandLUAlgos<T>();
+    TestBandLUSolveAlgos<T>();
+    TestBandSpike<T>();
+    std::cout<<"BandMatrix<"<<Text(T())<<"> passed all ";
+    std::cout<<"LU solve and SPIKE tests\n";
+}
+
+#ifdef TEST_DOUBLE
+template void TestBandLU<double>();
+#endif
+#ifdef TEST_FLOAT
+template void TestBandLU<float>();
+#endif
+#ifdef TEST_LONGDOUBLE
+template void TestBandLU<long double>();
+#endif
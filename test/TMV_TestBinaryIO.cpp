@@ -0,0 +1,409 @@
+
+#include "TMV_Test.h"
+#include "TMV_Test_1.h"
+#include "TMV.h"
+#include "tmv/TMV_BinaryIO.h"
+#include <sstream>
+#include <cstdio>
+
+template <class T>
+static T BinaryVal(ptrdiff_t i, ptrdiff_t j)
+{ return TestVal<T>::make(10*i+j+1,i-3*j); }
+
+static const char* binfile = "tmvtest_binary.bin";
+
+template <class M>
+static void FillBinary(M& m)
+{
+    typedef typename M::value_type T;
+    for(ptrdiff_t i=0;i<m.colsize();++i) for(ptrdiff_t j=0;j<m.rowsize();++j)
+        m.ref(i,j) = BinaryVal<T>(i,j);
+}
+
+template <class T, tmv::StorageType stor>
+static void DoTestBinaryMatrix(ptrdiff_t M, ptrdiff_t N)
+{
+    std::string label = std::string("Binary Matrix ") + tmv::TMV_Text(stor);
+    tmv::Matrix<T,stor> m(M,N);
+    FillBinary(m);
+
+    // Read back into both storage orders.
+    std::stringstream ss;
+    tmv::WriteBinary(ss,m);
+    Assert(ss.str().size() == tmv::BinaryHeaderSize + M*N*sizeof(T),
+           label+" size");
+    tmv::Matrix<T,tmv::ColMajor> mc;
+    tmv::Matrix<T,tmv::RowMajor> mr(2,3);
+    ss.seekg(0);
+    tmv::ReadBinary(ss,mc);
+    Assert(Equal(mc,m,0),label+" read ColMajor");
+    ss.seekg(0);
+    tmv::ReadBinary(ss,mr);
+    Assert(Equal(mr,m,0),label+" read RowMajor");
+
+    // A view that isn't contiguous is written with the storage of m.
+    std::stringstream ss2;
+    tmv::WriteBinary(ss2,m.subMatrix(1,M,0,N,1,2));
+    tmv::Matrix<T> m2;
+    tmv::ReadBinary(ss2,m2);
+    Assert(Equal(m2,m.subMatrix(1,M,0,N,1,2),0),label+" view");
+    std::stringstream ss3;
+    tmv::WriteBinary(ss3,m.conjugate());
+    tmv::ReadBinary(ss3,m2);
+    Assert(Equal(m2,m.conjugate(),0),label+" conjugate");
+
+    // Memory mapped.
+    tmv::WriteBinary(std::string(binfile),m);
+    {
+        tmv::MappedBinaryFile f(binfile);
+        Assert(f.header().kind == 'M',label+" mapped kind");
+        Assert(f.header().stor == (stor == tmv::RowMajor ? 'R' : 'C'),
+               label+" mapped stor");
+        tmv::ConstMatrixView<T> mv = f.template matrixView<T>();
+        Assert(mv.colsize() == M && mv.rowsize() == N,label+" mapped size");
+        Assert(Equal(mv,m,0),label+" mapped");
+    }
+    tmv::ReadBinary(std::string(binfile),m2);
+    Assert(Equal(m2,m,0),label+" read file");
+
+    // BinaryMatrixWriter, one column or row at a time.
+    std::stringstream ss4;
+    {
+        tmv::BinaryMatrixWriter<T> w(ss4,M,N,stor);
+        const ptrdiff_t n = stor == tmv::RowMajor ? M : N;
+        for(ptrdiff_t k=0;k<n;++k) {
+            Assert(w.count() == k && !w.done(),label+" writer count");
+            if (stor == tmv::RowMajor) w.write(m.row(k));
+            else w.write(m.col(k));
+        }
+        Assert(w.done(),label+" writer done");
+    }
+    Assert(ss4.str() == ss.str(),label+" writer same as WriteBinary");
+}
+
+template <class T, tmv::StorageType stor>
+static void DoTestBinaryBand(ptrdiff_t M, ptrdiff_t N, ptrdiff_t lo, ptrdiff_t hi)
+{
+    std::string label = std::string("Binary BandMatrix ") +
+        tmv::TMV_Text(stor);
+    tmv::BandMatrix<T,stor> m(M,N,lo,hi);
+    for(ptrdiff_t i=0;i<M;++i) for(ptrdiff_t j=0;j<N;++j)
+        if (j >= i-lo && j <= i+hi) m(i,j) = BinaryVal<T>(i,j);
+
+    std::stringstream ss;
+    tmv::WriteBinary(ss,m);
+    tmv::BandMatrix<T,tmv::ColMajor> mc;
+    tmv::BandMatrix<T,tmv::RowMajor> mr;
+    tmv::BandMatrix<T,tmv::DiagMajor> md;
+    ss.seekg(0);
+    tmv::ReadBinary(ss,mc);
+    Assert(mc.nlo() == lo && mc.nhi() == hi,label+" read nlo,nhi");
+    Assert(Equal(mc,m,0),label+" read ColMajor");
+    ss.seekg(0);
+    tmv::ReadBinary(ss,mr);
+    Assert(Equal(mr,m,0),label+" read RowMajor");
+    ss.seekg(0);
+    tmv::ReadBinary(ss,md);
+    Assert(Equal(md,m,0),label+" read DiagMajor");
+
+    tmv::WriteBinary(std::string(binfile),m);
+    {
+        tmv::MappedBinaryFile f(binfile);
+        tmv::ConstBandMatrixView<T> mv = f.template bandMatrixView<T>();
+        Assert(mv.colsize() == M && mv.rowsize() == N,label+" mapped size");
+        Assert(mv.nlo() == lo && mv.nhi() == hi,label+" mapped nlo,nhi");
+        Assert(Equal(mv,m,0),label+" mapped");
+    }
+}
+
+template <class T, tmv::DiagType dt, tmv::StorageType stor>
+static void DoTestBinaryTri(ptrdiff_t N)
+{
+    std::string label = std::string("Binary TriMatrix ") +
+        tmv::TMV_Text(dt) + " " + tmv::TMV_Text(stor);
+    const int A = dt | stor;
+    tmv::UpperTriMatrix<T,A> u(N);
+    tmv::LowerTriMatrix<T,A> l(N);
+    for(ptrdiff_t i=0;i<N;++i) for(ptrdiff_t j=0;j<N;++j) {
+        if (i < j || (i == j && dt == tmv::NonUnitDiag))
+            u(i,j) = BinaryVal<T>(i,j);
+        if (i > j || (i == j && dt == tmv::NonUnitDiag))
+            l(i,j) = BinaryVal<T>(i,j);
+    }
+
+    std::stringstream ssu, ssl;
+    tmv::WriteBinary(ssu,u);
+    tmv::WriteBinary(ssl,l);
+    tmv::UpperTriMatrix<T,A> u2;
+    tmv::LowerTriMatrix<T,A> l2;
+    tmv::ReadBinary(ssu,u2);
+    tmv::ReadBinary(ssl,l2);
+    Assert(Equal(u2,u,0),label+" upper");
+    Assert(Equal(l2,l,0),label+" lower");
+
+    // Read into the other storage order.  A UnitDiag file can be read
+    // into a NonUnitDiag matrix, which gets 1's on the diagonal.
+    const tmv::StorageType stor2 =
+        stor == tmv::RowMajor ? tmv::ColMajor : tmv::RowMajor;
+    tmv::UpperTriMatrix<T,tmv::NonUnitDiag|stor2> u3;
+    tmv::LowerTriMatrix<T,tmv::NonUnitDiag|stor2> l3;
+    ssu.seekg(0);
+    ssl.seekg(0);
+    tmv::ReadBinary(ssu,u3);
+    tmv::ReadBinary(ssl,l3);
+    Assert(Equal(u3,u,0),label+" upper other storage");
+    Assert(Equal(l3,l,0),label+" lower other storage");
+
+    tmv::WriteBinary(std::string(binfile),u);
+    {
+        tmv::MappedBinaryFile f(binfile);
+        tmv::ConstUpperTriMatrixView<T> uv =
+            f.template upperTriMatrixView<T>();
+        Assert(uv.isunit() == (dt == tmv::UnitDiag),label+" mapped unit");
+        Assert(Equal(uv,u,0),label+" mapped upper");
+    }
+    tmv::WriteBinary(std::string(binfile),l);
+    {
+        tmv::MappedBinaryFile f(binfile);
+        tmv::ConstLowerTriMatrixView<T> lv =
+            f.template lowerTriMatrixView<T>();
+        Assert(lv.isunit() == (dt == tmv::UnitDiag),label+" mapped unit");
+        Assert(Equal(lv,l,0),label+" mapped lower");
+    }
+
+#ifndef TMV_NO_THROW
+    if (dt == tmv::NonUnitDiag) {
+        tmv::UpperTriMatrix<T,tmv::UnitDiag> u4;
+        ssu.seekg(0);
+        bool threw = false;
+        try { tmv::ReadBinary(ssu,u4); }
+        catch (tmv::BinaryReadError&) { threw = true; }
+        Assert(threw,label+" NonUnitDiag into UnitDiag");
+    }
+#endif
+}
+
+template <class T>
+static void DoTestBinaryDiagVector(ptrdiff_t N)
+{
+    tmv::Vector<T> v(N);
+    for(ptrdiff_t i=0;i<N;++i) v(i) = BinaryVal<T>(i,2);
+    tmv::DiagMatrix<T> d(v);
+
+    std::stringstream ssv, ssd;
+    tmv::WriteBinary(ssv,v);
+    tmv::WriteBinary(ssd,d);
+    tmv::Vector<T> v2;
+    tmv::DiagMatrix<T> d2;
+    tmv::ReadBinary(ssv,v2);
+    tmv::ReadBinary(ssd,d2);
+    Assert(Equal(v2,v,0),"Binary Vector");
+    Assert(Equal(d2,d,0),"Binary DiagMatrix");
+    // A Vector file can be read as a DiagMatrix and vice versa.
+    ssv.seekg(0);
+    ssd.seekg(0);
+    tmv::ReadBinary(ssv,d2);
+    tmv::ReadBinary(ssd,v2);
+    Assert(Equal(d2,d,0),"Binary Vector as DiagMatrix");
+    Assert(Equal(v2,v,0),"Binary DiagMatrix as Vector");
+
+    // A view with a non-unit step.
+    std::stringstream ssv2;
+    tmv::WriteBinary(ssv2,v.subVector(0,N,2));
+    tmv::ReadBinary(ssv2,v2);
+    Assert(Equal(v2,v.subVector(0,N,2),0),"Binary Vector step");
+
+    tmv::WriteBinary(std::string(binfile),v);
+    {
+        tmv::MappedBinaryFile f(binfile);
+        Assert(Equal(f.template vectorView<T>(),v,0),"Binary mapped Vector");
+        Assert(Equal(f.template diagMatrixView<T>(),d,0),
+               "Binary mapped Vector as DiagMatrix");
+    }
+    tmv::WriteBinary(std::string(binfile),d);
+    {
+        tmv::MappedBinaryFile f(binfile);
+        Assert(Equal(f.template diagMatrixView<T>(),d,0),
+               "Binary mapped DiagMatrix");
+    }
+}
+
+#ifndef TMV_NO_THROW
+// Read s into a Matrix<T>, and check that it throws a BinaryReadError.
+template <class T>
+static bool BinaryReadThrows(const std::string& s)
+{
+    std::stringstream ss(s);
+    tmv::Matrix<T> m;
+    try { tmv::ReadBinary(ss,m); }
+    catch (tmv::BinaryReadError&) { return true; }
+    return false;
+}
+
+// The same for a memory mapped file.
+template <class T>
+static bool BinaryMapThrows(const std::string& s)
+{
+    {
+        std::ofstream fout(binfile,std::ios::binary);
+        fout.write(s.data(),s.size());
+    }
+    try {
+        tmv::MappedBinaryFile f(binfile);
+        f.template matrixView<T>();
+    }
+    catch (tmv::BinaryReadError&) { return true; }
+    return false;
+}
+
+static std::string SetBinaryHeader(std::string s, const tmv::BinaryHeader& h)
+{
+    s.replace(0,sizeof(h),reinterpret_cast<const char*>(&h),sizeof(h));
+    return s;
+}
+
+// Check that invalid files throw a BinaryReadError.
+template <class T>
+static void TestBinaryErrors()
+{
+    const ptrdiff_t M = 5, N = 4;
+    tmv::Matrix<T> m(M,N);
+    FillBinary(m);
+    std::stringstream ss;
+    tmv::WriteBinary(ss,m);
+    const std::string good = ss.str();
+    tmv::BinaryHeader h0;
+    std::memcpy(&h0,good.data(),sizeof(h0));
+    Assert(!BinaryReadThrows<T>(good),"Binary good file");
+    Assert(!BinaryMapThrows<T>(good),"Binary good mapped file");
+
+    std::vector<std::string> bad;
+    std::vector<std::string> what;
+    tmv::BinaryHeader h;
+    h = h0; h.magic[0] = 'X';
+    bad.push_back(SetBinaryHeader(good,h)); what.push_back("magic");
+    h = h0; h.endian = 0x04030201;
+    bad.push_back(SetBinaryHeader(good,h)); what.push_back("endian");
+    h = h0; h.version = tmv::BinaryVersion+1;
+    bad.push_back(SetBinaryHeader(good,h)); what.push_back("version");
+    h = h0; h.kind = 'V';
+    bad.push_back(SetBinaryHeader(good,h)); what.push_back("kind");
+    h = h0; h.kind = 0;
+    bad.push_back(SetBinaryHeader(good,h)); what.push_back("kind 0");
+    h = h0; h.type = tmv::BinaryTypeCode<int>::value;
+    bad.push_back(SetBinaryHeader(good,h)); what.push_back("type");
+    h = h0; h.elemsize = sizeof(T)+1;
+    bad.push_back(SetBinaryHeader(good,h)); what.push_back("elemsize");
+    h = h0; h.stor = 'D';
+    bad.push_back(SetBinaryHeader(good,h)); what.push_back("stor");
+    h = h0; h.colsize = -M;
+    bad.push_back(SetBinaryHeader(good,h)); what.push_back("colsize < 0");
+    h = h0; h.rowsize = N+1;
+    bad.push_back(SetBinaryHeader(good,h)); what.push_back("datasize");
+    h = h0; h.dataoffset = tmv::BinaryHeaderSize - sizeof(T);
+    bad.push_back(SetBinaryHeader(good,h)); what.push_back("dataoffset");
+    // The data need to start at a multiple of sizeof(T).
+    h = h0; h.dataoffset = tmv::BinaryHeaderSize + sizeof(T)/2;
+    bad.push_back(SetBinaryHeader(good,h).insert(
+            tmv::BinaryHeaderSize,sizeof(T)/2,0));
+    what.push_back("unaligned dataoffset");
+    bad.push_back(good.substr(0,good.size()-1));
+    what.push_back("truncated");
+    bad.push_back(good.substr(0,tmv::BinaryHeaderSize/2));
+    what.push_back("truncated header");
+    for(size_t k=0;k<bad.size();++k) {
+        Assert(BinaryReadThrows<T>(bad[k]),"Binary bad "+what[k]);
+        Assert(BinaryMapThrows<T>(bad[k]),"Binary bad mapped "+what[k]);
+    }
+
+    // A larger dataoffset that is a multiple of sizeof(T) is fine.
+    h = h0; h.dataoffset = tmv::BinaryHeaderSize + 2*sizeof(T);
+    std::string padded = SetBinaryHeader(good,h);
+    padded.insert(tmv::BinaryHeaderSize,2*sizeof(T),0);
+    std::stringstream ssp(padded);
+    tmv::Matrix<T> m2;
+    tmv::ReadBinary(ssp,m2);
+    Assert(Equal(m2,m,0),"Binary padded dataoffset");
+    Assert(!BinaryMapThrows<T>(padded),"Binary padded dataoffset mapped");
+    {
+        tmv::MappedBinaryFile f(binfile);
+        Assert(Equal(f.template matrixView<T>(),m,0),
+               "Binary padded dataoffset mapped values");
+    }
+
+    // The wrong value_type.
+    std::stringstream ss2(good);
+    tmv::Matrix<int> mi;
+    bool threw = false;
+    try { tmv::ReadBinary(ss2,mi); }
+    catch (tmv::BinaryReadError&) { threw = true; }
+    Assert(threw,"Binary read with wrong value_type");
+
+    // Files that can't be opened.
+    threw = false;
+    try { tmv::ReadBinary(std::string("no_such_dir/x.bin"),m2); }
+    catch (tmv::BinaryReadError&) { threw = true; }
+    Assert(threw,"Binary read missing file");
+    threw = false;
+    try { tmv::MappedBinaryFile f("no_such_dir/x.bin"); }
+    catch (tmv::BinaryReadError&) { threw = true; }
+    Assert(threw,"Binary map missing file");
+    threw = false;
+    try { tmv::WriteBinary(std::string("no_such_dir/x.bin"),m); }
+    catch (tmv::BinaryWriteError&) { threw = true; }
+    Assert(threw,"Binary write to missing directory");
+}
+#endif
+
+template <class T>
+static void TestBinary()
+{
+    DoTestBinaryMatrix<T,tmv::ColMajor>(7,5);
+    DoTestBinaryMatrix<T,tmv::RowMajor>(7,5);
+    DoTestBinaryMatrix<T,tmv::ColMajor>(4,9);
+    DoTestBinaryMatrix<T,tmv::RowMajor>(4,9);
+    DoTestBinaryMatrix<T,tmv::ColMajor>(1,1);
+
+    // Square and non-square, with the band reaching past the matrix
+    // in some cases.
+    DoTestBinaryBand<T,tmv::ColMajor>(8,8,2,1);
+    DoTestBinaryBand<T,tmv::RowMajor>(8,8,2,1);
+    DoTestBinaryBand<T,tmv::DiagMajor>(8,8,2,1);
+    DoTestBinaryBand<T,tmv::ColMajor>(10,6,1,3);
+    DoTestBinaryBand<T,tmv::RowMajor>(10,6,1,3);
+    DoTestBinaryBand<T,tmv::DiagMajor>(10,6,1,3);
+    DoTestBinaryBand<T,tmv::ColMajor>(5,9,3,0);
+    DoTestBinaryBand<T,tmv::RowMajor>(5,9,3,0);
+    DoTestBinaryBand<T,tmv::DiagMajor>(5,9,3,0);
+    DoTestBinaryBand<T,tmv::ColMajor>(6,6,0,0);
+
+    DoTestBinaryTri<T,tmv::NonUnitDiag,tmv::ColMajor>(6);
+    DoTestBinaryTri<T,tmv::NonUnitDiag,tmv::RowMajor>(6);
+    DoTestBinaryTri<T,tmv::UnitDiag,tmv::ColMajor>(6);
+    DoTestBinaryTri<T,tmv::UnitDiag,tmv::RowMajor>(6);
+
+    DoTestBinaryDiagVector<T>(9);
+
+#ifndef TMV_NO_THROW
+    TestBinaryErrors<T>();
+#endif
+}
+
+template <class T>
+void TestBinaryIO()
+{
+    TestBinary<T>();
+    TestBinary<std::complex<T> >();
+    std::remove(binfile);
+    std::cout<<"BinaryIO<"<<Text(T())<<"> passed all tests\n";
+}
+
+#ifdef TEST_DOUBLE
+template void TestBinaryIO<double>();
+#endif
+#ifdef TEST_FLOAT
+template void TestBinaryIO<float>();
+#endif
+#ifdef TEST_LONGDOUBLE
+template void TestBinaryIO<long double>();
+#endif
@@ -0,0 +1,153 @@
+
+#include "TMV_Test.h"
+#include "TMV_Test_1.h"
+#include "TMV.h"
+#include "tmv/TMV_BlockTridiagMatrix.h"
+#include <vector>
+
+// A block diagonally dominant matrix, so the block Thomas algorithm
+// and the cyclic reduction are both stable.
+template <class T>
+static tmv::BlockTridiagMatrix<T> MakeBlockTridiag(ptrdiff_t n, ptrdiff_t bs)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    tmv::BlockTridiagMatrix<T> A(n,bs);
+    for(ptrdiff_t k=0;k<n;++k) {
+        for(ptrdiff_t i=0;i<bs;++i) for(ptrdiff_t j=0;j<bs;++j) {
+            A.diag(k)(i,j) = TestVal<T>::make(
+                RT((3*i+5*j+k)%7)-RT(3),RT((i+2*j+3*k)%5)-RT(2)) / RT(8);
+            if (k < n-1) {
+                A.lower(k)(i,j) = TestVal<T>::make(
+                    RT((2*i+j+k)%5)-RT(2),RT((i+k)%3)-RT(1)) / RT(8);
+                A.upper(k)(i,j) = TestVal<T>::make(
+                    RT((i+4*j+2*k)%7)-RT(3),RT((j+k)%3)-RT(1)) / RT(8);
+            }
+        }
+        for(ptrdiff_t i=0;i<bs;++i) A.diag(k)(i,i) += T(RT(4+bs+k%3));
+    }
+    return A;
+}
+
+template <class T>
+static tmv::Matrix<T> BlockTridiagFull(const tmv::BlockTridiagMatrix<T>& A)
+{
+    const ptrdiff_t N = A.colsize();
+    tmv::Matrix<T> m(N,N);
+    for(ptrdiff_t i=0;i<N;++i) for(ptrdiff_t j=0;j<N;++j) m(i,j) = A(i,j);
+    return m;
+}
+
+// Check the multiplication and both solvers for an n x n block matrix
+// with bs x bs blocks, and nrhs right hand sides.
+template <class T>
+static void DoTestBlockTridiag(
+    ptrdiff_t n, ptrdiff_t bs, ptrdiff_t nrhs, std::string label)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    typedef typename tmv::Traits<RT>::float_type FT;
+    const ptrdiff_t N = n*bs;
+
+    if (showstartdone) {
+        std::cout<<"Start DoTestBlockTridiag: "<<label<<", n,bs,nrhs = "<<
+            n<<','<<bs<<','<<nrhs<<std::endl;
+    }
+
+    tmv::BlockTridiagMatrix<T> A = MakeBlockTridiag<T>(n,bs);
+    tmv::Matrix<T> m = BlockTridiagFull(A);
+    const FT normm = Norm(m);
+
+    tmv::Matrix<T> X(N,nrhs);
+    for(ptrdiff_t i=0;i<N;++i) for(ptrdiff_t j=0;j<nrhs;++j)
+        X(i,j) = TestVal<T>::make(RT(1+(i+3*j)%5),RT(i%4)-RT(j));
+    tmv::Vector<T> x = X.col(0);
+    const FT normx = Norm(X);
+    const FT eps = EPS * FT(N) * normm * normx;
+
+    // MultMM, MultMV
+    tmv::Matrix<T> B(N,nrhs);
+    tmv::BlockTridiag_MultMM(A,X,B);
+    Assert(Equal(B,m*X,eps),label+" BlockTridiag_MultMM");
+    tmv::Vector<T> b(N);
+    tmv::BlockTridiag_MultMV(A,x,b);
+    Assert(Equal(b,m*x,eps),label+" BlockTridiag_MultMV");
+
+    // Block Thomas algorithm
+    tmv::BlockTridiagMatrix<T> LU = A;
+    std::vector<ptrdiff_t> P(N);
+    tmv::BlockTridiag_Decompose(LU,&P[0]);
+    tmv::Matrix<T> X2 = B;
+    tmv::BlockTridiag_SolveInPlace(LU,&P[0],X2);
+    if (showacc) {
+        std::cout<<"Norm(X2-X) = "<<Norm(X2-X)<<std::endl;
+        std::cout<<"cf "<<eps<<std::endl;
+    }
+    Assert(Equal(X2,X,eps),label+" BlockTridiag_SolveInPlace");
+    tmv::Vector<T> x2 = b;
+    tmv::BlockTridiag_SolveInPlace(LU,&P[0],x2);
+    Assert(Equal(x2,x,eps),label+" BlockTridiag_SolveInPlace vector");
+
+    // Block cyclic reduction
+    tmv::Matrix<T> X3 = B;
+    tmv::BlockTridiag_SolveCR(A,X3);
+    if (showacc) {
+        std::cout<<"Norm(X3-X) = "<<Norm(X3-X)<<std::endl;
+        std::cout<<"cf "<<eps<<std::endl;
+    }
+    Assert(Equal(X3,X,eps),label+" BlockTridiag_SolveCR");
+    Assert(Equal(BlockTridiagFull(A),m,0),label+" BlockTridiag_SolveCR A");
+    tmv::Vector<T> x3 = b;
+    tmv::BlockTridiag_SolveCR(A,x3);
+    Assert(Equal(x3,x,eps),label+" BlockTridiag_SolveCR vector");
+
+    // Conjugated arguments are copied first.
+    typedef typename tmv::Matrix<T>::conjugate_type MC;
+    typedef typename tmv::Matrix<T>::const_conjugate_type MCC;
+    MCC Xc = X.conjugate();
+    tmv::Matrix<T> B4(N,nrhs);
+    tmv::BlockTridiag_MultMM(A,Xc,B4);
+    Assert(Equal(B4,m*Xc,eps),label+" BlockTridiag_MultMM conj X");
+    tmv::Matrix<T> B5(N,nrhs);
+    MC B5c = B5.conjugate();
+    tmv::BlockTridiag_MultMM(A,X,B5c);
+    Assert(Equal(B5c,B,eps),label+" BlockTridiag_MultMM conj B");
+    tmv::Matrix<T> X4 = B.conjugate();
+    MC X4c = X4.conjugate();
+    tmv::BlockTridiag_SolveInPlace(LU,&P[0],X4c);
+    Assert(Equal(X4c,X,eps),label+" BlockTridiag_SolveInPlace conj");
+    tmv::Matrix<T> X5 = B.conjugate();
+    MC X5c = X5.conjugate();
+    tmv::BlockTridiag_SolveCR(A,X5c);
+    Assert(Equal(X5c,X,eps),label+" BlockTridiag_SolveCR conj");
+}
+
+template <class T>
+static void TestBlockTridiag(std::string label)
+{
+    // n = 1 has no reduction levels.  The other n include both odd and
+    // even sizes at each level of the cyclic reduction.
+    DoTestBlockTridiag<T>(1,3,2,label);
+    DoTestBlockTridiag<T>(2,3,2,label);
+    DoTestBlockTridiag<T>(7,3,2,label);
+    DoTestBlockTridiag<T>(16,1,3,label);
+    DoTestBlockTridiag<T>(33,4,1,label);
+    // Large enough that the cyclic reduction levels are split among
+    // the threads (n nrhs >= TMV_BLOCKTRIDIAG_OPENMP_THRESH bs).
+    DoTestBlockTridiag<T>(300,2,4,label);
+}
+
+template <class T> void TestBlockTridiagMatrix()
+{
+    TestBlockTridiag<T>("BlockTridiag");
+    TestBlockTridiag<std::complex<T> >("BlockTridiag complex");
+    std::cout<<"BlockTridiagMatrix<"<<Text(T())<<"> passed all tests\n";
+}
+
+#ifdef TEST_DOUBLE
+template void TestBlockTridiagMatrix<double>();
+#endif
+#ifdef TEST_FLOAT
+template void TestBlockTridiagMatrix<float>();
+#endif
+#ifdef TEST_LONGDOUBLE
+template void TestBlockTridiagMatrix<long double>();
+#endif
@@ -204,6 +204,97 @@ void TestMatrixDecomp()
             std::cout<<"."; std::cout.flush();
         } while (false);
 
+        // Cholesky and LDL Decompositions
+        // These need a hermitian matrix, so use m m^H, which is positive 
+        // definite, for CH and m + m^H, which is indefinite, for LDL.
+        // Only the lower triangle is used.
+        if (m.isSquare() && !singular) do {
+            if (showstartdone) {
+                std::cout<<"CH"<<std::endl;
+            }
+            tmv::Matrix<T,stor> h = m*m.adjoint();
+            FT normh = Norm(h);
+            tmv::LowerTriMatrix<T> L = h.chd().getL();
+            tmv::Matrix<T> LLt = L*L.adjoint();
+            if (showacc) {
+                std::cout<<"Norm(h-LLt) = "<<Norm(h-LLt)<<std::endl;
+                std::cout<<"cf "<<EPS*normh<<std::endl;
+            }
+            Assert(CheckDecomp(h.chd(),h,dbgout),"CH CheckDecomp");
+            Assert(Equal(h,LLt,EPS*FT(N)*normh),"CH"); 
+
+            tmv::Matrix<CT,stor> ch = c*c.adjoint();
+            FT normch = Norm(ch);
+            tmv::LowerTriMatrix<CT> cL = ch.chd().getL();
+            tmv::Matrix<CT> cLLt = cL*cL.adjoint();
+            if (showacc) {
+                std::cout<<"Norm(ch-cLLt) = "<<Norm(ch-cLLt)<<std::endl;
+                std::cout<<"cf "<<EPS*normch<<std::endl;
+            }
+            Assert(CheckDecomp(ch.chd(),ch,dbgout),"C CH CheckDecomp");
+            Assert(Equal(ch,cLLt,EPS*FT(N)*normch),"C CH"); 
+
+#if (XTEST & 16)
+            tmv::Matrix<T,stor> h2 = h;
+            CH_Decompose(h2);
+            L = h2.lowerTri();
+            LLt = L*L.adjoint();
+            Assert(Equal(h,LLt,EPS*FT(N)*normh),"CH2"); 
+
+            tmv::Matrix<CT,stor> ch2 = ch;
+            CH_Decompose(ch2);
+            cL = ch2.lowerTri();
+            cLLt = cL*cL.adjoint();
+            Assert(Equal(ch,cLLt,EPS*FT(N)*normch),"C CH2"); 
+#endif
+
+            if (showstartdone) {
+                std::cout<<"LDL"<<std::endl;
+            }
+            // Zeros at the start of the diagonal, with a large (1,0) element,
+            // force a 2x2 block as the first pivot.
+            tmv::Matrix<T,stor> s = m + m.adjoint();
+            s(0,0) = s(1,1) = T(0);
+            s(1,0) = s(0,1) = T(10) * s.maxAbsElement();
+            FT norms = Norm(s);
+            FT seps = EPS * norms * Norm(s.inverse());
+            tmv::Permutation sP = s.ldld().getP();
+            tmv::Matrix<T> sPL = sP * s.ldld().getL();
+            tmv::Matrix<T> sD = tmv::DiagMatrix<T>(s.ldld().getLx().diag());
+            sD.diag(-1) = s.ldld().getxD();
+            sD.diag(1) = s.ldld().getxD().conjugate();
+            tmv::Matrix<T> sPLDLP = sPL * sD * sPL.adjoint();
+            if (showacc) {
+                std::cout<<"Norm(s-PLDLP) = "<<Norm(s-sPLDLP)<<std::endl;
+                std::cout<<"cf "<<seps*norms<<std::endl;
+            }
+            Assert(s.ldld().getxD()(0) != T(0),"LDL 2x2 pivot");
+            Assert(CheckDecomp(s.ldld(),s,dbgout),"LDL CheckDecomp");
+            Assert(Equal(s,sPLDLP,seps*norms),"LDL"); 
+
+            tmv::Matrix<CT,stor> cs = c + c.adjoint();
+            cs(0,0) = cs(1,1) = CT(0);
+            cs(1,0) = CT(10) * cs.maxAbsElement() * CT(0.6,0.8);
+            cs(0,1) = std::conj(cs(1,0));
+            FT normcs = Norm(cs);
+            FT cseps = EPS * normcs * Norm(cs.inverse());
+            tmv::Permutation csP = cs.ldld().getP();
+            tmv::Matrix<CT> csPL = csP * cs.ldld().getL();
+            tmv::Matrix<CT> csD = 
+                tmv::DiagMatrix<CT>(cs.ldld().getLx().diag());
+            csD.diag(-1) = cs.ldld().getxD();
+            csD.diag(1) = cs.ldld().getxD().conjugate();
+            tmv::Matrix<CT> csPLDLP = csPL * csD * csPL.adjoint();
+            if (showacc) {
+                std::cout<<"Norm(cs-PLDLP) = "<<Norm(cs-csPLDLP)<<std::endl;
+                std::cout<<"cf "<<cseps*normcs<<std::endl;
+            }
+            Assert(cs.ldld().getxD()(0) != CT(0),"C LDL 2x2 pivot");
+            Assert(CheckDecomp(cs.ldld(),cs,dbgout),"C LDL CheckDecomp");
+            Assert(Equal(cs,csPLDLP,cseps*normcs),"C LDL"); 
+            std::cout<<"."; std::cout.flush();
+        } while (false);
+
         // QR Decomposition
         do {
             // QR Decomposition always works.  It just can't be used for
@@ -1016,6 +1016,156 @@ static void TestSingularDiv(tmv::DivType dt)
     }
 }
 
+// CH and LDL only use the lower triangle of m, so they need a 
+// hermitian matrix.  For CH, it is positive definite.  For LDL, it is 
+// indefinite, with zeros at the start of the diagonal so the first
+// pivot is a 2x2 block.
+template <class T, tmv::StorageType stor> 
+static void TestHermDiv(tmv::DivType dt)
+{
+    typedef typename tmv::Traits<T>::float_type FT;
+    typedef std::complex<T> CT;
+    const int N = 20;
+
+    tmv::Matrix<T,stor> a(N,N);
+    // Keep the determinant in range for float.
+    for(int i=0;i<N;++i) for(int j=0;j<N;++j) 
+        a(i,j) = T(2+4*i-5*j) / T(10*N);
+    for(int i=0;i<N;++i) a(i,i) += T(3);
+    tmv::Matrix<T,stor> m(N,N);
+    if (dt == tmv::CH) {
+        m = a * a.transpose();
+    } else {
+        m = a + a.transpose();
+        m(0,0) = m(1,1) = T(0);
+        m(1,0) = m(0,1) = T(10) * m.maxAbsElement();
+    }
+
+    tmv::Vector<T> b(N);
+    for(int i=0;i<N;++i) b(i) = T(3-2*i);
+
+    if (showstartdone) {
+        std::cout<<"Start TestHermDiv:\n";
+        std::cout<<"stor = "<<Text(stor)<<std::endl;
+        std::cout<<"dt = "<<Text(dt)<<std::endl;
+        std::cout<<"m = "<<m<<std::endl;
+    }
+
+    m.divideUsing(dt);
+    m.saveDiv();
+    Assert(m.getDivType() == dt,"Herm divideUsing");
+    Assert(m.divIsSaved(),"Herm saveDiv");
+    std::ostream* dbgout = showdiv ? &std::cout : 0;
+    if (dt == tmv::CH) Assert(CheckDecomp(m.chd(),m,dbgout),"CheckDecomp");
+    else Assert(CheckDecomp(m.ldld(),m,dbgout),"CheckDecomp");
+
+    tmv::Matrix<T> m0 = m;
+    m0.divideUsing(tmv::LU);
+    tmv::Matrix<T> m0inv = m0.inverse();
+    FT eps = EPS * Norm(m) * Norm(m0inv);
+
+    tmv::Vector<T> x = b/m;
+    tmv::Vector<T> b2 = m*x;
+    if (showacc) {
+        std::cout<<"x = b/m = "<<x<<std::endl;
+        std::cout<<"Norm(b-b2) = "<<Norm(b-b2)<<std::endl;
+    }
+    Assert(Norm(b2-b) < eps*Norm(b),"Herm b/m");
+
+    x = b%m;
+    b2 = x*m;
+    Assert(Norm(b2-b) < eps*Norm(b),"Herm b%m");
+
+    tmv::Matrix<T> minv = m.inverse();
+    Assert(Norm(m*minv-T(1)) < eps,"Herm inverse");
+    Assert(Norm(minv-m0inv) < eps*Norm(m0inv),"Herm inverse vs LU");
+
+    T mdet = m.det();
+    T mdet0 = m0.det();
+    if (showacc) {
+        std::cout<<"m.det() = "<<mdet<<"  LU det = "<<mdet0<<std::endl;
+    }
+    Assert(std::abs(mdet-mdet0) < eps*std::abs(mdet0),"Herm Det");
+    T sdet, sdet0;
+    Assert(std::abs(m.logDet(&sdet)-m0.logDet(&sdet0)) < eps,"Herm logDet");
+    Assert(sdet == sdet0,"Herm logDet - sign");
+
+    // With DivInPlaceFlag, the decomposition overwrites the matrix.
+    // The flag must not clobber the DivType.
+    tmv::Matrix<T,stor> m2 = m;
+    m2.divideUsing(dt);
+    m2.divideInPlace();
+    Assert(m2.getDivType() == dt,"Herm divideInPlace DivType");
+    Assert(m2.divIsInPlace() && m2.divIsSaved(),"Herm divideInPlace flags");
+    x = b/m2;
+    b2 = m*x;
+    Assert(Norm(b2-b) < eps*Norm(b),"Herm in place b/m");
+    Assert(!(Norm(m2-m) < eps*Norm(m)),"Herm in place overwrote m");
+    m2.dontDivideInPlace();
+    Assert(!m2.divIsInPlace() && m2.getDivType() == dt,
+           "Herm dontDivideInPlace");
+
+    tmv::Matrix<CT,stor> ca(N,N);
+    for(int i=0;i<N;++i) for(int j=0;j<N;++j) 
+        ca(i,j) = CT(2+4*i-5*j,3-i+2*j) / T(10*N);
+    for(int i=0;i<N;++i) ca(i,i) += T(3);
+    tmv::Matrix<CT,stor> c(N,N);
+    if (dt == tmv::CH) {
+        c = ca * ca.adjoint();
+    } else {
+        c = ca + ca.adjoint();
+        c(0,0) = c(1,1) = CT(0);
+        c(1,0) = T(10) * c.maxAbsElement() * CT(0.6,0.8);
+        c(0,1) = std::conj(c(1,0));
+    }
+    tmv::Vector<CT> cb(N);
+    for(int i=0;i<N;++i) cb(i) = CT(3-2*i,i);
+
+    c.divideUsing(dt);
+    c.saveDiv();
+    if (dt == tmv::CH) Assert(CheckDecomp(c.chd(),c,dbgout),"C CheckDecomp");
+    else Assert(CheckDecomp(c.ldld(),c,dbgout),"C CheckDecomp");
+
+    tmv::Matrix<CT> c0 = c;
+    c0.divideUsing(tmv::LU);
+    tmv::Matrix<CT> c0inv = c0.inverse();
+    FT ceps = EPS * Norm(c) * Norm(c0inv);
+
+    tmv::Vector<CT> cx = cb/c;
+    tmv::Vector<CT> cb2 = c*cx;
+    Assert(Norm(cb2-cb) < ceps*Norm(cb),"Herm cb/c");
+    cx = cb%c;
+    cb2 = cx*c;
+    Assert(Norm(cb2-cb) < ceps*Norm(cb),"Herm cb%c");
+
+    tmv::Matrix<CT> cinv = c.inverse();
+    Assert(Norm(c*cinv-T(1)) < ceps,"Herm Cinverse");
+    Assert(Norm(cinv-c0inv) < ceps*Norm(c0inv),"Herm Cinverse vs LU");
+
+    CT cdet = c.det();
+    CT cdet0 = c0.det();
+    if (showacc) {
+        std::cout<<"c.det() = "<<cdet<<"  LU det = "<<cdet0<<std::endl;
+    }
+    // The determinant of a hermitian matrix is real.
+    Assert(std::abs(cdet-cdet0) < ceps*std::abs(cdet0),"Herm Cdet");
+    Assert(std::abs(std::imag(cdet)) < ceps*std::abs(cdet0),
+           "Herm Cdet is real");
+    CT csdet, csdet0;
+    Assert(std::abs(c.logDet(&csdet)-c0.logDet(&csdet0)) < ceps,
+           "Herm ClogDet");
+    Assert(std::abs(csdet-csdet0) < ceps,"Herm ClogDet - sign");
+
+    if (stor == tmv::ColMajor) {
+#if (XTEST & 2)
+        TestHermDiv<T,tmv::RowMajor>(dt);
+    } else {
+#endif
+        std::cout<<"Hermitian Matrix<"<<Text(T())<<"> Division using ";
+        std::cout<<Text(dt)<<" passed all tests\n";
+    }
+}
+
 template <class T> void TestMatrixDiv()
 {
     TestMatrixDecomp<T,tmv::ColMajor>();
@@ -1027,6 +1177,13 @@ template <class T> void TestMatrixDiv()
     TestSquareDiv<T,tmv::ColMajor>(tmv::QR);
     TestSquareDiv<T,tmv::ColMajor>(tmv::QRP);
     TestSquareDiv<T,tmv::ColMajor>(tmv::SV);
+    // The flags are stored in the same field as the DivType, so they
+    // must not overlap any of the real DivType values.
+    Assert(!(tmv::DivInPlaceFlag & tmv::DivTypeFlags) &&
+           !(tmv::SaveDivFlag & tmv::DivTypeFlags) &&
+           (tmv::LDL & tmv::DivTypeFlags) == tmv::LDL,"DivType flags");
+    TestHermDiv<T,tmv::ColMajor>(tmv::CH);
+    TestHermDiv<T,tmv::ColMajor>(tmv::LDL);
     TestNonSquareDiv<T,tmv::ColMajor>(tmv::QR);
     TestNonSquareDiv<T,tmv::ColMajor>(tmv::QRP);
     TestNonSquareDiv<T,tmv::ColMajor>(tmv::SV);
@@ -0,0 +1,186 @@
+
+#include "TMV_Test.h"
+#include "TMV_Test_1.h"
+#include "TMV.h"
+
+// Check Tridiagonalize, Eigen_Decompose, Eigen_Values and
+// Eigen_DecomposeLargest for the hermitian matrix a.
+// Only the lower triangle of the input is used, but a is given in full
+// so the residuals can be checked directly.
+template <class T>
+static void DoTestEigen(const tmv::Matrix<T>& a, std::string label)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    typedef typename tmv::Traits<RT>::float_type FT;
+    const ptrdiff_t N = a.colsize();
+    const FT norma = Norm(a);
+    const FT eps = EPS * FT(N) * (norma > 0 ? norma : FT(1));
+
+    if (showstartdone) {
+        std::cout<<"Start DoTestEigen: "<<label<<", N = "<<N<<std::endl;
+    }
+
+    // Tridiagonalize: A = Q T Q^H
+    if (N > 1) {
+        tmv::Matrix<T> A = a;
+        tmv::Vector<RT> beta(N-1);
+        tmv::Vector<RT> D(N);
+        tmv::Vector<T> E(N-1);
+        tmv::Tridiagonalize(A,beta,D,E);
+        tmv::Matrix<T> Q(N,N,T(0));
+        Q(0,0) = T(1);
+        Q.subMatrix(1,N,1,N) = A.subMatrix(1,N,0,N-1);
+        tmv::MatrixView<T> Q1 = Q.subMatrix(1,N,1,N);
+        tmv::UnpackQ(Q1,beta);
+        tmv::Matrix<T> Tr(N,N,T(0));
+        Tr.diag() = D;
+        Tr.diag(-1) = E;
+        Tr.diag(1) = E.conjugate();
+        tmv::Matrix<T> QTQ = Q * Tr * Q.adjoint();
+        if (showacc) {
+            std::cout<<"Norm(a-QTQt) = "<<Norm(a-QTQ)<<std::endl;
+            std::cout<<"Norm(QtQ-1) = "<<Norm(Q.adjoint()*Q-T(1))<<std::endl;
+            std::cout<<"cf "<<eps<<std::endl;
+        }
+        Assert(Equal(a,QTQ,eps),label+" Tridiagonalize");
+        Assert(Equal(Q.adjoint()*Q,T(1),EPS*FT(N)),
+               label+" Tridiagonalize QtQ");
+    }
+
+    // Eigen_Decompose: A = Z diag(lambda) Z^H
+    tmv::Matrix<T> Z = a;
+    tmv::Vector<RT> lambda(N);
+    tmv::Eigen_Decompose(Z,lambda);
+    tmv::Matrix<T> aZ = a * Z;
+    tmv::Matrix<T> Zl = Z * tmv::DiagMatrix<RT>(lambda);
+    if (showacc) {
+        std::cout<<"lambda = "<<lambda<<std::endl;
+        std::cout<<"Norm(aZ-Zl) = "<<Norm(aZ-Zl)<<std::endl;
+        std::cout<<"Norm(ZtZ-1) = "<<Norm(Z.adjoint()*Z-T(1))<<std::endl;
+        std::cout<<"cf "<<eps<<std::endl;
+    }
+    Assert(Equal(aZ,Zl,eps),label+" Eigen_Decompose");
+    Assert(Equal(Z.adjoint()*Z,T(1),EPS*FT(N)),label+" Eigen_Decompose ZtZ");
+    for(ptrdiff_t i=1;i<N;++i)
+        Assert(lambda(i-1) <= lambda(i),label+" Eigen_Decompose order");
+
+    // Eigen_Values
+    tmv::Matrix<T> A2 = a;
+    tmv::Vector<RT> lambda2(N);
+    tmv::Eigen_Values(A2,lambda2);
+    if (showacc) {
+        std::cout<<"Norm(lambda-lambda2) = "<<Norm(lambda-lambda2)<<std::endl;
+    }
+    Assert(Equal(lambda2,lambda,eps),label+" Eigen_Values");
+    for(ptrdiff_t i=1;i<N;++i)
+        Assert(lambda2(i-1) <= lambda2(i),label+" Eigen_Values order");
+
+    // Eigen_DecomposeLargest with k = 1 and k = 3 (or N if N < 3).
+    for(ptrdiff_t k=1;k<=3 && k<=N;k+=2) {
+        tmv::Matrix<T> A3 = a;
+        tmv::Matrix<T> Z3(N,k);
+        tmv::Vector<RT> lambda3(k);
+        tmv::Eigen_DecomposeLargest(A3,Z3,lambda3);
+        tmv::Matrix<T> aZ3 = a * Z3;
+        tmv::Matrix<T> Zl3 = Z3 * tmv::DiagMatrix<RT>(lambda3);
+        if (showacc) {
+            std::cout<<"k = "<<k<<", lambda3 = "<<lambda3<<std::endl;
+            std::cout<<"Norm(aZ3-Zl3) = "<<Norm(aZ3-Zl3)<<std::endl;
+            std::cout<<"Norm(Z3tZ3-1) = "<<
+                Norm(Z3.adjoint()*Z3-T(1))<<std::endl;
+        }
+        Assert(Equal(aZ3,Zl3,eps),label+" Eigen_DecomposeLargest");
+        Assert(Equal(Z3.adjoint()*Z3,T(1),EPS*FT(N)),
+               label+" Eigen_DecomposeLargest ZtZ");
+        for(ptrdiff_t i=0;i<k;++i) {
+            Assert(std::abs(lambda3(i)-lambda(N-1-i)) <= eps,
+                   label+" Eigen_DecomposeLargest values");
+            // Bisection only finds degenerate values to within eps,
+            // so they might be out of order by that much.
+            if (i > 0) Assert(lambda3(i-1) >= lambda3(i) - eps,
+                              label+" Eigen_DecomposeLargest order");
+        }
+    }
+}
+
+// A hermitian matrix with the given eigenvalues, H diag(lambda) H,
+// where H is a Householder reflection, which is unitary and hermitian.
+template <class T>
+static tmv::Matrix<T> MakeHerm(const tmv::Vector<T>& lambda)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    const ptrdiff_t N = lambda.size();
+    tmv::Vector<T> v(N);
+    for(ptrdiff_t i=0;i<N;++i) v(i) = TestVal<T>::make(1+i%3,2-i%5);
+    tmv::Matrix<T> H = -RT(2)/NormSq(v) * (v ^ v.conjugate());
+    for(ptrdiff_t i=0;i<N;++i) H(i,i) += T(1);
+    return H * tmv::DiagMatrix<T>(lambda) * H;
+}
+
+template <class T>
+static void TestEigen(std::string label)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+
+    // A general hermitian matrix.  This is large enough to use the
+    // blocked tridiagonalization and several levels of divide and
+    // conquer, with the OpenMP tasks if they are enabled (N >=
+    // TMV_EIGEN_DC_OPENMP_THRESH = 256).
+    {
+        const ptrdiff_t N = 280;
+        tmv::Matrix<T> a(N,N);
+        for(ptrdiff_t i=0;i<N;++i) for(ptrdiff_t j=0;j<=i;++j) {
+            a(i,j) = i==j ? T(RT(i%7)-RT(3)) :
+                TestVal<T>::make(RT(2+4*i-5*j)/N,RT(i-2*j)/N);
+            a(j,i) = tmv::TMV_CONJ(a(i,j));
+        }
+        DoTestEigen(a,label+" general");
+    }
+
+    // Degenerate eigenvalues, including some that are split between
+    // the two halves of the top level divide step.
+    {
+        const ptrdiff_t N = 80;
+        tmv::Vector<T> lambda(N);
+        for(ptrdiff_t i=0;i<N;++i) lambda(i) = T(RT(i%4));
+        DoTestEigen(MakeHerm(lambda),label+" degenerate");
+    }
+
+    // A diagonal matrix, so E = 0 and everything deflates.
+    {
+        const ptrdiff_t N = 60;
+        tmv::Matrix<T> a(N,N,T(0));
+        for(ptrdiff_t i=0;i<N;++i) a(i,i) = T(RT((7*i)%N)-RT(N/2));
+        DoTestEigen(a,label+" diagonal");
+    }
+
+    // The smallest sizes.
+    {
+        tmv::Matrix<T> a(1,1);
+        a(0,0) = T(3);
+        DoTestEigen(a,label+" N=1");
+        tmv::Matrix<T> b(2,2);
+        b(0,0) = T(2);
+        b(1,1) = T(-1);
+        b(1,0) = TestVal<T>::make(1,-2);
+        b(0,1) = tmv::TMV_CONJ(b(1,0));
+        DoTestEigen(b,label+" N=2");
+    }
+}
+
+template <class T> void TestMatrixEigen()
+{
+    TestEigen<T>("Eigen");
+    TestEigen<std::complex<T> >("Eigen complex");
+    std::cout<<"Matrix<"<<Text(T())<<"> passed all eigen tests.\n";
+}
+
+#ifdef TEST_DOUBLE
+template void TestMatrixEigen<double>();
+#endif
+#ifdef TEST_FLOAT
+template void TestMatrixEigen<float>();
+#endif
+#ifdef TEST_LONGDOUBLE
+template void TestMatrixEigen<long double>();
+#endif
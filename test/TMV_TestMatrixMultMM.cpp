@@ -0,0 +1,195 @@
+
+#include "TMV_Test.h"
+#include "TMV_Test_1.h"
+#include "TMV.h"
+#include "tmv/TMV_MultMM_Block.h"
+#include "tmv/TMV_MultMM_Packed.h"
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+template <class T, class M>
+static void FillMM(M& m, int seed)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    for(ptrdiff_t i=0;i<m.colsize();++i) for(ptrdiff_t j=0;j<m.rowsize();++j)
+        m(i,j) = TestVal<T>::make(
+            RT((3*i+5*j+seed)%11)-RT(5),RT((i+2*j+seed)%7)-RT(3)) / RT(4);
+}
+
+// Check the packed algorithm (algo 65 in TMV_MultMM.h) against the
+// block algorithm for an M x K times K x N product, with m1 in either
+// storage order.  The sizes are all above TMV_MM_MIN_PACKED, so the
+// regular m1*m2 uses algo 65 as well.
+template <class T, tmv::StorageType stor1, tmv::StorageType stor2>
+static void DoTestMultMMPacked(ptrdiff_t M, ptrdiff_t N, ptrdiff_t K)
+{
+    typedef typename tmv::Traits<T>::float_type FT;
+    std::string label = std::string("MultMM_Packed ") +
+        tmv::TMV_Text(stor1) + " " + tmv::TMV_Text(stor2);
+
+    if (showstartdone) {
+        std::cout<<"Start "<<label<<": M,N,K = "<<
+            M<<','<<N<<','<<K<<std::endl;
+    }
+
+    tmv::Matrix<T,stor1> m1(M,K);
+    tmv::Matrix<T,stor2> m2(K,N);
+    FillMM<T>(m1,0);
+    FillMM<T>(m2,1);
+    tmv::Matrix<T> m0(M,N);
+    FillMM<T>(m0,2);
+    const T x(3);
+    const FT eps = EPS * FT(K) * Norm(m1) * Norm(m2) * FT(3);
+
+    tmv::Matrix<T> mb = m0;
+    tmv::InlineMultMM_Block<false>(tmv::Scaling<0,T>(x),m1,m2,mb);
+
+    tmv::Matrix<T> mp = m0;
+    tmv::MultMM_Packed<false>(tmv::Scaling<0,T>(x),m1,m2,mp);
+    Assert(Equal(mp,mb,eps),label);
+    mp = m0;
+    tmv::InlineMultMM_Packed<false>(tmv::Scaling<0,T>(x),m1,m2,mp);
+    Assert(Equal(mp,mb,eps),label+" inline");
+
+    tmv::Matrix<T> mba = m0;
+    tmv::InlineMultMM_Block<true>(tmv::Scaling<0,T>(x),m1,m2,mba);
+    mp = m0;
+    tmv::MultMM_Packed<true>(tmv::Scaling<0,T>(x),m1,m2,mp);
+    Assert(Equal(mp,mba,eps),label+" add");
+
+    mp = x*m1*m2;
+    Assert(Equal(mp,mb,eps),label+" m1*m2");
+    mp = m0;
+    mp += x*m1*m2;
+    Assert(Equal(mp,mba,eps),label+" m3 += m1*m2");
+
+    // Views that don't start at the beginning of the storage, and have
+    // a non-unit step in m3.
+    tmv::Matrix<T> m3x(2*M+1,N,T(0));
+    tmv::MatrixView<T> m3v = m3x.subMatrix(1,2*M-1,0,N,2,1);
+    tmv::MatrixView<T> mbv = mb.subMatrix(0,M-1,0,N);
+    mbv.setZero();
+    tmv::MultMM_Packed<false>(
+        tmv::Scaling<0,T>(x),m1.subMatrix(1,M,1,K),m2.subMatrix(1,K,0,N),
+        m3v);
+    tmv::InlineMultMM_Block<false>(
+        tmv::Scaling<0,T>(x),m1.subMatrix(1,M,1,K),m2.subMatrix(1,K,0,N),
+        mbv);
+    Assert(Equal(m3v,mbv,eps),
+           label+" views");
+}
+
+#ifdef _OPENMP
+// Check the OpenMP algorithm (algo 69 in TMV_MultMM.h) against the 
+// serial block algorithm.  m1*m2 only uses algo 69 when there is more 
+// than one thread, so we run it with 4 threads.  (The number of cores 
+// doesn't matter; the threads just take turns.)  The sizes select 
+// whether m3 is split into 2D tiles, or K is split as well because 
+// there are too few tiles.
+template <class T, tmv::StorageType stor1, tmv::StorageType stor2>
+static void DoTestMultMMOpenMP(ptrdiff_t M, ptrdiff_t N, ptrdiff_t K)
+{
+    typedef typename tmv::Traits<T>::float_type FT;
+    std::string label = std::string("MultMM_OpenMP ") +
+        tmv::TMV_Text(stor1) + " " + tmv::TMV_Text(stor2);
+
+    if (showstartdone) {
+        std::cout<<"Start "<<label<<": M,N,K = "<<
+            M<<','<<N<<','<<K<<std::endl;
+    }
+
+    tmv::Matrix<T,stor1> m1(M,K);
+    tmv::Matrix<T,stor2> m2(K,N);
+    FillMM<T>(m1,3);
+    FillMM<T>(m2,4);
+    tmv::Matrix<T> m0(M,N);
+    FillMM<T>(m0,5);
+    const T x(3);
+    const FT eps = EPS * FT(K) * Norm(m1) * Norm(m2) * FT(3);
+
+    tmv::Matrix<T> mb = m0;
+    tmv::InlineMultMM_Block<false>(tmv::Scaling<0,T>(x),m1,m2,mb);
+    tmv::Matrix<T> mba = m0;
+    tmv::InlineMultMM_Block<true>(tmv::Scaling<0,T>(x),m1,m2,mba);
+
+    const int nthreads = omp_get_max_threads();
+    omp_set_num_threads(4);
+
+    tmv::Matrix<T> mp(M,N);
+#ifndef TMV_NO_ALGO_TRACE
+    tmv::ResetAlgoTrace();
+    tmv::EnableAlgoTrace();
+#endif
+    mp = x*m1*m2;
+#ifndef TMV_NO_ALGO_TRACE
+    tmv::DisableAlgoTrace();
+    std::vector<tmv::AlgoTraceRecord> recs;
+    tmv::GetAlgoTrace(recs);
+    bool used69 = false;
+    for(size_t i=0;i<recs.size();++i)
+        if (std::string("MultMM") == recs[i].op && recs[i].algo == 69)
+            used69 = true;
+    Assert(used69,label+" used algo 69");
+    tmv::ResetAlgoTrace();
+#endif
+    Assert(Equal(mp,mb,eps),label);
+    mp = m0;
+    mp += x*m1*m2;
+    Assert(Equal(mp,mba,eps),label+" add");
+
+    // Views that don't start at the beginning of the storage, and have
+    // a non-unit step in m3.
+    tmv::Matrix<T> m3x(2*M+1,N,T(0));
+    tmv::MatrixView<T> m3v = m3x.subMatrix(1,2*M-1,0,N,2,1);
+    tmv::MatrixView<T> mbv = mb.subMatrix(0,M-1,0,N);
+    tmv::InlineMultMM_Block<false>(
+        tmv::Scaling<0,T>(x),m1.subMatrix(1,M,1,K),m2.subMatrix(1,K,0,N),
+        mbv);
+    m3v = x*m1.subMatrix(1,M,1,K)*m2.subMatrix(1,K,0,N);
+    Assert(Equal(m3v,mbv,eps),label+" views");
+    m3v += x*m1.subMatrix(1,M,1,K)*m2.subMatrix(1,K,0,N);
+    mbv *= FT(2);
+    Assert(Equal(m3v,mbv,eps),label+" views add");
+
+    omp_set_num_threads(nthreads);
+}
+#endif
+
+template <class T>
+void TestMatrixMultMM()
+{
+    // The sizes aren't multiples of the micro-kernel size, and
+    // K > KC, M > MC, so there are partial panels at each level.
+    const ptrdiff_t mp = TMV_MM_MIN_PACKED;
+    DoTestMultMMPacked<T,tmv::ColMajor,tmv::ColMajor>(mp,mp,mp);
+    DoTestMultMMPacked<T,tmv::ColMajor,tmv::ColMajor>(mp+69,mp+3,2*mp+5);
+    DoTestMultMMPacked<T,tmv::RowMajor,tmv::ColMajor>(mp+69,mp+3,2*mp+5);
+    DoTestMultMMPacked<T,tmv::ColMajor,tmv::RowMajor>(mp+1,mp+17,mp+2);
+    DoTestMultMMPacked<T,tmv::RowMajor,tmv::RowMajor>(mp+1,mp+17,mp+2);
+
+#ifdef _OPENMP
+    // 2D tiles of m3.
+    DoTestMultMMOpenMP<T,tmv::ColMajor,tmv::ColMajor>(300,260,200);
+    DoTestMultMMOpenMP<T,tmv::RowMajor,tmv::ColMajor>(300,260,200);
+    DoTestMultMMOpenMP<T,tmv::ColMajor,tmv::RowMajor>(259,301,150);
+    // Too few tiles of m3 for the threads, so K is split too.
+    DoTestMultMMOpenMP<T,tmv::ColMajor,tmv::ColMajor>(64,64,1500);
+    DoTestMultMMOpenMP<T,tmv::RowMajor,tmv::ColMajor>(130,20,700);
+    // Only K is large.
+    DoTestMultMMOpenMP<T,tmv::ColMajor,tmv::ColMajor>(40,40,600);
+#endif
+
+    std::cout<<"Matrix<"<<Text(T())<<"> MultMM passed all tests\n";
+}
+
+#ifdef TEST_DOUBLE
+template void TestMatrixMultMM<double>();
+#endif
+#ifdef TEST_FLOAT
+template void TestMatrixMultMM<float>();
+#endif
+#ifdef TEST_LONGDOUBLE
+template void TestMatrixMultMM<long double>();
+#endif
@@ -0,0 +1,445 @@
+
+#include "TMV_Test.h"
+#include "TMV_Test_1.h"
+#include "TMV.h"
+#include <vector>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// These test the OpenMP versions of the decompositions against the
+// serial versions.  The parallel algorithms are only used above some
+// minimum size, and only when there is more than one thread, so we
+// run each calculation with 1 thread and then with NTHREADS threads.
+// (The number of cores doesn't matter; the tasks just take turns.)
+#define NTHREADS 4
+
+#ifdef _OPENMP
+// A pseudo-random matrix with values in (-1,1), so the pivots are
+// not ambiguous.
+template <class T, int A>
+static void OpenMPFill(tmv::Matrix<T,A>& m, unsigned long seed)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    unsigned long s = seed;
+    for(ptrdiff_t j=0;j<m.rowsize();++j) for(ptrdiff_t i=0;i<m.colsize();++i) {
+        RT x[2];
+        for(int k=0;k<2;++k) {
+            s = (s * 1103515245UL + 12345UL) & 0x7fffffffUL;
+            x[k] = RT(2) * RT(s) / RT(0x7fffffffUL) - RT(1);
+        }
+        m(i,j) = TestVal<T>::make(x[0],x[1]);
+    }
+}
+
+#ifndef TMV_NO_ALGO_TRACE
+// Returns whether op was called with the given algorithm.
+static bool OpenMPUsedAlgo(const char* op, int algo)
+{
+    std::vector<tmv::AlgoTraceRecord> recs;
+    tmv::GetAlgoTrace(recs);
+    for(size_t i=0;i<recs.size();++i)
+        if (std::string(op) == recs[i].op && recs[i].algo == algo)
+            return true;
+    return false;
+}
+#endif
+
+// LU_Decompose uses the task algorithm 31 when min(M,N) is at least
+// TMV_LU_OPENMP_THRESH (512).  The pivots should be the same as the
+// serial algorithm, and the factors should agree to rounding error.
+template <class T>
+static void TestOpenMPLU(ptrdiff_t M, ptrdiff_t N)
+{
+    typedef typename tmv::Traits<T>::real_type FT;
+    if (showstartdone) {
+        std::cout<<"Start TestOpenMPLU: "<<tmv::TMV_Text(T())<<
+            ", M,N = "<<M<<','<<N<<std::endl;
+    }
+    tmv::Matrix<T> m(M,N);
+    OpenMPFill(m,1234+M);
+    const ptrdiff_t R = std::min(M,N);
+
+    tmv::Matrix<T> lu1 = m;
+    std::vector<ptrdiff_t> P1(M);
+    omp_set_num_threads(1);
+    tmv::LU_Decompose(lu1,&P1[0]);
+
+    tmv::Matrix<T> lu2 = m;
+    std::vector<ptrdiff_t> P2(M);
+    omp_set_num_threads(NTHREADS);
+#ifndef TMV_NO_ALGO_TRACE
+    tmv::ResetAlgoTrace();
+    tmv::EnableAlgoTrace();
+#endif
+    tmv::LU_Decompose(lu2,&P2[0]);
+#ifndef TMV_NO_ALGO_TRACE
+    tmv::DisableAlgoTrace();
+    Assert(OpenMPUsedAlgo("LU_Decompose",31),"OpenMP LU used algo 31");
+    tmv::ResetAlgoTrace();
+#endif
+
+    bool samep = true;
+    for(ptrdiff_t i=0;i<R;++i) if (P1[i] != P2[i]) samep = false;
+    Assert(samep,"OpenMP LU pivots");
+    const FT eps = EPS * M * Norm(m);
+    Assert(Equal(lu1,lu2,eps),"OpenMP LU factors");
+
+    // And P L U = m.
+    tmv::Matrix<T> l = lu2.colRange(0,R);
+    tmv::Matrix<T> u = lu2.rowRange(0,R);
+    for(ptrdiff_t j=0;j<R;++j) {
+        l.col(j,0,j).setZero();
+        l(j,j) = T(1);
+        u.col(j,j+1,R).setZero();
+    }
+    tmv::Matrix<T> plu = l * u;
+    for(ptrdiff_t i=R-1;i>=0;--i) plu.swapRows(i,P2[i]);
+    Assert(Equal(plu,m,eps),"OpenMP LU P L U = m");
+}
+
+// R and Q are only unique up to a diagonal matrix of phases, which 
+// may be different for TSQR: Q1 R1 = (Q2 S*) (S R2).  So scale the
+// rows of R2 and the columns of Q2 to match R1 before comparing.
+template <class T>
+static void OpenMPMatchPhases(
+    const tmv::Matrix<T>& Q1, const tmv::UpperTriMatrix<T>& R1,
+    tmv::Matrix<T>& Q2, tmv::UpperTriMatrix<T>& R2)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    for(ptrdiff_t i=0;i<R1.size();++i) {
+        const T s = R2(i,i) == T(0) ? T(1) : R1(i,i) / R2(i,i);
+        const RT abss = tmv::TMV_ABS(s);
+        Assert(std::abs(abss-RT(1)) < RT(1.e-3),"OpenMP QR phase");
+        R2.row(i,i,R2.size()) *= s;
+        Q2.col(i) *= tmv::TMV_CONJ(s);
+    }
+}
+
+// QR_Decompose uses TSQR (recorded as algo 41) when there are at least 
+// TMV_QR_TSQR_MINTHREADS (4) threads, M >= TMV_QR_TSQR_RATIO*N (8N) and 
+// M*N >= TMV_QR_TSQR_MINSIZE.  And UnpackQ uses ParallelUnpackQ when
+// M*N*N >= TMV_QR_OPENMP_THRESH and N >= 2*TMV_QR_OPENMP_MINCOLS.
+template <class T>
+static void TestOpenMPQR(ptrdiff_t M, ptrdiff_t N)
+{
+    typedef typename tmv::Traits<T>::real_type FT;
+    if (showstartdone) {
+        std::cout<<"Start TestOpenMPQR: "<<tmv::TMV_Text(T())<<
+            ", M,N = "<<M<<','<<N<<std::endl;
+    }
+    tmv::Matrix<T> m(M,N);
+    OpenMPFill(m,5678+M);
+    const FT eps = EPS * M * Norm(m);
+
+    omp_set_num_threads(1);
+    tmv::Matrix<T> qr1 = m;
+    tmv::Vector<FT> beta1(N);
+    tmv::QR_Decompose(qr1,beta1);
+    tmv::UpperTriMatrix<T> R1 = qr1.upperTri();
+    tmv::Matrix<T> Q1 = qr1;
+    tmv::UnpackQ(Q1,beta1);
+
+    omp_set_num_threads(NTHREADS);
+#ifndef TMV_NO_ALGO_TRACE
+    tmv::ResetAlgoTrace();
+    tmv::EnableAlgoTrace();
+#endif
+    tmv::Matrix<T> qr2 = m;
+    tmv::Vector<FT> beta2(N);
+    tmv::QR_Decompose(qr2,beta2);
+#ifndef TMV_NO_ALGO_TRACE
+    tmv::DisableAlgoTrace();
+    Assert(OpenMPUsedAlgo("QR_Decompose",41),"OpenMP QR used TSQR");
+    tmv::ResetAlgoTrace();
+#endif
+    tmv::UpperTriMatrix<T> R2 = qr2.upperTri();
+    tmv::Matrix<T> Q2 = qr2;
+    tmv::UnpackQ(Q2,beta2);
+
+    // The TSQR packed form is a valid set of Householder reflections.
+    for(ptrdiff_t j=0;j<N;++j) {
+        Assert(beta2(j) >= FT(0) && beta2(j) <= FT(2),"OpenMP QR beta");
+    }
+    Assert(Equal(Q2*R2,m,eps),"OpenMP QR Q R = m");
+    Assert(Equal(Q2.adjoint()*Q2,T(1),eps),"OpenMP QR QtQ = 1");
+
+    OpenMPMatchPhases(Q1,R1,Q2,R2);
+    Assert(Equal(R1,R2,eps),"OpenMP QR R");
+    Assert(Equal(Q1,Q2,eps),"OpenMP QR Q");
+
+    // ParallelUnpackQ gives the same Q as the serial unpack from the 
+    // same Householder vectors.
+    tmv::Matrix<T> Q3 = qr1;
+    tmv::UnpackQ(Q3,beta1);
+    Assert(Equal(Q1,Q3,eps),"OpenMP UnpackQ");
+}
+
+// The divide and conquer SVD does the two halves of each divide step
+// as tasks when N >= TMV_DC_OPENMP_THRESH (256), and splits up the 
+// secular equation solves.  The singular values should be the same as
+// the serial ones, and the singular vectors should be the same up to 
+// a sign, since the singular values are well separated.
+template <class T>
+static void TestOpenMPBidiagSVD(ptrdiff_t N)
+{
+    typedef typename tmv::Traits<T>::real_type FT;
+    if (showstartdone) {
+        std::cout<<"Start TestOpenMPBidiagSVD: "<<tmv::TMV_Text(T())<<
+            ", N = "<<N<<std::endl;
+    }
+    tmv::Matrix<FT> de(N,2);
+    OpenMPFill(de,4321+N);
+    tmv::Vector<FT> D0(N);
+    tmv::Vector<FT> E0(N-1);
+    for(ptrdiff_t i=0;i<N;++i) D0(i) = de(i,0) + FT(1.2);
+    for(ptrdiff_t i=0;i<N-1;++i) E0(i) = de(i,1) + FT(1.2);
+    const FT normB = std::sqrt(NormSq(D0) + NormSq(E0));
+    const FT eps = EPS * N * normB;
+
+    // Start with a U that isn't the identity, so the DC algorithm has 
+    // to multiply it by the singular vectors of B.
+    tmv::Matrix<T> U0(N+10,N);
+    OpenMPFill(U0,8765+N);
+    tmv::QR_Decompose(U0);
+
+    omp_set_num_threads(1);
+    tmv::Matrix<T> U1 = U0;
+    tmv::Matrix<T> V1(N,N);
+    V1.setToIdentity();
+    tmv::Vector<FT> D1 = D0;
+    tmv::Vector<FT> E1 = E0;
+    tmv::SV_DecomposeFromBidiagonal_DC(U1,D1,E1,V1,false,true);
+
+    omp_set_num_threads(NTHREADS);
+    tmv::Matrix<T> U2 = U0;
+    tmv::Matrix<T> V2(N,N);
+    V2.setToIdentity();
+    tmv::Vector<FT> D2 = D0;
+    tmv::Vector<FT> E2 = E0;
+    tmv::SV_DecomposeFromBidiagonal_DC(U2,D2,E2,V2,false,true);
+
+    Assert(Equal(D1,D2,eps),"OpenMP DC SVD S");
+
+    // U0 B V2^T = U2 S.  Row i of B V^T is D0(i) V.col(i) + E0(i) V.col(i+1).
+    tmv::Matrix<T> BVt(N,N);
+    for(ptrdiff_t i=0;i<N;++i) {
+        BVt.row(i) = D0(i) * V2.col(i);
+        if (i < N-1) BVt.row(i) += E0(i) * V2.col(i+1);
+    }
+    tmv::Matrix<T> US = U2;
+    for(ptrdiff_t j=0;j<N;++j) US.col(j) *= D2(j);
+    Assert(Equal(U0*BVt,US,eps),"OpenMP DC SVD U B Vt = U S");
+    Assert(Equal(V2*V2.transpose(),T(1),eps),"OpenMP DC SVD V Vt = 1");
+
+    for(ptrdiff_t j=0;j<N;++j) {
+        if (tmv::TMV_REAL(U1.col(j).conjugate() * U2.col(j)) < FT(0)) {
+            U2.col(j) *= FT(-1);
+            V2.row(j) *= FT(-1);
+        }
+    }
+    Assert(Equal(U1,U2,eps),"OpenMP DC SVD U");
+    Assert(Equal(V1,V2,eps),"OpenMP DC SVD V");
+}
+
+// The full SVD uses the DC algorithm for the bidiagonal matrix, both
+// with and without the singular vectors.
+template <class T>
+static void TestOpenMPSVD(ptrdiff_t M, ptrdiff_t N)
+{
+    typedef typename tmv::Traits<T>::real_type FT;
+    if (showstartdone) {
+        std::cout<<"Start TestOpenMPSVD: "<<tmv::TMV_Text(T())<<
+            ", M,N = "<<M<<','<<N<<std::endl;
+    }
+    tmv::Matrix<T> m(M,N);
+    OpenMPFill(m,2468+M);
+    const FT eps = EPS * M * Norm(m);
+
+    omp_set_num_threads(1);
+    tmv::Matrix<T> U1 = m;
+    tmv::DiagMatrix<FT> S1(N);
+    tmv::Matrix<T> V1(N,N);
+    tmv::SV_Decompose(U1.view(),S1.view(),V1.view());
+
+    omp_set_num_threads(NTHREADS);
+    tmv::Matrix<T> U2 = m;
+    tmv::DiagMatrix<FT> S2(N);
+    tmv::Matrix<T> V2(N,N);
+    tmv::SV_Decompose(U2.view(),S2.view(),V2.view());
+    Assert(Equal(S1,S2,eps),"OpenMP SVD S");
+    Assert(Equal(U2*S2*V2,m,eps),"OpenMP SVD U S V = m");
+    Assert(Equal(U2.adjoint()*U2,T(1),eps),"OpenMP SVD UtU = 1");
+    Assert(Equal(V2*V2.adjoint(),T(1),eps),"OpenMP SVD VVt = 1");
+
+    tmv::Matrix<T> m3 = m;
+    tmv::DiagMatrix<FT> S3(N);
+    tmv::SV_Decompose(m3.view(),S3.view(),false);
+    Assert(Equal(S1,S3,eps),"OpenMP SVD S only");
+}
+
+// The triangular solve (LDivEqMU), multiply (MultUM) and inverse 
+// (InvertU) have a task algorithm 37, which splits the problem into 
+// tiles of 128 rows and columns.  These are compared directly with the
+// serial algorithms 17 (upper) and 27 (lower).
+template <class T, class Tri>
+static void TestOpenMPTriDiv(ptrdiff_t M, ptrdiff_t N)
+{
+    typedef typename tmv::Traits<T>::real_type FT;
+    typedef tmv::Matrix<T,tmv::ColMajor> MM;
+    typedef typename MM::view_type MV;
+    typedef typename MM::const_view_type MCV;
+    typedef typename Tri::const_view_type TCV;
+    const ptrdiff_t xx = tmv::Unknown;
+    const bool upper = Tri::_upper;
+    const int algo2 = upper ? 17 : 27;
+    std::string label = std::string("OpenMP ") + (upper ? "U " : "L ") +
+        tmv::TMV_Text(T());
+    if (showstartdone) {
+        std::cout<<"Start TestOpenMPTriDiv: "<<label<<
+            ", M,N = "<<M<<','<<N<<std::endl;
+    }
+
+    MM a(M,M);
+    OpenMPFill(a,1357+M);
+    for(ptrdiff_t i=0;i<M;++i) a(i,i) += T(M/4);
+    Tri t(a);
+    TCV tv = t.view();
+    MM x0(M,N);
+    OpenMPFill(x0,9753+N);
+    const FT eps = EPS * M * Norm(x0) * Norm(t);
+
+    omp_set_num_threads(NTHREADS);
+
+    // X = T^-1 X
+    MM x1 = x0;
+    MM x2 = x0;
+    MV x1v = x1.view();
+    MV x2v = x2.view();
+    tmv::LDivEqMU_Helper<algo2,xx,xx,MV,TCV>::call(x1v,tv);
+    tmv::LDivEqMU_Helper<37,xx,xx,MV,TCV>::call(x2v,tv);
+    Assert(Equal(x1,x2,eps),label+" LDivEqMU algo 37");
+    Assert(Equal(t*x2,x0,eps),label+" LDivEqMU T X = X0");
+    MM x3 = x0;
+    x3 /= t;
+    Assert(Equal(x1,x3,eps),label+" LDivEqMU automatic");
+
+    // Y = T X
+    MCV x0v = x0.view();
+    const tmv::Scaling<1,FT> one;
+    MM y1(M,N);
+    MM y2(M,N);
+    MV y1v = y1.view();
+    MV y2v = y2.view();
+    tmv::MultUM_Helper<algo2,xx,xx,false,1,FT,TCV,MCV,MV>::call(
+        one,tv,x0v,y1v);
+    tmv::MultUM_Helper<37,xx,xx,false,1,FT,TCV,MCV,MV>::call(
+        one,tv,x0v,y2v);
+    Assert(Equal(y1,y2,eps),label+" MultUM algo 37");
+
+    // Y += -T X
+    const tmv::Scaling<-1,FT> mone;
+    MM y3 = x0;
+    MM y4 = x0;
+    MV y3v = y3.view();
+    MV y4v = y4.view();
+    tmv::MultUM_Helper<algo2,xx,xx,true,-1,FT,TCV,MCV,MV>::call(
+        mone,tv,x0v,y3v);
+    tmv::MultUM_Helper<37,xx,xx,true,-1,FT,TCV,MCV,MV>::call(
+        mone,tv,x0v,y4v);
+    Assert(Equal(y3,y4,eps),label+" MultUM algo 37 add");
+    Assert(Equal(y4,x0-y1,eps),label+" MultUM add = X - T X");
+
+    // X = T X in place, which can only split the columns.
+    MM y5 = x0;
+    MV y5v = y5.view();
+    MCV y5cv = y5.view();
+    tmv::MultUM_Helper<37,xx,xx,false,1,FT,TCV,MCV,MV>::call(
+        one,tv,y5cv,y5v);
+    Assert(Equal(y1,y5,eps),label+" MultUM algo 37 in place");
+}
+
+// The inverse only has an upper triangle version.  (Lower triangle 
+// matrices use the transpose.)  Algos 17 and 37 expect the diagonal to
+// be inverted already.
+template <class T>
+static void TestOpenMPInvertU(ptrdiff_t N)
+{
+    typedef typename tmv::Traits<T>::real_type FT;
+    typedef tmv::UpperTriMatrix<T,tmv::NonUnitDiag|tmv::ColMajor> UM;
+    typedef typename UM::view_type UV;
+    typedef typename UV::diag_type DV;
+    const ptrdiff_t xx = tmv::Unknown;
+    std::string label = std::string("OpenMP InvertU ") + tmv::TMV_Text(T());
+    if (showstartdone) {
+        std::cout<<"Start TestOpenMPInvertU: "<<label<<", N = "<<N<<std::endl;
+    }
+
+    tmv::Matrix<T> a(N,N);
+    OpenMPFill(a,2468+N);
+    for(ptrdiff_t i=0;i<N;++i) a(i,i) += T(N/4);
+    UM u(a);
+    const FT eps = EPS * N * Norm(u);
+
+    omp_set_num_threads(NTHREADS);
+    UM u1 = u;
+    UM u2 = u;
+    UV u1v = u1.view();
+    UV u2v = u2.view();
+    DV d1 = u1v.diag();
+    DV d2 = u2v.diag();
+    tmv::ElemInvert_Helper<-4,xx,DV>::call(d1);
+    tmv::ElemInvert_Helper<-4,xx,DV>::call(d2);
+    tmv::InvertU_Helper<17,xx,UV>::call(u1v);
+    tmv::InvertU_Helper<37,xx,UV>::call(u2v);
+    Assert(Equal(u1,u2,eps/Norm(u)),label+" algo 37");
+    Assert(Equal(u*u2,T(1),eps),label+" U U^-1 = 1");
+}
+#endif
+
+template <class T>
+void TestMatrixOpenMP()
+{
+#ifdef _OPENMP
+    const int nthreads = omp_get_max_threads();
+
+    // M > N, with N not a multiple of the panel width.
+    TestOpenMPLU<T>(600,520);
+    // N > M, so some column blocks are only updated.
+    TestOpenMPLU<T>(520,700);
+    TestOpenMPLU<std::complex<T> >(530,515);
+
+    // M = 8N exactly.
+    TestOpenMPQR<T>(1456,182);
+    // A small N, which has more leaves.
+    TestOpenMPQR<T>(4800,64);
+    TestOpenMPQR<std::complex<T> >(2100,128);
+
+    TestOpenMPBidiagSVD<T>(400);
+    TestOpenMPBidiagSVD<std::complex<T> >(300);
+    TestOpenMPSVD<T>(320,300);
+    TestOpenMPSVD<std::complex<T> >(280,260);
+
+    typedef tmv::UpperTriMatrix<T,tmv::NonUnitDiag|tmv::ColMajor> UM;
+    typedef tmv::LowerTriMatrix<T,tmv::NonUnitDiag|tmv::ColMajor> LM;
+    typedef tmv::UpperTriMatrix<std::complex<T>,tmv::NonUnitDiag|tmv::ColMajor> CUM;
+    typedef tmv::LowerTriMatrix<std::complex<T>,tmv::NonUnitDiag|tmv::RowMajor> CLM;
+    TestOpenMPTriDiv<T,UM>(300,200);
+    TestOpenMPTriDiv<T,LM>(300,200);
+    TestOpenMPTriDiv<std::complex<T>,CUM>(260,140);
+    TestOpenMPTriDiv<std::complex<T>,CLM>(260,140);
+    TestOpenMPInvertU<T>(600);
+    TestOpenMPInvertU<std::complex<T> >(530);
+
+    omp_set_num_threads(nthreads);
+#endif
+    std::cout<<"MatrixOpenMP<"<<Text(T())<<"> passed all tests\n";
+}
+
+#ifdef TEST_DOUBLE
+template void TestMatrixOpenMP<double>();
+#endif
+#ifdef TEST_FLOAT
+template void TestMatrixOpenMP<float>();
+#endif
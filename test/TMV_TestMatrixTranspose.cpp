@@ -0,0 +1,274 @@
+
+#include "TMV_Test.h"
+#include "TMV_Test_1.h"
+#include "TMV.h"
+
+template <class T>
+static T TransposeVal(ptrdiff_t i, ptrdiff_t j)
+{ return TestVal<T>::make(1000*i+j+1,j-2*i); }
+
+// Check that the elements of m outside of rows i1..i2 and columns j1..j2
+// are all still z.
+template <class M, class T>
+static bool Untouched(
+    const M& m, ptrdiff_t i1, ptrdiff_t i2, ptrdiff_t j1, ptrdiff_t j2, T z)
+{
+    for(ptrdiff_t i=0;i<m.colsize();++i) for(ptrdiff_t j=0;j<m.rowsize();++j)
+        if ((i<i1 || i>=i2 || j<j1 || j>=j2) && m(i,j) != z) return false;
+    return true;
+}
+
+// Check the copy between opposite storage orders (CopyM algos 40-42)
+// for an M x N matrix.  Both matrices are views into larger matrices
+// that start at an offset, so the first element isn't aligned, and
+// the distance between rows or columns is more than M or N.
+template <class T1, class T2>
+static void DoTestTransposeCopy(ptrdiff_t M, ptrdiff_t N, std::string label)
+{
+    typedef tmv::Matrix<T1,tmv::RowMajor> RM1;
+    typedef tmv::Matrix<T1,tmv::ColMajor> CM1;
+    typedef tmv::Matrix<T2,tmv::RowMajor> RM2;
+    typedef tmv::Matrix<T2,tmv::ColMajor> CM2;
+    typedef typename RM1::const_submatrix_type RM1s;
+    typedef typename CM1::const_submatrix_type CM1s;
+    typedef typename RM2::submatrix_type RM2s;
+    typedef typename CM2::submatrix_type CM2s;
+    const ptrdiff_t xx = tmv::Unknown;
+
+    if (showstartdone) {
+        std::cout<<"Start DoTestTransposeCopy: "<<label<<", M,N = "<<
+            M<<','<<N<<std::endl;
+    }
+
+    RM1 a1r(M+3,N+5);
+    CM1 a1c(M+5,N+3);
+    for(ptrdiff_t i=0;i<M+3;++i) for(ptrdiff_t j=0;j<N+5;++j)
+        a1r(i,j) = TransposeVal<T1>(i-1,j-3);
+    for(ptrdiff_t i=0;i<M+5;++i) for(ptrdiff_t j=0;j<N+3;++j)
+        a1c(i,j) = TransposeVal<T1>(i-3,j-1);
+    const RM1& ca1r = a1r;
+    const CM1& ca1c = a1c;
+    RM1s m1r = ca1r.subMatrix(1,M+1,3,N+3);
+    CM1s m1c = ca1c.subMatrix(3,M+3,1,N+1);
+
+    tmv::Matrix<T2> exact(M,N);
+    for(ptrdiff_t i=0;i<M;++i) for(ptrdiff_t j=0;j<N;++j)
+        exact(i,j) = T2(TransposeVal<T1>(i,j));
+
+    // The values outside the views must not be touched.
+    const T2 z(-7);
+
+    // algo 41: rowmajor -> colmajor and colmajor -> rowmajor
+    {
+        CM2 a2c(M+2,N+4,z);
+        RM2 a2r(M+4,N+2,z);
+        CM2s m2c = a2c.subMatrix(1,M+1,3,N+3);
+        RM2s m2r = a2r.subMatrix(3,M+3,1,N+1);
+        tmv::CopyM_Helper<41,xx,xx,RM1s,CM2s>::call(m1r,m2c);
+        tmv::CopyM_Helper<41,xx,xx,CM1s,RM2s>::call(m1c,m2r);
+        Assert(Equal(m2c,exact,0),label+" algo 41 rm->cm");
+        Assert(Equal(m2r,exact,0),label+" algo 41 cm->rm");
+        Assert(Untouched(a2c,1,M+1,3,N+3,z),label+" algo 41 rm->cm outside");
+        Assert(Untouched(a2r,3,M+3,1,N+1,z),label+" algo 41 cm->rm outside");
+    }
+
+    // algo 40: selects 42 for float and double, else 41.
+    {
+        CM2 a2c(M+2,N+4,z);
+        RM2 a2r(M+4,N+2,z);
+        CM2s m2c = a2c.subMatrix(1,M+1,3,N+3);
+        RM2s m2r = a2r.subMatrix(3,M+3,1,N+1);
+        tmv::CopyM_Helper<40,xx,xx,RM1s,CM2s>::call(m1r,m2c);
+        tmv::CopyM_Helper<40,xx,xx,CM1s,RM2s>::call(m1c,m2r);
+        Assert(Equal(m2c,exact,0),label+" algo 40 rm->cm");
+        Assert(Equal(m2r,exact,0),label+" algo 40 cm->rm");
+        Assert(Untouched(a2c,1,M+1,3,N+3,z),label+" algo 40 rm->cm outside");
+        Assert(Untouched(a2r,3,M+3,1,N+1,z),label+" algo 40 cm->rm outside");
+    }
+
+    // The regular assignment, which picks the algorithm itself.
+    {
+        CM2 a2c(M+2,N+4,z);
+        RM2 a2r(M+4,N+2,z);
+        CM2s m2c = a2c.subMatrix(1,M+1,3,N+3);
+        RM2s m2r = a2r.subMatrix(3,M+3,1,N+1);
+        m2c = m1r;
+        m2r = m1c;
+        Assert(Equal(m2c,exact,0),label+" m2c = m1r");
+        Assert(Equal(m2r,exact,0),label+" m2r = m1c");
+        Assert(Untouched(a2c,1,M+1,3,N+3,z),label+" m2c = m1r outside");
+    }
+}
+
+// Same, but only for algo 42, which needs T1 and T2 to be the same
+// float or double.
+template <class T>
+static void DoTestTransposeCopy42(ptrdiff_t M, ptrdiff_t N, std::string label)
+{
+    typedef tmv::Matrix<T,tmv::RowMajor> RM;
+    typedef tmv::Matrix<T,tmv::ColMajor> CM;
+    typedef typename RM::const_submatrix_type RMcs;
+    typedef typename CM::const_submatrix_type CMcs;
+    typedef typename RM::submatrix_type RMs;
+    typedef typename CM::submatrix_type CMs;
+    const ptrdiff_t xx = tmv::Unknown;
+
+    RM a1r(M+3,N+5);
+    CM a1c(M+5,N+3);
+    for(ptrdiff_t i=0;i<M+3;++i) for(ptrdiff_t j=0;j<N+5;++j)
+        a1r(i,j) = TransposeVal<T>(i-1,j-3);
+    for(ptrdiff_t i=0;i<M+5;++i) for(ptrdiff_t j=0;j<N+3;++j)
+        a1c(i,j) = TransposeVal<T>(i-3,j-1);
+    const RM& ca1r = a1r;
+    const CM& ca1c = a1c;
+    RMcs m1r = ca1r.subMatrix(1,M+1,3,N+3);
+    CMcs m1c = ca1c.subMatrix(3,M+3,1,N+1);
+
+    tmv::Matrix<T> exact(M,N);
+    for(ptrdiff_t i=0;i<M;++i) for(ptrdiff_t j=0;j<N;++j)
+        exact(i,j) = TransposeVal<T>(i,j);
+    const T z(-7);
+
+    CM a2c(M+2,N+4,z);
+    RM a2r(M+4,N+2,z);
+    CMs m2c = a2c.subMatrix(1,M+1,3,N+3);
+    RMs m2r = a2r.subMatrix(3,M+3,1,N+1);
+    tmv::CopyM_Helper<42,xx,xx,RMcs,CMs>::call(m1r,m2c);
+    tmv::CopyM_Helper<42,xx,xx,CMcs,RMs>::call(m1c,m2r);
+    Assert(Equal(m2c,exact,0),label+" algo 42 rm->cm");
+    Assert(Equal(m2r,exact,0),label+" algo 42 cm->rm");
+    Assert(Untouched(a2c,1,M+1,3,N+3,z),label+" algo 42 rm->cm outside");
+    Assert(Untouched(a2r,3,M+3,1,N+1,z),label+" algo 42 cm->rm outside");
+}
+
+template <class T>
+static void TestTransposeCopy()
+{
+    typedef std::complex<T> CT;
+    const ptrdiff_t nb = TMV_COPYM_BLOCK;
+    // Sizes smaller than the SSE tiles, odd sizes that aren't multiples
+    // of either the SSE tiles or the blocks, and exact multiples.
+    const ptrdiff_t sizes[][2] = {
+        {1,1}, {1,7}, {7,1}, {3,5}, {5,3}, {2,2}, {4,4}, {7,7},
+        {nb-1,nb+1}, {nb+1,nb-1}, {nb,nb}, {2*nb,3*nb},
+        {3*nb+5,2*nb+3}, {2*nb+3,5*nb+7}, {101,37}
+    };
+    const int nsizes = sizeof(sizes)/sizeof(sizes[0]);
+    for(int k=0;k<nsizes;++k) {
+        const ptrdiff_t M = sizes[k][0];
+        const ptrdiff_t N = sizes[k][1];
+        DoTestTransposeCopy<T,T>(M,N,"TransposeCopy");
+        DoTestTransposeCopy42<T>(M,N,"TransposeCopy");
+        DoTestTransposeCopy<CT,CT>(M,N,"TransposeCopy complex");
+        DoTestTransposeCopy<T,CT>(M,N,"TransposeCopy real->complex");
+    }
+}
+
+// Check Matrix::transposeSelf for an M x N matrix.  For M != N, this
+// follows the cycles of the permutation in InPlaceTransposeStorage,
+// so the sizes include 1 x N and N x 1, where nothing moves, and sizes
+// where M*N-1 is prime, which have a single long cycle.
+template <class T, tmv::StorageType stor>
+static void DoTestTransposeSelf(ptrdiff_t M, ptrdiff_t N, std::string label)
+{
+    if (showstartdone) {
+        std::cout<<"Start DoTestTransposeSelf: "<<label<<' '<<
+            tmv::TMV_Text(stor)<<", M,N = "<<M<<','<<N<<std::endl;
+    }
+
+    tmv::Matrix<T,stor> m(M,N);
+    for(ptrdiff_t i=0;i<M;++i) for(ptrdiff_t j=0;j<N;++j)
+        m(i,j) = TransposeVal<T>(i,j);
+    tmv::Matrix<T,stor> m0 = m;
+    const T* p0 = m.cptr();
+
+    m.transposeSelf();
+    Assert(m.colsize() == N && m.rowsize() == M,
+           label+" transposeSelf sizes");
+    Assert(m.cptr() == p0,label+" transposeSelf in place");
+    Assert(Equal(m,m0.transpose(),0),label+" transposeSelf");
+    if (stor == tmv::ColMajor) Assert(m.stepj() == N,label+" stepj");
+    else Assert(m.stepi() == M,label+" stepi");
+
+    // The result is a regular matrix, which can be used as usual.
+    tmv::Matrix<T,stor> m2 = m;
+    Assert(Equal(m2,m0.transpose(),0),label+" copy after transposeSelf");
+
+    m.transposeSelf();
+    Assert(m.colsize() == M && m.rowsize() == N,
+           label+" transposeSelf twice sizes");
+    Assert(Equal(m,m0,0),label+" transposeSelf twice");
+}
+
+// Check ChangeMajor in both directions.
+template <class T>
+static void DoTestChangeMajor(ptrdiff_t M, ptrdiff_t N, std::string label)
+{
+    if (showstartdone) {
+        std::cout<<"Start DoTestChangeMajor: "<<label<<", M,N = "<<
+            M<<','<<N<<std::endl;
+    }
+
+    tmv::Matrix<T,tmv::ColMajor> mc(M,N);
+    for(ptrdiff_t i=0;i<M;++i) for(ptrdiff_t j=0;j<N;++j)
+        mc(i,j) = TransposeVal<T>(i,j);
+    tmv::Matrix<T,tmv::ColMajor> m0 = mc;
+    const T* p0 = mc.cptr();
+
+    // m2 starts with some other size, which is replaced.
+    tmv::Matrix<T,tmv::RowMajor> mr(3,4,T(1));
+    tmv::ChangeMajor(mc,mr);
+    Assert(mr.colsize() == M && mr.rowsize() == N,
+           label+" ChangeMajor cm->rm sizes");
+    Assert(mr.cptr() == p0,label+" ChangeMajor cm->rm in place");
+    Assert(Equal(mr,m0,0),label+" ChangeMajor cm->rm");
+    Assert(mc.colsize() == 0 && mc.rowsize() == 0,
+           label+" ChangeMajor cm->rm leaves m1 empty");
+
+    tmv::ChangeMajor(mr,mc);
+    Assert(mc.colsize() == M && mc.rowsize() == N,
+           label+" ChangeMajor rm->cm sizes");
+    Assert(mc.cptr() == p0,label+" ChangeMajor rm->cm in place");
+    Assert(Equal(mc,m0,0),label+" ChangeMajor rm->cm");
+    Assert(mr.colsize() == 0 && mr.rowsize() == 0,
+           label+" ChangeMajor rm->cm leaves m1 empty");
+}
+
+template <class T>
+static void TestTransposeSelf()
+{
+    typedef std::complex<T> CT;
+    const ptrdiff_t sizes[][2] = {
+        {1,1}, {1,9}, {9,1}, {2,3}, {3,2}, {2,7}, {5,17}, {7,13},
+        {100,3}, {3,100}, {64,17}, {37,101}, {8,8}, {40,40}
+    };
+    const int nsizes = sizeof(sizes)/sizeof(sizes[0]);
+    for(int k=0;k<nsizes;++k) {
+        const ptrdiff_t M = sizes[k][0];
+        const ptrdiff_t N = sizes[k][1];
+        DoTestTransposeSelf<T,tmv::ColMajor>(M,N,"TransposeSelf");
+        DoTestTransposeSelf<T,tmv::RowMajor>(M,N,"TransposeSelf");
+        DoTestTransposeSelf<CT,tmv::ColMajor>(M,N,"TransposeSelf complex");
+        DoTestTransposeSelf<CT,tmv::RowMajor>(M,N,"TransposeSelf complex");
+        DoTestChangeMajor<T>(M,N,"ChangeMajor");
+        DoTestChangeMajor<CT>(M,N,"ChangeMajor complex");
+    }
+}
+
+template <class T>
+void TestMatrixTranspose()
+{
+    TestTransposeCopy<T>();
+    TestTransposeSelf<T>();
+    std::cout<<"Matrix<"<<Text(T())<<"> Transpose passed all tests\n";
+}
+
+#ifdef TEST_DOUBLE
+template void TestMatrixTranspose<double>();
+#endif
+#ifdef TEST_FLOAT
+template void TestMatrixTranspose<float>();
+#endif
+#ifdef TEST_LONGDOUBLE
+template void TestMatrixTranspose<long double>();
+#endif
@@ -0,0 +1,251 @@
+
+#include "TMV_Test.h"
+#include "TMV_Test_1.h"
+#include "TMV.h"
+#ifdef TMV_SCRATCH_DTOR
+#include <thread>
+#endif
+
+#ifndef TMV_NO_SCRATCH
+template <class T>
+static bool InArena(const T* p)
+{
+    const tmv::ScratchArena& arena = tmv::ScratchArena::get();
+    const char* c = reinterpret_cast<const char*>(p);
+    return arena.mem && c >= arena.mem && c < arena.mem + arena.cap;
+}
+
+// Check the scratch arena: allocations inside a ScratchScope come from
+// the arena until it is full, after which they use the heap, and the
+// arena is released at the end of each scope.
+template <class T>
+static void TestScratch()
+{
+    const size_t size0 = tmv::GetScratchSize();
+    const size_t nbytes = 1<<16;
+    const ptrdiff_t n = 100;
+    const ptrdiff_t nbig = 2*nbytes/sizeof(T);
+
+    tmv::SetScratchSize(nbytes);
+    Assert(tmv::GetScratchSize() == nbytes,"SetScratchSize");
+    tmv::ResetScratch();
+    Assert(tmv::ScratchArena::get().mem == 0,"ResetScratch");
+    tmv::ResetScratchPeak();
+    Assert(tmv::GetScratchPeak() == 0,"ResetScratchPeak");
+
+    // Outside of a ScratchScope, everything uses the heap.
+    {
+        tmv::Vector<T> v(n,T(1));
+        Assert(!InArena(v.cptr()),"Allocation outside ScratchScope");
+        Assert(tmv::GetScratchPeak() == 0,"Peak outside ScratchScope");
+    }
+
+    {
+        tmv::ScratchScope scope;
+        tmv::Vector<T> v1(n,T(1));
+        Assert(InArena(v1.cptr()),"Allocation in ScratchScope");
+        Assert(tmv::ScratchArena::get().cap == nbytes,"Arena size");
+        Assert(tmv::GetScratchPeak() >= n*sizeof(T),"GetScratchPeak");
+        const size_t top1 = tmv::ScratchArena::get().top;
+        {
+            tmv::ScratchScope scope2;
+            tmv::Vector<T> v2(n,T(2));
+            Assert(InArena(v2.cptr()),"Allocation in nested ScratchScope");
+            Assert(v2.cptr() >= v1.cptr()+n,"Nested allocation after v1");
+            Assert(v1 == tmv::Vector<T>(n,T(1)),"v1 after nested alloc");
+        }
+        Assert(tmv::ScratchArena::get().top == top1,
+               "Nested ScratchScope releases its memory");
+
+        // This doesn't fit, so it goes to the heap, but the peak still
+        // counts it.
+        tmv::Vector<T> vbig(nbig,T(3));
+        Assert(!InArena(vbig.cptr()),"Heap fallback when arena is full");
+        Assert(vbig == tmv::Vector<T>(nbig,T(3)),"Heap fallback values");
+        Assert(tmv::GetScratchPeak() >= top1 + nbig*sizeof(T),
+               "GetScratchPeak includes heap fallback");
+        Assert(tmv::ScratchArena::get().top == top1,
+               "Heap fallback doesn't use the arena");
+
+        // Regular calculations still work with the arena memory.
+        tmv::Matrix<T> m(20,20);
+        for(ptrdiff_t i=0;i<20;++i) for(ptrdiff_t j=0;j<20;++j)
+            m(i,j) = T(i+2*j);
+        tmv::Matrix<T> m2 = m.transpose() * m;
+        Assert(InArena(m2.cptr()),"Matrix in ScratchScope");
+        Assert(m2(3,5) == (m.col(3)*m.col(5)),"Calculation in arena");
+    }
+    Assert(tmv::ScratchArena::get().top == 0,"ScratchScope releases memory");
+    Assert(tmv::ScratchArena::get().depth == 0,"ScratchScope depth");
+    Assert(tmv::GetScratchPeak() >= (n+nbig)*sizeof(T),
+           "GetScratchPeak after scope");
+    tmv::ResetScratchPeak();
+    Assert(tmv::GetScratchPeak() == 0,"ResetScratchPeak after scope");
+
+    // A new size is used the next time the arena is empty.
+    tmv::SetScratchSize(2*nbytes);
+    {
+        tmv::ScratchScope scope;
+        tmv::Vector<T> v(nbig/2,T(1));
+        Assert(InArena(v.cptr()),"Allocation after SetScratchSize");
+        Assert(tmv::ScratchArena::get().cap == 2*nbytes,
+               "Arena size after SetScratchSize");
+    }
+
+    // With a size of 0, everything goes to the heap.
+    tmv::SetScratchSize(0);
+    {
+        tmv::ScratchScope scope;
+        tmv::Vector<T> v(n,T(1));
+        Assert(!InArena(v.cptr()),"Allocation with scratch size 0");
+        Assert(tmv::ScratchArena::get().mem == 0,"No arena with size 0");
+    }
+
+    tmv::SetScratchSize(size0);
+    tmv::ResetScratch();
+    tmv::ResetScratchPeak();
+}
+
+#ifdef TMV_SCRATCH_DTOR
+static int scratch_nalloc = 0;
+static int scratch_nfree = 0;
+
+static void* CountingAlloc(size_t nbytes, size_t align)
+{
+    ++scratch_nalloc;
+    return tmv::AllocationPolicy::defaultAllocate(nbytes,align);
+}
+
+static void CountingFree(void* p, size_t nbytes)
+{
+    ++scratch_nfree;
+    tmv::AllocationPolicy::defaultDeallocate(p,nbytes);
+}
+
+template <class T>
+static void UseScratch()
+{
+    tmv::ScratchScope scope;
+    tmv::Vector<T> v(100,T(1));
+}
+
+// Each thread's arena is freed when the thread exits.
+template <class T>
+static void TestScratchThreadExit()
+{
+    tmv::SetAllocator(&CountingAlloc,&CountingFree);
+    scratch_nalloc = scratch_nfree = 0;
+    std::thread t(&UseScratch<T>);
+    t.join();
+    tmv::SetAllocator(0,0);
+    Assert(scratch_nalloc == 1,"Thread allocates its arena");
+    Assert(scratch_nfree == 1,"Arena freed at thread exit");
+}
+#endif
+#endif
+
+static int alloc_ncalls = 0;
+static int free_ncalls = 0;
+static size_t alloc_lastalign = 0;
+static size_t alloc_nbytes = 0;
+
+static void* TestAlloc(size_t nbytes, size_t align)
+{
+    ++alloc_ncalls;
+    alloc_lastalign = align;
+    alloc_nbytes += nbytes;
+    return tmv::AllocationPolicy::defaultAllocate(nbytes,align);
+}
+
+static void TestFree(void* p, size_t nbytes)
+{
+    ++free_ncalls;
+    alloc_nbytes -= nbytes;
+    tmv::AllocationPolicy::defaultDeallocate(p,nbytes);
+}
+
+// Check that SetAllocator's functions are used for Vector and Matrix
+// storage, that memory is freed with the function that allocated it,
+// and that SetAlignment is honored.
+template <class T>
+static void TestAllocator()
+{
+    typedef std::complex<T> CT;
+    const size_t align0 = tmv::GetAlignment();
+    const size_t size0 = tmv::GetScratchSize();
+    // Make sure the scratch arena doesn't get in the way.
+    tmv::SetScratchSize(0);
+    tmv::ResetScratch();
+
+    alloc_ncalls = free_ncalls = 0;
+    alloc_nbytes = 0;
+    tmv::SetAllocator(&TestAlloc,&TestFree);
+    {
+        tmv::Vector<T> v(10,T(1));
+        Assert(alloc_ncalls == 1,"Custom allocator used for Vector");
+        Assert(alloc_nbytes >= 10*sizeof(T),"Custom allocator nbytes");
+        tmv::Matrix<CT> m(7,9,CT(2));
+        Assert(alloc_ncalls == 2,"Custom allocator used for Matrix");
+        Assert(alloc_nbytes >= 10*sizeof(T) + 63*sizeof(CT),
+               "Custom allocator nbytes complex");
+        Assert(free_ncalls == 0,"Custom deallocator not called yet");
+        Assert(alloc_lastalign == align0,"Custom allocator align");
+    }
+    Assert(free_ncalls == 2,"Custom deallocator called");
+    Assert(alloc_nbytes == 0,"Custom deallocator nbytes");
+
+    // Memory allocated before the allocator is changed is freed with
+    // the function that goes with it.
+    {
+        tmv::Vector<T> v1(10,T(1));
+        tmv::SetAllocator(0,0);
+        tmv::Vector<T> v2(10,T(1));
+        Assert(alloc_ncalls == 3,"Default allocator restored");
+    }
+    Assert(free_ncalls == 3,"Deallocate with the original function");
+    Assert(alloc_nbytes == 0,"Deallocate with the original nbytes");
+
+    // Each of the alignments is honored by both the default allocator 
+    // and a custom one.
+    for(size_t align=16; align<=256; align*=2) {
+        tmv::SetAlignment(align);
+        Assert(tmv::GetAlignment() == align,"GetAlignment");
+        for(int k=0; k<2; ++k) {
+            if (k==1) tmv::SetAllocator(&TestAlloc,&TestFree);
+            for(ptrdiff_t n=1; n<40; n+=3) {
+                tmv::Vector<T> v(n,T(1));
+                tmv::Matrix<CT> m(n,3,CT(1));
+                Assert(size_t(v.cptr()) % align == 0,"Vector alignment");
+                Assert(size_t(m.cptr()) % align == 0,"Matrix alignment");
+            }
+            if (k==1) {
+                Assert(alloc_lastalign == align,"Custom allocator align");
+                tmv::SetAllocator(0,0);
+            }
+        }
+    }
+    Assert(alloc_nbytes == 0,"All memory freed");
+
+    tmv::SetAlignment(align0);
+    tmv::SetScratchSize(size0);
+}
+
+template <class T>
+void TestMemory()
+{
+    TestAllocator<T>();
+#ifndef TMV_NO_SCRATCH
+    TestScratch<T>();
+#endif
+#ifdef TMV_SCRATCH_DTOR
+    TestScratchThreadExit<T>();
+#endif
+    std::cout<<"Memory<"<<Text(T())<<"> passed all tests\n";
+}
+
+#ifdef TEST_DOUBLE
+template void TestMemory<double>();
+#endif
+#ifdef TEST_FLOAT
+template void TestMemory<float>();
+#endif
@@ -0,0 +1,133 @@
+
+#include "TMV_Test.h"
+#include "TMV_Test_3.h"
+#include "TMV.h"
+
+// Check each of the batch operations against doing the same thing to
+// each matrix in turn with a regular Matrix.  The batch size is not a
+// multiple of TMV_BATCH_BLOCKSIZE, so the last chunk is a partial one.
+template <class T, ptrdiff_t N>
+static void DoTestBatch(std::string label)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    typedef typename tmv::Traits<RT>::float_type FT;
+    const ptrdiff_t nb = 3*TMV_BATCH_BLOCKSIZE/2;
+
+    tmv::SmallMatrixBatch<T,N,N> A(nb);
+    tmv::SmallMatrixBatch<T,N,2> B(nb);
+    for(ptrdiff_t b=0;b<nb;++b) {
+        for(ptrdiff_t i=0;i<N;++i) for(ptrdiff_t j=0;j<N;++j)
+            A[b](i,j) = TestVal<T>::make(2+4*i-3*j+b%7,(i*j+b)%5-2) / RT(N);
+        for(ptrdiff_t i=0;i<N;++i) A[b](i,i) += RT(3+b%4);
+        for(ptrdiff_t i=0;i<N;++i) for(ptrdiff_t j=0;j<2;++j)
+            B[b](i,j) = TestVal<T>::make(1-i+2*j,b%3+i);
+    }
+
+    // BatchMultMM
+    tmv::SmallMatrixBatch<T,N,2> C(nb,T(1));
+    tmv::BatchMultMM<true>(T(2),A,B,C);
+    for(ptrdiff_t b=0;b<nb;++b) {
+        tmv::Matrix<T> a = A[b];
+        tmv::Matrix<T> bb = B[b];
+        tmv::Matrix<T> c = 2*a*bb;
+        c.addToAll(T(1));
+        Assert(Equal(C[b],c,EPS*Norm(a)*Norm(bb)),label+" BatchMultMM");
+    }
+
+    // BatchDet
+    tmv::Vector<T> d(nb);
+    tmv::BatchDet(A,d);
+    for(ptrdiff_t b=0;b<nb;++b) {
+        tmv::Matrix<T> a = A[b];
+        T det = a.det();
+        Assert(Equal2(d(b),det,EPS*N*tmv::TMV_ABS(det)),label+" BatchDet");
+    }
+
+    // BatchInvert
+    tmv::SmallMatrixBatch<T,N,N> Ainv(nb);
+    tmv::BatchInvert(A,Ainv);
+    for(ptrdiff_t b=0;b<nb;++b) {
+        tmv::Matrix<T> a = A[b];
+        tmv::Matrix<T> ainv = a.inverse();
+        Assert(Equal(Ainv[b],ainv,EPS*Norm(a)*Norm(ainv)*Norm(ainv)),
+               label+" BatchInvert");
+    }
+    // Also in place.
+    tmv::SmallMatrixBatch<T,N,N> A2 = A;
+    tmv::BatchInvert(A2,A2);
+    for(ptrdiff_t b=0;b<nb;++b) {
+        tmv::Matrix<T> ainv = Ainv[b];
+        Assert(Equal(A2[b],ainv,EPS*Norm(ainv)),label+" BatchInvert alias");
+    }
+
+    // BatchLU_Decompose, BatchLU_Solve
+    A2 = A;
+    tmv::SmallMatrixBatch<int,N,1> P(nb);
+    tmv::BatchLU_Decompose(A2,P);
+    tmv::SmallMatrixBatch<T,N,2> X = B;
+    tmv::BatchLU_Solve(A2,P,X);
+    for(ptrdiff_t b=0;b<nb;++b) {
+        tmv::Matrix<T> a = A[b];
+        tmv::Matrix<T> x = X[b];
+        tmv::Matrix<T> bb = B[b];
+        Assert(Equal(a*x,bb,EPS*Norm(a)*Norm(x)),label+" BatchLU_Solve");
+    }
+
+    // BatchCH_Decompose, BatchCH_Solve with A[b] * A[b]^H, which is
+    // hermitian positive definite.
+    tmv::SmallMatrixBatch<T,N,N> H(nb);
+    for(ptrdiff_t b=0;b<nb;++b) {
+        tmv::Matrix<T> a = A[b];
+        H[b] = a * a.adjoint();
+    }
+    A2 = H;
+    tmv::BatchCH_Decompose(A2);
+    X = B;
+    tmv::BatchCH_Solve(A2,X);
+    for(ptrdiff_t b=0;b<nb;++b) {
+        tmv::Matrix<T> h = H[b];
+        tmv::Matrix<T> x = X[b];
+        tmv::Matrix<T> bb = B[b];
+        Assert(Equal(h*x,bb,EPS*Norm(h)*Norm(x)),label+" BatchCH_Solve");
+    }
+
+    // A matrix that is not positive definite should throw.
+#ifndef NOTHROW
+    A2 = H;
+    A2[nb-1](0,0) = T(-1);
+    bool threw = false;
+    try { tmv::BatchCH_Decompose(A2); }
+    catch (tmv::NonPosDef&) { threw = true; }
+    Assert(threw,label+" BatchCH_Decompose NonPosDef");
+#endif
+}
+
+template <class T>
+void TestSmallMatrixBatch()
+{
+    // N <= 4 use the explicit formulae for the determinant (and N <= 3
+    // for the inverse).  The rest use the LU decomposition of each chunk.
+    // N = 40 is large enough that the chunk temporaries are not on the
+    // stack.
+    DoTestBatch<T,1>("N=1");
+    DoTestBatch<T,2>("N=2");
+    DoTestBatch<T,3>("N=3");
+    DoTestBatch<T,4>("N=4");
+    DoTestBatch<T,7>("N=7");
+    DoTestBatch<T,40>("N=40");
+    DoTestBatch<std::complex<T>,2>("complex N=2");
+    DoTestBatch<std::complex<T>,5>("complex N=5");
+    DoTestBatch<std::complex<T>,40>("complex N=40");
+
+    std::cout<<"SmallMatrixBatch<"<<Text(T())<<"> passed all tests\n";
+}
+
+#ifdef TEST_DOUBLE
+template void TestSmallMatrixBatch<double>();
+#endif
+#ifdef TEST_FLOAT
+template void TestSmallMatrixBatch<float>();
+#endif
+#ifdef TEST_LONGDOUBLE
+template void TestSmallMatrixBatch<long double>();
+#endif
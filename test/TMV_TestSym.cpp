@@ -0,0 +1,202 @@
+
+#include "TMV_Test.h"
+#include "TMV_Test_1.h"
+#include "TMV_Sym.h"
+#include <fstream>
+#include <cstdio>
+
+// The full Matrix that a SymMatrix or HermMatrix with the given
+// stored triangle represents.
+template <class T, class SM>
+static tmv::Matrix<T> SymFull(const SM& s)
+{
+    const ptrdiff_t N = s.size();
+    tmv::Matrix<T> m(N,N);
+    for(ptrdiff_t i=0;i<N;++i) for(ptrdiff_t j=0;j<N;++j) m(i,j) = s(i,j);
+    return m;
+}
+
+template <class T, class SM>
+static void TestBasicSym(std::string label)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    typedef typename tmv::Traits<RT>::float_type FT;
+    const bool herm = SM::_herm;
+    const ptrdiff_t N = 10;
+
+    SM s(N);
+    Assert(s.colsize() == N && s.rowsize() == N && s.size() == N,
+           label+" Creating SymMatrix(N)");
+
+    // Set the lower triangle, and check that the upper triangle
+    // comes back with the right symmetry.
+    for(ptrdiff_t i=0;i<N;++i) for(ptrdiff_t j=0;j<=i;++j)
+        s(i,j) = i==j ? T(RT(2*i+1)) : TestVal<T>::make(3*i-j,i+2*j+1);
+    for(ptrdiff_t i=0;i<N;++i) for(ptrdiff_t j=0;j<N;++j) {
+        T expected = i>=j ?
+            (i==j ? T(RT(2*i+1)) : TestVal<T>::make(3*i-j,i+2*j+1)) :
+            (herm ? tmv::TMV_CONJ(TestVal<T>::make(3*j-i,j+2*i+1)) :
+             TestVal<T>::make(3*j-i,j+2*i+1));
+        Assert(s(i,j) == expected,label+" Read/Write SymMatrix");
+        Assert(s.cref(i,j) == expected,label+" SymMatrix cref");
+    }
+    // Setting the upper triangle sets the same storage.
+    s(2,5) = TestVal<T>::make(7,-3);
+    Assert(s(5,2) == (herm ? TestVal<T>::make(7,3) : TestVal<T>::make(7,-3)),
+           label+" SymMatrix upper ref");
+
+    tmv::Matrix<T> m = SymFull<T>(s);
+    Assert(Equal2(s.trace(),m.trace(),EPS*N*N),label+" SymMatrix trace");
+    Assert(Equal2(s.normF(),m.normF(),EPS*m.normF()),
+           label+" SymMatrix normF");
+    Assert(Equal2(s.sumAbsElements(),m.sumAbsElements(),
+                  EPS*m.sumAbsElements()),label+" SymMatrix sumAbsElements");
+
+    // Copy to a SymMatrix with the other storage.
+    SM s2 = s;
+    Assert(Equal(SymFull<T>(s2),m,EPS),label+" SymMatrix copy");
+
+    // I/O round trip, both the normal and the compact formats.
+    std::ofstream fout("tmvtest_symmatrix_io.dat");
+    Assert(bool(fout),label+" Couldn't open tmvtest_symmatrix_io.dat");
+    fout << s << std::endl;
+    fout << tmv::CompactIO() << s << std::endl;
+    fout.close();
+
+    SM xs1(N), xs2(0);
+    std::ifstream fin("tmvtest_symmatrix_io.dat");
+    Assert(bool(fin),label+" Couldn't open tmvtest_symmatrix_io.dat");
+    fin >> xs1;
+    fin >> tmv::CompactIO() >> xs2;
+    Assert(bool(fin),label+" Reading SymMatrix from file");
+    fin.close();
+    Assert(Equal(SymFull<T>(xs1),m,EPS*m.normF()),label+" SymMatrix I/O");
+    Assert(xs2.size() == N,label+" SymMatrix compact I/O resize");
+    Assert(Equal(SymFull<T>(xs2),m,EPS*m.normF()),
+           label+" SymMatrix compact I/O");
+#ifndef NOTHROW
+    // The full format is checked for symmetry.
+    {
+        std::istringstream iss(herm ?
+                               "H 2 2\n( 1  2 )\n( 3  4 )\n" :
+                               "S 2 2\n( 1  2 )\n( 3  4 )\n");
+        SM xs3(2);
+        bool threw = false;
+        try { iss >> xs3; }
+        catch (tmv::ReadError&) { threw = true; }
+        Assert(threw,label+" SymMatrix read non-symmetric");
+    }
+#endif
+    std::remove("tmvtest_symmatrix_io.dat");
+}
+
+template <class T, class SM>
+static void TestSymArith(std::string label)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    typedef typename tmv::Traits<RT>::float_type FT;
+    // N is large enough that Rank2KUpdate uses more than one
+    // diagonal block.
+    const ptrdiff_t N = TMV_RANKK_BLOCK + 13;
+    const ptrdiff_t K = 7;
+
+    SM s(N);
+    for(ptrdiff_t i=0;i<N;++i) for(ptrdiff_t j=0;j<=i;++j)
+        s(i,j) = i==j ? T(RT(N+i)) :
+            TestVal<T>::make(RT((i+2*j)%7)-3,RT((i*j)%5)-2) / RT(N);
+    tmv::Matrix<T> m = SymFull<T>(s);
+    const RT sn = m.normF();
+
+    // MultSV: v3 = x * S * v2 and v3 += x * v2 * S
+    tmv::Vector<T> v2(N);
+    for(ptrdiff_t i=0;i<N;++i) v2(i) = TestVal<T>::make(1-i%4,i%3);
+    tmv::Vector<T> v3(N), v3b(N);
+    tmv::MultMV<false>(tmv::Scaling<0,T>(T(3)),s,v2,v3);
+    v3b = 3 * m * v2;
+    Assert(Equal(v3,v3b,EPS*sn*Norm(v2)),label+" S * v");
+    tmv::MultVM<true>(tmv::Scaling<0,T>(T(2)),v2,s,v3);
+    v3b += 2 * v2 * m;
+    Assert(Equal(v3,v3b,EPS*sn*Norm(v2)),label+" v * S");
+
+    // MultSM: m3 = x * S * m2 and m3 = x * m2 * S
+    tmv::Matrix<T> m2(N,K);
+    for(ptrdiff_t i=0;i<N;++i) for(ptrdiff_t j=0;j<K;++j)
+        m2(i,j) = TestVal<T>::make(RT(i-2*j)/N,RT(j)/K);
+    tmv::Matrix<T> m3(N,K), m3b(N,K);
+    tmv::MultMM<false>(tmv::Scaling<0,T>(T(3)),s,m2,m3);
+    m3b = 3 * m * m2;
+    Assert(Equal(m3,m3b,EPS*sn*Norm(m2)),label+" S * M");
+    tmv::Matrix<T> m4(K,N), m4b(K,N);
+    tmv::MultMM<false>(tmv::Scaling<0,T>(T(3)),m2.transpose(),s,m4);
+    m4b = 3 * m2.transpose() * m;
+    Assert(Equal(m4,m4b,EPS*sn*Norm(m2)),label+" M * S");
+
+    // RankKUpdate: S += x * A * A^T (or A^H for a HermMatrix)
+    tmv::Matrix<T> a(N,K), b(N,K);
+    for(ptrdiff_t i=0;i<N;++i) for(ptrdiff_t j=0;j<K;++j) {
+        a(i,j) = TestVal<T>::make(RT(i+j)/N,RT(i-j)/N);
+        b(i,j) = TestVal<T>::make(RT(2*j-i)/N,RT(1));
+    }
+    tmv::Matrix<T> at = SM::_herm ?
+        tmv::Matrix<T>(a.adjoint()) : tmv::Matrix<T>(a.transpose());
+    tmv::Matrix<T> bt = SM::_herm ?
+        tmv::Matrix<T>(b.adjoint()) : tmv::Matrix<T>(b.transpose());
+    SM s2 = s;
+    tmv::RankKUpdate<true>(RT(2),a,s2);
+    tmv::Matrix<T> m5 = m + RT(2) * a * at;
+    Assert(Equal(SymFull<T>(s2),m5,EPS*(sn+Norm(a)*Norm(a))),
+           label+" RankKUpdate add");
+    tmv::RankKUpdate<false>(RT(2),a,s2);
+    m5 = RT(2) * a * at;
+    Assert(Equal(SymFull<T>(s2),m5,EPS*Norm(a)*Norm(a)),
+           label+" RankKUpdate");
+
+    // Rank2KUpdate: S += x * (A * B^T + B * A^T)
+    // (or x * A * B^H + conj(x) * B * A^H for a HermMatrix)
+    s2 = s;
+    const T x = TestVal<T>::make(2,SM::_herm ? 1 : 0);
+    tmv::Rank2KUpdate<true>(x,a,b,s2);
+    m5 = m + x * a * bt + (SM::_herm ? tmv::TMV_CONJ(x) : x) * b * at;
+    Assert(Equal(SymFull<T>(s2),m5,EPS*(sn+Norm(a)*Norm(b))),
+           label+" Rank2KUpdate add");
+}
+
+template <class T, class SM>
+static void TestSymStorage(std::string label)
+{
+    TestBasicSym<T,SM>(label);
+    TestSymArith<T,SM>(label);
+}
+
+template <class T>
+void TestSymMatrix()
+{
+    typedef std::complex<T> CT;
+    TestSymStorage<T,tmv::SymMatrix<T> >("Sym CL");
+    TestSymStorage<T,tmv::SymMatrix<T,tmv::RowMajor|tmv::Upper> >("Sym RU");
+    TestSymStorage<T,tmv::SymMatrix<T,tmv::Packed> >("Sym CL packed");
+    TestSymStorage<T,tmv::SymMatrix<T,tmv::Packed|tmv::Upper> >(
+        "Sym CU packed");
+    TestSymStorage<CT,tmv::SymMatrix<CT> >("Sym complex CL");
+    TestSymStorage<CT,tmv::SymMatrix<CT,tmv::Packed|tmv::RowMajor> >(
+        "Sym complex RL packed");
+    TestSymStorage<CT,tmv::HermMatrix<CT> >("Herm complex CL");
+    TestSymStorage<CT,tmv::HermMatrix<CT,tmv::RowMajor|tmv::Upper> >(
+        "Herm complex RU");
+    TestSymStorage<CT,tmv::HermMatrix<CT,tmv::Packed> >(
+        "Herm complex CL packed");
+    TestSymStorage<CT,tmv::HermMatrix<CT,tmv::Packed|tmv::Upper> >(
+        "Herm complex CU packed");
+
+    std::cout<<"SymMatrix<"<<Text(T())<<"> passed all basic tests\n";
+}
+
+#ifdef TEST_DOUBLE
+template void TestSymMatrix<double>();
+#endif
+#ifdef TEST_FLOAT
+template void TestSymMatrix<float>();
+#endif
+#ifdef TEST_LONGDOUBLE
+template void TestSymMatrix<long double>();
+#endif
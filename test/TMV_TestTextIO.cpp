@@ -0,0 +1,309 @@
+
+#include "TMV_Test.h"
+#include "TMV_Test_1.h"
+#include "TMV.h"
+#include "tmv/TMV_TextConvert.h"
+#include <sstream>
+#include <cstring>
+#include <cstdio>
+
+// The number of values to check in each of the random tests.
+#define TEXT_NTEST 20000
+
+// A simple generator, so the tests are the same everywhere.
+static unsigned long long TextRand(unsigned long long& state)
+{
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return state >> 11;
+}
+
+static double TextStrto(const char* s, double ) { return std::strtod(s,0); }
+static float TextStrto(const char* s, float ) { return std::strtof(s,0); }
+
+// A random finite value with any bit pattern, including denormals.
+static void TextRandomBits(unsigned long long& state, double& x)
+{
+    do {
+        const unsigned long long b =
+            (TextRand(state) << 32) ^ TextRand(state);
+        std::memcpy(&x,&b,sizeof(x));
+    } while (!(x == x) || x - x != 0.);
+}
+
+static void TextRandomBits(unsigned long long& state, float& x)
+{
+    do {
+        const unsigned int b = (unsigned int)(TextRand(state));
+        std::memcpy(&x,&b,sizeof(x));
+    } while (!(x == x) || x - x != 0.f);
+}
+
+// The number of significant digits in s, which is in %g format.
+static int TextSigDigits(const char* s)
+{
+    int n = 0, nz = 0;
+    bool started = false;
+    for(; *s && *s != 'e'; ++s) {
+        if (*s < '0' || *s > '9') continue;
+        if (*s != '0') { started = true; n += nz+1; nz = 0; }
+        else if (started) ++nz;
+    }
+    return n;
+}
+
+// Write random values with the shortest format, and check that they
+// read back exactly, both with ParseText and with strtod (strtof),
+// and that one fewer digit would not have been enough.
+template <class T>
+static void TestTextShortest()
+{
+    const int p1 = std::numeric_limits<T>::digits10;
+    unsigned long long state = 1234;
+    char buf[TMV_TEXT_BUFSIZE];
+    char buf2[TMV_TEXT_BUFSIZE];
+    for(int k=0;k<TEXT_NTEST;++k) {
+        T x;
+        TextRandomBits(state,x);
+        const int n = tmv::FormatText(buf,x,-1);
+        Assert(n == int(std::strlen(buf)),"FormatText length");
+        const char* p = buf;
+        T y;
+        Assert(tmv::ParseText(p,buf+n,y) && p == buf+n,"ParseText shortest");
+        if (!(y == x) || !(TextStrto(buf,x) == x)) {
+            Assert(false,std::string("Shortest round trip ")+buf);
+            continue;
+        }
+        const int nd = TextSigDigits(buf);
+        if (nd > p1) {
+            std::sprintf(buf2,"%.*g",nd-1,double(x));
+            if (TextStrto(buf2,x) == x)
+                Assert(false,std::string("Shortest is too long ")+buf);
+        }
+        // With an explicit precision, this is the same as %g.
+        const int prec = 1 + k % 20;
+        tmv::FormatText(buf,x,prec);
+        std::sprintf(buf2,"%.*g",prec,double(x));
+        Assert(std::strcmp(buf,buf2) == 0,"FormatText precision");
+    }
+
+    // Some special values.
+    const T inf = std::numeric_limits<T>::infinity();
+    tmv::FormatText(buf,inf,-1);
+    Assert(std::string(buf) == "inf","FormatText inf");
+    tmv::FormatText(buf,-inf,-1);
+    Assert(std::string(buf) == "-inf","FormatText -inf");
+    tmv::FormatText(buf,std::numeric_limits<T>::quiet_NaN(),-1);
+    Assert(std::string(buf) == "nan","FormatText nan");
+    tmv::FormatText(buf,T(0),-1);
+    Assert(std::string(buf) == "0","FormatText 0");
+    tmv::FormatText(buf,T(0.1),-1);
+    Assert(std::string(buf) == "0.1","FormatText 0.1");
+    tmv::FormatText(buf,T(-2.5e10),-1);
+    Assert(TextStrto(buf,T()) == T(-2.5e10),"FormatText -2.5e10");
+    tmv::FormatText(buf,std::numeric_limits<T>::max(),-1);
+    Assert(TextStrto(buf,T()) == std::numeric_limits<T>::max(),
+           "FormatText max");
+    tmv::FormatText(buf,std::numeric_limits<T>::denorm_min(),-1);
+    Assert(TextStrto(buf,T()) == std::numeric_limits<T>::denorm_min(),
+           "FormatText denorm_min");
+}
+
+// Parse random decimal strings with various numbers of digits and
+// exponents, and check that the results are the same as strtod
+// (strtof), which are correctly rounded.
+template <class T>
+static void TestTextParse()
+{
+    const int emax = std::numeric_limits<T>::max_exponent10 + 5;
+    const int emin = std::numeric_limits<T>::min_exponent10 -
+        std::numeric_limits<T>::digits10 - 5;
+    unsigned long long state = 5678;
+    std::string s;
+    for(int k=0;k<TEXT_NTEST;++k) {
+        s.clear();
+        const int r = int(TextRand(state) % 4);
+        if (r == 1) s += '-';
+        else if (r == 2) s += '+';
+        const int nd = 1 + int(TextRand(state) % 25);
+        const int ipt = int(TextRand(state) % (nd+1));
+        for(int i=0;i<nd;++i) {
+            if (i == ipt) s += '.';
+            s += char('0' + TextRand(state) % 10);
+        }
+        if (TextRand(state) % 4 != 0) {
+            const int e = emin + int(TextRand(state) % (emax-emin));
+            std::ostringstream ss;
+            ss << (TextRand(state) % 2 ? 'e' : 'E') << e;
+            s += ss.str();
+        }
+        if (s[s.size()-1] == '.' && (s.size() == 1 || s[s.size()-2] == '-'
+                                     || s[s.size()-2] == '+'))
+            s += '0';
+        const char* p = s.c_str();
+        T x;
+        const bool ok = tmv::ParseText(p,s.c_str()+s.size(),x);
+        const T y = TextStrto(s.c_str(),T());
+        if (!ok || p != s.c_str()+s.size() || !(x == y))
+            Assert(false,"ParseText "+s);
+    }
+
+    // Some special cases.
+    const char* ok[] = {
+        "0", "-0", "+0.", ".5", "5.", "1e5", "1E+05", "1e-5", "00012.5000",
+        "inf", "-Inf", "INFINITY", "nan", "NaN", "1e400", "-1e400",
+        "1e-400", "123456789012345678901234567890",
+        "0.000000000000000000000000000001234",
+        "4.9406564584124654e-324", "2.2250738585072011e-308",
+        "1.7976931348623157e308", "3.4028235e38", "1.4e-45"
+    };
+    for(size_t k=0;k<sizeof(ok)/sizeof(ok[0]);++k) {
+        const char* p = ok[k];
+        const char* end = ok[k] + std::strlen(ok[k]);
+        T x;
+        const bool b = tmv::ParseText(p,end,x);
+        const T y = TextStrto(ok[k],T());
+        Assert(b && p == end,std::string("ParseText ")+ok[k]);
+        Assert(x == y || (x != x && y != y),std::string("ParseText ")+ok[k]);
+    }
+
+    // Text that isn't a number.  ParseText stops at the first character
+    // that can't be part of the number.
+    const char* bad[] = { "", "-", "+", ".", "e5", "abc", "in", "-na", "." };
+    for(size_t k=0;k<sizeof(bad)/sizeof(bad[0]);++k) {
+        const char* p = bad[k];
+        T x;
+        Assert(!tmv::ParseText(p,bad[k]+std::strlen(bad[k]),x),
+               std::string("ParseText bad ")+bad[k]);
+        Assert(p == bad[k],std::string("ParseText bad p ")+bad[k]);
+    }
+    {
+        const char* s2 = "1.5x";
+        const char* p = s2;
+        T x;
+        Assert(tmv::ParseText(p,s2+4,x) && x == T(1.5) && p == s2+3,
+               "ParseText stops at x");
+    }
+
+    // Complex
+    const char* cs[] = { "(1.5,-2)", "( 1.5 , -2 )", "(3)", "3" };
+    const std::complex<T> cv[] = {
+        std::complex<T>(1.5,-2), std::complex<T>(1.5,-2),
+        std::complex<T>(3,0), std::complex<T>(3,0) };
+    for(int k=0;k<4;++k) {
+        const char* p = cs[k];
+        std::complex<T> z;
+        Assert(tmv::ParseText(p,cs[k]+std::strlen(cs[k]),z) && z == cv[k],
+               std::string("ParseText complex ")+cs[k]);
+    }
+    const char* badcs[] = { "(1.5,", "(1.5", "(,2)", "(1 2)" };
+    for(int k=0;k<4;++k) {
+        const char* p = badcs[k];
+        std::complex<T> z;
+        Assert(!tmv::ParseText(p,badcs[k]+std::strlen(badcs[k]),z),
+               std::string("ParseText bad complex ")+badcs[k]);
+    }
+}
+
+// Write and read matrices with the fast IO in several styles.  The
+// values are random bit patterns, so they need the shortest format
+// to be exact.  The larger size uses more than one block in the read
+// (ReadM_Helper algo 12), and converts them in parallel.
+template <class T, tmv::StorageType stor>
+static void DoTestFastIO(ptrdiff_t M, ptrdiff_t N, std::string label)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    if (showstartdone) {
+        std::cout<<"Start DoTestFastIO: "<<label<<' '<<tmv::TMV_Text(stor)<<
+            ", M,N = "<<M<<','<<N<<std::endl;
+    }
+
+    unsigned long long state = 99;
+    tmv::Matrix<T,stor> m(M,N);
+    for(ptrdiff_t i=0;i<M;++i) for(ptrdiff_t j=0;j<N;++j) {
+        RT re, im;
+        TextRandomBits(state,re);
+        TextRandomBits(state,im);
+        m(i,j) = TestVal<T>::make(re,im);
+    }
+
+    const tmv::IOStyle styles[] = {
+        tmv::FastIO(), tmv::CompactIO().fast(), tmv::EigenIO().fast(),
+        tmv::NormalIO().fast()
+    };
+    const char* names[] = { "default", "compact", "eigen", "normal" };
+    for(int k=0;k<4;++k) {
+        std::string lab = label + " FastIO " + names[k];
+        std::stringstream ss;
+        ss << styles[k] << m;
+        tmv::Matrix<T,tmv::ColMajor> mc(M,N);
+        tmv::Matrix<T,tmv::RowMajor> mr(M,N);
+        ss >> styles[k] >> mc;
+        Assert(!ss.fail(),lab+" read ColMajor ok");
+        Assert(mc == m,lab+" read ColMajor");
+        ss.clear();
+        ss.seekg(0);
+        ss >> styles[k] >> mr.view();
+        Assert(!ss.fail(),lab+" read RowMajor ok");
+        Assert(mr == m,lab+" read RowMajor");
+    }
+
+    // The fast writer with an explicit precision gives the same text
+    // as the normal writer, and the fast reader reads the normal text.
+    std::ostringstream os1, os2;
+    os1 << tmv::CompactIO().setPrecision(10) << m;
+    os2 << tmv::CompactIO().setPrecision(10).fast() << m;
+    Assert(os1.str() == os2.str(),label+" FastIO precision");
+    std::stringstream ss(os1.str());
+    tmv::Matrix<T> m1, m2;
+    ss >> tmv::CompactIO() >> m1;
+    ss.clear();
+    ss.seekg(0);
+    ss >> tmv::CompactIO().fast() >> m2;
+    Assert(m1 == m2,label+" FastIO reads normal text");
+
+#ifndef TMV_NO_THROW
+    // Malformed input throws a ReadError.  The bad value is near the
+    // end, so it is in the last block.
+    std::string good;
+    {
+        std::ostringstream os;
+        os << tmv::CompactIO().fast() << m;
+        good = os.str();
+    }
+    const size_t last = good.rfind(' ');
+    std::string bad[4];
+    bad[0] = good.substr(0,last+1) + "1.2.3";
+    bad[1] = good.substr(0,last+1) + "abc";
+    bad[2] = good.substr(0,last);
+    bad[3] = good.substr(0,good.size()/2);
+    for(int k=0;k<4;++k) {
+        std::stringstream ssb(bad[k]);
+        tmv::Matrix<T> mb;
+        bool threw = false;
+        try { ssb >> tmv::CompactIO().fast() >> mb; }
+        catch (tmv::ReadError&) { threw = true; }
+        Assert(threw,label+" FastIO malformed input throws");
+    }
+#endif
+}
+
+template <class T>
+void TestTextIO()
+{
+    TestTextShortest<T>();
+    TestTextParse<T>();
+    DoTestFastIO<T,tmv::ColMajor>(5,7,"Text");
+    DoTestFastIO<T,tmv::RowMajor>(5,7,"Text");
+    DoTestFastIO<std::complex<T>,tmv::ColMajor>(5,7,"Text complex");
+    // Large enough to use several blocks with OpenMP.
+    DoTestFastIO<T,tmv::ColMajor>(300,300,"Text");
+    DoTestFastIO<std::complex<T>,tmv::RowMajor>(200,150,"Text complex");
+    std::cout<<"TextIO<"<<Text(T())<<"> passed all tests\n";
+}
+
+#ifdef TEST_DOUBLE
+template void TestTextIO<double>();
+#endif
+#ifdef TEST_FLOAT
+template void TestTextIO<float>();
+#endif
@@ -0,0 +1,187 @@
+
+#include "TMV_Test.h"
+#include "TMV_Test_1.h"
+#include "TMV.h"
+#include "tmv/TMV_TridiagMatrix.h"
+
+// A diagonally dominant matrix, so the Thomas algorithm and the cyclic
+// reduction are both stable without pivoting.
+template <class T>
+static tmv::TridiagMatrix<T> MakeTridiag(ptrdiff_t n, int seed)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    tmv::TridiagMatrix<T> A(n);
+    for(ptrdiff_t k=0;k<n;++k) {
+        A.diag()(k) = TestVal<T>::make(
+            RT(4+(3*k+seed)%5),RT((k+seed)%3)-RT(1));
+        if (k < n-1) {
+            A.subDiag()(k) = TestVal<T>::make(
+                RT((2*k+seed)%5)-RT(2),RT((k+2*seed)%3)-RT(1)) / RT(2);
+            A.superDiag()(k) = TestVal<T>::make(
+                RT((k+3*seed)%7)-RT(3),RT(k%2)) / RT(3);
+        }
+    }
+    return A;
+}
+
+// Check the multiplication and both solvers for an n x n matrix.
+// For small n, these are checked against the dense matrix.  For large n
+// (which is needed for the OpenMP version of the cyclic reduction),
+// the solutions are checked with Tridiag_MultMV.
+template <class T>
+static void DoTestTridiag(ptrdiff_t n, std::string label)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    typedef typename tmv::Traits<RT>::float_type FT;
+
+    if (showstartdone) {
+        std::cout<<"Start DoTestTridiag: "<<label<<", n = "<<n<<std::endl;
+    }
+
+    tmv::TridiagMatrix<T> A = MakeTridiag<T>(n,0);
+    const ptrdiff_t nrhs = 3;
+    tmv::Matrix<T> X(n,nrhs);
+    for(ptrdiff_t i=0;i<n;++i) for(ptrdiff_t j=0;j<nrhs;++j)
+        X(i,j) = TestVal<T>::make(RT(1+(i+3*j)%5),RT(i%4)-RT(j));
+    tmv::Vector<T> x = X.col(0);
+    // Each row of A has |elements| <= 11, so Norm(A) <= 11 sqrt(n).
+    const FT eps = EPS * FT(11*n) * Norm(X);
+
+    // Tridiag_MultMV
+    tmv::Matrix<T> B(n,nrhs);
+    for(ptrdiff_t j=0;j<nrhs;++j) {
+        tmv::VectorView<T> bj = B.col(j);
+        tmv::Tridiag_MultMV(A,X.col(j),bj);
+    }
+    tmv::Vector<T> b = B.col(0);
+    if (n <= 100) {
+        tmv::Matrix<T> m(n,n);
+        for(ptrdiff_t i=0;i<n;++i) for(ptrdiff_t j=0;j<n;++j)
+            m(i,j) = A(i,j);
+        Assert(Equal(B,m*X,eps),label+" Tridiag_MultMV");
+    }
+    // In place (x and y the same vector) and with non-unit steps.
+    tmv::Vector<T> b2 = x;
+    tmv::Tridiag_MultMV(A,b2,b2);
+    Assert(Equal(b2,b,eps),label+" Tridiag_MultMV alias");
+    tmv::Matrix<T,tmv::RowMajor> Xr = X;
+    tmv::Matrix<T,tmv::RowMajor> Br(n,nrhs);
+    tmv::VectorView<T> br0 = Br.col(0);
+    tmv::Tridiag_MultMV(A,Xr.col(0),br0);
+    Assert(Equal(Br.col(0),b,eps),label+" Tridiag_MultMV step");
+
+    // Thomas algorithm
+    tmv::TridiagMatrix<T> LU = A;
+    tmv::Tridiag_Decompose(LU);
+    tmv::Vector<T> x2 = b;
+    tmv::Tridiag_SolveInPlace(LU,x2);
+    if (showacc) {
+        std::cout<<"Norm(x2-x) = "<<Norm(x2-x)<<std::endl;
+        std::cout<<"cf "<<eps<<std::endl;
+    }
+    Assert(Equal(x2,x,eps),label+" Tridiag_SolveInPlace");
+    tmv::Matrix<T> X2 = B;
+    tmv::Tridiag_SolveInPlace(LU,X2);
+    Assert(Equal(X2,X,eps),label+" Tridiag_SolveInPlace matrix");
+    Br = B;
+    tmv::Tridiag_SolveInPlace(LU,Br);
+    Assert(Equal(Br,X,eps),label+" Tridiag_SolveInPlace RowMajor");
+    tmv::Vector<T> x2c = b.conjugate();
+    typename tmv::Vector<T>::conjugate_type x2cc = x2c.conjugate();
+    tmv::Tridiag_SolveInPlace(LU,x2cc);
+    Assert(Equal(x2cc,x,eps),label+" Tridiag_SolveInPlace conj");
+
+    // Cyclic reduction
+    tmv::Vector<T> x3 = b;
+    tmv::Tridiag_SolveCR(A,x3);
+    if (showacc) {
+        std::cout<<"Norm(x3-x) = "<<Norm(x3-x)<<std::endl;
+        std::cout<<"cf "<<eps<<std::endl;
+    }
+    Assert(Equal(x3,x,eps),label+" Tridiag_SolveCR");
+    tmv::VectorView<T> x3r = Br.col(1);
+    x3r = B.col(1);
+    tmv::Tridiag_SolveCR(A,x3r);
+    Assert(Equal(x3r,X.col(1),eps),label+" Tridiag_SolveCR step");
+}
+
+// Check BatchTridiag_Decompose and BatchTridiag_SolveInPlace against
+// Tridiag_SolveInPlace for each system.  The batch size is not a
+// multiple of TMV_BATCH_BLOCKSIZE, so the last chunk is a partial one.
+template <class T>
+static void DoTestTridiagBatch(ptrdiff_t n, std::string label)
+{
+    typedef typename tmv::Traits<T>::real_type RT;
+    typedef typename tmv::Traits<RT>::float_type FT;
+    const ptrdiff_t nb = 3*TMV_BATCH_BLOCKSIZE/2;
+
+    if (showstartdone) {
+        std::cout<<"Start DoTestTridiagBatch: "<<label<<", n = "<<
+            n<<std::endl;
+    }
+
+    tmv::TridiagMatrixBatch<T> A(nb,n);
+    tmv::Matrix<T> X(nb,n);
+    for(ptrdiff_t b=0;b<nb;++b) {
+        tmv::TridiagMatrix<T> Ab = MakeTridiag<T>(n,b);
+        A.diag().row(b) = Ab.diag();
+        A.subDiag().row(b) = Ab.subDiag();
+        A.superDiag().row(b) = Ab.superDiag();
+        for(ptrdiff_t i=0;i<n;++i)
+            X(b,i) = TestVal<T>::make(RT(1+(i+b)%5),RT(b%3)-RT(i%4));
+    }
+    tmv::Matrix<T> X0 = X;
+
+    tmv::BatchTridiag_Decompose(A);
+    tmv::BatchTridiag_SolveInPlace(A,X);
+    // Also with a RowMajor X, which is copied.
+    tmv::Matrix<T,tmv::RowMajor> Xr = X0;
+    tmv::BatchTridiag_SolveInPlace(A,Xr);
+
+    for(ptrdiff_t b=0;b<nb;++b) {
+        tmv::TridiagMatrix<T> Ab = MakeTridiag<T>(n,b);
+        tmv::Vector<T> xb = X0.row(b);
+        const FT eps = EPS * FT(11*n) * Norm(xb);
+        tmv::Tridiag_Decompose(Ab);
+        tmv::Tridiag_SolveInPlace(Ab,xb);
+        Assert(Equal(X.row(b),xb,eps),label+" BatchTridiag_SolveInPlace");
+        Assert(Equal(Xr.row(b),xb,eps),
+               label+" BatchTridiag_SolveInPlace RowMajor");
+    }
+}
+
+template <class T>
+static void TestTridiag(std::string label)
+{
+    // n = 1 has no reduction levels.  The other n include both odd and
+    // even sizes at each level of the cyclic reduction.
+    DoTestTridiag<T>(1,label);
+    DoTestTridiag<T>(2,label);
+    DoTestTridiag<T>(3,label);
+    DoTestTridiag<T>(17,label);
+    DoTestTridiag<T>(64,label);
+    // Large enough that the first levels of the cyclic reduction are
+    // split among the threads (n >= TMV_TRIDIAG_CR_OPENMP_THRESH).
+    DoTestTridiag<T>(2*TMV_TRIDIAG_CR_OPENMP_THRESH+3,label);
+
+    DoTestTridiagBatch<T>(1,label);
+    DoTestTridiagBatch<T>(2,label);
+    DoTestTridiagBatch<T>(9,label);
+}
+
+template <class T> void TestTridiagMatrix()
+{
+    TestTridiag<T>("Tridiag");
+    TestTridiag<std::complex<T> >("Tridiag complex");
+    std::cout<<"TridiagMatrix<"<<Text(T())<<"> passed all tests\n";
+}
+
+#ifdef TEST_DOUBLE
+template void TestTridiagMatrix<double>();
+#endif
+#ifdef TEST_FLOAT
+template void TestTridiagMatrix<float>();
+#endif
+#ifdef TEST_LONGDOUBLE
+template void TestTridiagMatrix<long double>();
+#endif
@@ -0,0 +1,130 @@
+
+#include "TMV_Test.h"
+#include "TMV_Test_1.h"
+#include "TMV.h"
+#include "tmv/TMV_Tuning.h"
+#include <sstream>
+#include <cstdio>
+
+static const char* tunefile = "tmvtest_tuning.txt";
+
+static bool SameTuning(const tmv::TuningProfile& p1,
+                       const tmv::TuningProfile& p2)
+{
+    for(const tmv::TuningField* f = tmv::TuningFields(); f->name; ++f)
+        if (p1.*(f->value) != p2.*(f->value)) return false;
+    return true;
+}
+
+// A profile with a different value in each field, none of which are
+// the defaults.
+static tmv::TuningProfile TestProfile()
+{
+    tmv::TuningProfile p = tmv::DefaultTuning();
+    ptrdiff_t k = 1001;
+    for(const tmv::TuningField* f = tmv::TuningFields(); f->name; ++f)
+        p.*(f->value) += k++;
+    return p;
+}
+
+// Read the profile in s into p, and return the number of warnings.
+static int ReadTuningWarnings(
+    const std::string& s, tmv::TuningProfile& p, bool& ok)
+{
+    std::istringstream is(s);
+    std::ostringstream warn;
+    std::ostream* oldwarn = tmv::WriteWarningsTo(&warn);
+    ok = tmv::ReadTuning(is,p);
+    tmv::WriteWarningsTo(oldwarn);
+    std::string w = warn.str();
+    int nwarn = 0;
+    for(size_t i=w.find("Warning:"); i!=std::string::npos;
+        i=w.find("Warning:",i+1)) ++nwarn;
+    return nwarn;
+}
+
+template <class T>
+void TestTuning()
+{
+    const tmv::TuningProfile p0 = tmv::GetTuning();
+    const tmv::TuningProfile def = tmv::DefaultTuning();
+    const tmv::TuningProfile p1 = TestProfile();
+    Assert(!SameTuning(p1,def),"Tuning test profile");
+
+    // WriteTuning writes every field, and ReadTuning reads them back.
+    std::ostringstream os;
+    tmv::WriteTuning(os,p1);
+    for(const tmv::TuningField* f = tmv::TuningFields(); f->name; ++f)
+        Assert(os.str().find(std::string(f->name)+' ') != std::string::npos,
+               std::string("WriteTuning ")+f->name);
+    tmv::TuningProfile p2 = def;
+    bool ok;
+    int nwarn = ReadTuningWarnings(os.str(),p2,ok);
+    Assert(ok,"ReadTuning round trip");
+    Assert(nwarn == 0,"ReadTuning round trip warnings");
+    Assert(SameTuning(p2,p1),"ReadTuning round trip values");
+
+    // Comments and blank lines are skipped, and fields that aren't in
+    // the input keep their values.
+    p2 = def;
+    nwarn = ReadTuningWarnings(
+        "# comment\n\n   \nmm_min_packed 77\n#mm_min_winograd 5\n",p2,ok);
+    Assert(ok,"ReadTuning partial");
+    Assert(nwarn == 0,"ReadTuning partial warnings");
+    Assert(p2.mm_min_packed == 77,"ReadTuning partial value");
+    p2.mm_min_packed = def.mm_min_packed;
+    Assert(SameTuning(p2,def),"ReadTuning partial others unchanged");
+
+    // An unknown name or a line without a valid value gives a warning,
+    // and the rest of the input is still read.
+    p2 = def;
+    nwarn = ReadTuningWarnings(
+        "mm_min_packed 77\nno_such_field 5\nqr_min_blocked 33\n",p2,ok);
+    Assert(ok,"ReadTuning unknown name");
+#ifdef TMV_WARN
+    Assert(nwarn == 1,"ReadTuning unknown name warning");
+#endif
+    Assert(p2.mm_min_packed == 77,"ReadTuning unknown name before");
+    Assert(p2.qr_min_blocked == 33,"ReadTuning unknown name after");
+    p2 = def;
+    nwarn = ReadTuningWarnings(
+        "mm_min_packed abc\nmm_min_winograd\nqr_min_blocked 33\n",p2,ok);
+    Assert(ok,"ReadTuning bad line");
+#ifdef TMV_WARN
+    Assert(nwarn == 2,"ReadTuning bad line warnings");
+#endif
+    Assert(p2.mm_min_packed == def.mm_min_packed,"ReadTuning bad value");
+    Assert(p2.mm_min_winograd == def.mm_min_winograd,"ReadTuning no value");
+    Assert(p2.qr_min_blocked == 33,"ReadTuning bad line after");
+
+    // A stream that has gone bad is an error.
+    std::istringstream bad("mm_min_packed 77\n");
+    bad.setstate(std::ios::badbit);
+    p2 = def;
+    Assert(!tmv::ReadTuning(bad,p2),"ReadTuning bad stream");
+    Assert(SameTuning(p2,def),"ReadTuning bad stream unchanged");
+
+    // SaveTuning and LoadTuning do the same with the current profile.
+    tmv::SetTuning(p1);
+    Assert(SameTuning(tmv::GetTuning(),p1),"SetTuning");
+    Assert(tmv::SaveTuning(tunefile),"SaveTuning");
+    tmv::SetTuning(def);
+    Assert(tmv::LoadTuning(tunefile),"LoadTuning");
+    Assert(SameTuning(tmv::GetTuning(),p1),"LoadTuning values");
+    tmv::SetTuning(def);
+    Assert(!tmv::LoadTuning("no_such_dir/tuning.txt"),"LoadTuning no file");
+    Assert(SameTuning(tmv::GetTuning(),def),"LoadTuning no file unchanged");
+    Assert(!tmv::SaveTuning("no_such_dir/tuning.txt"),"SaveTuning no dir");
+
+    tmv::SetTuning(p0);
+    std::remove(tunefile);
+
+    std::cout<<"Tuning<"<<Text(T())<<"> passed all tests\n";
+}
+
+#ifdef TEST_DOUBLE
+template void TestTuning<double>();
+#endif
+#ifdef TEST_FLOAT
+template void TestTuning<float>();
+#endif
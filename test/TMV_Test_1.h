@@ -4,6 +4,14 @@
 template <class T> void TestVector();
 template <class T> void TestMatrix();
 template <class T> void TestPermutation();
+template <class T> void TestMatrixTranspose();
+template <class T> void TestMatrixMultMM();
+template <class T> void TestMemory();
+template <class T> void TestAlgoTrace();
+template <class T> void TestBinaryIO();
+template <class T> void TestTextIO();
+template <class T> void TestTuning();
+template <class T> void TestMatrixOpenMP();
 template <class T> void TestMatrixArith_1();
 template <class T> void TestMatrixArith_2();
 template <class T> void TestMatrixArith_3();
@@ -14,6 +22,11 @@ template <class T> void TestMatrixArith_7();
 template <class T> void TestMatrixArith_8();
 template <class T> void TestMatrixDiv();
 template <class T> void TestMatrixDet();
+template <class T> void TestMatrixEigen();
+template <class T> void TestBlockTridiagMatrix();
+template <class T> void TestTridiagMatrix();
+template <class T> void TestSymMatrix();
+template <class T> void TestBandLU();
 template <class T, tmv::StorageType stor> void TestMatrixDecomp();
 
 template <class T> void TestDiagMatrix();
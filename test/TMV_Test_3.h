@@ -31,6 +31,7 @@ template <class T> void TestSmallSquareDiv_e();
 template <class T> void TestSmallSquareDiv_f();
 template <class T> void TestSmallSquareDiv_g();
 template <class T> void TestSmallMatrixDet();
+template <class T> void TestSmallMatrixBatch();
 template <class T> void TestAllSmallNonSquareDiv();
 template <class T> void TestSmallNonSquareDiv_a();
 template <class T> void TestSmallNonSquareDiv_b();